@@ -17,8 +17,12 @@
 
 #include "bspf.hxx"
 
+#include "Base.hxx"
 #include "Cheat.hxx"
 #include "CheatManager.hxx"
+#include "Console.hxx"
+#include "M6532.hxx"
+#include "RamSearch.hxx"
 #include "CheckListWidget.hxx"
 #include "DialogContainer.hxx"
 #include "Dialog.hxx"
@@ -47,16 +51,21 @@ CheatCodeDialog::CheatCodeDialog(OSystem& osystem, DialogContainer& parent,
 
   // Set real dimensions
   _w = 45 * fontWidth + HBORDER * 2;
-  _h = 11 * (lineHeight + 4) + VBORDER;
+  _h = 14 * (lineHeight + 4) + VBORDER;
 
   // List of cheats, with checkboxes to enable/disable
   xpos = HBORDER;  ypos = VBORDER;
   myCheatList =
     new CheckListWidget(this, font, xpos, ypos, _w - buttonWidth - HBORDER * 2 - 8,
-                        _h - 2*buttonHeight - VBORDER);
+                        _h - 2*buttonHeight - VBORDER - lineHeight - 4);
   myCheatList->setEditable(false);
   wid.push_back(myCheatList);
 
+  // Result of the RAM search, below the list
+  mySearchResult =
+    new StaticTextWidget(this, font, xpos, ypos + myCheatList->getHeight() + 4,
+                         myCheatList->getWidth(), lineHeight, "");
+
   xpos += myCheatList->getWidth() + 8; ypos = VBORDER;
 
   b = new ButtonWidget(this, font, xpos, ypos, buttonWidth, buttonHeight,
@@ -79,6 +88,25 @@ CheatCodeDialog::CheatCodeDialog(OSystem& osystem, DialogContainer& parent,
   b = new ButtonWidget(this, font, xpos, ypos, buttonWidth, buttonHeight,
                        "One shot" + ELLIPSIS, kAddOneShotCmd);
   wid.push_back(b);
+  ypos += lineHeight + 8 * 3;
+
+  // Search the RAM for the location of a value, comparing it between the
+  // times the dialog is opened
+  b = new ButtonWidget(this, font, xpos, ypos, buttonWidth, buttonHeight,
+                       "Search", kSearchStartCmd);
+  wid.push_back(b);
+  ypos += lineHeight + 8;
+
+  mySearchChangedButton =
+    new ButtonWidget(this, font, xpos, ypos, buttonWidth, buttonHeight,
+                     "Changed", kSearchChangedCmd);
+  wid.push_back(mySearchChangedButton);
+  ypos += lineHeight + 8;
+
+  mySearchSameButton =
+    new ButtonWidget(this, font, xpos, ypos, buttonWidth, buttonHeight,
+                     "Same", kSearchSameCmd);
+  wid.push_back(mySearchSameButton);
 
   // Inputbox which will pop up when adding/editing a cheat
   StringList labels;
@@ -134,6 +162,45 @@ void CheatCodeDialog::loadConfig()
   bool enabled = (list.size() > 0);
   myEditButton->setEnabled(enabled);
   myRemoveButton->setEnabled(enabled);
+
+  updateSearchResult();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CheatCodeDialog::searchRam(int cmd)
+{
+  RamSearch& search = instance().cheat().ramSearch();
+  const uInt8* ram = instance().console().riot().getRAM();
+
+  if(cmd == kSearchStartCmd)
+    search.start(ram);
+  else
+    search.filter(ram, cmd == kSearchChangedCmd ?
+                  RamSearch::Compare::Changed : RamSearch::Compare::Unchanged);
+
+  updateSearchResult();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CheatCodeDialog::updateSearchResult()
+{
+  const RamSearch& search = instance().cheat().ramSearch();
+  ostringstream buf;
+
+  if(search.active())
+  {
+    const IntArray& addresses = search.candidates();
+    buf << addresses.size() << " left";
+    if(addresses.size() > 0 && addresses.size() <= 8)
+    {
+      buf << ":";
+      for(int addr: addresses)
+        buf << " " << Common::Base::HEX2 << addr;
+    }
+  }
+  mySearchResult->setLabel(buf.str());
+  mySearchChangedButton->setEnabled(search.active());
+  mySearchSameButton->setEnabled(search.active());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -265,6 +332,12 @@ void CheatCodeDialog::handleCommand(CommandSender* sender, int cmd,
       addOneShotCheat();
       break;
 
+    case kSearchStartCmd:
+    case kSearchChangedCmd:
+    case kSearchSameCmd:
+      searchRam(cmd);
+      break;
+
     case kOneShotCheatAdded:
     {
       const string& name = myCheatInput->getResult(0);
@@ -48,6 +48,8 @@ class CheatCodeDialog : public Dialog
     void editCheat();
     void removeCheat();
     void addOneShotCheat();
+    void searchRam(int cmd);
+    void updateSearchResult();
 
   private:
     CheckListWidget* myCheatList;
@@ -55,6 +57,9 @@ class CheatCodeDialog : public Dialog
 
     ButtonWidget* myEditButton;
     ButtonWidget* myRemoveButton;
+    ButtonWidget* mySearchChangedButton;
+    ButtonWidget* mySearchSameButton;
+    StaticTextWidget* mySearchResult;
 
     enum {
       kAddCheatCmd       = 'CHTa',
@@ -63,7 +68,10 @@ class CheatCodeDialog : public Dialog
       kCheatAdded        = 'CHad',
       kCheatEdited       = 'CHed',
       kOneShotCheatAdded = 'CHoa',
-      kRemCheatCmd       = 'CHTr'
+      kRemCheatCmd       = 'CHTr',
+      kSearchStartCmd    = 'CHss',
+      kSearchChangedCmd  = 'CHsc',
+      kSearchSameCmd     = 'CHsu'
     };
 
   private:
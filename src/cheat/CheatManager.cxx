@@ -17,6 +17,8 @@
 
 #include "OSystem.hxx"
 #include "Console.hxx"
+#include "System.hxx"
+#include "M6532.hxx"
 #include "Cheat.hxx"
 #include "Settings.hxx"
 #include "CheetahCheat.hxx"
@@ -29,6 +31,7 @@
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 CheatManager::CheatManager(OSystem& osystem)
   : myOSystem(osystem),
+    myFileEntries(0),
     myListIsDirty(false)
 {
 }
@@ -115,6 +118,43 @@ void CheatManager::addPerFrame(const string& name, const string& code, bool enab
     if(found)
       Vec::removeAt(myPerFrameList, i);
   }
+  compilePerFrame();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CheatManager::compilePerFrame()
+{
+  // Only RAM cheats ('aavv') are evaluated each frame; their address
+  // and value are parsed once here instead of on every frame
+  myRamPatches.clear();
+  for(const auto& cheat: myPerFrameList)
+  {
+    const string& code = cheat->code();
+    if(code.size() == 4)
+      myRamPatches.push_back({
+        uInt16(std::stoi(code.substr(0, 2), nullptr, 16)),
+        uInt8(std::stoi(code.substr(2, 2), nullptr, 16))
+      });
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CheatManager::applyPerFrame()
+{
+  if(myRamPatches.empty())
+    return;
+
+  System& system = myOSystem.console().system();
+  M6532& riot = myOSystem.console().riot();
+  for(const auto& patch: myRamPatches)
+  {
+    // Zero-page RAM is written directly; TIA addresses still need the
+    // device to see the write
+    if(patch.address & 0x80)
+      riot.setRAM(patch.address, patch.value);
+    else
+      system.poke(patch.address, patch.value);
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -214,10 +254,24 @@ void CheatManager::enable(const string& code, bool enable)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CheatManager::loadCheatDatabase()
 {
-  const string& cheatfile = myOSystem.cheatFile();
+  // The database is only needed once a ROM is loaded, so it is parsed
+  // in the background rather than delaying startup
+  const string cheatfile = myOSystem.cheatFile();
+  myDatabaseLoading = std::async(std::launch::async, [cheatfile] {
+    return readCheatDatabase(cheatfile);
+  });
+  myListIsDirty = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CheatManager::CheatDatabase CheatManager::readCheatDatabase(const string& cheatfile)
+{
+  CheatDatabase database;
+  database.entries = 0;
+
   ifstream in(cheatfile);
   if(!in)
-    return;
+    return database;
 
   string line, md5, cheat;
   string::size_type one, two, three, four;
@@ -242,16 +296,37 @@ void CheatManager::loadCheatDatabase()
     md5   = line.substr(one + 1, two - one - 1);
     cheat = line.substr(three + 1, four - three - 1);
 
-    myCheatMap.emplace(md5, cheat);
+    // Changed entries are appended to the file, so a later entry replaces
+    // an earlier one, and an empty one removes it
+    if(cheat != "")
+      database.cheats[md5] = cheat;
+    else
+      database.cheats.erase(md5);
+    ++database.entries;
   }
 
-  myListIsDirty = false;
+  return database;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CheatManager::waitForDatabase()
+{
+  if(myDatabaseLoading.valid())
+  {
+    CheatDatabase database = myDatabaseLoading.get();
+    myCheatMap = std::move(database.cheats);
+    myFileEntries = database.entries;
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CheatManager::saveCheatDatabase()
 {
-  if(!myListIsDirty)
+  waitForDatabase();
+
+  // Changes have already been appended to the file; it is only rewritten
+  // once most of its entries have been replaced
+  if(!myListIsDirty && myFileEntries <= 2 * myCheatMap.size())
     return;
 
   const string& cheatfile = myOSystem.cheatFile();
@@ -261,14 +336,19 @@ void CheatManager::saveCheatDatabase()
 
   for(const auto& iter: myCheatMap)
     out << "\"" << iter.first << "\" " << "\"" << iter.second << "\"" << endl;
+  myFileEntries = uInt32(myCheatMap.size());
+  myListIsDirty = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CheatManager::loadCheats(const string& md5sum)
 {
   myPerFrameList.clear();
+  myRamPatches.clear();
   myCheatList.clear();
+  myRamSearch.reset();
   myCurrentCheat = "";
+  waitForDatabase();
 
   // Set up any cheatcodes that was on the command line
   // (and remove the key from the settings, so they won't get set again)
@@ -301,6 +381,7 @@ void CheatManager::saveCheats(const string& md5sum)
   }
 
   bool changed = cheats.str() != myCurrentCheat;
+  waitForDatabase();
 
   // Only update the list if absolutely necessary
   if(changed)
@@ -314,11 +395,18 @@ void CheatManager::saveCheats(const string& md5sum)
     // Add new entry only if there are any cheats defined
     if(cheats.str() != "")
       myCheatMap.emplace(md5sum, cheats.str());
+
+    // Append the changed entry to the database file, instead of writing
+    // all of it; if that fails, the file is rewritten at exit
+    ofstream out(myOSystem.cheatFile(), std::ios::app);
+    if(out << "\"" << md5sum << "\" " << "\"" << cheats.str() << "\"" << endl)
+      ++myFileEntries;
+    else
+      myListIsDirty = true;
   }
 
-  // Update the dirty flag
-  myListIsDirty = myListIsDirty || changed;
   myPerFrameList.clear();
+  myRamPatches.clear();
   myCheatList.clear();
 }
 
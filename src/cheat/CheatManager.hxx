@@ -19,10 +19,12 @@
 #define CHEAT_MANAGER_HXX
 
 #include <map>
+#include <future>
 
 class Cheat;
 class OSystem;
 
+#include "RamSearch.hxx"
 #include "bspf.hxx"
 
 using CheatList = vector<shared_ptr<Cheat>>;
@@ -94,17 +96,26 @@ class CheatManager
     const CheatList& list() { return myCheatList; }
 
     /**
-      Returns the per-frame cheatlist (needed to evaluate cheats each frame)
+      Apply all per-frame cheats; this is called once each frame.
     */
-    const CheatList& perFrame() { return myPerFrameList; }
+    void applyPerFrame();
+
+    /**
+      The search for RAM locations used to find new cheats.
+    */
+    RamSearch& ramSearch() { return myRamSearch; }
 
     /**
       Load all cheats (for all ROMs) from disk to internal database.
+      This is done in the background; the database is waited for when
+      first used.
     */
     void loadCheatDatabase();
 
     /**
       Save all cheats (for all ROMs) in internal database to disk.
+      Changes are appended to the file as they are made, so it is only
+      rewritten when it has grown too much.
     */
     void saveCheatDatabase();
 
@@ -141,20 +152,54 @@ class CheatManager
     */
     void parse(const string& cheats);
 
+    /**
+      Rebuild the list of RAM writes from the per-frame cheatlist.
+    */
+    void compilePerFrame();
+
+    // The cheats of the database file, and the number of entries in the
+    // file (some of which may have been replaced by later ones)
+    struct CheatDatabase {
+      std::map<string,string> cheats;
+      uInt32 entries;
+    };
+
+    /**
+      Parse the cheat database file (called on a background thread).
+    */
+    static CheatDatabase readCheatDatabase(const string& cheatfile);
+
+    /**
+      Take over the database once it's been loaded in the background.
+    */
+    void waitForDatabase();
+
   private:
     OSystem& myOSystem;
 
     CheatList myCheatList;
     CheatList myPerFrameList;
 
+    // The per-frame cheats, compiled into the writes they make
+    struct RamPatch {
+      uInt16 address;
+      uInt8  value;
+    };
+    vector<RamPatch> myRamPatches;
+
+    RamSearch myRamSearch;
+
     std::map<string,string> myCheatMap;
+    std::future<CheatDatabase> myDatabaseLoading;
+    uInt32 myFileEntries;
     string myCheatFile;
 
     // This is set each time a new cheat/ROM is loaded, for later
     // comparison to see if the cheatcode list has actually been modified
     string myCurrentCheat;
 
-    // Indicates that the list has been modified, and should be saved to disk
+    // Indicates that the list has been modified, and the file must be
+    // rewritten
     bool myListIsDirty;
 
   private:
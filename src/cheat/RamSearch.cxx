@@ -0,0 +1,96 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "RamSearch.hxx"
+
+constexpr uInt32 RamSearch::RAM_SIZE;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RamSearch::RamSearch()
+  : myActive(false)
+{
+  memset(mySnapshot, 0, RAM_SIZE);
+  memset(myCandidates, 0, RAM_SIZE);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RamSearch::start(const uInt8* ram)
+{
+  memcpy(mySnapshot, ram, RAM_SIZE);
+  memset(myCandidates, 1, RAM_SIZE);
+  myActive = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 RamSearch::filter(const uInt8* ram, Compare compare, uInt8 value)
+{
+  if(!myActive)
+    start(ram);
+
+  // Keep each loop a simple, branch-free operation on all locations
+  switch(compare)
+  {
+    case Compare::Changed:
+      for(uInt32 i = 0; i < RAM_SIZE; ++i)
+        myCandidates[i] &= uInt8(ram[i] != mySnapshot[i]);
+      break;
+
+    case Compare::Unchanged:
+      for(uInt32 i = 0; i < RAM_SIZE; ++i)
+        myCandidates[i] &= uInt8(ram[i] == mySnapshot[i]);
+      break;
+
+    case Compare::Increased:
+      for(uInt32 i = 0; i < RAM_SIZE; ++i)
+        myCandidates[i] &= uInt8(ram[i] > mySnapshot[i]);
+      break;
+
+    case Compare::Decreased:
+      for(uInt32 i = 0; i < RAM_SIZE; ++i)
+        myCandidates[i] &= uInt8(ram[i] < mySnapshot[i]);
+      break;
+
+    case Compare::Equal:
+      for(uInt32 i = 0; i < RAM_SIZE; ++i)
+        myCandidates[i] &= uInt8(ram[i] == value);
+      break;
+  }
+  memcpy(mySnapshot, ram, RAM_SIZE);
+
+  return count();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 RamSearch::count() const
+{
+  uInt32 count = 0;
+  for(uInt32 i = 0; i < RAM_SIZE; ++i)
+    count += myCandidates[i];
+
+  return count;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+IntArray RamSearch::candidates() const
+{
+  IntArray list;
+  for(uInt32 i = 0; i < RAM_SIZE; ++i)
+    if(myCandidates[i])
+      list.push_back(0x80 + i);
+
+  return list;
+}
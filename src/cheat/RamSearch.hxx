@@ -0,0 +1,94 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef RAM_SEARCH_HXX
+#define RAM_SEARCH_HXX
+
+#include "bspf.hxx"
+
+/**
+  Finds the RAM locations holding a value of interest (lives, score, etc),
+  by comparing the RIOT RAM against a snapshot taken at an earlier frame.
+  Each comparison removes the locations which don't match from the list of
+  candidates, and then takes a new snapshot.
+
+  The comparisons are done for all locations at once, as straight loops
+  over fixed size arrays without branches, which the compiler turns into
+  vector instructions.
+
+  @author  Stephen Anthony
+*/
+class RamSearch
+{
+  public:
+    enum class Compare { Changed, Unchanged, Increased, Decreased, Equal };
+
+    static constexpr uInt32 RAM_SIZE = 128;
+
+  public:
+    RamSearch();
+
+    /**
+      Start a new search, with all locations as candidates.
+
+      @param ram  The current contents of the RIOT RAM
+    */
+    void start(const uInt8* ram);
+
+    /**
+      Remove all candidates whose value doesn't match the comparison
+      (against the previous snapshot, or 'value' for Compare::Equal).
+
+      @param ram  The current contents of the RIOT RAM
+      @return  The number of remaining candidates
+    */
+    uInt32 filter(const uInt8* ram, Compare compare, uInt8 value = 0);
+
+    /**
+      Stop the current search.
+    */
+    void reset() { myActive = false; }
+
+    /**
+      Answer whether a search was started.
+    */
+    bool active() const { return myActive; }
+
+    /**
+      The number of remaining candidates.
+    */
+    uInt32 count() const;
+
+    /**
+      The addresses ($80 - $FF) of the remaining candidates.
+    */
+    IntArray candidates() const;
+
+  private:
+    uInt8 mySnapshot[RAM_SIZE];
+    uInt8 myCandidates[RAM_SIZE];  // 0 or 1
+    bool myActive;
+
+  private:
+    // Following constructors and assignment operators not supported
+    RamSearch(const RamSearch&) = delete;
+    RamSearch(RamSearch&&) = delete;
+    RamSearch& operator=(const RamSearch&) = delete;
+    RamSearch& operator=(RamSearch&&) = delete;
+};
+
+#endif
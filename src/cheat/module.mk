@@ -5,7 +5,8 @@ MODULE_OBJS := \
 	src/cheat/CheatManager.o \
 	src/cheat/CheetahCheat.o \
 	src/cheat/BankRomCheat.o \
-	src/cheat/RamCheat.o
+	src/cheat/RamCheat.o \
+	src/cheat/RamSearch.o
 
 MODULE_DIRS += \
 	src/cheat
@@ -0,0 +1,116 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef ARENA_HXX
+#define ARENA_HXX
+
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "bspf.hxx"
+
+/**
+  A fixed-size block of memory, which objects with the lifetime of their
+  owner are created in one after another.  Each object starts on its own
+  cache line, so objects used together sit next to each other without
+  sharing lines, and the whole block is released in one go.
+
+  The objects are handed out as Ptr, which only destroys them; the arena
+  must therefore outlive all of them (i.e. be declared before them).
+
+  @author  Stephen Anthony
+*/
+namespace Common {
+
+class Arena
+{
+  public:
+    static constexpr size_t ALIGNMENT = 64;  // the usual cache line
+
+    // Destroys an object created in an arena, without freeing its memory
+    struct Destroy {
+      template <class T>
+      void operator()(T* object) const { object->~T(); }
+    };
+
+    template <class T>
+    using Ptr = std::unique_ptr<T, Destroy>;
+
+    /**
+      The size of an arena holding one object of each of the given types.
+    */
+    template <class T>
+    static constexpr size_t sizeFor() {
+      return (sizeof(T) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+    template <class T, class U, class... Ts>
+    static constexpr size_t sizeFor() {
+      return sizeFor<T>() + sizeFor<U, Ts...>();
+    }
+
+  public:
+    explicit Arena(size_t size)
+      : myMemory(make_unique<uInt8[]>(size + ALIGNMENT - 1)),
+        mySize(size),
+        myUsed(0)
+    {
+      // Align the start of the block to a cache line
+      const size_t offset = reinterpret_cast<uintptr_t>(myMemory.get()) & (ALIGNMENT - 1);
+      myBase = myMemory.get() + (offset ? ALIGNMENT - offset : 0);
+    }
+
+    /**
+      Create an object in the arena.  Running out of space is a programming
+      error (the size must be calculated with sizeFor()).
+    */
+    template <class T, class... Args>
+    Ptr<T> create(Args&&... args) {
+      static_assert(alignof(T) <= ALIGNMENT, "Object is aligned beyond a cache line");
+
+      const size_t size = sizeFor<T>();
+      if(size > mySize - myUsed)
+        throw std::runtime_error("Arena: out of space");
+
+      T* object = new(myBase + myUsed) T(std::forward<Args>(args)...);
+      myUsed += size;
+
+      return Ptr<T>(object);
+    }
+
+    size_t size() const { return mySize; }
+    size_t used() const { return myUsed; }
+
+  private:
+    unique_ptr<uInt8[]> myMemory;
+    uInt8* myBase;
+    size_t mySize;
+    size_t myUsed;
+
+  private:
+    // Following constructors and assignment operators not supported
+    Arena() = delete;
+    Arena(const Arena&) = delete;
+    Arena(Arena&&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena& operator=(Arena&&) = delete;
+};
+
+}  // Namespace Common
+
+#endif
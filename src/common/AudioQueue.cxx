@@ -16,33 +16,60 @@
 //============================================================================
 
 #include "AudioQueue.hxx"
+#include "PerfCounters.hxx"
 
-using std::mutex;
-using std::lock_guard;
+namespace {
+  // Fragments are aligned to cache lines (in samples)
+  constexpr uInt32 CACHE_LINE_SAMPLES = 64 / sizeof(Int16);
+}
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 AudioQueue::AudioQueue(uInt32 fragmentSize, uInt32 capacity, bool isStereo)
-  : myFragmentSize(fragmentSize),
-    myIsStereo(isStereo),
-    myFragmentQueue(capacity),
-    myAllFragments(capacity + 2),
-    mySize(0),
-    myNextFragment(0),
+  : myFragmentBufferSize(0),
+    myReadPosition(0),
+    myWritePosition(0),
     myIgnoreOverflows(true),
     myOverflowLogger("audio buffer overflow", Logger::Level::INFO)
 {
-  const uInt8 sampleSize = myIsStereo ? 2 : 1;
+  reconfigure(fragmentSize, capacity, isStereo);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioQueue::reconfigure(uInt32 fragmentSize, uInt32 capacity, bool isStereo)
+{
+  myFragmentSize = fragmentSize;
+  myIsStereo = isStereo;
 
-  myFragmentBuffer = make_unique<Int16[]>(myFragmentSize * sampleSize * (capacity + 2));
+  const uInt32 stride = (myFragmentSize * (myIsStereo ? 2 : 1) + CACHE_LINE_SAMPLES - 1) /
+    CACHE_LINE_SAMPLES * CACHE_LINE_SAMPLES;
+  // Room for aligning the first fragment
+  const uInt32 bufferSize = stride * (capacity + 2) + CACHE_LINE_SAMPLES - 1;
+
+  if (bufferSize > myFragmentBufferSize) {
+    myFragmentBuffer = make_unique<Int16[]>(bufferSize);
+    myFragmentBufferSize = bufferSize;
+  }
+  memset(myFragmentBuffer.get(), 0, myFragmentBufferSize * sizeof(Int16));
+
+  const uInt32 misalignment =
+    uInt32(reinterpret_cast<uintptr_t>(myFragmentBuffer.get()) / sizeof(Int16) % CACHE_LINE_SAMPLES);
+  Int16* fragments = myFragmentBuffer.get() + (CACHE_LINE_SAMPLES - misalignment) % CACHE_LINE_SAMPLES;
+
+  // The vectors keep their memory when shrinking
+  myFragmentQueue.resize(capacity);
+  myAllFragments.resize(capacity + 2);
+
+  for (uInt32 i = 0; i < capacity + 2; ++i)
+    myAllFragments[i] = fragments + i * stride;
 
   for (uInt32 i = 0; i < capacity; ++i)
-    myFragmentQueue[i] = myAllFragments[i] = myFragmentBuffer.get() + i * sampleSize * myFragmentSize;
+    myFragmentQueue[i] = myAllFragments[i];
 
-  myAllFragments[capacity] = myFirstFragmentForEnqueue =
-    myFragmentBuffer.get() + capacity * sampleSize * myFragmentSize;
+  myFirstFragmentForEnqueue = myAllFragments[capacity];
+  myFirstFragmentForDequeue = myAllFragments[capacity + 1];
 
-  myAllFragments[capacity + 1] = myFirstFragmentForDequeue =
-    myFragmentBuffer.get() + (capacity + 1) * sampleSize * myFragmentSize;
+  myReadPosition = 0;
+  myWritePosition = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -52,11 +79,12 @@ uInt32 AudioQueue::capacity() const
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 AudioQueue::size()
+uInt32 AudioQueue::size() const
 {
-  lock_guard<mutex> guard(myMutex);
+  const uInt32 wrap = 2 * capacity();
 
-  return mySize;
+  return (myWritePosition.load(std::memory_order_acquire) + wrap -
+          myReadPosition.load(std::memory_order_acquire)) % wrap;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -74,8 +102,6 @@ uInt32 AudioQueue::fragmentSize() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Int16* AudioQueue::enqueue(Int16* fragment)
 {
-  lock_guard<mutex> guard(myMutex);
-
   Int16* newFragment;
 
   if (!fragment) {
@@ -87,27 +113,37 @@ Int16* AudioQueue::enqueue(Int16* fragment)
     return newFragment;
   }
 
-  const uInt8 capacity = uInt8(myFragmentQueue.size());
-  const uInt8 fragmentIndex = (myNextFragment + mySize) % capacity;
+  if (myFragmentCallback)
+    myFragmentCallback(fragment, myFragmentSize * (myIsStereo ? 2 : 1));
 
-  newFragment = myFragmentQueue.at(fragmentIndex);
-  myFragmentQueue.at(fragmentIndex) = fragment;
+  const uInt32 capacity = this->capacity();
+  const uInt32 writePosition = myWritePosition.load(std::memory_order_relaxed);
 
-  if (mySize < capacity) ++mySize;
-  else {
-    myNextFragment = (myNextFragment + 1) % capacity;
+  // The queue is full; the consumer owns the queued fragments, so we drop
+  // the new one instead of the oldest
+  if (size() == capacity) {
+    PERF_COUNT(audioQueueOverflow);
     if (!myIgnoreOverflows) myOverflowLogger.log();
+
+    return fragment;
   }
 
+  // The slot behind the last queued fragment holds a free fragment, which
+  // the consumer has released before advancing the read position
+  const uInt32 fragmentIndex = writePosition % capacity;
+
+  newFragment = myFragmentQueue[fragmentIndex];
+  myFragmentQueue[fragmentIndex] = fragment;
+
+  myWritePosition.store((writePosition + 1) % (2 * capacity), std::memory_order_release);
+
   return newFragment;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Int16* AudioQueue::dequeue(Int16* fragment)
 {
-  lock_guard<mutex> guard(myMutex);
-
-  if (mySize == 0) return nullptr;
+  if (size() == 0) return nullptr;
 
   if (!fragment) {
     if (!myFirstFragmentForDequeue) throw runtime_error("dequeue called empty");
@@ -116,11 +152,14 @@ Int16* AudioQueue::dequeue(Int16* fragment)
     myFirstFragmentForDequeue = nullptr;
   }
 
-  Int16* nextFragment = myFragmentQueue.at(myNextFragment);
-  myFragmentQueue.at(myNextFragment) = fragment;
+  const uInt32 capacity = this->capacity();
+  const uInt32 readPosition = myReadPosition.load(std::memory_order_relaxed);
+  const uInt32 fragmentIndex = readPosition % capacity;
+
+  Int16* nextFragment = myFragmentQueue[fragmentIndex];
+  myFragmentQueue[fragmentIndex] = fragment;
 
-  --mySize;
-  myNextFragment = (myNextFragment + 1) % myFragmentQueue.size();
+  myReadPosition.store((readPosition + 1) % (2 * capacity), std::memory_order_release);
 
   return nextFragment;
 }
@@ -128,8 +167,6 @@ Int16* AudioQueue::dequeue(Int16* fragment)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AudioQueue::closeSink(Int16* fragment)
 {
-  lock_guard<mutex> guard(myMutex);
-
   if (myFirstFragmentForDequeue && fragment)
     throw new runtime_error("attempt to return unknown buffer on closeSink");
 
@@ -142,3 +179,9 @@ void AudioQueue::ignoreOverflows(bool shouldIgnoreOverflows)
 {
   myIgnoreOverflows = shouldIgnoreOverflows;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioQueue::setFragmentCallback(FragmentCallback callback)
+{
+  myFragmentCallback = callback;
+}
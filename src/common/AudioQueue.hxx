@@ -18,7 +18,8 @@
 #ifndef AUDIO_QUEUE_HXX
 #define AUDIO_QUEUE_HXX
 
-#include <mutex>
+#include <atomic>
+#include <functional>
 
 #include "bspf.hxx"
 #include "StaggeredLogger.hxx"
@@ -33,11 +34,24 @@
   The queue needs to be threadsafe as the (SDL) audio driver runs on a
   separate thread. Samples are stored as signed 16 bit integers
   (platform endian).
+
+  The queue is lock-free as long as there is a single producer (the
+  emulation) and a single consumer (the sound driver): the producer only
+  advances the write position and the consumer only advances the read
+  position. The driver callback thus never waits for the emulation thread.
+  If the queue is full, the fragment passed to enqueue is dropped and
+  handed back for refilling.
+
+  The fragments live in a single block of memory, with every fragment
+  starting on a cache line.  The queue can be reconfigured in place, so
+  the block is only reallocated if it has to grow.
 */
 class AudioQueue
 {
   public:
 
+    using FragmentCallback = std::function<void(const Int16*, uInt32)>;
+
     /**
        Create a new AudioQueue.
 
@@ -47,6 +61,17 @@ class AudioQueue
      */
     AudioQueue(uInt32 fragmentSize, uInt32 capacity, bool isStereo);
 
+    /**
+       Change the geometry of the queue, which is reset to the state after
+       construction.  This must only be called while neither the emulation
+       nor the sound driver use the queue.
+
+       @param fragmentSize  The size (in stereo / mono samples) of each fragment
+       @param capacity      The number of fragments that can be queued before wrapping.
+       @param isStereo      Whether samples are stereo or mono.
+     */
+    void reconfigure(uInt32 fragmentSize, uInt32 capacity, bool isStereo);
+
     /**
        Capacity getter.
      */
@@ -55,7 +80,7 @@ class AudioQueue
     /**
       Size getter.
      */
-    uInt32 size();
+    uInt32 size() const;
 
     /**
       Stereo / mono getter.
@@ -96,6 +121,13 @@ class AudioQueue
      */
     void ignoreOverflows(bool shouldIgnoreOverflows);
 
+    /**
+      Pass every fragment enqueued (and the number of samples in it, counting
+      both channels) to the given function, on the thread enqueueing it.
+      This must only be called while the emulation doesn't use the queue.
+     */
+    void setFragmentCallback(FragmentCallback callback);
+
   private:
 
     // The size of an individual fragment (in stereo / mono samples)
@@ -110,17 +142,17 @@ class AudioQueue
     // All fragments, including the two fragments that are in circulation.
     vector<Int16*> myAllFragments;
 
-    // We allocate a consecutive slice of memory for the fragments.
+    // We allocate a consecutive slice of memory for the fragments, which is
+    // kept (and reused) as long as it is large enough.
     unique_ptr<Int16[]> myFragmentBuffer;
+    uInt32 myFragmentBufferSize;
 
-    // The nubmer if queued fragments
-    uInt32 mySize;
-
-    // The next fragment.
-    uInt32 myNextFragment;
-
-    // We need a mutex for thread safety.
-    std::mutex myMutex;
+    // Read (next fragment to dequeue) and write positions. Both run modulo
+    // twice the capacity, so a full queue can be told apart from an empty one.
+    // The read position is only advanced by the consumer, the write position
+    // only by the producer.
+    std::atomic<uInt32> myReadPosition;
+    std::atomic<uInt32> myWritePosition;
 
     // The first (empty) enqueue call returns this fragment.
     Int16* myFirstFragmentForEnqueue;
@@ -128,10 +160,13 @@ class AudioQueue
     Int16* myFirstFragmentForDequeue;
 
     // Log overflows?
-    bool myIgnoreOverflows;
+    std::atomic<bool> myIgnoreOverflows;
 
     StaggeredLogger myOverflowLogger;
 
+    // Called for every fragment enqueued
+    FragmentCallback myFragmentCallback;
+
   private:
 
     AudioQueue() = delete;
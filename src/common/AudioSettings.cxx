@@ -36,7 +36,7 @@ namespace {
   {
     return (
       numericResamplingQuality >= static_cast<int>(AudioSettings::ResamplingQuality::nearestNeightbour) &&
-      numericResamplingQuality <= static_cast<int>(AudioSettings::ResamplingQuality::lanczos_3)
+      numericResamplingQuality <= static_cast<int>(AudioSettings::ResamplingQuality::polyphase)
     ) ? static_cast<AudioSettings::ResamplingQuality>(numericResamplingQuality) : AudioSettings::DEFAULT_RESAMPLING_QUALITY;
   }
 }
@@ -92,6 +92,10 @@ void AudioSettings::normalize(Settings& settings)
   if (static_cast<int>(resamplingQuality) != settingResamplingQuality)
     settings.setValue(SETTING_RESAMPLING_QUALITY, static_cast<int>(DEFAULT_RESAMPLING_QUALITY));
 
+  int settingResamplingTaps = settings.getInt(SETTING_RESAMPLING_TAPS);
+  if (settingResamplingTaps < 2 || settingResamplingTaps > MAX_RESAMPLING_TAPS || settingResamplingTaps % 2 != 0)
+    settings.setValue(SETTING_RESAMPLING_TAPS, DEFAULT_RESAMPLING_TAPS);
+
   int settingVolume = settings.getInt(SETTING_VOLUME);
   if (settingVolume < 0 || settingVolume > 100) settings.setValue(SETTING_VOLUME, DEFAULT_VOLUME);
 }
@@ -140,6 +144,12 @@ AudioSettings::ResamplingQuality AudioSettings::resamplingQuality()
   return customSettings() ? normalizeResamplingQuality(mySettings.getInt(SETTING_RESAMPLING_QUALITY)) : myPresetResamplingQuality;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 AudioSettings::resamplingTaps() const
+{
+  return lboundInt(mySettings.getInt(SETTING_RESAMPLING_TAPS), DEFAULT_RESAMPLING_TAPS);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool AudioSettings::stereo() const
 {
@@ -166,6 +176,18 @@ uInt32 AudioSettings::dpcPitch() const
   return lboundInt(mySettings.getInt(SETTING_DPC_PITCH), 10000);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool AudioSettings::autotune() const
+{
+  return mySettings.getBool(SETTING_AUTOTUNE);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool AudioSettings::dynamicRate() const
+{
+  return mySettings.getBool(SETTING_DYNAMIC_RATE);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AudioSettings::setPreset(AudioSettings::Preset preset)
 {
@@ -260,6 +282,15 @@ void AudioSettings::setResamplingQuality(AudioSettings::ResamplingQuality resamp
   normalize(mySettings);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioSettings::setResamplingTaps(uInt32 taps)
+{
+  if (!myIsPersistent) return;
+
+  mySettings.setValue(SETTING_RESAMPLING_TAPS, taps);
+  normalize(mySettings);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AudioSettings::setStereo(bool allROMs)
 {
@@ -276,6 +307,22 @@ void AudioSettings::setDpcPitch(uInt32 pitch)
   mySettings.setValue(SETTING_DPC_PITCH, pitch);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioSettings::setAutotune(bool autotune)
+{
+  if(!myIsPersistent) return;
+
+  mySettings.setValue(SETTING_AUTOTUNE, autotune);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AudioSettings::setDynamicRate(bool dynamicRate)
+{
+  if(!myIsPersistent) return;
+
+  mySettings.setValue(SETTING_DYNAMIC_RATE, dynamicRate);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AudioSettings::setVolume(uInt32 volume)
 {
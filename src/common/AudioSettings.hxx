@@ -37,7 +37,8 @@ class AudioSettings
     enum class ResamplingQuality {
       nearestNeightbour   = 1,
       lanczos_2           = 2,
-      lanczos_3           = 3
+      lanczos_3           = 3,
+      polyphase           = 4
     };
 
     static constexpr const char* SETTING_PRESET              = "audio.preset";
@@ -46,10 +47,13 @@ class AudioSettings
     static constexpr const char* SETTING_BUFFER_SIZE         = "audio.buffer_size";
     static constexpr const char* SETTING_HEADROOM            = "audio.headroom";
     static constexpr const char* SETTING_RESAMPLING_QUALITY  = "audio.resampling_quality";
+    static constexpr const char* SETTING_RESAMPLING_TAPS     = "audio.resampling_taps";
     static constexpr const char* SETTING_STEREO              = "audio.stereo";
     static constexpr const char* SETTING_VOLUME              = "audio.volume";
     static constexpr const char* SETTING_ENABLED             = "audio.enabled";
     static constexpr const char* SETTING_DPC_PITCH           = "audio.dpc_pitch";
+    static constexpr const char* SETTING_AUTOTUNE            = "audio.autotune";
+    static constexpr const char* SETTING_DYNAMIC_RATE        = "audio.dynamic_rate";
 
     static constexpr Preset DEFAULT_PRESET                          = Preset::highQualityMediumLag;
     static constexpr uInt32 DEFAULT_SAMPLE_RATE                     = 44100;
@@ -57,13 +61,17 @@ class AudioSettings
     static constexpr uInt32 DEFAULT_BUFFER_SIZE                     = 3;
     static constexpr uInt32 DEFAULT_HEADROOM                        = 2;
     static constexpr ResamplingQuality DEFAULT_RESAMPLING_QUALITY   = ResamplingQuality::lanczos_2;
+    static constexpr uInt32 DEFAULT_RESAMPLING_TAPS                 = 4;
     static constexpr bool DEFAULT_STEREO                            = false;
     static constexpr uInt32 DEFAULT_VOLUME                          = 80;
     static constexpr bool DEFAULT_ENABLED                           = true;
     static constexpr uInt32 DEFAULT_DPC_PITCH                       = 20000;
+    static constexpr bool DEFAULT_AUTOTUNE                          = false;
+    static constexpr bool DEFAULT_DYNAMIC_RATE                      = false;
 
     static constexpr int MAX_BUFFER_SIZE = 10;
     static constexpr int MAX_HEADROOM    = 10;
+    static constexpr int MAX_RESAMPLING_TAPS = 16;
 
   public:
 
@@ -83,6 +91,12 @@ class AudioSettings
 
     ResamplingQuality resamplingQuality();
 
+    /**
+      The number of taps of the polyphase resampler (an even number); more
+      taps give better quality at a higher cost.
+     */
+    uInt32 resamplingTaps() const;
+
     bool stereo() const;
 
     uInt32 volume() const;
@@ -91,6 +105,10 @@ class AudioSettings
 
     uInt32 dpcPitch() const;
 
+    bool autotune() const;
+
+    bool dynamicRate() const;
+
     void setPreset(Preset preset);
 
     void setSampleRate(uInt32 sampleRate);
@@ -103,10 +121,16 @@ class AudioSettings
 
     void setResamplingQuality(ResamplingQuality resamplingQuality);
 
+    void setResamplingTaps(uInt32 taps);
+
     void setStereo(bool allROMs);
 
     void setDpcPitch(uInt32 pitch);
 
+    void setAutotune(bool autotune);
+
+    void setDynamicRate(bool dynamicRate);
+
     void setVolume(uInt32 volume);
 
     void setEnabled(bool isEnabled);
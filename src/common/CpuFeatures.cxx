@@ -0,0 +1,121 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <map>
+#include <mutex>
+
+#include "Logger.hxx"
+#include "CpuFeatures.hxx"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  #include <intrin.h>
+#endif
+
+namespace {
+  uInt32 detectFeatures()
+  {
+    uInt32 features = CpuFeatures::NONE;
+
+  #if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("sse2"))   features |= CpuFeatures::SSE2;
+    if(__builtin_cpu_supports("sse4.1")) features |= CpuFeatures::SSE41;
+    if(__builtin_cpu_supports("avx2"))   features |= CpuFeatures::AVX2;
+  #elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    if(info[3] & (1 << 26)) features |= CpuFeatures::SSE2;
+    if(info[2] & (1 << 19)) features |= CpuFeatures::SSE41;
+
+    // AVX2 also needs the OS to save the YMM registers (OSXSAVE and XCR0)
+    const bool osYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+    if(maxLeaf >= 7 && osYmm)
+    {
+      __cpuidex(info, 7, 0);
+      if(info[1] & (1 << 5)) features |= CpuFeatures::AVX2;
+    }
+  #elif defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+    // Part of the baseline on 64-bit ARM, and of the build on 32-bit ARM
+    features |= CpuFeatures::NEON;
+  #endif
+
+    return features;
+  }
+
+  uInt32 cpuFeatures()
+  {
+    static const uInt32 features = detectFeatures();
+    return features;
+  }
+
+  std::mutex kernelMutex;
+  std::map<string, string> kernelVariants;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CpuFeatures::detect()
+{
+  cpuFeatures();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CpuFeatures::has(uInt32 features)
+{
+  return (cpuFeatures() & features) == features;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string CpuFeatures::features()
+{
+  const uInt32 features = cpuFeatures();
+  ostringstream buf;
+
+  if(features & SSE2)  buf << " SSE2";
+  if(features & SSE41) buf << " SSE4.1";
+  if(features & AVX2)  buf << " AVX2";
+  if(features & NEON)  buf << " NEON";
+
+  return features != NONE ? buf.str().substr(1) : "none";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string CpuFeatures::kernels()
+{
+  std::lock_guard<std::mutex> lock(kernelMutex);
+  ostringstream buf;
+
+  for(const auto& variant: kernelVariants)
+    buf << ", " << variant.first << ": " << variant.second;
+
+  return !kernelVariants.empty() ? buf.str().substr(2) : "none";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CpuFeatures::selected(const string& family, const string& name)
+{
+  std::lock_guard<std::mutex> lock(kernelMutex);
+  string& variant = kernelVariants[family];
+
+  if(variant != name)
+  {
+    variant = name;
+    Logger::info("Using " + name + " " + family + " kernel");
+  }
+}
@@ -0,0 +1,122 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef CPU_FEATURES_HXX
+#define CPU_FEATURES_HXX
+
+#include "bspf.hxx"
+
+/**
+  Kernels for x86 instruction sets beyond the baseline of the build are
+  compiled for their target only (CPU_TARGET("avx2") etc.), and must only
+  be called once CpuFeatures reports the instruction set.  MSVC doesn't
+  need (nor support) the attribute.
+*/
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define CPU_X86_KERNELS
+  #define CPU_TARGET(isa) __attribute__((target(isa)))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  #define CPU_X86_KERNELS
+  #define CPU_TARGET(isa)
+#endif
+
+/**
+  Detects the SIMD instruction sets of the CPU we run on, and selects the
+  best variant of a kernel from those compiled in.  Every kernel family
+  (e.g. the phosphor blend) lists its variants, best first and ending with
+  the portable one; the first whose instruction sets are all available is
+  used from then on, through a plain function pointer.
+
+  The selected variants are recorded by family, for the log and the
+  video system information.
+
+  @author  Stephen Anthony
+*/
+class CpuFeatures
+{
+  public:
+    enum Feature : uInt32 {
+      NONE  = 0,
+      SSE2  = 1 << 0,
+      SSE41 = 1 << 1,
+      AVX2  = 1 << 2,
+      NEON  = 1 << 3
+    };
+
+    template<typename Fn>
+    struct Variant {
+      const char* name;
+      uInt32 features;  // all of them are required
+      Fn kernel;
+    };
+
+  public:
+    /**
+      Detect the features of the CPU; later calls do nothing.
+    */
+    static void detect();
+
+    /**
+      Whether all of the given features are available.
+    */
+    static bool has(uInt32 features);
+
+    /**
+      The available features, e.g. "SSE2 SSE4.1 AVX2".
+    */
+    static string features();
+
+    /**
+      The selected variant of each kernel family, e.g. "phosphor: avx2".
+    */
+    static string kernels();
+
+    /**
+      Select the best available variant of a kernel family.
+
+      @param family    The name of the family
+      @param variants  The variants, best first; the last one must not
+                       require any features
+      @return  The kernel of the selected variant
+    */
+    template<typename Fn, size_t N>
+    static Fn select(const char* family, const Variant<Fn> (&variants)[N])
+    {
+      static_assert(N > 0, "A kernel family needs at least one variant");
+
+      size_t i = 0;
+      while(i < N - 1 && !has(variants[i].features))
+        ++i;
+
+      selected(family, variants[i].name);
+      return variants[i].kernel;
+    }
+
+  private:
+    // Record the variant selected for a family
+    static void selected(const string& family, const string& name);
+
+  private:
+    // Following constructors and assignment operators not supported
+    CpuFeatures() = delete;
+    CpuFeatures(const CpuFeatures&) = delete;
+    CpuFeatures(CpuFeatures&&) = delete;
+    CpuFeatures& operator=(const CpuFeatures&) = delete;
+    CpuFeatures& operator=(CpuFeatures&&) = delete;
+};
+
+#endif
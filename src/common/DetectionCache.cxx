@@ -0,0 +1,108 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "repository/KeyValueRepository.hxx"
+#include "DetectionCache.hxx"
+
+namespace {
+  // Increase this whenever the detection changes, to discard old results
+  constexpr uInt32 VERSION = 1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+DetectionCache::DetectionCache(shared_ptr<KeyValueRepository> repository)
+  : myRepository(repository)
+{
+  // Values are stored as '<version> <value>'
+  for(const auto& pair: myRepository->load())
+  {
+    istringstream buf(pair.second.toString());
+    uInt32 version = 0;
+    string value;
+
+    if(buf >> version >> value && version == VERSION)
+      myValues[pair.first] = value;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool DetectionCache::findFormat(const string& md5, string& format) const
+{
+  return find(md5, format);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DetectionCache::insertFormat(const string& md5, const string& format)
+{
+  insert(md5, format);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool DetectionCache::findYStart(const string& md5, FrameLayout layout,
+                                uInt32& ystart) const
+{
+  string value;
+  if(!find(yStartKey(md5, layout), value))
+    return false;
+
+  ystart = atoi(value.c_str());
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DetectionCache::insertYStart(const string& md5, FrameLayout layout,
+                                  uInt32 ystart)
+{
+  insert(yStartKey(md5, layout), std::to_string(ystart));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool DetectionCache::find(const string& key, string& value) const
+{
+  if(key.empty())
+    return false;
+
+  const auto iter = myValues.find(key);
+  if(iter == myValues.end())
+    return false;
+
+  value = iter->second;
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DetectionCache::insert(const string& key, const string& value)
+{
+  if(key.empty())
+    return;
+
+  auto iter = myValues.find(key);
+  if(iter != myValues.end() && iter->second == value)
+    return;
+
+  myValues[key] = value;
+  myRepository->save(key, std::to_string(VERSION) + " " + value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string DetectionCache::yStartKey(const string& md5, FrameLayout layout)
+{
+  if(md5.empty())
+    return EmptyString;
+
+  return md5 + (layout == FrameLayout::pal ? ":ystart:pal" : ":ystart:ntsc");
+}
@@ -0,0 +1,89 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef DETECTION_CACHE_HXX
+#define DETECTION_CACHE_HXX
+
+class KeyValueRepository;
+
+#include <unordered_map>
+
+#include "bspf.hxx"
+#include "FrameLayout.hxx"
+
+/**
+  A persistent cache of the display format and ystart autodetected for
+  each ROM, keyed by its MD5.  Detection takes a few dozen frames of
+  emulation, so this makes loading a ROM again (almost) instant.
+
+  Entries are written to the repository (the SQLite database, if
+  available) as soon as they are inserted.  Entries of older versions of
+  the detection are ignored, since they might differ.
+
+  @author  Stephen Anthony
+*/
+class DetectionCache
+{
+  public:
+    explicit DetectionCache(shared_ptr<KeyValueRepository> repository);
+
+    /**
+      Get the display format ("NTSC" or "PAL") detected for the given ROM.
+
+      @return  False if it isn't cached
+    */
+    bool findFormat(const string& md5, string& format) const;
+
+    /**
+      Remember the display format detected for the given ROM.
+    */
+    void insertFormat(const string& md5, const string& format);
+
+    /**
+      Get the ystart detected for the given ROM and frame layout.
+
+      @return  False if it isn't cached
+    */
+    bool findYStart(const string& md5, FrameLayout layout, uInt32& ystart) const;
+
+    /**
+      Remember the ystart detected for the given ROM and frame layout.
+    */
+    void insertYStart(const string& md5, FrameLayout layout, uInt32 ystart);
+
+  private:
+    bool find(const string& key, string& value) const;
+    void insert(const string& key, const string& value);
+
+    static string yStartKey(const string& md5, FrameLayout layout);
+
+  private:
+    shared_ptr<KeyValueRepository> myRepository;
+
+    // Values without the version prefix
+    std::unordered_map<string, string> myValues;
+
+  private:
+    // Following constructors and assignment operators not supported
+    DetectionCache() = delete;
+    DetectionCache(const DetectionCache&) = delete;
+    DetectionCache(DetectionCache&&) = delete;
+    DetectionCache& operator=(const DetectionCache&) = delete;
+    DetectionCache& operator=(DetectionCache&&) = delete;
+};
+
+#endif // DETECTION_CACHE_HXX
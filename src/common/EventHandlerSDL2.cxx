@@ -58,6 +58,15 @@ void EventHandlerSDL2::enableTextEvents(bool enable)
     SDL_StopTextInput();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EventHandlerSDL2::waitEvent(uInt32 timeout)
+{
+  ASSERT_MAIN_THREAD;
+
+  // The event stays in the queue for the next pollEvent()
+  SDL_WaitEventTimeout(nullptr, int(timeout));
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void EventHandlerSDL2::pollEvent()
 {
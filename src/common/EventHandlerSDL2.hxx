@@ -49,6 +49,11 @@ class EventHandlerSDL2 : public EventHandler
     */
     void pollEvent() override;
 
+    /**
+      Waits for the next SDL2 event, or until the timeout has passed.
+    */
+    void waitEvent(uInt32 timeout) override;
+
   private:
     SDL_Event myEvent;
 
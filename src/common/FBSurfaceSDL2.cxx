@@ -31,7 +31,17 @@ FBSurfaceSDL2::FBSurfaceSDL2(FrameBufferSDL2& buffer,
     myTexAccess(SDL_TEXTUREACCESS_STREAMING),
     myInterpolate(false),
     myBlendEnabled(false),
-    myBlendAlpha(255)
+    myBlendAlpha(255),
+    myPersistTexture(nullptr),
+    myScaledTexture(nullptr),
+    mySharpScaling(false),
+    myPersistence(false),
+    myPersistDecay(0),
+    myDirtyTop(0),
+    myDirtyBottom(0),
+    myPrevDirtyTop(0),
+    myPrevDirtyBottom(0),
+    myTextureLocked(false)
 {
   createSurface(width, height, data);
 }
@@ -119,6 +129,10 @@ void FBSurfaceSDL2::setDstSize(uInt32 w, uInt32 h)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FBSurfaceSDL2::setVisible(bool visible)
 {
+  // Changes made while hidden are not tracked
+  if(visible && !myIsVisible)
+    markAllRowsDirty();
+
   myIsVisible = visible;
 }
 
@@ -139,18 +153,102 @@ bool FBSurfaceSDL2::render()
     SDL_Texture* texture = myTexture;
 
     if(myTexAccess == SDL_TEXTUREACCESS_STREAMING) {
-      SDL_UpdateTexture(myTexture, &mySrcR, mySurface->pixels, mySurface->pitch);
+      // Upload the rows changed since this texture was last used, unless
+      // they were rendered into the texture directly
+      uInt32 top, bottom;
+      changedRows(top, bottom);
+
+      if(myTextureLocked)
+      {
+        SDL_UnlockTexture(myTexture);
+        myTextureLocked = false;
+      }
+      else if(top < bottom)
+      {
+        const SDL_Rect rect = { mySrcR.x, int(top), mySrcR.w, int(bottom - top) };
+        const uInt8* pixels = static_cast<const uInt8*>(mySurface->pixels) +
+            top * mySurface->pitch + mySrcR.x * myFB.myPixelFormat->BytesPerPixel;
+        SDL_UpdateTexture(myTexture, &rect, pixels, mySurface->pitch);
+      }
       myTexture = mySecondaryTexture;
       mySecondaryTexture = texture;
+
+      // Unless told otherwise, assume everything changes for the next frame
+      myPrevDirtyTop = myDirtyTop;  myPrevDirtyBottom = myDirtyBottom;
+      myDirtyTop = 0;  myDirtyBottom = mySurface->h;
+    }
+
+    if(myPersistTexture)
+    {
+      SDL_Renderer* renderer = myFB.myRenderer;
+
+      // Decay the previous image, then raise it to the current one
+      SDL_SetRenderTarget(renderer, myPersistTexture);
+      SDL_SetRenderDrawBlendMode(renderer, myFB.myDecayBlendMode);
+      SDL_SetRenderDrawColor(renderer, myPersistDecay, myPersistDecay, myPersistDecay, 255);
+      SDL_RenderFillRect(renderer, &mySrcR);
+      SDL_RenderCopy(renderer, texture, &mySrcR, &mySrcR);
+
+      SDL_SetRenderTarget(renderer, nullptr);
+      SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+      SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+      texture = myPersistTexture;
     }
 
-    SDL_RenderCopy(myFB.myRenderer, texture, &mySrcR, &myDstR);
+    if(!mySharpScaling || !renderSharp(texture))
+      SDL_RenderCopy(myFB.myRenderer, texture, &mySrcR, &myDstR);
 
     return true;
   }
   return false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FBSurfaceSDL2::renderSharp(SDL_Texture* texture)
+{
+  if(mySrcR.w <= 0 || mySrcR.h <= 0)
+    return false;
+
+  // Scale blocky by the largest integer factor that fits; an integer
+  // scaled image has no pixels to blend, so it is drawn as-is
+  const SDL_Rect rect = { 0, 0, mySrcR.w * std::max(1, myDstR.w / mySrcR.w),
+                                mySrcR.h * std::max(1, myDstR.h / mySrcR.h) };
+  if(rect.w == myDstR.w && rect.h == myDstR.h)
+    return false;
+
+  SDL_Renderer* renderer = myFB.myRenderer;
+
+  int w = 0, h = 0;
+  if(myScaledTexture)
+    SDL_QueryTexture(myScaledTexture, nullptr, nullptr, &w, &h);
+  if(w != rect.w || h != rect.h)
+  {
+    if(myScaledTexture)
+      SDL_DestroyTexture(myScaledTexture);
+
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "1");
+    myScaledTexture = SDL_CreateTexture(renderer, myFB.myPixelFormat->format,
+        SDL_TEXTUREACCESS_TARGET, rect.w, rect.h);
+    if(!myScaledTexture)
+      return false;
+
+    applyBlending();
+  }
+
+  // Only the final, smoothed copy is blended
+  SDL_BlendMode mode;
+  SDL_GetTextureBlendMode(texture, &mode);
+  SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+  SDL_SetRenderTarget(renderer, myScaledTexture);
+  SDL_RenderCopy(renderer, texture, &mySrcR, &rect);
+  SDL_SetRenderTarget(renderer, nullptr);
+  SDL_SetTextureBlendMode(texture, mode);
+
+  SDL_RenderCopy(renderer, myScaledTexture, &rect, &myDstR);
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FBSurfaceSDL2::invalidate()
 {
@@ -171,6 +269,18 @@ void FBSurfaceSDL2::free()
     SDL_DestroyTexture(myTexture);
     myTexture = nullptr;
   }
+
+  if(myPersistTexture)
+  {
+    SDL_DestroyTexture(myPersistTexture);
+    myPersistTexture = nullptr;
+  }
+
+  if(myScaledTexture)
+  {
+    SDL_DestroyTexture(myScaledTexture);
+    myScaledTexture = nullptr;
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -178,8 +288,18 @@ void FBSurfaceSDL2::reload()
 {
   ASSERT_MAIN_THREAD;
 
+  // New textures have undefined contents
+  markAllRowsDirty();
+  myTextureLocked = false;
+
+  // Smoothing is done by scaling blocky to an integer multiple first, and
+  // then smoothing only the remaining fraction (sharp bilinear), which
+  // needs render targets; otherwise the texture itself is smoothed
+  mySharpScaling = myInterpolate && SDL_RenderTargetSupported(myFB.myRenderer);
+
   // Re-create texture; the underlying SDL_Surface is fine as-is
-  SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, myInterpolate ? "1" : "0");
+  SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY,
+              myInterpolate && !mySharpScaling ? "1" : "0");
   myTexture = SDL_CreateTexture(myFB.myRenderer, myFB.myPixelFormat->format,
       myTexAccess, mySurface->w, mySurface->h);
 
@@ -191,7 +311,16 @@ void FBSurfaceSDL2::reload()
   if(myTexAccess == SDL_TEXTUREACCESS_STATIC)
     SDL_UpdateTexture(myTexture, nullptr, myStaticData.get(), myStaticPitch);
 
-  SDL_Texture* textures[] = {myTexture, mySecondaryTexture};
+  applyBlending();
+
+  if(myPersistence && !createPersistence())
+    myPersistence = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FBSurfaceSDL2::applyBlending()
+{
+  SDL_Texture* textures[] = {myTexture, mySecondaryTexture, myScaledTexture};
   for (SDL_Texture* texture: textures) {
     if (!texture) continue;
 
@@ -201,6 +330,8 @@ void FBSurfaceSDL2::reload()
       SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
       SDL_SetTextureAlphaMod(texture, myBlendAlpha);
     }
+    else
+      SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
   }
 }
 
@@ -221,6 +352,120 @@ void FBSurfaceSDL2::resize(uInt32 width, uInt32 height)
   createSurface(width, height, nullptr);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FBSurfaceSDL2::setDirtyRows(uInt32 top, uInt32 bottom)
+{
+  myDirtyTop = top;
+  myDirtyBottom = bottom;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FBSurfaceSDL2::lockRows(uInt32& top, uInt32& bottom, uInt32*& pixels,
+                             uInt32& pitch)
+{
+  ASSERT_MAIN_THREAD;
+
+  if(myTexAccess != SDL_TEXTUREACCESS_STREAMING || !myIsVisible || myTextureLocked)
+    return false;
+
+  // The texture still holds the image before the previous one, so the
+  // rows changed in both frames must be written
+  setDirtyRows(top, bottom);
+  changedRows(top, bottom);
+  if(top >= bottom)
+  {
+    bottom = top;
+    return true;  // nothing to render at all
+  }
+
+  const SDL_Rect rect = { mySrcR.x, int(top), mySrcR.w, int(bottom - top) };
+  void* locked;
+  int lockedPitch;
+  if(SDL_LockTexture(myTexture, &rect, &locked, &lockedPitch) != 0)
+    return false;
+
+  myTextureLocked = true;
+  pixels = static_cast<uInt32*>(locked);
+  pitch = uInt32(lockedPitch) / myFB.myPixelFormat->BytesPerPixel;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FBSurfaceSDL2::changedRows(uInt32& top, uInt32& bottom) const
+{
+  top = myDirtyTop;  bottom = myDirtyBottom;
+  if(top >= bottom)
+  {
+    top = myPrevDirtyTop;  bottom = myPrevDirtyBottom;
+  }
+  else if(myPrevDirtyTop < myPrevDirtyBottom)
+  {
+    top = std::min(top, myPrevDirtyTop);
+    bottom = std::max(bottom, myPrevDirtyBottom);
+  }
+  top = std::max(top, uInt32(mySrcR.y));
+  bottom = std::min(bottom, uInt32(mySrcR.y + mySrcR.h));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FBSurfaceSDL2::markAllRowsDirty()
+{
+  myDirtyTop = myPrevDirtyTop = 0;
+  myDirtyBottom = myPrevDirtyBottom = mySurface->h;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FBSurfaceSDL2::enablePersistence(bool enable, float decay)
+{
+  ASSERT_MAIN_THREAD;
+
+  myPersistDecay = uInt8(BSPF::clamp(decay, 0.0F, 1.0F) * 255);
+  if(enable == myPersistence)
+    return myPersistence;
+
+  myPersistence = enable;
+  free();
+  reload();
+
+  return myPersistence;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FBSurfaceSDL2::createPersistence()
+{
+  // Only streamed images change between frames, and both custom blend
+  // modes must be available in the current renderer
+  if(myTexAccess != SDL_TEXTUREACCESS_STREAMING || !myFB.myPersistenceSupported)
+    return false;
+
+  SDL_Renderer* renderer = myFB.myRenderer;
+
+  SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY,
+              myInterpolate && !mySharpScaling ? "1" : "0");
+  myPersistTexture = SDL_CreateTexture(renderer, myFB.myPixelFormat->format,
+      SDL_TEXTUREACCESS_TARGET, mySurface->w, mySurface->h);
+  if(!myPersistTexture)
+    return false;
+
+  bool ok = SDL_SetTextureBlendMode(myTexture, myFB.myMaxBlendMode) == 0 &&
+            SDL_SetTextureBlendMode(mySecondaryTexture, myFB.myMaxBlendMode) == 0;
+
+  // Start out with a black image
+  ok = ok && SDL_SetRenderTarget(renderer, myPersistTexture) == 0;
+  SDL_RenderClear(renderer);
+  SDL_SetRenderTarget(renderer, nullptr);
+
+  if(!ok)
+  {
+    SDL_SetTextureBlendMode(myTexture, SDL_BLENDMODE_NONE);
+    SDL_SetTextureBlendMode(mySecondaryTexture, SDL_BLENDMODE_NONE);
+    SDL_DestroyTexture(myPersistTexture);
+    myPersistTexture = nullptr;
+  }
+  return ok;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FBSurfaceSDL2::createSurface(uInt32 width, uInt32 height,
                                   const uInt32* data)
@@ -263,14 +508,22 @@ void FBSurfaceSDL2::createSurface(uInt32 width, uInt32 height,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FBSurfaceSDL2::applyAttributes(bool immediate)
 {
+  const bool interpolate = myInterpolate;
+
   myInterpolate  = myAttributes.smoothing;
   myBlendEnabled = myAttributes.blending;
   myBlendAlpha   = uInt8(myAttributes.blendalpha * 2.55);
 
   if(immediate)
   {
-    // Re-create the texture with the new settings
-    free();
-    reload();
+    // Scaling quality is fixed when a texture is created, so only then
+    // the textures must be re-created (which causes a visible hitch)
+    if(interpolate != myInterpolate || !myTexture)
+    {
+      free();
+      reload();
+    }
+    else if(!myPersistTexture)  // persistence uses its own blend modes
+      applyBlending();
   }
 }
@@ -59,12 +59,21 @@ class FBSurfaceSDL2 : public FBSurface
     void free() override;
     void reload() override;
     void resize(uInt32 width, uInt32 height) override;
+    bool enablePersistence(bool enable, float decay) override;
+    void setDirtyRows(uInt32 top, uInt32 bottom) override;
+    bool lockRows(uInt32& top, uInt32& bottom, uInt32*& pixels,
+                  uInt32& pitch) override;
 
   protected:
     void applyAttributes(bool immediate) override;
 
   private:
     void createSurface(uInt32 width, uInt32 height, const uInt32* data);
+    bool createPersistence();
+    bool renderSharp(SDL_Texture* texture);
+    void markAllRowsDirty();
+    void changedRows(uInt32& top, uInt32& bottom) const;
+    void applyBlending();
 
     // Following constructors and assignment operators not supported
     FBSurfaceSDL2() = delete;
@@ -89,6 +98,20 @@ class FBSurfaceSDL2 : public FBSurface
     bool myBlendEnabled;  // Blending is enabled
     uInt8 myBlendAlpha;   // Alpha to use in blending mode
 
+    SDL_Texture* myPersistTexture;  // Render target holding the last image
+    bool myPersistence;             // Phosphor persistence is done in hardware
+    uInt8 myPersistDecay;           // Decay of the previous image (0 - 255)
+
+    SDL_Texture* myScaledTexture;   // Render target holding the integer scaled image
+    bool mySharpScaling;            // Smoothing is done on the integer scaled image
+
+    // Rows changed for this and the previous frame; since two textures are
+    // streamed in turn, each upload must cover both
+    uInt32 myDirtyTop, myDirtyBottom, myPrevDirtyTop, myPrevDirtyBottom;
+
+    // The streaming texture is locked, and was rendered into directly
+    bool myTextureLocked;
+
     unique_ptr<uInt32[]> myStaticData; // The data to use when the buffer contents are static
     uInt32 myStaticPitch;              // The number of bytes in a row of static data
 
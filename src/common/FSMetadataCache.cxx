@@ -0,0 +1,102 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <mutex>
+#include <unordered_map>
+
+#include "FSMetadataCache.hxx"
+
+constexpr std::chrono::milliseconds FSMetadataCache::LIFETIME;
+constexpr size_t FSMetadataCache::MAX_ENTRIES;
+
+namespace {
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    FSMetadataCache::Metadata metadata;
+    Clock::time_point expires;
+  };
+
+  std::mutex cacheMutex;
+  std::unordered_map<string, Entry> cache;
+
+  // The path with a trailing separator removed
+  string key(const string& path)
+  {
+    if(path.size() > 1 && (path.back() == '/' || path.back() == '\\'))
+      return path.substr(0, path.size() - 1);
+
+    return path;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FSMetadataCache::find(const string& path, Metadata& metadata)
+{
+  std::lock_guard<std::mutex> lock(cacheMutex);
+
+  const auto iter = cache.find(key(path));
+  if(iter == cache.end())
+    return false;
+
+  if(Clock::now() >= iter->second.expires)
+  {
+    cache.erase(iter);
+    return false;
+  }
+  metadata = iter->second.metadata;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FSMetadataCache::insert(const string& path, const Metadata& metadata)
+{
+  const Clock::time_point now = Clock::now();
+  std::lock_guard<std::mutex> lock(cacheMutex);
+
+  // Browsing large directories would grow the cache without bound; drop
+  // the expired entries first, and everything if that isn't enough
+  if(cache.size() >= MAX_ENTRIES)
+  {
+    for(auto iter = cache.begin(); iter != cache.end(); )
+      iter = now >= iter->second.expires ? cache.erase(iter) : std::next(iter);
+
+    if(cache.size() >= MAX_ENTRIES)
+      cache.clear();
+  }
+
+  Entry& entry = cache[key(path)];
+  entry.metadata = metadata;
+  entry.expires = now + LIFETIME;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FSMetadataCache::invalidate(const string& path)
+{
+  std::lock_guard<std::mutex> lock(cacheMutex);
+
+  cache.erase(key(path));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FSMetadataCache::clear()
+{
+  std::lock_guard<std::mutex> lock(cacheMutex);
+
+  cache.clear();
+}
@@ -0,0 +1,85 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef FS_METADATA_CACHE_HXX
+#define FS_METADATA_CACHE_HXX
+
+#include <chrono>
+
+#include "bspf.hxx"
+
+/**
+  A short-lived cache of filesystem metadata, shared by all filesystem
+  nodes of the process.  Opening a ROM creates and queries nodes for the
+  same paths several times; on network shares, each of these queries is
+  a round trip to the server.
+
+  Entries expire after LIFETIME, so changes made by other programs show
+  up soon.  Changes made by Stella itself must invalidate the affected
+  paths (see FilesystemNode::invalidateCache()).
+
+  @author  Stephen Anthony
+*/
+class FSMetadataCache
+{
+  public:
+    static constexpr std::chrono::milliseconds LIFETIME{2000};
+    static constexpr size_t MAX_ENTRIES = 512;
+
+    struct Metadata {
+      bool exists{false};
+      bool isFile{false};
+      bool isDirectory{false};
+      uInt64 size{0};
+      uInt64 modified{0};
+      Int8 readable{-1};    // -1 = not queried yet
+    };
+
+  public:
+    /**
+      Get the metadata of the given path, if it is cached and still fresh.
+
+      @return  False if it isn't cached
+    */
+    static bool find(const string& path, Metadata& metadata);
+
+    /**
+      Remember the metadata of the given path.
+    */
+    static void insert(const string& path, const Metadata& metadata);
+
+    /**
+      Forget the metadata of the given path, with or without a trailing
+      separator.
+    */
+    static void invalidate(const string& path);
+
+    /**
+      Forget the metadata of all paths.
+    */
+    static void clear();
+
+  private:
+    // Following constructors and assignment operators not supported
+    FSMetadataCache() = delete;
+    FSMetadataCache(const FSMetadataCache&) = delete;
+    FSMetadataCache(FSMetadataCache&&) = delete;
+    FSMetadataCache& operator=(const FSMetadataCache&) = delete;
+    FSMetadataCache& operator=(FSMetadataCache&&) = delete;
+};
+
+#endif // FS_METADATA_CACHE_HXX
@@ -18,6 +18,7 @@
 #if defined(ZIP_SUPPORT)
 
 #include <set>
+#include <mutex>
 
 #include "bspf.hxx"
 #include "Bankswitch.hxx"
@@ -48,10 +49,24 @@ FilesystemNodeZIP::FilesystemNodeZIP(const string& p)
 
   _zipFile = p.substr(0, pos+4);
 
-  // Open file at least once to initialize the virtual file count
+  // The contents are accessed below, and must not change in the meantime
+  std::lock_guard<std::recursive_mutex> lock(myMutex);
+
+  // Create a concrete FSNode to use
+  // This *must not* be a ZIP file; it must be a real FSNode object that
+  // has direct access to the actual filesystem (aka, a 'System' node)
+  // Behind the scenes, this node is actually a platform-specific object
+  // for whatever system we are running on
+  AbstractFSNodePtr realNode =
+      FilesystemNodeFactory::create(_zipFile, FilesystemNodeFactory::Type::SYSTEM);
+
+  // Get the contents at least once to initialize the virtual file count
+  const vector<string>* files = nullptr;
   try
   {
-    myZipHandler->open(_zipFile);
+    const Contents& c = contents(_zipFile, realNode);
+    _numFiles = c.romFiles;
+    files = &c.files;
   }
   catch(const runtime_error&)
   {
@@ -59,7 +74,6 @@ FilesystemNodeZIP::FilesystemNodeZIP(const string& p)
     //       For now, we just indicate that no ROMs were found
     _error = zip_error::NO_ROMS;
   }
-  _numFiles = myZipHandler->romFiles();
   if(_numFiles == 0)
   {
     _error = zip_error::NO_ROMS;
@@ -76,15 +90,15 @@ FilesystemNodeZIP::FilesystemNodeZIP(const string& p)
   else if(_numFiles == 1)
   {
     bool found = false;
-    while(myZipHandler->hasNext() && !found)
+    for(const auto& file: *files)
     {
-      const string& file = myZipHandler->next();
       if(Bankswitch::isValidRomName(file))
       {
         _virtualPath = file;
         _isFile = true;
 
         found = true;
+        break;
       }
     }
     if(!found)
@@ -93,14 +107,7 @@ FilesystemNodeZIP::FilesystemNodeZIP(const string& p)
   else if(_numFiles > 1)
     _isDirectory = true;
 
-  // Create a concrete FSNode to use
-  // This *must not* be a ZIP file; it must be a real FSNode object that
-  // has direct access to the actual filesystem (aka, a 'System' node)
-  // Behind the scenes, this node is actually a platform-specific object
-  // for whatever system we are running on
-  _realNode = FilesystemNodeFactory::create(_zipFile, FilesystemNodeFactory::Type::SYSTEM);
-
-  setFlags(_zipFile, _virtualPath, _realNode);
+  setFlags(_zipFile, _virtualPath, realNode);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -148,13 +155,12 @@ bool FilesystemNodeZIP::getChildren(AbstractFSList& myList, ListMode mode) const
   if(!isDirectory() || _error != zip_error::NONE)
     return false;
 
+  std::lock_guard<std::recursive_mutex> lock(myMutex);
   std::set<string> dirs;
-  myZipHandler->open(_zipFile);
-  while(myZipHandler->hasNext())
+  for(const auto& next: contents(_zipFile, _realNode).files)
   {
     // Only consider entries that start with '_virtualPath'
     // Ignore empty filenames and '__MACOSX' virtual directories
-    const string& next = myZipHandler->next();
     if(BSPF::startsWithIgnoreCase(next, "__MACOSX") || next == EmptyString)
       continue;
     if(BSPF::startsWithIgnoreCase(next, _virtualPath))
@@ -190,6 +196,7 @@ uInt32 FilesystemNodeZIP::read(ByteBuffer& image) const
     case zip_error::NO_ROMS:      throw runtime_error("ZIP file doesn't contain any ROMs");
   }
 
+  std::lock_guard<std::recursive_mutex> lock(myMutex);
   myZipHandler->open(_zipFile);
 
   bool found = false;
@@ -211,7 +218,80 @@ AbstractFSNodePtr FilesystemNodeZIP::getParent() const
   return make_shared<FilesystemNodeZIP>(string(start, end - start - 1));
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FilesystemNodeZIP::setIndexRepository(shared_ptr<KeyValueRepository> repository)
+{
+  std::lock_guard<std::recursive_mutex> lock(myMutex);
+  myIndexRepository = repository;
+  myIndex.clear();
+  if(!myIndexRepository)
+    return;
+
+  // Each entry is stored as 'size modified romfiles', followed by the
+  // names of all files, one per line
+  for(const auto& entry: myIndexRepository->load())
+  {
+    istringstream in(entry.second.toString());
+    Contents c;
+    if(!(in >> c.size >> c.modified >> c.romFiles))
+      continue;
+
+    string file;
+    getline(in, file);
+    while(getline(in, file))
+      c.files.push_back(file);
+
+    myIndex.emplace(entry.first, std::move(c));
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const FilesystemNodeZIP::Contents& FilesystemNodeZIP::contents(
+    const string& zipfile, const AbstractFSNodePtr& realnode)
+{
+  std::lock_guard<std::recursive_mutex> lock(myMutex);
+  uInt64 size = 0, modified = 0;
+  const bool indexable = realnode && realnode->getFileInfo(size, modified);
+
+  auto it = myIndex.find(zipfile);
+  if(indexable && it != myIndex.end() &&
+     it->second.size == size && it->second.modified == modified)
+    return it->second;
+
+  // Not indexed (or changed), so the central directory must be scanned
+  Contents c;
+  c.size = size;
+  c.modified = modified;
+
+  myZipHandler->open(zipfile);
+  c.romFiles = myZipHandler->romFiles();
+  while(myZipHandler->hasNext())
+  {
+    const string& file = myZipHandler->next();
+    if(file != EmptyString)
+      c.files.push_back(file);
+  }
+
+  Contents& result = myIndex[zipfile];
+  result = std::move(c);
+
+  if(indexable && myIndexRepository)
+  {
+    ostringstream out;
+    out << result.size << " " << result.modified << " " << result.romFiles;
+    for(const auto& file: result.files)
+      out << "\n" << file;
+
+    myIndexRepository->save(zipfile, out.str());
+  }
+
+  return result;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 unique_ptr<ZipHandler> FilesystemNodeZIP::myZipHandler = make_unique<ZipHandler>();
+std::map<string, FilesystemNodeZIP::Contents> FilesystemNodeZIP::myIndex;
+shared_ptr<KeyValueRepository> FilesystemNodeZIP::myIndexRepository;
+std::recursive_mutex FilesystemNodeZIP::myMutex;
 
 #endif  // ZIP_SUPPORT
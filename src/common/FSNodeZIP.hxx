@@ -20,8 +20,12 @@
 #ifndef FS_NODE_ZIP_HXX
 #define FS_NODE_ZIP_HXX
 
+#include <map>
+#include <mutex>
+
 #include "ZipHandler.hxx"
 #include "FSNode.hxx"
+#include "repository/KeyValueRepository.hxx"
 
 /*
  * Implementation of the Stella file system API based on ZIP archives.
@@ -69,7 +73,28 @@ class FilesystemNodeZIP : public AbstractFSNode
 
     uInt32 read(ByteBuffer& image) const override;
 
+    /**
+     * Set the repository in which the contents of ZIP archives are kept
+     * between sessions, so that large archives don't have to be scanned
+     * each time they are entered.
+     */
+    static void setIndexRepository(shared_ptr<KeyValueRepository> repository);
+
   private:
+    // The files in a ZIP archive, as listed in its central directory
+    struct Contents
+    {
+      uInt64 size, modified;  // of the archive when it was scanned
+      uInt32 romFiles;
+      vector<string> files;
+    };
+
+    // Get the contents of a ZIP archive, scanning it only if it's not
+    // indexed yet or has changed since
+    // An exception will be thrown on any errors
+    static const Contents& contents(const string& zipfile,
+                                    const AbstractFSNodePtr& realnode);
+
     FilesystemNodeZIP(const string& zipfile, const string& virtualpath,
         AbstractFSNodePtr realnode, bool isdir);
 
@@ -109,6 +134,13 @@ class FilesystemNodeZIP : public AbstractFSNode
     // ZipHandler static reference variable responsible for accessing ZIP files
     static unique_ptr<ZipHandler> myZipHandler;
 
+    // The contents of all ZIP archives seen so far, and where they are kept
+    static std::map<string, Contents> myIndex;
+    static shared_ptr<KeyValueRepository> myIndexRepository;
+
+    // Guards the above, since directories may be listed in the background
+    static std::recursive_mutex myMutex;
+
     // Get last component of path
     static const char* lastPathComponent(const string& str)
     {
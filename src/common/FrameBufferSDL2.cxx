@@ -22,6 +22,7 @@
 #include "Console.hxx"
 #include "OSystem.hxx"
 #include "Settings.hxx"
+#include "CpuFeatures.hxx"
 
 #include "ThreadDebugging.hxx"
 #include "FBSurfaceSDL2.hxx"
@@ -32,6 +33,10 @@ FrameBufferSDL2::FrameBufferSDL2(OSystem& osystem)
   : FrameBuffer(osystem),
     myWindow(nullptr),
     myRenderer(nullptr),
+    myMaxBlendMode(SDL_BLENDMODE_NONE),
+    myDecayBlendMode(SDL_BLENDMODE_NONE),
+    myPersistenceSupported(false),
+    myGLFinish(nullptr),
     myCenter(false)
 {
   ASSERT_MAIN_THREAD;
@@ -299,6 +304,10 @@ bool FrameBufferSDL2::setVideoMode(const string& title, const VideoMode& mode)
   const string& video = myOSystem.settings().getString("video");  // Render hint
   if(video != "")
     SDL_SetHint(SDL_HINT_RENDER_DRIVER, video.c_str());
+#if SDL_VERSION_ATLEAST(2,0,10)
+  // Let the renderer combine the copies of all surfaces into few draw calls
+  SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+#endif
   myRenderer = SDL_CreateRenderer(myWindow, -1, renderFlags);
   if(myRenderer == nullptr)
   {
@@ -308,10 +317,42 @@ bool FrameBufferSDL2::setVideoMode(const string& title, const VideoMode& mode)
   }
   clear();
 
+  // Phosphor persistence needs render targets and custom blending, which
+  // not every renderer supports
+#if SDL_VERSION_ATLEAST(2,0,6)
+  // dst = max(src, dst)
+  myMaxBlendMode = SDL_ComposeCustomBlendMode(
+      SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_MAXIMUM,
+      SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_MAXIMUM);
+  // dst = dst * src, where src is the decay as draw colour
+  myDecayBlendMode = SDL_ComposeCustomBlendMode(
+      SDL_BLENDFACTOR_ZERO, SDL_BLENDFACTOR_SRC_COLOR, SDL_BLENDOPERATION_ADD,
+      SDL_BLENDFACTOR_ZERO, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD);
+  myPersistenceSupported = SDL_RenderTargetSupported(myRenderer) &&
+      SDL_SetRenderDrawBlendMode(myRenderer, myDecayBlendMode) == 0;
+  SDL_SetRenderDrawBlendMode(myRenderer, SDL_BLENDMODE_NONE);
+#else
+  myPersistenceSupported = false;
+#endif
+
   SDL_RendererInfo renderinfo;
   if(SDL_GetRendererInfo(myRenderer, &renderinfo) >= 0)
     myOSystem.settings().setValue("video", renderinfo.name);
 
+  // OpenGL drivers may queue up several frames before they are shown,
+  // each adding a frame of latency; so optionally wait for the GPU to
+  // finish every frame (this only works with vsync, as otherwise
+  // presenting doesn't block)
+  myGLFinish = nullptr;
+  if(myOSystem.settings().getBool("gpusync") &&
+     (renderFlags & SDL_RENDERER_PRESENTVSYNC) &&
+     BSPF::startsWithIgnoreCase(myOSystem.settings().getString("video"), "opengl"))
+  {
+    myGLFinish = reinterpret_cast<GLFinishFunc>(SDL_GL_GetProcAddress("glFinish"));
+    if(myGLFinish == nullptr)
+      Logger::info("GPU sync not available: " + string(SDL_GetError()));
+  }
+
   return true;
 }
 
@@ -342,9 +383,11 @@ string FrameBufferSDL2::about() const
                                << info.max_texture_height << endl;
     out << "  Flags: "
         << ((info.flags & SDL_RENDERER_PRESENTVSYNC) ? "+" : "-") << "vsync, "
-        << ((info.flags & SDL_RENDERER_ACCELERATED) ? "+" : "-") << "accel"
+        << ((info.flags & SDL_RENDERER_ACCELERATED) ? "+" : "-") << "accel, "
+        << (myGLFinish ? "+" : "-") << "gpusync"
         << endl;
   }
+  out << "  CPU kernels: " << CpuFeatures::kernels() << endl;
   return out.str();
 }
 
@@ -383,6 +426,10 @@ void FrameBufferSDL2::renderToScreen()
 
   // Show all changes made to the renderer
   SDL_RenderPresent(myRenderer);
+
+  // Don't let the driver queue up frames
+  if(myGLFinish)
+    myGLFinish();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
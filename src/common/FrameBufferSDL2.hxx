@@ -182,6 +182,18 @@ class FrameBufferSDL2 : public FrameBuffer
     // Used by mapRGB (when palettes are created)
     SDL_PixelFormat* myPixelFormat;
 
+    // Custom blend modes for hardware phosphor persistence (see FBSurfaceSDL2)
+    SDL_BlendMode myMaxBlendMode, myDecayBlendMode;
+    bool myPersistenceSupported;
+
+    // Waits for the GPU after each frame (OpenGL renderers only)
+  #ifdef BSPF_WINDOWS
+    using GLFinishFunc = void (__stdcall*)();
+  #else
+    using GLFinishFunc = void (*)();
+  #endif
+    GLFinishFunc myGLFinish;
+
     // Center setting of current window
     bool myCenter;
 
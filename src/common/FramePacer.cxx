@@ -0,0 +1,157 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <cmath>
+#include <thread>
+
+#include "FramePacer.hxx"
+
+using namespace std::chrono;
+
+namespace {
+  // Emulation speed is only corrected by up to 2% to match the display
+  constexpr double MAX_CORRECTION = 0.02;
+
+  // Changes of the correction smaller than this are ignored, since each
+  // change reinitializes the audio
+  constexpr double MIN_CORRECTION_CHANGE = 0.0005;
+
+  // Presenting is considered to wait for vsync if it blocks for more than
+  // this fraction of a frame on average
+  constexpr double MIN_BLOCKED_FRACTION = 0.05;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FramePacer::FramePacer()
+  : myMode(Mode::timer),
+    mySleepMargin(duration_cast<clock::duration>(microseconds(500))),
+    myMaxSleepMargin(duration_cast<clock::duration>(milliseconds(4))),
+    myBlockedTotal(0),
+    myFrameRateTotal(0),
+    myHasLastPresent(false),
+    myRefreshRate(0),
+    mySpeedCorrection(1)
+{
+  myIntervals.reserve(WINDOW_SIZE);
+  reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FramePacer::setMode(Mode mode)
+{
+  myMode = mode;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FramePacer::reset()
+{
+  myVirtualTime = clock::now();
+
+  // Frames presented before the pause don't tell anything about the display
+  myIntervals.clear();
+  myBlockedTotal = myFrameRateTotal = 0;
+  myHasLastPresent = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FramePacer::wait(double timesliceSeconds, double maxLag)
+{
+  myVirtualTime += duration_cast<clock::duration>(duration<double>(timesliceSeconds));
+  clock::time_point now = clock::now();
+
+  if (duration_cast<duration<double>>(now - myVirtualTime).count() > maxLag)
+    // If 6507 time is lagging behind more than allowed we reset it to real time
+    myVirtualTime = now;
+  else if (myVirtualTime > now)
+    // Wait until we have caught up with 6507 time
+    sleepUntil(myVirtualTime);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FramePacer::sleepUntil(clock::time_point deadline)
+{
+  clock::time_point wakeup = deadline - mySleepMargin;
+
+  if (wakeup > clock::now()) {
+    std::this_thread::sleep_until(wakeup);
+
+    // Adapt the margin to the oversleeping observed: grow at once if we
+    // woke up too late, and shrink slowly otherwise
+    clock::duration overslept = clock::now() - wakeup;
+    if (overslept > mySleepMargin)
+      mySleepMargin = std::min(overslept + overslept / 4, myMaxSleepMargin);
+    else
+      mySleepMargin -= (mySleepMargin - overslept) / 64;
+  }
+
+  // Spend the rest of the time yielding
+  while (clock::now() < deadline)
+    std::this_thread::yield();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FramePacer::presented(clock::time_point start, clock::time_point end,
+                           double frameRate)
+{
+  if (myHasLastPresent) {
+    myIntervals.push_back(duration_cast<duration<double>>(end - myLastPresent).count());
+    myBlockedTotal += duration_cast<duration<double>>(end - start).count();
+    myFrameRateTotal += frameRate;
+  }
+  myLastPresent = end;
+  myHasLastPresent = true;
+
+  return myIntervals.size() == WINDOW_SIZE && evaluateWindow();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FramePacer::evaluateWindow()
+{
+  // Individual frames may wait for an extra refresh, or be presented late
+  // because of a hiccup; only the intervals near the median are used
+  vector<double> sorted(myIntervals);
+  std::nth_element(sorted.begin(), sorted.begin() + WINDOW_SIZE / 2, sorted.end());
+  double median = sorted[WINDOW_SIZE / 2];
+
+  double total = 0;
+  uInt32 count = 0;
+  for (double interval: myIntervals)
+    if (std::abs(interval - median) < median * 0.05) {
+      total += interval;
+      ++count;
+    }
+
+  // Without a steady rate there is no fixed refresh to lock to
+  myRefreshRate = count >= WINDOW_SIZE * 9 / 10 ? count / total : 0;
+  double blockedFraction = myBlockedTotal / WINDOW_SIZE / median;
+  double frameRate = myFrameRateTotal / WINDOW_SIZE;
+
+  myIntervals.clear();
+  myBlockedTotal = myFrameRateTotal = 0;
+
+  double correction = 1;
+  if (myMode == Mode::display && myRefreshRate > 0 && frameRate > 0 &&
+      blockedFraction > MIN_BLOCKED_FRACTION &&
+      std::abs(myRefreshRate / frameRate - 1) < MAX_CORRECTION)
+    correction = myRefreshRate / frameRate;
+
+  if (std::abs(correction - mySpeedCorrection) < MIN_CORRECTION_CHANGE)
+    return false;
+
+  mySpeedCorrection = correction;
+  return true;
+}
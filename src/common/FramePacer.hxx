@@ -0,0 +1,131 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef FRAME_PACER_HXX
+#define FRAME_PACER_HXX
+
+#include <chrono>
+
+#include "bspf.hxx"
+
+/**
+  The frame pacer is used by the main loop for waiting until the next
+  timeslice is due, and for matching emulation speed to the display.
+
+  Waiting uses a hybrid approach: the thread sleeps until shortly before
+  the deadline, and yields for the rest of the time.  The margin adapts
+  to how much the OS actually oversleeps, since the sleep granularity on
+  Windows and some Linux kernels is far worse than the 1 ms needed for
+  even frame times at 60 Hz.
+
+  The pacer also measures the times at which frames are presented.  In
+  'display' mode, if presenting blocks on a fixed refresh rate (vsync)
+  which is close to the emulated frame rate, the emulation speed is
+  corrected to match the display exactly, so that no frame is ever
+  dropped or shown twice.  The audio follows the emulation speed, so
+  audio is resampled slightly to stay at the same pitch.  On
+  variable-refresh displays (or with vsync disabled) presenting doesn't
+  block, and the timer based pacing is kept, so the display follows the
+  emulation instead.
+*/
+class FramePacer
+{
+  public:
+    using clock = std::chrono::high_resolution_clock;
+
+    enum class Mode { timer, display };
+
+  public:
+
+    FramePacer();
+
+    void setMode(Mode mode);
+
+    /**
+      Restart pacing from the current time, e.g. after emulation was paused.
+    */
+    void reset();
+
+    /**
+      Advance the virtual time by the given timeslice and wait until it is
+      reached.  If the virtual time lags behind by more than 'maxLag'
+      seconds, it is reset to the current time instead.
+    */
+    void wait(double timesliceSeconds, double maxLag);
+
+    /**
+      Record that a frame was presented between the given times.  After
+      enough frames, the speed correction is re-evaluated.
+
+      @param frameRate  The emulated frame rate at the current speed
+      @return  True if the speed correction has changed
+    */
+    bool presented(clock::time_point start, clock::time_point end,
+                   double frameRate);
+
+    /**
+      The factor by which emulation speed currently is corrected to match
+      the display; 1 unless locked to the display.
+    */
+    double speedCorrection() const { return mySpeedCorrection; }
+
+    /**
+      The measured display refresh rate, or 0 if it isn't known (yet).
+    */
+    double refreshRate() const { return myRefreshRate; }
+
+  private:
+
+    void sleepUntil(clock::time_point deadline);
+
+    bool evaluateWindow();
+
+  private:
+
+    // Number of presented frames evaluated together
+    static constexpr uInt32 WINDOW_SIZE = 120;
+
+    Mode myMode;
+
+    clock::time_point myVirtualTime;
+
+    // The current sleep margin, and its upper limit
+    clock::duration mySleepMargin;
+    const clock::duration myMaxSleepMargin;
+
+    // Present measurements of the current window
+    vector<double> myIntervals;
+    double myBlockedTotal;
+    double myFrameRateTotal;
+    clock::time_point myLastPresent;
+    bool myHasLastPresent;
+
+    // The refresh rate measured in the last window
+    double myRefreshRate;
+
+    double mySpeedCorrection;
+
+  private:
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer(FramePacer&&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+    FramePacer& operator=(FramePacer&&) = delete;
+
+};
+
+#endif // FRAME_PACER_HXX
@@ -0,0 +1,252 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#if defined(ZIP_SUPPORT)
+  #include <zlib.h>
+#endif
+
+#include "OSystem.hxx"
+#include "Console.hxx"
+#include "FrameBuffer.hxx"
+#include "FSNode.hxx"
+#include "Props.hxx"
+#include "Serializer.hxx"
+#include "TIA.hxx"
+#include "TIASurface.hxx"
+#include "FrameRecorder.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FrameRecorder::FrameRecorder(OSystem& osystem)
+  : myOSystem(osystem),
+    myHead(0),
+    myTail(0),
+    myPending(0),
+    myQuit(false),
+    myPaletteValid(false),
+    myLastFrame(0),
+    myFramesWritten(0),
+    myFramesDropped(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FrameRecorder::~FrameRecorder()
+{
+  stop();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FrameRecorder::start(const string& filename)
+{
+  stop();
+  if(!myOSystem.hasConsole())
+    return false;
+
+  unique_ptr<Serializer> file =
+      make_unique<Serializer>(filename, Serializer::Mode::ReadWriteTrunc);
+  if(!*file)
+    return false;
+
+  const Console& console = myOSystem.console();
+  try
+  {
+    file->putString("StellaFrameDump");
+    file->putInt(1);
+    file->putString(console.properties().get(PropType::Cart_MD5));
+    file->putString(console.getFormatString());
+    file->putInt(uInt32(console.getFramerate() * 1000));
+  }
+  catch(...)
+  {
+    return false;
+  }
+
+  myFile = std::move(file);
+  myHead = myTail = myPending = 0;
+  myQuit = false;
+  myPaletteValid = false;
+  myLastFrame = console.tia().frameCount();
+  myFramesWritten = myFramesDropped = 0;
+  myWriter = std::thread(&FrameRecorder::writerLoop, this);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameRecorder::stop()
+{
+  if(!isRecording())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myQuit = true;
+  }
+  myFrameAvailable.notify_one();
+  myWriter.join();
+
+  try
+  {
+    myFile->putByte('E');
+    myFile->putInt(myFramesWritten);
+    myFile->putInt(myFramesDropped);
+  }
+  catch(...) { }
+
+  myFile.reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameRecorder::toggleRecording()
+{
+  ostringstream buf;
+  if(isRecording())
+  {
+    stop();
+    buf << "Frame recording stopped, " << myFramesWritten << " frames";
+    if(myFramesDropped > 0)
+      buf << " (" << myFramesDropped << " dropped)";
+  }
+  else if(myOSystem.hasConsole())
+  {
+    // Name the file like the snapshots, without overwriting older ones
+  #ifdef PNG_SUPPORT
+    const string& dir = myOSystem.snapshotSaveDir();
+  #else
+    const string& dir = myOSystem.defaultSaveDir();
+  #endif
+    string path = dir +
+        (myOSystem.settings().getString("snapname") != "int" ?
+            myOSystem.romFile().getNameWithExt("")
+          : myOSystem.console().properties().get(PropType::Cart_Name));
+    string filename = path + ".sfd";
+    for(uInt32 i = 1; FilesystemNode(filename).exists(); ++i)
+      filename = path + "_" + std::to_string(i) + ".sfd";
+
+    if(start(filename))
+      buf << "Frame recording started";
+    else
+      buf << "ERROR: Couldn't create frame dump file";
+  }
+  else
+    return;
+
+  myOSystem.frameBuffer().showMessage(buf.str());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameRecorder::update()
+{
+  TIA& tia = myOSystem.console().tia();
+  if(tia.frameCount() == myLastFrame)
+    return;
+  myLastFrame = tia.frameCount();
+
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    if(myPending == RING_SIZE)
+    {
+      ++myFramesDropped;
+      return;
+    }
+  }
+
+  // The head slot isn't used by the writer, so it can be filled unlocked
+  Frame& frame = myRing[myHead];
+  frame.number = myLastFrame;
+  frame.width = tia.width();
+  frame.height = tia.height();
+  frame.pixels.assign(tia.frameBuffer(), tia.frameBuffer() + frame.width * frame.height);
+
+  const uInt32* palette = myOSystem.frameBuffer().tiaSurface().rgbPalette();
+  frame.hasPalette = !myPaletteValid ||
+      !std::equal(myPalette.begin(), myPalette.end(), palette);
+  if(frame.hasPalette)
+  {
+    std::copy_n(palette, myPalette.size(), myPalette.begin());
+    frame.palette = myPalette;
+    myPaletteValid = true;
+  }
+
+  myHead = (myHead + 1) % RING_SIZE;
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    ++myPending;
+  }
+  myFrameAvailable.notify_one();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameRecorder::writerLoop()
+{
+  bool failed = false;
+  for(;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(myMutex);
+      myFrameAvailable.wait(lock, [this] { return myQuit || myPending > 0; });
+      if(myPending == 0)
+        return;
+    }
+
+    const Frame& frame = myRing[myTail];
+    const uInt8* data = frame.pixels.data();
+    uInt32 size = uInt32(frame.pixels.size());
+    bool compressed = false;
+
+  #if defined(ZIP_SUPPORT)
+    uLongf packedSize = compressBound(size);
+    myCompressBuffer.resize(packedSize);
+    if(compress2(myCompressBuffer.data(), &packedSize, data, size,
+                 Z_BEST_SPEED) == Z_OK)
+    {
+      data = myCompressBuffer.data();
+      size = uInt32(packedSize);
+      compressed = true;
+    }
+  #endif
+
+    // After a write error, the remaining frames are only discarded
+    if(!failed)
+    {
+      try
+      {
+        if(frame.hasPalette)
+        {
+          myFile->putByte('P');
+          myFile->putIntArray(frame.palette.data(), uInt32(frame.palette.size()));
+        }
+        myFile->putByte('F');
+        myFile->putInt(frame.number);
+        myFile->putShort(uInt16(frame.width));
+        myFile->putShort(uInt16(frame.height));
+        myFile->putBool(compressed);
+        myFile->putInt(size);
+        myFile->putByteArray(data, size);
+        ++myFramesWritten;
+      }
+      catch(...)
+      {
+        failed = true;
+      }
+    }
+
+    myTail = (myTail + 1) % RING_SIZE;
+    std::lock_guard<std::mutex> lock(myMutex);
+    --myPending;
+  }
+}
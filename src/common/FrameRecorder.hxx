@@ -0,0 +1,152 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef FRAME_RECORDER_HXX
+#define FRAME_RECORDER_HXX
+
+class OSystem;
+class Serializer;
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+
+/**
+  This class records the emulated TIA frames into a frame dump file, for
+  capturing gameplay at full speed.  The frames are stored as the raw
+  (indexed) TIA data together with the RGB palette, which is only a
+  fraction of the size of a scaled RGB capture, and allows re-rendering
+  the footage with any TV effect later.
+
+  Frames are copied into a fixed ring of buffers on the emulation thread;
+  compression and disk I/O happen on a writer thread.  Emulation never
+  waits for the writer: if the ring is full, the frame is dropped (and
+  counted).  Only the frames actually displayed are recorded, so when
+  running faster than normal speed, the frame numbers have gaps.
+
+  The file is written using a Serializer, and consists of
+
+    string  "StellaFrameDump"
+    int     format version
+    string  ROM MD5, display format (e.g. "NTSC")
+    int     frame rate (in 1/1000 Hz)
+
+  followed by any number of these chunks:
+
+    byte 'P'  int[256]  RGB palette; precedes the first frame, and is
+                        repeated whenever the palette changes
+    byte 'F'  int       TIA frame number
+              short     width (in TIA pixels)
+              short     height (in scanlines)
+              bool      data is compressed with zlib's compress()
+              int       size of the data, followed by the data itself
+    byte 'E'  int       number of frames written, and dropped
+
+  @author  Stephen Anthony
+*/
+class FrameRecorder
+{
+  public:
+    explicit FrameRecorder(OSystem& osystem);
+    ~FrameRecorder();
+
+    /**
+      Start recording to the given file.
+
+      @param filename  The file to record to; it is overwritten
+      @return  False if the file couldn't be created
+    */
+    bool start(const string& filename);
+
+    /**
+      Stop recording; this waits until all pending frames are written.
+    */
+    void stop();
+
+    /**
+      Start recording to a new file in the snapshot directory, named
+      after the ROM, or stop the current recording.
+    */
+    void toggleRecording();
+
+    /**
+      Answer whether a recording is currently running.
+    */
+    bool isRecording() const { return myFile != nullptr; }
+
+    /**
+      Called once per displayed frame; records the current TIA frame
+      buffer if it contains a new frame.
+    */
+    void update();
+
+  private:
+    /**
+      The loop run by the writer thread; it exits once all frames are
+      written and myQuit is set.
+    */
+    void writerLoop();
+
+  private:
+    // One slot of the frame ring
+    struct Frame {
+      uInt32 number;
+      uInt32 width, height;
+      bool hasPalette;
+      std::array<uInt32, 256> palette;
+      vector<uInt8> pixels;
+    };
+
+    // Number of frames which can be pending (about a second)
+    static constexpr uInt32 RING_SIZE = 64;
+
+    OSystem& myOSystem;
+
+    unique_ptr<Serializer> myFile;
+    std::thread myWriter;
+
+    std::array<Frame, RING_SIZE> myRing;
+    uInt32 myHead, myTail, myPending;
+    bool myQuit;
+    std::mutex myMutex;
+    std::condition_variable myFrameAvailable;
+
+    // The palette of the last recorded frame
+    std::array<uInt32, 256> myPalette;
+    bool myPaletteValid;
+
+    // The last recorded TIA frame, to skip frames shown more than once
+    uInt32 myLastFrame;
+
+    uInt32 myFramesWritten, myFramesDropped;
+
+    // Buffer for compressing frames (only used by the writer thread)
+    vector<uInt8> myCompressBuffer;
+
+  private:
+    // Following constructors and assignment operators not supported
+    FrameRecorder() = delete;
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder(FrameRecorder&&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(FrameRecorder&&) = delete;
+};
+
+#endif
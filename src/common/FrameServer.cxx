@@ -0,0 +1,139 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <new>
+
+#include "FrameServer.hxx"
+
+constexpr uInt32 FrameServer::VERSION;
+constexpr uInt32 FrameServer::FRAME_SLOTS;
+constexpr uInt32 FrameServer::FRAME_WIDTH;
+constexpr uInt32 FrameServer::FRAME_HEIGHT;
+constexpr uInt32 FrameServer::AUDIO_CAPACITY;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FrameServer::FrameServer()
+  : myHeader(nullptr),
+    mySlots(nullptr),
+    myAudio(nullptr)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FrameServer::~FrameServer()
+{
+  close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FrameServer::open(const string& path)
+{
+  close();
+
+  const size_t size = sizeof(Header) + FRAME_SLOTS * sizeof(FrameSlot) +
+                      AUDIO_CAPACITY * sizeof(Int16);
+
+  if(!myFile.openWrite(path, size))
+    return false;
+
+  uInt8* data = myFile.data();
+  std::fill_n(data, size, 0);
+
+  myHeader = new(data) Header;
+  mySlots = reinterpret_cast<FrameSlot*>(data + sizeof(Header));
+  for(uInt32 i = 0; i < FRAME_SLOTS; ++i)
+    new(&mySlots[i].sequence) std::atomic<uInt64>(0);
+  myAudio = reinterpret_cast<Int16*>(mySlots + FRAME_SLOTS);
+
+  std::copy_n("STELLAFS", 8, myHeader->magic);
+  myHeader->frameSlots = FRAME_SLOTS;
+  myHeader->frameWidth = FRAME_WIDTH;
+  myHeader->frameHeight = FRAME_HEIGHT;
+  myHeader->audioCapacity = AUDIO_CAPACITY;
+  myHeader->audioChannels = 1;
+  myHeader->audioSampleRate = 0;
+  myHeader->frameSequence.store(0);
+  myHeader->audioSequence.store(0);
+
+  // Readers check the version last, once everything else is valid
+  std::atomic_thread_fence(std::memory_order_release);
+  myHeader->version = VERSION;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameServer::close()
+{
+  myFile.close();
+  myHeader = nullptr;
+  mySlots = nullptr;
+  myAudio = nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameServer::setAudioFormat(uInt32 sampleRate, bool stereo)
+{
+  if(!myHeader)
+    return;
+
+  myHeader->audioSampleRate = sampleRate;
+  myHeader->audioChannels = stereo ? 2 : 1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameServer::publishFrame(const uInt8* pixels, uInt32 height,
+                               uInt32 frameNumber, uInt32 paletteId)
+{
+  if(!myHeader)
+    return;
+
+  const uInt64 n = myHeader->frameSequence.load(std::memory_order_relaxed);
+  FrameSlot& slot = mySlots[n % FRAME_SLOTS];
+
+  // Mark the slot as being written before touching its contents
+  slot.sequence.store(2 * n + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  height = std::min(height, FRAME_HEIGHT);
+  slot.frameNumber = frameNumber;
+  slot.height = height;
+  slot.paletteId = paletteId;
+  std::copy_n(pixels, FRAME_WIDTH * height, slot.pixels);
+
+  slot.sequence.store(2 * n + 2, std::memory_order_release);
+  myHeader->frameSequence.store(n + 1, std::memory_order_release);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameServer::publishAudio(const Int16* samples, uInt32 count)
+{
+  if(!myHeader)
+    return;
+
+  const uInt64 written = myHeader->audioSequence.load(std::memory_order_relaxed);
+  uInt32 pos = uInt32(written % AUDIO_CAPACITY);
+  for(uInt32 done = 0; done < count; )
+  {
+    const uInt32 chunk = std::min(count - done, AUDIO_CAPACITY - pos);
+    std::copy_n(samples + done, chunk, myAudio + pos);
+    done += chunk;
+    pos = (pos + chunk) % AUDIO_CAPACITY;
+  }
+
+  myHeader->audioSequence.store(written + count, std::memory_order_release);
+}
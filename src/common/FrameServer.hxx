@@ -0,0 +1,148 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef FRAME_SERVER_HXX
+#define FRAME_SERVER_HXX
+
+#include <atomic>
+
+#include "bspf.hxx"
+#include "MappedFile.hxx"
+#include "TIAConstants.hxx"
+
+/**
+  Publishes the emulated frames (as TIA palette indices) and audio samples
+  in a memory mapped file, so that other processes (e.g. a video encoder)
+  can read them while Stella runs, without copying them out of the file.
+  Frames are published as they are rendered, audio as the fragments are
+  enqueued.  On Linux, the file is best placed in /dev/shm.
+
+  The file starts with a Header, followed by FRAME_SLOTS frame slots, and
+  the audio ring of AUDIO_CAPACITY samples.  All values are in the native
+  byte order.  There is a single writer for the frames and one for the
+  audio; any number of readers never block the writers:
+
+  - Frame n is written to slot n % FRAME_SLOTS, and frameSequence is set to
+    n + 1 once it is complete.  While a slot is written, its sequence is odd
+    (2n + 1); it becomes 2n + 2 when the frame is complete.  A reader copies
+    or processes the slot and checks that the sequence didn't change in the
+    meantime; otherwise the slot was overwritten and the frame is lost.
+
+  - Audio samples (Int16, interleaved if stereo) are written to the ring
+    modulo AUDIO_CAPACITY, and audioSequence counts all samples written.
+    A reader at position p can read audioSequence - p samples; if that is
+    more than AUDIO_CAPACITY, it has fallen behind and lost samples.
+
+  Where the platform can't map files, nothing is shared until the file is
+  closed, so the server is only useful on Unix, macOS and Windows.
+
+  @author  Stephen Anthony
+*/
+class FrameServer
+{
+  public:
+    static constexpr uInt32 VERSION = 1;
+    static constexpr uInt32 FRAME_SLOTS = 8;
+    static constexpr uInt32 FRAME_WIDTH = TIAConstants::H_PIXEL;
+    static constexpr uInt32 FRAME_HEIGHT = TIAConstants::frameBufferHeight;
+    static constexpr uInt32 AUDIO_CAPACITY = 1 << 16;
+
+    // Both are padded to a multiple of the cache line size
+    struct alignas(64) Header {
+      char magic[8];                       // "STELLAFS"
+      uInt32 version;
+      uInt32 frameSlots;
+      uInt32 frameWidth;                   // pixels per line of a slot
+      uInt32 frameHeight;                  // lines of a slot
+      uInt32 audioCapacity;                // samples in the audio ring
+      uInt32 audioChannels;                // 1 or 2
+      uInt32 audioSampleRate;
+      uInt32 reserved;
+      std::atomic<uInt64> frameSequence;   // frames published
+      std::atomic<uInt64> audioSequence;   // samples published
+    };
+
+    struct alignas(64) FrameSlot {
+      std::atomic<uInt64> sequence;        // odd while being written
+      uInt32 frameNumber;                  // as counted by the TIA
+      uInt32 height;                       // lines used of the slot
+      uInt32 paletteId;                    // 0 = NTSC, 1 = PAL, 2 = SECAM
+      uInt32 reserved;
+      uInt8 pixels[FRAME_WIDTH * FRAME_HEIGHT];
+    };
+
+  public:
+    FrameServer();
+    ~FrameServer();
+
+    /**
+      Create the file and start publishing.
+
+      @param path  The file to create
+      @return  True on success
+    */
+    bool open(const string& path);
+
+    /**
+      Stop publishing; the file is kept, so readers may still finish.
+    */
+    void close();
+
+    bool isOpen() const { return myHeader != nullptr; }
+
+    /**
+      Describe the audio published from now on.
+    */
+    void setAudioFormat(uInt32 sampleRate, bool stereo);
+
+    /**
+      Publish a frame.
+
+      @param pixels       The frame buffer of the TIA (FRAME_WIDTH pixels
+                          per line)
+      @param height       The number of lines of the frame
+      @param frameNumber  The number of the frame
+      @param paletteId    The palette the pixels index into
+    */
+    void publishFrame(const uInt8* pixels, uInt32 height, uInt32 frameNumber,
+                      uInt32 paletteId);
+
+    /**
+      Publish audio samples.
+
+      @param samples  The samples (interleaved if stereo)
+      @param count    The number of samples (counting both channels)
+    */
+    void publishAudio(const Int16* samples, uInt32 count);
+
+  private:
+    MappedFile myFile;
+
+    // The parts of the mapped file
+    Header* myHeader;
+    FrameSlot* mySlots;
+    Int16* myAudio;
+
+  private:
+    // Following constructors and assignment operators not supported
+    FrameServer(const FrameServer&) = delete;
+    FrameServer(FrameServer&&) = delete;
+    FrameServer& operator=(const FrameServer&) = delete;
+    FrameServer& operator=(FrameServer&&) = delete;
+};
+
+#endif
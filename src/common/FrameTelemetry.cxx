@@ -0,0 +1,148 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <fstream>
+#include <iomanip>
+
+#include "OSystem.hxx"
+#include "Console.hxx"
+#include "FrameBuffer.hxx"
+#include "FSNode.hxx"
+#include "Props.hxx"
+#include "FrameTelemetry.hxx"
+
+using namespace std::chrono;
+
+namespace {
+  double toMilliseconds(FrameTelemetry::clock::duration d) {
+    return duration_cast<duration<double, std::milli>>(d).count();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FrameTelemetry::FrameTelemetry(OSystem& osystem)
+  : myOSystem(osystem),
+    myEnabled(false),
+    myEmulation(0),
+    myHandoff(0),
+    myInputPending(false),
+    mySamples(CAPACITY),
+    myWritten(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameTelemetry::toggleRecording()
+{
+  ostringstream buf;
+  if(myEnabled)
+  {
+    myEnabled = false;
+
+    // Name the file like the snapshots, without overwriting older ones
+  #ifdef PNG_SUPPORT
+    const string& dir = myOSystem.snapshotSaveDir();
+  #else
+    const string& dir = myOSystem.defaultSaveDir();
+  #endif
+    string path = dir + (myOSystem.hasConsole()
+        ? myOSystem.console().properties().get(PropType::Cart_Name) + "_telemetry"
+        : "telemetry");
+    string filename = path + ".csv";
+    for(uInt32 i = 1; FilesystemNode(filename).exists(); ++i)
+      filename = path + "_" + std::to_string(i) + ".csv";
+
+    if(saveCSV(filename))
+      buf << "Telemetry saved to " << FilesystemNode(filename).getShortPath();
+    else
+      buf << "ERROR: Couldn't save telemetry";
+  }
+  else
+  {
+    myWritten = 0;
+    myEmulation = myHandoff = clock::duration(0);
+    myInputPending = false;
+    myStart = clock::now();
+    myEnabled = true;
+
+    buf << "Telemetry recording started";
+  }
+
+  myOSystem.frameBuffer().showMessage(buf.str());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameTelemetry::framePresented(clock::duration render, clock::duration present,
+                                    double audioFill)
+{
+  if(!myEnabled) return;
+
+  const clock::time_point now = clock::now();
+  const uInt64 written = myWritten.load(std::memory_order_relaxed);
+  Sample& s = mySamples[written % CAPACITY];
+
+  s.time = duration_cast<duration<double>>(now - myStart).count();
+  s.emulation = toMilliseconds(myEmulation);
+  s.handoff = toMilliseconds(myHandoff);
+  s.render = toMilliseconds(render);
+  s.present = toMilliseconds(present);
+  s.audioFill = audioFill;
+  s.inputLatency = myInputPending ? toMilliseconds(now - myInputTime) : -1;
+
+  // Publish the sample only after it is complete
+  myWritten.store(written + 1, std::memory_order_release);
+
+  myEmulation = myHandoff = clock::duration(0);
+  myInputPending = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 FrameTelemetry::size() const
+{
+  return uInt32(std::min(myWritten.load(std::memory_order_acquire), uInt64(CAPACITY)));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const FrameTelemetry::Sample& FrameTelemetry::sample(uInt32 i) const
+{
+  const uInt64 written = myWritten.load(std::memory_order_acquire);
+  const uInt64 first = written > CAPACITY ? written - CAPACITY : 0;
+
+  return mySamples[(first + i) % CAPACITY];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FrameTelemetry::saveCSV(const string& filename) const
+{
+  std::ofstream out(FilesystemNode(filename).getPath());
+  if(!out) return false;
+
+  out << "time,emulation_ms,handoff_ms,render_ms,present_ms,audio_fill,input_latency_ms\n"
+      << std::fixed << std::setprecision(3);
+
+  for(uInt32 i = 0, n = size(); i < n; ++i)
+  {
+    const Sample& s = sample(i);
+
+    out << s.time << ',' << s.emulation << ',' << s.handoff << ',' << s.render << ','
+        << s.present << ',' << s.audioFill << ',';
+    if(s.inputLatency >= 0) out << s.inputLatency;
+    out << '\n';
+  }
+
+  return bool(out);
+}
@@ -0,0 +1,153 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef FRAME_TELEMETRY_HXX
+#define FRAME_TELEMETRY_HXX
+
+class OSystem;
+
+#include <atomic>
+#include <chrono>
+
+#include "bspf.hxx"
+
+/**
+  Records the timing of every presented frame while enabled: how long the
+  worker emulated, how long the handoffs to and from the worker took,
+  how long rendering and presenting the frame took, the fill level of the
+  audio queue, and an estimate of the input latency.  The frame buffer
+  draws the most recent frames as a graph on top of the emulation, and
+  the samples are written to a CSV file when recording stops.
+
+  The input latency is measured from the time an input event was handled
+  to the time the next frame has been presented.  The scanout of the
+  display isn't included, so this is a lower bound of input-to-photon
+  latency.
+
+  Samples are kept in a ring buffer with a single producer (the main loop).
+  Readers on other threads may see a sample that is being overwritten, but
+  never have to wait.
+
+  @author  Stephen Anthony
+*/
+class FrameTelemetry
+{
+  public:
+    using clock = std::chrono::high_resolution_clock;
+
+    struct Sample {
+      // Time of the present, in seconds since recording started
+      double time;
+      // Milliseconds the worker emulated since the previous frame
+      double emulation;
+      // Milliseconds spent in EmulationWorker::start() and stop()
+      double handoff;
+      // Milliseconds to render the TIA frame to the frame buffer
+      double render;
+      // Milliseconds to draw and present the frame
+      double present;
+      // Fill level of the audio queue (0 - 1)
+      double audioFill;
+      // Milliseconds from input to present, or negative without input
+      double inputLatency;
+    };
+
+    // Number of samples kept
+    static constexpr uInt32 CAPACITY = 4096;
+
+  public:
+    explicit FrameTelemetry(OSystem& osystem);
+
+    /**
+      Start recording, or stop recording and write the samples to a CSV
+      file in the snapshot directory.
+    */
+    void toggleRecording();
+
+    /**
+      Answer whether recording is enabled.
+    */
+    bool isEnabled() const { return myEnabled; }
+
+    /**
+      Write the recorded samples to the given file, oldest first.
+
+      @return  False if the file couldn't be written
+    */
+    bool saveCSV(const string& filename) const;
+
+    /**
+      Add time spent on emulation and handoffs to the next sample.
+    */
+    void addEmulation(clock::duration emulation, clock::duration handoff) {
+      myEmulation += emulation;
+      myHandoff += handoff;
+    }
+
+    /**
+      Called for input events; the next present measures the latency
+      from the first of them.
+    */
+    void inputReceived() {
+      if(myEnabled && !myInputPending) {
+        myInputTime = clock::now();
+        myInputPending = true;
+      }
+    }
+
+    /**
+      Record a sample for a presented frame.
+    */
+    void framePresented(clock::duration render, clock::duration present,
+                        double audioFill);
+
+    /**
+      The number of samples available (up to CAPACITY).
+    */
+    uInt32 size() const;
+
+    /**
+      The i-th of the available samples, oldest first.
+    */
+    const Sample& sample(uInt32 i) const;
+
+  private:
+    OSystem& myOSystem;
+
+    bool myEnabled;
+    clock::time_point myStart;
+
+    // Accumulated for the next sample
+    clock::duration myEmulation;
+    clock::duration myHandoff;
+    clock::time_point myInputTime;
+    bool myInputPending;
+
+    // The ring buffer, and the number of samples ever written to it
+    vector<Sample> mySamples;
+    std::atomic<uInt64> myWritten;
+
+  private:
+    // Following constructors and assignment operators not supported
+    FrameTelemetry() = delete;
+    FrameTelemetry(const FrameTelemetry&) = delete;
+    FrameTelemetry(FrameTelemetry&&) = delete;
+    FrameTelemetry& operator=(const FrameTelemetry&) = delete;
+    FrameTelemetry& operator=(FrameTelemetry&&) = delete;
+};
+
+#endif // FRAME_TELEMETRY_HXX
@@ -19,6 +19,9 @@
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 JoyMap::JoyMap(void)
+  : myLookupModes(0),
+    myLookupButtons(0),
+    myLookupValid(false)
 {
 }
 
@@ -26,6 +29,7 @@ JoyMap::JoyMap(void)
 void JoyMap::add(const Event::Type event, const JoyMapping& mapping)
 {
   myMap[mapping] = event;
+  myLookupValid = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -47,6 +51,7 @@ void JoyMap::add(const Event::Type event, const EventMode mode, const int button
 void JoyMap::erase(const JoyMapping& mapping)
 {
   myMap.erase(mapping);
+  myLookupValid = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -66,22 +71,58 @@ void JoyMap::erase(const EventMode mode, const int button,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Event::Type JoyMap::get(const JoyMapping& mapping) const
 {
-  auto find = myMap.find(mapping);
-  if (find != myMap.end())
-    return find->second;
+  if (!myLookupValid)
+    buildLookup();
+
+  Event::Type event = lookup(mapping);
+  if (event != Event::Type::NoType)
+    return event;
 
   // try without button as modifier
   JoyMapping m = mapping;
 
   m.button = JOY_CTRL_NONE;
 
-  find = myMap.find(m);
-  if (find != myMap.end())
-    return find->second;
+  return lookup(m);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Event::Type JoyMap::lookup(const JoyMapping& mapping) const
+{
+  const uInt32 mode = uInt32(mapping.mode),
+               button = uInt32(mapping.button - JOY_CTRL_NONE);
+
+  // Nothing is mapped outside of the table
+  if (mode >= myLookupModes || button >= myLookupButtons)
+    return Event::Type::NoType;
+
+  for (const auto& entry : myLookup[mode * myLookupButtons + button])
+    if (entry.first == mapping)
+      return entry.second;
 
   return Event::Type::NoType;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void JoyMap::buildLookup() const
+{
+  myLookupModes = myLookupButtons = 0;
+  for (const auto& item : myMap)
+  {
+    myLookupModes = std::max(myLookupModes, uInt32(item.first.mode) + 1);
+    myLookupButtons = std::max(myLookupButtons,
+                               uInt32(item.first.button - JOY_CTRL_NONE) + 1);
+  }
+
+  myLookup.clear();
+  myLookup.resize(myLookupModes * myLookupButtons);
+  for (const auto& item : myMap)
+    myLookup[uInt32(item.first.mode) * myLookupButtons +
+             uInt32(item.first.button - JOY_CTRL_NONE)].emplace_back(item);
+
+  myLookupValid = true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Event::Type JoyMap::get(const EventMode mode, const int button,
                         const JoyAxis axis, const JoyDir adir) const
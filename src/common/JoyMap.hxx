@@ -128,6 +128,12 @@ class JoyMap
   private:
     string getDesc(const Event::Type event, const JoyMapping& mapping) const;
 
+    /** Find the event for a mapping in the lookup table */
+    Event::Type lookup(const JoyMapping& mapping) const;
+
+    /** Rebuild the lookup table from the current mappings */
+    void buildLookup() const;
+
     struct JoyHash {
       size_t operator()(const JoyMapping& m)const {
         return std::hash<uInt64>()((uInt64(m.mode)) // 3 bits
@@ -142,6 +148,16 @@ class JoyMap
     };
 
     std::unordered_map<JoyMapping, Event::Type, JoyHash> myMap;
+
+    // Flat table for resolving controller events, since get() is called for
+    // every button, axis and hat event.  It is indexed by mode and button
+    // (starting with JOY_CTRL_NONE), and each entry holds the few mappings
+    // for that button.  It is rebuilt from myMap after the mappings have
+    // changed.
+    using LookupEntry = std::pair<JoyMapping, Event::Type>;
+    mutable vector<vector<LookupEntry>> myLookup;
+    mutable uInt32 myLookupModes, myLookupButtons;
+    mutable bool myLookupValid;
 };
 
 #endif
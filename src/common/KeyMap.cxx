@@ -18,7 +18,10 @@
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 KeyMap::KeyMap(void)
-  : myModEnabled(true)
+  : myLookupModes(0),
+    myLookupKeys(0),
+    myLookupValid(false),
+    myModEnabled(true)
 {
 }
 
@@ -26,6 +29,7 @@ KeyMap::KeyMap(void)
 void KeyMap::add(const Event::Type event, const Mapping& mapping)
 {
 	myMap[convertMod(mapping)] = event;
+  myLookupValid = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -38,6 +42,7 @@ void KeyMap::add(const Event::Type event, const EventMode mode, const int key, c
 void KeyMap::erase(const Mapping& mapping)
 {
 	myMap.erase(convertMod(mapping));
+  myLookupValid = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -51,23 +56,58 @@ Event::Type KeyMap::get(const Mapping& mapping) const
 {
   Mapping m = convertMod(mapping);
 
+  if (!myLookupValid)
+    buildLookup();
+
   if (myModEnabled)
   {
-    auto find = myMap.find(m);
-    if (find != myMap.end())
-      return find->second;
+    Event::Type event = lookup(m);
+    if (event != Event::Type::NoType)
+      return event;
   }
 
   // mapping not found, try without modifiers
   m.mod = StellaMod(0);
 
-  auto find = myMap.find(m);
-  if (find != myMap.end())
-    return find->second;
+  return lookup(m);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Event::Type KeyMap::lookup(const Mapping& mapping) const
+{
+  const uInt32 mode = uInt32(mapping.mode), key = uInt32(mapping.key);
+
+  // Nothing is mapped outside of the table
+  if (mode >= myLookupModes || key >= myLookupKeys)
+    return Event::Type::NoType;
+
+  // Compare the same way as the map does (see Mapping::operator==)
+  for (const auto& entry : myLookup[mode * myLookupKeys + key])
+    if (Mapping(mapping.mode, mapping.key, entry.first) == mapping)
+      return entry.second;
 
   return Event::Type::NoType;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void KeyMap::buildLookup() const
+{
+  myLookupModes = myLookupKeys = 0;
+  for (const auto& item : myMap)
+  {
+    myLookupModes = std::max(myLookupModes, uInt32(item.first.mode) + 1);
+    myLookupKeys = std::max(myLookupKeys, uInt32(item.first.key) + 1);
+  }
+
+  myLookup.clear();
+  myLookup.resize(myLookupModes * myLookupKeys);
+  for (const auto& item : myMap)
+    myLookup[uInt32(item.first.mode) * myLookupKeys + uInt32(item.first.key)]
+      .emplace_back(item.first.mod, item.second);
+
+  myLookupValid = true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Event::Type KeyMap::get(const EventMode mode, const int key, const int mod) const
 {
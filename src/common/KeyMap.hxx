@@ -102,6 +102,12 @@ class KeyMap
     //** Convert modifiers */
     Mapping convertMod(const Mapping& mapping) const;
 
+    /** Find the event for a (converted) mapping in the lookup table */
+    Event::Type lookup(const Mapping& mapping) const;
+
+    /** Rebuild the lookup table from the current mappings */
+    void buildLookup() const;
+
     struct KeyHash {
       size_t operator()(const Mapping& m) const {
         return std::hash<uInt64>()((uInt64(m.mode))     // 3 bits
@@ -117,6 +123,15 @@ class KeyMap
 
     std::unordered_map<Mapping, Event::Type, KeyHash> myMap;
 
+    // Flat table for resolving key events, since get() is called for every
+    // key press and release.  It is indexed by mode and key, and each entry
+    // holds the few mappings for that key (with their modifiers).  It is
+    // rebuilt from myMap after the mappings have changed.
+    using LookupEntry = std::pair<StellaMod, Event::Type>;
+    mutable vector<vector<LookupEntry>> myLookup;
+    mutable uInt32 myLookupModes, myLookupKeys;
+    mutable bool myLookupValid;
+
     // Indicates whether the key-combos tied to a modifier key are
     // being used or not (e.g. Ctrl by default is the fire button,
     // pressing it with a movement key could inadvertantly activate
@@ -18,21 +18,26 @@
 #ifndef LINKED_OBJECT_POOL_HXX
 #define LINKED_OBJECT_POOL_HXX
 
-#include <list>
+#include <iterator>
 #include "bspf.hxx"
 
 /**
-  A fixed-size object-pool based doubly-linked list that makes use of
-  multiple STL lists, to reduce frequent (de)allocations.
+  A fixed-size object-pool based doubly-linked list, which never
+  (de)allocates while in use.
 
   This structure can be used as either a stack or queue, but also allows
   for removal at any location in the list.
 
-  There are two internal lists; one stores active nodes, and the other
-  stores pool nodes that have been 'deleted' from the active list (note
-  that no actual deletion takes place; nodes are simply moved from one list
-  to another).  Similarly, when a new node is added to the active list, it
-  is simply moved from the pool list to the active list.
+  All nodes are allocated in one block (a slab) when the pool is
+  resized, and are linked by their indices, which are kept apart from
+  the objects; walking the list thus touches only a small, contiguous
+  area of memory.  There are two internal lists; one stores active nodes,
+  and the other stores pool nodes that have been 'deleted' from the active
+  list (note that no actual deletion takes place; nodes are simply moved
+  from one list to another).  Similarly, when a new node is added to the
+  active list, it is simply moved from the pool list to the active list.
+  The pool list is a stack, so the node removed last is reused first,
+  together with any buffers its object still owns.
 
   In all cases, the variable 'myCurrent' is updated to point to the
   current node.
@@ -40,10 +45,9 @@
   NOTE: You must always call 'currentIsValid()' before calling 'current()',
         to make sure that the return value is a valid reference.
 
-        In the case of methods which wrap the C++ 'splice()' method, the
-        semantics of splice are followed wrt invalid/out-of-range/etc
-        iterators.  See the applicable C++ STL documentation for such
-        behaviour.
+        Iterators behave like those of std::list; they remain valid until
+        their node is removed, and moving past either end of the active
+        list leads to the end() iterator.
 
   @author Stephen Anthony
 */
@@ -52,14 +56,61 @@ namespace Common {
 template <class T, uInt32 CAPACITY = 100>
 class LinkedObjectPool
 {
+  private:
+    // Node 0 is the head of the active list: its successor is the first
+    // node, and its predecessor the last one.  It is also the end()
+    // position, and has no object.
+    static constexpr uInt32 HEAD = 0;
+
+    struct Links {
+      uInt32 prev, next;
+    };
+
+    template <class Pool, class Value>
+    class Iterator
+    {
+      public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value*;
+        using reference = Value&;
+
+        Iterator() : myPool(nullptr), myNode(HEAD) { }
+        Iterator(Pool* pool, uInt32 node) : myPool(pool), myNode(node) { }
+
+        // Any iterator converts to a constant one
+        operator Iterator<const LinkedObjectPool, const T>() const {
+          return Iterator<const LinkedObjectPool, const T>(myPool, myNode);
+        }
+
+        Value& operator*() const  { return myPool->myObjects[myNode - 1]; }
+        Value* operator->() const { return &**this; }
+
+        Iterator& operator++() { myNode = myPool->myLinks[myNode].next; return *this; }
+        Iterator& operator--() { myNode = myPool->myLinks[myNode].prev; return *this; }
+        Iterator operator++(int) { Iterator i = *this; ++*this; return i; }
+        Iterator operator--(int) { Iterator i = *this; --*this; return i; }
+
+        bool operator==(const Iterator& i) const { return myNode == i.myNode; }
+        bool operator!=(const Iterator& i) const { return myNode != i.myNode; }
+
+      private:
+        Pool* myPool;
+        uInt32 myNode;
+
+        friend class LinkedObjectPool;
+    };
+
   public:
-    using iter = typename std::list<T>::iterator;
-    using const_iter = typename std::list<T>::const_iterator;
+    using iter = Iterator<LinkedObjectPool, T>;
+    using const_iter = Iterator<const LinkedObjectPool, const T>;
 
     /*
       Create a pool of size CAPACITY; the active list starts out empty.
     */
-    LinkedObjectPool<T, CAPACITY>() : myCurrent(myList.end()), myCapacity(0) {
+    LinkedObjectPool<T, CAPACITY>()
+      : myCurrent(HEAD), myFree(HEAD), mySize(0), myCapacity(0) {
       resize(CAPACITY);
     }
 
@@ -70,7 +121,7 @@ class LinkedObjectPool
 
       Make sure to call 'currentIsValid()' before accessing this method.
     */
-    T& current() const { return *myCurrent; }
+    T& current() const { return myObjects[myCurrent - 1]; }
 
     /**
       Returns current's position in the list
@@ -81,10 +132,9 @@ class LinkedObjectPool
       if(empty())
         return 0;
 
-      iter it = myCurrent;
       uInt32 idx = 1;
-
-      while(it-- != myList.begin()) ++idx;
+      for(uInt32 node = myCurrent; myLinks[node].prev != HEAD; node = myLinks[node].prev)
+        ++idx;
       return idx;
     }
 
@@ -92,7 +142,7 @@ class LinkedObjectPool
       Does the 'current' iterator point to a valid node in the active list?
       This must be called before 'current()' is called.
     */
-    bool currentIsValid() const { return myCurrent != myList.end(); }
+    bool currentIsValid() const { return myCurrent != HEAD; }
 
     /**
       Advance 'current' iterator to previous position in the active list.
@@ -100,7 +150,7 @@ class LinkedObjectPool
     */
     void moveToPrevious() {
       if(currentIsValid())
-        myCurrent = myCurrent == myList.begin() ? myList.end() : std::prev(myCurrent, 1);
+        myCurrent = myLinks[myCurrent].prev;
     }
 
     /**
@@ -109,7 +159,7 @@ class LinkedObjectPool
     */
     void moveToNext() {
       if(currentIsValid())
-        myCurrent = std::next(myCurrent, 1);
+        myCurrent = myLinks[myCurrent].next;
     }
 
     /**
@@ -117,7 +167,7 @@ class LinkedObjectPool
     */
     void moveToFirst() {
       if(currentIsValid())
-        myCurrent = myList.begin();
+        myCurrent = myLinks[HEAD].next;
     }
 
     /**
@@ -125,48 +175,53 @@ class LinkedObjectPool
     */
     void moveToLast() {
       if(currentIsValid())
-        myCurrent = std::prev(myList.end(), 1);
+        myCurrent = myLinks[HEAD].prev;
     }
 
+    /**
+      Return node data that the given iterator points to, for modification.
+    */
+    T& get(const_iter i) { return myObjects[i.myNode - 1]; }
+
     /**
       Return an iterator to the first node in the active list.
     */
-    const_iter first() const { return myList.begin(); }
+    const_iter first() const { return const_iter(this, myLinks[HEAD].next); }
 
     /**
       Return an iterator to the last node in the active list.
     */
-    const_iter last() const { return std::prev(myList.end(), 1); }
+    const_iter last() const { return const_iter(this, myLinks[HEAD].prev); }
 
     /**
       Return an iterator to the previous node of 'i' in the active list.
     */
-    const_iter previous(const_iter i) const { return std::prev(i, 1); }
+    const_iter previous(const_iter i) const { return --i; }
 
     /**
       Return an iterator to the next node to 'current' in the active list.
     */
-    const_iter next(const_iter i) const { return std::next(i, 1); }
+    const_iter next(const_iter i) const { return ++i; }
 
     /**
       Canonical iterators from C++ STL.
     */
-    const_iter cbegin() const { return myList.cbegin(); }
-    const_iter cend() const   { return myList.cend();   }
+    const_iter cbegin() const { return first(); }
+    const_iter cend() const   { return const_iter(this, HEAD); }
 
     /**
       Answer whether 'current' is at the specified iterator.
     */
-    bool atFirst() const { return myCurrent == first(); }
-    bool atLast() const  { return myCurrent == last();  }
+    bool atFirst() const { return myCurrent == myLinks[HEAD].next; }
+    bool atLast() const  { return myCurrent == myLinks[HEAD].prev; }
 
     /**
       Add a new node at the beginning of the active list, and update 'current'
       to point to that node.
     */
     void addFirst() {
-      myList.splice(myList.begin(), myPool, myPool.begin());
-      myCurrent = myList.begin();
+      myCurrent = allocate();
+      link(myCurrent, myLinks[HEAD].next);
     }
 
     /**
@@ -174,8 +229,8 @@ class LinkedObjectPool
       to point to that node.
     */
     void addLast() {
-      myList.splice(myList.end(), myPool, myPool.begin());
-      myCurrent = std::prev(myList.end(), 1);
+      myCurrent = allocate();
+      link(myCurrent, HEAD);
     }
 
     /**
@@ -183,10 +238,10 @@ class LinkedObjectPool
       happens to be the one removed.
     */
     void removeFirst() {
-      const_iter i = myList.cbegin();
-      myPool.splice(myPool.end(), myList, i);
-      if(myCurrent == i)  // did we just invalidate 'current'
-        moveToNext();     // if so, move to the next node
+      const uInt32 node = myLinks[HEAD].next;
+      if(myCurrent == node)  // are we about to invalidate 'current'
+        moveToNext();        // if so, move to the next node
+      unlink(node, node);
     }
 
     /**
@@ -194,17 +249,17 @@ class LinkedObjectPool
       happens to be the one removed.
     */
     void removeLast() {
-      const_iter i = std::prev(myList.end(), 1);
-      myPool.splice(myPool.end(), myList, i);
-      if(myCurrent == i)  // did we just invalidate 'current'
-        moveToPrevious(); // if so, move to the previous node
+      const uInt32 node = myLinks[HEAD].prev;
+      if(myCurrent == node)  // are we about to invalidate 'current'
+        moveToPrevious();    // if so, move to the previous node
+      unlink(node, node);
     }
 
     /**
       Remove a single element from the active list at position of the iterator.
     */
     void remove(const_iter i) {
-      myPool.splice(myPool.end(), myList, i);
+      unlink(i.myNode, i.myNode);
     }
 
     /**
@@ -213,7 +268,7 @@ class LinkedObjectPool
       and so on).
     */
     void remove(uInt32 index) {
-      myPool.splice(myPool.end(), myList, std::next(myList.begin(), index));
+      remove(std::next(first(), index));
     }
 
     /**
@@ -221,7 +276,9 @@ class LinkedObjectPool
       the 'current' node.
     */
     void removeToFirst() {
-      myPool.splice(myPool.end(), myList, myList.begin(), myCurrent);
+      const uInt32 first = myLinks[HEAD].next;
+      if(first != myCurrent)
+        unlink(first, myLinks[myCurrent].prev);
     }
 
     /**
@@ -229,7 +286,9 @@ class LinkedObjectPool
       active list.
     */
     void removeToLast() {
-      myPool.splice(myPool.end(), myList, std::next(myCurrent, 1), myList.end());
+      const uInt32 next = myLinks[myCurrent].next;
+      if(next != HEAD)
+        unlink(next, myLinks[HEAD].prev);
     }
 
     /**
@@ -239,12 +298,21 @@ class LinkedObjectPool
     void resize(uInt32 capacity) {
       if(myCapacity != capacity)  // only resize when necessary
       {
-        myList.clear();  myPool.clear();
-        myCurrent = myList.end();
         myCapacity = capacity;
-
-        for(uInt32 i = 0; i < myCapacity; ++i)
-          myPool.emplace_back(T());
+        myObjects = make_unique<T[]>(myCapacity);
+        myLinks = make_unique<Links[]>(myCapacity + 1);
+
+        myLinks[HEAD] = { HEAD, HEAD };
+        mySize = 0;
+        myCurrent = HEAD;
+
+        // All nodes are in the pool, in order
+        myFree = HEAD;
+        for(uInt32 node = myCapacity; node > HEAD; --node)
+        {
+          myLinks[node].next = myFree;
+          myFree = node;
+        }
       }
     }
 
@@ -252,30 +320,77 @@ class LinkedObjectPool
       Erase entire contents of active list.
     */
     void clear() {
-      myPool.splice(myPool.end(), myList, myList.begin(), myList.end());
-      myCurrent = myList.end();
+      if(!empty())
+        unlink(myLinks[HEAD].next, myLinks[HEAD].prev);
+      myCurrent = HEAD;
     }
 
     uInt32 capacity() const { return myCapacity; }
 
-    uInt32 size() const { return uInt32(myList.size()); }
-    bool empty() const  { return size() == 0;           }
-    bool full() const   { return size() >= capacity();  }
+    uInt32 size() const { return mySize;           }
+    bool empty() const  { return size() == 0;      }
+    bool full() const   { return size() >= capacity(); }
 
-    friend ostream& operator<<(ostream& os, const LinkedObjectPool<T>& p) {
-      for(const auto& i: p.myList)
-        os << i << (p.current() == i ? "* " : "  ");
+    friend ostream& operator<<(ostream& os, const LinkedObjectPool& p) {
+      for(const_iter i = p.cbegin(); i != p.cend(); ++i)
+        os << *i << (p.currentIsValid() && &*i == &p.current() ? "* " : "  ");
       return os;
     }
 
   private:
-    std::list<T> myList, myPool;
+    /**
+      Take a node from the pool.
+    */
+    uInt32 allocate() {
+      const uInt32 node = myFree;
+      myFree = myLinks[node].next;
+      ++mySize;
+      return node;
+    }
+
+    /**
+      Link a node into the active list, before the given node.
+    */
+    void link(uInt32 node, uInt32 before) {
+      const uInt32 prev = myLinks[before].prev;
+      myLinks[node] = { prev, before };
+      myLinks[prev].next = node;
+      myLinks[before].prev = node;
+    }
+
+    /**
+      Move the range of nodes from 'first' to 'last' (inclusive) from the
+      active list to the pool.
+    */
+    void unlink(uInt32 first, uInt32 last) {
+      const uInt32 prev = myLinks[first].prev, next = myLinks[last].next;
+      myLinks[prev].next = next;
+      myLinks[next].prev = prev;
+
+      for(uInt32 node = first; ; node = myLinks[node].next)
+      {
+        --mySize;
+        if(node == last)
+          break;
+      }
+      myLinks[last].next = myFree;
+      myFree = first;
+    }
+
+  private:
+    // The objects of all nodes (node i holds object i - 1), and the links
+    // of the active list and the pool
+    unique_ptr<T[]> myObjects;
+    unique_ptr<Links[]> myLinks;
+
+    // Current position in the active list (HEAD indicates an invalid position)
+    uInt32 myCurrent;
 
-    // Current position in the active list (end() indicates an invalid position)
-    iter myCurrent;
+    // The first node of the pool
+    uInt32 myFree;
 
-    // Total capacity of the pool
-    uInt32 myCapacity;
+    // Number of nodes in the active list, and total capacity of the pool
+    uInt32 mySize, myCapacity;
 
   private:
     // Following constructors and assignment operators not supported
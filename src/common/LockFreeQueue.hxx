@@ -0,0 +1,132 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef LOCK_FREE_QUEUE_HXX
+#define LOCK_FREE_QUEUE_HXX
+
+#include <array>
+#include <atomic>
+
+#include "bspf.hxx"
+
+/**
+  A fixed-size, lock-free queue for passing items from any number of
+  producer threads to a single consumer thread.  Neither side ever blocks
+  or allocates; if the queue is full, new items are rejected.
+
+  Each slot carries a sequence number which tells whether it is free for
+  the producer of a given position, or holds an item for the consumer.
+  Producers claim a position by atomically advancing the write position,
+  so they never wait on each other (see D. Vyukov's bounded queue).
+
+  @author  Stephen Anthony
+*/
+namespace Common {
+
+template <class T, uInt32 CAPACITY = 256>
+class LockFreeQueue
+{
+  static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0,
+                "CAPACITY must be a power of two");
+
+  public:
+    LockFreeQueue() {
+      for(uInt32 i = 0; i < CAPACITY; ++i)
+        mySlots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    /**
+      Add an item to the back of the queue; may be called from any thread.
+
+      @return  False if the queue is full, in which case the item is dropped
+    */
+    bool push(const T& item) {
+      uInt32 pos = myWritePos.load(std::memory_order_relaxed);
+      for(;;)
+      {
+        Slot& slot = mySlots[pos & (CAPACITY - 1)];
+        const Int32 diff =
+          Int32(slot.sequence.load(std::memory_order_acquire) - pos);
+
+        if(diff == 0)
+        {
+          // The slot is free; try to claim it
+          if(myWritePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          {
+            slot.item = item;
+            slot.sequence.store(pos + 1, std::memory_order_release);
+            return true;
+          }
+        }
+        else if(diff < 0)
+          return false;  // full
+        else
+          pos = myWritePos.load(std::memory_order_relaxed);
+      }
+    }
+
+    /**
+      Remove the item at the front of the queue; must only be called from
+      the (single) consumer thread.
+
+      @return  False if the queue is empty
+    */
+    bool pop(T& item) {
+      Slot& slot = mySlots[myReadPos & (CAPACITY - 1)];
+
+      if(Int32(slot.sequence.load(std::memory_order_acquire) - (myReadPos + 1)) < 0)
+        return false;
+
+      item = std::move(slot.item);
+      slot.sequence.store(myReadPos + CAPACITY, std::memory_order_release);
+      ++myReadPos;
+
+      return true;
+    }
+
+    /**
+      Remove all items; must only be called from the consumer thread.
+    */
+    void clear() {
+      T item;
+      while(pop(item)) ;
+    }
+
+  private:
+    struct Slot {
+      std::atomic<uInt32> sequence;
+      T item;
+    };
+    std::array<Slot, CAPACITY> mySlots;
+
+    // The position the next item is written to; shared by all producers
+    std::atomic<uInt32> myWritePos{0};
+
+    // The position the next item is read from; only used by the consumer
+    uInt32 myReadPos{0};
+
+  private:
+    // Following constructors and assignment operators not supported
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue(LockFreeQueue&&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(LockFreeQueue&&) = delete;
+};
+
+}  // Namespace Common
+
+#endif
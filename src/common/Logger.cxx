@@ -49,23 +49,50 @@ void Logger::debug(const string& message)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Logger::logMessage(const string& message, Level level) const
+void Logger::logMessage(const string& message, Level level)
 {
-  if (myLogCallback)
-    myLogCallback(message, level);
+  const std::thread::id callbackThread = myCallbackThread.load();
 
-  else
+  if (callbackThread == std::this_thread::get_id())
+  {
+    // Deliver anything queued before, so that the order is kept
+    flush();
+    myLogCallback(message, level);
+  }
+  else if (callbackThread == std::thread::id())
     cout << message << endl << std::flush;
+
+  else if (!myMessages.push({message, level}))
+    ++myDroppedMessages;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Logger::flush()
+{
+  if (myCallbackThread.load() != std::this_thread::get_id())
+    return;
+
+  Message message;
+  while (myMessages.pop(message))
+    myLogCallback(message.text, message.level);
+
+  const uInt32 dropped = myDroppedMessages.exchange(0);
+  if (dropped > 0)
+    myLogCallback(std::to_string(dropped) + " log message(s) dropped", Level::INFO);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Logger::setLogCallback(Logger::logCallback callback)
 {
   myLogCallback = callback;
+  myCallbackThread = std::this_thread::get_id();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Logger::clearLogCallback()
 {
+  flush();
+
+  myCallbackThread = std::thread::id();
   myLogCallback = logCallback();
 }
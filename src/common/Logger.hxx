@@ -19,8 +19,11 @@
 #define LOGGER_HXX
 
 #include <functional>
+#include <thread>
+#include <atomic>
 
 #include "bspf.hxx"
+#include "LockFreeQueue.hxx"
 
 class Logger {
 
@@ -52,17 +55,36 @@ class Logger {
 
     void clearLogCallback();
 
+    /**
+      Pass the messages logged by other threads on to the log callback.
+      Messages are only ever delivered on the thread which set the callback,
+      so this must be called regularly from that thread.
+    */
+    void flush();
+
   protected:
 
     Logger() = default;
 
   private:
 
+    struct Message {
+      string text;
+      Level level{Level::INFO};
+    };
+
     logCallback myLogCallback;
 
+    // The thread the callback is invoked on (none without a callback)
+    std::atomic<std::thread::id> myCallbackThread;
+
+    // Messages from other threads; these never block on the callback
+    Common::LockFreeQueue<Message, 512> myMessages;
+    std::atomic<uInt32> myDroppedMessages{0};
+
   private:
 
-    void logMessage(const string& message, Level level) const;
+    void logMessage(const string& message, Level level);
 
     Logger(const Logger&) = delete;
     Logger(Logger&&) = delete;
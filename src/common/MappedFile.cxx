@@ -0,0 +1,244 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#if defined(BSPF_UNIX) || defined(BSPF_MACOS)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#elif defined(BSPF_WINDOWS)
+  #include <windows.h>
+#else
+  #include <fstream>
+#endif
+
+#include "MappedFile.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MappedFile::MappedFile()
+  : myData(nullptr),
+    mySize(0),
+    myWritable(false)
+#if defined(BSPF_UNIX) || defined(BSPF_MACOS)
+  , myFd(-1)
+#elif defined(BSPF_WINDOWS)
+  , myFile(INVALID_HANDLE_VALUE),
+    myMapping(nullptr)
+#endif
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+#if defined(BSPF_UNIX) || defined(BSPF_MACOS)
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MappedFile::openRead(const string& path)
+{
+  close();
+
+  struct stat st;
+  if((myFd = ::open(path.c_str(), O_RDONLY)) < 0 || fstat(myFd, &st) != 0 ||
+     st.st_size <= 0)
+  {
+    close();
+    return false;
+  }
+  mySize = size_t(st.st_size);
+
+  void* data = mmap(nullptr, mySize, PROT_READ, MAP_SHARED, myFd, 0);
+  if(data == MAP_FAILED)
+  {
+    close();
+    return false;
+  }
+  myData = static_cast<uInt8*>(data);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MappedFile::openWrite(const string& path, size_t size)
+{
+  close();
+
+  if(size == 0 ||
+     (myFd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0 ||
+     ftruncate(myFd, off_t(size)) != 0)
+  {
+    close();
+    return false;
+  }
+  mySize = size;
+
+  void* data = mmap(nullptr, mySize, PROT_READ | PROT_WRITE, MAP_SHARED, myFd, 0);
+  if(data == MAP_FAILED)
+  {
+    close();
+    return false;
+  }
+  myData = static_cast<uInt8*>(data);
+  myWritable = true;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MappedFile::close()
+{
+  if(myData)
+    munmap(myData, mySize);
+  if(myFd >= 0)
+    ::close(myFd);
+
+  myData = nullptr;
+  mySize = 0;
+  myWritable = false;
+  myFd = -1;
+}
+
+#elif defined(BSPF_WINDOWS)
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MappedFile::openRead(const string& path)
+{
+  close();
+
+  LARGE_INTEGER size;
+  myFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                       OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if(myFile == INVALID_HANDLE_VALUE || !GetFileSizeEx(myFile, &size) ||
+     size.QuadPart <= 0 ||
+     (myMapping = CreateFileMappingA(myFile, nullptr, PAGE_READONLY, 0, 0, nullptr)) == nullptr)
+  {
+    close();
+    return false;
+  }
+  mySize = size_t(size.QuadPart);
+
+  myData = static_cast<uInt8*>(MapViewOfFile(myMapping, FILE_MAP_READ, 0, 0, 0));
+  if(!myData)
+  {
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MappedFile::openWrite(const string& path, size_t size)
+{
+  close();
+
+  const uInt64 size64 = size;
+  myFile = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                       CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if(size == 0 || myFile == INVALID_HANDLE_VALUE ||
+     (myMapping = CreateFileMappingA(myFile, nullptr, PAGE_READWRITE,
+        DWORD(size64 >> 32), DWORD(size64 & 0xffffffff), nullptr)) == nullptr)
+  {
+    close();
+    return false;
+  }
+  mySize = size;
+
+  myData = static_cast<uInt8*>(MapViewOfFile(myMapping, FILE_MAP_WRITE, 0, 0, 0));
+  if(!myData)
+  {
+    close();
+    return false;
+  }
+  myWritable = true;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MappedFile::close()
+{
+  if(myData)
+    UnmapViewOfFile(myData);
+  if(myMapping)
+    CloseHandle(myMapping);
+  if(myFile != INVALID_HANDLE_VALUE)
+    CloseHandle(myFile);
+
+  myData = nullptr;
+  mySize = 0;
+  myWritable = false;
+  myFile = INVALID_HANDLE_VALUE;
+  myMapping = nullptr;
+}
+
+#else
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MappedFile::openRead(const string& path)
+{
+  close();
+
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if(!in || in.tellg() <= 0)
+    return false;
+
+  myBuffer.resize(size_t(in.tellg()));
+  in.seekg(0);
+  if(!in.read(reinterpret_cast<char*>(myBuffer.data()), myBuffer.size()))
+  {
+    myBuffer.clear();
+    return false;
+  }
+  myData = myBuffer.data();
+  mySize = myBuffer.size();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MappedFile::openWrite(const string& path, size_t size)
+{
+  close();
+
+  if(size == 0)
+    return false;
+
+  myBuffer.assign(size, 0);
+  myData = myBuffer.data();
+  mySize = size;
+  myPath = path;
+  myWritable = true;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MappedFile::close()
+{
+  if(myData && myWritable)
+  {
+    std::ofstream out(myPath, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(myData), mySize);
+  }
+
+  myBuffer.clear();
+  myData = nullptr;
+  mySize = 0;
+  myWritable = false;
+}
+#endif
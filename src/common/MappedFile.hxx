@@ -0,0 +1,90 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef MAPPED_FILE_HXX
+#define MAPPED_FILE_HXX
+
+#include "bspf.hxx"
+
+/**
+  A file mapped into memory.  Where the platform supports it, the file
+  is accessed through the page cache (mmap/MapViewOfFile), so neither
+  reading nor writing copies its contents.  Elsewhere, the file is read
+  into a buffer, and written back when it is closed.
+
+  @author  Stephen Anthony
+*/
+class MappedFile
+{
+  public:
+    MappedFile();
+    ~MappedFile();
+
+    /**
+      Map an existing file for reading.
+
+      @param path  The file to map
+      @return  True on success
+    */
+    bool openRead(const string& path);
+
+    /**
+      Create (or truncate) a file of the given size and map it for writing.
+
+      @param path  The file to map
+      @param size  The size of the file
+      @return  True on success
+    */
+    bool openWrite(const string& path, size_t size);
+
+    /**
+      Unmap the file, writing back any changes.
+    */
+    void close();
+
+    bool isOpen() const { return myData != nullptr; }
+
+    uInt8* data() { return myData; }
+    const uInt8* data() const { return myData; }
+    size_t size() const { return mySize; }
+
+  private:
+    uInt8* myData;
+    size_t mySize;
+    bool myWritable;
+
+    // Native handles of the mapped file, or the buffer and name of the
+    // file when mapping is not supported
+  #if defined(BSPF_UNIX) || defined(BSPF_MACOS)
+    int myFd;
+  #elif defined(BSPF_WINDOWS)
+    void* myFile;
+    void* myMapping;
+  #else
+    ByteArray myBuffer;
+    string myPath;
+  #endif
+
+  private:
+    // Following constructors and assignment operators not supported
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+};
+
+#endif
@@ -408,10 +408,12 @@ PhysicalKeyboardHandler::EventMappingArray PhysicalKeyboardHandler::DefaultCommo
   {Event::ConsoleRightDiffB,        KBDK_F8},
   {Event::SaveState,                KBDK_F9},
   {Event::SaveAllStates,            KBDK_F9, MOD3},
+  {Event::ToggleMovieRecord,        KBDK_F9, KBDM_SHIFT | MOD3},
   {Event::ChangeState,              KBDK_F10},
   {Event::ToggleAutoSlot,           KBDK_F10, MOD3},
   {Event::LoadState,                KBDK_F11},
   {Event::LoadAllStates,            KBDK_F11, MOD3},
+  {Event::ToggleMoviePlayback,      KBDK_F11, KBDM_SHIFT | MOD3},
   {Event::TakeSnapshot,             KBDK_F12},
   {Event::Fry,                      KBDK_BACKSPACE},
   {Event::TogglePauseMode,          KBDK_PAUSE},
@@ -455,11 +457,15 @@ PhysicalKeyboardHandler::EventMappingArray PhysicalKeyboardHandler::DefaultCommo
   {Event::TogglePalette,            KBDK_P, KBDM_CTRL},
   {Event::ToggleJitter,             KBDK_J, MOD3},
   {Event::ToggleFrameStats,         KBDK_L, MOD3},
+  {Event::ToggleTelemetry,          KBDK_L, KBDM_SHIFT | MOD3},
+  {Event::ToggleLineTiming,         KBDK_K, MOD3},
   {Event::ToggleTimeMachine,        KBDK_T, MOD3},
 #ifdef PNG_SUPPORT
   {Event::ToggleContSnapshots,      KBDK_S, MOD3},
   {Event::ToggleContSnapshotsFrame, KBDK_S, KBDM_SHIFT | MOD3},
 #endif
+  {Event::ToggleFrameRecording,     KBDK_R, MOD3},
+  {Event::ToggleTurbo,              KBDK_Y, MOD3},
   {Event::HandleMouseControl,       KBDK_0, KBDM_CTRL},
   {Event::ToggleGrabMouse,          KBDK_G, KBDM_CTRL},
   {Event::ToggleSAPortOrder,        KBDK_1, KBDM_CTRL},
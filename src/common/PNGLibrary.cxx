@@ -24,8 +24,10 @@
 #include "Console.hxx"
 #include "FrameBuffer.hxx"
 #include "FBSurface.hxx"
+#include "FSNode.hxx"
 #include "Props.hxx"
 #include "Settings.hxx"
+#include "TIA.hxx"
 #include "TIASurface.hxx"
 #include "Version.hxx"
 #include "PNGLibrary.hxx"
@@ -34,12 +36,33 @@
 PNGLibrary::PNGLibrary(OSystem& osystem)
   : myOSystem(osystem),
     mySnapInterval(0),
-    mySnapCounter(0)
+    mySnapCounter(0),
+    myQuitWriters(false)
 {
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PNGLibrary::~PNGLibrary()
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myQuitWriters = true;
+  }
+  myJobAvailable.notify_all();
+
+  for(auto& writer: myWriters)
+    writer.join();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PNGLibrary::loadImage(const string& filename, FBSurface& surface)
+{
+  decodeImage(filename, myImage);
+  loadImage(myImage, surface);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::decodeImage(const string& filename, Image& image)
 {
   png_structp png_ptr = nullptr;
   png_infop info_ptr = nullptr;
@@ -64,59 +87,68 @@ void PNGLibrary::loadImage(const string& filename, FBSurface& surface)
     loadImageERROR("Couldn't allocate memory for PNG file");
 
   // Allocate/initialize the memory for image information.  REQUIRED.
-	info_ptr = png_create_info_struct(png_ptr);
+  info_ptr = png_create_info_struct(png_ptr);
   if(info_ptr == nullptr)
     loadImageERROR("Couldn't create image information for PNG file");
 
-  // Set up the input control
-  png_set_read_fn(png_ptr, &in, png_read_data);
-
-  // Read PNG header info
-  png_read_info(png_ptr, info_ptr);
-  png_get_IHDR(png_ptr, info_ptr, &iwidth, &iheight, &bit_depth,
-    &color_type, &interlace_type, nullptr, nullptr);
+  try
+  {
+    // Set up the input control
+    png_set_read_fn(png_ptr, &in, png_read_data);
 
-  // Tell libpng to strip 16 bit/color files down to 8 bits/color
-  png_set_strip_16(png_ptr);
+    // Read PNG header info
+    png_read_info(png_ptr, info_ptr);
+    png_get_IHDR(png_ptr, info_ptr, &iwidth, &iheight, &bit_depth,
+      &color_type, &interlace_type, nullptr, nullptr);
 
-  // Extract multiple pixels with bit depths of 1, 2, and 4 from a single
-  // byte into separate bytes (useful for paletted and grayscale images).
-  png_set_packing(png_ptr);
+    // Tell libpng to strip 16 bit/color files down to 8 bits/color
+    png_set_strip_16(png_ptr);
 
-  // Only normal RBG(A) images are supported (without the alpha channel)
-  if(color_type == PNG_COLOR_TYPE_RGBA)
-  {
-    png_set_strip_alpha(png_ptr);
-  }
-  else if(color_type == PNG_COLOR_TYPE_GRAY || color_type == PNG_COLOR_TYPE_GRAY_ALPHA)
-  {
-    loadImageERROR("Greyscale PNG images not supported");
-  }
-  else if(color_type == PNG_COLOR_TYPE_PALETTE)
-  {
-    png_set_palette_to_rgb(png_ptr);
-  }
-  else if(color_type != PNG_COLOR_TYPE_RGB)
-  {
-    loadImageERROR("Unknown format in PNG image");
-  }
+    // Extract multiple pixels with bit depths of 1, 2, and 4 from a single
+    // byte into separate bytes (useful for paletted and grayscale images).
+    png_set_packing(png_ptr);
 
-  // Create/initialize storage area for the current image
-  if(!allocateStorage(iwidth, iheight))
-    loadImageERROR("Not enough memory to read PNG file");
+    // Only normal RBG(A) images are supported (without the alpha channel)
+    if(color_type == PNG_COLOR_TYPE_RGBA)
+    {
+      png_set_strip_alpha(png_ptr);
+    }
+    else if(color_type == PNG_COLOR_TYPE_GRAY || color_type == PNG_COLOR_TYPE_GRAY_ALPHA)
+    {
+      loadImageERROR("Greyscale PNG images not supported");
+    }
+    else if(color_type == PNG_COLOR_TYPE_PALETTE)
+    {
+      png_set_palette_to_rgb(png_ptr);
+    }
+    else if(color_type != PNG_COLOR_TYPE_RGB)
+    {
+      loadImageERROR("Unknown format in PNG image");
+    }
 
-  // The PNG read function expects an array of rows, not a single 1-D array
-  for(uInt32 irow = 0, offset = 0; irow < ReadInfo.height; ++irow, offset += ReadInfo.pitch)
-    ReadInfo.row_pointers[irow] = png_bytep(ReadInfo.buffer.get() + offset);
+    // Create space for the entire image (3 bytes per pixel in RGB format)
+    image.width  = iwidth;
+    image.height = iheight;
+    image.pixels.resize(size_t(iwidth) * iheight * 3);
 
-  // Read the entire image in one go
-  png_read_image(png_ptr, ReadInfo.row_pointers.get());
+    // The PNG read function expects an array of rows, not a single 1-D array
+    vector<png_bytep> row_pointers(iheight);
+    for(uInt32 irow = 0; irow < iheight; ++irow)
+      row_pointers[irow] = image.pixels.data() + size_t(irow) * iwidth * 3;
 
-  // We're finished reading
-  png_read_end(png_ptr, info_ptr);
+    // Read the entire image in one go
+    png_read_image(png_ptr, row_pointers.data());
 
-  // Load image into the surface, setting the correct dimensions
-  loadImagetoSurface(surface);
+    // We're finished reading
+    png_read_end(png_ptr, info_ptr);
+  }
+  catch(const runtime_error&)
+  {
+    // Errors reported by libpng itself must clean up as well
+    if(png_ptr)
+      png_destroy_read_struct(&png_ptr, info_ptr ? &info_ptr : nullptr, nullptr);
+    throw;
+  }
 
   // Cleanup
   if(png_ptr)
@@ -129,22 +161,14 @@ void PNGLibrary::saveImage(const string& filename, const VariantList& comments)
   ofstream out(filename, std::ios_base::binary);
   if(!out.is_open())
     throw runtime_error("ERROR: Couldn't create snapshot file");
+  FilesystemNode::invalidateCache(filename);
 
-  const FrameBuffer& fb = myOSystem.frameBuffer();
-  const Common::Rect& rect = fb.imageRect();
-  png_uint_32 width = rect.w(), height = rect.h();
-
-  // Get framebuffer pixel data (we get ABGR format)
-  unique_ptr<png_byte[]> buffer = make_unique<png_byte[]>(width * height * 4);
-  fb.readPixels(buffer.get(), width*4, rect);
-
-  // Set up pointers into "buffer" byte array
-  unique_ptr<png_bytep[]> rows = make_unique<png_bytep[]>(height);
-  for(png_uint_32 k = 0; k < height; ++k)
-    rows[k] = png_bytep(buffer.get() + k*width*4);
+  vector<png_byte> buffer;
+  png_uint_32 width, height;
+  captureImage(buffer, width, height);
 
   // And save the image
-  saveImageToDisk(out, rows, width, height, comments);
+  saveImageToDisk(out, buffer.data(), width, height, comments);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -154,9 +178,50 @@ void PNGLibrary::saveImage(const string& filename, const FBSurface& surface,
   ofstream out(filename, std::ios_base::binary);
   if(!out.is_open())
     throw runtime_error("ERROR: Couldn't create snapshot file");
+  FilesystemNode::invalidateCache(filename);
+
+  vector<png_byte> buffer;
+  png_uint_32 width, height;
+  captureImage(buffer, width, height, surface, rect);
+
+  // And save the image
+  saveImageToDisk(out, buffer.data(), width, height, comments);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::saveImage(const string& filename, const uInt32* pixels,
+                           uInt32 width, uInt32 height, const VariantList& comments)
+{
+  ofstream out(filename, std::ios_base::binary);
+  if(!out.is_open())
+    throw runtime_error("ERROR: Couldn't create snapshot file");
+  FilesystemNode::invalidateCache(filename);
+
+  // The values are stored as BGRX bytes, as captured from a surface
+  saveImageToDisk(out, reinterpret_cast<const png_byte*>(pixels), width, height,
+                  comments);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::captureImage(vector<png_byte>& buffer,
+                              png_uint_32& width, png_uint_32& height)
+{
+  const FrameBuffer& fb = myOSystem.frameBuffer();
+  const Common::Rect& rect = fb.imageRect();
+  width = rect.w();  height = rect.h();
+
+  // Get framebuffer pixel data (we get ABGR format)
+  buffer.resize(width * height * 4);
+  fb.readPixels(buffer.data(), width*4, rect);
+}
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::captureImage(vector<png_byte>& buffer,
+                              png_uint_32& width, png_uint_32& height,
+                              const FBSurface& surface, const Common::Rect& rect)
+{
   // Do we want the entire surface or just a section?
-  png_uint_32 width = rect.w(), height = rect.h();
+  width = rect.w();  height = rect.h();
   if(rect.empty())
   {
     width = surface.width();
@@ -164,24 +229,145 @@ void PNGLibrary::saveImage(const string& filename, const FBSurface& surface,
   }
 
   // Get the surface pixel data (we get ABGR format)
-  unique_ptr<png_byte[]> buffer = make_unique<png_byte[]>(width * height * 4);
-  surface.readPixels(buffer.get(), width, rect);
+  buffer.resize(width * height * 4);
+  surface.readPixels(buffer.data(), width, rect);
+}
 
-  // Set up pointers into "buffer" byte array
-  unique_ptr<png_bytep[]> rows = make_unique<png_bytep[]>(height);
-  for(png_uint_32 k = 0; k < height; ++k)
-    rows[k] = png_bytep(buffer.get() + k*width*4);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PNGLibrary::captureIndexedImage(SaveJob& job, bool native)
+{
+  const uInt32* rgb = myOSystem.frameBuffer().tiaSurface().rgbPalette();
+  if(rgb == nullptr)
+    return false;
 
-  // And save the image
-  saveImageToDisk(out, rows, width, height, comments);
+  job.palette.resize(256);
+  for(uInt32 i = 0; i < 256; ++i)
+  {
+    job.palette[i].red   = png_byte(rgb[i] >> 16);
+    job.palette[i].green = png_byte(rgb[i] >> 8);
+    job.palette[i].blue  = png_byte(rgb[i]);
+  }
+
+  // The TIA pixels are doubled horizontally, unless the aspect ratio is
+  // noted in the image instead
+  TIA& tia = myOSystem.console().tia();
+  const uInt32 tiaw = tia.width();
+  job.width = native ? tiaw : tiaw * 2;
+  job.height = tia.height();
+  job.widePixels = native;
+  job.pixels.resize(job.width * job.height);
+
+  const uInt8* src = tia.frameBuffer();
+  png_byte* dst = job.pixels.data();
+  for(uInt32 y = 0; y < job.height; ++y, src += tiaw)
+  {
+    if(native)
+      dst = std::copy(src, src + tiaw, dst);
+    else
+      for(uInt32 x = 0; x < tiaw; ++x)
+      {
+        *dst++ = src[x];
+        *dst++ = src[x];
+      }
+  }
+
+  return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void PNGLibrary::saveImageToDisk(ofstream& out, const unique_ptr<png_bytep[]>& rows,
-    png_uint_32 width, png_uint_32 height, const VariantList& comments)
+vector<png_byte> PNGLibrary::acquireBuffer()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  vector<png_byte> buffer;
+  if(!myBufferPool.empty())
+  {
+    buffer = std::move(myBufferPool.back());
+    myBufferPool.pop_back();
+  }
+  return buffer;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::queueImage(SaveJob&& job)
+{
+  // Leave one core to the emulation; the remaining ones (up to four) take
+  // turns compressing frames when snapshots are taken continuously
+  if(myWriters.empty())
+  {
+    uInt32 count = BSPF::clamp(std::thread::hardware_concurrency(), 2u, 5u) - 1;
+    for(uInt32 i = 0; i < count; ++i)
+      myWriters.emplace_back(&PNGLibrary::writerLoop, this);
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(myMutex);
+    myJobTaken.wait(lock, [this] { return myJobs.size() < myWriters.size() * 2; });
+    myJobs.push_back(std::move(job));
+  }
+  myJobAvailable.notify_one();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::writerLoop()
+{
+  for(;;)
+  {
+    SaveJob job;
+    {
+      std::unique_lock<std::mutex> lock(myMutex);
+      myJobAvailable.wait(lock, [this] { return myQuitWriters || !myJobs.empty(); });
+      if(myJobs.empty())
+        return;
+
+      job = std::move(myJobs.front());
+      myJobs.pop_front();
+    }
+    myJobTaken.notify_one();
+
+    string error;
+    try
+    {
+      saveImageToDisk(job.out, job.pixels.data(), job.width, job.height,
+                      job.comments, job.palette, job.widePixels);
+    }
+    catch(const runtime_error& e)
+    {
+      error = e.what();
+    }
+    job.out.close();
+
+    std::lock_guard<std::mutex> lock(myMutex);
+    if(!error.empty() && myWriteError.empty())
+      myWriteError = error;
+    myBufferPool.push_back(std::move(job.pixels));
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string PNGLibrary::takeWriteError()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  string error;
+  error.swap(myWriteError);
+  return error;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGLibrary::saveImageToDisk(ofstream& out, const png_byte* pixels,
+    png_uint_32 width, png_uint_32 height, const VariantList& comments,
+    const vector<png_color>& palette, bool widePixels)
 {
   png_structp png_ptr = nullptr;
   png_infop info_ptr = nullptr;
+  const bool indexed = !palette.empty();
+
+  // Set up pointers into the "pixels" byte array
+  const png_uint_32 pitch = indexed ? width : width * 4;
+  unique_ptr<png_bytep[]> rows = make_unique<png_bytep[]>(height);
+  for(png_uint_32 k = 0; k < height; ++k)
+    rows[k] = const_cast<png_bytep>(pixels + k*pitch);
 
   auto saveImageERROR = [&](const char* s) {
     if(png_ptr)
@@ -206,8 +392,14 @@ void PNGLibrary::saveImageToDisk(ofstream& out, const unique_ptr<png_bytep[]>& r
 
   // Write PNG header info
   png_set_IHDR(png_ptr, info_ptr, width, height, 8,
-      PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
-      PNG_FILTER_TYPE_DEFAULT);
+      indexed ? PNG_COLOR_TYPE_PALETTE : PNG_COLOR_TYPE_RGB,
+      PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+  if(indexed)
+    png_set_PLTE(png_ptr, info_ptr, palette.data(), int(palette.size()));
+
+  // The pixel aspect ratio is given as pixels per unit (i.e. 1 x 2)
+  if(widePixels)
+    png_set_pHYs(png_ptr, info_ptr, 1, 2, PNG_RESOLUTION_UNKNOWN);
 
   // Write comments
   writeComments(png_ptr, info_ptr, comments);
@@ -215,17 +407,20 @@ void PNGLibrary::saveImageToDisk(ofstream& out, const unique_ptr<png_bytep[]>& r
   // Write the file header information.  REQUIRED
   png_write_info(png_ptr, info_ptr);
 
-  // Pack pixels into bytes
-  png_set_packing(png_ptr);
+  if(!indexed)
+  {
+    // Pack pixels into bytes
+    png_set_packing(png_ptr);
 
-  // Swap location of alpha bytes from ARGB to RGBA
-  png_set_swap_alpha(png_ptr);
+    // Swap location of alpha bytes from ARGB to RGBA
+    png_set_swap_alpha(png_ptr);
 
-  // Pack ARGB into RGB
-  png_set_filler(png_ptr, 0, PNG_FILLER_AFTER);
+    // Pack ARGB into RGB
+    png_set_filler(png_ptr, 0, PNG_FILLER_AFTER);
 
-  // Flip BGR pixels to RGB
-  png_set_bgr(png_ptr);
+    // Flip BGR pixels to RGB
+    png_set_bgr(png_ptr);
+  }
 
   // Write the entire image in one go
   png_write_image(png_ptr, rows.get());
@@ -341,81 +536,60 @@ void PNGLibrary::takeSnapshot(uInt32 number)
   VarList::push_back(comments, "ROM MD5", myOSystem.console().properties().get(PropType::Cart_MD5));
   VarList::push_back(comments, "TV Effects", myOSystem.frameBuffer().tiaSurface().effectsInfo());
 
-  // Now create a PNG snapshot
-  if(myOSystem.settings().getBool("ss1x"))
-  {
-    string message = "Snapshot saved";
-    try
-    {
-      Common::Rect rect;
-      const FBSurface& surface = myOSystem.frameBuffer().tiaSurface().baseSurface(rect);
-      myOSystem.png().saveImage(filename, surface, rect, comments);
-    }
-    catch(const runtime_error& e)
-    {
-      message = e.what();
-    }
-    if(showmessage)
-      myOSystem.frameBuffer().showMessage(message);
-  }
-  else
+  // Now capture a PNG snapshot; it is compressed and written in the background
+  SaveJob job;
+  string message = "Snapshot saved";
+  job.out.open(filename, std::ios_base::binary);
+  if(job.out.is_open())
   {
-    // Make sure we have a 'clean' image, with no onscreen messages
-    myOSystem.frameBuffer().enableMessages(false);
-    myOSystem.frameBuffer().tiaSurface().renderForSnapshot();
+    job.pixels = acquireBuffer();
+    job.comments = std::move(comments);
 
-    string message = "Snapshot saved";
-    try
-    {
-      myOSystem.png().saveImage(filename, comments);
-    }
-    catch(const runtime_error& e)
-    {
-      message = e.what();
-    }
+    // Without TV effects, the image can be taken from the TIA directly,
+    // which is much faster to capture and compress
+    const TIASurface& tiaSurface = myOSystem.frameBuffer().tiaSurface();
+    const string& format = myOSystem.settings().getString("ssformat");
+    const bool indexed = format != "rgb" && !tiaSurface.ntscEnabled() &&
+        !tiaSurface.phosphorEnabled() && captureIndexedImage(job, format == "native");
 
-    // Re-enable old messages
-    myOSystem.frameBuffer().enableMessages(true);
-    if(showmessage)
-      myOSystem.frameBuffer().showMessage(message);
-  }
-}
+    if(!indexed)
+    {
+      if(myOSystem.settings().getBool("ss1x"))
+      {
+        Common::Rect rect;
+        const FBSurface& surface = myOSystem.frameBuffer().tiaSurface().baseSurface(rect);
+        captureImage(job.pixels, job.width, job.height, surface, rect);
+      }
+      else
+      {
+        // Make sure we have a 'clean' image, with no onscreen messages
+        myOSystem.frameBuffer().enableMessages(false);
+        myOSystem.frameBuffer().tiaSurface().renderForSnapshot();
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool PNGLibrary::allocateStorage(png_uint_32 w, png_uint_32 h)
-{
-  // Create space for the entire image (3 bytes per pixel in RGB format)
-  uInt32 req_buffer_size = w * h * 3;
-  if(req_buffer_size > ReadInfo.buffer_size)
-  {
-    ReadInfo.buffer = make_unique<png_byte[]>(req_buffer_size);
-    if(ReadInfo.buffer == nullptr)
-      return false;
+        captureImage(job.pixels, job.width, job.height);
 
-    ReadInfo.buffer_size = req_buffer_size;
-  }
-  uInt32 req_row_size = h;
-  if(req_row_size > ReadInfo.row_size)
-  {
-    ReadInfo.row_pointers = make_unique<png_bytep[]>(req_row_size);
-    if(ReadInfo.row_pointers == nullptr)
-      return false;
-
-    ReadInfo.row_size = req_row_size;
+        // Re-enable old messages
+        myOSystem.frameBuffer().enableMessages(true);
+      }
+    }
+    queueImage(std::move(job));
   }
-
-  ReadInfo.width  = w;
-  ReadInfo.height = h;
-  ReadInfo.pitch  = w * 3;
-
-  return true;
+  else
+    message = "ERROR: Couldn't create snapshot file";
+
+  // Errors of earlier snapshots are only known now, and are always shown
+  string error = takeWriteError();
+  if(!error.empty())
+    myOSystem.frameBuffer().showMessage(error);
+  else if(showmessage)
+    myOSystem.frameBuffer().showMessage(message);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void PNGLibrary::loadImagetoSurface(FBSurface& surface)
+void PNGLibrary::loadImage(const Image& image, FBSurface& surface)
 {
   // First determine if we need to resize the surface
-  uInt32 iw = ReadInfo.width, ih = ReadInfo.height;
+  uInt32 iw = image.width, ih = image.height;
   if(iw > surface.width() || ih > surface.height())
     surface.resize(iw, ih);
 
@@ -427,15 +601,15 @@ void PNGLibrary::loadImagetoSurface(FBSurface& surface)
   // Convert RGB triples into pixels and store in the surface
   uInt32 *s_buf, s_pitch;
   surface.basePtr(s_buf, s_pitch);
-  uInt8* i_buf = ReadInfo.buffer.get();
-  uInt32 i_pitch = ReadInfo.pitch;
+  const uInt8* i_buf = image.pixels.data();
+  uInt32 i_pitch = iw * 3;
 
   const FrameBuffer& fb = myOSystem.frameBuffer();
   for(uInt32 irow = 0; irow < ih; ++irow, i_buf += i_pitch, s_buf += s_pitch)
   {
-    uInt8*  i_ptr = i_buf;
+    const uInt8* i_ptr = i_buf;
     uInt32* s_ptr = s_buf;
-    for(uInt32 icol = 0; icol < ReadInfo.width; ++icol, i_ptr += 3)
+    for(uInt32 icol = 0; icol < iw; ++icol, i_ptr += 3)
       *s_ptr++ = fb.mapRGB(*i_ptr, *(i_ptr+1), *(i_ptr+2));
   }
 }
@@ -491,9 +665,4 @@ void PNGLibrary::png_user_error(png_structp ctx, png_const_charp str)
   throw runtime_error(string("PNGLibrary error: ") + str);
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-PNGLibrary::ReadInfoType PNGLibrary::ReadInfo = {
-  nullptr, nullptr, 0, 0, 0, 0, 0
-};
-
 #endif  // PNG_SUPPORT
@@ -20,6 +20,10 @@
 #ifndef PNGLIBRARY_HXX
 #define PNGLIBRARY_HXX
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <png.h>
 
 class OSystem;
@@ -28,19 +32,39 @@ class FBSurface;
 class Properties;
 
 #include "bspf.hxx"
+#include "Rect.hxx"
+#include "Variant.hxx"
 
 /**
   This class implements a thin wrapper around the libpng library, and
   abstracts all the irrelevant details other loading and saving an
   actual image.
 
+  Snapshots taken with takeSnapshot() are only captured on the calling
+  thread; compressing and writing them happens on background writer
+  threads, so that continuous (per-frame) snapshots don't stall emulation.
+
   @author  Stephen Anthony
 */
 class PNGLibrary
 {
+  public:
+    // A decoded image, as RGB triples
+    struct Image {
+      vector<uInt8> pixels;
+      uInt32 width, height;
+
+      Image() : width(0), height(0) { }
+    };
+
   public:
     explicit PNGLibrary(OSystem& osystem);
 
+    /**
+      Waits until all pending snapshots have been written.
+    */
+    ~PNGLibrary();
+
     /**
       Read a PNG image from the specified file into a FBSurface structure,
       scaling the image to the surface bounds.
@@ -54,6 +78,28 @@ class PNGLibrary
     */
     void loadImage(const string& filename, FBSurface& surface);
 
+    /**
+      Read a PNG image from the specified file, without placing it in a
+      surface yet.  Unlike the other methods, this can be called from any
+      thread.
+
+      @param filename  The filename to load the PNG image
+      @param image     The decoded image, resized as necessary
+
+      @post  On failure, a runtime_error is thrown containing a more
+             detailed error message.
+    */
+    static void decodeImage(const string& filename, Image& image);
+
+    /**
+      Load a decoded image into a FBSurface structure.  The surface is
+      resized as necessary to accommodate the data.
+
+      @param image    The decoded image
+      @param surface  The FBSurface into which to place the image data
+    */
+    void loadImage(const Image& image, FBSurface& surface);
+
     /**
       Save the current FrameBuffer image to a PNG file.  Note that in most
       cases this will be a TIA image, but it could actually be used for
@@ -85,6 +131,25 @@ class PNGLibrary
                    const Common::Rect& rect = Common::EmptyRect,
                    const VariantList& comments = EmptyVarList);
 
+    /**
+      Save an image given as RGB values (0x00RRGGBB) to a PNG file.  Unlike
+      the other methods, this doesn't need a FrameBuffer, and can be called
+      from any thread (e.g. to create snapshots headless).
+
+      @param filename  The filename to save the PNG image
+      @param pixels    The RGB values of the image, row by row
+      @param width     The width of the image
+      @param height    The height of the image
+      @param comments  The text comments to add to the PNG image
+
+      @post  On success, the PNG file has been saved to 'filename',
+             otherwise a runtime_error is thrown containing a
+             more detailed error message.
+    */
+    static void saveImage(const string& filename, const uInt32* pixels,
+                          uInt32 width, uInt32 height,
+                          const VariantList& comments = EmptyVarList);
+
     /**
       Called at regular intervals, and used to determine whether a
       continuous snapshot is due to be taken.
@@ -134,55 +199,104 @@ class PNGLibrary
     uInt32 mySnapInterval;
     uInt32 mySnapCounter;
 
-    // The following data remains between invocations of allocateStorage,
-    // and is only changed when absolutely necessary.
-    struct ReadInfoType {
-      ByteBuffer buffer;
-      unique_ptr<png_bytep[]> row_pointers;
-      png_uint_32 width, height, pitch;
-      uInt32 buffer_size, row_size;
+    // A captured image waiting to be compressed and written to disk; the
+    // pixels are palette indices if there is a palette, ABGR otherwise
+    struct SaveJob {
+      ofstream out;
+      vector<png_byte> pixels;
+      png_uint_32 width, height;
+      vector<png_color> palette;
+      bool widePixels;
+      VariantList comments;
+
+      SaveJob() : width(0), height(0), widePixels(false) { }
     };
-    static ReadInfoType ReadInfo;
+
+    // Background writers; they are only started with the first snapshot
+    vector<std::thread> myWriters;
+    std::mutex myMutex;
+    std::condition_variable myJobAvailable, myJobTaken;
+    std::deque<SaveJob> myJobs;
+    bool myQuitWriters;
+
+    // Pixel buffers of finished jobs, reused for later captures
+    vector<vector<png_byte>> myBufferPool;
+
+    // The first error reported by a writer since it was last shown
+    string myWriteError;
+
+    // The image last read by loadImage(); its storage is reused, so that
+    // memory isn't constantly allocated and deallocated for each image
+    Image myImage;
+
+    /**
+      Read the current FrameBuffer image resp. (part of) the given surface
+      into 'buffer' (ABGR format), resizing it as necessary.
+    */
+    void captureImage(vector<png_byte>& buffer,
+                      png_uint_32& width, png_uint_32& height);
+    void captureImage(vector<png_byte>& buffer,
+                      png_uint_32& width, png_uint_32& height,
+                      const FBSurface& surface, const Common::Rect& rect);
 
     /**
-      Allocate memory for PNG read operations.  This is used to provide a
-      basic memory manager, so that we don't constantly allocate and deallocate
-      memory for each image loaded.
+      Read the frame of the TIA as palette indices, along with the palette,
+      into the job.  Without any TV effects, this is the same image as
+      captured from the TIA surface in 1x mode.
 
-      The method fills the 'ReadInfo' struct with valid memory locations
-      dependent on the given dimensions.  If memory has been previously
-      allocated and it can accommodate the given dimensions, it is used directly.
+      @param native  Keep the native width of 160 pixels, which are twice
+                     as wide as high, instead of doubling it
+      @return  False if there is no palette
+    */
+    bool captureIndexedImage(SaveJob& job, bool native);
 
-      @param iwidth  The width of the PNG image
-      @param iheight The height of the PNG image
+    /**
+      Take a buffer from the pool, or a new one if the pool is empty.
     */
-    bool allocateStorage(png_uint_32 iwidth, png_uint_32 iheight);
+    vector<png_byte> acquireBuffer();
 
-    /** The actual method which saves a PNG image.
+    /**
+      Hand a captured image to the background writers, starting them if
+      necessary.  If the writers are too far behind, this waits until one
+      of them has taken a job, so no snapshot is ever dropped.
+    */
+    void queueImage(SaveJob&& job);
 
-      @param out      The output stream for writing PNG data
-      @param rows     Pointer into PNG RGB data for each row
-      @param width    The width of the PNG image
-      @param height   The height of the PNG image
-      @param comments The text comments to add to the PNG image
+    /**
+      The loop run by each background writer; it exits once the queue is
+      empty and myQuitWriters is set.
     */
-    void saveImageToDisk(ofstream& out, const unique_ptr<png_bytep[]>& rows,
-                         png_uint_32 width, png_uint_32 height,
-                         const VariantList& comments);
+    void writerLoop();
 
     /**
-      Load the PNG data from 'ReadInfo' into the FBSurface.  The surface
-      is resized as necessary to accommodate the data.
+      Answer the first error reported by a writer since the last call,
+      or an empty string if all snapshots were written successfully.
+    */
+    string takeWriteError();
+
+    /** The actual method which saves a PNG image.
 
-      @param surface  The FBSurface into which to place the PNG data
+      @param out        The output stream for writing PNG data
+      @param pixels     The ABGR data of the image, or the palette indices
+                        if a palette is given
+      @param width      The width of the PNG image
+      @param height     The height of the PNG image
+      @param comments   The text comments to add to the PNG image
+      @param palette    The palette of an indexed image
+      @param widePixels Note in the image that its pixels are twice as
+                        wide as high
     */
-    void loadImagetoSurface(FBSurface& surface);
+    static void saveImageToDisk(ofstream& out, const png_byte* pixels,
+                                png_uint_32 width, png_uint_32 height,
+                                const VariantList& comments,
+                                const vector<png_color>& palette = vector<png_color>(),
+                                bool widePixels = false);
 
     /**
       Write PNG tEXt chunks to the image.
     */
-    void writeComments(png_structp png_ptr, png_infop info_ptr,
-                       const VariantList& comments);
+    static void writeComments(png_structp png_ptr, png_infop info_ptr,
+                              const VariantList& comments);
 
     /** PNG library callback functions */
     static void png_read_data(png_structp ctx, png_bytep area, png_size_t size);
@@ -0,0 +1,199 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <fstream>
+#include <iomanip>
+
+#ifdef PERF_COUNTERS
+  #include <mutex>
+#endif
+
+#include "PerfCounters.hxx"
+
+namespace {
+  constexpr uInt8 NUM_COUNTERS = uInt8(PerfCounters::Counter::numCounters);
+
+  const char* const COUNTER_NAMES[NUM_COUNTERS] = {
+    "tia.flushLineCache",
+    "system.devicePeek",
+    "system.devicePoke",
+    "thumbulator.run",
+    "delayqueue.push",
+    "audioqueue.overflow",
+    "rewind.compress",
+    "rewind.replay"
+  };
+
+#ifdef PERF_COUNTERS
+  std::mutex& registryMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+#endif
+}
+
+#ifdef PERF_COUNTERS
+// The blocks of all running threads, and the sums of all threads that
+// have exited since the last reset; guarded by registryMutex()
+struct PerfCounters::ThreadBlockOwner
+{
+  ThreadBlockOwner() : block(make_unique<Block>()) {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    blocks().push_back(block.get());
+
+    // Counting starts with the first thread that counts
+    resetTime();
+  }
+
+  ~ThreadBlockOwner() {
+    std::lock_guard<std::mutex> lock(registryMutex());
+
+    for (uInt8 i = 0; i < NUM_COUNTERS; ++i) {
+      retired().counts[i] += block->counts[i].load(std::memory_order_relaxed);
+      retired().nanoseconds[i] += block->nanoseconds[i].load(std::memory_order_relaxed);
+    }
+
+    auto& all = blocks();
+    all.erase(std::remove(all.begin(), all.end(), block.get()), all.end());
+
+    PerfCounters::myThreadBlock = nullptr;
+  }
+
+  static vector<Block*>& blocks() {
+    static vector<Block*> blocks;
+    return blocks;
+  }
+
+  static Block& retired() {
+    static Block retired{};
+    return retired;
+  }
+
+  static std::chrono::time_point<std::chrono::steady_clock>& resetTime() {
+    static auto resetTime = std::chrono::steady_clock::now();
+    return resetTime;
+  }
+
+  unique_ptr<Block> block;
+};
+
+thread_local PerfCounters::Block* PerfCounters::myThreadBlock = nullptr;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PerfCounters::Block& PerfCounters::registerThread()
+{
+  static thread_local ThreadBlockOwner owner;
+
+  myThreadBlock = owner.block.get();
+
+  return *myThreadBlock;
+}
+#endif
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PerfCounters::enabled()
+{
+#ifdef PERF_COUNTERS
+  return true;
+#else
+  return false;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PerfCounters::reset()
+{
+#ifdef PERF_COUNTERS
+  std::lock_guard<std::mutex> lock(registryMutex());
+
+  // Other threads may be counting while we reset; losing a few of their
+  // counts is fine here
+  auto clear = [] (Block& block) {
+    for (uInt8 i = 0; i < NUM_COUNTERS; ++i) {
+      block.counts[i].store(0, std::memory_order_relaxed);
+      block.nanoseconds[i].store(0, std::memory_order_relaxed);
+    }
+  };
+
+  for (Block* block : ThreadBlockOwner::blocks()) clear(*block);
+  clear(ThreadBlockOwner::retired());
+
+  ThreadBlockOwner::resetTime() = std::chrono::steady_clock::now();
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PerfCounters::print(ostream& out)
+{
+#ifdef PERF_COUNTERS
+  uInt64 counts[NUM_COUNTERS], nanoseconds[NUM_COUNTERS];
+  size_t threads;
+  double seconds;
+
+  {
+    std::lock_guard<std::mutex> lock(registryMutex());
+
+    const Block& retired = ThreadBlockOwner::retired();
+    for (uInt8 i = 0; i < NUM_COUNTERS; ++i) {
+      counts[i] = retired.counts[i].load(std::memory_order_relaxed);
+      nanoseconds[i] = retired.nanoseconds[i].load(std::memory_order_relaxed);
+
+      for (const Block* block : ThreadBlockOwner::blocks()) {
+        counts[i] += block->counts[i].load(std::memory_order_relaxed);
+        nanoseconds[i] += block->nanoseconds[i].load(std::memory_order_relaxed);
+      }
+    }
+
+    threads = ThreadBlockOwner::blocks().size();
+    seconds = std::chrono::duration_cast<std::chrono::duration<double>>(
+      std::chrono::steady_clock::now() - ThreadBlockOwner::resetTime()).count();
+  }
+
+  out << std::fixed << std::setprecision(1)
+      << "counters for the last " << seconds << " seconds ("
+      << threads << " counting threads)" << endl;
+
+  for (uInt8 i = 0; i < NUM_COUNTERS; ++i) {
+    out << "  " << std::left << std::setw(22) << COUNTER_NAMES[i] << std::right
+        << std::setw(14) << counts[i]
+        << std::setw(14) << (seconds > 0 ? counts[i] / seconds : 0.0) << "/s";
+
+    if (nanoseconds[i] > 0)
+      out << std::setprecision(3) << std::setw(12) << (nanoseconds[i] / 1e6) << " ms"
+          << std::setprecision(1)
+          << std::setw(10) << uInt64(nanoseconds[i] / std::max(counts[i], uInt64(1)))
+          << " ns/call";
+
+    out << endl;
+  }
+
+  out << std::defaultfloat;
+#else
+  (void)COUNTER_NAMES;
+  out << "performance counters not compiled in (configure with --enable-perf-counters)"
+      << endl;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool PerfCounters::save(const string& path)
+{
+  std::ofstream out(path);
+  print(out);
+
+  return bool(out);
+}
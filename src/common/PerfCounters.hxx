@@ -0,0 +1,159 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef PERF_COUNTERS_HXX
+#define PERF_COUNTERS_HXX
+
+#ifdef PERF_COUNTERS
+  #include <atomic>
+  #include <chrono>
+#endif
+
+#include "bspf.hxx"
+
+/**
+  Counters and timers for a few hot paths of the emulation core, so that
+  a report of a stuttering game can come with numbers attached.  They are
+  only compiled in if PERF_COUNTERS is defined (configure with
+  --enable-perf-counters); otherwise PERF_COUNT and PERF_TIME expand to
+  nothing.
+
+  Every thread counts into a block of its own, so counting is a plain
+  increment without any locking.  The blocks are only summed up when the
+  counters are read (from the debugger prompt, see 'perf' and 'saveperf').
+
+  @author  Stella Team
+*/
+class PerfCounters
+{
+  public:
+
+    enum class Counter: uInt8 {
+      tiaFlushLineCache,
+      systemDevicePeek,
+      systemDevicePoke,
+      thumbulatorRun,
+      delayQueuePush,
+      audioQueueOverflow,
+      rewindCompress,
+      rewindReplay,
+      numCounters
+    };
+
+    /**
+      Answers whether the counters have been compiled in.
+    */
+    static bool enabled();
+
+    /**
+      Set all counters and timers to zero.
+    */
+    static void reset();
+
+    /**
+      Print all counters and timers, summed up over all threads.
+    */
+    static void print(ostream& out);
+
+    /**
+      Write the output of print() to the given file.
+
+      @return  False if the file could not be written
+    */
+    static bool save(const string& path);
+
+  #ifdef PERF_COUNTERS
+    static void count(Counter counter) {
+      Block& block = threadBlock();
+      block.counts[uInt8(counter)].store(
+        block.counts[uInt8(counter)].load(std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed
+      );
+    }
+
+    static void addTime(Counter counter, uInt64 nanoseconds) {
+      Block& block = threadBlock();
+      block.nanoseconds[uInt8(counter)].store(
+        block.nanoseconds[uInt8(counter)].load(std::memory_order_relaxed) + nanoseconds,
+        std::memory_order_relaxed
+      );
+    }
+
+    /**
+      Counts a call and adds the time until it goes out of scope.
+    */
+    class Timer {
+      public:
+        explicit Timer(Counter counter)
+          : myCounter(counter), myStart(std::chrono::steady_clock::now()) {
+          count(counter);
+        }
+
+        ~Timer() {
+          addTime(myCounter, std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - myStart).count());
+        }
+
+      private:
+        Counter myCounter;
+        std::chrono::time_point<std::chrono::steady_clock> myStart;
+
+      private:
+        Timer() = delete;
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+    };
+
+  private:
+
+    // The counters of a single thread.  Only the owning thread writes, so
+    // relaxed loads and stores are enough for the readers to see values
+    // that are at most slightly stale.
+    struct Block {
+      std::atomic<uInt64> counts[uInt8(Counter::numCounters)];
+      std::atomic<uInt64> nanoseconds[uInt8(Counter::numCounters)];
+    };
+
+    static Block& threadBlock() {
+      return myThreadBlock ? *myThreadBlock : registerThread();
+    }
+
+    static Block& registerThread();
+
+    // Folds the block of a thread into the totals when the thread exits
+    struct ThreadBlockOwner;
+
+  private:
+
+    static thread_local Block* myThreadBlock;
+  #endif
+
+  private:
+    PerfCounters() = delete;
+};
+
+#ifdef PERF_COUNTERS
+  #define PERF_COUNT(counter) \
+    PerfCounters::count(PerfCounters::Counter::counter)
+  #define PERF_TIME(counter) \
+    PerfCounters::Timer perfTimer_##counter(PerfCounters::Counter::counter)
+#else
+  #define PERF_COUNT(counter)
+  #define PERF_TIME(counter)
+#endif
+
+#endif // PERF_COUNTERS_HXX
@@ -0,0 +1,196 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <limits>
+
+#include "RankedMaxTree.hxx"
+
+namespace Common {
+
+// The key of empty slots
+static constexpr double NONE = -std::numeric_limits<double>::infinity();
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RankedMaxTree::RankedMaxTree()
+  : mySlots(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RankedMaxTree::reset(uInt32 slots)
+{
+  mySlots = 1;
+  while(mySlots < slots)
+    mySlots <<= 1;
+
+  myMax.assign(2 * mySlots, NONE);
+  myMaxSlot.resize(2 * mySlots);
+  myPending.assign(2 * mySlots, 0);
+  myCount.assign(2 * mySlots, 0);
+
+  for(uInt32 i = 0; i < mySlots; ++i)
+    myMaxSlot[mySlots + i] = i;
+  for(uInt32 node = mySlots - 1; node > 0; --node)
+    myMaxSlot[node] = myMaxSlot[2 * node + 1];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RankedMaxTree::set(uInt32 slot, double key)
+{
+  set(1, 0, mySlots - 1, slot, key, true);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RankedMaxTree::erase(uInt32 slot)
+{
+  set(1, 0, mySlots - 1, slot, NONE, false);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RankedMaxTree::add(uInt32 from, double delta)
+{
+  if(from < mySlots)
+    add(1, 0, mySlots - 1, from, delta);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 RankedMaxTree::rank(uInt32 slot) const
+{
+  // Walk up from the leaf, counting the left siblings on the way
+  uInt32 count = 0;
+  for(uInt32 node = mySlots + slot; node > 1; node >>= 1)
+    if(node & 1)
+      count += myCount[node - 1];
+
+  return count;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 RankedMaxTree::select(uInt32 rank) const
+{
+  uInt32 node = 1;
+  while(node < mySlots)
+  {
+    node <<= 1;
+    if(rank >= myCount[node])
+      rank -= myCount[node++];
+  }
+  return node - mySlots;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RankedMaxTree::findMax(uInt32 from, uInt32 to, uInt32& slot, double& key)
+{
+  key = NONE;
+  if(from <= to && to < mySlots)
+    findMax(1, 0, mySlots - 1, from, to, slot, key);
+
+  return key != NONE;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RankedMaxTree::push(uInt32 node)
+{
+  if(myPending[node] != 0)
+  {
+    for(uInt32 child = 2 * node; child <= 2 * node + 1; ++child)
+    {
+      myMax[child] += myPending[node];
+      myPending[child] += myPending[node];
+    }
+    myPending[node] = 0;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RankedMaxTree::pull(uInt32 node)
+{
+  const uInt32 left = 2 * node, right = 2 * node + 1;
+  const uInt32 max = myMax[left] > myMax[right] ? left : right;
+
+  myMax[node] = myMax[max];
+  myMaxSlot[node] = myMaxSlot[max];
+  myCount[node] = myCount[left] + myCount[right];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RankedMaxTree::set(uInt32 node, uInt32 lo, uInt32 hi,
+                        uInt32 slot, double key, bool used)
+{
+  if(lo == hi)
+  {
+    myMax[node] = key;
+    myCount[node] = used ? 1 : 0;
+    return;
+  }
+
+  push(node);
+  const uInt32 mid = (lo + hi) / 2;
+  if(slot <= mid)
+    set(2 * node, lo, mid, slot, key, used);
+  else
+    set(2 * node + 1, mid + 1, hi, slot, key, used);
+  pull(node);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RankedMaxTree::add(uInt32 node, uInt32 lo, uInt32 hi, uInt32 from, double delta)
+{
+  if(hi < from)
+    return;
+
+  if(lo >= from)
+  {
+    // Empty slots stay empty, as their key is infinite
+    myMax[node] += delta;
+    if(lo != hi)
+      myPending[node] += delta;
+    return;
+  }
+
+  push(node);
+  const uInt32 mid = (lo + hi) / 2;
+  add(2 * node, lo, mid, from, delta);
+  add(2 * node + 1, mid + 1, hi, from, delta);
+  pull(node);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RankedMaxTree::findMax(uInt32 node, uInt32 lo, uInt32 hi,
+                            uInt32 from, uInt32 to, uInt32& slot, double& key)
+{
+  if(hi < from || lo > to || myCount[node] == 0)
+    return;
+
+  if(lo >= from && hi <= to)
+  {
+    // Later slots are visited last, so they win ties
+    if(myMax[node] >= key)
+    {
+      key = myMax[node];
+      slot = myMaxSlot[node];
+    }
+    return;
+  }
+
+  push(node);
+  const uInt32 mid = (lo + hi) / 2;
+  findMax(2 * node, lo, mid, from, to, slot, key);
+  findMax(2 * node + 1, mid + 1, hi, from, to, slot, key);
+}
+
+} // namespace Common
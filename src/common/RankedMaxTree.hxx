@@ -0,0 +1,120 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef RANKED_MAX_TREE_HXX
+#define RANKED_MAX_TREE_HXX
+
+#include "bspf.hxx"
+
+namespace Common {
+
+/**
+  A segment tree over a fixed number of slots, each of which is either
+  empty or holds a key.  Besides changing single keys, a value can be
+  added to the keys of all slots from a given one on, and the slot with
+  the largest key in a range can be found, all in O(log n).  The slots
+  in use are counted as well, so the rank of a slot (the number of slots
+  in use before it) can be determined, and vice versa.
+
+  Slots are meant to be assigned in the order entries are added to a list,
+  so the rank of a slot is the position of its entry in the list.
+
+  @author  Stephen Anthony
+*/
+class RankedMaxTree
+{
+  public:
+    RankedMaxTree();
+
+    /**
+      Make all slots empty, and provide at least the given number of them.
+    */
+    void reset(uInt32 slots);
+
+    /**
+      The number of slots available.
+    */
+    uInt32 slots() const { return mySlots; }
+
+    /**
+      Use the given slot, with the given key.
+    */
+    void set(uInt32 slot, double key);
+
+    /**
+      Make the given slot empty.
+    */
+    void erase(uInt32 slot);
+
+    /**
+      Add the given value to the keys of all slots from the given one on.
+    */
+    void add(uInt32 from, double delta);
+
+    /**
+      The number of slots in use before the given slot.
+    */
+    uInt32 rank(uInt32 slot) const;
+
+    /**
+      The slot in use with the given rank; there must be enough slots in use.
+    */
+    uInt32 select(uInt32 rank) const;
+
+    /**
+      Find the slot in use with the largest key in the given range
+      (inclusive); of equal keys, the last one is chosen.
+
+      @return  False if no slot is in use in the range
+    */
+    bool findMax(uInt32 from, uInt32 to, uInt32& slot, double& key);
+
+  private:
+    // Apply a pending addition to the children of a node
+    void push(uInt32 node);
+
+    // Recalculate a node from its children
+    void pull(uInt32 node);
+
+    void set(uInt32 node, uInt32 lo, uInt32 hi, uInt32 slot, double key, bool used);
+    void add(uInt32 node, uInt32 lo, uInt32 hi, uInt32 from, double delta);
+    void findMax(uInt32 node, uInt32 lo, uInt32 hi, uInt32 from, uInt32 to,
+                 uInt32& slot, double& key);
+
+  private:
+    // The tree is stored as a heap; the children of node i are 2i and 2i+1,
+    // and the leaves (the slots) start at mySlots
+    uInt32 mySlots;
+
+    // For each node: the largest key below, the slot it is in, the value
+    // still to be added to the children, and the number of slots in use
+    vector<double> myMax;
+    vector<uInt32> myMaxSlot;
+    vector<double> myPending;
+    vector<uInt32> myCount;
+
+  private:
+    // Following constructors and assignment operators not supported
+    RankedMaxTree(const RankedMaxTree&) = delete;
+    RankedMaxTree(RankedMaxTree&&) = delete;
+    RankedMaxTree& operator=(const RankedMaxTree&) = delete;
+    RankedMaxTree& operator=(RankedMaxTree&&) = delete;
+};
+
+} // namespace Common
+
+#endif
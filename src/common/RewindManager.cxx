@@ -16,21 +16,139 @@
 //============================================================================
 
 #include <cmath>
+#include <limits>
 
 #include "OSystem.hxx"
+#include "Console.hxx"
+#include "M6532.hxx"
 #include "Serializer.hxx"
 #include "StateManager.hxx"
 #include "TIA.hxx"
+#include "DispatchResult.hxx"
 #include "EventHandler.hxx"
+#include "InputMovie.hxx"
+#include "MappedFile.hxx"
+#include "PerfCounters.hxx"
 
 #include "RewindManager.hxx"
 
+// The key of states not to be removed by compression
+static constexpr double NO_COMPRESSION = -std::numeric_limits<double>::infinity();
+
+// Identifies the file written by saveAllStates()
+static constexpr char ALL_STATES_HEADER[] = STATE_HEADER "all";
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 RewindManager::RewindManager(OSystem& system, StateManager& statemgr)
   : myOSystem(system),
-    myStateManager(statemgr)
+    myStateManager(statemgr),
+    myNextSlot(0),
+    myScheduleValid(false),
+    myStatePending(false),
+    myQuit(false),
+    myPendingCycles(0),
+    myPendingReplay(false),
+    myPendingFrames(0),
+    myPendingChecksum(0),
+    myRecordingState(nullptr)
 {
   setup();
+
+  myWorker = std::thread(&RewindManager::threadMain, this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RewindManager::~RewindManager()
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myQuit = true;
+  }
+  myCondition.notify_all();
+  myWorker.join();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::threadMain()
+{
+  for(;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(myMutex);
+
+      myCondition.wait(lock, [this]{ return myStatePending || myQuit; });
+      if(myQuit)
+        return;
+    }
+
+    // Until the state is marked as inserted, the emulation thread leaves
+    // the list and the pending state alone, so no lock is needed here
+    insertPendingState();
+
+    {
+      std::lock_guard<std::mutex> lock(myMutex);
+      myStatePending = false;
+    }
+    myCondition.notify_all();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::insertPendingState()
+{
+  // Remove all future states
+  const uInt32 size = myStateList.size();
+  myStateList.removeToLast();
+  if(myStateList.size() != size)
+    myScheduleValid = false;
+
+  // Make sure we never run out of space
+  if(myStateList.full())
+    compressStates();
+
+  // A replayed state needs the stored state its inputs were recorded
+  // after; without it (never expected), the state is dropped
+  if(myPendingReplay &&
+     !(myRecordingState && myRecordingState->inputs == myPendingInputs))
+  {
+    myPendingInputs.reset();
+    return;
+  }
+
+  // Add new state at the end of the list (queue adds at end)
+  // This updates the 'current' iterator inside the list
+  myStateList.addLast();
+  RewindState& state = myStateList.current();
+
+  if(myPendingReplay)
+  {
+    // Nothing is stored, the state is replayed from the stored state
+    vector<uInt8>().swap(state.data);
+    state.size = 0;
+    state.keyframe = nullptr;
+    state.inputs.reset();
+    state.origin = myRecordingState;
+    state.frames = myPendingFrames;
+    state.checksum = myPendingChecksum;
+    myPendingInputs.reset();
+  }
+  else
+  {
+    storeState(myStateList.last(), myStateData.data(), uInt32(myStateData.size()));
+    state.inputs = std::move(myPendingInputs);
+    myRecordingState = state.inputs ? &state : nullptr;
+  }
+  state.message = myPendingMessage;
+  state.cycles = myPendingCycles;
+  scheduleLast();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::waitForPendingState() const
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  myCondition.wait(lock, [this]{ return !myStatePending; });
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -38,6 +156,7 @@ void RewindManager::setup()
 {
   myStateSize = 0;
   myLastTimeMachineAdd = false;
+  myScheduleValid = false;
 
   const string& prefix = myOSystem.settings().getBool("dev.settings") ? "dev." : "plr.";
 
@@ -47,6 +166,10 @@ void RewindManager::setup()
 
   myUncompressed = myOSystem.settings().getInt(prefix + "tm.uncompressed");
 
+  myReplay = myOSystem.settings().getBool(prefix + "tm.replay");
+  if(!myReplay)
+    stopRecording();
+
   myInterval = INTERVAL_CYCLES[0];
   for(int i = 0; i < NUM_INTERVALS; ++i)
     if(INT_SETTINGS[i] == myOSystem.settings().getString(prefix + "tm.interval"))
@@ -95,10 +218,21 @@ void RewindManager::setup()
 bool RewindManager::addState(const string& message, bool timeMachine)
 {
   // only check for Time Machine states, ignore for debugger
-  if(timeMachine && myStateList.currentIsValid())
+  if(timeMachine)
   {
     // check if the current state has the right interval from the last state
-    RewindState& lastState = myStateList.current();
+    // (the pending one is going to be the current state, no need to wait)
+    uInt64 lastCycles;
+    {
+      std::lock_guard<std::mutex> lock(myMutex);
+
+      if(myStatePending)
+        lastCycles = myPendingCycles;
+      else if(myStateList.currentIsValid())
+        lastCycles = myStateList.current().cycles;
+      else
+        lastCycles = ~uInt64(0);
+    }
     uInt32 interval = myInterval;
 
     // adjust frame timed intervals to actual scanlines (vs 262)
@@ -109,30 +243,73 @@ bool RewindManager::addState(const string& message, bool timeMachine)
       interval = interval * scanlines / 262;
     }
 
-    if(myOSystem.console().tia().cycles() - lastState.cycles < interval)
+    if(lastCycles != ~uInt64(0) &&
+       myOSystem.console().tia().cycles() - lastCycles < interval)
       return false;
   }
 
-  // Remove all future states
-  myStateList.removeToLast();
+  waitForPendingState();
 
-  // Make sure we never run out of space
-  if(myStateList.full())
-    compressStates();
+  Console& console = myOSystem.console();
 
-  // Add new state at the end of the list (queue adds at end)
-  // This updates the 'current' iterator inside the list
-  myStateList.addLast();
-  RewindState& state = myStateList.current();
-  Serializer& s = state.data;
+  // In replay mode, a time machine state shortly after the last stored
+  // state is only reached again by replaying the inputs recorded since
+  if(timeMachine && myReplay && myRecording &&
+     console.inputMovie() == myRecording && myRecording->frames() < REPLAY_FRAMES)
+  {
+    myLastTimeMachineAdd = true;
+    {
+      std::lock_guard<std::mutex> lock(myMutex);
+
+      myPendingReplay = true;
+      myPendingFrames = myRecording->frames();
+      myPendingChecksum = ramChecksum();
+      myPendingInputs = myRecording;
+      myPendingMessage = message;
+      myPendingCycles = console.tia().cycles();
+      myStatePending = true;
+    }
+    myCondition.notify_all();
+    return true;
+  }
+
+  Serializer& s = myStateData;
 
   s.rewind();  // rewind Serializer internal buffers
-  if(myStateManager.saveState(s) && myOSystem.console().tia().saveDisplay(s))
+  if(myStateManager.saveState(s) && console.tia().saveDisplay(s))
   {
     myStateSize = std::max(myStateSize, uInt32(s.size()));
-    state.message = message;
-    state.cycles = myOSystem.console().tia().cycles();
     myLastTimeMachineAdd = timeMachine;
+
+    // Record the inputs from here on, for replaying the following states
+    // (unless a movie is using the console's inputs already)
+    shared_ptr<InputMovie> inputs;
+    if(myReplay && (!console.inputMovie() || console.inputMovie() == myRecording))
+    {
+      inputs = make_shared<InputMovie>();
+      inputs->startRecording(Properties(), nullptr, 0);
+    }
+
+    // Hand the state over to the worker thread for insertion; it reads
+    // the serialized state in place, since it is only written again
+    // after the insertion finished
+    {
+      std::lock_guard<std::mutex> lock(myMutex);
+
+      myPendingReplay = false;
+      myPendingInputs = inputs;
+      myPendingMessage = message;
+      myPendingCycles = console.tia().cycles();
+      myStatePending = true;
+    }
+    myCondition.notify_all();
+
+    stopRecording();
+    if(inputs)
+    {
+      console.setInputMovie(inputs, false);
+      myRecording = inputs;
+    }
     return true;
   }
   return false;
@@ -141,6 +318,8 @@ bool RewindManager::addState(const string& message, bool timeMachine)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 RewindManager::rewindStates(uInt32 numStates)
 {
+  waitForPendingState();
+
   uInt64 startCycles = myOSystem.console().tia().cycles();
   uInt32 i;
   string message;
@@ -157,10 +336,6 @@ uInt32 RewindManager::rewindStates(uInt32 numStates)
         // ...except when the last state was added automatically,
         // because that already happened one interval before
         myLastTimeMachineAdd = false;
-
-      RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-      s.rewind();  // rewind Serializer internal buffers
     }
     else
       break;
@@ -180,6 +355,8 @@ uInt32 RewindManager::rewindStates(uInt32 numStates)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 RewindManager::unwindStates(uInt32 numStates)
 {
+  waitForPendingState();
+
   uInt64 startCycles = myOSystem.console().tia().cycles();
   uInt32 i;
   string message;
@@ -191,10 +368,6 @@ uInt32 RewindManager::unwindStates(uInt32 numStates)
       // Set internal current iterator to nextCycles state (forward in time),
       // since we will now process this state
       myStateList.moveToNext();
-
-      RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-      s.rewind();  // rewind Serializer internal buffers
     }
     else
       break;
@@ -233,38 +406,48 @@ string RewindManager::saveAllStates()
       << myOSystem.console().properties().get(PropType::Cart_Name)
       << ".sta";
 
-    Serializer out(buf.str(), Serializer::Mode::ReadWriteTrunc);
-    if (!out)
-      return "Can't save to all states file";
-
-    uInt32 curIdx = getCurrentIdx();
-    rewindStates(1000);
-    uInt32 numStates = uInt32(cyclesList().size());
+    // States replayed from a stored state (replay mode) can't be saved
+    uInt32 numStates = 0;
+    for(auto it = myStateList.cbegin(); it != myStateList.cend(); ++it)
+      if(!it->origin)
+        ++numStates;
+
+    // The file consists of a header, all states padded to the common size,
+    // and a table of their messages and cycles.  Its size is determined
+    // first, so everything can be written directly into the mapped file.
+    auto putHeader = [&](Serializer& out) {
+      out.putString(ALL_STATES_HEADER);
+      out.putInt(numStates);
+      out.putInt(myStateSize);
+    };
+    auto putTable = [&](Serializer& out) {
+      for(auto it = myStateList.cbegin(); it != myStateList.cend(); ++it)
+      {
+        if(it->origin)
+          continue;
+        out.putString(it->message);
+        out.putLong(it->cycles);
+      }
+    };
+    Serializer count(static_cast<void*>(nullptr), ~size_t(0));
+    putHeader(count);
+    putTable(count);
 
-    // Save header
-    buf.str("");
-    out.putString(STATE_HEADER);
-    out.putShort(numStates);
-    out.putInt(myStateSize);
+    MappedFile file;
+    if (!file.openWrite(buf.str(), count.size() + size_t(numStates) * myStateSize))
+      return "Can't save to all states file";
 
-    unique_ptr<uInt8[]> buffer = make_unique<uInt8[]>(myStateSize);
-    for (uInt32 i = 0; i < numStates; i++)
+    Serializer out(static_cast<void*>(file.data()), file.size());
+    putHeader(out);
+    for(auto it = myStateList.cbegin(); it != myStateList.cend(); ++it)
     {
-      RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-      // Rewind Serializer internal buffers
-      s.rewind();
-      // Save state
-      s.getByteArray(buffer.get(), myStateSize);
-      out.putByteArray(buffer.get(), myStateSize);
-      out.putString(state.message);
-      out.putLong(state.cycles);
-
-      if (i < numStates)
-        unwindStates(1);
+      if(it->origin)
+        continue;
+      decodeState(*it);
+      myStateBuffer.resize(myStateSize);
+      out.putByteArray(myStateBuffer.data(), myStateSize);
     }
-    // restore old state position
-    rewindStates(numStates - curIdx);
+    putTable(out);
 
     buf.str("");
     buf << "Saved " << numStates << " states";
@@ -287,22 +470,28 @@ string RewindManager::loadAllStates()
       << ".sta";
 
     // Make sure the file can be opened for reading
-    Serializer in(buf.str(), Serializer::Mode::ReadOnly);
-    if (!in)
+    MappedFile file;
+    if (!file.openRead(buf.str()))
       return "Can't load from all states file";
 
-    clear();
-    uInt32 numStates;
+    // The states are taken directly from the mapped file
+    Serializer in(static_cast<const void*>(file.data()), file.size());
 
-    // Load header
-    buf.str("");
     // Check compatibility
-    if (in.getString() != STATE_HEADER)
+    if (in.getString() != ALL_STATES_HEADER)
       return "Incompatible all states file";
-    numStates = in.getShort();
+
+    clear();
+    uInt32 numStates = in.getInt();
     myStateSize = in.getInt();
 
-    unique_ptr<uInt8[]> buffer = make_unique<uInt8[]>(myStateSize);
+    const size_t dataPos = in.readPosition();
+    const size_t tablePos = dataPos + size_t(numStates) * myStateSize;
+    if (tablePos > file.size())
+      return "Error loading all states";
+    Serializer table(static_cast<const void*>(file.data() + tablePos),
+                     file.size() - tablePos);
+
     for (uInt32 i = 0; i < numStates; i++)
     {
       if (myStateList.full())
@@ -312,15 +501,13 @@ string RewindManager::loadAllStates()
       // This updates the 'current' iterator inside the list
       myStateList.addLast();
       RewindState& state = myStateList.current();
-      Serializer& s = state.data;
-      // Rewind Serializer internal buffers
-      s.rewind();
 
       // Fill new state with saved values
-      in.getByteArray(buffer.get(), myStateSize);
-      s.putByteArray(buffer.get(), myStateSize);
-      state.message = in.getString();
-      state.cycles = in.getLong();
+      storeState(myStateList.last(), file.data() + dataPos + size_t(i) * myStateSize,
+                 myStateSize);
+      state.message = table.getString();
+      state.cycles = table.getLong();
+      scheduleLast();
     }
 
     // initialize current state (parameters ignored)
@@ -339,46 +526,285 @@ string RewindManager::loadAllStates()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void RewindManager::compressStates()
 {
-  double expectedCycles = myInterval * myFactor * (1 + myFactor);
-  double maxError = 1.5;
-  uInt32 idx = myStateList.size() - 2;
-  // in case maxError is <= 1.5 remove first state by default:
-  Common::LinkedObjectPool<RewindState>::const_iter removeIter = myStateList.first();
-  /*if(myUncompressed < mySize)
-    //  if compression is enabled, the first but one state is removed by default:
-    removeIter++;*/
-
-  // iterate from last but one to first but one
-  for(auto it = myStateList.previous(myStateList.last()); it != myStateList.first(); --it)
+  PERF_TIME(rewindCompress);
+
+  if(!myScheduleValid)
+    rebuildSchedule();
+
+  // In the compressed part of the list, the expected interval between the
+  // neighbours of the state at position i is
+  //   myInterval * myFactor * (1 + myFactor) * myFactor^(last + 1 - i)
+  // with 'last' the position of the last compressed state.  The state with
+  // the largest error (the expected interval divided by the actual one) is
+  // removed, if the error exceeds 1.5; otherwise the first state is.  The
+  // schedule holds the logarithm of the error, minus the common terms.
+  StateList::const_iter removeIter = myStateList.first();
+  const uInt32 size = myStateList.size();
+  const uInt32 compressed = mySize - myUncompressed;
+
+  if(size > 2 && compressed > 0)
+  {
+    const uInt32 last = std::min(size - 2, compressed - 1);
+    uInt32 slot;
+    double key;
+
+    if(mySchedule.findMax(myStateList.next(myStateList.first())->slot,
+                          mySchedule.select(last), slot, key))
+    {
+      const double error = std::log(myInterval * myFactor * (1 + myFactor)) +
+                           (last + 1) * std::log(myFactor) + key;
+      if(error > std::log(1.5))
+        removeIter = mySlotStates[slot];
+    }
+  }
+
+  // A stored state is only removed once no states are replayed from it
+  // anymore; until then, the state following it goes instead
+  const StateList::const_iter next = myStateList.next(removeIter);
+  if(next != myStateList.cend() && next->origin == &*removeIter)
+    removeIter = next;
+
+  removeState(removeIter);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::scheduleLast()
+{
+  if(!myScheduleValid)
+    return;
+
+  // Once all slots were used, the schedule is rebuilt when needed next
+  if(myNextSlot == mySchedule.slots())
+  {
+    myScheduleValid = false;
+    return;
+  }
+
+  const StateList::const_iter last = myStateList.last();
+  RewindState& state = myStateList.get(last);
+  state.slot = myNextSlot++;
+  mySlotStates[state.slot] = last;
+  mySchedule.set(state.slot, NO_COMPRESSION);
+
+  if(myStateList.size() > 2)
+    reschedule(myStateList.previous(last));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::rebuildSchedule()
+{
+  // Twice the slots needed, so this only happens every mySize states
+  mySchedule.reset(2 * std::max(myStateList.capacity(), 1u));
+  mySlotStates.resize(mySchedule.slots());
+  myNextSlot = 0;
+
+  for(auto it = myStateList.first(); it != myStateList.cend(); ++it)
+  {
+    RewindState& state = myStateList.get(it);
+    state.slot = myNextSlot++;
+    mySlotStates[state.slot] = it;
+    mySchedule.set(state.slot, NO_COMPRESSION);
+  }
+  for(auto it = myStateList.first(); it != myStateList.cend(); ++it)
+    reschedule(it);
+
+  myScheduleValid = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::reschedule(StateList::const_iter it)
+{
+  double key = NO_COMPRESSION;
+
+  if(it != myStateList.first() && it != myStateList.last())
+  {
+    const uInt64 interval = myStateList.next(it)->cycles - myStateList.previous(it)->cycles;
+    key = -(mySchedule.rank(it->slot) * std::log(myFactor)) - std::log(double(interval));
+  }
+  mySchedule.set(it->slot, key);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::removeState(StateList::const_iter it)
+{
+  if(!it->keyframe)
   {
-    if(idx < mySize - myUncompressed)
+    // Re-encode all the states depending on this keyframe; the first one
+    // becomes the new keyframe
+    const RewindState* newKeyframe = nullptr;
+    for(auto dep = myStateList.next(it); dep != myStateList.cend(); ++dep)
     {
-      expectedCycles *= myFactor;
+      if(dep->origin)
+        continue;  // nothing stored
+      if(dep->keyframe != &*it)
+        break;
 
-      uInt64 prevCycles = myStateList.previous(it)->cycles;
-      uInt64 nextCycles = myStateList.next(it)->cycles;
-      double error = expectedCycles / (nextCycles - prevCycles);
+      RewindState& state = myStateList.get(dep);
 
-      if(error > maxError)
+      decodeState(state);
+      if(newKeyframe)
       {
-        maxError = error;
-        removeIter = it;
+        state.keyframe = newKeyframe;
+        encodeDelta(*newKeyframe, myStateBuffer.data(), state.size, state.data);
+      }
+      else
+      {
+        state.keyframe = nullptr;
+        state.data = myStateBuffer;
+        newKeyframe = &state;
       }
     }
-    --idx;
   }
-   myStateList.remove(removeIter); // remove
+
+  if(&*it == myRecordingState)
+    myRecordingState = nullptr;
+
+  // The states following this one move up by one position
+  const StateList::const_iter prev =
+      it != myStateList.first() ? myStateList.previous(it) : myStateList.cend();
+  const StateList::const_iter next = myStateList.next(it);
+  if(myScheduleValid)
+  {
+    mySchedule.erase(it->slot);
+    mySchedule.add(it->slot + 1, std::log(myFactor));
+  }
+
+  myStateList.remove(it);
+
+  if(myScheduleValid)
+  {
+    if(prev != myStateList.cend())
+      reschedule(prev);
+    if(next != myStateList.cend())
+      reschedule(next);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::storeState(StateList::const_iter it, const uInt8* data, uInt32 size)
+{
+  RewindState& state = myStateList.get(it);
+
+  state.origin = nullptr;
+  state.inputs.reset();
+
+  // Find the most recent keyframe, if it is close enough (not counting
+  // the states replayed in between, which store nothing)
+  state.keyframe = nullptr;
+  for(uInt32 distance = 1; it != myStateList.first() && distance < KEYFRAME_INTERVAL; )
+  {
+    --it;
+    if(it->origin)
+      continue;
+    if(!it->keyframe)
+    {
+      state.keyframe = &*it;
+      break;
+    }
+    ++distance;
+  }
+
+  state.size = size;
+  if(state.keyframe)
+  {
+    encodeDelta(*state.keyframe, data, size, state.data);
+    // Don't keep the memory of a previous (complete) state around
+    if(state.data.capacity() > 2 * state.data.size())
+      state.data.shrink_to_fit();
+  }
+  else
+    state.data.assign(data, data + size);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::decodeState(const RewindState& state)
+{
+  if(state.keyframe)
+  {
+    myStateBuffer.resize(state.size);
+    decodeDelta(*state.keyframe, state.data, state.size, myStateBuffer.data());
+  }
+  else
+    myStateBuffer = state.data;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::encodeDelta(const RewindState& keyframe, const uInt8* data,
+                                uInt32 size, vector<uInt8>& delta)
+{
+  // The delta consists of (skip, count) pairs of 16-bit values, each
+  // followed by 'count' bytes replacing the keyframe data after skipping
+  // 'skip' unchanged bytes; the keyframe is assumed to be zero-padded
+  const uInt8* key = keyframe.data.data();
+  const uInt32 keySize = keyframe.size;
+  auto changed = [&](uInt32 i) { return (i < keySize ? key[i] : 0) != data[i]; };
+  auto putShort = [&](uInt32 value) {
+    delta.push_back(uInt8(value));
+    delta.push_back(uInt8(value >> 8));
+  };
+
+  delta.clear();
+  for(uInt32 i = 0; i < size; )
+  {
+    uInt32 start = i;
+    while(i < size && i - start < 0xFFFF && !changed(i))
+      ++i;
+    if(i == size)
+      break;  // no changes until the end anymore
+
+    uInt32 skip = i - start;
+    start = i;
+    while(i < size && i - start < 0xFFFF && changed(i))
+      ++i;
+
+    putShort(skip);
+    putShort(i - start);
+    delta.insert(delta.end(), data + start, data + i);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::decodeDelta(const RewindState& keyframe, const vector<uInt8>& delta,
+                                uInt32 size, uInt8* data)
+{
+  const uInt32 keySize = std::min(keyframe.size, size);
+
+  std::copy_n(keyframe.data.data(), keySize, data);
+  std::fill(data + keySize, data + size, 0);
+
+  uInt32 pos = 0;
+  for(auto it = delta.cbegin(); it != delta.cend(); )
+  {
+    uInt32 skip  = it[0] | (it[1] << 8);
+    uInt32 count = it[2] | (it[3] << 8);
+    it += 4;
+    pos += skip;
+    std::copy_n(it, count, data + pos);
+    it += count;
+    pos += count;
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string RewindManager::loadState(Int64 startCycles, uInt32 numStates)
 {
   RewindState& state = myStateList.current();
-  Serializer& s = state.data;
+  const RewindState& stored = state.origin ? *state.origin : state;
+  Serializer& s = myStateData;
+
+  // The inputs recorded so far don't continue from the loaded state
+  stopRecording();
+
+  // Reconstruct the complete state (if necessary)
+  decodeState(stored);
+  s.rewind();
+  s.putByteArray(myStateBuffer.data(), uInt32(myStateBuffer.size()));
 
   myStateManager.loadState(s);
   myOSystem.console().tia().loadDisplay(s);
 
+  const bool replayed = !state.origin || replayState(state);
+
   Int64 diff = startCycles - state.cycles;
   stringstream message;
 
@@ -386,12 +812,77 @@ string RewindManager::loadState(Int64 startCycles, uInt32 numStates)
   message << " [" << myStateList.currentIdx() << "/" << myStateList.size() << "]";
 
   // add optional message
-  if(numStates == 1 && !state.message.empty())
+  if(!replayed)
+    message << " (replay diverged)";
+  else if(numStates == 1 && !state.message.empty())
     message << " (" << state.message << ")";
 
   return message.str();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RewindManager::replayState(const RewindState& state)
+{
+  PERF_TIME(rewindReplay);
+
+  Console& console = myOSystem.console();
+  TIA& tia = console.tia();
+  Event& event = myOSystem.eventHandler().event();
+  const shared_ptr<InputMovie>& inputs = state.origin->inputs;
+
+  // The inputs are played back through the event object, so the host
+  // inputs are restored afterwards
+  Int32 hostInputs[Event::LastType];
+  for(Int32 i = 0; i < Event::LastType; ++i)
+    hostInputs[i] = event.get(Event::Type(i));
+
+  inputs->startPlayback();
+  console.setInputMovie(inputs, true);
+  tia.setAudioMuted(true);
+
+  DispatchResult dispatchResult;
+  while(tia.cycles() < state.cycles)
+  {
+    tia.update(dispatchResult, state.cycles - tia.cycles());
+    if(dispatchResult.getStatus() != DispatchResult::Status::ok)
+      break;
+  }
+
+  tia.setAudioMuted(false);
+  console.setInputMovie(nullptr, false);
+  for(Int32 i = 0; i < Event::LastType; ++i)
+    if(InputMovie::isRecorded(Event::Type(i)))
+      event.set(Event::Type(i), hostInputs[i]);
+
+  // Show the last frame emulated
+  tia.renderToFrameBuffer();
+
+  return tia.cycles() == state.cycles && inputs->framesPlayed() == state.frames &&
+         ramChecksum() == state.checksum;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RewindManager::stopRecording()
+{
+  if(myRecording && myOSystem.hasConsole() &&
+     myOSystem.console().inputMovie() == myRecording)
+    myOSystem.console().setInputMovie(nullptr, false);
+
+  myRecording.reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 RewindManager::ramChecksum() const
+{
+  // FNV-1a
+  const uInt8* ram = myOSystem.console().riot().getRAM();
+  uInt32 hash = 2166136261u;
+  for(uInt32 i = 0; i < 128; ++i)
+    hash = (hash ^ ram[i]) * 16777619u;
+
+  return hash;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string RewindManager::getUnitString(Int64 cycles)
 {
@@ -427,12 +918,14 @@ string RewindManager::getUnitString(Int64 cycles)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 RewindManager::getFirstCycles() const
 {
+  waitForPendingState();
   return !myStateList.empty() ? myStateList.first()->cycles : 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 RewindManager::getCurrentCycles() const
 {
+  waitForPendingState();
   if(myStateList.currentIsValid())
     return myStateList.current().cycles;
   else
@@ -442,12 +935,15 @@ uInt64 RewindManager::getCurrentCycles() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 RewindManager::getLastCycles() const
 {
+  waitForPendingState();
   return !myStateList.empty() ? myStateList.last()->cycles : 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 IntArray RewindManager::cyclesList() const
 {
+  waitForPendingState();
+
   IntArray arr;
 
   uInt64 firstCycle = getFirstCycles();
@@ -456,3 +952,40 @@ IntArray RewindManager::cyclesList() const
 
   return arr;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uInt8* RewindManager::previewFrame(uInt32 index)
+{
+  waitForPendingState();
+
+  auto it = myStateList.cbegin();
+  for(uInt32 i = 0; i < index && it != myStateList.cend(); ++i)
+    ++it;
+  if(it == myStateList.cend())
+    return nullptr;
+
+  // A replayed state shows the frame of the state it is replayed from
+  const RewindState& state = it->origin ? *it->origin : *it;
+  auto cached = std::find_if(myFrameCache.begin(), myFrameCache.end(),
+      [&](const PreviewFrame& f) { return f.state == &state && f.cycles == state.cycles; });
+  if(cached == myFrameCache.end())
+  {
+    constexpr uInt32 FRAME_SIZE = TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight;
+    if(state.size < TIA::DISPLAY_SIZE)
+      return nullptr;
+
+    if(myFrameCache.size() >= FRAME_CACHE_SIZE)
+      myFrameCache.pop_back();
+    myFrameCache.push_front({&state, state.cycles, vector<uInt8>()});
+    cached = myFrameCache.begin();
+
+    // The display is saved at the end of each state
+    decodeState(state);
+    const uInt8* frame = myStateBuffer.data() + state.size - TIA::DISPLAY_SIZE;
+    cached->pixels.assign(frame, frame + FRAME_SIZE);
+  }
+  else
+    myFrameCache.splice(myFrameCache.begin(), myFrameCache, cached);
+
+  return cached->pixels.data();
+}
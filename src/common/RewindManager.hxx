@@ -20,8 +20,16 @@
 
 class OSystem;
 class StateManager;
+class InputMovie;
+
+#include <list>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 #include "LinkedObjectPool.hxx"
+#include "RankedMaxTree.hxx"
+#include "Serializer.hxx"
 #include "bspf.hxx"
 
 /**
@@ -34,6 +42,10 @@ class StateManager;
   Unwinding involves moving the internal iterator forwards in time (towards
   the end of the list).
 
+  Adding a state only serializes the emulation into a buffer; encoding the
+  state and inserting it into the list happens on a background thread.
+  All methods accessing the list wait for a pending insertion first.
+
   Any time a new state is added, all states from the current iterator position
   to the end of the list (aka, all future states) are removed, and the internal
   iterator moves to the insertion point of the data (the end of the list).
@@ -41,12 +53,26 @@ class StateManager;
   If the list is full, states are either removed at the beginning (compression
   off) or at selective positions (compression on).
 
+  To save memory, only every KEYFRAME_INTERVAL-th state is stored completely
+  (a keyframe).  All other states only store the bytes which differ from
+  their keyframe, and are reconstructed when they are loaded.
+
+  In replay mode (the 'tm.replay' setting), the time machine states which
+  follow a stored state within REPLAY_FRAMES frames aren't stored at all.
+  Instead, the inputs of every frame are recorded after each stored state
+  (see InputMovie), and such a state is reached again by loading the stored
+  state and re-emulating up to its cycle with the recorded inputs, muted
+  and without showing the frames in between.  So with short intervals,
+  only every few states cost memory.  A stored state is only removed once
+  no states are replayed from it anymore.
+
   @author  Stephen Anthony
 */
 class RewindManager
 {
   public:
     RewindManager(OSystem& system, StateManager& statemgr);
+    ~RewindManager();
 
   public:
     static constexpr int NUM_INTERVALS = 7;
@@ -71,6 +97,12 @@ class RewindManager
       "10s"
     };
 
+    // maximum distance between two keyframes (1 = no delta states)
+    static constexpr uInt32 KEYFRAME_INTERVAL = 16;
+
+    // maximum number of frames re-emulated to reach a state (replay mode)
+    static constexpr uInt32 REPLAY_FRAMES = 30;
+
     static constexpr int NUM_HORIZONS = 8;
     // cycle values for the horzions
     const uInt64 HORIZON_CYCLES[NUM_HORIZONS] = {
@@ -139,12 +171,20 @@ class RewindManager
     string saveAllStates();
     string loadAllStates();
 
-    bool atFirst() const { return myStateList.atFirst(); }
-    bool atLast() const  { return myStateList.atLast();  }
-    void resize(uInt32 size) { myStateList.resize(size); }
+    bool atFirst() const { waitForPendingState(); return myStateList.atFirst(); }
+    bool atLast() const  { waitForPendingState(); return myStateList.atLast();  }
+    void resize(uInt32 size) {
+      waitForPendingState();
+      myStateList.resize(size);
+      myScheduleValid = false;
+    }
     void clear() {
+      waitForPendingState();
+      stopRecording();
       myStateSize = 0;
       myStateList.clear();
+      myFrameCache.clear();
+      myScheduleValid = false;
     }
 
     /**
@@ -152,8 +192,8 @@ class RewindManager
     */
     string getUnitString(Int64 cycles);
 
-    uInt32 getCurrentIdx() { return myStateList.currentIdx(); }
-    uInt32 getLastIdx() { return myStateList.size(); }
+    uInt32 getCurrentIdx() { waitForPendingState(); return myStateList.currentIdx(); }
+    uInt32 getLastIdx() { waitForPendingState(); return myStateList.size(); }
 
     uInt64 getFirstCycles() const;
     uInt64 getCurrentCycles() const;
@@ -165,6 +205,16 @@ class RewindManager
     */
     IntArray cyclesList() const;
 
+    /**
+      Get the frame which was shown when the state at the given position
+      (0 = first state) was saved, without loading the state.  Recently
+      used frames are cached, so scrubbing over the timeline is fast.
+
+      @return  The frame (TIAConstants::H_PIXEL x frameBufferHeight pixels),
+               or the null pointer if there is no such state
+    */
+    const uInt8* previewFrame(uInt32 index);
+
   private:
     OSystem& myOSystem;
     StateManager& myStateManager;
@@ -176,16 +226,31 @@ class RewindManager
     double myFactor;
     bool   myLastTimeMachineAdd;
     uInt32 myStateSize;
+    bool   myReplay;
 
     struct RewindState {
-      Serializer data;  // actual save state
-      string message;   // describes save state origin
-      uInt64 cycles;    // cycles since emulation started
+      vector<uInt8> data;         // actual save state, or delta to the keyframe
+      uInt32 size;                // size of the complete save state
+      const RewindState* keyframe;  // keyframe of a delta state, else nullptr
+      string message;             // describes save state origin
+      uInt64 cycles;              // cycles since emulation started
+      uInt32 slot;                // slot in mySchedule
+
+      // Replay mode: the inputs recorded after a stored state; for a state
+      // which isn't stored, the stored state it is replayed from, and the
+      // number of frames and a checksum of the RAM to verify the replay
+      shared_ptr<InputMovie> inputs;
+      const RewindState* origin;
+      uInt32 frames;
+      uInt32 checksum;
 
       // We do nothing on object instantiation or copy
       // The goal of LinkedObjectPool is to not do any allocations at all
-      RewindState() : cycles(0) { }
-      RewindState(const RewindState& rs) : cycles(rs.cycles) { }
+      RewindState() : size(0), keyframe(nullptr), cycles(0), slot(0),
+                      origin(nullptr), frames(0), checksum(0) { }
+      RewindState(const RewindState& rs)
+        : size(0), keyframe(nullptr), cycles(rs.cycles), slot(0),
+          origin(nullptr), frames(0), checksum(0) { }
       RewindState& operator= (const RewindState& rs) { cycles = rs.cycles; return *this; }
 
       // Output object info; used for debugging only
@@ -194,15 +259,118 @@ class RewindManager
       }
     };
 
+    using StateList = Common::LinkedObjectPool<RewindState>;
+
     // The linked-list to store states (internally it takes care of reducing
     // frequent (de)-allocations)
-    Common::LinkedObjectPool<RewindState> myStateList;
+    StateList myStateList;
+
+    // The compression schedule: every state has a slot, assigned in the
+    // order the states are added, which holds the logarithm of its
+    // compression error, apart from terms common to all states (see
+    // compressStates()).  The state with the largest error is removed
+    // when the list is full.
+    Common::RankedMaxTree mySchedule;
+    vector<StateList::const_iter> mySlotStates;
+    uInt32 myNextSlot;
+    bool myScheduleValid;
+
+    // Buffers for (de)serializing and reconstructing complete states
+    Serializer myStateData;
+    vector<uInt8> myStateBuffer;
+
+    // Frames of recently previewed states, most recently used first; the
+    // cycles tell apart states reusing the same (pooled) object
+    struct PreviewFrame {
+      const RewindState* state;
+      uInt64 cycles;
+      vector<uInt8> pixels;
+    };
+    std::list<PreviewFrame> myFrameCache;
+    static constexpr uInt32 FRAME_CACHE_SIZE = 32;
+
+    // The thread encoding and inserting new states, and the pending state;
+    // myMutex only guards handing it over (and myStatePending), while the
+    // state list, myStateData and the pending values belong to the worker
+    // thread as long as a state is pending
+    std::thread myWorker;
+    mutable std::mutex myMutex;
+    mutable std::condition_variable myCondition;
+    bool myStatePending;
+    bool myQuit;
+    string myPendingMessage;
+    uInt64 myPendingCycles;
+    bool myPendingReplay;
+    uInt32 myPendingFrames;
+    uInt32 myPendingChecksum;
+    shared_ptr<InputMovie> myPendingInputs;
+
+    // Replay mode: the inputs being recorded, and the stored state they
+    // follow (set by the worker thread once the state is inserted)
+    shared_ptr<InputMovie> myRecording;
+    const RewindState* myRecordingState;
 
     /**
       Remove a save state from the list
     */
     void compressStates();
 
+    /**
+      Add the state just added at the end of the list to the compression
+      schedule, or rebuild the schedule from the list.
+    */
+    void scheduleLast();
+    void rebuildSchedule();
+
+    /**
+      Update the key of the given state in the compression schedule, after
+      one of its neighbours changed.
+    */
+    void reschedule(StateList::const_iter it);
+
+    /**
+      The main loop of the worker thread, inserting pending states.
+    */
+    void threadMain();
+
+    /**
+      Insert the pending state at the end of the list; called by the worker
+      thread without holding myMutex.
+    */
+    void insertPendingState();
+
+    /**
+      Wait until the worker thread has inserted the pending state (if any).
+    */
+    void waitForPendingState() const;
+
+    /**
+      Remove the given state from the list; if it is a keyframe, the states
+      depending on it are re-encoded first.
+    */
+    void removeState(StateList::const_iter it);
+
+    /**
+      Store a complete save state into the given (last) state, either as a
+      keyframe or as a delta to the most recent keyframe.
+    */
+    void storeState(StateList::const_iter it, const uInt8* data, uInt32 size);
+
+    /**
+      Reconstruct the complete save state of the given state into
+      myStateBuffer.
+    */
+    void decodeState(const RewindState& state);
+
+    /**
+      Encode the delta between a keyframe and a complete state, or apply
+      such a delta to a keyframe.
+    */
+    static void encodeDelta(const RewindState& keyframe, const uInt8* data,
+                            uInt32 size, vector<uInt8>& delta);
+    static void decodeDelta(const RewindState& keyframe, const vector<uInt8>& delta,
+                            uInt32 size, uInt8* data);
+
     /**
       Load the current state and get the message string for the rewind/unwind
 
@@ -210,6 +378,24 @@ class RewindManager
     */
     string loadState(Int64 startCycles, uInt32 numStates);
 
+    /**
+      Re-emulate from the (just loaded) stored state to the given state,
+      with the recorded inputs.
+
+      @return  False if the emulation didn't arrive at the same state
+    */
+    bool replayState(const RewindState& state);
+
+    /**
+      Stop recording the inputs for replay mode.
+    */
+    void stopRecording();
+
+    /**
+      A checksum of the RAM, for verifying replayed states.
+    */
+    uInt32 ramChecksum() const;
+
   private:
     // Following constructors and assignment operators not supported
     RewindManager() = delete;
@@ -0,0 +1,170 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <algorithm>
+#include <chrono>
+
+#include "MD5.hxx"
+#include "RomIndex.hxx"
+#include "RomHasher.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomHasher::RomHasher(const FSList& files, const vector<bool>& filter,
+                     RomIndex& index)
+  : myFiles(files),
+    myFilter(filter),
+    myIndex(index),
+    myResults(files.size()),
+    myFinished(files.size(), false),
+    myPosition(0),
+    myReadDone(false),
+    myQuit(false)
+{
+  const uInt32 workers =
+    std::max(1u, std::min(std::thread::hardware_concurrency(), 8u) - 1);
+
+  myThreads.emplace_back(&RomHasher::read, this);
+  for(uInt32 i = 0; i < workers; ++i)
+    myThreads.emplace_back(&RomHasher::hash, this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomHasher::~RomHasher()
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myQuit = true;
+  }
+  myJobsChanged.notify_all();
+
+  for(auto& thread: myThreads)
+    thread.join();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RomHasher::next(string& md5, uInt32 timeout)
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  if(myPosition >= myFiles.size())
+    return false;
+
+  if(!myResultFinished.wait_for(lock, std::chrono::milliseconds(timeout),
+      [this]() { return myFinished[myPosition]; }))
+    return false;
+
+  md5 = std::move(myResults[myPosition]);
+  ++myPosition;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomHasher::read()
+{
+  for(uInt32 idx = 0; idx < myFiles.size(); ++idx)
+  {
+    RomIndex::Entry entry;
+    Job job { idx, nullptr, 0 };
+
+    if(myFilter[idx] && !myIndex.find(myFiles[idx], entry))
+    {
+      try
+      {
+        job.size = myFiles[idx].read(job.image);
+      }
+      catch(...) { }
+    }
+
+    std::unique_lock<std::mutex> lock(myMutex);
+    if(job.size == 0)
+    {
+      finish(idx, entry.md5);
+      continue;
+    }
+
+    myJobsChanged.wait(lock,
+        [this]() { return myQuit || myJobs.size() < PREFETCH; });
+    if(myQuit)
+      break;
+
+    myJobs.push_back(std::move(job));
+    lock.unlock();
+    myJobsChanged.notify_all();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myReadDone = true;
+  }
+  myJobsChanged.notify_all();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomHasher::hash()
+{
+  for(;;)
+  {
+    std::unique_lock<std::mutex> lock(myMutex);
+    myJobsChanged.wait(lock,
+        [this]() { return myQuit || myReadDone || !myJobs.empty(); });
+    if(myQuit || myJobs.empty())
+      break;
+
+    // Take as many images as are waiting (up to a limit), since hashing
+    // several at once is much faster
+    vector<Job> jobs;
+    while(!myJobs.empty() && jobs.size() < BATCH_SIZE)
+    {
+      jobs.push_back(std::move(myJobs.front()));
+      myJobs.pop_front();
+    }
+    lock.unlock();
+    // Wake the reader, which may be waiting for room in the queue
+    myJobsChanged.notify_all();
+
+    vector<const uInt8*> images;
+    vector<uInt32> sizes;
+    for(const auto& job: jobs)
+    {
+      images.push_back(job.image.get());
+      sizes.push_back(job.size);
+    }
+    const vector<string>& md5s = MD5::hash(images, sizes);
+
+    vector<RomIndex::Entry> entries;
+    for(uInt32 i = 0; i < jobs.size(); ++i)
+    {
+      entries.push_back(RomIndex::index(jobs[i].image, jobs[i].size, md5s[i]));
+      myIndex.insert(myFiles[jobs[i].idx], entries.back());
+    }
+
+    lock.lock();
+    for(uInt32 i = 0; i < jobs.size(); ++i)
+      finish(jobs[i].idx, entries[i].md5);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomHasher::finish(uInt32 idx, const string& md5)
+{
+  myResults[idx] = md5;
+  myFinished[idx] = true;
+
+  if(idx == myPosition)
+    myResultFinished.notify_all();
+}
@@ -0,0 +1,119 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef ROM_HASHER_HXX
+#define ROM_HASHER_HXX
+
+class RomIndex;
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "FSNode.hxx"
+#include "bspf.hxx"
+
+/**
+  Calculates the MD5s of a list of ROM files in a pipeline, for operations
+  like the ROM audit which work on whole directories.
+
+  A single reader thread reads the files, staying at most a few images
+  ahead of the hashing, so that memory use is bounded no matter how many
+  files are processed.  Files which are unchanged in the ROM index aren't
+  read at all.  Several worker threads hash the images and add them to
+  the index.  The caller collects the results in the original order with
+  next(), and is free to do other work (like updating a progress dialog)
+  while waiting.
+
+  Only the reader thread accesses the filesystem, since reading from ZIP
+  files isn't thread-safe.
+
+  @author  Stephen Anthony
+*/
+class RomHasher
+{
+  public:
+    /**
+      Start processing the given files; the list must be valid until the
+      hasher is destroyed.  Files for which 'filter' is false are skipped.
+    */
+    RomHasher(const FSList& files, const vector<bool>& filter, RomIndex& index);
+    ~RomHasher();
+
+    /**
+      Wait for the MD5 of the next file in the list.
+
+      @param md5      The MD5, or empty if the file was skipped or unreadable
+      @param timeout  The maximum time to wait, in milliseconds
+      @return  False if the result isn't available yet
+    */
+    bool next(string& md5, uInt32 timeout);
+
+    /**
+      The index of the file whose MD5 next() returns next.
+    */
+    uInt32 position() const { return myPosition; }
+
+  private:
+    struct Job {
+      uInt32 idx;
+      ByteBuffer image;
+      uInt32 size;
+    };
+
+    void read();
+    void hash();
+
+    // Store the result for the given file (the lock must be held)
+    void finish(uInt32 idx, const string& md5);
+
+  private:
+    // Maximum number of images read but not yet hashed
+    static constexpr uInt32 PREFETCH = 16;
+
+    // Maximum number of images hashed at once by one worker
+    static constexpr uInt32 BATCH_SIZE = 4;
+
+    const FSList& myFiles;
+    const vector<bool>& myFilter;
+    RomIndex& myIndex;
+
+    vector<string> myResults;
+    vector<bool> myFinished;
+    uInt32 myPosition;
+
+    std::deque<Job> myJobs;
+    bool myReadDone;
+    bool myQuit;
+
+    std::mutex myMutex;
+    std::condition_variable myJobsChanged;
+    std::condition_variable myResultFinished;
+
+    vector<std::thread> myThreads;
+
+  private:
+    // Following constructors and assignment operators not supported
+    RomHasher() = delete;
+    RomHasher(const RomHasher&) = delete;
+    RomHasher(RomHasher&&) = delete;
+    RomHasher& operator=(const RomHasher&) = delete;
+    RomHasher& operator=(RomHasher&&) = delete;
+};
+
+#endif
@@ -0,0 +1,229 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Bankswitch.hxx"
+#include "CartDetector.hxx"
+#include "MD5.hxx"
+#include "repository/KeyValueRepository.hxx"
+#include "RomIndex.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomIndex::RomIndex(shared_ptr<KeyValueRepository> repository)
+  : myRepository(repository),
+    myQuit(false)
+{
+  // Values are stored as '<size> <modified> <md5> <type>'
+  for(const auto& pair: myRepository->load())
+  {
+    istringstream buf(pair.second.toString());
+    Record record;
+
+    if(buf >> record.size >> record.modified >> record.entry.md5 >> record.entry.type)
+    {
+      record.dirty = false;
+      myRecords[pair.first] = record;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomIndex::~RomIndex()
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myQuit = true;
+  }
+  myQueueChanged.notify_all();
+  if(myWorker.joinable())
+    myWorker.join();
+
+  save();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomIndex::Entry RomIndex::get(const FilesystemNode& node)
+{
+  Entry entry;
+  if(find(node, entry))
+    return entry;
+
+  entry = index(node);
+  insert(node, entry);
+
+  return entry;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RomIndex::find(const FilesystemNode& node, Entry& entry)
+{
+  uInt64 size = 0, modified = 0;
+  if(!node.getFileInfo(size, modified))
+    return false;
+
+  std::lock_guard<std::mutex> lock(myMutex);
+  return lookup(node.getPath(), size, modified, entry);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomIndex::insert(const FilesystemNode& node, const Entry& entry)
+{
+  uInt64 size = 0, modified = 0;
+  if(entry.md5.empty() || !node.getFileInfo(size, modified))
+    return;
+
+  std::lock_guard<std::mutex> lock(myMutex);
+  myRecords[node.getPath()] = { size, modified, entry, true };
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomIndex::queue(const FSList& files)
+{
+  // Persist what has been indexed so far, before starting on new files
+  save();
+
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    myQueue.clear();
+    for(const auto& file: files)
+      if(file.isFile() && Bankswitch::isValidRomName(file))
+        myQueue.push_back(file);
+
+    if(!myWorker.joinable() && !myQueue.empty())
+      myWorker = std::thread([this] { workerLoop(); });
+  }
+  myQueueChanged.notify_one();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomIndex::renamed(const string& oldPath, const string& newPath)
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  auto iter = myRecords.find(oldPath);
+  if(iter == myRecords.end())
+    return;
+
+  Record record = iter->second;
+  record.dirty = true;
+  myRecords.erase(iter);
+  myRecords[newPath] = record;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomIndex::save()
+{
+  std::map<string, Variant> values;
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    for(auto& pair: myRecords)
+    {
+      Record& record = pair.second;
+      if(!record.dirty)
+        continue;
+
+      ostringstream buf;
+      buf << record.size << " " << record.modified << " "
+          << record.entry.md5 << " " << record.entry.type;
+      values[pair.first] = buf.str();
+
+      record.dirty = false;
+    }
+  }
+
+  if(!values.empty())
+    myRepository->save(values);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool RomIndex::lookup(const string& path, uInt64 size, uInt64 modified,
+                    Entry& entry) const
+{
+  auto iter = myRecords.find(path);
+  if(iter == myRecords.end() ||
+     iter->second.size != size || iter->second.modified != modified)
+    return false;
+
+  entry = iter->second.entry;
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomIndex::Entry RomIndex::index(const ByteBuffer& image, uInt32 size,
+                                const string& md5)
+{
+  Entry entry;
+  entry.md5 = md5;
+  entry.type = Bankswitch::typeToName(CartDetector::autodetectType(image, size));
+
+  return entry;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomIndex::Entry RomIndex::index(const FilesystemNode& node)
+{
+  try
+  {
+    ByteBuffer image;
+    uInt32 size = node.read(image);
+    if(size > 0)
+      return index(image, size, MD5::hash(image, size));
+  }
+  catch(...) { }
+
+  return Entry();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomIndex::workerLoop()
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  while(!myQuit)
+  {
+    if(myQueue.empty())
+    {
+      myQueueChanged.wait(lock);
+      continue;
+    }
+
+    FilesystemNode node = myQueue.front();
+    myQueue.pop_front();
+
+    // Reading and hashing is done without holding the lock
+    lock.unlock();
+
+    uInt64 size = 0, modified = 0;
+    bool indexable = node.getFileInfo(size, modified);
+    Entry entry;
+    if(indexable)
+    {
+      {
+        std::lock_guard<std::mutex> check(myMutex);
+        indexable = !lookup(node.getPath(), size, modified, entry);
+      }
+      if(indexable)
+        entry = index(node);
+    }
+
+    lock.lock();
+
+    if(indexable && !entry.md5.empty())
+      myRecords[node.getPath()] = { size, modified, entry, true };
+  }
+}
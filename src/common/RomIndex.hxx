@@ -0,0 +1,140 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef ROM_INDEX_HXX
+#define ROM_INDEX_HXX
+
+class KeyValueRepository;
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "bspf.hxx"
+#include "FSNode.hxx"
+
+/**
+  A persistent index of ROM files, so that the launcher and the ROM audit
+  don't need to read and hash every file again each time it is shown.
+
+  For each file, the index stores its MD5 and the autodetected bankswitch
+  type, keyed by the path.  An entry is only used if the size and
+  modification time of the file are unchanged since it was indexed.  Files
+  inside of ZIP archives are not indexed, and are hashed every time.
+
+  Files can be queued for indexing in the background, e.g. the contents of
+  a directory when the launcher enters it.  New entries are written to the
+  repository (the SQLite database, if available) by save(), which must be
+  called from the thread that owns the repository.
+
+  @author  Stephen Anthony
+*/
+class RomIndex
+{
+  public:
+    struct Entry {
+      string md5;
+      string type;  // autodetected bankswitch type
+    };
+
+  public:
+    explicit RomIndex(shared_ptr<KeyValueRepository> repository);
+    ~RomIndex();
+
+    /**
+      Get the index entry of the given file, reading and hashing it now
+      if it isn't indexed (yet).  The MD5 is empty if the file can't be
+      read.
+    */
+    Entry get(const FilesystemNode& node);
+
+    /**
+      Convenience method to get the MD5 of the given file.
+    */
+    string md5(const FilesystemNode& node) { return get(node).md5; }
+
+    /**
+      Get the index entry of the given file, without reading it.
+
+      @return  False if the file isn't indexed, or changed since
+    */
+    bool find(const FilesystemNode& node, Entry& entry);
+
+    /**
+      Add the entry of a file which was read and indexed elsewhere.
+    */
+    void insert(const FilesystemNode& node, const Entry& entry);
+
+    /**
+      Create the index entry for the given ROM image and its MD5.
+    */
+    static Entry index(const ByteBuffer& image, uInt32 size, const string& md5);
+
+    /**
+      Index the given files in the background, replacing any files queued
+      before which weren't indexed yet.
+    */
+    void queue(const FSList& files);
+
+    /**
+      Keep the entry of a file which has been renamed.
+    */
+    void renamed(const string& oldPath, const string& newPath);
+
+    /**
+      Write all new entries to the repository.
+    */
+    void save();
+
+  private:
+    struct Record {
+      uInt64 size;
+      uInt64 modified;
+      Entry entry;
+      bool dirty;
+    };
+
+    // Look up a valid entry for the node (the lock must be held)
+    bool lookup(const string& path, uInt64 size, uInt64 modified, Entry& entry) const;
+
+    static Entry index(const FilesystemNode& node);
+
+    void workerLoop();
+
+  private:
+    shared_ptr<KeyValueRepository> myRepository;
+
+    std::unordered_map<string, Record> myRecords;
+    std::deque<FilesystemNode> myQueue;
+
+    std::mutex myMutex;
+    std::condition_variable myQueueChanged;
+    std::thread myWorker;
+    bool myQuit;
+
+  private:
+    // Following constructors and assignment operators not supported
+    RomIndex() = delete;
+    RomIndex(const RomIndex&) = delete;
+    RomIndex(RomIndex&&) = delete;
+    RomIndex& operator=(const RomIndex&) = delete;
+    RomIndex& operator=(RomIndex&&) = delete;
+};
+
+#endif // ROM_INDEX_HXX
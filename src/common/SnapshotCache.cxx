@@ -0,0 +1,164 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#if defined(PNG_SUPPORT)
+
+#include "SnapshotCache.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SnapshotCache::SnapshotCache(size_t capacity)
+  : myCapacity(std::max<size_t>(capacity, 1)),
+    myTime(0),
+    myQuit(false)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SnapshotCache::~SnapshotCache()
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myQuit = true;
+  }
+  myQueueChanged.notify_all();
+  if(myWorker.joinable())
+    myWorker.join();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<const PNGLibrary::Image> SnapshotCache::get(const string& filename)
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  // A file which is being prefetched right now isn't decoded twice
+  myDecoded.wait(lock, [&] { return myDecoding != filename; });
+
+  auto iter = myEntries.find(filename);
+  if(iter == myEntries.end())
+  {
+    // Decoding is done without holding the lock
+    lock.unlock();
+    Entry entry = decode(filename);
+    lock.lock();
+
+    iter = store(filename, std::move(entry));
+  }
+  iter->second.lastUsed = ++myTime;
+
+  if(!iter->second.image)
+    throw runtime_error(iter->second.error);
+
+  return iter->second.image;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SnapshotCache::prefetch(const StringList& filenames)
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    myQueue.clear();
+    for(const auto& filename: filenames)
+      if(myEntries.find(filename) == myEntries.end())
+        myQueue.push_back(filename);
+
+    if(!myWorker.joinable() && !myQueue.empty())
+      myWorker = std::thread([this] { workerLoop(); });
+  }
+  myQueueChanged.notify_one();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SnapshotCache::clear()
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+
+  myEntries.clear();
+  myQueue.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SnapshotCache::Entry SnapshotCache::decode(const string& filename)
+{
+  Entry entry;
+  entry.lastUsed = 0;
+  try
+  {
+    auto image = make_shared<PNGLibrary::Image>();
+    PNGLibrary::decodeImage(filename, *image);
+    entry.image = image;
+  }
+  catch(const runtime_error& e)
+  {
+    entry.error = e.what();
+  }
+
+  return entry;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SnapshotCache::EntryMap::iterator SnapshotCache::store(const string& filename,
+                                                       Entry&& entry)
+{
+  // Make room by forgetting the image used the longest time ago
+  if(myEntries.size() >= myCapacity && myEntries.find(filename) == myEntries.end())
+    myEntries.erase(std::min_element(myEntries.begin(), myEntries.end(),
+      [](const EntryMap::value_type& a, const EntryMap::value_type& b) {
+        return a.second.lastUsed < b.second.lastUsed;
+      }));
+
+  Entry& stored = myEntries[filename];
+  stored = std::move(entry);
+
+  return myEntries.find(filename);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SnapshotCache::workerLoop()
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  while(!myQuit)
+  {
+    if(myQueue.empty())
+    {
+      myQueueChanged.wait(lock);
+      continue;
+    }
+
+    const string filename = myQueue.front();
+    myQueue.pop_front();
+    if(myEntries.find(filename) != myEntries.end())
+      continue;
+
+    // Decoding is done without holding the lock
+    myDecoding = filename;
+    lock.unlock();
+    Entry entry = decode(filename);
+    lock.lock();
+
+    // Prefetched images count as used now, so they aren't evicted before
+    // the entries they belong to are selected
+    entry.lastUsed = ++myTime;
+    store(filename, std::move(entry));
+
+    myDecoding.clear();
+    myDecoded.notify_all();
+  }
+}
+
+#endif  // PNG_SUPPORT
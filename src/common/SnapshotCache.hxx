@@ -0,0 +1,113 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#if defined(PNG_SUPPORT)
+
+#ifndef SNAPSHOT_CACHE_HXX
+#define SNAPSHOT_CACHE_HXX
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+#include "PNGLibrary.hxx"
+
+/**
+  A cache of decoded snapshot images, as shown by the launcher.
+
+  Decoding a snapshot takes long enough to make scrolling through the
+  launcher stutter, so the most recently used images are kept decoded, and
+  the snapshots of nearby entries can be decoded ahead of time on a
+  background thread.  Failures (most commonly a missing snapshot) are
+  cached as well.
+
+  @author  Stephen Anthony
+*/
+class SnapshotCache
+{
+  public:
+    /**
+      Create a cache keeping at most the given number of images.
+    */
+    explicit SnapshotCache(size_t capacity);
+    ~SnapshotCache();
+
+    /**
+      Get the decoded image of the given snapshot file, decoding it now
+      if it wasn't decoded before.
+
+      @post  On failure, a runtime_error is thrown containing a more
+             detailed error message.
+    */
+    shared_ptr<const PNGLibrary::Image> get(const string& filename);
+
+    /**
+      Decode the given snapshot files in the background, replacing any
+      files queued before which weren't decoded yet.
+    */
+    void prefetch(const StringList& filenames);
+
+    /**
+      Forget all images, e.g. because new snapshots may have been saved.
+    */
+    void clear();
+
+  private:
+    struct Entry {
+      shared_ptr<const PNGLibrary::Image> image;
+      string error;
+      uInt64 lastUsed;
+    };
+    using EntryMap = std::map<string, Entry>;
+
+    // Decode the given file; this doesn't access the cache
+    static Entry decode(const string& filename);
+
+    // Add an entry, making room if necessary (the lock must be held)
+    EntryMap::iterator store(const string& filename, Entry&& entry);
+
+    void workerLoop();
+
+  private:
+    size_t myCapacity;
+
+    EntryMap myEntries;
+    uInt64 myTime;
+
+    std::deque<string> myQueue;
+    string myDecoding;  // the file currently decoded by the worker
+
+    std::mutex myMutex;
+    std::condition_variable myQueueChanged, myDecoded;
+    std::thread myWorker;
+    bool myQuit;
+
+  private:
+    // Following constructors and assignment operators not supported
+    SnapshotCache() = delete;
+    SnapshotCache(const SnapshotCache&) = delete;
+    SnapshotCache(SnapshotCache&&) = delete;
+    SnapshotCache& operator=(const SnapshotCache&) = delete;
+    SnapshotCache& operator=(SnapshotCache&&) = delete;
+};
+
+#endif // SNAPSHOT_CACHE_HXX
+
+#endif // PNG_SUPPORT
@@ -34,6 +34,7 @@
 #include "AudioSettings.hxx"
 #include "audio/SimpleResampler.hxx"
 #include "audio/LanczosResampler.hxx"
+#include "audio/PolyphaseResampler.hxx"
 #include "StaggeredLogger.hxx"
 
 #include "ThreadDebugging.hxx"
@@ -48,7 +49,15 @@ SoundSDL2::SoundSDL2(OSystem& osystem, AudioSettings& audioSettings)
     myEmulationTiming(nullptr),
     myCurrentFragment(nullptr),
     myUnderrun(false),
-    myAudioSettings(audioSettings)
+    myAutotune(false),
+    myPrebufferFragments(0),
+    myMinPrebufferFragments(0),
+    myStableFragments(0),
+    myAutotuneInterval(0),
+    myDynamicRate(false),
+    myQueueFill(0),
+    myAudioSettings(audioSettings),
+    myPlacementPending(false)
 {
   ASSERT_MAIN_THREAD;
 
@@ -98,6 +107,10 @@ bool SoundSDL2::openDevice()
 
   if(myIsInitializedFlag)
     SDL_CloseAudioDevice(myDevice);
+
+  myPlacement = ThreadPlacement::fromSettings(myOSystem.settings(), "audio");
+  myPlacementPending = !myPlacement.isDefault();
+
   myDevice = SDL_OpenAudioDevice(nullptr, 0, &desired, &myHardwareSpec,
                                  SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
 
@@ -152,6 +165,19 @@ void SoundSDL2::open(shared_ptr<AudioQueue> audioQueue,
   myUnderrun = true;
   myCurrentFragment = nullptr;
 
+  // Autotuning starts with the configured headroom, and may go down to
+  // just what the playback period requires; it tries to reduce latency
+  // every ~10 seconds of stable playback
+  myAutotune = myAudioSettings.autotune();
+  myPrebufferFragments = myEmulationTiming->prebufferFragmentCount();
+  myMinPrebufferFragments = std::max(
+    myPrebufferFragments - std::min(myAudioSettings.headroom(), myPrebufferFragments), 1u);
+  myStableFragments = 0;
+  myAutotuneInterval = 10 * myEmulationTiming->audioSampleRate() / myAudioQueue->fragmentSize();
+
+  myDynamicRate = myAudioSettings.dynamicRate();
+  myQueueFill = myPrebufferFragments;
+
   // Adjust volume to that defined in settings
   setVolume(myAudioSettings.volume());
 
@@ -216,6 +242,7 @@ void SoundSDL2::setVolume(uInt32 percent)
 
     SDL_LockAudioDevice(myDevice);
     myVolumeFactor = static_cast<float>(percent) / 100.f;
+    if(myResampler) myResampler->setVolume(myVolumeFactor);
     SDL_UnlockAudioDevice(myDevice);
   }
 }
@@ -295,20 +322,26 @@ string SoundSDL2::about() const
     case AudioSettings::ResamplingQuality::lanczos_3:
       buf << "Quality 3, Lanczos (a = 3)" << endl;
       break;
+    case AudioSettings::ResamplingQuality::polyphase:
+      buf << "Quality 4, polyphase (" << myAudioSettings.resamplingTaps() << " taps)" << endl;
+      break;
   }
   buf << "    Headroom:      " << std::fixed << std::setprecision(1)
       << (0.5 * myAudioSettings.headroom()) << " frames" << endl
       << "    Buffer size:   " << std::fixed << std::setprecision(1)
-      << (0.5 * myAudioSettings.bufferSize()) << " frames" << endl;
+      << (0.5 * myAudioSettings.bufferSize()) << " frames" << endl
+      << "    Autotune:      " << (myAutotune ? "enabled" : "disabled") << endl
+      << "    Dynamic rate:  " << (myDynamicRate ? "enabled" : "disabled") << endl;
   return buf.str();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundSDL2::processFragment(float* stream, uInt32 length)
 {
-  myResampler->fillFragment(stream, length);
+  if (myDynamicRate) adjustRate();
 
-  for (uInt32 i = 0; i < length; i++) stream[i] = stream[i] * myVolumeFactor;
+  // The resampler applies the volume while converting the samples
+  myResampler->fillFragment(stream, length);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -318,13 +351,26 @@ void SoundSDL2::initResampler()
     Int16* nextFragment = nullptr;
 
     if (myUnderrun)
-      nextFragment = myAudioQueue->size() >= myEmulationTiming->prebufferFragmentCount() ?
+      nextFragment = myAudioQueue->size() >= myPrebufferFragments ?
           myAudioQueue->dequeue(myCurrentFragment) : nullptr;
-    else
+    else {
+      // Skip a fragment if more are buffered than required (the fragment
+      // skipped is never handed to the resampler); dynamic rate control
+      // drains the queue smoothly instead
+      if (myAutotune && !myDynamicRate && myAudioQueue->size() > myPrebufferFragments + 1) {
+        Int16* skippedFragment = myAudioQueue->dequeue(myCurrentFragment);
+        if (skippedFragment) myCurrentFragment = skippedFragment;
+      }
+
       nextFragment = myAudioQueue->dequeue(myCurrentFragment);
+      if (myAutotune && !nextFragment) autotune(true);
+    }
 
     myUnderrun = nextFragment == nullptr;
-    if (nextFragment) myCurrentFragment = nextFragment;
+    if (nextFragment) {
+      myCurrentFragment = nextFragment;
+      if (myAutotune) autotune(false);
+    }
 
     return nextFragment;
   };
@@ -347,9 +393,50 @@ void SoundSDL2::initResampler()
       myResampler = make_unique<LanczosResampler>(formatFrom, formatTo, nextFragmentCallback, 3);
       break;
 
+    case AudioSettings::ResamplingQuality::polyphase:
+      myResampler = make_unique<PolyphaseResampler>(formatFrom, formatTo, nextFragmentCallback,
+                                                    myAudioSettings.resamplingTaps());
+      break;
+
     default:
       throw runtime_error("invalid resampling quality");
   }
+
+  myResampler->setVolume(myVolumeFactor);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundSDL2::autotune(bool underrun)
+{
+  if (underrun) {
+    // Buffer one more fragment before playback resumes
+    if (myPrebufferFragments + 1 < myAudioQueue->capacity()) ++myPrebufferFragments;
+    myStableFragments = 0;
+  }
+  else if (++myStableFragments >= myAutotuneInterval) {
+    // Stable for a while, try with one fragment less
+    if (myPrebufferFragments > myMinPrebufferFragments) --myPrebufferFragments;
+    myStableFragments = 0;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void SoundSDL2::adjustRate()
+{
+  // The largest deviation from the nominal rate; 0.5% is well below the
+  // pitch difference anyone can hear
+  constexpr double MAX_RATE_DEVIATION = 0.005;
+  // Weight of the current queue size in the smoothed fill; fragments are
+  // queued and drained in whole steps
+  constexpr double FILL_SMOOTHING = 0.05;
+
+  myQueueFill += (double(myAudioQueue->size()) - myQueueFill) * FILL_SMOOTHING;
+
+  // Consume faster if more than the target is queued, slower if less
+  const double target = std::max(myPrebufferFragments, 1u);
+  const double deviation = BSPF::clamp((myQueueFill - target) / target, -1., 1.);
+
+  myResampler->setRateAdjustment(1 + MAX_RATE_DEVIATION * deviation);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -357,6 +444,9 @@ void SoundSDL2::callback(void* udata, uInt8* stream, int len)
 {
   SoundSDL2* self = static_cast<SoundSDL2*>(udata);
 
+  if (self->myPlacementPending.exchange(false))
+    self->myPlacement.apply("audio");
+
   if (self->myAudioQueue)
     self->processFragment(reinterpret_cast<float*>(stream), len >> 2);
   else
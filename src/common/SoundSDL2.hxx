@@ -25,10 +25,13 @@ class AudioQueue;
 class EmulationTiming;
 class AudioSettings;
 
+#include <atomic>
+
 #include "SDL_lib.hxx"
 
 #include "bspf.hxx"
 #include "Sound.hxx"
+#include "ThreadPlacement.hxx"
 #include "audio/Resampler.hxx"
 
 /**
@@ -129,6 +132,20 @@ class SoundSDL2 : public Sound
 
     void initResampler();
 
+    /**
+      Adapt the number of fragments buffered before playback to the host
+      (audio.autotune).  Called from the sound callback for every fragment
+      played, or when the queue ran empty.
+    */
+    void autotune(bool underrun);
+
+    /**
+      Nudge the rate at which the resampler consumes the queue, so that it
+      stays at the prebuffer target (audio.dynamic_rate).  Called from the
+      sound callback before every output fragment.
+    */
+    void adjustRate();
+
   private:
     // Indicates if the sound device was successfully initialized
     bool myIsInitializedFlag;
@@ -149,10 +166,27 @@ class SoundSDL2 : public Sound
     Int16* myCurrentFragment;
     bool myUnderrun;
 
+    // Autotuning: the number of fragments buffered before playback (re)starts,
+    // its lower bound, and the fragments played since the last adjustment
+    bool myAutotune;
+    uInt32 myPrebufferFragments;
+    uInt32 myMinPrebufferFragments;
+    uInt32 myStableFragments;
+    uInt32 myAutotuneInterval;
+
+    // Dynamic rate control: the smoothed number of queued fragments
+    bool myDynamicRate;
+    double myQueueFill;
+
     unique_ptr<Resampler> myResampler;
 
     AudioSettings& myAudioSettings;
 
+    // The cores and priority of the callback thread, applied by the first
+    // callback after the device is opened (SDL starts a new thread then)
+    ThreadPlacement myPlacement;
+    std::atomic<bool> myPlacementPending;
+
     string myAboutString;
 
   private:
@@ -64,6 +64,14 @@ StaggeredLogger::~StaggeredLogger()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StaggeredLogger::log()
 {
+  // Within an interval, the event only needs to be counted; an event racing
+  // the end of the interval may go uncounted, which is fine for a summary
+  if (myIsCurrentlyCollecting)
+  {
+    ++myCurrentEventCount;
+    return;
+  }
+
   std::lock_guard<std::mutex> lock(myMutex);
 
   _log();
@@ -22,6 +22,7 @@
 #include <chrono>
 #include <thread>
 #include <mutex>
+#include <atomic>
 
 #include "bspf.hxx"
 #include "TimerManager.hxx"
@@ -58,8 +59,10 @@ class StaggeredLogger {
     string myMessage;
     Logger::Level myLevel;
 
-    uInt32 myCurrentEventCount;
-    bool myIsCurrentlyCollecting;
+    // These are also accessed without holding the mutex in log(), so that
+    // reporting an event within an interval never blocks
+    std::atomic<uInt32> myCurrentEventCount;
+    std::atomic<bool> myIsCurrentlyCollecting;
 
     std::chrono::high_resolution_clock::time_point myLastIntervalStartTimestamp;
     std::chrono::high_resolution_clock::time_point myLastIntervalEndTimestamp;
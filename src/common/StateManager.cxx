@@ -15,6 +15,10 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#if defined(ZIP_SUPPORT)
+  #include <zlib.h>
+#endif
+
 #include "OSystem.hxx"
 #include "Settings.hxx"
 #include "Console.hxx"
@@ -24,10 +28,17 @@
 #include "System.hxx"
 #include "Serializable.hxx"
 #include "RewindManager.hxx"
+#include "InputMovie.hxx"
+#include "TIA.hxx"
 
 #include "StateManager.hxx"
 
-// #define MOVIE_HEADER "03030000movie"
+// Identifies states saved by a Serializer in lean mode
+static constexpr char LEAN_STATE_HEADER[] = STATE_HEADER "lean";
+
+// Identifies compressed state files; the header is followed by the size of
+// the state, and the state compressed with zlib's compress()
+static constexpr char COMPRESSED_STATE_HEADER[] = STATE_HEADER "zlib";
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 StateManager::StateManager(OSystem& osystem)
@@ -42,94 +53,142 @@ StateManager::StateManager(OSystem& osystem)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 StateManager::~StateManager()
 {
+  finishWriting();
 }
 
-#if 0
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::toggleRecordMode()
 {
-  if(myActiveMode != kMovieRecordMode)  // Turn on movie record mode
+  if(myActiveMode == Mode::MovieRecord)
   {
-    myActiveMode = kOffMode;
-
-    string moviefile = /*myOSystem.baseDir() +*/ "test.inp";
-    if(myMovieWriter.isOpen())
-      myMovieWriter.close();
-    if(!myMovieWriter.open(moviefile))
-      return false;
-
-    // Prepend the ROM md5 so this state file only works with that ROM
-    myMovieWriter.putString(myOSystem.console().properties().get(Cartridge_MD5));
-
-    if(!myOSystem.console().save(myMovieWriter))
-      return false;
-
-    // Save controller types for this ROM
-    // We need to check this, since some controllers save more state than
-    // normal, and those states files wouldn't be compatible with normal
-    // controllers.
-    myMovieWriter.putString(
-      myOSystem.console().controller(Controller::Jack::Left).name());
-    myMovieWriter.putString(
-      myOSystem.console().controller(Controller::Jack::Right).name());
-
-    // If we get this far, we're really in movie record mode
-    myActiveMode = kMovieRecordMode;
+    stopMovie();
+    return;
   }
-  else  // Turn off movie record mode
+  if(!myOSystem.hasConsole())
+    return;
+
+  stopMovie();
+
+  // The starting state has the layout of a HeadlessConsole state (a
+  // Console state and the frame count), so the movie can be replayed
+  // headless as well
+  Console& console = myOSystem.console();
+  Serializer state;
+  if(!console.save(state))
   {
-    myActiveMode = kOffMode;
-    myMovieWriter.close();
-    return false;
+    myOSystem.frameBuffer().showMessage("Error saving movie state");
+    return;
   }
+  state.putInt(0);
+
+  // Store the properties as they are in effect, rather than as given
+  // (e.g. 'AUTO')
+  Properties props = console.properties();
+  props.set(PropType::Cart_Type, console.cartridge().detectedType());
+  props.set(PropType::Display_Format, console.getFormatString());
+  props.set(PropType::Display_YStart, std::to_string(console.tia().ystart()));
+  props.set(PropType::Controller_Left,
+            Controller::getPropName(console.leftController().type()));
+  props.set(PropType::Controller_Right,
+            Controller::getPropName(console.rightController().type()));
+
+  myMovie = make_shared<InputMovie>();
+  myMovie->startRecording(props, state.data(), state.size());
+  console.setInputMovie(myMovie, false);
+  myActiveMode = Mode::MovieRecord;
+
+  myOSystem.frameBuffer().showMessage("Movie recording started");
+}
 
-  return myActiveMode == kMovieRecordMode;
-////////////////////////////////////////////////////////
-// FIXME - For now, I'm going to use this to activate movie playback
-  // Close the writer, since we're about to re-open in read mode
-  myMovieWriter.close();
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::togglePlaybackMode()
+{
+  if(myActiveMode == Mode::MoviePlayback)
+  {
+    stopMovie();
+    myOSystem.frameBuffer().showMessage("Movie playback stopped");
+    return;
+  }
+  if(!myOSystem.hasConsole())
+    return;
+
+  stopMovie();
+
+  Console& console = myOSystem.console();
+  shared_ptr<InputMovie> movie = make_shared<InputMovie>();
+  const Properties& props = movie->properties();
+  string message;
+
+  if(!movie->load(movieFile(console.properties().get(PropType::Cart_Name))))
+    message = "Can't open/load movie file";
+  else if(props.get(PropType::Cart_MD5) != console.properties().get(PropType::Cart_MD5))
+    message = "Movie was recorded with a different ROM";
+  else if(props.get(PropType::Controller_Left) !=
+            Controller::getPropName(console.leftController().type()) ||
+          props.get(PropType::Controller_Right) !=
+            Controller::getPropName(console.rightController().type()))
+    message = "Movie was recorded with different controllers";
+  else
+  {
+    Serializer state(static_cast<const void*>(movie->state().data()),
+                     movie->state().size());
+    if(!console.load(state))
+      message = "Invalid data in movie file";
+  }
 
-  if(myActiveMode != kMoviePlaybackMode)  // Turn on movie playback mode
+  if(message.empty())
   {
-    myActiveMode = kOffMode;
+    myMovie = movie;
+    console.setInputMovie(myMovie, true);
+    myActiveMode = Mode::MoviePlayback;
+    message = "Movie playback started";
+  }
+  myOSystem.frameBuffer().showMessage(message);
+}
 
-    string moviefile = /*myOSystem.baseDir() + */ "test.inp";
-    if(myMovieReader.isOpen())
-      myMovieReader.close();
-    if(!myMovieReader.open(moviefile))
-      return false;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::stopMovie()
+{
+  if(!movieActive())
+    return;
 
-    // Check the ROM md5
-    if(myMovieReader.getString() !=
-       myOSystem.console().properties().get(Cartridge_MD5))
-      return false;
+  if(myOSystem.hasConsole())
+    myOSystem.console().setInputMovie(nullptr, false);
 
-    if(!myOSystem.console().load(myMovieReader))
-      return false;
+  if(myActiveMode == Mode::MovieRecord)
+  {
+    ostringstream buf;
+    if(myMovie->save(movieFile(myMovie->properties().get(PropType::Cart_Name))))
+      buf << "Movie saved, " << myMovie->frames() << " frames";
+    else
+      buf << "Can't save movie file";
+    myOSystem.frameBuffer().showMessage(buf.str());
+  }
 
-    // Check controller types
-    const string& left  = myMovieReader.getString();
-    const string& right = myMovieReader.getString();
+  myMovie.reset();
+  myActiveMode = defaultMode();
+}
 
-    if(left != myOSystem.console().controller(Controller::Jack::Left).name() ||
-       right != myOSystem.console().controller(Controller::Jack::Right).name())
-      return false;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string StateManager::movieFile(const string& name) const
+{
+  return myOSystem.stateDir() + name + ".inp";
+}
 
-    // If we get this far, we're really in movie record mode
-    myActiveMode = kMoviePlaybackMode;
-  }
-  else  // Turn off movie playback mode
-  {
-    myActiveMode = kOffMode;
-    myMovieReader.close();
-    return false;
-  }
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateManager::Mode StateManager::defaultMode() const
+{
+  return myOSystem.settings().getBool(
+    myOSystem.settings().getBool("dev.settings") ? "dev.timemachine" : "plr.timemachine") ? Mode::TimeMachine : Mode::Off;
 }
-#endif
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::toggleTimeMachine()
 {
+  // States would break the inputs of a movie
+  if(movieActive())
+    return;
+
   bool devSettings = myOSystem.settings().getBool("dev.settings");
 
   myActiveMode = myActiveMode == Mode::TimeMachine ? Mode::Off : Mode::TimeMachine;
@@ -181,22 +240,25 @@ void StateManager::update()
       myRewindManager->addState("Time Machine", true);
       break;
 
-#if 0
-    case Mode::MovieRecord:
-      myOSystem.console().controller(Controller::Jack::Left).save(myMovieWriter);
-      myOSystem.console().controller(Controller::Jack::Right).save(myMovieWriter);
-      myOSystem.console().switches().save(myMovieWriter);
-      break;
-
     case Mode::MoviePlayback:
-      myOSystem.console().controller(Controller::Jack::Left).load(myMovieReader);
-      myOSystem.console().controller(Controller::Jack::Right).load(myMovieReader);
-      myOSystem.console().switches().load(myMovieReader);
+      if(myMovie->finished())
+      {
+        stopMovie();
+        myOSystem.frameBuffer().showMessage("Movie playback finished");
+      }
       break;
-#endif
+
     default:
       break;
   }
+
+  string error;
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    error.swap(myWriteError);
+  }
+  if(error != "")
+    myOSystem.frameBuffer().showMessage(error);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -211,26 +273,52 @@ void StateManager::loadState(int slot)
         << myOSystem.console().properties().get(PropType::Cart_Name)
         << ".st" << slot;
 
+    // The state may still be written
+    finishWriting();
+
     // Make sure the file can be opened in read-only mode
-    Serializer in(buf.str(), Serializer::Mode::ReadOnly);
-    if(!in)
+    ifstream file(buf.str(), std::ios::binary);
+    if(!file)
     {
       buf.str("");
       buf << "Can't open/load from state file " << slot;
       myOSystem.frameBuffer().showMessage(buf.str());
       return;
     }
+    vector<uInt8> data{std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>()};
 
     // First test if we have a valid header
     // If so, do a complete state load using the Console
     buf.str("");
     try
     {
-      if(in.getString() != STATE_HEADER)
+      unique_ptr<Serializer> in =
+          make_unique<Serializer>(static_cast<const void*>(data.data()), data.size());
+      string header = in->getString();
+
+    #if defined(ZIP_SUPPORT)
+      // A compressed state is unpacked into memory first
+      if(header == COMPRESSED_STATE_HEADER)
+      {
+        uLongf size = in->getInt();
+        vector<uInt8> state(size);
+        const size_t pos = in->readPosition();
+        if(uncompress(state.data(), &size, data.data() + pos,
+                      uLong(data.size() - pos)) != Z_OK)
+          throw runtime_error("Invalid compressed state");
+
+        data = std::move(state);
+        in = make_unique<Serializer>(static_cast<const void*>(data.data()), size_t(size));
+        header = in->getString();
+      }
+    #endif
+
+      if(header != STATE_HEADER)
         buf << "Incompatible state " << slot << " file";
       else
       {
-        if(myOSystem.console().load(in))
+        if(myOSystem.console().load(*in))
           buf << "State " << slot << " loaded";
         else
           buf << "Invalid data in state " << slot << " file";
@@ -257,16 +345,12 @@ void StateManager::saveState(int slot)
         << myOSystem.console().properties().get(PropType::Cart_Name)
         << ".st" << slot;
 
-    // Make sure the file can be opened for writing
-    Serializer out(buf.str());
-    if(!out)
-    {
-      buf.str("");
-      buf << "Can't open/save to state file " << slot;
-      myOSystem.frameBuffer().showMessage(buf.str());
-      return;
-    }
+    const string filename = buf.str();
 
+    // The state is saved into memory, and written to disk by the writer
+    // thread, so the emulation doesn't wait for the file system
+    Serializer out;
+    buf.str("");
     try
     {
       // Add header so that if the state format changes in the future,
@@ -281,9 +365,12 @@ void StateManager::saveState(int slot)
     }
 
     // Do a complete state save using the Console
-    buf.str("");
     if(myOSystem.console().save(out))
     {
+      finishWriting();
+      myWriter = std::thread(&StateManager::writeState, this, filename,
+                             vector<uInt8>(out.data(), out.data() + out.size()), slot);
+
       buf << "State " << slot << " saved";
       if(myOSystem.settings().getBool("autoslot"))
       {
@@ -298,6 +385,55 @@ void StateManager::saveState(int slot)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::writeState(const string& filename, const vector<uInt8>& state,
+                              int slot)
+{
+  const uInt8* data = state.data();
+  size_t size = state.size();
+
+#if defined(ZIP_SUPPORT)
+  Serializer packed;
+  uLongf packedSize = compressBound(uLong(size));
+  vector<uInt8> buffer(packedSize);
+  if(compress2(buffer.data(), &packedSize, data, uLong(size), Z_BEST_SPEED) == Z_OK)
+  {
+    packed.putString(COMPRESSED_STATE_HEADER);
+    packed.putInt(uInt32(size));
+    packed.putByteArray(buffer.data(), uInt32(packedSize));
+    data = packed.data();
+    size = packed.size();
+  }
+#endif
+
+  const string tempname = filename + ".tmp";
+  bool written;
+  {
+    ofstream out(tempname, std::ios::binary | std::ios::trunc);
+    written = out.write(reinterpret_cast<const char*>(data), size).flush().good();
+  }
+
+  // Renaming fails on some systems if the file exists already
+  if(written && std::rename(tempname.c_str(), filename.c_str()) != 0)
+    written = std::remove(filename.c_str()) == 0 &&
+              std::rename(tempname.c_str(), filename.c_str()) == 0;
+
+  if(!written)
+  {
+    std::remove(tempname.c_str());
+
+    std::lock_guard<std::mutex> lock(myMutex);
+    myWriteError = "Can't open/save to state file " + std::to_string(slot);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateManager::finishWriting()
+{
+  if(myWriter.joinable())
+    myWriter.join();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::changeState()
 {
@@ -334,8 +470,12 @@ bool StateManager::loadState(Serializer& in)
       {
         // First test if we have a valid header
         // If so, do a complete state load using the Console
-        return in.getString() == STATE_HEADER &&
-               myOSystem.console().load(in);
+        const string header = in.getString();
+        if(header != STATE_HEADER && header != LEAN_STATE_HEADER)
+          return false;
+
+        in.setLean(header == LEAN_STATE_HEADER);
+        return myOSystem.console().load(in);
       }
     }
   }
@@ -358,7 +498,7 @@ bool StateManager::saveState(Serializer& out)
       {
         // Add header so that if the state format changes in the future,
         // we'll know right away, without having to parse the rest of the file
-        out.putString(STATE_HEADER);
+        out.putString(out.lean() ? LEAN_STATE_HEADER : STATE_HEADER);
 
         // Do a complete state save using the Console
         if(myOSystem.console().save(out))
@@ -376,26 +516,8 @@ bool StateManager::saveState(Serializer& out)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::reset()
 {
-  myRewindManager->clear();
-  myActiveMode = myOSystem.settings().getBool(
-    myOSystem.settings().getBool("dev.settings") ? "dev.timemachine" : "plr.timemachine") ? Mode::TimeMachine : Mode::Off;
-
-#if 0
-  myCurrentSlot = 0;
+  stopMovie();
 
-  switch(myActiveMode)
-  {
-    case kMovieRecordMode:
-      myMovieWriter.close();
-      break;
-
-    case kMoviePlaybackMode:
-      myMovieReader.close();
-      break;
-
-    default:
-      break;
-  }
-  myActiveMode = kOffMode;
-#endif
+  myRewindManager->clear();
+  myActiveMode = defaultMode();
 }
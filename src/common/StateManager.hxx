@@ -18,10 +18,14 @@
 #ifndef STATE_MANAGER_HXX
 #define STATE_MANAGER_HXX
 
-#define STATE_HEADER "06000003state"
+#define STATE_HEADER "06000004state"
 
 class OSystem;
 class RewindManager;
+class InputMovie;
+
+#include <mutex>
+#include <thread>
 
 #include "Serializer.hxx"
 
@@ -54,12 +58,31 @@ class StateManager
     */
     Mode mode() const { return myActiveMode; }
 
-#if 0
     /**
-      Toggle movie recording mode (FIXME - currently disabled)
+      Toggle movie recording mode.  The recording starts with a state of
+      the current frame, and is saved to the state directory when it is
+      stopped.
     */
     void toggleRecordMode();
-#endif
+
+    /**
+      Toggle movie playback mode, playing back the movie recorded for the
+      current ROM.
+    */
+    void togglePlaybackMode();
+
+    /**
+      Stop recording or playing back a movie; a recorded movie is saved.
+    */
+    void stopMovie();
+
+    /**
+      Answers whether a movie is being recorded or played back.
+    */
+    bool movieActive() const {
+      return myActiveMode == Mode::MovieRecord ||
+             myActiveMode == Mode::MoviePlayback;
+    }
 
     /**
       Toggle state rewind recording mode; this uses the RewindManager
@@ -100,14 +123,17 @@ class StateManager
     void update();
 
     /**
-      Load a state into the current system.
+      Load a state into the current system.  Both compressed and
+      uncompressed state files are accepted.
 
       @param slot  The state 'slot' to load state from
     */
     void loadState(int slot = -1);
 
     /**
-      Save the current state from the system.
+      Save the current state from the system.  The state is saved into
+      memory, then compressed (if zlib is available) and written to disk
+      in the background; a write error is reported by update().
 
       @param slot  The state 'slot' to save into
     */
@@ -125,7 +151,8 @@ class StateManager
 
     /**
       Load a state into the current system from the given Serializer.
-      No messages are printed to the screen.
+      No messages are printed to the screen.  Lean states (see
+      Serializer::setLean()) are recognized by their header.
 
       @param in  The Serializer object to use
 
@@ -135,7 +162,8 @@ class StateManager
 
     /**
       Save the current state from the system into the given Serializer.
-      No messages are printed to the screen.
+      No messages are printed to the screen.  If the Serializer is in lean
+      mode, a lean state is saved.
 
       @param out  The Serializer object to use
 
@@ -158,6 +186,30 @@ class StateManager
     */
     RewindManager& rewindManager() const { return *myRewindManager; }
 
+  private:
+    /**
+      The file name of the movie for the given ROM name.
+    */
+    string movieFile(const string& name) const;
+
+    /**
+      The mode when no movie is active.
+    */
+    Mode defaultMode() const;
+
+    /**
+      Write a state to the given file, compressed if possible; runs on
+      the writer thread.  The state is written to a temporary file first,
+      which then replaces the old file, so a state file is never left
+      half-written.
+    */
+    void writeState(const string& filename, const vector<uInt8>& state, int slot);
+
+    /**
+      Wait until the state saved last has been written.
+    */
+    void finishWriting();
+
   private:
     // The parent OSystem object
     OSystem& myOSystem;
@@ -171,13 +223,19 @@ class StateManager
     // MD5 of the currently active ROM (either in movie or rewind mode)
     string myMD5;
 
-    // Serializer classes used to save/load the eventstream
-    Serializer myMovieWriter;
-    Serializer myMovieReader;
+    // The movie being recorded or played back
+    shared_ptr<InputMovie> myMovie;
 
     // Stored savestates to be later rewound
     unique_ptr<RewindManager> myRewindManager;
 
+    // Writes the state saved last to disk
+    std::thread myWriter;
+
+    // The message of a failed write, shown by update()
+    string myWriteError;
+    std::mutex myMutex;
+
   private:
     // Following constructors and assignment operators not supported
     StateManager() = delete;
@@ -0,0 +1,568 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#if defined(BSPF_UNIX) || defined(BSPF_MACOS)
+  #include <arpa/inet.h>
+  #include <fcntl.h>
+  #include <netinet/in.h>
+  #include <sys/socket.h>
+  #include <unistd.h>
+
+  #define STREAM_SOCKETS
+  using SocketLength = socklen_t;
+#elif defined(BSPF_WINDOWS)
+  #include <winsock2.h>
+  #include <ws2tcpip.h>
+  #if defined(_MSC_VER)
+    #pragma comment(lib, "ws2_32.lib")
+  #endif
+
+  #define STREAM_SOCKETS
+  using SocketLength = int;
+#endif
+
+#include <random>
+
+#include "Logger.hxx"
+#include "StreamServer.hxx"
+
+constexpr uInt8 StreamServer::VERSION;
+constexpr uInt32 StreamServer::FRAME_WIDTH;
+constexpr uInt32 StreamServer::MAX_PACKET;
+constexpr uInt32 StreamServer::MAX_CLIENTS;
+constexpr uInt32 StreamServer::KEYFRAME_INTERVAL;
+constexpr std::chrono::seconds StreamServer::CLIENT_TIMEOUT;
+
+namespace {
+  constexpr std::intptr_t NO_SOCKET = -1;
+
+  // The sizes of the headers, as sent
+  constexpr size_t HEADER_SIZE = 8;
+  constexpr size_t FRAME_HEADER_SIZE = 12;
+  constexpr size_t AUDIO_HEADER_SIZE = 8;
+  constexpr size_t COOKIE_SIZE = 8;
+  constexpr size_t INPUT_SIZE = 6;
+
+#if defined(STREAM_SOCKETS)
+  uInt16 get16(const uInt8* in)
+  {
+    return uInt16(in[0] | (in[1] << 8));
+  }
+
+  uInt32 get32(const uInt8* in)
+  {
+    return uInt32(in[0]) | (uInt32(in[1]) << 8) | (uInt32(in[2]) << 16) |
+           (uInt32(in[3]) << 24);
+  }
+
+  uInt64 get64(const uInt8* in)
+  {
+    return uInt64(get32(in)) | (uInt64(get32(in + 4)) << 32);
+  }
+#endif
+
+  uInt64 rotate(uInt64 x, int bits)
+  {
+    return (x << bits) | (x >> (64 - bits));
+  }
+
+  // SipHash-2-4 of a single 64-bit value
+  uInt64 sipHash(const std::array<uInt64, 2>& key, uInt64 value)
+  {
+    uInt64 v0 = key[0] ^ 0x736f6d6570736575ULL, v1 = key[1] ^ 0x646f72616e646f6dULL,
+           v2 = key[0] ^ 0x6c7967656e657261ULL, v3 = key[1] ^ 0x7465646279746573ULL;
+
+    const auto rounds = [&](int n) {
+      while(n--)
+      {
+        v0 += v1; v1 = rotate(v1, 13); v1 ^= v0; v0 = rotate(v0, 32);
+        v2 += v3; v3 = rotate(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = rotate(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = rotate(v1, 17); v1 ^= v2; v2 = rotate(v2, 32);
+      }
+    };
+    const auto compress = [&](uInt64 m) {
+      v3 ^= m;  rounds(2);  v0 ^= m;
+    };
+
+    compress(value);
+    compress(uInt64(8) << 56);  // the length of the message
+    v2 ^= 0xff;
+    rounds(4);
+
+    return v0 ^ v1 ^ v2 ^ v3;
+  }
+
+#if defined(STREAM_SOCKETS)
+
+  // Console and controller events, which a remote player may send
+  bool isRemoteEvent(uInt32 type)
+  {
+    return type >= Event::ConsoleColor && type <= Event::MouseButtonRightValue;
+  }
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StreamServer::StreamServer()
+  : mySocket(NO_SOCKET),
+    myOpen(false),
+    myCookieKey{{0, 0}},
+    mySequence(0),
+    myAudioFormat(0),
+    myPreviousHeight(0),
+    myPreviousPalette(0),
+    myFramesSinceKeyframe(0),
+    myKeyframeRequested(true),
+    myFrameNumber(0),
+    myPaletteId(0),
+    myKeyframe(true),
+    myHeight(0)
+{
+  myPreviousFrame.fill(0);
+  myPacket.reserve(MAX_PACKET);
+  myLine.reserve(FRAME_WIDTH * 2 + 1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StreamServer::~StreamServer()
+{
+  close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StreamServer::open(uInt16 port, const string& address)
+{
+  close();
+
+#if defined(STREAM_SOCKETS)
+  #if defined(BSPF_WINDOWS)
+  WSADATA data;
+  if(WSAStartup(MAKEWORD(2, 2), &data) != 0)
+    return false;
+
+  const SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  u_long nonBlocking = 1;
+  if(s == INVALID_SOCKET || ioctlsocket(s, FIONBIO, &nonBlocking) != 0)
+  {
+    if(s != INVALID_SOCKET) closesocket(s);
+    WSACleanup();
+    return false;
+  }
+  #else
+  const int s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if(s < 0 || fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK) != 0)
+  {
+    if(s >= 0) ::close(s);
+    return false;
+  }
+  #endif
+  mySocket = std::intptr_t(s);
+
+  sockaddr_in local;
+  std::fill_n(reinterpret_cast<uInt8*>(&local), sizeof(local), 0);
+  local.sin_family = AF_INET;
+  local.sin_port = htons(port);
+
+  if(inet_pton(AF_INET, address.c_str(), &local.sin_addr) != 1 ||
+     bind(s, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0)
+  {
+    myOpen = true;  // so that close() cleans up
+    close();
+    return false;
+  }
+
+  // Cookies handed out before don't register anyone anymore
+  std::random_device random;
+  for(auto& key: myCookieKey)
+    key = (uInt64(random()) << 32) | random();
+
+  myOpen = true;
+  myKeyframeRequested = true;
+  Logger::info("Streaming on UDP " + address + ":" + std::to_string(port));
+
+  return true;
+#else
+  (void)port;
+  (void)address;
+  return false;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StreamServer::close()
+{
+  if(!myOpen)
+    return;
+
+#if defined(STREAM_SOCKETS)
+  #if defined(BSPF_WINDOWS)
+  closesocket(SOCKET(mySocket));
+  WSACleanup();
+  #else
+  ::close(int(mySocket));
+  #endif
+#endif
+
+  mySocket = NO_SOCKET;
+  myOpen = false;
+
+  std::lock_guard<std::mutex> lock(myClientMutex);
+  myClients.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StreamServer::setAudioFormat(uInt32 sampleRate, bool stereo)
+{
+  myAudioFormat = (sampleRate << 1) | (stereo ? 1 : 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StreamServer::sendFrame(const uInt8* pixels, uInt32 height,
+                             uInt32 frameNumber, uInt32 paletteId)
+{
+  if(!myOpen || clients() == 0)
+    return;
+
+  height = std::min(height, TIAConstants::frameBufferHeight);
+
+  // Lines that didn't change since the previous frame cost one byte per
+  // 255 of them; clients that lost a packet recover with the next keyframe
+  myKeyframe = myKeyframeRequested.exchange(false) || height != myPreviousHeight ||
+               paletteId != myPreviousPalette ||
+               ++myFramesSinceKeyframe >= KEYFRAME_INTERVAL;
+  if(myKeyframe)
+    myFramesSinceKeyframe = 0;
+
+  myFrameNumber = frameNumber;
+  myPaletteId = uInt8(paletteId);
+  myHeight = uInt16(height);
+
+  const auto unchanged = [&](uInt32 y) {
+    return std::equal(pixels + y * FRAME_WIDTH, pixels + (y + 1) * FRAME_WIDTH,
+                      myPreviousFrame.data() + y * FRAME_WIDTH);
+  };
+
+  uInt32 lines = 0;
+  startFramePacket(0);
+  for(uInt32 y = 0; y < height; )
+  {
+    const uInt8* line = pixels + y * FRAME_WIDTH;
+    uInt32 count = 1;
+
+    myLine.clear();
+    if(!myKeyframe && unchanged(y))
+    {
+      while(y + count < height && count < 255 && unchanged(y + count))
+        ++count;
+      myLine.push_back(LINE_UNCHANGED);
+      myLine.push_back(uInt8(count));
+    }
+    else
+      encodeLine(line, lines > 0 ? line - FRAME_WIDTH : nullptr, myLine);
+
+    if(myPacket.size() + myLine.size() > MAX_PACKET)
+    {
+      finishFramePacket(lines);
+      sendToClients(myPacket);
+      startFramePacket(y);
+      lines = 0;
+
+      // The first line of a packet can't refer to the line above
+      if(myLine[0] == LINE_REPEAT)
+      {
+        myLine.clear();
+        encodeLine(line, nullptr, myLine);
+      }
+    }
+
+    myPacket.insert(myPacket.end(), myLine.begin(), myLine.end());
+    lines += count;
+    y += count;
+  }
+  finishFramePacket(lines);
+  sendToClients(myPacket);
+
+  std::copy_n(pixels, height * FRAME_WIDTH, myPreviousFrame.begin());
+  myPreviousHeight = height;
+  myPreviousPalette = paletteId;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StreamServer::sendAudio(const Int16* samples, uInt32 count)
+{
+  if(!myOpen || clients() == 0)
+    return;
+
+  const uInt32 format = myAudioFormat;
+  const uInt32 channels = (format & 1) ? 2 : 1;
+
+  // Whole sample frames per packet
+  const uInt32 maxSamples =
+    uInt32((MAX_PACKET - HEADER_SIZE - AUDIO_HEADER_SIZE) / 2) / channels * channels;
+
+  vector<uInt8> packet;
+  packet.reserve(MAX_PACKET);
+  for(uInt32 first = 0; first < count; first += maxSamples)
+  {
+    const uInt32 n = std::min(count - first, maxSamples);
+
+    startPacket(packet, AUDIO);
+    put32(packet, format >> 1);
+    packet.push_back(uInt8(channels));
+    packet.push_back(0);
+    put16(packet, uInt16(n));
+    for(uInt32 i = 0; i < n; ++i)
+      put16(packet, uInt16(samples[first + i]));
+
+    sendToClients(packet);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StreamServer::receive(const InputHandler& handler)
+{
+#if defined(STREAM_SOCKETS)
+  if(!myOpen)
+    return;
+
+  const Clock::time_point now = Clock::now();
+  uInt8 packet[MAX_PACKET];
+
+  for(;;)
+  {
+    sockaddr_in from;
+    SocketLength fromSize = sizeof(from);
+    const auto size = recvfrom(mySocket, reinterpret_cast<char*>(packet), sizeof(packet), 0,
+                               reinterpret_cast<sockaddr*>(&from), &fromSize);
+    if(size < 0)
+      break;  // nothing left (or an error, which is retried next time)
+
+    if(size_t(size) < HEADER_SIZE + COOKIE_SIZE || packet[0] != 'S' || packet[1] != 'T' ||
+       packet[2] != VERSION || from.sin_family != AF_INET)
+      continue;
+
+    // Only a client which received the cookie at its address may register
+    // and play; a HELLO from anyone else just gets the cookie, in a packet
+    // of the same size
+    const uInt64 expected = cookie(from.sin_addr.s_addr, from.sin_port);
+    if(get64(packet + HEADER_SIZE) != expected)
+    {
+      if(packet[3] == HELLO)
+      {
+        vector<uInt8> challenge;
+        startPacket(challenge, CHALLENGE);
+        put64(challenge, expected);
+        sendTo(from.sin_addr.s_addr, from.sin_port, challenge);
+      }
+      continue;
+    }
+
+    std::lock_guard<std::mutex> lock(myClientMutex);
+
+    auto client = std::find_if(myClients.begin(), myClients.end(), [&](const Client& c) {
+      return c.address == from.sin_addr.s_addr && c.port == from.sin_port;
+    });
+
+    switch(packet[3])
+    {
+      case HELLO:
+        if(client != myClients.end())
+          client->lastSeen = now;
+        else if(myClients.size() < MAX_CLIENTS)
+        {
+          myClients.push_back({ from.sin_addr.s_addr, from.sin_port, now });
+          myKeyframeRequested = true;
+          Logger::info("Stream client connected");
+        }
+        break;
+
+      case BYE:
+        if(client != myClients.end())
+        {
+          myClients.erase(client);
+          Logger::info("Stream client disconnected");
+        }
+        break;
+
+      case INPUT:
+      {
+        // Only registered clients may play
+        constexpr size_t start = HEADER_SIZE + COOKIE_SIZE;
+        if(client == myClients.end() || size_t(size) < start + 1)
+          break;
+        client->lastSeen = now;
+
+        const uInt32 events = std::min<uInt32>(packet[start],
+          uInt32((size_t(size) - start - 1) / INPUT_SIZE));
+        for(uInt32 i = 0; i < events; ++i)
+        {
+          const uInt8* event = packet + start + 1 + i * INPUT_SIZE;
+          const uInt32 type = get16(event);
+
+          if(isRemoteEvent(type))
+            handler(Event::Type(type), Int32(get32(event + 2)));
+        }
+        break;
+      }
+
+      default:
+        break;
+    }
+  }
+
+  // Drop the clients that went away without saying so
+  std::lock_guard<std::mutex> lock(myClientMutex);
+  const size_t before = myClients.size();
+  myClients.erase(std::remove_if(myClients.begin(), myClients.end(), [&](const Client& c) {
+    return now - c.lastSeen > CLIENT_TIMEOUT;
+  }), myClients.end());
+  if(myClients.size() != before)
+    Logger::info("Stream client timed out");
+#else
+  (void)handler;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 StreamServer::clients() const
+{
+  std::lock_guard<std::mutex> lock(myClientMutex);
+  return uInt32(myClients.size());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StreamServer::encodeLine(const uInt8* line, const uInt8* above, vector<uInt8>& out)
+{
+  if(above && std::equal(line, line + FRAME_WIDTH, above))
+  {
+    out.push_back(LINE_REPEAT);
+    return;
+  }
+
+  out.push_back(LINE_RLE);
+  for(uInt32 x = 0; x < FRAME_WIDTH; )
+  {
+    uInt32 length = 1;
+    while(x + length < FRAME_WIDTH && length < 255 && line[x + length] == line[x])
+      ++length;
+
+    out.push_back(uInt8(length));
+    out.push_back(line[x]);
+    x += length;
+  }
+
+  // Busy lines are cheaper as they are
+  if(out.size() - 1 > FRAME_WIDTH)
+  {
+    out.clear();
+    out.push_back(LINE_RAW);
+    out.insert(out.end(), line, line + FRAME_WIDTH);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 StreamServer::cookie(uInt32 address, uInt16 port) const
+{
+  return sipHash(myCookieKey, uInt64(address) | (uInt64(port) << 32));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StreamServer::startPacket(vector<uInt8>& packet, PacketType type)
+{
+  packet.clear();
+  packet.push_back('S');
+  packet.push_back('T');
+  packet.push_back(VERSION);
+  packet.push_back(type);
+  put32(packet, mySequence++);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StreamServer::startFramePacket(uInt32 firstLine)
+{
+  startPacket(myPacket, FRAME);
+  put32(myPacket, myFrameNumber);
+  myPacket.push_back(myPaletteId);
+  myPacket.push_back(myKeyframe ? 1 : 0);
+  put16(myPacket, myHeight);
+  put16(myPacket, uInt16(firstLine));
+  put16(myPacket, 0);  // the lines, filled in by finishFramePacket()
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StreamServer::finishFramePacket(uInt32 lines)
+{
+  myPacket[HEADER_SIZE + FRAME_HEADER_SIZE - 2] = uInt8(lines);
+  myPacket[HEADER_SIZE + FRAME_HEADER_SIZE - 1] = uInt8(lines >> 8);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StreamServer::sendToClients(const vector<uInt8>& packet)
+{
+#if defined(STREAM_SOCKETS)
+  std::lock_guard<std::mutex> lock(myClientMutex);
+
+  for(const Client& client: myClients)
+    sendTo(client.address, client.port, packet);
+#else
+  (void)packet;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StreamServer::sendTo(uInt32 address, uInt16 port, const vector<uInt8>& packet)
+{
+#if defined(STREAM_SOCKETS)
+  sockaddr_in to;
+  std::fill_n(reinterpret_cast<uInt8*>(&to), sizeof(to), 0);
+  to.sin_family = AF_INET;
+  to.sin_addr.s_addr = address;
+  to.sin_port = port;
+
+  // A full socket buffer drops the packet, like the network would
+  sendto(mySocket, reinterpret_cast<const char*>(packet.data()), int(packet.size()), 0,
+         reinterpret_cast<const sockaddr*>(&to), sizeof(to));
+#else
+  (void)address;
+  (void)port;
+  (void)packet;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StreamServer::put16(vector<uInt8>& out, uInt16 value)
+{
+  out.push_back(uInt8(value));
+  out.push_back(uInt8(value >> 8));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StreamServer::put32(vector<uInt8>& out, uInt32 value)
+{
+  out.push_back(uInt8(value));
+  out.push_back(uInt8(value >> 8));
+  out.push_back(uInt8(value >> 16));
+  out.push_back(uInt8(value >> 24));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StreamServer::put64(vector<uInt8>& out, uInt64 value)
+{
+  put32(out, uInt32(value));
+  put32(out, uInt32(value >> 32));
+}
@@ -0,0 +1,256 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef STREAM_SERVER_HXX
+#define STREAM_SERVER_HXX
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+
+#include "bspf.hxx"
+#include "Event.hxx"
+#include "TIAConstants.hxx"
+
+/**
+  Streams the emulated frames (as TIA palette indices) and audio samples
+  to remote players over UDP, and takes their input.  Unlike a video
+  stream of the scaled window, encoding a frame costs next to nothing, and
+  a session needs some kilobytes per second.
+
+  Each packet starts with a Header; all values are little endian.  Every
+  packet from a client continues with the cookie (uInt64) the server gave
+  it, or zero before it has one.  A client registers in two steps, so that
+  a forged sender address can't make the server stream to it:
+
+  - HELLO (client to server): asks to be registered; a client sends it at
+    least every few seconds (CLIENT_TIMEOUT) to stay registered, and
+    leaves with BYE.  If the cookie isn't the one of the sender's address
+    and port, the server only answers with CHALLENGE.
+
+  - CHALLENGE (server to client): the cookie, which the client echoes in
+    all further packets.  It is a keyed hash of the client's address and
+    port, so the server doesn't keep any state for unregistered clients,
+    and it is no larger than the HELLO it answers.
+
+  Packets with a wrong cookie are ignored otherwise.
+
+  - FRAME (server to client): a FrameHeader, followed by 'lines' encoded
+    lines, starting at 'firstLine'.  A frame is split into as many packets
+    as it needs; the packets of a frame don't depend on each other.  A line
+    starts with a code:
+
+      LINE_UNCHANGED n   n lines (1 - 255) are as in the previous frame
+      LINE_REPEAT        the line is the same as the one above; never the
+                         first line of a packet
+      LINE_RLE           runs of (length 1 - 255, index) up to FRAME_WIDTH
+                         pixels
+      LINE_RAW           FRAME_WIDTH indices
+
+    Keyframes don't use LINE_UNCHANGED.  They are sent every
+    KEYFRAME_INTERVAL frames, when a client registers, and when the height
+    or palette of the frame changes; after losing a packet, a client shows
+    a stale part of the image until the next keyframe at the latest.
+
+  - AUDIO (server to client): an AudioHeader, followed by 'samples' Int16
+    (interleaved if stereo).
+
+  - INPUT (client to server): a count (uInt8), followed by as many events
+    of Event::Type (uInt16) and value (Int32).  Only console and controller
+    events are accepted.
+
+  Sockets are supported on Unix, macOS and Windows.
+
+  @author  Stephen Anthony
+*/
+class StreamServer
+{
+  public:
+    static constexpr uInt8 VERSION = 2;
+    static constexpr uInt32 FRAME_WIDTH = TIAConstants::H_PIXEL;
+    static constexpr uInt32 MAX_PACKET = 1400;  // stays below the usual MTU
+    static constexpr uInt32 MAX_CLIENTS = 8;
+    static constexpr uInt32 KEYFRAME_INTERVAL = 60;
+    static constexpr std::chrono::seconds CLIENT_TIMEOUT{10};
+
+    enum PacketType: uInt8 {
+      HELLO = 1, BYE = 2, INPUT = 3,
+      FRAME = 16, AUDIO = 17, CHALLENGE = 18
+    };
+
+    enum LineCode: uInt8 {
+      LINE_UNCHANGED = 0, LINE_REPEAT = 1, LINE_RLE = 2, LINE_RAW = 3
+    };
+
+    // The layout of the packets; the structures are only for reference,
+    // since the values are written byte by byte
+    struct Header {
+      char magic[2];        // "ST"
+      uInt8 version;
+      uInt8 type;           // PacketType
+      uInt32 sequence;      // counts the packets sent by the server
+    };
+
+    struct FrameHeader {
+      uInt32 frameNumber;   // as counted by the TIA
+      uInt8 paletteId;      // 0 = NTSC, 1 = PAL, 2 = SECAM
+      uInt8 keyframe;       // 1 if no line refers to the previous frame
+      uInt16 height;        // lines of the frame
+      uInt16 firstLine;     // first line in this packet
+      uInt16 lines;         // lines in this packet
+    };
+
+    struct AudioHeader {
+      uInt32 sampleRate;
+      uInt8 channels;       // 1 or 2
+      uInt8 reserved;
+      uInt16 samples;       // counting both channels
+    };
+
+    using InputHandler = std::function<void(Event::Type, Int32)>;
+
+  public:
+    StreamServer();
+    ~StreamServer();
+
+    /**
+      Start listening for clients.
+
+      @param port     The UDP port to listen on
+      @param address  The IPv4 address to listen on, e.g. "127.0.0.1" to
+                      only accept clients on this machine
+      @return  True on success
+    */
+    bool open(uInt16 port, const string& address);
+
+    /**
+      Stop streaming and forget all clients.
+    */
+    void close();
+
+    bool isOpen() const { return myOpen; }
+
+    /**
+      Describe the audio sent from now on.
+    */
+    void setAudioFormat(uInt32 sampleRate, bool stereo);
+
+    /**
+      Send a frame to all clients.  Must be called from one thread only.
+
+      @param pixels       The frame buffer of the TIA (FRAME_WIDTH pixels
+                          per line)
+      @param height       The number of lines of the frame
+      @param frameNumber  The number of the frame
+      @param paletteId    The palette the pixels index into
+    */
+    void sendFrame(const uInt8* pixels, uInt32 height, uInt32 frameNumber,
+                   uInt32 paletteId);
+
+    /**
+      Send audio samples to all clients.  May be called from another thread
+      than the rest.
+
+      @param samples  The samples (interleaved if stereo)
+      @param count    The number of samples (counting both channels)
+    */
+    void sendAudio(const Int16* samples, uInt32 count);
+
+    /**
+      Handle the packets received since the last call: register and drop
+      clients, and pass their input to the given handler.
+    */
+    void receive(const InputHandler& handler);
+
+    /**
+      The number of clients registered.
+    */
+    uInt32 clients() const;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Client {
+      uInt32 address;       // IPv4, in network byte order
+      uInt16 port;          // in network byte order
+      Clock::time_point lastSeen;
+    };
+
+    /**
+      Encode a line into the given buffer.
+
+      @param line      The pixels of the line
+      @param above     The pixels of the line above, or nullptr
+    */
+    static void encodeLine(const uInt8* line, const uInt8* above, vector<uInt8>& out);
+
+    /**
+      The cookie of the client with the given address and port (both in
+      network byte order).
+    */
+    uInt64 cookie(uInt32 address, uInt16 port) const;
+
+    void startPacket(vector<uInt8>& packet, PacketType type);
+    void startFramePacket(uInt32 firstLine);
+    void finishFramePacket(uInt32 lines);
+
+    void sendToClients(const vector<uInt8>& packet);
+    void sendTo(uInt32 address, uInt16 port, const vector<uInt8>& packet);
+
+    static void put16(vector<uInt8>& out, uInt16 value);
+    static void put32(vector<uInt8>& out, uInt32 value);
+    static void put64(vector<uInt8>& out, uInt64 value);
+
+  private:
+    std::intptr_t mySocket;
+    std::atomic<bool> myOpen;
+
+    // The key of the cookies, chosen at random whenever the server opens
+    std::array<uInt64, 2> myCookieKey;
+
+    mutable std::mutex myClientMutex;
+    vector<Client> myClients;
+
+    std::atomic<uInt32> mySequence;
+    std::atomic<uInt32> myAudioFormat;  // sample rate << 1 | stereo
+
+    // The previous frame, which delta frames refer to
+    std::array<uInt8, FRAME_WIDTH * TIAConstants::frameBufferHeight> myPreviousFrame;
+    uInt32 myPreviousHeight;
+    uInt32 myPreviousPalette;
+    uInt32 myFramesSinceKeyframe;
+    std::atomic<bool> myKeyframeRequested;
+
+    // The frame packet being assembled, and what goes into its header
+    vector<uInt8> myPacket;
+    vector<uInt8> myLine;
+    uInt32 myFrameNumber;
+    uInt8 myPaletteId;
+    bool myKeyframe;
+    uInt16 myHeight;
+
+  private:
+    // Following constructors and assignment operators not supported
+    StreamServer(const StreamServer&) = delete;
+    StreamServer(StreamServer&&) = delete;
+    StreamServer& operator=(const StreamServer&) = delete;
+    StreamServer& operator=(StreamServer&&) = delete;
+};
+
+#endif
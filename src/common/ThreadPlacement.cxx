@@ -0,0 +1,264 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <map>
+#include <mutex>
+
+#include "Logger.hxx"
+#include "Settings.hxx"
+#include "ThreadPlacement.hxx"
+
+#if defined(BSPF_UNIX) && defined(__linux__)
+  #include <pthread.h>
+  #include <sched.h>
+  #include <unistd.h>
+  #include <sys/resource.h>
+  #include <sys/syscall.h>
+#elif defined(BSPF_UNIX) || defined(BSPF_MACOS)
+  #include <pthread.h>
+  #include <sched.h>
+#elif defined(BSPF_WINDOWS)
+  #include <windows.h>
+#endif
+
+namespace {
+  // The nice value of the 'high' priority on Linux
+  constexpr int HIGH_NICE = -10;
+
+  std::mutex placementMutex;
+  std::map<string, string> placements;
+
+  // Apply the cores to the calling thread
+  bool setCores(const vector<uInt32>& cores)
+  {
+    if(cores.empty())
+      return true;
+
+  #if defined(BSPF_UNIX) && defined(__linux__)
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for(uInt32 core: cores)
+      if(core < CPU_SETSIZE) CPU_SET(core, &cpus);
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+  #elif defined(BSPF_WINDOWS)
+    DWORD_PTR mask = 0;
+    for(uInt32 core: cores)
+      if(core < sizeof(mask) * 8) mask |= DWORD_PTR(1) << core;
+
+    return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+  #else
+    // macOS only takes affinity hints, which we don't use
+    return false;
+  #endif
+  }
+
+  // Apply the priority to the calling thread
+  bool setPriority(ThreadPlacement::Priority priority)
+  {
+    using Priority = ThreadPlacement::Priority;
+
+    if(priority == Priority::normal)
+      return true;
+
+  #if defined(BSPF_UNIX) && defined(__linux__)
+    if(priority == Priority::high)
+    {
+      // On Linux, the nice value belongs to the thread
+      const id_t tid = id_t(syscall(SYS_gettid));
+      return setpriority(PRIO_PROCESS, tid, HIGH_NICE) == 0;
+    }
+
+    sched_param param;
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+  #elif defined(BSPF_UNIX) || defined(BSPF_MACOS)
+    const int policy = priority == Priority::realtime ? SCHED_FIFO : SCHED_RR;
+    sched_param param;
+    param.sched_priority = priority == Priority::realtime
+      ? sched_get_priority_max(policy) : sched_get_priority_min(policy);
+
+    return pthread_setschedparam(pthread_self(), policy, &param) == 0;
+  #elif defined(BSPF_WINDOWS)
+    return SetThreadPriority(GetCurrentThread(), priority == Priority::realtime
+      ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_HIGHEST) != 0;
+  #else
+    return false;
+  #endif
+  }
+
+  constexpr bool affinitySupported()
+  {
+  #if (defined(BSPF_UNIX) && defined(__linux__)) || defined(BSPF_WINDOWS)
+    return true;
+  #else
+    return false;
+  #endif
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThreadPlacement ThreadPlacement::fromSettings(const Settings& settings,
+                                              const string& prefix)
+{
+  ThreadPlacement placement;
+
+  if(!parseCores(settings.getString(prefix + ".core"), placement.myCores))
+    placement.myCores.clear();
+  if(!parsePriority(settings.getString(prefix + ".priority"), placement.myPriority))
+    placement.myPriority = Priority::normal;
+
+  return placement;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ThreadPlacement::parseCores(const string& spec, vector<uInt32>& cores)
+{
+  cores.clear();
+  if(spec.empty() || spec == "-1")
+    return true;
+
+  // A list of cores and ranges of cores, e.g. "2,4-7"
+  istringstream buf(spec);
+  string item;
+  while(std::getline(buf, item, ','))
+  {
+    const size_t dash = item.find('-');
+    const string first = item.substr(0, dash);
+    const string last = dash == string::npos ? first : item.substr(dash + 1);
+
+    if(first.empty() || last.empty() ||
+       first.find_first_not_of("0123456789") != string::npos ||
+       last.find_first_not_of("0123456789") != string::npos ||
+       first.size() > 4 || last.size() > 4)
+      return false;
+
+    const uInt32 from = uInt32(std::stoi(first)), to = uInt32(std::stoi(last));
+    if(from > to)
+      return false;
+
+    for(uInt32 core = from; core <= to; ++core)
+      if(std::find(cores.begin(), cores.end(), core) == cores.end())
+        cores.push_back(core);
+  }
+  std::sort(cores.begin(), cores.end());
+
+  return !cores.empty();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ThreadPlacement::parsePriority(const string& name, Priority& priority)
+{
+  if(BSPF::equalsIgnoreCase(name, "normal") || name.empty())
+    priority = Priority::normal;
+  else if(BSPF::equalsIgnoreCase(name, "high"))
+    priority = Priority::high;
+  else if(BSPF::equalsIgnoreCase(name, "realtime"))
+    priority = Priority::realtime;
+  else
+    return false;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ThreadPlacement::apply(const string& name) const
+{
+  if(isDefault())
+    return true;
+
+  const bool coresSet = setCores(myCores);
+  const bool prioritySet = setPriority(myPriority);
+
+  ostringstream buf;
+  if(!myCores.empty())
+  {
+    ThreadPlacement cores;
+    cores.myCores = myCores;
+    buf << cores.toString();
+    if(!coresSet) buf << (affinitySupported() ? " (denied)" : " (not supported)");
+  }
+  if(myPriority != Priority::normal)
+  {
+    ThreadPlacement priority;
+    priority.myPriority = myPriority;
+    buf << (myCores.empty() ? "" : ", ") << priority.toString();
+    if(!prioritySet) buf << " (denied)";
+  }
+
+  const string outcome = buf.str();
+  {
+    std::lock_guard<std::mutex> lock(placementMutex);
+
+    // Pool threads apply the same placement several times, log it once
+    string& previous = placements[name];
+    if(previous == outcome)
+      return coresSet && prioritySet;
+    previous = outcome;
+  }
+
+  if(coresSet && prioritySet)
+    Logger::info("Thread placement: " + name + ": " + outcome);
+  else
+    Logger::error("Thread placement: " + name + ": " + outcome);
+
+  return coresSet && prioritySet;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string ThreadPlacement::toString() const
+{
+  ostringstream buf;
+
+  if(!myCores.empty())
+  {
+    buf << (myCores.size() == 1 ? "core " : "cores ");
+
+    // Print consecutive cores as a range
+    for(size_t i = 0; i < myCores.size(); )
+    {
+      size_t j = i;
+      while(j + 1 < myCores.size() && myCores[j + 1] == myCores[j] + 1)
+        ++j;
+
+      buf << (i > 0 ? "," : "") << myCores[i];
+      if(j > i) buf << "-" << myCores[j];
+      i = j + 1;
+    }
+  }
+
+  if(myPriority != Priority::normal)
+    buf << (myCores.empty() ? "" : ", ")
+        << (myPriority == Priority::high ? "high" : "realtime") << " priority";
+
+  return myCores.empty() && myPriority == Priority::normal ? "default" : buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string ThreadPlacement::applied()
+{
+  std::lock_guard<std::mutex> lock(placementMutex);
+
+  if(placements.empty())
+    return "default";
+
+  ostringstream buf;
+  for(const auto& placement: placements)
+    buf << (buf.tellp() > 0 ? "; " : "") << placement.first << ": " << placement.second;
+
+  return buf.str();
+}
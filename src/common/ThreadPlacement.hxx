@@ -0,0 +1,97 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef THREAD_PLACEMENT_HXX
+#define THREAD_PLACEMENT_HXX
+
+class Settings;
+
+#include "bspf.hxx"
+
+/**
+  The cores a thread may run on, and its scheduling priority.  On CPUs
+  with cores of different speed (e.g. big.LITTLE), keeping the emulation,
+  the audio callback and the filter threads on the fast cores, at a raised
+  priority, makes the frame rate predictable.
+
+  Each kind of thread takes its placement from two settings, e.g.
+  'worker.core' (a list of cores such as "2,4-7", or -1 for any core) and
+  'worker.priority' (normal, high or realtime), and applies it to itself
+  when it starts.  What the OS refuses (e.g. realtime scheduling without
+  the rights for it) is left as it is, and reported.
+
+  Affinity is supported on Linux and Windows, priorities on Linux, Windows
+  and macOS.
+
+  @author  Stephen Anthony
+*/
+class ThreadPlacement
+{
+  public:
+    enum class Priority : uInt8 { normal, high, realtime };
+
+  public:
+    ThreadPlacement() : myPriority(Priority::normal) { }
+
+    /**
+      The placement given by the settings '<prefix>.core' and
+      '<prefix>.priority'; invalid settings are ignored.
+    */
+    static ThreadPlacement fromSettings(const Settings& settings, const string& prefix);
+
+    /**
+      Parse a list of cores ("-1" or "" for any core) or a priority.
+
+      @return  False if the string isn't valid
+    */
+    static bool parseCores(const string& spec, vector<uInt32>& cores);
+    static bool parsePriority(const string& name, Priority& priority);
+
+    /**
+      Answer whether the thread may run anywhere, at normal priority.
+    */
+    bool isDefault() const {
+      return myCores.empty() && myPriority == Priority::normal;
+    }
+
+    /**
+      Apply the placement to the calling thread, as far as the OS allows
+      it.  The outcome is logged and recorded under the given name (e.g.
+      "emulation"); a default placement changes and records nothing.
+
+      @return  False if any part of the placement wasn't applied
+    */
+    bool apply(const string& name) const;
+
+    /**
+      The placement as text, e.g. "cores 4-7, high priority".
+    */
+    string toString() const;
+
+    /**
+      The outcome of the placements applied so far, by name, e.g.
+      "emulation: cores 4-7, high priority; audio: realtime priority
+      (denied)".
+    */
+    static string applied();
+
+  private:
+    vector<uInt32> myCores;  // empty = any core
+    Priority myPriority;
+};
+
+#endif
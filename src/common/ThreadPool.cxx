@@ -0,0 +1,129 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "ThreadPool.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThreadPool::ThreadPool()
+  : myJob(nullptr),
+    myContext(nullptr),
+    myCount(0),
+    myNextJob(0),
+    myBusyWorkers(0),
+    myGeneration(0),
+    myQuit(false)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThreadPool::~ThreadPool()
+{
+  stop();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadPool::setThreads(uInt32 threads)
+{
+  threads = std::max(threads, 1u);
+  if(threads == this->threads())
+    return;
+
+  stop();
+
+  // Workers must only wait for frames started after this point, even if
+  // they only start running later
+  myQuit = false;
+  const uInt64 generation = myGeneration;
+  myWorkers.reserve(threads - 1);
+  for(uInt32 i = 1; i < threads; ++i)
+    myWorkers.emplace_back([this, generation] { workerLoop(generation); });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadPool::dispatch(uInt32 count, Job job, const void* context)
+{
+  if(myWorkers.empty() || count <= 1)
+  {
+    for(uInt32 i = 0; i < count; ++i)
+      job(context, i);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    myJob = job;
+    myContext = context;
+    myCount = count;
+    myNextJob = 0;
+    myBusyWorkers = uInt32(myWorkers.size());
+    ++myGeneration;
+  }
+  myWorkAvailable.notify_all();
+
+  // Make the calling thread busy too
+  runJobs();
+
+  // ...and wait for the workers to finish their last jobs
+  std::unique_lock<std::mutex> lock(myMutex);
+  myWorkDone.wait(lock, [this] { return myBusyWorkers == 0; });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadPool::runJobs()
+{
+  for(uInt32 i = myNextJob++; i < myCount; i = myNextJob++)
+    myJob(myContext, i);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadPool::workerLoop(uInt64 generation)
+{
+  myPlacement.apply(myPlacementName);
+
+  for(;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(myMutex);
+      myWorkAvailable.wait(lock, [&] { return myQuit || myGeneration != generation; });
+      if(myQuit)
+        return;
+
+      generation = myGeneration;
+    }
+
+    runJobs();
+
+    std::lock_guard<std::mutex> lock(myMutex);
+    if(--myBusyWorkers == 0)
+      myWorkDone.notify_one();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadPool::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myQuit = true;
+  }
+  myWorkAvailable.notify_all();
+
+  for(std::thread& worker: myWorkers)
+    worker.join();
+  myWorkers.clear();
+}
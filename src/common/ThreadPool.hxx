@@ -0,0 +1,117 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef THREAD_POOL_HXX
+#define THREAD_POOL_HXX
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "bspf.hxx"
+#include "ThreadPlacement.hxx"
+
+/**
+  A pool of long-lived worker threads for splitting per-frame work (the
+  NTSC filter, phosphor blending) across cores.  The workers are created
+  once and sleep between frames, so running a frame neither creates
+  threads nor allocates memory.
+
+  The work of a frame is a number of jobs, which are handed out one at a
+  time; threads which are less loaded simply take more of them.  The
+  calling thread takes part as well, and run() only returns after all
+  jobs are done.  run() must not be called by more than one thread at a
+  time.
+
+  @author  Stephen Anthony
+*/
+class ThreadPool
+{
+  public:
+    ThreadPool();
+    ~ThreadPool();
+
+    /**
+      Set the total number of threads used by run(), including the calling
+      thread.  A value of 1 (or 0) runs all jobs in the calling thread.
+    */
+    void setThreads(uInt32 threads);
+
+    /**
+      Set the cores and priority of the workers started from now on, and
+      the name their placement is reported under.
+    */
+    void setPlacement(const ThreadPlacement& placement, const string& name) {
+      myPlacement = placement;
+      myPlacementName = name;
+    }
+
+    /**
+      The total number of threads used by run().
+    */
+    uInt32 threads() const { return uInt32(myWorkers.size()) + 1; }
+
+    /**
+      Call 'job(i)' for each 'i' in 0 ... count-1, spread over all threads,
+      and wait for all of the calls to finish.
+    */
+    template<typename F>
+    void run(uInt32 count, const F& job) {
+      dispatch(count, [](const void* context, uInt32 i) {
+        (*static_cast<const F*>(context))(i);
+      }, &job);
+    }
+
+  private:
+    using Job = void (*)(const void* context, uInt32 i);
+
+    void dispatch(uInt32 count, Job job, const void* context);
+    void runJobs();
+    void workerLoop(uInt64 generation);
+    void stop();
+
+  private:
+    vector<std::thread> myWorkers;
+
+    std::mutex myMutex;
+    std::condition_variable myWorkAvailable, myWorkDone;
+
+    // The jobs of the current frame
+    Job myJob;
+    const void* myContext;
+    uInt32 myCount;
+    std::atomic<uInt32> myNextJob;
+
+    // Number of workers still busy with the current frame
+    uInt32 myBusyWorkers;
+    // Incremented for each frame, to wake up the workers
+    uInt64 myGeneration;
+    bool myQuit;
+
+    ThreadPlacement myPlacement;
+    string myPlacementName;
+
+  private:
+    // Following constructors and assignment operators not supported
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+};
+
+#endif
@@ -18,12 +18,19 @@
 #include <cassert>
 #include "TimerManager.hxx"
 
+constexpr uInt32 TimerManager::NONE;
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TimerManager::TimerManager()
   : nextId(no_timer + 1),
-    queue(),
+    scheduled(0),
+    scheduled0(0),
+    start(Clock::now()),
+    currentTick(0),
+    wakeTick(0),
     done(false)
 {
+  buckets.fill(NONE);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -61,17 +68,25 @@ TimerManager::TimerId TimerManager::addTimer(
   if (!worker.joinable())
     worker = std::thread(&TimerManager::timerThreadWorker, this);
 
-  // Assign an ID and insert it into function storage
-  auto id = nextId++;
-  auto iter = active.emplace(id, Timer(id, Clock::now() + Duration(msDelay),
-      Duration(msPeriod), std::move(func)));
+  // An empty wheel can simply be moved forward to the current time
+  const uInt64 tick = now();
+  if (scheduled == 0)
+    currentTick = std::max(currentTick, tick);
+
+  // Assign an ID and store the timer
+  const uInt32 index = allocTimer();
+  Timer& timer = timers[index];
+  timer.id = (nextId++ << 32) | index;
+  timer.expiry = tick + msDelay;
+  timer.period = msPeriod;
+  timer.handler = func;
 
-  // Insert a reference to the Timer into ordering queue
-  Queue::iterator place = queue.emplace(iter.first->second);
+  link(index);
 
-  // We need to notify the timer thread only if we inserted
-  // this timer into the front of the timer queue
-  bool needNotify = (place == queue.begin());
+  // We need to notify the timer thread only if it would sleep
+  // past the expiry of this timer
+  const bool needNotify = timer.expiry < wakeTick;
+  const TimerId id = timer.id;
 
   lock.unlock();
 
@@ -85,30 +100,30 @@ TimerManager::TimerId TimerManager::addTimer(
 bool TimerManager::clear(TimerId id)
 {
   ScopedLock lock(sync);
-  auto i = active.find(id);
-  return destroy_impl(lock, i, true);
+  return destroy_impl(lock, findTimer(id));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TimerManager::clear()
 {
   ScopedLock lock(sync);
-  while (!active.empty())
-    destroy_impl(lock, active.begin(), queue.size() == 1);
+  for (uInt32 index = 0; index < timers.size(); ++index)
+    if (timers[index].id != no_timer)
+      destroy_impl(lock, index);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 std::size_t TimerManager::size() const noexcept
 {
   ScopedLock lock(sync);
-  return active.size();
+  return timers.size() - freeTimers.size();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool TimerManager::empty() const noexcept
 {
   ScopedLock lock(sync);
-  return active.empty();
+  return timers.size() == freeTimers.size();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -125,80 +140,89 @@ void TimerManager::timerThreadWorker()
 
   while (!done)
   {
-    if (queue.empty())
+    if (scheduled == 0)
     {
       // Wait for done or work
-      wakeUp.wait(lock, [this] { return done || !queue.empty(); });
+      wakeTick = ~uInt64(0);
+      wakeUp.wait(lock, [this] { return done || scheduled > 0; });
+      wakeTick = 0;
       continue;
     }
 
-    auto queueHead = queue.begin();
-    Timer& timer = *queueHead;
-    auto now = Clock::now();
-    if (now >= timer.next)
+    const uInt64 tick = now();
+    if (currentTick > tick)
     {
-      queue.erase(queueHead);
+      // Wait until the next timer is due or a timer creation notifies
+      wakeTick = nextWakeTick();
+      wakeUp.wait_until(lock, start + Duration(wakeTick));
+      wakeTick = 0;
+      continue;
+    }
 
-      // Mark it as running to handle racing destroy
-      timer.running = true;
+    const uInt32 index = buckets[currentTick & (WHEEL_SIZE_0 - 1)];
+    if (index == NONE)
+    {
+      // Nothing due at this tick; if the first level is empty, we
+      // can skip right to the next turn
+      advanceTo(scheduled0 > 0 ? currentTick + 1 :
+                std::min(tick + 1, (currentTick | (WHEEL_SIZE_0 - 1)) + 1));
+      continue;
+    }
 
-      // Call the handler outside the lock
-      lock.unlock();
-      timer.handler();
-      lock.lock();
+    Timer& timer = timers[index];
+    unlink(index);
 
-      if (timer.running)
+    // Mark it as running to handle racing destroy
+    timer.running = true;
+
+    // Call the handler outside the lock
+    lock.unlock();
+    timer.handler();
+    lock.lock();
+
+    if (timer.running)
+    {
+      timer.running = false;
+
+      // If it is periodic, schedule it again
+      if (timer.period > 0)
       {
-        timer.running = false;
-
-        // If it is periodic, schedule a new one
-        if (timer.period.count() > 0)
-        {
-          timer.next = timer.next + timer.period;
-          queue.emplace(timer);
-        }
-        else
-        {
-          // Not rescheduling, destruct it
-          active.erase(timer.id);
-        }
+        timer.expiry += timer.period;
+        link(index);
       }
       else
       {
-        // timer.running changed!
-        //
-        // Running was set to false, destroy was called
-        // for this Timer while the callback was in progress
-        // (this thread was not holding the lock during the callback)
-        // The thread trying to destroy this timer is waiting on
-        // a condition variable, so notify it
-        timer.waitCond->notify_all();
-
-        // The clearTimer call expects us to remove the instance
-        // when it detects that it is racing with its callback
-        active.erase(timer.id);
+        // Not rescheduling, destruct it
+        freeTimer(index);
       }
     }
     else
     {
-      // Wait until the timer is ready or a timer creation notifies
-      Timestamp next = timer.next;
-      wakeUp.wait_until(lock, next);
+      // timer.running changed!
+      //
+      // Running was set to false, destroy was called
+      // for this Timer while the callback was in progress
+      // (this thread was not holding the lock during the callback)
+      // The thread trying to destroy this timer is waiting on
+      // a condition variable, so notify it
+      timer.waitCond->notify_all();
+
+      // The clearTimer call expects us to remove the instance
+      // when it detects that it is racing with its callback
+      freeTimer(index);
     }
   }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-// NOTE: if notify is true, returns with lock unlocked
-bool TimerManager::destroy_impl(ScopedLock& lock, TimerMap::iterator i,
-                                bool notify)
+bool TimerManager::destroy_impl(ScopedLock& lock, uInt32 index)
 {
   assert(lock.owns_lock());
 
-  if (i == active.end())
+  if (index == NONE)
     return false;
 
-  Timer& timer = i->second;
+  Timer& timer = timers[index];
   if (timer.running)
   {
     // A callback is in progress for this Timer,
@@ -214,47 +238,160 @@ bool TimerManager::destroy_impl(ScopedLock& lock, TimerMap::iterator i,
   }
   else
   {
-    queue.erase(timer);
-    active.erase(i);
-
-    if (notify)
-    {
-      lock.unlock();
-      wakeUp.notify_all();
-    }
+    // The worker doesn't need to be woken up; at worst, it looks at
+    // the wheel once more than necessary
+    unlink(index);
+    freeTimer(index);
   }
 
   return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-// TimerManager::Timer implementation
-//
+uInt64 TimerManager::now() const
+{
+  return std::chrono::duration_cast<Duration>(Clock::now() - start).count();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 TimerManager::allocTimer()
+{
+  if (freeTimers.empty())
+  {
+    timers.emplace_back();
+    return uInt32(timers.size() - 1);
+  }
+
+  const uInt32 index = freeTimers.back();
+  freeTimers.pop_back();
+
+  return index;
+}
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-TimerManager::Timer::Timer(TimerId tid)
-  : id(tid),
-    running(false)
+void TimerManager::freeTimer(uInt32 index)
 {
+  Timer& timer = timers[index];
+
+  timer.id = no_timer;
+  timer.handler = nullptr;
+  timer.waitCond.reset();
+
+  freeTimers.push_back(index);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-TimerManager::Timer::Timer(Timer&& r) noexcept
-  : id(std::move(r.id)),
-    next(std::move(r.next)),
-    period(std::move(r.period)),
-    handler(std::move(r.handler)),
-    running(std::move(r.running))
+uInt32 TimerManager::findTimer(TimerId id) const
 {
+  const uInt32 index = uInt32(id);
+
+  return (id != no_timer && index < timers.size() && timers[index].id == id)
+    ? index : NONE;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-TimerManager::Timer::Timer(TimerId tid, Timestamp tnext, Duration tperiod,
-                           const TFunction& func) noexcept
-  : id(tid),
-    next(tnext),
-    period(tperiod),
-    handler(std::move(func)),
-    running(false)
+void TimerManager::link(uInt32 index)
 {
+  Timer& timer = timers[index];
+
+  // Overdue timers are due at the current tick
+  uInt64 expiry = std::max(timer.expiry, currentTick);
+  const uInt64 delta = expiry - currentTick;
+  uInt32 bucket;
+
+  if (delta < WHEEL_SIZE_0)
+  {
+    bucket = uInt32(expiry & (WHEEL_SIZE_0 - 1));
+    ++scheduled0;
+  }
+  else
+  {
+    // Timers beyond the range of the wheel are parked in the last level,
+    // and are placed anew each time they are cascaded
+    constexpr uInt32 maxBits = WHEEL_BITS_0 + (WHEEL_LEVELS - 1) * WHEEL_BITS_N;
+    if (delta >> maxBits)
+      expiry = currentTick + (uInt64(1) << maxBits) - 1;
+
+    uInt32 level = 1, shift = WHEEL_BITS_0;
+    while ((expiry - currentTick) >> (shift + WHEEL_BITS_N))
+    {
+      ++level;
+      shift += WHEEL_BITS_N;
+    }
+    bucket = WHEEL_SIZE_0 + (level - 1) * WHEEL_SIZE_N +
+             uInt32((expiry >> shift) & (WHEEL_SIZE_N - 1));
+  }
+
+  timer.bucket = bucket;
+  timer.prev = NONE;
+  timer.next = buckets[bucket];
+  if (timer.next != NONE)
+    timers[timer.next].prev = index;
+  buckets[bucket] = index;
+
+  ++scheduled;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimerManager::unlink(uInt32 index)
+{
+  Timer& timer = timers[index];
+
+  if (timer.bucket == NONE)
+    return;
+
+  if (timer.prev != NONE)
+    timers[timer.prev].next = timer.next;
+  else
+    buckets[timer.bucket] = timer.next;
+  if (timer.next != NONE)
+    timers[timer.next].prev = timer.prev;
+
+  if (timer.bucket < WHEEL_SIZE_0)
+    --scheduled0;
+  --scheduled;
+
+  timer.bucket = timer.prev = timer.next = NONE;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimerManager::advanceTo(uInt64 tick)
+{
+  currentTick = tick;
+
+  // When a level completes a turn, the next bucket of the level above is
+  // distributed into the lower levels
+  uInt32 shift = WHEEL_BITS_0;
+  for (uInt32 level = 1; level < WHEEL_LEVELS; ++level)
+  {
+    if (tick & ((uInt64(1) << shift) - 1))
+      break;
+
+    const uInt32 bucket = WHEEL_SIZE_0 + (level - 1) * WHEEL_SIZE_N +
+                          uInt32((tick >> shift) & (WHEEL_SIZE_N - 1));
+    uInt32 index = buckets[bucket];
+    while (index != NONE)
+    {
+      const uInt32 next = timers[index].next;
+      unlink(index);
+      link(index);
+      index = next;
+    }
+    shift += WHEEL_BITS_N;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 TimerManager::nextWakeTick() const
+{
+  // Either the next non-empty bucket of the first level, or the end of its
+  // turn, when the next level must be cascaded
+  const uInt64 turnEnd = (currentTick | (WHEEL_SIZE_0 - 1)) + 1;
+
+  if (scheduled0 > 0)
+    for (uInt64 tick = currentTick; tick < turnEnd; ++tick)
+      if (buckets[tick & (WHEEL_SIZE_0 - 1)] != NONE)
+        return tick;
+
+  return turnEnd;
 }
@@ -21,8 +21,8 @@
 #include <algorithm>
 #include <functional>
 #include <chrono>
-#include <unordered_map>
-#include <set>
+#include <deque>
+#include <array>
 #include <cstdint>
 #include <thread>
 #include <mutex>
@@ -144,54 +144,79 @@ class TimerManager
     using Timestamp = std::chrono::time_point<Clock>;
     using Duration = std::chrono::milliseconds;
 
+    // Timers are kept in a hierarchical timing wheel with a resolution of
+    // one millisecond: the first level has a bucket for each of the next
+    // 256 ticks, and each further level has 64 buckets, each covering a full
+    // turn of the level below.  Whenever a level completes a turn, the next
+    // bucket of the level above is redistributed ('cascaded') into it.
+    static constexpr uInt32 WHEEL_BITS_0 = 8;
+    static constexpr uInt32 WHEEL_BITS_N = 6;
+    static constexpr uInt32 WHEEL_LEVELS = 4;
+    static constexpr uInt32 WHEEL_SIZE_0 = 1 << WHEEL_BITS_0;
+    static constexpr uInt32 WHEEL_SIZE_N = 1 << WHEEL_BITS_N;
+    static constexpr uInt32 NUM_BUCKETS =
+        WHEEL_SIZE_0 + (WHEEL_LEVELS - 1) * WHEEL_SIZE_N;
+
+    // Marks the end of a bucket list, or a timer which isn't in any bucket
+    static constexpr uInt32 NONE = ~0U;
+
     struct Timer
     {
-      explicit Timer(TimerId id = 0);
-      Timer(Timer&& r) noexcept;
-      Timer& operator=(Timer&& r) noexcept;
-
-      Timer(TimerId id, Timestamp next, Duration period, const TFunction& func) noexcept;
-
-      // Never called
-      Timer(Timer const& r) = delete;
-      Timer& operator=(Timer const& r) = delete;
-
-      TimerId id;
-      Timestamp next;
-      Duration period;
+      TimerId id{no_timer};
+      uInt64 expiry{0};  // in ticks
+      uInt64 period{0};  // in ticks
       TFunction handler;
 
       // You must be holding the 'sync' lock to assign waitCond
       std::unique_ptr<ConditionVar> waitCond;
 
-      bool running;
-    };
+      bool running{false};
 
-    // Comparison functor to sort the timer "queue" by Timer::next
-    struct NextActiveComparator
-    {
-      bool operator()(Timer const& a, Timer const& b) const noexcept
-      {
-        return a.next < b.next;
-      }
+      // Links within the bucket this timer is in
+      uInt32 bucket{NONE}, prev{NONE}, next{NONE};
     };
 
-    // Queue is a set of references to Timer objects, sorted by next
-    using QueueValue = std::reference_wrapper<Timer>;
-    using Queue = std::multiset<QueueValue, NextActiveComparator>;
-    using TimerMap = std::unordered_map<TimerId, Timer>;
-
     void timerThreadWorker();
-    bool destroy_impl(ScopedLock& lock, TimerMap::iterator i, bool notify);
+    bool destroy_impl(ScopedLock& lock, uInt32 index);
 
-    // Inexhaustible source of unique IDs
+    // Number of ticks elapsed since this object was created
+    uInt64 now() const;
+
+    // Timer storage; slots are reused, so that no allocation is needed
+    // after a while
+    uInt32 allocTimer();
+    void freeTimer(uInt32 index);
+    uInt32 findTimer(TimerId id) const;
+
+    // Put the timer into the bucket for its expiry, or take it out again
+    void link(uInt32 index);
+    void unlink(uInt32 index);
+
+    // Advance the wheel to the given tick, cascading the higher levels
+    // when a turn is completed
+    void advanceTo(uInt64 tick);
+
+    // Tick at which the worker must look at the wheel again
+    uInt64 nextWakeTick() const;
+
+    // Source of unique IDs; the lower bits of an ID are the slot index
     TimerId nextId;
 
-    // The Timer objects are physically stored in this map
-    TimerMap active;
+    // The Timer objects are physically stored here; a deque never moves
+    // its elements, so a running handler is not affected by new timers
+    std::deque<Timer> timers;
+    vector<uInt32> freeTimers;
+
+    // The first timer in each bucket of the wheel
+    std::array<uInt32, NUM_BUCKETS> buckets;
+
+    // Number of timers in the wheel, and in its first level
+    uInt32 scheduled, scheduled0;
 
-    // The ordering queue holds references to items in 'active'
-    Queue queue;
+    // The next tick to be processed, and the tick the worker sleeps until
+    Timestamp start;
+    uInt64 currentTick;
+    uInt64 wakeTick;
 
     // One worker thread for an unlimited number of timers is acceptable
     // Lazily started when first timer is started
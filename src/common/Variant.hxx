@@ -18,13 +18,18 @@
 #ifndef VARIANT_HXX
 #define VARIANT_HXX
 
+#include <cstdlib>
+
 #include "Rect.hxx"
 #include "bspf.hxx"
 
 /**
   This class implements a very simple variant type, which is convertible
   to several other types.  It stores the actual data as a string, and
-  converts to other types as required.  Eventually, this class may be
+  converts to other types as required.  Numeric values are parsed once,
+  when the value is set, since settings and properties are read far more
+  often than they are written (and from several threads at once, so
+  reading must not modify anything).  Eventually, this class may be
   extended to use templates and become a more full-featured variant type.
 
   @author  Stephen Anthony
@@ -35,43 +40,50 @@ class Variant
     // Underlying data store is (currently) always a string
     string data;
 
+    // The parsed numeric values
+    Int32 myInt{0};
+    float myFloat{0};
+
     // Use singleton so we use only one ostringstream object
     inline ostringstream& buf() {
       static ostringstream buf;
       return buf;
     }
 
+    // Parse the numeric values; plain integers (the most common case)
+    // don't need a stream
+    void parse() {
+      char* end;
+      const Int64 i = std::strtoll(data.c_str(), &end, 10);
+      myInt = Int32(BSPF::clamp(i, Int64(INT32_MIN), Int64(INT32_MAX)));
+      if(*end == '\0')
+        myFloat = float(i);
+      else
+      {
+        istringstream ss(data);
+        ss >> myFloat;
+      }
+    }
+
   public:
     Variant() { }
 
-    Variant(const string& s) : data(s) { }
-    Variant(const char* s) : data(s) { }
+    Variant(const string& s) : data(s) { parse(); }
+    Variant(const char* s) : data(s) { parse(); }
 
-    Variant(Int32 i)  { buf().str(""); buf() << i; data = buf().str(); }
-    Variant(uInt32 i) { buf().str(""); buf() << i; data = buf().str(); }
-    Variant(float f)  { buf().str(""); buf() << f; data = buf().str(); }
-    Variant(double d) { buf().str(""); buf() << d; data = buf().str(); }
-    Variant(bool b)   { buf().str(""); buf() << b; data = buf().str(); }
-    Variant(const Common::Size& s) { buf().str(""); buf() << s; data = buf().str(); }
-    Variant(const Common::Point& s) { buf().str(""); buf() << s; data = buf().str(); }
+    Variant(Int32 i)  : data(std::to_string(i)), myInt(i), myFloat(float(i)) { }
+    Variant(uInt32 i) : data(std::to_string(i)) { parse(); }
+    Variant(float f)  { buf().str(""); buf() << f; data = buf().str(); parse(); }
+    Variant(double d) { buf().str(""); buf() << d; data = buf().str(); parse(); }
+    Variant(bool b)   : data(b ? "1" : "0"), myInt(b), myFloat(b) { }
+    Variant(const Common::Size& s) { buf().str(""); buf() << s; data = buf().str(); parse(); }
+    Variant(const Common::Point& s) { buf().str(""); buf() << s; data = buf().str(); parse(); }
 
     // Conversion methods
     const string& toString() const { return data; }
     const char* toCString() const { return data.c_str(); }
-    Int32 toInt() const {
-      istringstream ss(data);
-      Int32 parsed;
-      ss >> parsed;
-
-      return parsed;
-    }
-    float toFloat() const {
-      istringstream ss(data);
-      float parsed;
-      ss >> parsed;
-
-      return parsed;
-    }
+    Int32 toInt() const { return myInt; }
+    float toFloat() const { return myFloat; }
     bool toBool() const         { return data == "1" || data == "true"; }
     Common::Size toSize() const { return Common::Size(data); }
     Common::Point toPoint() const { return Common::Point(data); }
@@ -0,0 +1,126 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "AudioQueue.hxx"
+#include "WavFileSink.hxx"
+
+namespace {
+  void putLE(uInt8*& p, uInt32 value, uInt32 bytes)
+  {
+    for(uInt32 i = 0; i < bytes; ++i, value >>= 8)
+      *p++ = uInt8(value);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+WavFileSink::WavFileSink()
+  : mySampleRate(0),
+    myChannels(1),
+    mySamples(0),
+    myCurrentFragment(nullptr)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+WavFileSink::~WavFileSink()
+{
+  close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool WavFileSink::open(const string& filename, uInt32 sampleRate, bool stereo)
+{
+  close();
+
+  myFile.open(filename, std::ios::binary | std::ios::trunc);
+  if(!myFile)
+    return false;
+
+  mySampleRate = sampleRate;
+  myChannels = stereo ? 2 : 1;
+  mySamples = 0;
+  myCurrentFragment = nullptr;
+
+  // The sizes are filled in once the file is closed
+  writeHeader(0);
+
+  return bool(myFile);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool WavFileSink::drain(AudioQueue& queue)
+{
+  if(!myFile.is_open())
+    return false;
+
+  const uInt32 samples = queue.fragmentSize() * myChannels;
+  myBuffer.resize(samples * 2);
+
+  while(Int16* fragment = queue.dequeue(myCurrentFragment))
+  {
+    myCurrentFragment = fragment;
+
+    uInt8* p = myBuffer.data();
+    for(uInt32 i = 0; i < samples; ++i)
+      putLE(p, uInt16(fragment[i]), 2);
+
+    myFile.write(reinterpret_cast<const char*>(myBuffer.data()), myBuffer.size());
+    mySamples += queue.fragmentSize();
+  }
+
+  return bool(myFile);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void WavFileSink::close(AudioQueue* queue)
+{
+  if(queue)
+    queue->closeSink(myCurrentFragment);
+  myCurrentFragment = nullptr;
+
+  if(!myFile.is_open())
+    return;
+
+  // WAV files are limited to 4GB
+  const uInt64 dataSize = mySamples * myChannels * 2;
+
+  myFile.seekp(0);
+  writeHeader(uInt32(std::min(dataSize, uInt64(0xffffffff - 36))));
+  myFile.close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void WavFileSink::writeHeader(uInt32 dataSize)
+{
+  uInt8 header[44];
+  uInt8* p = header;
+
+  std::copy_n("RIFF", 4, p);  p += 4;
+  putLE(p, 36 + dataSize, 4);
+  std::copy_n("WAVEfmt ", 8, p);  p += 8;
+  putLE(p, 16, 4);                             // format chunk size
+  putLE(p, 1, 2);                              // PCM
+  putLE(p, myChannels, 2);
+  putLE(p, mySampleRate, 4);
+  putLE(p, mySampleRate * myChannels * 2, 4);  // bytes per second
+  putLE(p, myChannels * 2, 2);                 // bytes per sample frame
+  putLE(p, 16, 2);                             // bits per sample
+  std::copy_n("data", 4, p);  p += 4;
+  putLE(p, dataSize, 4);
+
+  myFile.write(reinterpret_cast<const char*>(header), sizeof(header));
+}
@@ -0,0 +1,96 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef WAV_FILE_SINK_HXX
+#define WAV_FILE_SINK_HXX
+
+class AudioQueue;
+
+#include <fstream>
+
+#include "bspf.hxx"
+
+/**
+  A headless audio sink, which streams the fragments of an audio queue to
+  a WAV file (16 bit PCM).  In contrast to a sound driver, it does not pace
+  the emulation; the queue is drained whenever drain() is called, so audio
+  can be rendered as fast as it is emulated.
+
+  @author  Stephen Anthony
+*/
+class WavFileSink
+{
+  public:
+    WavFileSink();
+    ~WavFileSink();
+
+    /**
+      Create the given file and write the WAV header.
+
+      @param filename    The file to write
+      @param sampleRate  The sample rate of the audio queue
+      @param stereo      Whether the audio queue contains stereo samples
+      @return  True on success
+    */
+    bool open(const string& filename, uInt32 sampleRate, bool stereo);
+
+    /**
+      Write all fragments currently queued.
+
+      @param queue  The queue to drain
+      @return  False if writing to the file failed
+    */
+    bool drain(AudioQueue& queue);
+
+    /**
+      Finalize the sizes in the WAV header and close the file.  The played
+      fragment is returned to the given queue, if any.
+
+      @param queue  The queue drained (or nullptr)
+    */
+    void close(AudioQueue* queue = nullptr);
+
+    /**
+      The number of samples (per channel) written so far.
+    */
+    uInt64 samples() const { return mySamples; }
+
+  private:
+    void writeHeader(uInt32 dataSize);
+
+  private:
+    std::ofstream myFile;
+
+    uInt32 mySampleRate;
+    uInt16 myChannels;
+    uInt64 mySamples;
+
+    // The fragment returned to the queue on the next dequeue
+    Int16* myCurrentFragment;
+
+    // Conversion buffer for little endian samples
+    ByteArray myBuffer;
+
+  private:
+    // Following constructors and assignment operators not supported
+    WavFileSink(const WavFileSink&) = delete;
+    WavFileSink(WavFileSink&&) = delete;
+    WavFileSink& operator=(const WavFileSink&) = delete;
+    WavFileSink& operator=(WavFileSink&&) = delete;
+};
+
+#endif
@@ -15,32 +15,105 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+  #include <xmmintrin.h>
+  #define CONVOLUTION_SSE
+#elif defined(__ARM_NEON)
+  #include <arm_neon.h>
+  #define CONVOLUTION_NEON
+#endif
+
 #include "ConvolutionBuffer.hxx"
 
+namespace {
+  // Number of floats processed per SIMD operation
+  constexpr uInt32 LANES = 4;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-ConvolutionBuffer::ConvolutionBuffer(uInt32 size)
+ConvolutionBuffer::ConvolutionBuffer(uInt32 size, uInt32 channels)
   : myFirstIndex(0),
-    mySize(size)
+    mySize(size),
+    myChannels(channels),
+    myStride(kernelStride(size, channels))
+{
+  // Two copies of the window, plus the padding read beyond the second one
+  const uInt32 length = 2 * mySize * myChannels + LANES;
+
+  myData = make_unique<float[]>(length);
+  memset(myData.get(), 0, length * sizeof(float));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 ConvolutionBuffer::kernelStride(uInt32 size, uInt32 channels)
 {
-  myData = make_unique<float[]>(mySize);
-  memset(myData.get(), 0, mySize * sizeof(float));
+  return (size * channels + LANES - 1) / LANES * LANES;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ConvolutionBuffer::shift(float nextValue)
 {
-  myData[myFirstIndex] = nextValue;
+  myData[myFirstIndex] = myData[myFirstIndex + mySize] = nextValue;
+  myFirstIndex = (myFirstIndex + 1) % mySize;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConvolutionBuffer::shift(float nextValueL, float nextValueR)
+{
+  float* data = myData.get() + 2 * myFirstIndex;
+
+  data[0] = data[2 * mySize] = nextValueL;
+  data[1] = data[2 * mySize + 1] = nextValueR;
   myFirstIndex = (myFirstIndex + 1) % mySize;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-float ConvolutionBuffer::convoluteWith(float* kernel) const
+float ConvolutionBuffer::convoluteWith(const float* kernel) const
 {
-  float result = 0.;
+  float lanes[LANES];
+  convoluteLanes(kernel, lanes);
+
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConvolutionBuffer::convoluteWith(const float* kernel, float& resultL, float& resultR) const
+{
+  float lanes[LANES];
+  convoluteLanes(kernel, lanes);
+
+  // Even lanes hold the left, odd lanes the right channel
+  resultL = lanes[0] + lanes[2];
+  resultR = lanes[1] + lanes[3];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConvolutionBuffer::convoluteLanes(const float* kernel, float* lanes) const
+{
+  // The padding of the kernel is zero, so whatever is read beyond the
+  // window does not contribute
+  const float* data = myData.get() + myChannels * myFirstIndex;
+
+#if defined(CONVOLUTION_SSE)
+  __m128 sum = _mm_setzero_ps();
+
+  for (uInt32 i = 0; i < myStride; i += LANES)
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(kernel + i), _mm_loadu_ps(data + i)));
+
+  _mm_storeu_ps(lanes, sum);
+#elif defined(CONVOLUTION_NEON)
+  float32x4_t sum = vdupq_n_f32(0.f);
+
+  for (uInt32 i = 0; i < myStride; i += LANES)
+    sum = vmlaq_f32(sum, vld1q_f32(kernel + i), vld1q_f32(data + i));
 
-  for (uInt32 i = 0; i < mySize; ++i) {
-    result += kernel[i] * myData[(myFirstIndex + i) % mySize];
-  }
+  vst1q_f32(lanes, sum);
+#else
+  for (uInt32 j = 0; j < LANES; ++j)
+    lanes[j] = 0.f;
 
-  return result;
+  for (uInt32 i = 0; i < myStride; i += LANES)
+    for (uInt32 j = 0; j < LANES; ++j)
+      lanes[j] += kernel[i + j] * data[i + j];
+#endif
 }
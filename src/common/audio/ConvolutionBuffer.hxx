@@ -20,15 +20,37 @@
 
 #include "bspf.hxx"
 
+/**
+  A ring buffer of the last 'size' samples of one or two (interleaved)
+  channels, convoluted with a kernel using SIMD instructions where available.
+
+  Every sample is stored twice, so the window always is a contiguous block
+  of memory; kernels are laid out like the window (one coefficient per tap
+  and channel) and are padded with zeros to kernelStride() floats.
+*/
 class ConvolutionBuffer
 {
   public:
 
-    explicit ConvolutionBuffer(uInt32 size);
+    explicit ConvolutionBuffer(uInt32 size, uInt32 channels = 1);
+
+    /**
+      The number of floats occupied by a kernel for the given buffer geometry
+      (a multiple of the SIMD vector width).
+     */
+    static uInt32 kernelStride(uInt32 size, uInt32 channels);
 
     void shift(float nextValue);
 
-    float convoluteWith(float* kernel) const;
+    void shift(float nextValueL, float nextValueR);
+
+    float convoluteWith(const float* kernel) const;
+
+    void convoluteWith(const float* kernel, float& resultL, float& resultR) const;
+
+  private:
+
+    void convoluteLanes(const float* kernel, float* lanes) const;
 
   private:
 
@@ -38,6 +60,10 @@ class ConvolutionBuffer
 
     uInt32 mySize;
 
+    uInt32 myChannels;
+
+    uInt32 myStride;
+
   private:
 
     ConvolutionBuffer() = delete;
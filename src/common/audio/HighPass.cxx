@@ -36,3 +36,49 @@ float HighPass::apply(float valueIn)
 
   return valueOut;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void HighPass::apply(const Int16* in, float* out, uInt32 count, float scale)
+{
+  float lastIn = myLastValueIn, lastOut = myLastValueOut;
+
+  for(uInt32 i = 0; i < count; ++i)
+  {
+    const float valueIn = in[i] * scale;
+
+    lastOut = myAlpha * (lastOut + valueIn - lastIn);
+    lastIn = valueIn;
+    out[i] = lastOut;
+  }
+
+  myLastValueIn = lastIn;
+  myLastValueOut = lastOut;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void HighPass::applyStereo(HighPass& left, HighPass& right,
+                           const Int16* in, float* out, uInt32 count, float scale)
+{
+  // Each channel depends on its previous sample only, so the two channels
+  // are independent chains of operations which the CPU overlaps
+  float lastInL = left.myLastValueIn, lastOutL = left.myLastValueOut;
+  float lastInR = right.myLastValueIn, lastOutR = right.myLastValueOut;
+  const float alphaL = left.myAlpha, alphaR = right.myAlpha;
+
+  for(uInt32 i = 0; i < 2 * count; i += 2)
+  {
+    const float valueInL = in[i] * scale, valueInR = in[i + 1] * scale;
+
+    lastOutL = alphaL * (lastOutL + valueInL - lastInL);
+    lastOutR = alphaR * (lastOutR + valueInR - lastInR);
+    lastInL = valueInL;
+    lastInR = valueInR;
+    out[i] = lastOutL;
+    out[i + 1] = lastOutR;
+  }
+
+  left.myLastValueIn = lastInL;
+  left.myLastValueOut = lastOutL;
+  right.myLastValueIn = lastInR;
+  right.myLastValueOut = lastOutR;
+}
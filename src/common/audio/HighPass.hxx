@@ -18,6 +18,8 @@
 #ifndef HIGH_PASS_HXX
 #define HIGH_PASS_HXX
 
+#include "bspf.hxx"
+
 class HighPass
 {
   public:
@@ -26,6 +28,19 @@ class HighPass
 
     float apply(float value);
 
+    /**
+      Convert 'count' 16-bit samples to float, scaled by 'scale', and
+      filter them, in one pass.
+     */
+    void apply(const Int16* in, float* out, uInt32 count, float scale);
+
+    /**
+      The same for 'count' interleaved stereo samples, with separate
+      filters for the two channels; both are filtered in the same pass.
+     */
+    static void applyStereo(HighPass& left, HighPass& right,
+                            const Int16* in, float* out, uInt32 count, float scale);
+
   private:
 
     float myLastValueIn;
@@ -71,7 +71,9 @@ LanczosResampler::LanczosResampler(
   // -> we find N from fully reducing the fraction.
   myPrecomputedKernelCount(reducedDenominator(formatFrom.sampleRate, formatTo.sampleRate)),
   myKernelSize(2 * kernelParameter),
-  myCurrentKernelIndex(0),
+  // Stereo samples are convoluted in one pass, with the kernel coefficients
+  // duplicated for the interleaved channels
+  myKernelStride(ConvolutionBuffer::kernelStride(myKernelSize, formatFrom.stereo ? 2 : 1)),
   myKernelParameter(kernelParameter),
   myCurrentFragment(nullptr),
   myFragmentIndex(0),
@@ -81,15 +83,11 @@ LanczosResampler::LanczosResampler(
   myHighPass(HIGH_PASS_CUT_OFF, float(formatFrom.sampleRate)),
   myTimeIndex(0)
 {
-  myPrecomputedKernels = make_unique<float[]>(myPrecomputedKernelCount * myKernelSize);
+  myPrecomputedKernels = make_unique<float[]>(myPrecomputedKernelCount * myKernelStride);
+  memset(myPrecomputedKernels.get(), 0, myPrecomputedKernelCount * myKernelStride * sizeof(float));
 
-  if (myFormatFrom.stereo)
-  {
-    myBufferL = make_unique<ConvolutionBuffer>(myKernelSize);
-    myBufferR = make_unique<ConvolutionBuffer>(myKernelSize);
-  }
-  else
-    myBuffer = make_unique<ConvolutionBuffer>(myKernelSize);
+  myBuffer = make_unique<ConvolutionBuffer>(myKernelSize, myFormatFrom.stereo ? 2 : 1);
+  myFilteredFragment = make_unique<float[]>(myFormatFrom.fragmentSize * (myFormatFrom.stereo ? 2 : 1));
 
   precomputeKernels();
 }
@@ -98,32 +96,30 @@ LanczosResampler::LanczosResampler(
 void LanczosResampler::precomputeKernels()
 {
   // timeIndex = time * formatFrom.sampleRate * formatTo.sampleRAte
-  uInt32 timeIndex = 0;
+  //
+  // By construction, we limit the argument during kernel evaluation to 0 .. 1, which
+  // corresponds to 0 .. 1 / formatFrom.sampleRate for time. Stepping time by
+  // 1 / formatTo.sampleRate, timeIndex (modulo formatTo.sampleRate) visits all multiples of
+  // formatTo.sampleRate / myPrecomputedKernelCount, and the kernels are stored in that order.
+  const uInt32 timeIndexStep = myFormatTo.sampleRate / myPrecomputedKernelCount;
 
   for (uInt32 i = 0; i < myPrecomputedKernelCount; ++i) {
-    float* kernel = myPrecomputedKernels.get() + myKernelSize * i;
+    float* kernel = myPrecomputedKernels.get() + myKernelStride * i;
+    const uInt32 timeIndex = i * timeIndexStep;
     // The kernel is normalized such to be evaluate on time * formatFrom.sampleRate
     float center =
       static_cast<float>(timeIndex) / static_cast<float>(myFormatTo.sampleRate);
 
     for (uInt32 j = 0; j < 2 * myKernelParameter; ++j) {
-      kernel[j] = lanczosKernel(
+      const float value = lanczosKernel(
           center - static_cast<float>(j) + static_cast<float>(myKernelParameter) - 1.f, myKernelParameter
         ) * CLIPPING_FACTOR;
-    }
 
-    // Next step: time += 1 / formatTo.sampleRate
-    //
-    // By construction, we limit the argument during kernel evaluation to 0 .. 1, which
-    // corresponds to 0 .. 1 / formatFrom.sampleRate for time. To implement this, we decompose
-    // time as follows:
-    //
-    // time = N / formatFrom.sampleRate + delta
-    // timeIndex = N * formatTo.sampleRate + delta * formatTo.sampleRate * formatFrom.sampleRate
-    //
-    // with N integral and delta < 0. From this, it follows that we replace
-    // time with delta, i.e. take the modulus of timeIndex.
-    timeIndex = (timeIndex + myFormatFrom.sampleRate) % myFormatTo.sampleRate;
+      if (myFormatFrom.stereo)
+        kernel[2*j] = kernel[2*j + 1] = value;
+      else
+        kernel[j] = value;
+    }
   }
 }
 
@@ -137,6 +133,7 @@ void LanczosResampler::fillFragment(float* fragment, uInt32 length)
       myCurrentFragment = nextFragment;
       myFragmentIndex = 0;
       myIsUnderrun = false;
+      filterFragment();
     }
   }
 
@@ -148,12 +145,15 @@ void LanczosResampler::fillFragment(float* fragment, uInt32 length)
   const uInt32 outputSamples = myFormatTo.stereo ? (length >> 1) : length;
 
   for (uInt32 i = 0; i < outputSamples; ++i) {
-    float* kernel = myPrecomputedKernels.get() + (myCurrentKernelIndex * myKernelSize);
-    myCurrentKernelIndex = (myCurrentKernelIndex + 1) % myPrecomputedKernelCount;
+    // Exact unless the rate is adjusted; the closest earlier kernel is used then
+    const uInt32 kernelIndex = static_cast<uInt32>(
+      uInt64(myTimeIndex) * myPrecomputedKernelCount / myFormatTo.sampleRate
+    );
+    const float* kernel = myPrecomputedKernels.get() + (kernelIndex * myKernelStride);
 
     if (myFormatFrom.stereo) {
-      float sampleL = myBufferL->convoluteWith(kernel);
-      float sampleR = myBufferR->convoluteWith(kernel);
+      float sampleL, sampleR;
+      myBuffer->convoluteWith(kernel, sampleL, sampleR);
 
       if (myFormatTo.stereo) {
         fragment[2*i] = sampleL;
@@ -170,7 +170,7 @@ void LanczosResampler::fillFragment(float* fragment, uInt32 length)
         fragment[i] = sample;
     }
 
-    myTimeIndex += myFormatFrom.sampleRate;
+    myTimeIndex += myInputRate;
 
     uInt32 samplesToShift = myTimeIndex / myFormatTo.sampleRate;
     if (samplesToShift == 0) continue;
@@ -184,12 +184,10 @@ void LanczosResampler::fillFragment(float* fragment, uInt32 length)
 inline void LanczosResampler::shiftSamples(uInt32 samplesToShift)
 {
   while (samplesToShift-- > 0) {
-    if (myFormatFrom.stereo) {
-      myBufferL->shift(myHighPassL.apply(myCurrentFragment[2*myFragmentIndex] / static_cast<float>(0x7fff)));
-      myBufferR->shift(myHighPassR.apply(myCurrentFragment[2*myFragmentIndex + 1] / static_cast<float>(0x7fff)));
-    }
+    if (myFormatFrom.stereo)
+      myBuffer->shift(myFilteredFragment[2*myFragmentIndex], myFilteredFragment[2*myFragmentIndex + 1]);
     else
-      myBuffer->shift(myHighPass.apply(myCurrentFragment[myFragmentIndex] / static_cast<float>(0x7fff)));
+      myBuffer->shift(myFilteredFragment[myFragmentIndex]);
 
     ++myFragmentIndex;
 
@@ -204,6 +202,22 @@ inline void LanczosResampler::shiftSamples(uInt32 samplesToShift)
         myUnderrunLogger.log();
         myIsUnderrun = true;
       }
+
+      // On underrun, the last fragment is played (and filtered) again
+      filterFragment();
     }
   }
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void LanczosResampler::filterFragment()
+{
+  const float scale = myVolume / static_cast<float>(0x7fff);
+
+  if (myFormatFrom.stereo)
+    HighPass::applyStereo(myHighPassL, myHighPassR, myCurrentFragment,
+                          myFilteredFragment.get(), myFormatFrom.fragmentSize, scale);
+  else
+    myHighPass.apply(myCurrentFragment, myFilteredFragment.get(),
+                     myFormatFrom.fragmentSize, scale);
+}
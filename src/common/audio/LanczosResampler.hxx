@@ -41,20 +41,24 @@ class LanczosResampler : public Resampler
 
     void shiftSamples(uInt32 samplesToShift);
 
+    /**
+      Convert and high-pass filter the current fragment as a whole.
+     */
+    void filterFragment();
+
   private:
 
     uInt32 myPrecomputedKernelCount;
     uInt32 myKernelSize;
-    uInt32 myCurrentKernelIndex;
+    uInt32 myKernelStride;
     unique_ptr<float[]> myPrecomputedKernels;
 
     uInt32 myKernelParameter;
 
     unique_ptr<ConvolutionBuffer> myBuffer;
-    unique_ptr<ConvolutionBuffer> myBufferL;
-    unique_ptr<ConvolutionBuffer> myBufferR;
 
     Int16* myCurrentFragment;
+    unique_ptr<float[]> myFilteredFragment;
     uInt32 myFragmentIndex;
     bool myIsUnderrun;
 
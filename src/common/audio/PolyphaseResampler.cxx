@@ -0,0 +1,241 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include <cmath>
+
+#include "PolyphaseResampler.hxx"
+
+namespace {
+
+  constexpr float CLIPPING_FACTOR = 0.75;
+  constexpr float HIGH_PASS_CUT_OFF = 10;
+
+  // The cut-off of the low-pass, relative to the lower of the two sample
+  // rates, and the shape of the window.  With four taps, this suppresses
+  // the images by more than 50 dB (Lanczos with a = 2: less than 40 dB).
+  constexpr double CUT_OFF = 0.8;
+  constexpr double KAISER_BETA = 5;
+
+  // Upper limit for the number of precomputed kernels
+  constexpr uInt32 MAX_PHASES = 1024;
+
+  uInt32 reducedDenominator(uInt32 n, uInt32 d)
+  {
+    for (uInt32 i = std::min(n ,d); i > 1; --i) {
+      if ((n % i == 0) && (d % i == 0)) {
+        n /= i;
+        d /= i;
+        i = std::min(n ,d);
+      }
+    }
+
+    return d;
+  }
+
+  double sinc(double x)
+  {
+    return x == 0. ? 1 : sin(BSPF::PI_d * x) / BSPF::PI_d / x;
+  }
+
+  // Modified Bessel function of the first kind, order 0
+  double besselI0(double x)
+  {
+    double sum = 1, term = 1;
+
+    for (uInt32 k = 1; term > 1e-12 * sum; ++k) {
+      term *= (x / (2 * k)) * (x / (2 * k));
+      sum += term;
+    }
+
+    return sum;
+  }
+
+  // A windowed sinc with the given cut-off (in units of the input Nyquist
+  // frequency), spanning 'halfWidth' input samples on either side
+  double kaiserKernel(double x, double halfWidth, double cutOff)
+  {
+    const double t = x / halfWidth;
+    if (t <= -1 || t >= 1) return 0;
+
+    return cutOff * sinc(cutOff * x) *
+      besselI0(KAISER_BETA * sqrt(1 - t * t)) / besselI0(KAISER_BETA);
+  }
+
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PolyphaseResampler::PolyphaseResampler(
+  Resampler::Format formatFrom,
+  Resampler::Format formatTo,
+  Resampler::NextFragmentCallback nextFragmentCallback,
+  uInt32 taps)
+:
+  Resampler(formatFrom, formatTo, nextFragmentCallback),
+  myTaps(taps),
+  myPhaseCount(std::min(reducedDenominator(formatFrom.sampleRate, formatTo.sampleRate), MAX_PHASES)),
+  myKernelStride(ConvolutionBuffer::kernelStride(myTaps, formatFrom.stereo ? 2 : 1)),
+  myCurrentFragment(nullptr),
+  myFragmentIndex(0),
+  myIsUnderrun(true),
+  myHighPassL(HIGH_PASS_CUT_OFF, float(formatFrom.sampleRate)),
+  myHighPassR(HIGH_PASS_CUT_OFF, float(formatFrom.sampleRate)),
+  myHighPass(HIGH_PASS_CUT_OFF, float(formatFrom.sampleRate)),
+  myTimeIndex(0)
+{
+  // One more kernel than phases: rounding the phase may yield the kernel
+  // for a full sample step
+  myPrecomputedKernels = make_unique<float[]>((myPhaseCount + 1) * myKernelStride);
+  memset(myPrecomputedKernels.get(), 0, (myPhaseCount + 1) * myKernelStride * sizeof(float));
+
+  myBuffer = make_unique<ConvolutionBuffer>(myTaps, myFormatFrom.stereo ? 2 : 1);
+  myFilteredFragment = make_unique<float[]>(myFormatFrom.fragmentSize * (myFormatFrom.stereo ? 2 : 1));
+
+  precomputeKernels();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PolyphaseResampler::precomputeKernels()
+{
+  const double cutOff = CUT_OFF *
+    std::min(1., double(myFormatTo.sampleRate) / double(myFormatFrom.sampleRate));
+  const double halfWidth = myTaps / 2;
+  vector<double> values(myTaps);
+
+  for (uInt32 i = 0; i <= myPhaseCount; ++i) {
+    float* kernel = myPrecomputedKernels.get() + myKernelStride * i;
+    // The time since the last input sample, in units of the input period
+    const double phase = double(i) / double(myPhaseCount);
+    double sum = 0;
+
+    for (uInt32 j = 0; j < myTaps; ++j) {
+      values[j] = kaiserKernel(phase - double(j) + halfWidth - 1, halfWidth, cutOff);
+      sum += values[j];
+    }
+
+    // Normalize every kernel to unit gain, so the phases don't modulate a
+    // constant signal
+    for (uInt32 j = 0; j < myTaps; ++j) {
+      const float value = static_cast<float>(values[j] / sum) * CLIPPING_FACTOR;
+
+      if (myFormatFrom.stereo)
+        kernel[2*j] = kernel[2*j + 1] = value;
+      else
+        kernel[j] = value;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PolyphaseResampler::fillFragment(float* fragment, uInt32 length)
+{
+  if (myIsUnderrun) {
+    Int16* nextFragment = myNextFragmentCallback();
+
+    if (nextFragment) {
+      myCurrentFragment = nextFragment;
+      myFragmentIndex = 0;
+      myIsUnderrun = false;
+      filterFragment();
+    }
+  }
+
+  if (!myCurrentFragment) {
+    memset(fragment, 0, sizeof(float) * length);
+    return;
+  }
+
+  const uInt32 outputSamples = myFormatTo.stereo ? (length >> 1) : length;
+
+  // myTimeIndex = time * formatFrom.sampleRate * formatTo.sampleRate, with
+  // time measured from the last input sample
+  for (uInt32 i = 0; i < outputSamples; ++i) {
+    const uInt32 phase = static_cast<uInt32>(
+      (uInt64(myTimeIndex) * myPhaseCount + myFormatTo.sampleRate / 2) / myFormatTo.sampleRate
+    );
+    const float* kernel = myPrecomputedKernels.get() + (phase * myKernelStride);
+
+    if (myFormatFrom.stereo) {
+      float sampleL, sampleR;
+      myBuffer->convoluteWith(kernel, sampleL, sampleR);
+
+      if (myFormatTo.stereo) {
+        fragment[2*i] = sampleL;
+        fragment[2*i + 1] = sampleR;
+      }
+      else
+        fragment[i] = (sampleL + sampleR) / 2.f;
+    } else {
+      float sample = myBuffer->convoluteWith(kernel);
+
+      if (myFormatTo.stereo)
+        fragment[2*i] = fragment[2*i + 1] = sample;
+      else
+        fragment[i] = sample;
+    }
+
+    myTimeIndex += myInputRate;
+
+    uInt32 samplesToShift = myTimeIndex / myFormatTo.sampleRate;
+    if (samplesToShift == 0) continue;
+
+    myTimeIndex %= myFormatTo.sampleRate;
+    shiftSamples(samplesToShift);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void PolyphaseResampler::shiftSamples(uInt32 samplesToShift)
+{
+  while (samplesToShift-- > 0) {
+    if (myFormatFrom.stereo)
+      myBuffer->shift(myFilteredFragment[2*myFragmentIndex], myFilteredFragment[2*myFragmentIndex + 1]);
+    else
+      myBuffer->shift(myFilteredFragment[myFragmentIndex]);
+
+    ++myFragmentIndex;
+
+    if (myFragmentIndex >= myFormatFrom.fragmentSize) {
+      myFragmentIndex %= myFormatFrom.fragmentSize;
+
+      Int16* nextFragment = myNextFragmentCallback();
+      if (nextFragment) {
+        myCurrentFragment = nextFragment;
+        myIsUnderrun = false;
+      } else {
+        myUnderrunLogger.log();
+        myIsUnderrun = true;
+      }
+
+      // On underrun, the last fragment is played (and filtered) again
+      filterFragment();
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PolyphaseResampler::filterFragment()
+{
+  const float scale = myVolume / static_cast<float>(0x7fff);
+
+  if (myFormatFrom.stereo)
+    HighPass::applyStereo(myHighPassL, myHighPassR, myCurrentFragment,
+                          myFilteredFragment.get(), myFormatFrom.fragmentSize, scale);
+  else
+    myHighPass.apply(myCurrentFragment, myFilteredFragment.get(),
+                     myFormatFrom.fragmentSize, scale);
+}
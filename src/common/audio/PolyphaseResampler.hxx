@@ -0,0 +1,90 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef POLYPHASE_RESAMPLER_HXX
+#define POLYPHASE_RESAMPLER_HXX
+
+#include "bspf.hxx"
+#include "Resampler.hxx"
+#include "ConvolutionBuffer.hxx"
+#include "HighPass.hxx"
+
+/**
+  Resamples with a Kaiser windowed sinc low-pass, evaluated for a set of
+  phases between two input samples.  At the same number of taps this
+  suppresses the images of the input spectrum much better than a Lanczos
+  kernel, so it can run with fewer taps for the same quality.
+
+  The number of phases is the reduced denominator of the sample rate ratio
+  (i.e. every output sample gets its exact kernel), but is capped for the
+  odd rates that speed adjustment produces; the phase is rounded then.
+*/
+class PolyphaseResampler : public Resampler
+{
+  public:
+    PolyphaseResampler(
+      Resampler::Format formatFrom,
+      Resampler::Format formatTo,
+      Resampler::NextFragmentCallback nextFragmentCallback,
+      uInt32 taps
+    );
+
+    void fillFragment(float* fragment, uInt32 length) override;
+
+  private:
+
+    void precomputeKernels();
+
+    void shiftSamples(uInt32 samplesToShift);
+
+    /**
+      Convert and high-pass filter the current fragment as a whole.
+     */
+    void filterFragment();
+
+  private:
+
+    uInt32 myTaps;
+    uInt32 myPhaseCount;
+    uInt32 myKernelStride;
+    unique_ptr<float[]> myPrecomputedKernels;
+
+    unique_ptr<ConvolutionBuffer> myBuffer;
+
+    Int16* myCurrentFragment;
+    unique_ptr<float[]> myFilteredFragment;
+    uInt32 myFragmentIndex;
+    bool myIsUnderrun;
+
+    HighPass myHighPassL;
+    HighPass myHighPassR;
+    HighPass myHighPass;
+
+    uInt32 myTimeIndex;
+
+  private:
+
+    PolyphaseResampler() = delete;
+    PolyphaseResampler(const PolyphaseResampler&) = delete;
+    PolyphaseResampler(PolyphaseResampler&&) = delete;
+    PolyphaseResampler& operator=(const PolyphaseResampler&) = delete;
+    PolyphaseResampler& operator=(PolyphaseResampler&&) = delete;
+
+};
+
+#endif // POLYPHASE_RESAMPLER_HXX
@@ -19,6 +19,7 @@
 #define RESAMPLER_HXX
 
 #include <functional>
+#include <cmath>
 
 #include "bspf.hxx"
 #include "StaggeredLogger.hxx"
@@ -54,11 +55,29 @@ class Resampler {
       myFormatFrom(formatFrom),
       myFormatTo(formatTo),
       myNextFragmentCallback(nextFragmentCallback),
-      myUnderrunLogger("audio buffer underrun", Logger::Level::INFO)
+      myUnderrunLogger("audio buffer underrun", Logger::Level::INFO),
+      myVolume(1),
+      myInputRate(formatFrom.sampleRate)
     {}
 
     virtual void fillFragment(float* fragment, uInt32 length) = 0;
 
+    /**
+      Set the factor (0 - 1) the output is scaled with.  It is applied when
+      converting the input samples, rather than in a separate pass.
+     */
+    void setVolume(float volume) { myVolume = volume; }
+
+    /**
+      Scale the rate at which input samples are consumed by a factor close
+      to 1.  This lets the sound driver keep the audio queue at its target
+      fill (dynamic rate control), at the cost of a pitch change too small
+      to be heard.
+     */
+    void setRateAdjustment(double factor) {
+      myInputRate = static_cast<uInt32>(std::lround(myFormatFrom.sampleRate * factor));
+    }
+
     virtual ~Resampler() {}
 
   protected:
@@ -70,6 +89,11 @@ class Resampler {
 
     StaggeredLogger myUnderrunLogger;
 
+    float myVolume;
+
+    // The input sample rate, adjusted by setRateAdjustment()
+    uInt32 myInputRate;
+
   private:
 
     Resampler() = delete;
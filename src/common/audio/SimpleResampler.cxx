@@ -49,12 +49,13 @@ void SimpleResampler::fillFragment(float* fragment, uInt32 length)
   }
 
   const uInt32 outputSamples = myFormatTo.stereo ? (length >> 1) : length;
+  const float scale = myVolume / static_cast<float>(0x7fff);
 
   // For the following math, remember that myTimeIndex = time * myFormatFrom.sampleRate * myFormatTo.sampleRate
   for (uInt32 i = 0; i < outputSamples; ++i) {
     if (myFormatFrom.stereo) {
-      float sampleL = static_cast<float>(myCurrentFragment[2*myFragmentIndex]) / static_cast<float>(0x7fff);
-      float sampleR = static_cast<float>(myCurrentFragment[2*myFragmentIndex + 1]) / static_cast<float>(0x7fff);
+      float sampleL = static_cast<float>(myCurrentFragment[2*myFragmentIndex]) * scale;
+      float sampleR = static_cast<float>(myCurrentFragment[2*myFragmentIndex + 1]) * scale;
 
       if (myFormatTo.stereo) {
         fragment[2*i] = sampleL;
@@ -63,7 +64,7 @@ void SimpleResampler::fillFragment(float* fragment, uInt32 length)
       else
         fragment[i] = (sampleL + sampleR) / 2.f;
     } else {
-      float sample = static_cast<float>(myCurrentFragment[myFragmentIndex] / static_cast<float>(0x7fff));
+      float sample = static_cast<float>(myCurrentFragment[myFragmentIndex]) * scale;
 
       if (myFormatTo.stereo)
         fragment[2*i] = fragment[2*i + 1] = sample;
@@ -72,7 +73,7 @@ void SimpleResampler::fillFragment(float* fragment, uInt32 length)
     }
 
     // time += 1 / myFormatTo.sampleRate
-    myTimeIndex += myFormatFrom.sampleRate;
+    myTimeIndex += myInputRate;
 
     // time >= 1 / myFormatFrom.sampleRate
     if (myTimeIndex >= myFormatTo.sampleRate) {
@@ -33,6 +33,11 @@
 #include "System.hxx"
 #include "TIASurface.hxx"
 #include "ProfilingRunner.hxx"
+#include "BatchRunner.hxx"
+#include "ScriptRunner.hxx"
+#include "ReplayRunner.hxx"
+#include "BenchmarkRunner.hxx"
+#include "StateProfileRunner.hxx"
 
 #include "ThreadDebugging.hxx"
 
@@ -70,7 +75,7 @@ void checkForCustomBaseDir(Settings::Options& options);
 
 /**
   Checks whether the commandline contains an argument corresponding to
-  starting a profile session.
+  starting a profile (or audio rendering) session.
 */
 bool isProfilingRun(int ac, char* av[]);
 
@@ -150,7 +155,7 @@ void checkForCustomBaseDir(Settings::Options& options)
 bool isProfilingRun(int ac, char* av[]) {
   if (ac <= 1) return false;
 
-  return string(av[1]) == "-profile";
+  return string(av[1]) == "-profile" || string(av[1]) == "-renderaudio";
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -170,6 +175,36 @@ int main(int ac, char* av[])
     return runner.run() ? 0 : 1;
   }
 
+  if (ac > 1 && string(av[1]) == "-batch") {
+    BatchRunner runner(ac, av);
+
+    return runner.run() ? 0 : 1;
+  }
+
+  if (ac > 1 && string(av[1]) == "-script") {
+    ScriptRunner runner(ac, av);
+
+    return runner.run() ? 0 : 1;
+  }
+
+  if (ac > 1 && string(av[1]) == "-replay") {
+    ReplayRunner runner(ac, av);
+
+    return runner.run() ? 0 : 1;
+  }
+
+  if (ac > 1 && string(av[1]) == "-benchmark") {
+    BenchmarkRunner runner(ac, av);
+
+    return runner.run() ? 0 : 1;
+  }
+
+  if (ac > 1 && string(av[1]) == "-stateprofile") {
+    StateProfileRunner runner(ac, av);
+
+    return runner.run() ? 0 : 1;
+  }
+
   unique_ptr<OSystem> theOSystem;
 
   auto Cleanup = [&theOSystem]() {
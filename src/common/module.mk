@@ -2,27 +2,44 @@ MODULE := src/common
 
 MODULE_OBJS := \
 	src/common/Base.o \
+	src/common/CpuFeatures.o \
 	src/common/EventHandlerSDL2.o \
 	src/common/FBSurfaceSDL2.o \
 	src/common/FrameBufferSDL2.o \
 	src/common/FSNodeZIP.o \
+	src/common/FrameRecorder.o \
+	src/common/FrameServer.o \
+	src/common/FrameTelemetry.o \
 	src/common/JoyMap.o \
 	src/common/KeyMap.o \
 	src/common/Logger.o \
+	src/common/MappedFile.o \
 	src/common/main.o \
 	src/common/MouseControl.o \
+	src/common/PerfCounters.o \
 	src/common/PhysicalJoystick.o \
 	src/common/PJoystickHandler.o \
 	src/common/PKeyboardHandler.o \
 	src/common/PNGLibrary.o \
+	src/common/RankedMaxTree.o \
 	src/common/RewindManager.o \
+	src/common/RomIndex.o \
+	src/common/DetectionCache.o \
+	src/common/RomHasher.o \
+	src/common/SnapshotCache.o \
 	src/common/SoundSDL2.o \
 	src/common/StateManager.o \
+	src/common/StreamServer.o \
+	src/common/ThreadPlacement.o \
+	src/common/ThreadPool.o \
 	src/common/TimerManager.o \
+	src/common/WavFileSink.o \
 	src/common/ZipHandler.o \
 	src/common/AudioQueue.o \
 	src/common/AudioSettings.o \
 	src/common/FpsMeter.o \
+	src/common/FSMetadataCache.o \
+	src/common/FramePacer.o \
 	src/common/ThreadDebugging.o \
 	src/common/StaggeredLogger.o \
 	src/common/repository/KeyValueRepositoryConfigfile.o
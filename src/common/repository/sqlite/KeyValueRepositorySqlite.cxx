@@ -37,8 +37,11 @@ std::map<string, Variant> KeyValueRepositorySqlite::load()
   try {
     myStmtSelect->reset();
 
-    while (myStmtSelect->step())
+    myStored.clear();
+    while (myStmtSelect->step()) {
       values[myStmtSelect->columnText(0)] = myStmtSelect->columnText(1);
+      myStored[myStmtSelect->columnText(0)] = myStmtSelect->columnText(1);
+    }
 
     myStmtSelect->reset();
   }
@@ -52,21 +55,33 @@ std::map<string, Variant> KeyValueRepositorySqlite::load()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void KeyValueRepositorySqlite::save(const std::map<string, Variant>& values)
 {
+  // Don't even start a transaction if nothing has changed
+  vector<const std::pair<const string, Variant>*> changed;
+  for (const auto& pair: values) {
+    auto stored = myStored.find(pair.first);
+    if (stored == myStored.end() || stored->second != pair.second.toString())
+      changed.push_back(&pair);
+  }
+  if (changed.empty()) return;
+
   try {
     SqliteTransaction tx(myDb);
 
     myStmtInsert->reset();
 
-    for (const auto& pair: values) {
+    for (const auto* pair: changed) {
       (*myStmtInsert)
-        .bind(1, pair.first.c_str())
-        .bind(2, pair.second.toCString())
+        .bind(1, pair->first.c_str())
+        .bind(2, pair->second.toCString())
         .step();
 
       myStmtInsert->reset();
     }
 
     tx.commit();
+
+    for (const auto* pair: changed)
+      myStored[pair->first] = pair->second.toString();
   }
   catch (SqliteError err) {
     Logger::info(err.message);
@@ -76,6 +91,9 @@ void KeyValueRepositorySqlite::save(const std::map<string, Variant>& values)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void KeyValueRepositorySqlite::save(const string& key, const Variant& value)
 {
+  auto stored = myStored.find(key);
+  if (stored != myStored.end() && stored->second == value.toString()) return;
+
   try {
     myStmtInsert->reset();
 
@@ -85,6 +103,8 @@ void KeyValueRepositorySqlite::save(const string& key, const Variant& value)
       .step();
 
     myStmtInsert->reset();
+
+    myStored[key] = value.toString();
   }
   catch (SqliteError err) {
     Logger::info(err.message);
@@ -45,6 +45,10 @@ class KeyValueRepositorySqlite : public KeyValueRepository
     unique_ptr<SqliteStatement> myStmtInsert;
     unique_ptr<SqliteStatement> myStmtSelect;
 
+    // The values as currently stored in the database, so that saving
+    // only writes those which have changed
+    std::map<string, string> myStored;
+
   private:
 
     KeyValueRepositorySqlite(const KeyValueRepositorySqlite&) = delete;
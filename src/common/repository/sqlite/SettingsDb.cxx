@@ -36,12 +36,24 @@ bool SettingsDb::initialize()
 
     mySettingsRepository = make_unique<KeyValueRepositorySqlite>(*myDb, "settings");
     mySettingsRepository->initialize();
+
+    myRomIndexRepository = make_unique<KeyValueRepositorySqlite>(*myDb, "romindex");
+    myRomIndexRepository->initialize();
+
+    myZipIndexRepository = make_unique<KeyValueRepositorySqlite>(*myDb, "zipindex");
+    myZipIndexRepository->initialize();
+
+    myDetectionCacheRepository = make_unique<KeyValueRepositorySqlite>(*myDb, "detectioncache");
+    myDetectionCacheRepository->initialize();
   }
   catch (SqliteError err) {
     Logger::info("sqlite DB " + myDb->fileName() + " failed to initialize: " + err.message);
 
     myDb.reset();
     mySettingsRepository.reset();
+    myRomIndexRepository.reset();
+    myZipIndexRepository.reset();
+    myDetectionCacheRepository.reset();
 
     return false;
   }
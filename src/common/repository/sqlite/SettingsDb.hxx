@@ -32,6 +32,12 @@ class SettingsDb
 
     KeyValueRepository& settingsRepository() const { return *mySettingsRepository; }
 
+    KeyValueRepository& romIndexRepository() const { return *myRomIndexRepository; }
+
+    KeyValueRepository& zipIndexRepository() const { return *myZipIndexRepository; }
+
+    KeyValueRepository& detectionCacheRepository() const { return *myDetectionCacheRepository; }
+
   private:
 
     string myDatabaseDirectory;
@@ -39,6 +45,9 @@ class SettingsDb
 
     unique_ptr<SqliteDatabase> myDb;
     unique_ptr<KeyValueRepositorySqlite> mySettingsRepository;
+    unique_ptr<KeyValueRepositorySqlite> myRomIndexRepository;
+    unique_ptr<KeyValueRepositorySqlite> myZipIndexRepository;
+    unique_ptr<KeyValueRepositorySqlite> myDetectionCacheRepository;
 };
 
 #endif // SETTINGS_DB_HXX
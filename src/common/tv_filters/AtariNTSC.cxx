@@ -15,7 +15,15 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
-#include <thread>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define ATARI_NTSC_SSE2
+#elif defined(__ARM_NEON)
+  #include <arm_neon.h>
+  #define ATARI_NTSC_NEON
+#endif
+
+#include "ThreadPool.hxx"
 #include "AtariNTSC.hxx"
 
 // blitter related
@@ -66,46 +74,25 @@ void AtariNTSC::initializePalette(const uInt8* palette)
   }
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void AtariNTSC::enableThreading(bool enable)
-{
-  uInt32 systemThreads = enable ? std::thread::hardware_concurrency() : 0;
-  if(systemThreads <= 1)
-  {
-    myWorkerThreads = 0;
-    myTotalThreads  = 1;
-  }
-  else
-  {
-    systemThreads = std::max(1u, std::min(4u, systemThreads - 1));
-
-    myWorkerThreads = systemThreads - 1;
-    myTotalThreads  = systemThreads;
-
-    myThreads = make_unique<std::thread[]>(myWorkerThreads);
-  }
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AtariNTSC::render(const uInt8* atari_in, const uInt32 in_width, const uInt32 in_height,
   void* rgb_out, const uInt32 out_pitch, uInt32* rgb_in)
 {
-  // Spawn the threads...
-  for(uInt32 i = 0; i < myWorkerThreads; ++i)
-  {
-    myThreads[i] = std::thread([=] {
+  // Split the rows into a few parts per thread, so that threads finishing
+  // early can take over the remaining parts
+  const uInt32 parts = myThreadPool && myThreadPool->threads() > 1
+    ? std::min(in_height, myThreadPool->threads() * 4) : 1;
+
+  const auto renderPart = [&](uInt32 part) {
     rgb_in == nullptr ?
-      renderThread(atari_in, in_width, in_height, myTotalThreads, i+1, rgb_out, out_pitch) :
-      renderWithPhosphorThread(atari_in, in_width, in_height, myTotalThreads, i+1, rgb_in, rgb_out, out_pitch);
-    });
-  }
-  // Make the main thread busy too
-  rgb_in == nullptr ?
-    renderThread(atari_in, in_width, in_height, myTotalThreads, 0, rgb_out, out_pitch) :
-    renderWithPhosphorThread(atari_in, in_width, in_height, myTotalThreads, 0, rgb_in, rgb_out, out_pitch);
-  // ...and make them join again
-  for(uInt32 i = 0; i < myWorkerThreads; ++i)
-    myThreads[i].join();
+      renderThread(atari_in, in_width, in_height, parts, part, rgb_out, out_pitch) :
+      renderWithPhosphorThread(atari_in, in_width, in_height, parts, part, rgb_in, rgb_out, out_pitch);
+  };
+
+  if(parts > 1)
+    myThreadPool->run(parts, renderPart);
+  else
+    renderPart(0);
 
   // Copy phosphor values into out buffer
   if(rgb_in != nullptr)
@@ -138,6 +125,14 @@ void AtariNTSC::renderThread(const uInt8* atari_in, const uInt32 in_width,
 
     for(uInt32 n = chunk_count; n; --n)
     {
+    #if defined(ATARI_NTSC_SSE2) || defined(ATARI_NTSC_NEON)
+      // all seven pixels at once; renderChunk() may write one pixel past
+      // them, which is overwritten right afterwards
+      const uInt32* const kernelxx1 = kernelx1;
+      ATARI_NTSC_COLOR_IN(0, line_in[0])
+      ATARI_NTSC_COLOR_IN(1, line_in[1])
+      renderChunk(kernel0, kernelx0, kernel1, kernelx1, kernelxx1, line_out);
+    #else
       // order of input and output pixels must not be altered
       ATARI_NTSC_COLOR_IN(0, line_in[0])
       ATARI_NTSC_RGB_OUT_8888(0, line_out[0])
@@ -149,6 +144,7 @@ void AtariNTSC::renderThread(const uInt8* atari_in, const uInt32 in_width,
       ATARI_NTSC_RGB_OUT_8888(4, line_out[4])
       ATARI_NTSC_RGB_OUT_8888(5, line_out[5])
       ATARI_NTSC_RGB_OUT_8888(6, line_out[6])
+    #endif
 
       line_in += 2;
       line_out += 7;
@@ -215,6 +211,14 @@ void AtariNTSC::renderWithPhosphorThread(const uInt8* atari_in, const uInt32 in_
 
     for(uInt32 n = chunk_count; n; --n)
     {
+    #if defined(ATARI_NTSC_SSE2) || defined(ATARI_NTSC_NEON)
+      // all seven pixels at once; renderChunk() may write one pixel past
+      // them, which is overwritten right afterwards
+      const uInt32* const kernelxx1 = kernelx1;
+      ATARI_NTSC_COLOR_IN(0, line_in[0])
+      ATARI_NTSC_COLOR_IN(1, line_in[1])
+      renderChunk(kernel0, kernelx0, kernel1, kernelx1, kernelxx1, line_out);
+    #else
       // order of input and output pixels must not be altered
       ATARI_NTSC_COLOR_IN(0, line_in[0])
       ATARI_NTSC_RGB_OUT_8888(0, line_out[0])
@@ -226,6 +230,7 @@ void AtariNTSC::renderWithPhosphorThread(const uInt8* atari_in, const uInt32 in_
       ATARI_NTSC_RGB_OUT_8888(4, line_out[4])
       ATARI_NTSC_RGB_OUT_8888(5, line_out[5])
       ATARI_NTSC_RGB_OUT_8888(6, line_out[6])
+    #endif
 
       line_in += 2;
       line_out += 7;
@@ -305,6 +310,70 @@ void AtariNTSC::renderWithPhosphorThread(const uInt8* atari_in, const uInt32 in_
   }
 }
 
+#if defined(ATARI_NTSC_SSE2) || defined(ATARI_NTSC_NEON)
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void AtariNTSC::renderChunk(const uInt32* kernel0, const uInt32* kernelx0,
+    const uInt32* kernel1, const uInt32* kernelx1, const uInt32* kernelxx1,
+    uInt32* line_out)
+{
+  // This is ATARI_NTSC_RGB_OUT_8888 for pixels 0 - 3 and 4 - 7 of a chunk;
+  // pixels 0 - 3 still use the kernels of the previous odd input pixel
+  // (now in kernelx1 and kernelxx1).  Pixel 7 is junk.
+#if defined(ATARI_NTSC_SSE2)
+  const __m128i mask = _mm_set1_epi32(atari_ntsc_clamp_mask),
+                add  = _mm_set1_epi32(atari_ntsc_clamp_add);
+  const auto load = [](const uInt32* p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  };
+  const auto out = [&](__m128i raw, uInt32* rgb_out) {
+    // ATARI_NTSC_CLAMP_(raw, 0)
+    const __m128i sub = _mm_and_si128(_mm_srli_epi32(raw, 9), mask);
+    __m128i clamp = _mm_sub_epi32(add, sub);
+    raw = _mm_or_si128(raw, clamp);
+    clamp = _mm_sub_epi32(clamp, sub);
+    raw = _mm_and_si128(raw, clamp);
+
+    const __m128i rgb = _mm_or_si128(_mm_or_si128(
+        _mm_and_si128(_mm_srli_epi32(raw, 5), _mm_set1_epi32(0x00FF0000)),
+        _mm_and_si128(_mm_srli_epi32(raw, 3), _mm_set1_epi32(0x0000FF00))),
+        _mm_and_si128(_mm_srli_epi32(raw, 1), _mm_set1_epi32(0x000000FF)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb_out), rgb);
+  };
+
+  out(_mm_add_epi32(_mm_add_epi32(load(kernel0), load(kernelx1 + 17)),
+                    _mm_add_epi32(load(kernelx0 + 7), load(kernelxx1 + 24))),
+      line_out);
+  out(_mm_add_epi32(_mm_add_epi32(load(kernel0 + 4), load(kernel1 + 14)),
+                    _mm_add_epi32(load(kernelx0 + 11), load(kernelx1 + 21))),
+      line_out + 4);
+#elif defined(ATARI_NTSC_NEON)
+  const uint32x4_t mask = vdupq_n_u32(atari_ntsc_clamp_mask),
+                   add  = vdupq_n_u32(atari_ntsc_clamp_add);
+  const auto out = [&](uint32x4_t raw, uInt32* rgb_out) {
+    // ATARI_NTSC_CLAMP_(raw, 0)
+    const uint32x4_t sub = vandq_u32(vshrq_n_u32(raw, 9), mask);
+    uint32x4_t clamp = vsubq_u32(add, sub);
+    raw = vorrq_u32(raw, clamp);
+    clamp = vsubq_u32(clamp, sub);
+    raw = vandq_u32(raw, clamp);
+
+    const uint32x4_t rgb = vorrq_u32(vorrq_u32(
+        vandq_u32(vshrq_n_u32(raw, 5), vdupq_n_u32(0x00FF0000)),
+        vandq_u32(vshrq_n_u32(raw, 3), vdupq_n_u32(0x0000FF00))),
+        vandq_u32(vshrq_n_u32(raw, 1), vdupq_n_u32(0x000000FF)));
+    vst1q_u32(rgb_out, rgb);
+  };
+
+  out(vaddq_u32(vaddq_u32(vld1q_u32(kernel0), vld1q_u32(kernelx1 + 17)),
+                vaddq_u32(vld1q_u32(kernelx0 + 7), vld1q_u32(kernelxx1 + 24))),
+      line_out);
+  out(vaddq_u32(vaddq_u32(vld1q_u32(kernel0 + 4), vld1q_u32(kernel1 + 14)),
+                vaddq_u32(vld1q_u32(kernelx0 + 11), vld1q_u32(kernelx1 + 21))),
+      line_out + 4);
+#endif
+}
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline uInt32 AtariNTSC::getRGBPhosphor(const uInt32 c, const uInt32 p) const
 {
@@ -41,7 +41,8 @@
 #define ATARI_NTSC_HXX
 
 #include <cmath>
-#include <thread>
+
+class ThreadPool;
 
 #include "bspf.hxx"
 
@@ -51,7 +52,7 @@ class AtariNTSC
     static constexpr uInt32 palette_size = 256, entry_size = 2 * 14;
 
     // By default, threading is turned off
-    AtariNTSC() { enableThreading(false); }
+    AtariNTSC() : myThreadPool(nullptr) { }
 
     // Image parameters, ranging from -1.0 to 1.0. Actual internal values shown
     // in parenthesis and should remain fairly stable in future versions.
@@ -82,14 +83,19 @@ class AtariNTSC
     void initialize(const Setup& setup, const uInt8* palette);
     void initializePalette(const uInt8* palette);
 
-    // Set up threading
-    void enableThreading(bool enable);
+    // Set up threading; rows are split across the threads of the given
+    // pool (nullptr renders in the calling thread only)
+    void setThreadPool(ThreadPool* pool) { myThreadPool = pool; }
 
     // Set phosphor palette, for use in Blargg + phosphor mode
     void setPhosphorPalette(uInt8 palette[256][256]) {
       memcpy(myPhosphorPalette, palette, 256 * 256);
     }
 
+    // The kernels of all palette colors, 'entry_size' values per color in
+    // the packed format summed up by ATARI_NTSC_RGB_OUT_8888.
+    const uInt32* colorTable() const { return myColorTable[0]; }
+
     // Filters one or more rows of pixels. Input pixels are 8-bit Atari
     // palette colors.
     //  In_row_width is the number of pixels to get to the next input row.
@@ -112,7 +118,7 @@ class AtariNTSC
     }
 
   private:
-    // Threaded rendering
+    // Threaded rendering; each call renders one of 'numThreads' parts
     void renderThread(const uInt8* atari_in, const uInt32 in_width,
       const uInt32 in_height, const uInt32 numThreads, const uInt32 threadNum, void* rgb_out, const uInt32 out_pitch);
     void renderWithPhosphorThread(const uInt8* atari_in, const uInt32 in_width,
@@ -128,6 +134,17 @@ class AtariNTSC
     */
     uInt32 getRGBPhosphor(const uInt32 c, const uInt32 cp) const;
 
+    /**
+      Generates the seven output pixels of one chunk using SIMD (SSE2 or
+      NEON), after ATARI_NTSC_COLOR_IN of both of its input pixels.  Only
+      built when one of those is available.
+
+      @param kernelxx1  The value of 'kernelx1' before the chunk started
+    */
+    static void renderChunk(const uInt32* kernel0, const uInt32* kernelx0,
+        const uInt32* kernel1, const uInt32* kernelx1, const uInt32* kernelxx1,
+        uInt32* line_out);
+
   private:
     static constexpr Int32
       PIXEL_in_chunk  = 2,   // number of input pixels read per chunk
@@ -165,10 +182,8 @@ class AtariNTSC
     uInt32 myColorTable[palette_size][entry_size];
     uInt8 myPhosphorPalette[256][256];
 
-    // Rendering threads
-    unique_ptr<std::thread[]> myThreads;
-    // Number of rendering and total threads
-    uInt32 myWorkerThreads, myTotalThreads;
+    // Rendering threads (if any)
+    ThreadPool* myThreadPool;
 
     struct init_t
     {
@@ -120,10 +120,17 @@ class NTSCFilter
       myNTSC.render(src_buf, src_width, src_height, dest_buf, dest_pitch, prev_buf);
     }
 
-    // Enable threading for the NTSC rendering
-    inline void enableThreading(bool enable)
+    // The kernels generated for the current palette and setup, for
+    // doing the filtering elsewhere (see AtariNTSC::colorTable())
+    inline const uInt32* colorTable() const
     {
-      myNTSC.enableThreading(enable);
+      return myNTSC.colorTable();
+    }
+
+    // Use the threads of the given pool for the NTSC rendering
+    inline void setThreadPool(ThreadPool* pool)
+    {
+      myNTSC.setThreadPool(pool);
     }
 
   private:
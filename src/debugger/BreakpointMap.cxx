@@ -20,7 +20,8 @@
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 BreakpointMap::BreakpointMap(void)
-  : myInitialized(false)
+  : myInitialized(false),
+    myAnyBankBits(0x10000 / 64, 0)
 {
 }
 
@@ -30,7 +31,13 @@ void BreakpointMap::add(const Breakpoint& breakpoint, const uInt32 flags)
   Breakpoint bp = convertBreakpoint(breakpoint);
 
   myInitialized = true;
-  myMap[bp] = flags;
+
+  // An equal breakpoint (e.g. one for any bank) might already exist, in
+  // which case only its flags are changed
+  auto result = myMap.emplace(bp, flags);
+  if(!result.second)
+    result.first->second = flags;
+  setBit(result.first->first);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -50,6 +57,7 @@ void BreakpointMap::erase(const Breakpoint& breakpoint)
 
     myMap.erase(bp13);
   }
+  rebuildBits();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -100,7 +108,23 @@ bool BreakpointMap::check(const Breakpoint& breakpoint) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool BreakpointMap::check(const uInt16 addr, const uInt8 bank) const
 {
-  return check(Breakpoint(addr, bank));
+  if(bank == ANY_BANK)
+    return check(Breakpoint(addr, bank));
+
+  // Same as check(Breakpoint), but using the bitmaps only:
+  // breakpoints of a bank are stored by their 13 bit address, those valid
+  // in any bank match both the full and the 13 bit address
+  return (bank < myBankBits.size() && !myBankBits[bank].empty() &&
+          testBit(myBankBits[bank], addr & ADDRESS_MASK)) ||
+         testBit(myAnyBankBits, addr) ||
+         testBit(myAnyBankBits, addr & ADDRESS_MASK);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BreakpointMap::clear()
+{
+  myMap.clear();
+  rebuildBits();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -123,3 +147,31 @@ BreakpointMap::Breakpoint BreakpointMap::convertBreakpoint(const Breakpoint& bre
   else
     return Breakpoint(breakpoint.addr & ADDRESS_MASK, breakpoint.bank);
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BreakpointMap::setBit(const Breakpoint& bp)
+{
+  if(bp.bank == ANY_BANK)
+  {
+    myAnyBankBits[bp.addr >> 6] |= uInt64(1) << (bp.addr & 63);
+    return;
+  }
+
+  if(bp.bank >= myBankBits.size())
+    myBankBits.resize(bp.bank + 1);
+  vector<uInt64>& bits = myBankBits[bp.bank];
+  if(bits.empty())
+    bits.resize((ADDRESS_MASK + 1) / 64, 0);
+
+  bits[bp.addr >> 6] |= uInt64(1) << (bp.addr & 63);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BreakpointMap::rebuildBits()
+{
+  myBankBits.clear();
+  std::fill(myAnyBankBits.begin(), myAnyBankBits.end(), 0);
+
+  for(const auto& item: myMap)
+    setBit(item.first);
+}
@@ -25,6 +25,12 @@
 /**
   This class handles simple debugger breakpoints.
 
+  Since the CPU checks for a breakpoint after each instruction, all
+  breakpoints are also kept in bitmaps, one per bank (indexed by the 13 bit
+  address) and one for breakpoints valid in any bank (indexed by the full
+  address).  Checking for a breakpoint in a specific bank is thus only a
+  few bit tests.
+
   @author  Thomas Jentzsch
 */
 class BreakpointMap
@@ -94,12 +100,22 @@ public:
   BreakpointList getBreakpoints() const;
 
   /** clear all breakpoints */
-  void clear() { myMap.clear(); }
+  void clear();
   size_t size() { return myMap.size(); }
 
 private:
   Breakpoint convertBreakpoint(const Breakpoint& breakpoint);
 
+  /** Set the bit for the given (converted) breakpoint */
+  void setBit(const Breakpoint& bp);
+
+  /** Rebuild the bitmaps from the map, after breakpoints were erased */
+  void rebuildBits();
+
+  static bool testBit(const vector<uInt64>& bits, uInt32 index) {
+    return (bits[index >> 6] >> (index & 63)) & 1;
+  }
+
   struct BreakpointHash {
     size_t operator()(const Breakpoint& bp) const {
       return std::hash<uInt64>()(
@@ -110,6 +126,11 @@ private:
 
   std::unordered_map<Breakpoint, uInt32, BreakpointHash> myMap;
   bool myInitialized;
+
+  // Bits for the breakpoints of each bank (empty for banks without any),
+  // and of breakpoints valid in any bank
+  vector<vector<uInt64>> myBankBits;
+  vector<uInt64> myAnyBankBits;
 };
 
 #endif
@@ -20,6 +20,7 @@
 #include "M6502.hxx"
 #include "FSNode.hxx"
 #include "DiStella.hxx"
+#include "ThreadPool.hxx"
 #include "Debugger.hxx"
 #include "DebuggerParser.hxx"
 #include "CpuDebug.hxx"
@@ -28,6 +29,7 @@
 #include "Version.hxx"
 #include "Cart.hxx"
 #include "CartDebug.hxx"
+#include "CycleProfiler.hxx"
 #include "CartDebugWidget.hxx"
 #include "CartRamWidget.hxx"
 #include "RomWidget.hxx"
@@ -42,12 +44,61 @@ using std::setw;
 using std::left;
 using std::right;
 
+namespace {
+  // Read a whole text file at once
+  bool readTextFile(const FilesystemNode& node, string& text)
+  {
+    ifstream in(node.getPath(), std::ios::binary);
+    if(!in.is_open())
+      return false;
+
+    in.seekg(0, std::ios::end);
+    const std::streamoff size = in.tellg();
+    in.seekg(0, std::ios::beg);
+    if(size < 0)
+      return false;
+
+    text.resize(size_t(size));
+    in.read(&text[0], size);
+    return bool(in) || in.eof();
+  }
+
+  // Get the next whitespace-delimited token of [p, eol) as [start, p);
+  // returns the start, which is eol if there are no more tokens
+  const char* nextToken(const char*& p, const char* eol)
+  {
+    while(p < eol && isspace(uInt8(*p)))
+      ++p;
+    const char* start = p;
+    while(p < eol && !isspace(uInt8(*p)))
+      ++p;
+    return start;
+  }
+
+  // Parse the number at the start of [start, end); there must be at least
+  // one digit
+  bool parseNumber(const char* start, const char* end, int base, int& value)
+  {
+    if(start == end)
+      return false;
+
+    char* next;
+    const long v = strtol(start, &next, base);
+    if(next == start || next > end)
+      return false;
+
+    value = int(v);
+    return true;
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 CartDebug::CartDebug(Debugger& dbg, Console& console, const OSystem& osystem)
   : DebuggerSystem(dbg, console),
     myOSystem(osystem),
     myDebugWidget(nullptr),
     myAddrToLineIsROM(true),
+    myLabelsVersion(0),
     myLabelLength(8)   // longest pre-defined label
 {
   // Add case sensitive compare for user labels
@@ -292,6 +343,27 @@ bool CartDebug::fillDisassemblyList(BankInfo& info, uInt16 search)
   if(info.addressList.size() == 0)
     return false;
 
+  const uInt64 signature = disassemblySignature(info);
+
+  // Reuse an earlier disassembly if nothing it depends on has changed since
+  auto cached = std::find_if(myDisasmCache.begin(), myDisasmCache.end(),
+      [signature](const CachedDisassembly& c) { return c.signature == signature; });
+  if(cached != myDisasmCache.end())
+  {
+    myDisasmCache.splice(myDisasmCache.begin(), myDisasmCache, cached);
+
+    myDisassembly = cached->disassembly;
+    myAddrToLineList = cached->addrToLineList;
+    myAddrToLineIsROM = cached->offset & 0x1000;
+    memcpy(myDisLabels, cached->labels, 0x1000);
+    memcpy(myDisDirectives, cached->directives, 0x1000);
+    info.start  = cached->start;
+    info.end    = cached->end;
+    info.offset = cached->offset;
+
+    return myAddrToLineList.find(search & 0xFFF) != myAddrToLineList.end();
+  }
+
   myDisassembly.list.clear();
   myDisassembly.fieldwidth = 24 + myLabelLength;
   DiStella distella(*this, myDisassembly.list, info, DiStella::settings,
@@ -318,9 +390,74 @@ bool CartDebug::fillDisassemblyList(BankInfo& info, uInt16 search)
         found = true;
     }
   }
+
+  // Remember the result, dropping the least recently used one if necessary
+  if(myDisasmCache.size() >= DISASM_CACHE_SIZE)
+    myDisasmCache.pop_back();
+  myDisasmCache.emplace_front();
+  CachedDisassembly& entry = myDisasmCache.front();
+  entry.signature = signature;
+  entry.disassembly = myDisassembly;
+  entry.addrToLineList = myAddrToLineList;
+  memcpy(entry.labels, myDisLabels, 0x1000);
+  memcpy(entry.directives, myDisDirectives, 0x1000);
+  entry.start  = info.start;
+  entry.end    = info.end;
+  entry.offset = info.offset;
+
   return found;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 CartDebug::disassemblySignature(const BankInfo& info) const
+{
+  // FNV-1a hash
+  uInt64 hash = 0xcbf29ce484222325ULL;
+  const auto add = [&hash](uInt32 value) {
+    for(int i = 0; i < 4; ++i, value >>= 8)
+    {
+      hash ^= value & 0xFF;
+      hash *= 0x100000001b3ULL;
+    }
+  };
+
+  add(uInt32(&info - myBankInfo.data()));
+  add(info.offset);
+  add(info.size);
+  add(uInt32(info.addressList.size()));
+  for(uInt16 addr: info.addressList)
+    add(addr);
+  add(uInt32(info.directiveList.size()));
+  for(const auto& tag: info.directiveList)
+  {
+    add(tag.type);
+    add(tag.start);
+    add(tag.end);
+  }
+
+  const DiStella::Settings& s = DiStella::settings;
+  add(uInt32(s.gfxFormat));
+  add(s.resolveCode | s.showAddresses << 1 | s.aFlag << 2 |
+      s.fFlag << 3 | s.rFlag << 4 | s.bFlag << 5);
+  add(s.bytesWidth);
+  add(myLabelLength);
+  add(myLabelsVersion);
+
+  // The address range DiStella will work on (see its constructor), along
+  // with what is currently known about each byte in it
+  uInt32 first = 0x80, last = 0xFF;
+  const uInt16 start = info.addressList.front();
+  if(start & 0x1000)
+  {
+    first = info.offset != 0 ? info.offset : start - (start % info.size);
+    last = first + info.size - 1;
+  }
+  for(uInt32 addr = first; addr <= last; ++addr)
+    add(mySystem.peek(addr) | mySystem.getAccessFlags(addr) << 8);
+
+  return hash;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int CartDebug::addressToLine(uInt16 address) const
 {
@@ -526,6 +663,16 @@ int CartDebug::bankCount() const
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartDebug::addLabel(const string& label, uInt16 address)
+{
+  if(!insertLabel(label, address))
+    return false;
+
+  ++myLabelsVersion;
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartDebug::insertLabel(const string& label, uInt16 address)
 {
   // Only user-defined labels can be added or redefined
   switch(addressType(address))
@@ -534,12 +681,23 @@ bool CartDebug::addLabel(const string& label, uInt16 address)
     case AddrType::IO:
       return false;
     default:
-      removeLabel(label);
+    {
+      // Redefine the label, if it exists
+      const auto& iter = myUserAddresses.find(label);
+      if(iter != myUserAddresses.end())
+      {
+        const auto& iter2 = myUserLabels.find(iter->second);
+        if(iter2 != myUserLabels.end())
+          myUserLabels.erase(iter2);
+        mySystem.setDirtyPage(iter->second);
+        myUserAddresses.erase(iter);
+      }
       myUserAddresses.emplace(label, address);
       myUserLabels.emplace(address, label);
       myLabelLength = std::max(myLabelLength, uInt16(label.size()));
       mySystem.setDirtyPage(address);
       return true;
+    }
   }
 }
 
@@ -558,6 +716,7 @@ bool CartDebug::removeLabel(const string& label)
     // Erase the label itself
     mySystem.setDirtyPage(iter->second);
     myUserAddresses.erase(iter);
+    ++myLabelsVersion;
 
     return true;
   }
@@ -707,45 +866,54 @@ string CartDebug::loadListFile()
   }
 
   FilesystemNode node(myListFile);
-  ifstream in(node.getPath());
-  if(!in.is_open())
+  string text;
+  if(!readTextFile(node, text))
     return DebuggerParser::red("list file '" + node.getShortPath() + "' not readable");
 
-  while(!in.eof())
+  // Parse the whole file in one pass, without copying each line
+  const char* end = text.data() + text.size();
+  for(const char* line = text.data(); line < end; )
   {
-    string line, addr_s;
+    const char* eol = std::find(line, end, '\n');
+    const char* start = line;
+    line = eol < end ? eol + 1 : end;
 
-    getline(in, line);
+    if(start == eol || *start == '-')
+      continue;
 
-    if(!in.good() || line == "" || line[0] == '-')
+    // Swallow first value, then get actual numerical value for address
+    // The address may be prefixed by 'U'
+    const char* p = start;
+    const char* token = nextToken(p, eol);
+    int addr = -1;
+    if(!parseNumber(token, p, 10, addr))
       continue;
-    else  // Search for constants
-    {
-      stringstream buf(line);
+    token = nextToken(p, eol);
+    if(token == p)
+      continue;
+    if(*token == 'U')
+      ++token;
+    addr = int(strtoul(token, nullptr, 16));
 
-      // Swallow first value, then get actual numerical value for address
-      // We need to read the address as a string, since it may contain 'U'
-      int addr = -1;
-      buf >> addr >> addr_s;
-      if(addr_s.length() == 0)
-        continue;
-      const char* p = addr_s[0] == 'U' ? addr_s.c_str() + 1 : addr_s.c_str();
-      addr = int(strtoul(p, nullptr, 16));
-
-      // For now, completely ignore ROM addresses
-      if(!(addr & 0x1000))
-      {
-        // Search for pattern 'xx yy  CONSTANT ='
-        buf.seekg(20);  // skip potential '????'
-        int xx = -1, yy = -1;
-        char eq = '\0';
-        buf >> hex >> xx >> hex >> yy >> line >> eq;
-        if(xx >= 0 && yy >= 0 && eq == '=')
-          //myUserCLabels.emplace(xx*256+yy, line);
-          addLabel(line, xx * 256 + yy);
-      }
-    }
+    // For now, completely ignore ROM addresses
+    if(addr & 0x1000 || eol - start <= 20)
+      continue;
+
+    // Search for pattern 'xx yy  CONSTANT ='
+    p = start + 20;  // skip potential '????'
+    int xx = -1, yy = -1;
+    token = nextToken(p, eol);
+    if(!parseNumber(token, p, 16, xx))
+      continue;
+    token = nextToken(p, eol);
+    if(!parseNumber(token, p, 16, yy))
+      continue;
+    token = nextToken(p, eol);
+    const string label(token, p);
+    if(xx >= 0 && yy >= 0 && label != "" && *nextToken(p, eol) == '=')
+      insertLabel(label, xx * 256 + yy);
   }
+  ++myLabelsVersion;
   myDebugger.rom().invalidate();
 
   return "list file '" + node.getShortPath() + "' loaded OK";
@@ -767,45 +935,49 @@ string CartDebug::loadSymbolFile()
   }
 
   FilesystemNode node(mySymbolFile);
-  ifstream in(node.getPath());
-  if(!in.is_open())
+  string text;
+  if(!readTextFile(node, text))
     return DebuggerParser::red("symbol file '" + node.getShortPath() + "' not readable");
 
   myUserAddresses.clear();
   myUserLabels.clear();
 
-  while(!in.eof())
+  // Parse the whole file in one pass, without copying each line
+  const char* end = text.data() + text.size();
+  for(const char* line = text.data(); line < end; )
   {
-    string label;
-    int value = -1;
+    const char* eol = std::find(line, end, '\n');
+    const char* p = line;
+    line = eol < end ? eol + 1 : end;
 
-    getline(in, label);
-    if(!in.good())  continue;
-    stringstream buf(label);
-    buf >> label >> hex >> value;
+    const char* token = nextToken(p, eol);
+    string label(token, p);
+    int value = -1;
+    token = nextToken(p, eol);
+    if(!parseNumber(token, p, 16, value))
+      continue;
 
     if(label.length() > 0 && label[0] != '-' && value >= 0)
     {
       // Make sure the value doesn't represent a constant
       // For now, we simply ignore constants completely
-      //const auto& iter = myUserCLabels.find(value);
-      //if(iter == myUserCLabels.end() || !BSPF::equalsIgnoreCase(label, iter->second))
       const auto& iter = myUserLabels.find(value);
       if (iter == myUserLabels.end() || !BSPF::equalsIgnoreCase(label, iter->second))
       {
         // Check for period, and strip leading number
         string::size_type pos = label.find_first_of(".", 0);
         if(pos != string::npos)
-          addLabel(label.substr(pos), value);
+          insertLabel(label.substr(pos), value);
         else
         {
           pos = label.find_last_of("$");
           if (pos == string::npos || pos != label.length() - 1)
-            addLabel(label, value);
+            insertLabel(label, value);
         }
       }
     }
   }
+  ++myLabelsVersion;
   myDebugger.rom().invalidate();
 
   return "symbol file '" + node.getShortPath() + "' loaded OK";
@@ -953,7 +1125,8 @@ string CartDebug::saveConfigFile()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-string CartDebug::saveDisassembly()
+string CartDebug::saveDisassembly(const string& filename,
+                                  const CycleProfiler* profiler)
 {
   if(myDisasmFile == "")
   {
@@ -963,22 +1136,18 @@ string CartDebug::saveDisassembly()
     myDisasmFile = FilesystemNode(myOSystem.defaultSaveDir() + propsname).getPath();
   }
 
-  FilesystemNode node(myDisasmFile);
-  ofstream out(node.getPath());
+  // The disassembly of large carts is written directly, bank by bank,
+  // through a larger buffer than the default one
+  FilesystemNode node(filename != "" ? filename : myDisasmFile);
+  vector<char> outBuffer(DISASM_BUFFER_SIZE);
+  ofstream out;
+  out.rdbuf()->pubsetbuf(outBuffer.data(), outBuffer.size());
+  out.open(node.getPath());
   if(!out.is_open())
     return "Unable to save disassembly to " + node.getShortPath();
 
 #define ALIGN(x) setfill(' ') << left << setw(x)
 
-  // We can't print the header to the disassembly until it's actually
-  // been processed; therefore buffer output to a string first
-  ostringstream buf;
-  buf << "\n\n;***********************************************************\n"
-      << ";      Bank " << myConsole.cartridge().getBank();
-  if (myConsole.cartridge().bankCount() > 1)
-    buf << " / 0.." << myConsole.cartridge().bankCount() - 1;
-  buf << "\n;***********************************************************\n\n";
-
   // Use specific settings for disassembly output
   // This will most likely differ from what you see in the debugger
   DiStella::Settings settings;
@@ -991,82 +1160,69 @@ string CartDebug::saveDisassembly()
   settings.bytesWidth = 8+1;  // same as Stella debugger
   settings.bFlag = DiStella::settings.bFlag; // process break routine (TODO)
 
-  Disassembly disasm;
-  disasm.list.reserve(2048);
+  // An empty address list means that DiStella can't do a disassembly
+  vector<int> banks;
   for(int bank = 0; bank < myConsole.cartridge().bankCount(); ++bank)
-  {
-    BankInfo& info = myBankInfo[bank];
-    // An empty address list means that DiStella can't do a disassembly
-    if(info.addressList.size() == 0)
-      continue;
-
-    // Disassemble bank
-    disasm.list.clear();
-    DiStella distella(*this, disasm.list, info, settings,
-                      myDisLabels, myDisDirectives, myReserved);
-
-    if (myReserved.breakFound)
-      addLabel("Break", myDebugger.dpeek(0xfffe));
-
-    buf << "    SEG     CODE\n"
-        << "    ORG     $" << Base::HEX4 << info.offset << "\n\n";
-
-    // Format in 'distella' style
-    for(uInt32 i = 0; i < disasm.list.size(); ++i)
-    {
-      const DisassemblyTag& tag = disasm.list[i];
-
-      // Add label (if any)
-      if(tag.label != "")
-        buf << ALIGN(4) << (tag.label) << "\n";
-      buf << "    ";
+    if(myBankInfo[bank].addressList.size() > 0)
+      banks.push_back(bank);
+
+  // Each bank is disassembled from its own copy of the cart area and
+  // zero-page RAM, with its own labels and reserved equates, so that all
+  // banks can be processed in parallel; the results are merged afterwards
+  struct BankDisassembly {
+    Disassembly disasm;
+    DiStella::Snapshot snapshot;
+    uInt8 labels[0x1000], directives[0x1000];
+    ReservedEquates reserved;
+  };
+  const auto forEachSnapshotAddress = [](const auto& fn) {
+    for(uInt16 addr = 0x0080; addr <= 0x00FF; ++addr)  fn(addr);
+    for(uInt16 addr = 0x1000; addr <= 0x1FFF; ++addr)  fn(addr);
+  };
 
-      switch(tag.type)
-      {
-        case CartDebug::CODE:
-        {
-          buf << ALIGN(32) << tag.disasm << tag.ccount.substr(0, 5) << tag.ctotal << tag.ccount.substr(5, 2);
-          if (tag.disasm.find("WSYNC") != std::string::npos)
-            buf << "\n;---------------------------------------";
-          break;
-        }
-        case CartDebug::ROW:
-        {
-          buf << ".byte   " << ALIGN(32) << tag.disasm.substr(6, 8*4-1) << "; $" << Base::HEX4 << tag.address << " (*)";
-          break;
-        }
-        case CartDebug::GFX:
-        {
-          buf << ".byte   " << (settings.gfxFormat == Base::F_2 ? "%" : "$")
-              << tag.bytes << " ; |";
-          for(int c = 12; c < 20; ++c)
-            buf << ((tag.disasm[c] == '\x1e') ? "#" : " ");
-          buf << ALIGN(13) << "|" << "$" << Base::HEX4 << tag.address << " (G)";
-          break;
-        }
-        case CartDebug::PGFX:
-        {
-          buf << ".byte   " << (settings.gfxFormat == Base::F_2 ? "%" : "$")
-              << tag.bytes << " ; |";
-          for(int c = 12; c < 20; ++c)
-            buf << ((tag.disasm[c] == '\x1f') ? "*" : " ");
-          buf << ALIGN(13) << "|" << "$" << Base::HEX4 << tag.address << " (P)";
-          break;
-        }
-        case CartDebug::DATA:
-        {
-          buf << ".byte   " << ALIGN(32) << tag.disasm.substr(6, 8 * 4 - 1) << "; $" << Base::HEX4 << tag.address << " (D)";
-          break;
-        }
-        case CartDebug::NONE:
-        default:
-        {
-          break;
-        }
-      } // switch
-      buf << "\n";
-    }
+  auto image = make_unique<DiStella::Snapshot>();
+  forEachSnapshotAddress([&](uInt16 addr) {
+    image->bytes[addr] = myDebugger.peek(addr);
+    image->flags[addr] = mySystem.getAccessFlags(addr);
+  });
+
+  vector<unique_ptr<BankDisassembly>> results(banks.size());
+  ThreadPool pool;
+  pool.setThreads(std::min(std::max(std::thread::hardware_concurrency(), 1U),
+                           uInt32(banks.size())));
+  pool.run(uInt32(banks.size()), [&](uInt32 i) {
+    results[i] = make_unique<BankDisassembly>();
+    BankDisassembly& result = *results[i];
+    result.snapshot = *image;
+    result.disasm.list.reserve(2048);
+    DiStella distella(*this, result.disasm.list, myBankInfo[banks[i]], settings,
+                      result.labels, result.directives, result.reserved,
+                      &result.snapshot);
+  });
+
+  // Merge the access flags and reserved equates found in all banks
+  bool breakFound = false;
+  for(const auto& result : results)
+  {
+    forEachSnapshotAddress([&](uInt16 addr) {
+      if(result->snapshot.flags[addr] != image->flags[addr])
+        mySystem.setAccessFlags(addr, result->snapshot.flags[addr]);
+    });
+    const ReservedEquates& reserved = result->reserved;
+    for(uInt16 addr = 0x00; addr <= 0x0F; ++addr)
+      myReserved.TIARead[addr] |= reserved.TIARead[addr];
+    for(uInt16 addr = 0x00; addr <= 0x3F; ++addr)
+      myReserved.TIAWrite[addr] |= reserved.TIAWrite[addr];
+    for(uInt16 addr = 0x00; addr <= 0x17; ++addr)
+      myReserved.IOReadWrite[addr] |= reserved.IOReadWrite[addr];
+    for(uInt16 addr = 0x00; addr <= 0x7F; ++addr)
+      myReserved.ZPRAM[addr] |= reserved.ZPRAM[addr];
+    myReserved.Label.insert(reserved.Label.begin(), reserved.Label.end());
+    breakFound = breakFound || reserved.breakFound;
   }
+  myReserved.breakFound = breakFound;
+  if (breakFound)
+    addLabel("Break", myDebugger.dpeek(0xfffe));
 
   // Some boilerplate, similar to what DiStella adds
   auto timeinfo = BSPF::localTime();
@@ -1083,8 +1239,12 @@ string CartDebug::saveDisassembly()
       << ";         i = indexed accessed only\n"
       << ";         c = used by code executed in RAM\n"
       << ";         s = used by stack\n"
-      << ";         ! = page crossed, 1 cycle penalty\n"
-      << "\n    processor 6502\n\n";
+      << ";         ! = page crossed, 1 cycle penalty\n";
+  if(profiler)
+    out << ";\n; Profile: % of all cycles, cycles, executions (x) and cycles waiting\n"
+        << ";          for WSYNC (w) of each instruction, " << dec
+        << profiler->totalCycles() << " cycles in total\n";
+  out << "\n    processor 6502\n\n";
 
   bool addrUsed = false;
   for(uInt16 addr = 0x00; addr <= 0x0F; ++addr)
@@ -1193,7 +1353,94 @@ string CartDebug::saveDisassembly()
   }
 
   // And finally, output the disassembly
-  out << buf.str();
+  out << "\n\n;***********************************************************\n"
+      << ";      Bank " << myConsole.cartridge().getBank();
+  if (myConsole.cartridge().bankCount() > 1)
+    out << " / 0.." << myConsole.cartridge().bankCount() - 1;
+  out << "\n;***********************************************************\n\n";
+
+  for(uInt32 b = 0; b < banks.size(); ++b)
+  {
+    const BankInfo& info = myBankInfo[banks[b]];
+    const Disassembly& disasm = results[b]->disasm;
+
+    out << "    SEG     CODE\n"
+        << "    ORG     $" << Base::HEX4 << info.offset << "\n\n";
+
+    // Format in 'distella' style
+    for(uInt32 i = 0; i < disasm.list.size(); ++i)
+    {
+      const DisassemblyTag& tag = disasm.list[i];
+
+      // Add label (if any)
+      if(tag.label != "")
+        out << ALIGN(4) << (tag.label) << "\n";
+      out << "    ";
+
+      switch(tag.type)
+      {
+        case CartDebug::CODE:
+        {
+          out << ALIGN(32) << tag.disasm << tag.ccount.substr(0, 5) << tag.ctotal << tag.ccount.substr(5, 2);
+          if(profiler)
+          {
+            const CycleProfiler::Counters* counters = profiler->find(banks[b], tag.address);
+            if(counters)
+            {
+              const uInt64 total = std::max(profiler->totalCycles(), uInt64(1));
+              out << " " << dec << std::fixed << std::setprecision(2) << right << setfill(' ')
+                  << setw(6) << (100.0 * counters->cycles / total) << "% "
+                  << counters->cycles << " " << counters->executions << "x";
+              if(counters->waits > 0)
+                out << " " << counters->waits << "w";
+            }
+          }
+          if (tag.disasm.find("WSYNC") != std::string::npos)
+            out << "\n;---------------------------------------";
+          break;
+        }
+        case CartDebug::ROW:
+        {
+          out << ".byte   " << ALIGN(32) << tag.disasm.substr(6, 8*4-1) << "; $" << Base::HEX4 << tag.address << " (*)";
+          break;
+        }
+        case CartDebug::GFX:
+        {
+          out << ".byte   " << (settings.gfxFormat == Base::F_2 ? "%" : "$")
+              << tag.bytes << " ; |";
+          for(int c = 12; c < 20; ++c)
+            out << ((tag.disasm[c] == '\x1e') ? "#" : " ");
+          out << ALIGN(13) << "|" << "$" << Base::HEX4 << tag.address << " (G)";
+          break;
+        }
+        case CartDebug::PGFX:
+        {
+          out << ".byte   " << (settings.gfxFormat == Base::F_2 ? "%" : "$")
+              << tag.bytes << " ; |";
+          for(int c = 12; c < 20; ++c)
+            out << ((tag.disasm[c] == '\x1f') ? "*" : " ");
+          out << ALIGN(13) << "|" << "$" << Base::HEX4 << tag.address << " (P)";
+          break;
+        }
+        case CartDebug::DATA:
+        {
+          out << ".byte   " << ALIGN(32) << tag.disasm.substr(6, 8 * 4 - 1) << "; $" << Base::HEX4 << tag.address << " (D)";
+          break;
+        }
+        case CartDebug::NONE:
+        default:
+        {
+          break;
+        }
+      } // switch
+      out << "\n";
+    }
+  }
+
+
+  out.close();
+  if(!out)
+    return DebuggerParser::red("unable to save disassembly to " + node.getShortPath());
 
   stringstream retVal;
   if(myConsole.cartridge().bankCount() > 1)
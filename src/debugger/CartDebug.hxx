@@ -20,6 +20,7 @@
 
 class Settings;
 class CartDebugWidget;
+class CycleProfiler;
 
 // Function type for CartDebug instance methods
 class CartDebug;
@@ -195,6 +196,11 @@ class CartDebug : public DebuggerSystem
     */
     bool removeLabel(const string& label);
 
+    /**
+      Changes whenever a user label is added or removed.
+    */
+    uInt32 labelsVersion() const { return myLabelsVersion; }
+
     /**
       Accessor methods for labels and addresses
 
@@ -227,8 +233,12 @@ class CartDebug : public DebuggerSystem
 
     /**
       Save disassembly and ROM file
+
+      The disassembly is saved to the given file (by default named after
+      the ROM), with every instruction annotated by the given profile.
     */
-    string saveDisassembly();
+    string saveDisassembly(const string& filename = "",
+                           const CycleProfiler* profiler = nullptr);
     string saveRom();
 
     /**
@@ -290,10 +300,18 @@ class CartDebug : public DebuggerSystem
     };
     ReservedEquates myReserved;
 
+    // Add a user label without updating the labels version; used when
+    // loading many labels at once
+    bool insertLabel(const string& label, uInt16 address);
+
     // Actually call DiStella to fill the DisassemblyList structure
     // Return whether the search address was actually in the list
     bool fillDisassemblyList(BankInfo& bankinfo, uInt16 search);
 
+    // Calculate a signature of everything a disassembly of the given bank
+    // depends on (contents, access flags, addresses, directives, settings)
+    uInt64 disassemblySignature(const BankInfo& bankinfo) const;
+
     // Analyze of bank of ROM, generating a list of Distella directives
     // based on its disassembly
     void getBankDirectives(ostream& buf, BankInfo& info) const;
@@ -325,6 +343,25 @@ class CartDebug : public DebuggerSystem
     std::map<uInt16, int> myAddrToLineList;
     bool myAddrToLineIsROM;
 
+    // Recently created disassemblies, most recently used first; switching
+    // back to a bank which hasn't changed since reuses its disassembly
+    // instead of running DiStella again
+    struct CachedDisassembly {
+      uInt64 signature;
+      Disassembly disassembly;
+      std::map<uInt16, int> addrToLineList;
+      uInt8 labels[0x1000], directives[0x1000];
+      uInt16 start, end, offset;  // BankInfo values set by DiStella
+    };
+    std::list<CachedDisassembly> myDisasmCache;
+    static constexpr uInt32 DISASM_CACHE_SIZE = 16;
+
+    // The output buffer used when saving a disassembly
+    static constexpr uInt32 DISASM_BUFFER_SIZE = 64 * 1024;
+
+    // Incremented whenever a user label is added or removed
+    uInt32 myLabelsVersion;
+
     // Mappings from label to address (and vice versa) for items
     // defined by the user (either through a DASM symbol file or manually
     // from the commandline in the debugger)
@@ -148,6 +148,42 @@ int CpuDebug::icycles() const
   return mySystem.m6502().icycles;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uInt8* CpuDebug::byteRegister(CpuMethod method) const
+{
+  const M6502& cpu = mySystem.m6502();
+
+  if(method == &CpuDebug::a)   return &cpu.A;
+  if(method == &CpuDebug::x)   return &cpu.X;
+  if(method == &CpuDebug::y)   return &cpu.Y;
+  if(method == &CpuDebug::sp)  return &cpu.SP;
+
+  return nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uInt16* CpuDebug::wordRegister(CpuMethod method) const
+{
+  return method == &CpuDebug::pc ? &mySystem.m6502().PC : nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const bool* CpuDebug::flagRegister(CpuMethod method, bool& inverted) const
+{
+  const M6502& cpu = mySystem.m6502();
+
+  inverted = method == &CpuDebug::z;
+  if(inverted)                return &cpu.notZ;
+  if(method == &CpuDebug::n)  return &cpu.N;
+  if(method == &CpuDebug::v)  return &cpu.V;
+  if(method == &CpuDebug::b)  return &cpu.B;
+  if(method == &CpuDebug::d)  return &cpu.D;
+  if(method == &CpuDebug::i)  return &cpu.I;
+  if(method == &CpuDebug::c)  return &cpu.C;
+
+  return nullptr;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CpuDebug::setPC(int pc)
 {
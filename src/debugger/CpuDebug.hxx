@@ -65,6 +65,14 @@ class CpuDebug : public DebuggerSystem
 
     int icycles() const;
 
+    // Direct access to the registers read by the methods above, so that
+    // compiled expressions don't have to call them; for all other methods,
+    // nullptr is returned
+    const uInt8* byteRegister(CpuMethod method) const;
+    const uInt16* wordRegister(CpuMethod method) const;
+    // The flag is inverted for z(), since the CPU keeps its complement
+    const bool* flagRegister(CpuMethod method, bool& inverted) const;
+
     void setPC(int pc);
     void setSP(int sp);
     void setPS(int ps);
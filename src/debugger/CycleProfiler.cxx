@@ -0,0 +1,185 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "FSNode.hxx"
+#include "Base.hxx"
+#include "CartDebug.hxx"
+#include "DebuggerParser.hxx"
+#include "CycleProfiler.hxx"
+
+constexpr uInt32 CycleProfiler::MAX_SCANLINES;
+constexpr uInt32 CycleProfiler::MAX_WAIT;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CycleProfiler::CycleProfiler()
+  : myCurrent(nullptr),
+    myPrevious(nullptr),
+    myLastCycles(0),
+    myTotalCycles(0),
+    myTotalWaits(0),
+    myScanline(0),
+    myFrame(0),
+    myLineCycles(0),
+    myLineWaits(0),
+    myFrameCycles(0),
+    myFrameWaits(0),
+    myFrameStarted(false),
+    myFrames(0),
+    myFramesCycles(0),
+    myFramesWaits(0),
+    myMinFrameCycles(0),
+    myMaxFrameCycles(0),
+    myMinFrame(0),
+    myMaxFrame(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const CycleProfiler::Counters* CycleProfiler::find(uInt16 bank, uInt16 pc) const
+{
+  if(bank >= myBanks.size() || !myBanks[bank])
+    return nullptr;
+
+  const Counters& c = (*myBanks[bank])[pc & 0x1fff];
+  return c.executions > 0 ? &c : nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CycleProfiler::endScanline(bool endFrame)
+{
+  // Only complete frames are counted per scanline and frame, so that
+  // profiling can start anywhere in a frame
+  if(myFrameStarted)
+  {
+    const uInt32 line = std::min(myScanline, MAX_SCANLINES - 1);
+    if(line >= myLines.size())
+      myLines.resize(line + 1, LineStats{0, 0, 0, UINT_MAX, 0});
+
+    LineStats& stats = myLines[line];
+    stats.cycles += myLineCycles;
+    stats.waits += myLineWaits;
+    stats.maxCycles = std::max(stats.maxCycles, myLineCycles);
+    stats.minWaits = std::min(stats.minWaits, myLineWaits);
+    ++stats.frames;
+  }
+  myLineCycles = myLineWaits = 0;
+
+  if(!endFrame)
+    return;
+
+  if(myFrameStarted)
+  {
+    if(myFrames == 0 || myFrameCycles < myMinFrameCycles)
+    {
+      myMinFrameCycles = myFrameCycles;
+      myMinFrame = myFrame;
+    }
+    if(myFrames == 0 || myFrameCycles > myMaxFrameCycles)
+    {
+      myMaxFrameCycles = myFrameCycles;
+      myMaxFrame = myFrame;
+    }
+    myFramesCycles += myFrameCycles;
+    myFramesWaits += myFrameWaits;
+    ++myFrames;
+  }
+  myFrameStarted = true;
+  myFrameCycles = myFrameWaits = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string CycleProfiler::save(const FilesystemNode& node,
+                           const CartDebug& cartDebug) const
+{
+  using Common::Base;
+
+  ofstream out(node.getPath());
+  if(!out.is_open())
+    return DebuggerParser::red("unable to save profile to " + node.getShortPath());
+
+  const auto percent = [](uInt64 part, uInt64 total) {
+    return total > 0 ? 100.0 * part / total : 0.0;
+  };
+
+  out << std::fixed << std::setprecision(2)
+      << "; " << myTotalCycles << " CPU cycles executed, " << myTotalWaits
+      << " cycles waiting for WSYNC (" << percent(myTotalWaits, myTotalCycles + myTotalWaits)
+      << "%)\n";
+  if(myFrames > 0)
+    out << "; " << myFrames << " complete frames: "
+        << double(myFramesCycles) / myFrames << " cycles executed and "
+        << double(myFramesWaits) / myFrames << " waiting per frame, "
+        << "min " << myMinFrameCycles << " (frame " << myMinFrame << "), "
+        << "max " << myMaxFrameCycles << " (frame " << myMaxFrame << ")\n";
+
+  // The flat profile, hottest addresses first
+  struct Entry { uInt16 bank; const Counters* counters; };
+  vector<Entry> entries;
+  for(uInt32 bank = 0; bank < myBanks.size(); ++bank)
+    if(myBanks[bank])
+      for(const Counters& c: *myBanks[bank])
+        if(c.executions > 0)
+          entries.push_back({ uInt16(bank), &c });
+  std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+    return a.counters->cycles > b.counters->cycles;
+  });
+
+  out << "\n      cycles       %  executions  cyc/exec       waits  bank  address\n";
+  for(const Entry& e: entries)
+  {
+    const Counters& c = *e.counters;
+    out.flags(std::ios::dec | std::ios::fixed);
+    out << std::setfill(' ') << std::setw(12) << c.cycles << " "
+        << std::setw(7) << percent(c.cycles, myTotalCycles) << " "
+        << std::setw(11) << c.executions << " "
+        << std::setw(9) << double(c.cycles) / c.executions << " "
+        << std::setw(11) << c.waits << " "
+        << std::setw(5) << e.bank << "  $" << Base::HEX4 << c.pc;
+
+    const string& label = cartDebug.getLabel(c.pc, true);
+    if(label != "")
+      out << "  " << label;
+    out << "\n";
+  }
+
+  // Statistics per scanline, where a line with a minimum wait of 0 used
+  // all of its 76 cycles at least once
+  if(myFrames > 0)
+  {
+    out.flags(std::ios::dec | std::ios::fixed);
+    out << std::setfill(' ')
+        << "\n; cycles per scanline, in " << myFrames << " complete frames\n"
+        << "\nscanline  avg cycles  max cycles   avg waits   min waits\n";
+    for(uInt32 line = 0; line < myLines.size(); ++line)
+    {
+      const LineStats& stats = myLines[line];
+      if(stats.frames == 0)
+        continue;
+
+      out << std::setw(8) << line << " "
+          << std::setw(11) << double(stats.cycles) / stats.frames << " "
+          << std::setw(11) << stats.maxCycles << " "
+          << std::setw(11) << double(stats.waits) / stats.frames << " "
+          << std::setw(11) << stats.minWaits << "\n";
+    }
+  }
+
+  if(!out)
+    return DebuggerParser::red("unable to save profile to " + node.getShortPath());
+
+  return "saved profile to " + node.getShortPath();
+}
@@ -0,0 +1,190 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef CYCLE_PROFILER_HXX
+#define CYCLE_PROFILER_HXX
+
+class CartDebug;
+class FilesystemNode;
+
+#include <array>
+
+#include "bspf.hxx"
+
+/**
+  Counts the CPU cycles spent at every (bank, address), so ROM developers
+  can see where the time goes.  For each executed instruction, the cycles
+  it took and the number of executions are accumulated, along with the
+  cycles the CPU was halted by the WSYNC write of that instruction.
+
+  The cycles are also summed up per scanline (by the scanline each
+  instruction starts on) and per frame, which shows the kernel lines that
+  use up their whole budget of 76 cycles, and how much time is left in a
+  frame.
+
+  The profile can be saved as a flat list sorted by cycles; CartDebug
+  can annotate a disassembly with it as well.
+
+  @author  Stephen Anthony
+*/
+class CycleProfiler
+{
+  public:
+    struct Counters {
+      uInt64 cycles;
+      uInt64 waits;
+      uInt32 executions;
+      uInt16 pc;  // the address the instruction was last executed at
+    };
+
+    struct LineStats {
+      uInt64 cycles;
+      uInt64 waits;
+      uInt32 maxCycles;
+      uInt32 minWaits;
+      uInt32 frames;
+    };
+
+    // Scanlines beyond this are counted as the last one
+    static constexpr uInt32 MAX_SCANLINES = 512;
+
+  public:
+    CycleProfiler();
+
+    /**
+      Account for the instruction which has just completed, and start the
+      one about to be executed.
+
+      @param pc        The address of the next instruction
+      @param bank      The bank of the next instruction
+      @param cycles    The current system cycle
+      @param icycles   The CPU cycles taken by the completed instruction
+      @param scanline  The current scanline
+      @param frame     The current frame number
+    */
+    void beginInstruction(uInt16 pc, uInt16 bank, uInt64 cycles,
+                          uInt32 icycles, uInt32 scanline, uInt32 frame)
+    {
+      if(myCurrent)
+      {
+        // A WSYNC stall is applied at the first read after the write, which
+        // is the opcode fetch of the instruction following the one writing
+        const uInt64 total = cycles - myLastCycles;
+        const uInt32 waits = (cycles >= myLastCycles && total >= icycles &&
+                              total - icycles <= MAX_WAIT) ? uInt32(total - icycles) : 0;
+
+        myCurrent->cycles += icycles;
+        ++myCurrent->executions;
+        if(myPrevious)
+          myPrevious->waits += waits;
+
+        myTotalCycles += icycles;
+        myTotalWaits += waits;
+        myLineCycles += icycles;
+        myLineWaits += waits;
+        myFrameCycles += icycles;
+        myFrameWaits += waits;
+
+        if(scanline != myScanline || frame != myFrame)
+          endScanline(frame != myFrame);
+      }
+      myScanline = scanline;
+      myFrame = frame;
+
+      myPrevious = myCurrent;
+      myCurrent = &counters(bank, pc);
+      myCurrent->pc = pc;
+      myLastCycles = cycles;
+    }
+
+    /**
+      The counters of the given (bank, address), or the null pointer if
+      it has never been executed.
+    */
+    const Counters* find(uInt16 bank, uInt16 pc) const;
+
+    /**
+      The cycles executed and spent waiting for WSYNC in total, and the
+      number of complete frames profiled.
+    */
+    uInt64 totalCycles() const { return myTotalCycles; }
+    uInt64 totalWaits() const { return myTotalWaits; }
+    uInt32 frames() const { return myFrames; }
+
+    /**
+      Save the profile as text, the hottest addresses first, followed by
+      the statistics per scanline and per frame.
+
+      @param node       The file to create
+      @param cartDebug  Used to look up labels
+      @return  A message describing the result
+    */
+    string save(const FilesystemNode& node, const CartDebug& cartDebug) const;
+
+  private:
+    using Bank = std::array<Counters, 0x2000>;
+
+    // The longest WSYNC halt possible; anything longer is a discontinuity
+    // (a state was loaded)
+    static constexpr uInt32 MAX_WAIT = 76;
+
+    Counters& counters(uInt16 bank, uInt16 pc)
+    {
+      if(bank >= myBanks.size())
+        myBanks.resize(bank + 1);
+      if(!myBanks[bank])
+        myBanks[bank] = make_unique<Bank>();
+
+      return (*myBanks[bank])[pc & 0x1fff];
+    }
+
+    void endScanline(bool endFrame);
+
+  private:
+    // Counters of each bank, only allocated when a bank is executed
+    vector<unique_ptr<Bank>> myBanks;
+
+    // The instruction being executed, and the one before
+    Counters* myCurrent;
+    Counters* myPrevious;
+    uInt64 myLastCycles;
+
+    uInt64 myTotalCycles, myTotalWaits;
+
+    // The current scanline and frame, and the cycles counted so far
+    uInt32 myScanline, myFrame;
+    uInt32 myLineCycles, myLineWaits;
+    uInt64 myFrameCycles, myFrameWaits;
+
+    vector<LineStats> myLines;
+
+    // Complete frames; the first one is only partially profiled
+    bool myFrameStarted;
+    uInt32 myFrames;
+    uInt64 myFramesCycles, myFramesWaits;
+    uInt64 myMinFrameCycles, myMaxFrameCycles;
+    uInt32 myMinFrame, myMaxFrame;
+
+  private:
+    // Following constructors and assignment operators not supported
+    CycleProfiler(const CycleProfiler&) = delete;
+    CycleProfiler(CycleProfiler&&) = delete;
+    CycleProfiler& operator=(const CycleProfiler&) = delete;
+    CycleProfiler& operator=(CycleProfiler&&) = delete;
+};
+
+#endif
@@ -41,6 +41,10 @@
 #include "CpuDebug.hxx"
 #include "RiotDebug.hxx"
 #include "TIADebug.hxx"
+#include "TraceRecorder.hxx"
+#include "CycleProfiler.hxx"
+#include "ThumbProfiler.hxx"
+#include "MemoryWatcher.hxx"
 
 #include "TiaInfoWidget.hxx"
 #include "TiaOutputWidget.hxx"
@@ -52,6 +56,7 @@
 #include "YaccParser.hxx"
 
 #include "TIA.hxx"
+#include "EmulationTiming.hxx"
 #include "Debugger.hxx"
 #include "DispatchResult.hxx"
 
@@ -65,6 +70,8 @@ Debugger::Debugger(OSystem& osystem, Console& console)
     myConsole(console),
     mySystem(console.system()),
     myDialog(nullptr),
+    myProfiling(false),
+    myFunctionsVersion(0),
     myWidth(DebuggerDialog::kSmallFontMinW),
     myHeight(DebuggerDialog::kSmallFontMinH)
 {
@@ -77,11 +84,16 @@ Debugger::Debugger(OSystem& osystem, Console& console)
   myRiotDebug = make_unique<RiotDebug>(*this, myConsole);
   myTiaDebug  = make_unique<TIADebug>(*this, myConsole);
 
+  myMemoryWatcher = make_unique<MemoryWatcher>(mySystem);
+
   // Allow access to this object from any class
   // Technically this violates pure OO programming, but since I know
   // there will only be ever one instance of debugger in Stella,
   // I don't care :)
   myStaticDebugger = this;
+
+  // Expressions parsed for another ROM may refer to other labels
+  YaccParser::clearCache();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -177,17 +189,10 @@ string Debugger::autoExec(StringList* history)
   FilesystemNode romname(myOSystem.romFile().getPathWithExt(".script"));
   buf << myParser->exec(romname, history) << endl;
 
-  // Init builtins
+  // Init builtins; they are parsed by getFunction() when first used
   for(uInt32 i = 0; i < NUM_BUILTIN_FUNCS; ++i)
-  {
-    // TODO - check this for memory leaks
-    int res = YaccParser::parse(ourBuiltinFunctions[i].defn);
-    if(res == 0)
-      addFunction(ourBuiltinFunctions[i].name, ourBuiltinFunctions[i].defn,
-                  YaccParser::getResult(), true);
-    else
-      cerr << "ERROR in builtin function!" << endl;
-  }
+    addFunction(ourBuiltinFunctions[i].name, ourBuiltinFunctions[i].defn,
+                nullptr, true);
   return buf.str();
 }
 
@@ -234,6 +239,7 @@ void Debugger::reset()
   unlockSystem();
   mySystem.reset();
   lockSystem();
+  myMemoryWatcher->invalidate();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -276,6 +282,7 @@ void Debugger::loadState(int state)
 {
   // We're loading a new state, so we start with a clean slate
   mySystem.clearDirtyPages();
+  myMemoryWatcher->invalidate();
 
   // State loading could initiate a bankswitch, so we allow it temporarily
   unlockSystem();
@@ -288,6 +295,7 @@ void Debugger::loadAllStates()
 {
   // We're loading new states, so we start with a clean slate
   mySystem.clearDirtyPages();
+  myMemoryWatcher->invalidate();
 
   // State loading could initiate a bankswitch, so we allow it temporarily
   unlockSystem();
@@ -380,6 +388,55 @@ bool Debugger::checkBreakPoint(uInt16 addr, uInt8 bank)
   return breakPoints().check(addr, bank);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Debugger::startTraceRecording(uInt32 size)
+{
+  myTraceRecorder = make_unique<TraceRecorder>(size);
+  mySystem.m6502().setTraceRecorder(myTraceRecorder.get());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Debugger::stopTraceRecording()
+{
+  mySystem.m6502().setTraceRecorder(nullptr);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Debugger::startProfiling()
+{
+  myProfiler = make_unique<CycleProfiler>();
+  mySystem.m6502().setProfiler(myProfiler.get());
+
+  // The previous profile may still be in use by the ARM code until the
+  // new one is set
+  auto thumbProfiler = make_unique<ThumbProfiler>();
+  if(myConsole.cartridge().setThumbProfiler(thumbProfiler.get()))
+    myThumbProfiler = std::move(thumbProfiler);
+  else
+    myThumbProfiler.reset();
+
+  myProfiling = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Debugger::stopProfiling()
+{
+  mySystem.m6502().setProfiler(nullptr);
+  myConsole.cartridge().setThumbProfiler(nullptr);
+  myProfiling = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const ThumbProfiler* Debugger::thumbProfiler()
+{
+  // Setting the profiler again finishes any ARM code still running, which
+  // could change the profile while it's read
+  if(myThumbProfiler && myProfiling)
+    myConsole.cartridge().setThumbProfiler(myThumbProfiler.get());
+
+  return myThumbProfiler.get();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Debugger::toggleBreakPoint(uInt16 addr, uInt8 bank)
 {
@@ -578,6 +635,53 @@ void Debugger::nextFrame(int frames)
   addState(buf.str());
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 Debugger::runUntil(shared_ptr<const Expression> condition, const string& name,
+                          uInt32 seconds, string& message)
+{
+  M6502& cpu = mySystem.m6502();
+  TIA& tia = myOSystem.console().tia();
+  const EmulationTiming& timing = myOSystem.console().emulationTiming();
+  const uInt64 startCycle = mySystem.cycles();
+  const uInt64 maxCycles = uInt64(seconds) * timing.cyclesPerSecond();
+
+  saveOldState();
+
+  // Conditional breakpoints are checked from the last one added, so ours
+  // comes first; remember the message the CPU would report for it
+  uInt32 index = cpu.addCondBreak(condition, name);
+  ostringstream buf;
+  buf << "CBP[" << Common::Base::HEX2 << index << "]: " << name;
+  const string ownMessage = buf.str();
+
+  unlockSystem();
+
+  // Always execute at least one instruction, so we don't stop right away
+  tia.updateScanlineByStep();
+
+  // Run whole timeslices, without any debugger or GUI updates in between
+  DispatchResult dispatchResult;
+  dispatchResult.setOk(0);
+  while(dispatchResult.getStatus() == DispatchResult::Status::ok &&
+        mySystem.cycles() - startCycle < maxCycles)
+    tia.update(dispatchResult, timing.maxCyclesPerTimeslice());
+
+  tia.flushLineCache();
+  lockSystem();
+
+  cpu.delCondBreak(index);
+
+  if(dispatchResult.getStatus() == DispatchResult::Status::ok)
+    message = "timed out after " + std::to_string(seconds) + " seconds";
+  else if(dispatchResult.getMessage() != ownMessage)
+    message = dispatchResult.getMessage();
+  else
+    message = "";
+
+  addState("run until " + name);
+  return mySystem.cycles() - startCycle;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Debugger::updateRewindbuttons(const RewindManager& r)
 {
@@ -599,6 +703,7 @@ uInt16 Debugger::windStates(uInt16 numStates, bool unwind, string& message)
   message = r.getUnitString(myOSystem.console().tia().cycles() - startCycles);
 
   lockSystem();
+  myMemoryWatcher->invalidate();
 
   updateRewindbuttons(r);
   return winds;
@@ -651,7 +756,11 @@ bool Debugger::patchROM(uInt16 addr, uInt8 value)
 void Debugger::saveOldState(bool clearDirtyPages)
 {
   if(clearDirtyPages)
+  {
+    // Don't lose the pages written since the watches were last updated
+    myMemoryWatcher->collect();
     mySystem.clearDirtyPages();
+  }
 
   lockSystem();
   myCartDebug->saveOldState();
@@ -676,6 +785,12 @@ void Debugger::setStartState()
   // Lock the bus each time the debugger is entered, so we don't disturb anything
   lockSystem();
 
+  // Track the accesses while debugging, for the disassembly
+  mySystem.enableAccessFlags(true);
+
+  // States may have been loaded while running, which doesn't dirty any pages
+  myMemoryWatcher->invalidate();
+
   // Save initial state and add it to the rewind list (except when in currently rewinding)
   RewindManager& r = myOSystem.state().rewindManager();
   // avoid invalidating future states when entering the debugger e.g. during rewind
@@ -701,14 +816,17 @@ void Debugger::setQuitState()
   // sitting at a breakpoint/trap, this will get us past it.
   // Somehow this feels like a hack to me, but I don't know why
   mySystem.m6502().execute(1);
+
+  mySystem.enableAccessFlags(myOSystem.settings().getBool("dev.settings"));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Debugger::addFunction(const string& name, const string& definition,
-                           Expression* exp, bool builtin)
+                           shared_ptr<const Expression> exp, bool builtin)
 {
-  myFunctions.emplace(name, unique_ptr<Expression>(exp));
+  myFunctions.emplace(name, exp);
   myFunctionDefs.emplace(name, definition);
+  ++myFunctionsVersion;
 
   return true;
 }
@@ -740,6 +858,7 @@ bool Debugger::delFunction(const string& name)
     return false;
 
   myFunctionDefs.erase(name);
+  ++myFunctionsVersion;
   return true;
 }
 
@@ -747,7 +866,19 @@ bool Debugger::delFunction(const string& name)
 const Expression& Debugger::getFunction(const string& name) const
 {
   const auto& iter = myFunctions.find(name);
-  return iter != myFunctions.end() ? *(iter->second.get()) : EmptyExpression;
+  if(iter == myFunctions.end())
+    return EmptyExpression;
+
+  if(!iter->second)
+  {
+    iter->second = YaccParser::parseCached(getFunctionDef(name));
+    if(!iter->second)
+    {
+      cerr << "ERROR in builtin function!" << endl;
+      return EmptyExpression;
+    }
+  }
+  return *iter->second;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -40,6 +40,10 @@ class RiotDebug;
 class TIADebug;
 class DebuggerParser;
 class RewindManager;
+class TraceRecorder;
+class CycleProfiler;
+class ThumbProfiler;
+class MemoryWatcher;
 
 #include <map>
 
@@ -49,7 +53,7 @@ class RewindManager;
 #include "FrameBufferConstants.hxx"
 #include "bspf.hxx"
 
-using FunctionMap = std::map<string, unique_ptr<Expression>>;
+using FunctionMap = std::map<string, shared_ptr<const Expression>>;
 using FunctionDefMap = std::map<string, string>;
 
 /**
@@ -105,11 +109,17 @@ class Debugger : public DialogContainer
     void quit(bool exitrom);
 
     bool addFunction(const string& name, const string& def,
-                     Expression* exp, bool builtin = false);
+                     shared_ptr<const Expression> exp, bool builtin = false);
     bool isBuiltinFunction(const string& name);
     bool delFunction(const string& name);
     const Expression& getFunction(const string& name) const;
 
+    /**
+      Incremented whenever a function is added or removed, which changes
+      how expressions are parsed.
+    */
+    uInt32 functionsVersion() const { return myFunctionsVersion; }
+
     const string& getFunctionDef(const string& name) const;
     const FunctionDefMap getFunctionDefMap() const;
     string builtinHelp() const;
@@ -145,6 +155,11 @@ class Debugger : public DialogContainer
     */
     TIADebug& tiaDebug() const { return *myTiaDebug; }
 
+    /**
+      Tracks changes in subscribed address ranges
+    */
+    MemoryWatcher& memoryWatcher() const { return *myMemoryWatcher; }
+
     const GUI::Font& lfont() const      { return myDialog->lfont();     }
     const GUI::Font& nlfont() const     { return myDialog->nfont();     }
     DebuggerParser& parser() const      { return *myParser;             }
@@ -186,6 +201,42 @@ class Debugger : public DialogContainer
     */
     bool checkBreakPoint(uInt16 addr, uInt8 bank);
 
+    /**
+      Start recording executed instructions, keeping the most recent
+      'size' of them; any previous recording is discarded.
+    */
+    void startTraceRecording(uInt32 size);
+
+    /**
+      Stop recording; the recorded instructions are kept until the next
+      recording starts.
+    */
+    void stopTraceRecording();
+
+    /**
+      The most recent recording, or the null pointer if there is none.
+    */
+    const TraceRecorder* traceRecorder() const { return myTraceRecorder.get(); }
+
+    /**
+      Start counting the cycles of executed instructions, of the CPU as
+      well as of the cartridge's ARM code (if any); any previous profile
+      is discarded.
+    */
+    void startProfiling();
+
+    /**
+      Stop profiling; the profile is kept until the next one starts.
+    */
+    void stopProfiling();
+
+    /**
+      The most recent profiles of the CPU and of the ARM code, or the null
+      pointer if there is none.
+    */
+    const CycleProfiler* profiler() const { return myProfiler.get(); }
+    const ThumbProfiler* thumbProfiler();
+
     /**
       Run the debugger command and return the result.
     */
@@ -309,6 +360,23 @@ class Debugger : public DialogContainer
     int trace();
     void nextScanline(int lines);
     void nextFrame(int frames);
+
+    /**
+      Run at full speed until the given condition is true, another
+      breakpoint or trap is hit, or the timeout expires.  The condition is
+      checked like any other conditional breakpoint, and nothing in the
+      debugger is updated until the run stops.
+
+      @param condition  The condition to stop at (ownership is taken)
+      @param name       The text of the condition
+      @param seconds    The timeout, in seconds of emulated time
+      @param message    Set to why the run stopped if the condition wasn't
+                        reached (timeout or another break), else empty
+
+      @return  The number of cycles executed
+    */
+    uInt64 runUntil(shared_ptr<const Expression> condition, const string& name, uInt32 seconds,
+                    string& message);
     uInt16 rewindStates(const uInt16 numStates, string& message);
     uInt16 unwindStates(const uInt16 numStates, string& message);
 
@@ -344,11 +412,20 @@ class Debugger : public DialogContainer
     unique_ptr<CpuDebug>       myCpuDebug;
     unique_ptr<RiotDebug>      myRiotDebug;
     unique_ptr<TIADebug>       myTiaDebug;
+    unique_ptr<TraceRecorder>  myTraceRecorder;
+    unique_ptr<CycleProfiler>  myProfiler;
+    unique_ptr<ThumbProfiler>  myThumbProfiler;
+    unique_ptr<MemoryWatcher>  myMemoryWatcher;
+
+    // Set while the profilers are counting
+    bool myProfiling;
 
     static Debugger* myStaticDebugger;
 
-    FunctionMap myFunctions;
+    // The built-in functions are only parsed when they are first used
+    mutable FunctionMap myFunctions;
     FunctionDefMap myFunctionDefs;
+    uInt32 myFunctionsVersion;
 
     // Dimensions of the entire debugger window
     uInt32 myWidth;
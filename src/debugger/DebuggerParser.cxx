@@ -35,6 +35,12 @@
 #include "RomWidget.hxx"
 #include "ProgressDialog.hxx"
 #include "TimerManager.hxx"
+#include "PerfCounters.hxx"
+#include "TraceRecorder.hxx"
+#include "CycleProfiler.hxx"
+#include "ThumbProfiler.hxx"
+#include "StateProfile.hxx"
+#include "MemoryWatcher.hxx"
 #include "Vec.hxx"
 
 #include "Base.hxx"
@@ -301,27 +307,87 @@ int DebuggerParser::decipher_arg(const string& str)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string DebuggerParser::showWatches()
 {
+  // Find out which of the dereferenced cells changed since the last time
+  debugger.memoryWatcher().update();
+
   ostringstream buf;
   for(uInt32 i = 0; i < myWatches.size(); ++i)
   {
     if(myWatches[i] != "")
     {
-      // Clear the args, since we're going to pass them to eval()
-      argStrings.clear();
-      args.clear();
-
-      argCount = 1;
-      argStrings.push_back(myWatches[i]);
-      args.push_back(decipher_arg(argStrings[0]));
-      if(args[0] < 0)
-        buf << "BAD WATCH " << (i+1) << ": " << argStrings[0] << endl;
+      WatchCache& cache = *myWatchCache[i];
+
+      // The watched address depends on the labels and the default base
+      if(cache.labelsVersion != debugger.cartDebug().labelsVersion() ||
+         cache.format != Base::format())
+        subscribeWatch(cache, myWatches[i]);
+
+      if(!cache.constant || cache.changed)
+      {
+        // Clear the args, since we're going to pass them to eval()
+        argStrings.clear();
+        args.clear();
+
+        argCount = 1;
+        argStrings.push_back(myWatches[i]);
+        args.push_back(decipher_arg(argStrings[0]));
+        cache.result = args[0] < 0 ? "" : eval();
+        cache.changed = false;
+      }
+      if(cache.result == "")
+        buf << "BAD WATCH " << (i+1) << ": " << myWatches[i] << endl;
       else
-        buf << " watch #" << (i+1) << " (" << argStrings[0] << ") -> " << eval() << endl;
+        buf << " watch #" << (i+1) << " (" << myWatches[i] << ") -> " << cache.result << endl;
     }
   }
   return buf.str();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DebuggerParser::subscribeWatch(WatchCache& cache, const string& watch)
+{
+  MemoryWatcher& watcher = debugger.memoryWatcher();
+  if(cache.subscription)
+    watcher.unsubscribe(cache.subscription);
+
+  cache.subscription = 0;
+  cache.changed = true;
+  cache.labelsVersion = debugger.cartDebug().labelsVersion();
+  cache.format = Base::format();
+
+  // Strip the prefixes (see decipher_arg()) to find out whether the
+  // watch uses a register, and which cells it dereferences (if any)
+  string arg = watch;
+  uInt16 size = 0;
+  if(arg.substr(0, 1) == "*") {
+    size = 1;
+    arg.erase(0, 1);
+  } else if(arg.substr(0, 1) == "@") {
+    size = 2;
+    arg.erase(0, 1);
+  }
+  const string address = arg;
+  if(arg.substr(0, 1) == "<" || arg.substr(0, 1) == ">")
+    arg.erase(0, 1);
+  if(arg.substr(0, 1) == "\\" || arg.substr(0, 1) == "#" || arg.substr(0, 1) == "$")
+    arg.erase(0, 1);
+
+  cache.constant = !((arg == "a" && watch != "$a") || arg == "x" || arg == "y" ||
+                     arg == "p" || arg == "s" || arg == "pc" || arg == ".");
+  if(cache.constant && size > 0)
+  {
+    int addr = decipher_arg(address);
+    if(addr >= 0 && addr <= 0xFFFF)
+    {
+      WatchCache* c = &cache;
+      cache.subscription = watcher.subscribe(addr, addr + size - 1,
+          [c](uInt16, uInt8, uInt8) { c->changed = true; });
+    }
+    else
+      cache.constant = false;
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // Private methods below
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -391,13 +457,8 @@ bool DebuggerParser::getArgs(const string& command, string& verb)
 
   for(uInt32 arg = 0; arg < argCount; ++arg)
   {
-    if(!YaccParser::parse(argStrings[arg].c_str()))
-    {
-      unique_ptr<Expression> expr(YaccParser::getResult());
-      args.push_back(expr->evaluate());
-    }
-    else
-      args.push_back(-1);
+    const auto expr = YaccParser::parseCached(argStrings[arg]);
+    args.push_back(expr ? expr->evaluate() : -1);
   }
 
   return true;
@@ -786,8 +847,8 @@ void DebuggerParser::executeBreak()
 // "breakif"
 void DebuggerParser::executeBreakif()
 {
-  int res = YaccParser::parse(argStrings[0].c_str());
-  if(res == 0)
+  const auto expr = YaccParser::parseCached(argStrings[0]);
+  if(expr)
   {
     string condition = argStrings[0];
     for(uInt32 i = 0; i < debugger.m6502().getCondBreakNames().size(); ++i)
@@ -799,8 +860,7 @@ void DebuggerParser::executeBreakif()
         return;
       }
     }
-    uInt32 ret = debugger.m6502().addCondBreak(
-                 YaccParser::getResult(), argStrings[0]);
+    uInt32 ret = debugger.m6502().addCondBreak(expr, argStrings[0]);
     commandResult << "added breakif " << Base::toString(ret);
   }
   else
@@ -900,7 +960,12 @@ void DebuggerParser::executeCleartraps()
 // "clearwatches"
 void DebuggerParser::executeClearwatches()
 {
+  for(const auto& cache: myWatchCache)
+    if(cache->subscription)
+      debugger.memoryWatcher().unsubscribe(cache->subscription);
+
   myWatches.clear();
+  myWatchCache.clear();
   commandResult << "all watches cleared";
 }
 
@@ -1046,7 +1111,11 @@ void DebuggerParser::executeDelwatch()
   int which = args[0] - 1;
   if(which >= 0 && which < int(myWatches.size()))
   {
+    if(myWatchCache[which]->subscription)
+      debugger.memoryWatcher().unsubscribe(myWatchCache[which]->subscription);
+
     Vec::removeAt(myWatches, which);
+    Vec::removeAt(myWatchCache, which);
     commandResult << "removed watch";
   }
   else
@@ -1260,10 +1329,10 @@ void DebuggerParser::executeFunction()
     return;
   }
 
-  int res = YaccParser::parse(argStrings[1].c_str());
-  if(res == 0)
+  const auto expr = YaccParser::parseCached(argStrings[1]);
+  if(expr)
   {
-    debugger.addFunction(argStrings[0], argStrings[1], YaccParser::getResult());
+    debugger.addFunction(argStrings[0], argStrings[1], expr);
     commandResult << "added function " << argStrings[0] << " -> " << argStrings[1];
   }
   else
@@ -1631,6 +1700,27 @@ void DebuggerParser::executePc()
   debugger.cpuDebug().setPC(args[0]);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "perf"
+void DebuggerParser::executePerf()
+{
+  if(argCount == 1)
+  {
+    if(argStrings[0] != "reset")
+    {
+      outputCommandError("unknown argument", myCommand);
+      return;
+    }
+    PerfCounters::reset();
+    commandResult << "performance counters reset";
+    return;
+  }
+
+  ostringstream buf;
+  PerfCounters::print(buf);
+  commandResult << buf.str();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "pgfx"
 void DebuggerParser::executePGfx()
@@ -1660,6 +1750,32 @@ void DebuggerParser::executePrint()
   commandResult << eval();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "profile"
+void DebuggerParser::executeProfile()
+{
+  if(argCount == 1 && args[0] == 0)
+  {
+    debugger.stopProfiling();
+    const CycleProfiler* profiler = debugger.profiler();
+    commandResult << "profiling stopped";
+    if(profiler)
+      commandResult << ", " << dec << profiler->totalCycles() << " cycles in "
+                    << profiler->frames() << " complete frames profiled";
+    const ThumbProfiler* thumbProfiler = debugger.thumbProfiler();
+    if(thumbProfiler)
+      commandResult << ", " << dec << thumbProfiler->cycles() << " ARM cycles in "
+                    << thumbProfiler->runs() << " runs";
+  }
+  else
+  {
+    debugger.startProfiling();
+    commandResult << "profiling cycles of executed instructions";
+    if(debugger.thumbProfiler())
+      commandResult << " (including ARM code)";
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "ram"
 void DebuggerParser::executeRam()
@@ -1801,27 +1917,55 @@ void DebuggerParser::executeRunTo()
 // "runtopc"
 void DebuggerParser::executeRunToPc()
 {
-  const CartDebug& cartdbg = debugger.cartDebug();
-  const CartDebug::DisassemblyList& list = cartdbg.disassembly().list;
+  // Compare without the mirror bits, like the disassembly does
+  ostringstream condition;
+  condition << "(pc&$1fff)==$" << Base::HEX4 << (args[0] & 0x1fff);
+  const auto expr = YaccParser::parseCached(condition.str());
+  if(!expr)
+  {
+    commandResult << red("invalid expression");
+    return;
+  }
 
-  uInt32 count = 0;
-  bool done = false;
-  do {
-    debugger.step();
+  string message;
+  uInt64 cycles = debugger.runUntil(expr, condition.str(),
+                                    RUN_TIMEOUT, message);
+  if(message == "")
+    commandResult
+      << "set PC to " << Base::HEX4 << args[0] << " in "
+      << dec << cycles << " cycles";
+  else
+    commandResult
+      << "PC " << Base::HEX4 << args[0] << " not reached ("
+      << message << ") in " << dec << cycles << " cycles";
+}
 
-    // Update romlist to point to current PC
-    int pcline = cartdbg.addressToLine(debugger.cpuDebug().pc());
-    done = (pcline >= 0) && (list[pcline].address == args[0]);
-  } while(!done && ++count < list.size());
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "rununtil"
+void DebuggerParser::executeRunUntil()
+{
+  if(argCount > 2 || (argCount == 2 && args[1] <= 0))
+  {
+    outputCommandError("wrong number of arguments", myCommand);
+    return;
+  }
+  const auto expr = YaccParser::parseCached(argStrings[0]);
+  if(!expr)
+  {
+    commandResult << red("invalid expression");
+    return;
+  }
+  uInt32 seconds = argCount == 2 ? args[1] : RUN_TIMEOUT;
 
-  if(done)
+  string message;
+  uInt64 cycles = debugger.runUntil(expr, argStrings[0], seconds, message);
+  if(message == "")
     commandResult
-      << "set PC to " << Base::HEX4 << args[0] << " in "
-      << dec << count << " disassembled instructions";
+      << argStrings[0] << " reached in " << dec << cycles << " cycles";
   else
     commandResult
-      << "PC " << Base::HEX4 << args[0] << " not reached or found in "
-      << dec << count << " disassembled instructions";
+      << argStrings[0] << " not reached (" << message << ") in "
+      << dec << cycles << " cycles";
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1849,7 +1993,54 @@ void DebuggerParser::executeSaveconfig()
 // "savedis"
 void DebuggerParser::executeSavedisassembly()
 {
-  commandResult << debugger.cartDebug().saveDisassembly();
+  if(argCount == 1)
+    commandResult << debugger.cartDebug().saveDisassembly(
+      debugger.myOSystem.defaultSaveDir() + argStrings[0]);
+  else
+    commandResult << debugger.cartDebug().saveDisassembly();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "saveperf"
+void DebuggerParser::executeSaveperf()
+{
+  ostringstream filename;
+  auto timeinfo = BSPF::localTime();
+  filename << debugger.myOSystem.defaultSaveDir()
+           << std::put_time(&timeinfo, "perf_%F_%H-%M-%S.txt");
+  FilesystemNode file(filename.str());
+  if(PerfCounters::save(file.getPath()))
+    commandResult << "saved " + file.getShortPath() + " OK";
+  else
+    commandResult << "unable to save performance counters";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "saveprofile"
+void DebuggerParser::executeSaveprofile()
+{
+  const CycleProfiler* profiler = debugger.profiler();
+  if(!profiler)
+  {
+    commandResult << red("no profile recorded");
+    return;
+  }
+
+  ostringstream filename;
+  auto timeinfo = BSPF::localTime();
+  filename << debugger.myOSystem.defaultSaveDir()
+           << std::put_time(&timeinfo, "profile_%F_%H-%M-%S");
+  commandResult << profiler->save(FilesystemNode(filename.str() + ".txt"),
+                                  debugger.cartDebug())
+                << endl
+                << debugger.cartDebug().saveDisassembly(filename.str() + ".asm",
+                                                        profiler);
+
+  const ThumbProfiler* thumbProfiler = debugger.thumbProfiler();
+  if(thumbProfiler)
+    commandResult << endl << thumbProfiler->save(
+      FilesystemNode(filename.str() + ".callgrind"),
+      debugger.myOSystem.console().properties().get(PropType::Cart_Name));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1902,8 +2093,8 @@ void DebuggerParser::executeSavestate()
 // "savestateif"
 void DebuggerParser::executeSavestateif()
 {
-  int res = YaccParser::parse(argStrings[0].c_str());
-  if(res == 0)
+  const auto expr = YaccParser::parseCached(argStrings[0]);
+  if(expr)
   {
     string condition = argStrings[0];
     for(uInt32 i = 0; i < debugger.m6502().getCondSaveStateNames().size(); ++i)
@@ -1915,8 +2106,7 @@ void DebuggerParser::executeSavestateif()
         return;
       }
     }
-    uInt32 ret = debugger.m6502().addCondSaveState(
-      YaccParser::getResult(), argStrings[0]);
+    uInt32 ret = debugger.m6502().addCondSaveState(expr, argStrings[0]);
     commandResult << "added savestateif " << Base::toString(ret);
   }
   else
@@ -1933,6 +2123,24 @@ void DebuggerParser::executeScanline()
   commandResult << "advanced " << dec << count << " scanline(s)";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "stateprofile"
+void DebuggerParser::executeStateprofile()
+{
+  const uInt32 runs = argCount != 0 ? uInt32(std::max(args[0], 1)) : 100;
+
+  StateProfile profile;
+  if(!profile.measure(debugger.myOSystem.console(), runs))
+  {
+    commandResult << red("unable to save/load state");
+    return;
+  }
+
+  commandResult << debugger.myOSystem.console().about().BankSwitch
+                << " state, average of " << dec << runs << " runs\n"
+                << profile.report();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "step"
 void DebuggerParser::executeStep()
@@ -1945,12 +2153,11 @@ void DebuggerParser::executeStep()
 // "stepwhile"
 void DebuggerParser::executeStepwhile()
 {
-  int res = YaccParser::parse(argStrings[0].c_str());
-  if(res != 0) {
+  const auto expr = YaccParser::parseCached(argStrings[0]);
+  if(!expr) {
     commandResult << red("invalid expression");
     return;
   }
-  Expression* expr = YaccParser::getResult();
   int ncycles = 0;
   do {
     ncycles += debugger.step();
@@ -1972,6 +2179,68 @@ void DebuggerParser::executeTrace()
   commandResult << "executed " << dec << debugger.trace() << " cycles";
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "tracedecode"
+void DebuggerParser::executeTracedecode()
+{
+  FilesystemNode in(argStrings[0]);
+  if(!in.exists())
+    in = FilesystemNode(debugger.myOSystem.defaultSaveDir() + argStrings[0]);
+  if(!in.isFile())
+  {
+    commandResult << red("trace file '" + in.getShortPath() + "' not found");
+    return;
+  }
+  FilesystemNode out(in.getPath() + ".txt");
+
+  commandResult << TraceRecorder::decode(in, out);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "tracerec"
+void DebuggerParser::executeTracerec()
+{
+  const uInt32 size = argCount == 0 ? TraceRecorder::DEFAULT_SIZE : args[0];
+  if(size > TraceRecorder::MAX_SIZE)
+  {
+    commandResult << red("at most " + std::to_string(TraceRecorder::MAX_SIZE) +
+                         " instructions can be recorded");
+    return;
+  }
+  if(size == 0)
+  {
+    debugger.stopTraceRecording();
+    const TraceRecorder* recorder = debugger.traceRecorder();
+    commandResult << "trace recording stopped";
+    if(recorder)
+      commandResult << ", " << dec << recorder->size() << " of "
+                    << recorder->recorded() << " instructions kept";
+  }
+  else
+  {
+    debugger.startTraceRecording(size);
+    commandResult << "recording the last " << dec << size << " instructions";
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// "tracesave"
+void DebuggerParser::executeTracesave()
+{
+  const TraceRecorder* recorder = debugger.traceRecorder();
+  if(!recorder)
+  {
+    commandResult << red("no trace recorded");
+    return;
+  }
+
+  ostringstream filename;
+  auto timeinfo = BSPF::localTime();
+  filename << debugger.myOSystem.defaultSaveDir()
+           << std::put_time(&timeinfo, "trace_%F_%H-%M-%S.trace");
+  commandResult << recorder->save(FilesystemNode(filename.str()));
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 // "trap"
 void DebuggerParser::executeTrap()
@@ -2078,8 +2347,8 @@ void DebuggerParser::executeTraps(bool read, bool write, const string& command,
 
   const string condition = conditionBuf.str();
 
-  int res = YaccParser::parse(condition.c_str());
-  if(res == 0)
+  const auto expr = YaccParser::parseCached(condition);
+  if(expr)
   {
     // duplicates will remove each other
     bool add = true;
@@ -2103,8 +2372,7 @@ void DebuggerParser::executeTraps(bool read, bool write, const string& command,
     }
     if(add)
     {
-      uInt32 ret = debugger.m6502().addCondTrap(
-        YaccParser::getResult(), hasCond ? argStrings[0] : "");
+      uInt32 ret = debugger.m6502().addCondTrap(expr, hasCond ? argStrings[0] : "");
       commandResult << "added trap " << Base::toString(ret);
 
       // @sa666666: please check this:
@@ -2253,6 +2521,8 @@ void DebuggerParser::executeV()
 void DebuggerParser::executeWatch()
 {
   myWatches.push_back(argStrings[0]);
+  myWatchCache.push_back(make_unique<WatchCache>());
+  subscribeWatch(*myWatchCache.back(), argStrings[0]);
   commandResult << "added watch \"" << argStrings[0] << "\"";
 }
 
@@ -2853,6 +3123,18 @@ DebuggerParser::Command DebuggerParser::commands[NumCommands] = {
     std::mem_fn(&DebuggerParser::executePc)
   },
 
+  {
+    "perf",
+    "Show performance counters [or reset them]",
+    "Counts calls of hot paths in the emulation core, summed up over all threads\n"
+    "Example: perf, perf reset\n"
+    "NOTE: requires a build configured with --enable-perf-counters",
+    false,
+    false,
+    { Parameters::ARG_LABEL, Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executePerf)
+  },
+
   {
     "pgfx",
     "Mark 'PGFX' range in disassembly",
@@ -2874,6 +3156,18 @@ DebuggerParser::Command DebuggerParser::commands[NumCommands] = {
     std::mem_fn(&DebuggerParser::executePrint)
   },
 
+  {
+    "profile",
+    "Profile cycles of executed instructions (0 stops)",
+    "Counts cycles and executions per address, scanline and frame, until\n"
+    "'profile 0'; 'saveprofile' writes the results\n"
+    "Example: profile, profile 0",
+    false,
+    false,
+    { Parameters::ARG_BOOL, Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeProfile)
+  },
+
   {
     "ram",
     "Show ZP RAM, or set address xx to yy1 [yy2 ...]",
@@ -2966,6 +3260,18 @@ DebuggerParser::Command DebuggerParser::commands[NumCommands] = {
     std::mem_fn(&DebuggerParser::executeRunToPc)
   },
 
+  {
+    "rununtil",
+    "Run until <condition> is true, or timeout [xx] seconds",
+    "Runs at full speed, the debugger is only updated once the condition is\n"
+    "reached, another break occurs, or the timeout (default 600) expires\n"
+    "Example: rununtil _scan>100, rununtil *$80==3 #1200",
+    true,
+    true,
+    { Parameters::ARG_WORD, Parameters::ARG_MULTI_BYTE },
+    std::mem_fn(&DebuggerParser::executeRunUntil)
+  },
+
   {
     "s",
     "Set Stack Pointer to value xx",
@@ -2998,15 +3304,37 @@ DebuggerParser::Command DebuggerParser::commands[NumCommands] = {
 
   {
     "savedis",
-    "Save Distella disassembly (with default name)",
-    "Example: savedis\n"
+    "Save Distella disassembly (with default name or to file xx)",
+    "Example: savedis, savedis game.asm\n"
     "NOTE: saves to default save location",
     false,
     false,
-    { Parameters::ARG_END_ARGS },
+    { Parameters::ARG_FILE, Parameters::ARG_END_ARGS },
     std::mem_fn(&DebuggerParser::executeSavedisassembly)
   },
 
+  {
+    "saveperf",
+    "Save performance counters (with default name)",
+    "Example: saveperf\n"
+    "NOTE: saves to default save location",
+    false,
+    false,
+    { Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeSaveperf)
+  },
+
+  {
+    "saveprofile",
+    "Save profile and annotated disassembly (with default name)",
+    "Example: saveprofile\n"
+    "NOTE: saves to default save location",
+    false,
+    false,
+    { Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeSaveprofile)
+  },
+
   {
     "saverom",
     "Save (possibly patched) ROM (with default name)",
@@ -3080,6 +3408,16 @@ DebuggerParser::Command DebuggerParser::commands[NumCommands] = {
     std::mem_fn(&DebuggerParser::executeScanline)
   },
 
+  {
+    "stateprofile",
+    "Show state size and save/load time by component [xx runs]",
+    "Example: stateprofile, stateprofile 1000",
+    false,
+    false,
+    { Parameters::ARG_WORD, Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeStateprofile)
+  },
+
   {
     "step",
     "Single step CPU [with count xx]",
@@ -3120,6 +3458,41 @@ DebuggerParser::Command DebuggerParser::commands[NumCommands] = {
     std::mem_fn(&DebuggerParser::executeTrace)
   },
 
+  {
+    "tracedecode",
+    "Decode saved trace file xx to text",
+    "Writes the executed instructions, registers and beam position to a\n"
+    "text file next to the trace file\n"
+    "Example: tracedecode trace_2019-01-01_12-00-00.trace",
+    true,
+    false,
+    { Parameters::ARG_FILE, Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeTracedecode)
+  },
+
+  {
+    "tracerec",
+    "Record executed instructions [keeping the last xx, 0 stops]",
+    "Records every executed instruction into a buffer, which 'tracesave'\n"
+    "writes to a file\n"
+    "Example: tracerec, tracerec #5000000, tracerec 0",
+    false,
+    false,
+    { Parameters::ARG_DWORD, Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeTracerec)
+  },
+
+  {
+    "tracesave",
+    "Save recorded instructions (with default name)",
+    "Example: tracesave\n"
+    "NOTE: saves to default save location",
+    false,
+    false,
+    { Parameters::ARG_END_ARGS },
+    std::mem_fn(&DebuggerParser::executeTracesave)
+  },
+
   {
     "trap",
     "Trap read/write access to address(es) xx [yy]",
@@ -26,6 +26,7 @@ class Settings;
 class FilesystemNode;
 struct Command;
 
+#include "Base.hxx"
 #include "bspf.hxx"
 
 class DebuggerParser
@@ -88,7 +89,7 @@ class DebuggerParser
     };
 
     // List of commands available
-    static constexpr uInt32 NumCommands = 95;
+    static constexpr uInt32 NumCommands = 104;
     struct Command {
       string cmdString;
       string description;
@@ -100,6 +101,9 @@ class DebuggerParser
     };
     static Command commands[NumCommands];
 
+    // Default timeout for 'runtopc' and 'rununtil', in seconds of emulated time
+    static constexpr uInt32 RUN_TIMEOUT = 600;
+
     struct Trap
     {
       bool read;
@@ -130,6 +134,19 @@ class DebuggerParser
 
     StringList myWatches;
 
+    // The last value of each watch; it's only evaluated again when the
+    // memory it dereferences changes, or when it depends on registers
+    struct WatchCache {
+      string result;        // empty if the watch is invalid
+      uInt32 subscription;  // MemoryWatcher id, or 0 if none
+      bool constant;        // doesn't use any registers
+      bool changed;
+      uInt32 labelsVersion;
+      Common::Base::Format format;
+    };
+    vector<unique_ptr<WatchCache>> myWatchCache;
+    void subscribeWatch(WatchCache& cache, const string& watch);
+
     // Keep track of traps (read and/or write)
     vector<unique_ptr<Trap>> myTraps;
     void listTraps(bool listCond);
@@ -193,8 +210,10 @@ class DebuggerParser
     void executeN();
     void executePalette();
     void executePc();
+    void executePerf();
     void executePGfx();
     void executePrint();
+    void executeProfile();
     void executeRam();
     void executeReset();
     void executeRewind();
@@ -204,21 +223,28 @@ class DebuggerParser
     void executeRun();
     void executeRunTo();
     void executeRunToPc();
+    void executeRunUntil();
     void executeS();
     void executeSave();
     void executeSaveallstates();
     void executeSaveconfig();
     void executeSavedisassembly();
+    void executeSaveperf();
+    void executeSaveprofile();
     void executeSaverom();
     void executeSaveses();
     void executeSavesnap();
     void executeSavestate();
     void executeSavestateif();
     void executeScanline();
+    void executeStateprofile();
     void executeStep();
     void executeStepwhile();
     void executeTia();
     void executeTrace();
+    void executeTracedecode();
+    void executeTracerec();
+    void executeTracesave();
     void executeTrap();
     void executeTrapif();
     void executeTrapread();
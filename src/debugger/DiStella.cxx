@@ -24,11 +24,13 @@ using Common::Base;
 DiStella::DiStella(const CartDebug& dbg, CartDebug::DisassemblyList& list,
                    CartDebug::BankInfo& info, const DiStella::Settings& s,
                    uInt8* labels, uInt8* directives,
-                   CartDebug::ReservedEquates& reserved)
+                   CartDebug::ReservedEquates& reserved,
+                   Snapshot* snapshot)
   : myDbg(dbg),
     myList(list),
     mySettings(s),
     myReserved(reserved),
+    mySnapshot(snapshot),
     myOffset(0),
     myPC(0),
     myPCEnd(0),
@@ -167,7 +169,7 @@ FIX_LAST:
         mark(myPC + myOffset, CartDebug::VALID_ENTRY);
 
       // get opcode
-      opcode = Debugger::debugger().peek(myPC + myOffset);
+      opcode = peek(myPC + myOffset);
       // get address mode for opcode
       addrMode = ourLookup[opcode].addr_mode;
 
@@ -192,7 +194,7 @@ FIX_LAST:
           // the opcode's operand address matches a label address
           if (pass == 3) {
             // output the byte of the opcode incl. cycles
-            Uint8 nextOpcode = Debugger::debugger().peek(myPC + myOffset);
+            Uint8 nextOpcode = peek(myPC + myOffset);
 
             cycles += int(ourLookup[opcode].cycles) - int(ourLookup[nextOpcode].cycles);
             nextLine << ".byte   $" << Base::HEX2 << int(opcode) << " ;";
@@ -252,7 +254,7 @@ FIX_LAST:
                 else
                   myDisasmBuf << Base::HEX4 << myPC + myOffset << "'     '";
 
-                opcode = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+                opcode = peek(myPC + myOffset);  ++myPC;
                 myDisasmBuf << ".byte $" << Base::HEX2 << int(opcode) << "              $"
                   << Base::HEX4 << myPC + myOffset << "'"
                   << Base::HEX2 << int(opcode);
@@ -300,7 +302,7 @@ FIX_LAST:
 
         case AddressingMode::ABSOLUTE:
         {
-          ad = Debugger::debugger().dpeek(myPC + myOffset);  myPC += 2;
+          ad = dpeek(myPC + myOffset);  myPC += 2;
           labelFound = mark(ad, CartDebug::REFERENCED);
           if (pass == 3) {
             if (ad < 0x100 && mySettings.fFlag)
@@ -330,7 +332,7 @@ FIX_LAST:
 
         case AddressingMode::ZERO_PAGE:
         {
-          d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+          d1 = peek(myPC + myOffset);  ++myPC;
           labelFound = mark(d1, CartDebug::REFERENCED);
           if (pass == 3) {
             nextLine << "     ";
@@ -342,7 +344,7 @@ FIX_LAST:
 
         case AddressingMode::IMMEDIATE:
         {
-          d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+          d1 = peek(myPC + myOffset);  ++myPC;
           if (pass == 3) {
             nextLine << "     #$" << Base::HEX2 << int(d1) << " ";
             nextLineBytes << Base::HEX2 << int(d1);
@@ -352,7 +354,7 @@ FIX_LAST:
 
         case AddressingMode::ABSOLUTE_X:
         {
-          ad = Debugger::debugger().dpeek(myPC + myOffset);  myPC += 2;
+          ad = dpeek(myPC + myOffset);  myPC += 2;
           labelFound = mark(ad, CartDebug::REFERENCED);
           if (pass == 2 && !checkBit(ad & myAppData.end, CartDebug::CODE)) {
             // Since we can't know what address is being accessed unless we also
@@ -391,7 +393,7 @@ FIX_LAST:
 
         case AddressingMode::ABSOLUTE_Y:
         {
-          ad = Debugger::debugger().dpeek(myPC + myOffset);  myPC += 2;
+          ad = dpeek(myPC + myOffset);  myPC += 2;
           labelFound = mark(ad, CartDebug::REFERENCED);
           if (pass == 2 && !checkBit(ad & myAppData.end, CartDebug::CODE)) {
             // Since we can't know what address is being accessed unless we also
@@ -430,7 +432,7 @@ FIX_LAST:
 
         case AddressingMode::INDIRECT_X:
         {
-          d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+          d1 = peek(myPC + myOffset);  ++myPC;
           if (pass == 3) {
             labelFound = mark(d1, 0);  // dummy call to get address type
             nextLine << "     (";
@@ -443,7 +445,7 @@ FIX_LAST:
 
         case AddressingMode::INDIRECT_Y:
         {
-          d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+          d1 = peek(myPC + myOffset);  ++myPC;
           if (pass == 3) {
             labelFound = mark(d1, 0);  // dummy call to get address type
             nextLine << "     (";
@@ -456,7 +458,7 @@ FIX_LAST:
 
         case AddressingMode::ZERO_PAGE_X:
         {
-          d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+          d1 = peek(myPC + myOffset);  ++myPC;
           labelFound = mark(d1, CartDebug::REFERENCED);
           if (pass == 3) {
             nextLine << "     ";
@@ -469,7 +471,7 @@ FIX_LAST:
 
         case AddressingMode::ZERO_PAGE_Y:
         {
-          d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+          d1 = peek(myPC + myOffset);  ++myPC;
           labelFound = mark(d1, CartDebug::REFERENCED);
           if (pass == 3) {
             nextLine << "     ";
@@ -485,7 +487,7 @@ FIX_LAST:
           // SA - 04-06-2010: there seemed to be a bug in distella,
           // where wraparound occurred on a 32-bit int, and subsequent
           // indexing into the labels array caused a crash
-          d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+          d1 = peek(myPC + myOffset);  ++myPC;
           ad = ((myPC + Int8(d1)) & 0xfff) + myOffset;
 
           labelFound = mark(ad, CartDebug::REFERENCED);
@@ -503,7 +505,7 @@ FIX_LAST:
 
         case AddressingMode::ABS_INDIRECT:
         {
-          ad = Debugger::debugger().dpeek(myPC + myOffset);  myPC += 2;
+          ad = dpeek(myPC + myOffset);  myPC += 2;
           labelFound = mark(ad, CartDebug::REFERENCED);
           if (pass == 2 && !checkBit(ad & myAppData.end, CartDebug::CODE)) {
             // Since we can't know what address is being accessed unless we also
@@ -610,10 +612,10 @@ void DiStella::disasmPass1(CartDebug::AddressList& debuggerAddresses)
       for (uInt32 k = pcBeg; k <= myPCEnd; ++k) {
         if (checkBits(k, CartDebug::CartDebug::DATA | CartDebug::GFX | CartDebug::PGFX,
                       CartDebug::CODE)) {
-          //if (Debugger::debugger().getAccessFlags(k) &
+          //if (getAccessFlags(k) &
           //    (CartDebug::DATA | CartDebug::GFX | CartDebug::PGFX)) {
           // TODO: this should never happen, remove when we are sure
-          // TODO: NOT USED: uInt8 flags = Debugger::debugger().getAccessFlags(k);
+          // TODO: NOT USED: uInt8 flags = getAccessFlags(k);
           myPCEnd = k - 1;
           break;
         }
@@ -649,7 +651,7 @@ void DiStella::disasmPass1(CartDebug::AddressList& debuggerAddresses)
     // Stella itself can provide hints on whether an address has ever
     // been referenced as CODE
     while (myAddressQueue.empty() && codeAccessPoint <= myAppData.end) {
-      if ((Debugger::debugger().getAccessFlags(codeAccessPoint + myOffset) & CartDebug::CODE)
+      if ((getAccessFlags(codeAccessPoint + myOffset) & CartDebug::CODE)
           && !(myLabels[codeAccessPoint & myAppData.end] & CartDebug::CODE)) {
         myAddressQueue.push(codeAccessPoint + myOffset);
         ++codeAccessPoint;
@@ -663,9 +665,9 @@ void DiStella::disasmPass1(CartDebug::AddressList& debuggerAddresses)
   for (int k = 0; k <= myAppData.end; k++) {
     // Let the emulation core know about tentative code
     if (checkBit(k, CartDebug::CODE) &&
-      !(Debugger::debugger().getAccessFlags(k + myOffset) & CartDebug::CODE)
+      !(getAccessFlags(k + myOffset) & CartDebug::CODE)
       && myOffset != 0) {
-      Debugger::debugger().setAccessFlags(k + myOffset, CartDebug::TCODE);
+      setAccessFlags(k + myOffset, CartDebug::TCODE);
     }
 
     // Must be ROW / unused bytes
@@ -694,7 +696,7 @@ void DiStella::disasmFromAddress(uInt32 distart)
 
     // so this should be code now...
     // get opcode
-    opcode = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+    opcode = peek(myPC + myOffset);  ++myPC;
     // get address mode for opcode
     addrMode = ourLookup[opcode].addr_mode;
 
@@ -730,7 +732,7 @@ void DiStella::disasmFromAddress(uInt32 distart)
     // Add operand(s)
     switch (addrMode) {
       case AddressingMode::ABSOLUTE:
-        ad = Debugger::debugger().dpeek(myPC + myOffset);  myPC += 2;
+        ad = dpeek(myPC + myOffset);  myPC += 2;
         mark(ad, CartDebug::REFERENCED);
         // handle JMP/JSR
         if (ourLookup[opcode].source == AccessMode::ADDR) {
@@ -745,7 +747,7 @@ void DiStella::disasmFromAddress(uInt32 distart)
         break;
 
       case AddressingMode::ZERO_PAGE:
-        d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+        d1 = peek(myPC + myOffset);  ++myPC;
         mark(d1, CartDebug::REFERENCED);
         break;
 
@@ -754,12 +756,12 @@ void DiStella::disasmFromAddress(uInt32 distart)
         break;
 
       case AddressingMode::ABSOLUTE_X:
-        ad = Debugger::debugger().dpeek(myPC + myOffset);  myPC += 2;
+        ad = dpeek(myPC + myOffset);  myPC += 2;
         mark(ad, CartDebug::REFERENCED);
         break;
 
       case AddressingMode::ABSOLUTE_Y:
-        ad = Debugger::debugger().dpeek(myPC + myOffset);  myPC += 2;
+        ad = dpeek(myPC + myOffset);  myPC += 2;
         mark(ad, CartDebug::REFERENCED);
         break;
 
@@ -772,12 +774,12 @@ void DiStella::disasmFromAddress(uInt32 distart)
         break;
 
       case AddressingMode::ZERO_PAGE_X:
-        d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+        d1 = peek(myPC + myOffset);  ++myPC;
         mark(d1, CartDebug::REFERENCED);
         break;
 
       case AddressingMode::ZERO_PAGE_Y:
-        d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+        d1 = peek(myPC + myOffset);  ++myPC;
         mark(d1, CartDebug::REFERENCED);
         break;
 
@@ -785,7 +787,7 @@ void DiStella::disasmFromAddress(uInt32 distart)
         // SA - 04-06-2010: there seemed to be a bug in distella,
         // where wraparound occurred on a 32-bit int, and subsequent
         // indexing into the labels array caused a crash
-        d1 = Debugger::debugger().peek(myPC + myOffset);  ++myPC;
+        d1 = peek(myPC + myOffset);  ++myPC;
         ad = ((myPC + Int8(d1)) & 0xfff) + myOffset;
         mark(ad, CartDebug::REFERENCED);
         // do NOT use flags set by debugger, else known CODE will not analyzed statically.
@@ -796,7 +798,7 @@ void DiStella::disasmFromAddress(uInt32 distart)
         break;
 
       case AddressingMode::ABS_INDIRECT:
-        ad = Debugger::debugger().dpeek(myPC + myOffset);  myPC += 2;
+        ad = dpeek(myPC + myOffset);  myPC += 2;
         mark(ad, CartDebug::REFERENCED);
         break;
 
@@ -806,7 +808,7 @@ void DiStella::disasmFromAddress(uInt32 distart)
 
     // mark BRK vector
     if (opcode == 0x00) {
-      ad = Debugger::debugger().dpeek(0xfffe, CartDebug::DATA);
+      ad = dpeek(0xfffe, CartDebug::DATA);
       if (!myReserved.breakFound) {
         myAddressQueue.push(ad);
         mark(ad, CartDebug::CODE);
@@ -907,7 +909,7 @@ bool DiStella::checkBit(uInt16 address, uInt8 mask, bool useDebugger) const
   uInt8 label = myLabels[address & myAppData.end],
     lastbits = label & 0x03,
     directive = myDirectives[address & myAppData.end] & 0xFC,
-    debugger = Debugger::debugger().getAccessFlags(address | myOffset) & 0xFC;
+    debugger = getAccessFlags(address | myOffset) & 0xFC;
 
   // Any address marked by a manual directive always takes priority
   if (directive)
@@ -995,10 +997,10 @@ void DiStella::addEntry(CartDebug::DisasmType type)
       // but it could also indicate that code will *never* be accessed
       // Since it is impossible to tell the difference, marking the address
       // in the disassembly at least tells the user about it
-      if (!(Debugger::debugger().getAccessFlags(tag.address) & CartDebug::CODE)
+      if (!(getAccessFlags(tag.address) & CartDebug::CODE)
           && myOffset != 0) {
         tag.ccount += " *";
-        Debugger::debugger().setAccessFlags(tag.address, CartDebug::TCODE);
+        setAccessFlags(tag.address, CartDebug::TCODE);
       }
       break;
     case CartDebug::GFX:
@@ -1030,7 +1032,7 @@ void DiStella::outputGraphics()
 {
   bool isPGfx = checkBit(myPC, CartDebug::PGFX);
   const string& bitString = isPGfx ? "\x1f" : "\x1e";
-  uInt8 byte = Debugger::debugger().peek(myPC + myOffset);
+  uInt8 byte = peek(myPC + myOffset);
 
   // add extra spacing line when switching from non-graphics to graphics
   if (mySegType != CartDebug::GFX && mySegType != CartDebug::NONE) {
@@ -1078,14 +1080,14 @@ void DiStella::outputBytes(CartDebug::DisasmType type)
 
       myDisasmBuf << Base::HEX4 << myPC + myOffset << "'L" << Base::HEX4
         << myPC + myOffset << "'.byte " << "$" << Base::HEX2
-        << int(Debugger::debugger().peek(myPC + myOffset));
+        << int(peek(myPC + myOffset));
       ++myPC;
       numBytes = 1;
       lineEmpty = false;
     } else if (lineEmpty) {
       // start a new line without a label
       myDisasmBuf << Base::HEX4 << myPC + myOffset << "'     '"
-        << ".byte $" << Base::HEX2 << int(Debugger::debugger().peek(myPC + myOffset));
+        << ".byte $" << Base::HEX2 << int(peek(myPC + myOffset));
       ++myPC;
       numBytes = 1;
       lineEmpty = false;
@@ -1095,7 +1097,7 @@ void DiStella::outputBytes(CartDebug::DisasmType type)
       addEntry(type);
       lineEmpty = true;
     } else {
-      myDisasmBuf << ",$" << Base::HEX2 << int(Debugger::debugger().peek(myPC + myOffset));
+      myDisasmBuf << ",$" << Base::HEX2 << int(peek(myPC + myOffset));
       ++myPC;
     }
     isType = checkBits(myPC, type,
@@ -1118,6 +1120,41 @@ void DiStella::processDirectives(const CartDebug::DirectiveList& directives)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 DiStella::peek(uInt16 addr, uInt8 flags)
+{
+  if(!mySnapshot)
+    return Debugger::debugger().peek(addr, flags);
+
+  addr &= 0x1FFF;
+  mySnapshot->flags[addr] |= flags;
+  return mySnapshot->bytes[addr];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt16 DiStella::dpeek(uInt16 addr, uInt8 flags)
+{
+  return uInt16(peek(addr, flags) | (peek(addr + 1, flags) << 8));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 DiStella::getAccessFlags(uInt16 addr) const
+{
+  if(!mySnapshot)
+    return uInt8(Debugger::debugger().getAccessFlags(addr));
+
+  return mySnapshot->flags[addr & 0x1FFF];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DiStella::setAccessFlags(uInt16 addr, uInt8 flags)
+{
+  if(!mySnapshot)
+    Debugger::debugger().setAccessFlags(addr, flags);
+  else
+    mySnapshot->flags[addr & 0x1FFF] |= flags;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 DiStella::Settings DiStella::settings = {
   Base::F_2, // gfxFormat
@@ -1130,6 +1167,64 @@ DiStella::Settings DiStella::settings = {
   8+1        // number of bytes to use with .byte directive
 };
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string DiStella::disassembleInstruction(uInt16 pc, const uInt8* bytes,
+                                        uInt32 length)
+{
+  if(length == 0)
+    return "";
+
+  ostringstream instr;
+  const Instruction_tag& op = ourLookup[bytes[0]];
+  const uInt8 lo = length > 1 ? bytes[1] : 0;
+  const uInt16 word = lo | (length > 2 ? bytes[2] << 8 : 0);
+
+  instr << op.mnemonic;
+  switch(op.addr_mode)
+  {
+    case AddressingMode::ACCUMULATOR:
+      instr << " a";
+      break;
+    case AddressingMode::IMMEDIATE:
+      instr << " #$" << Base::HEX2 << int(lo);
+      break;
+    case AddressingMode::ZERO_PAGE:
+      instr << " $" << Base::HEX2 << int(lo);
+      break;
+    case AddressingMode::ZERO_PAGE_X:
+      instr << " $" << Base::HEX2 << int(lo) << ",x";
+      break;
+    case AddressingMode::ZERO_PAGE_Y:
+      instr << " $" << Base::HEX2 << int(lo) << ",y";
+      break;
+    case AddressingMode::ABSOLUTE:
+      instr << " $" << Base::HEX4 << word;
+      break;
+    case AddressingMode::ABSOLUTE_X:
+      instr << " $" << Base::HEX4 << word << ",x";
+      break;
+    case AddressingMode::ABSOLUTE_Y:
+      instr << " $" << Base::HEX4 << word << ",y";
+      break;
+    case AddressingMode::ABS_INDIRECT:
+      instr << " ($" << Base::HEX4 << word << ")";
+      break;
+    case AddressingMode::INDIRECT_X:
+      instr << " ($" << Base::HEX2 << int(lo) << ",x)";
+      break;
+    case AddressingMode::INDIRECT_Y:
+      instr << " ($" << Base::HEX2 << int(lo) << "),y";
+      break;
+    case AddressingMode::RELATIVE:
+      instr << " $" << Base::HEX4 << uInt16(pc + 2 + Int8(lo));
+      break;
+    default:
+      break;
+  }
+
+  return instr.str();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const DiStella::Instruction_tag DiStella::ourLookup[256] = {
   /****  Positive  ****/
@@ -53,6 +53,15 @@ class DiStella
     };
     static Settings settings;  // Default settings
 
+    // A private copy of the cartridge area and zero-page RAM, along with
+    // their access flags (indexed by address & 0x1FFF)
+    // A disassembly made from a snapshot never touches the System, so
+    // several of them can safely run at the same time
+    struct Snapshot {
+      uInt8 bytes[0x2000];
+      uInt8 flags[0x2000];
+    };
+
   public:
     /**
       Disassemble the current state of the System from the given start address.
@@ -64,11 +73,23 @@ class DiStella
       @param labels      Array storing label info determined by Distella
       @param directives  Array storing directive info determined by Distella
       @param reserved    The TIA/RIOT addresses referenced in the disassembled code
+      @param snapshot    If non-null, read from and mark this instead of the System
     */
     DiStella(const CartDebug& dbg, CartDebug::DisassemblyList& list,
              CartDebug::BankInfo& info, const DiStella::Settings& settings,
              uInt8* labels, uInt8* directives,
-             CartDebug::ReservedEquates& reserved);
+             CartDebug::ReservedEquates& reserved,
+             Snapshot* snapshot = nullptr);
+
+    /**
+      Disassemble a single instruction, without any labels.
+
+      @param pc      The address of the instruction
+      @param bytes   The opcode, followed by its operand bytes
+      @param length  The number of valid bytes in 'bytes'
+    */
+    static string disassembleInstruction(uInt16 pc, const uInt8* bytes,
+                                         uInt32 length);
 
   private:
     // Indicate that a new line of disassembly has been completed
@@ -93,6 +114,13 @@ class DiStella
     void outputGraphics();
     void outputBytes(CartDebug::DisasmType type);
 
+    // Access memory and access flags, either through the debugger or
+    // from the snapshot (when one is used)
+    uInt8 peek(uInt16 addr, uInt8 flags = 0);
+    uInt16 dpeek(uInt16 addr, uInt8 flags = 0);
+    uInt8 getAccessFlags(uInt16 addr) const;
+    void setAccessFlags(uInt16 addr, uInt8 flags);
+
     // Convenience methods to generate appropriate labels
     inline void labelA12High(stringstream& buf, uInt8 op, uInt16 addr, int labfound)
     {
@@ -120,6 +148,7 @@ class DiStella
     CartDebug::DisassemblyList& myList;
     const Settings& mySettings;
     CartDebug::ReservedEquates& myReserved;
+    Snapshot* mySnapshot;
     stringstream myDisasmBuf;
     std::queue<uInt16> myAddressQueue;
     uInt16 myOffset, myPC, myPCEnd;
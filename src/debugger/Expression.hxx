@@ -19,6 +19,7 @@
 #define EXPRESSION_HXX
 
 #include "bspf.hxx"
+#include "ExpressionProgram.hxx"
 
 /**
   This class provides an implementation of an expression node, which
@@ -37,6 +38,19 @@ class Expression
 
     virtual Int32 evaluate() const { return 0; }
 
+    /**
+      Append the code for this expression to the given program.  By
+      default, the program simply calls evaluate().
+    */
+    virtual void compile(ExpressionProgram& program) const
+      { program.emitEvaluate(*this); }
+
+  protected:
+    void compileUnary(ExpressionProgram& program, ExpressionProgram::Op op) const
+      { myLHS->compile(program); program.emit(op); }
+    void compileBinary(ExpressionProgram& program, ExpressionProgram::Op op) const
+      { myLHS->compile(program); myRHS->compile(program); program.emit(op); }
+
   protected:
     unique_ptr<Expression> myLHS, myRHS;
 
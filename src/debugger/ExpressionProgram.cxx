@@ -0,0 +1,264 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Debugger.hxx"
+#include "Expression.hxx"
+#include "ExpressionProgram.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ExpressionProgram::ExpressionProgram(shared_ptr<const Expression> expression)
+  : myExpression(expression),
+    myDepth(0),
+    myMaxDepth(0),
+    myBarrier(0)
+{
+  myExpression->compile(*this);
+
+  // Very deeply nested expressions don't fit on the stack
+  if(myMaxDepth > MAX_DEPTH)
+  {
+    myCode.clear();
+    myDepth = myMaxDepth = myBarrier = 0;
+    emitEvaluate(*myExpression);
+  }
+  myCode.shrink_to_fit();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ExpressionProgram::~ExpressionProgram() = default;
+ExpressionProgram::ExpressionProgram(ExpressionProgram&&) = default;
+ExpressionProgram& ExpressionProgram::operator=(ExpressionProgram&&) = default;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 ExpressionProgram::run() const
+{
+  return execute(myCode.data(), myCode.size());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 ExpressionProgram::execute(const Instruction* code, size_t size)
+{
+  Int32 stack[MAX_DEPTH];
+  Int32* sp = stack;
+
+  const Instruction* pc = code;
+  const Instruction* const end = code + size;
+  while(pc < end)
+  {
+    const Instruction& i = *pc++;
+    switch(i.op)
+    {
+      case Op::Const:     *sp++ = i.value;   break;
+      case Op::LoadByte:  *sp++ = *i.byte;   break;
+      case Op::LoadWord:  *sp++ = *i.word;   break;
+      case Op::LoadFlag:  *sp++ = *i.flag;   break;
+      case Op::Evaluate:  *sp++ = i.expression->evaluate();  break;
+
+      case Op::Peek:    sp[-1] = Debugger::debugger().peek(sp[-1]);        break;
+      case Op::DPeek:   sp[-1] = Debugger::debugger().dpeekAsInt(sp[-1]);  break;
+      case Op::Negate:  sp[-1] = -sp[-1];                 break;
+      case Op::BinNot:  sp[-1] = ~sp[-1];                 break;
+      case Op::LogNot:  sp[-1] = !sp[-1];                 break;
+      case Op::HiByte:  sp[-1] = 0xff & (sp[-1] >> 8);    break;
+      case Op::LoByte:  sp[-1] = 0xff & sp[-1];           break;
+      case Op::Bool:    sp[-1] = sp[-1] != 0;             break;
+
+      case Op::Plus:           --sp;  sp[-1] = sp[-1] + sp[0];   break;
+      case Op::Minus:          --sp;  sp[-1] = sp[-1] - sp[0];   break;
+      case Op::Mult:           --sp;  sp[-1] = sp[-1] * sp[0];   break;
+      case Op::Div:            --sp;  sp[-1] = sp[0] == 0 ? 0 : sp[-1] / sp[0];  break;
+      case Op::Mod:            --sp;  sp[-1] = sp[0] == 0 ? 0 : sp[-1] % sp[0];  break;
+      case Op::BinAnd:         --sp;  sp[-1] = sp[-1] & sp[0];   break;
+      case Op::BinOr:          --sp;  sp[-1] = sp[-1] | sp[0];   break;
+      case Op::BinXor:         --sp;  sp[-1] = sp[-1] ^ sp[0];   break;
+      case Op::ShiftLeft:      --sp;  sp[-1] = sp[-1] << sp[0];  break;
+      case Op::ShiftRight:     --sp;  sp[-1] = sp[-1] >> sp[0];  break;
+      case Op::Equals:         --sp;  sp[-1] = sp[-1] == sp[0];  break;
+      case Op::NotEquals:      --sp;  sp[-1] = sp[-1] != sp[0];  break;
+      case Op::Less:           --sp;  sp[-1] = sp[-1] <  sp[0];  break;
+      case Op::LessEquals:     --sp;  sp[-1] = sp[-1] <= sp[0];  break;
+      case Op::Greater:        --sp;  sp[-1] = sp[-1] >  sp[0];  break;
+      case Op::GreaterEquals:  --sp;  sp[-1] = sp[-1] >= sp[0];  break;
+
+      // The result is known if the left hand side is false resp. true,
+      // otherwise it's the (boolean) value of the right hand side
+      case Op::AndThen:
+        if(sp[-1])
+          --sp;
+        else
+          pc = code + i.target;
+        break;
+
+      case Op::OrElse:
+        if(sp[-1])
+        {
+          sp[-1] = 1;
+          pc = code + i.target;
+        }
+        else
+          --sp;
+        break;
+    }
+  }
+
+  return stack[0];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ExpressionProgram::emitConst(Int32 value)
+{
+  push(Op::Const, 1);
+  myCode.back().value = value;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ExpressionProgram::emitLoad(const uInt8* byte)
+{
+  push(Op::LoadByte, 1);
+  myCode.back().byte = byte;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ExpressionProgram::emitLoad(const uInt16* word)
+{
+  push(Op::LoadWord, 1);
+  myCode.back().word = word;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ExpressionProgram::emitLoad(const bool* flag)
+{
+  push(Op::LoadFlag, 1);
+  myCode.back().flag = flag;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ExpressionProgram::emitEvaluate(const Expression& expression)
+{
+  push(Op::Evaluate, 1);
+  myCode.back().expression = &expression;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ExpressionProgram::emit(Op op)
+{
+  Instruction code[3] = { };
+  Int32 lhs, rhs;
+
+  switch(op)
+  {
+    case Op::Peek:
+    case Op::DPeek:
+      // Memory must be read each time
+      push(op, 0);
+      break;
+
+    case Op::Negate:
+    case Op::BinNot:
+    case Op::LogNot:
+    case Op::HiByte:
+    case Op::LoByte:
+    case Op::Bool:
+      if(lastConst(lhs))
+      {
+        code[0].op = Op::Const;  code[0].value = lhs;
+        code[1].op = op;
+        myCode.back().value = execute(code, 2);
+      }
+      else
+        push(op, 0);
+      break;
+
+    case Op::Const:
+    case Op::LoadByte:
+    case Op::LoadWord:
+    case Op::LoadFlag:
+    case Op::Evaluate:
+    case Op::AndThen:
+    case Op::OrElse:
+      // These are appended by the other emit methods
+      break;
+
+    default:
+      if(lastConst(rhs, 1) && lastConst(lhs, 2))
+      {
+        code[0].op = Op::Const;  code[0].value = lhs;
+        code[1].op = Op::Const;  code[1].value = rhs;
+        code[2].op = op;
+        myCode.pop_back();
+        --myDepth;
+        myCode.back().value = execute(code, 3);
+      }
+      else
+        push(op, -1);
+      break;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ExpressionProgram::emitShortCircuit(Op op, const Expression& rhs)
+{
+  // With a constant left hand side, the result is either known already,
+  // or it's the value of the right hand side
+  Int32 lhs;
+  if(lastConst(lhs))
+  {
+    myCode.pop_back();
+    --myDepth;
+    if((op == Op::AndThen) == (lhs != 0))
+    {
+      rhs.compile(*this);
+      emit(Op::Bool);
+    }
+    else
+      emitConst(op == Op::AndThen ? 0 : 1);
+
+    return;
+  }
+
+  const size_t branch = myCode.size();
+  push(op, -1);
+  rhs.compile(*this);
+  emit(Op::Bool);
+
+  myCode[branch].target = myBarrier = uInt32(myCode.size());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ExpressionProgram::push(Op op, Int32 depth)
+{
+  Instruction i;
+  i.op = op;
+  i.value = 0;
+  myCode.push_back(i);
+
+  myDepth += depth;
+  myMaxDepth = std::max(myMaxDepth, myDepth);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ExpressionProgram::lastConst(Int32& value, uInt32 back) const
+{
+  if(myCode.size() < myBarrier + back || myCode[myCode.size() - back].op != Op::Const)
+    return false;
+
+  value = myCode[myCode.size() - back].value;
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+constexpr uInt32 ExpressionProgram::MAX_DEPTH;
@@ -0,0 +1,132 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef EXPRESSION_PROGRAM_HXX
+#define EXPRESSION_PROGRAM_HXX
+
+class Expression;
+
+#include "bspf.hxx"
+
+/**
+  An expression compiled into a flat program for a small stack machine, so
+  that conditions which are checked after every instruction (breakif,
+  savestateif, trapif) don't have to walk the expression tree each time.
+
+  Constant subexpressions are folded while compiling, and the CPU
+  registers are read directly.  Expressions which can't be compiled
+  (function calls, labels, etc) are evaluated through the tree instead.
+
+  @author  Stephen Anthony
+*/
+class ExpressionProgram
+{
+  public:
+    enum class Op : uInt8
+    {
+      // Push a value
+      Const, LoadByte, LoadWord, LoadFlag, Evaluate,
+      // Replace the topmost value
+      Peek, DPeek, Negate, BinNot, LogNot, HiByte, LoByte, Bool,
+      // Replace the two topmost values
+      Plus, Minus, Mult, Div, Mod, BinAnd, BinOr, BinXor,
+      ShiftLeft, ShiftRight, Equals, NotEquals,
+      Less, LessEquals, Greater, GreaterEquals,
+      // Short-circuit evaluation of '&&' and '||'
+      AndThen, OrElse
+    };
+
+  public:
+    /**
+      Create the program for the given expression, which may be shared with
+      other programs.
+    */
+    explicit ExpressionProgram(shared_ptr<const Expression> expression);
+    ~ExpressionProgram();
+
+    ExpressionProgram(ExpressionProgram&&);
+    ExpressionProgram& operator=(ExpressionProgram&&);
+
+    /**
+      Run the program, returning the value of the expression.
+    */
+    Int32 run() const;
+
+    /**
+      The following methods are used by Expression::compile() to append
+      code to the program.
+    */
+    void emitConst(Int32 value);
+    void emitLoad(const uInt8* byte);
+    void emitLoad(const uInt16* word);
+    void emitLoad(const bool* flag);
+    void emitEvaluate(const Expression& expression);
+
+    // Append an operator working on the topmost value(s)
+    void emit(Op op);
+
+    // Append the code for '<compiled> && rhs' resp. '<compiled> || rhs'
+    void emitAndThen(const Expression& rhs) { emitShortCircuit(Op::AndThen, rhs); }
+    void emitOrElse(const Expression& rhs)  { emitShortCircuit(Op::OrElse, rhs);  }
+
+  private:
+    struct Instruction
+    {
+      Op op;
+      union {
+        Int32 value;
+        uInt32 target;  // where to continue when short-circuiting
+        const uInt8* byte;
+        const uInt16* word;
+        const bool* flag;
+        const Expression* expression;
+      };
+    };
+
+    // Run the given code, which must leave exactly one value on the stack
+    static Int32 execute(const Instruction* code, size_t size);
+
+    // Append an instruction which changes the stack depth by 'depth'
+    void push(Op op, Int32 depth);
+    void emitShortCircuit(Op op, const Expression& rhs);
+
+    // Get the value of the last instruction, if it is a constant which
+    // may be folded into the following instruction
+    bool lastConst(Int32& value, uInt32 back = 1) const;
+
+  private:
+    shared_ptr<const Expression> myExpression;
+    vector<Instruction> myCode;
+
+    // The number of values on the stack while compiling, and at most
+    uInt32 myDepth, myMaxDepth;
+
+    // Instructions before this one are the target of a branch, and must not
+    // be folded into later ones
+    uInt32 myBarrier;
+
+    // Deeper expressions are evaluated through the tree instead
+    static constexpr uInt32 MAX_DEPTH = 32;
+
+  private:
+    // Following constructors and assignment operators not supported
+    ExpressionProgram() = delete;
+    ExpressionProgram(const ExpressionProgram&) = delete;
+    ExpressionProgram& operator=(const ExpressionProgram&) = delete;
+};
+
+#endif
@@ -0,0 +1,130 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "MemoryWatcher.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MemoryWatcher::MemoryWatcher(System& system)
+  : mySystem(system),
+    myNextId(1)
+{
+  for(uInt32 page = 0; page < System::NUM_PAGES; ++page)
+  {
+    myPeekBase[page] = nullptr;
+    myDevice[page] = nullptr;
+  }
+  invalidate();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 MemoryWatcher::subscribe(uInt16 start, uInt16 end, const Callback& callback)
+{
+  Subscription sub;
+  sub.id = myNextId++;
+  sub.start = start;
+  sub.end = std::max(start, end);
+  sub.callback = callback;
+
+  // The current values are the baseline; only later changes are reported
+  for(uInt32 addr = sub.start; addr <= sub.end; ++addr)
+    sub.values.push_back(mySystem.peek(addr));
+
+  mySubscriptions.push_back(std::move(sub));
+  return mySubscriptions.back().id;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MemoryWatcher::unsubscribe(uInt32 id)
+{
+  for(uInt32 i = 0; i < mySubscriptions.size(); ++i)
+  {
+    if(mySubscriptions[i].id == id)
+    {
+      mySubscriptions.erase(mySubscriptions.begin() + i);
+      return;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MemoryWatcher::collect()
+{
+  for(uInt32 page = 0; page < System::NUM_PAGES; ++page)
+  {
+    const uInt16 addr = page << System::PAGE_SHIFT;
+    const System::PageAccess& access = mySystem.getPageAccess(addr);
+
+    if(mySystem.isPageDirty(addr, addr))
+      myChangedPages[page] = true;
+
+    if(access.directPeekBase != myPeekBase[page] || access.device != myDevice[page])
+    {
+      myPeekBase[page] = access.directPeekBase;
+      myDevice[page] = access.device;
+      myChangedPages[page] = true;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MemoryWatcher::invalidate()
+{
+  for(uInt32 page = 0; page < System::NUM_PAGES; ++page)
+    myChangedPages[page] = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MemoryWatcher::update()
+{
+  collect();
+
+  myChanges.clear();
+  for(auto& sub : mySubscriptions)
+  {
+    for(uInt32 addr = sub.start; addr <= sub.end; ++addr)
+    {
+      const uInt32 page = (addr & System::ADDRESS_MASK) >> System::PAGE_SHIFT;
+
+      // Device registers may change without being written to (collisions,
+      // timers, inputs), so pages without direct access are always read
+      if(!myChangedPages[page] && myPeekBase[page])
+      {
+        // Skip the rest of this page
+        addr |= System::PAGE_MASK;
+        continue;
+      }
+
+      uInt8& value = sub.values[addr - sub.start];
+      const uInt8 newValue = mySystem.peek(addr);
+      if(newValue != value)
+      {
+        myChanges.push_back({sub.callback, uInt16(addr), value, newValue});
+        value = newValue;
+      }
+    }
+  }
+
+  for(uInt32 page = 0; page < System::NUM_PAGES; ++page)
+    myChangedPages[page] = false;
+
+  // Subscribers may (un)subscribe from their callback, so the
+  // notifications are only sent once all subscriptions were checked
+  const vector<Change> changes = std::move(myChanges);
+  myChanges.clear();
+  for(const auto& change : changes)
+    change.callback(change.addr, change.oldValue, change.newValue);
+}
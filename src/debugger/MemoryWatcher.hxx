@@ -0,0 +1,120 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef MEMORY_WATCHER_HXX
+#define MEMORY_WATCHER_HXX
+
+class Device;
+
+#include <functional>
+
+#include "System.hxx"
+#include "bspf.hxx"
+
+/**
+  Keeps track of changes in address ranges that consumers (watches,
+  widgets, etc) have subscribed to.  Rather than reading and comparing all
+  watched memory on every refresh, only the cells in pages that were
+  written to (as marked by the System poke path), remapped by a bankswitch,
+  or that belong to a device with its own peek handling (TIA, RIOT I/O,
+  cart registers) are read again.  Each changed cell is then pushed to the
+  subscriber's callback.
+
+  The System's dirty page flags are cleared by the debugger at several
+  points, so collect() must be called before each of those.  Operations
+  that replace memory wholesale (state loading, reset) must call
+  invalidate() instead.
+
+  @author  Stephen Anthony
+*/
+class MemoryWatcher
+{
+  public:
+    // Called for every cell that changed, with its old and new value
+    using Callback = std::function<void(uInt16 addr, uInt8 oldValue, uInt8 newValue)>;
+
+  public:
+    explicit MemoryWatcher(System& system);
+
+    /**
+      Watch the addresses from 'start' to 'end' (inclusive).
+
+      @return  An id used to unsubscribe again (never 0)
+    */
+    uInt32 subscribe(uInt16 start, uInt16 end, const Callback& callback);
+
+    /**
+      Stop watching the addresses subscribed under the given id.
+    */
+    void unsubscribe(uInt32 id);
+
+    /**
+      Remember which pages were written to or remapped since the System's
+      dirty page flags were last cleared.
+    */
+    void collect();
+
+    /**
+      Compare all watched cells on the next update, regardless of which
+      pages were written to.
+    */
+    void invalidate();
+
+    /**
+      Read the cells of all pages which may have changed since the last
+      update, and call the subscribers for each changed cell.
+    */
+    void update();
+
+  private:
+    struct Subscription {
+      uInt32 id;
+      uInt16 start, end;
+      Callback callback;
+      ByteArray values;
+    };
+
+    struct Change {
+      Callback callback;
+      uInt16 addr;
+      uInt8 oldValue, newValue;
+    };
+
+    System& mySystem;
+
+    vector<Subscription> mySubscriptions;
+    uInt32 myNextId;
+
+    // Pages that must be compared on the next update
+    bool myChangedPages[System::NUM_PAGES];
+
+    // The page mapping at the time of the last collect()
+    const uInt8* myPeekBase[System::NUM_PAGES];
+    const Device* myDevice[System::NUM_PAGES];
+
+    vector<Change> myChanges;
+
+  private:
+    // Following constructors and assignment operators not supported
+    MemoryWatcher() = delete;
+    MemoryWatcher(const MemoryWatcher&) = delete;
+    MemoryWatcher(MemoryWatcher&&) = delete;
+    MemoryWatcher& operator=(const MemoryWatcher&) = delete;
+    MemoryWatcher& operator=(MemoryWatcher&&) = delete;
+};
+
+#endif
@@ -0,0 +1,184 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "FSNode.hxx"
+#include "Base.hxx"
+#include "DiStella.hxx"
+#include "DebuggerParser.hxx"
+#include "TraceRecorder.hxx"
+
+namespace {
+  // Identifies a saved trace, followed by the entry size and count
+  constexpr char TRACE_MAGIC[8] = { 'S', 'T', 'L', 'T', 'R', 'C', '0', '1' };
+  constexpr uInt32 HEADER_SIZE = 8 + 4 + 8;
+
+  void putLE(uInt8* buf, uInt64 value, int bytes)
+  {
+    for(int i = 0; i < bytes; ++i, value >>= 8)
+      buf[i] = value & 0xff;
+  }
+
+  uInt64 getLE(const uInt8* buf, int bytes)
+  {
+    uInt64 value = 0;
+    for(int i = bytes - 1; i >= 0; --i)
+      value = (value << 8) | buf[i];
+    return value;
+  }
+}
+
+constexpr uInt32 TraceRecorder::ENTRY_SIZE;
+constexpr uInt32 TraceRecorder::DEFAULT_SIZE;
+constexpr uInt32 TraceRecorder::MAX_SIZE;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TraceRecorder::TraceRecorder(uInt32 size)
+  : myEntries(std::max(size, 1u)),
+    myNext(0),
+    myRecorded(0),
+    myCurrent(&myScratch)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string TraceRecorder::save(const FilesystemNode& node) const
+{
+  ofstream out(node.getPath(), std::ios::binary);
+  if(!out.is_open())
+    return DebuggerParser::red("unable to save trace to " + node.getShortPath());
+
+  const uInt32 count = size();
+  uInt8 header[HEADER_SIZE];
+  std::copy_n(TRACE_MAGIC, 8, header);
+  putLE(header + 8, ENTRY_SIZE, 4);
+  putLE(header + 12, count, 8);
+  out.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+
+  // Write in blocks; the oldest entry is the next one to be overwritten
+  // once the buffer has wrapped
+  constexpr uInt32 BLOCK = 4096;
+  vector<uInt8> buf(BLOCK * ENTRY_SIZE);
+  uInt32 idx = count < myEntries.size() ? 0 : myNext;
+  for(uInt32 done = 0; done < count; )
+  {
+    const uInt32 n = std::min(BLOCK, count - done);
+    for(uInt32 i = 0; i < n; ++i)
+    {
+      pack(myEntries[idx], buf.data() + i * ENTRY_SIZE);
+      if(++idx == myEntries.size())
+        idx = 0;
+    }
+    out.write(reinterpret_cast<const char*>(buf.data()), n * ENTRY_SIZE);
+    done += n;
+  }
+
+  if(!out)
+    return DebuggerParser::red("unable to save trace to " + node.getShortPath());
+
+  ostringstream buf2;
+  buf2 << "saved " << count << " instructions to " << node.getShortPath();
+  return buf2.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string TraceRecorder::decode(const FilesystemNode& in, const FilesystemNode& out)
+{
+  using Common::Base;
+
+  ifstream input(in.getPath(), std::ios::binary);
+  uInt8 header[HEADER_SIZE];
+  if(!input.is_open() ||
+     !input.read(reinterpret_cast<char*>(header), HEADER_SIZE) ||
+     !std::equal(TRACE_MAGIC, TRACE_MAGIC + 8, header))
+    return DebuggerParser::red("'" + in.getShortPath() + "' is not a trace file");
+
+  // Later versions may add fields to the end of an entry
+  const uInt32 entrySize = uInt32(getLE(header + 8, 4));
+  const uInt64 count = getLE(header + 12, 8);
+  if(entrySize < ENTRY_SIZE)
+    return DebuggerParser::red("'" + in.getShortPath() + "' is not a trace file");
+
+  ofstream output(out.getPath());
+  if(!output.is_open())
+    return DebuggerParser::red("unable to save decoded trace to " + out.getShortPath());
+
+  output << "      cycle scan clk bank   pc  bytes     instruction       "
+            "a  x  y  sp flags\n";
+
+  vector<uInt8> buf(entrySize);
+  uInt64 decoded = 0;
+  Entry e;
+  for(; decoded < count; ++decoded)
+  {
+    if(!input.read(reinterpret_cast<char*>(buf.data()), entrySize))
+      break;
+    unpack(buf.data(), e);
+
+    ostringstream bytes;
+    for(int i = 0; i < e.length; ++i)
+      bytes << Base::HEX2 << int(e.bytes[i]) << " ";
+    const string instr = DiStella::disassembleInstruction(e.pc, e.bytes, e.length);
+
+    string flags = "nv-bdizc";
+    for(int i = 0; i < 8; ++i)
+      if(e.ps & (0x80 >> i))
+        flags[i] = toupper(flags[i]);
+
+    output << std::dec << std::setfill(' ') << std::setw(11) << e.cycles << " "
+           << std::setw(4) << e.scanline << " "
+           << std::setw(3) << int(e.clock) << " "
+           << std::setw(4) << e.bank << " "
+           << Base::HEX4 << e.pc << "  " << std::setfill(' ')
+           << std::left << std::setw(10) << bytes.str()
+           << std::setw(17) << instr << std::right << " "
+           << Base::HEX2 << int(e.a) << " " << Base::HEX2 << int(e.x) << " "
+           << Base::HEX2 << int(e.y) << " " << Base::HEX2 << int(e.sp) << " "
+           << flags << "\n";
+  }
+
+  ostringstream result;
+  result << "decoded " << decoded << " instructions to " << out.getShortPath();
+  return result.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TraceRecorder::pack(const Entry& e, uInt8* buf)
+{
+  putLE(buf, e.cycles, 8);
+  putLE(buf + 8, e.pc, 2);
+  putLE(buf + 10, e.bank, 2);
+  putLE(buf + 12, e.scanline, 2);
+  buf[14] = e.clock;
+  buf[15] = e.a;  buf[16] = e.x;  buf[17] = e.y;
+  buf[18] = e.sp; buf[19] = e.ps;
+  buf[20] = e.length;
+  std::copy_n(e.bytes, 3, buf + 21);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TraceRecorder::unpack(const uInt8* buf, Entry& e)
+{
+  e.cycles = getLE(buf, 8);
+  e.pc = uInt16(getLE(buf + 8, 2));
+  e.bank = uInt16(getLE(buf + 10, 2));
+  e.scanline = uInt16(getLE(buf + 12, 2));
+  e.clock = buf[14];
+  e.a = buf[15];  e.x = buf[16];  e.y = buf[17];
+  e.sp = buf[18]; e.ps = buf[19];
+  e.length = std::min(buf[20], uInt8(3));
+  std::copy_n(buf + 21, 3, e.bytes);
+}
@@ -0,0 +1,136 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef TRACE_RECORDER_HXX
+#define TRACE_RECORDER_HXX
+
+class FilesystemNode;
+
+#include "bspf.hxx"
+
+/**
+  Records every instruction the CPU executes into a ring buffer, in a form
+  cheap enough to be filled at close to full emulation speed.  Each entry
+  holds the address, bank, instruction bytes and registers before the
+  instruction ran, along with the system cycle and beam position.
+
+  The buffer can be saved in a compact binary format and decoded into
+  readable text later on (using the opcode tables of DiStella), so traces
+  of millions of instructions can be compared against real hardware.
+
+  @author  Stephen Anthony
+*/
+class TraceRecorder
+{
+  public:
+    struct Entry {
+      uInt64 cycles;
+      uInt16 pc, bank, scanline;
+      uInt8 clock;
+      uInt8 a, x, y, sp, ps;
+      uInt8 length;   // number of valid bytes in 'bytes'
+      uInt8 bytes[3];
+    };
+
+    // Size of an entry in a saved trace
+    static constexpr uInt32 ENTRY_SIZE = 24;
+
+    static constexpr uInt32 DEFAULT_SIZE = 1 << 20;
+    static constexpr uInt32 MAX_SIZE = 1 << 25;
+
+  public:
+    /**
+      Create a recorder keeping the most recent 'size' instructions.
+    */
+    explicit TraceRecorder(uInt32 size = DEFAULT_SIZE);
+
+    /**
+      Start a new entry for the instruction about to be executed.
+    */
+    void beginInstruction(uInt16 pc, uInt16 bank, uInt8 a, uInt8 x,
+                          uInt8 y, uInt8 sp, uInt8 ps, uInt64 cycles,
+                          uInt32 scanline, uInt32 clock)
+    {
+      Entry& e = myEntries[myNext];
+      e.cycles = cycles;
+      e.pc = pc;  e.bank = bank;
+      e.scanline = uInt16(scanline);  e.clock = uInt8(clock);
+      e.a = a;  e.x = x;  e.y = y;  e.sp = sp;  e.ps = ps;
+      e.length = 0;
+      myCurrent = &e;
+
+      if(++myNext == myEntries.size())
+        myNext = 0;
+      ++myRecorded;
+    }
+
+    /**
+      Add a byte fetched as part of the current instruction.
+    */
+    void addCodeByte(uInt8 value)
+    {
+      if(myCurrent->length < 3)
+        myCurrent->bytes[myCurrent->length++] = value;
+    }
+
+    /**
+      Answer the number of entries currently held, and the total number of
+      instructions recorded so far.
+    */
+    uInt32 size() const {
+      return uInt32(std::min(myRecorded, uInt64(myEntries.size())));
+    }
+    uInt64 recorded() const { return myRecorded; }
+
+    /**
+      Save the recorded entries (oldest first) to the given file.
+
+      @return  A message describing the result
+    */
+    string save(const FilesystemNode& node) const;
+
+    /**
+      Decode a trace saved by 'save' into readable text.
+
+      @param in   The binary trace file
+      @param out  The text file to create
+      @return  A message describing the result
+    */
+    static string decode(const FilesystemNode& in, const FilesystemNode& out);
+
+  private:
+    static void pack(const Entry& e, uInt8* buf);
+    static void unpack(const uInt8* buf, Entry& e);
+
+  private:
+    vector<Entry> myEntries;
+    uInt32 myNext;
+    uInt64 myRecorded;
+
+    // The entry which code bytes are currently added to
+    Entry* myCurrent;
+    Entry myScratch;
+
+  private:
+    // Following constructors and assignment operators not supported
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder(TraceRecorder&&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(TraceRecorder&&) = delete;
+};
+
+#endif
@@ -25,26 +25,48 @@ class TrapArray
 public:
   TrapArray() : myInitialized(false) {}
 
-  bool isSet(const uInt16 address) const { return myCount[address]; }
-  bool isClear(const uInt16 address) const { return myCount[address] == 0; }
+  // The block is checked first, so that a few traps don't slow down
+  // every other access (blocks are smaller than pages, so that a trap on
+  // a TIA register doesn't affect the zero page RAM)
+  bool isSet(const uInt16 address) const {
+    return myBlockCount[address >> BLOCK_SHIFT] && myCount[address];
+  }
+  bool isClear(const uInt16 address) const { return !isSet(address); }
 
-  void add(const uInt16 address) { myCount[address]++; }
-  void remove(const uInt16 address) { myCount[address]--; }
+  void add(const uInt16 address) { setCount(address, myCount[address] + 1); }
+  void remove(const uInt16 address) { setCount(address, myCount[address] - 1); }
   //void toggle(uInt16 address) { myCount[address] ? remove(address) : add(address); } // TODO condition
 
   void initialize() { 
     if(!myInitialized)
+    {
       memset(myCount, 0, sizeof(myCount));
+      memset(myBlockCount, 0, sizeof(myBlockCount));
+    }
     myInitialized = true; 
   }
-  void clearAll() { myInitialized = false; memset(myCount, 0, sizeof(myCount)); }
+  void clearAll() {
+    myInitialized = false;
+    memset(myCount, 0, sizeof(myCount));
+    memset(myBlockCount, 0, sizeof(myBlockCount));
+  }
 
   bool isInitialized() const { return myInitialized; }
 
+private:
+  void setCount(const uInt16 address, const uInt8 count) {
+    myBlockCount[address >> BLOCK_SHIFT] += (count != 0) - (myCount[address] != 0);
+    myCount[address] = count;
+  }
+
 private:
   // The actual counts
   uInt8 myCount[0x10000];
 
+  // The number of addresses with a trap in each block of 64 bytes
+  static constexpr uInt32 BLOCK_SHIFT = 6;
+  uInt8 myBlockCount[0x10000 >> BLOCK_SHIFT];
+
   // Indicates whether we should treat this array as initialized
   bool myInitialized;
 
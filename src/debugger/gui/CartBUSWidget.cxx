@@ -190,6 +190,8 @@ CartridgeBUSWidget::CartridgeBUSWidget(
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeBUSWidget::saveOldState()
 {
+  myCart.flushDatastreams();
+
   myOldState.tops.clear();
   myOldState.bottoms.clear();
   myOldState.datastreampointers.clear();
@@ -246,6 +248,8 @@ void CartridgeBUSWidget::saveOldState()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeBUSWidget::loadConfig()
 {
+  myCart.flushDatastreams();
+
   myBank->setSelectedIndex(myCart.getBank());
 
   // Get registers, using change tracking
@@ -437,6 +441,7 @@ const ByteArray& CartridgeBUSWidget::internalRamOld(int start, int count)
 const ByteArray& CartridgeBUSWidget::internalRamCurrent(int start, int count)
 {
   myRamCurrent.clear();
+  myCart.flushDatastreams();
   for(int i = 0; i < count; i++)
     myRamCurrent.push_back(myCart.myBUSRAM[start + i]);
   return myRamCurrent;
@@ -445,11 +450,13 @@ const ByteArray& CartridgeBUSWidget::internalRamCurrent(int start, int count)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeBUSWidget::internalRamSetValue(int addr, uInt8 value)
 {
+  myCart.invalidateDatastreams();
   myCart.myBUSRAM[addr] = value;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 CartridgeBUSWidget::internalRamGetValue(int addr)
 {
+  myCart.flushDatastreams();
   return myCart.myBUSRAM[addr];
 }
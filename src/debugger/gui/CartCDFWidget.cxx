@@ -193,6 +193,8 @@ CartridgeCDFWidget::CartridgeCDFWidget(
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeCDFWidget::saveOldState()
 {
+  myCart.flushDatastreams();
+
   myOldState.tops.clear();
   myOldState.bottoms.clear();
   myOldState.datastreampointers.clear();
@@ -240,6 +242,8 @@ void CartridgeCDFWidget::saveOldState()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeCDFWidget::loadConfig()
 {
+  myCart.flushDatastreams();
+
   myBank->setSelectedIndex(myCart.getBank());
 
   // Get registers, using change tracking
@@ -436,6 +440,7 @@ const ByteArray& CartridgeCDFWidget::internalRamOld(int start, int count)
 const ByteArray& CartridgeCDFWidget::internalRamCurrent(int start, int count)
 {
   myRamCurrent.clear();
+  myCart.flushDatastreams();
   for(int i = 0; i < count; i++)
     myRamCurrent.push_back(myCart.myCDFRAM[start + i]);
   return myRamCurrent;
@@ -444,12 +449,14 @@ const ByteArray& CartridgeCDFWidget::internalRamCurrent(int start, int count)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeCDFWidget::internalRamSetValue(int addr, uInt8 value)
 {
+  myCart.invalidateDatastreams();
   myCart.myCDFRAM[addr] = value;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 CartridgeCDFWidget::internalRamGetValue(int addr)
 {
+  myCart.flushDatastreams();
   return myCart.myCDFRAM[addr];
 }
 
@@ -182,6 +182,8 @@ CartridgeDPCPlusWidget::CartridgeDPCPlusWidget(
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeDPCPlusWidget::saveOldState()
 {
+  myCart.waitForARM();
+
   myOldState.tops.clear();
   myOldState.bottoms.clear();
   myOldState.counters.clear();
@@ -220,6 +222,8 @@ void CartridgeDPCPlusWidget::saveOldState()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeDPCPlusWidget::loadConfig()
 {
+  myCart.waitForARM();
+
   myBank->setSelectedIndex(myCart.getBank(), myCart.getBank() != myOldState.bank);
 
   // Get registers, using change tracking
@@ -374,6 +378,7 @@ const ByteArray& CartridgeDPCPlusWidget::internalRamOld(int start, int count)
 const ByteArray& CartridgeDPCPlusWidget::internalRamCurrent(int start, int count)
 {
   myRamCurrent.clear();
+  myCart.waitForARM();
   for(int i = 0; i < count; i++)
     myRamCurrent.push_back(myCart.myDisplayImage[start + i]);
   return myRamCurrent;
@@ -382,11 +387,13 @@ const ByteArray& CartridgeDPCPlusWidget::internalRamCurrent(int start, int count
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeDPCPlusWidget::internalRamSetValue(int addr, uInt8 value)
 {
+  myCart.waitForARM();
   myCart.myDisplayImage[addr] = value;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 CartridgeDPCPlusWidget::internalRamGetValue(int addr)
 {
+  myCart.waitForARM();
   return myCart.myDisplayImage[addr];
 }
@@ -45,12 +45,15 @@ DataGridWidget::DataGridWidget(GuiObject* boss, const GUI::Font& font,
     _bits(bits),
     _crossGrid(false),
     _base(base),
+    _valuesFormatted(false),
+    _hexUppercase(false),
     _selectedItem(0),
     _currentKeyDown(KBDK_UNKNOWN),
     _opsWidget(nullptr),
     _scrollBar(nullptr)
 {
-  _flags = Widget::FLAG_ENABLED | Widget::FLAG_RETAIN_FOCUS | Widget::FLAG_WANTS_RAWDATA;
+  _flags = Widget::FLAG_ENABLED | Widget::FLAG_CLEARBG | Widget::FLAG_RETAIN_FOCUS |
+           Widget::FLAG_WANTS_RAWDATA;
   _editMode = false;
 
   // The item is selected, thus _bgcolor is used to draw the caret and
@@ -124,20 +127,28 @@ cerr << "alist.size() = "     << alist.size()
   int size = int(vlist.size());  // assume the alist is the same size
   assert(size == _rows * _cols);
 
-  _addrList.clear();
-  _valueList.clear();
-  _valueStringList.clear();
-  _changedList.clear();
+  // Most values don't change between updates (e.g. when stepping), so only
+  // the cells which did are formatted again, and the grid is only redrawn
+  // when anything visible changed
+  const bool reformat = !_valuesFormatted ||
+                        _hexUppercase != Common::Base::hexUppercase();
+  bool dirty = reformat;
+  for(int i = 0; i < size; ++i)
+  {
+    if(reformat || vlist[i] != _valueList[i])
+    {
+      _valueStringList[i] = Common::Base::toString(vlist[i], _base);
+      dirty = true;
+    }
+    dirty = dirty || changed[i] != _changedList[i];
+  }
+  _valuesFormatted = true;
+  _hexUppercase = Common::Base::hexUppercase();
 
   _addrList    = alist;
   _valueList   = vlist;
   _changedList = changed;
 
-  // An efficiency thing
-  string temp;
-  for(int i = 0; i < size; ++i)
-    _valueStringList.push_back(Common::Base::toString(_valueList[i], _base));
-
 /*
 cerr << "_addrList.size() = "     << _addrList.size()
      << ", _valueList.size() = "   << _valueList.size()
@@ -150,7 +161,8 @@ cerr << "_addrList.size() = "     << _addrList.size()
   // Send item selected signal for starting with cell 0
   sendCommand(DataGridWidget::kSelectionChangedCmd, _selectedItem, _id);
 
-  setDirty();
+  if(dirty)
+    setDirty();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -191,7 +203,9 @@ void DataGridWidget::setEditable(bool editable, bool hiliteBG)
 void DataGridWidget::setHiliteList(const BoolArray& hilitelist)
 {
   assert(hilitelist.size() == uInt32(_rows * _cols));
-  _hiliteList.clear();
+  if(hilitelist == _hiliteList)
+    return;
+
   _hiliteList = hilitelist;
 
   setDirty();
@@ -81,7 +81,9 @@ class DataGridWidget : public EditableWidget
 
     void setOpsWidget(DataGridOpsWidget* w) { _opsWidget = w; }
 
-    void setCrossed(bool enable) { _crossGrid = enable; }
+    void setCrossed(bool enable) {
+      if(enable != _crossGrid) { _crossGrid = enable; setDirty(); }
+    }
 
   protected:
     void drawWidget(bool hilite) override;
@@ -121,6 +123,10 @@ class DataGridWidget : public EditableWidget
 
     Common::Base::Format _base;
 
+    // Whether the values have been formatted yet, and in which hex case
+    bool _valuesFormatted;
+    bool _hexUppercase;
+
     IntArray    _addrList;
     IntArray    _valueList;
     StringList  _valueStringList;
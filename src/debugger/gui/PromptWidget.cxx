@@ -39,7 +39,9 @@ PromptWidget::PromptWidget(GuiObject* boss, const GUI::Font& font,
     _historyLine(0),
     _makeDirty(false),
     _firstTime(true),
-    _exitedEarly(false)
+    _exitedEarly(false),
+    _deferUpdates(false),
+    _scrollBarChanged(false)
 {
   _flags = Widget::FLAG_ENABLED | Widget::FLAG_CLEARBG | Widget::FLAG_RETAIN_FOCUS |
            Widget::FLAG_WANTS_TAB | Widget::FLAG_WANTS_RAWDATA;
@@ -803,6 +805,13 @@ void PromptWidget::updateScrollBuffer()
     _firstLineInBuffer = firstline;
   }
 
+  // While printing, the scrollbar is only updated once at the end
+  if(_deferUpdates)
+  {
+    _scrollBarChanged = true;
+    return;
+  }
+
   _scrollBar->_numEntries = numlines;
   _scrollBar->_currentPos = _scrollBar->_numEntries - (line - _scrollLine + _linesPerPage);
   _scrollBar->_entriesPerPage = _linesPerPage;
@@ -856,14 +865,26 @@ void PromptWidget::putcharIntern(int c)
       updateScrollBuffer();
     }
   }
-  setDirty();
+  if(!_deferUpdates)
+    setDirty();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PromptWidget::print(const string& str)
 {
+  // Commands can print thousands of lines; only the characters are stored
+  // while printing, the scrollbar and the widget are updated afterwards
+  _deferUpdates = true;
   for(char c: str)
     putcharIntern(c);
+  _deferUpdates = false;
+
+  if(_scrollBarChanged)
+  {
+    _scrollBarChanged = false;
+    updateScrollBuffer();
+  }
+  setDirty();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
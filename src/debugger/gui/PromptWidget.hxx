@@ -129,6 +129,10 @@ class PromptWidget : public Widget, public CommandSender
     bool _firstTime;
     bool _exitedEarly;
 
+    // Set while printing, when the scrollbar is updated afterwards
+    bool _deferUpdates;
+    bool _scrollBarChanged;
+
 //    int compareHistory(const char *histLine);
 
   private:
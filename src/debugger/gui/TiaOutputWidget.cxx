@@ -64,8 +64,8 @@ void TiaOutputWidget::loadConfig()
 void TiaOutputWidget::saveSnapshot(int execDepth, const string& execPrefix)
 {
 #ifdef PNG_SUPPORT
-  if(execDepth > 0)
-    drawWidget(false);
+  if(execDepth > 0 || mySurface == nullptr)
+    renderFrame();
 
   ostringstream sspath;
   sspath << instance().snapshotSaveDir()
@@ -79,15 +79,11 @@ void TiaOutputWidget::saveSnapshot(int execDepth, const string& execPrefix)
 
   const uInt32 width  = instance().console().tia().width(),
                height = instance().console().tia().height();
-  FBSurface& s = dialog().surface();
-
-  // to skip borders, add 1 to origin
-  int x = _x + 1, y = _y + 1;
-  Common::Rect rect(x, y, x + width*2, y + height);
+  Common::Rect rect(width*2, height);
   string message = "Snapshot saved";
   try
   {
-    instance().png().saveImage(sspath.str(), s, rect);
+    instance().png().saveImage(sspath.str(), *mySurface, rect);
   }
   catch(const runtime_error& e)
   {
@@ -175,6 +171,31 @@ void TiaOutputWidget::drawWidget(bool hilite)
   s.vLine(_x + _w + 1, _y, height, kColor);
   s.hLine(_x, _y + height + 1, _x +_w + 1, kColor);
 
+  renderFrame();
+
+  // The image is scaled and positioned by the GPU; to skip borders,
+  // add 1 to origin
+  const uInt32 scale = instance().frameBuffer().hidpiScaleFactor();
+  const Common::Rect& s_dst = s.dstRect();
+  mySurface->setDstPos((_x + 1) * scale + s_dst.x(), (_y + 1) * scale + s_dst.y());
+  mySurface->setDstSize(width * 2 * scale, height * scale);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TiaOutputWidget::renderFrame()
+{
+  const uInt32 width  = instance().console().tia().width(),
+               height = instance().console().tia().height();
+
+  // The image has a surface of its own, drawn on top of the dialog
+  if(mySurface == nullptr)
+  {
+    mySurface = instance().frameBuffer().allocateSurface(
+        TIAConstants::frameBufferWidth*2, TIAConstants::frameBufferHeight);
+    dialog().addSurface(mySurface);
+  }
+  mySurface->setSrcSize(width * 2, height);
+
   // Get current scanline position
   // This determines where the frame greying should start, and where a
   // scanline 'pointer' should be drawn
@@ -184,9 +205,12 @@ void TiaOutputWidget::drawWidget(bool hilite)
   uInt8* tiaOutputBuffer = instance().console().tia().outputBuffer();
   TIASurface& tiaSurface(instance().frameBuffer().tiaSurface());
 
+  uInt32 *pixels, pitch;
+  mySurface->basePtr(pixels, pitch);
+
   for(uInt32 y = 0, i = 0; y < height; ++y)
   {
-    uInt32* line_ptr = myLineBuffer;
+    uInt32* line_ptr = pixels + y * pitch;
     for(uInt32 x = 0; x < width; ++x, ++i)
     {
       uInt8 shift = i >= scanoffset ? 1 : 0;
@@ -194,10 +218,9 @@ void TiaOutputWidget::drawWidget(bool hilite)
       *line_ptr++ = pixel;
       *line_ptr++ = pixel;
     }
-    s.drawPixels(myLineBuffer, _x + 1, _y + 1 + y, width << 1);
   }
 
   // Show electron beam position
   if(visible && scanx < width && scany+2u < height)
-    s.fillRect(_x + 1 + (scanx<<1), _y + 1 + scany, 3, 3, kColorInfo);
+    mySurface->fillRect(scanx<<1, scany, 3, 3, kColorInfo);
 }
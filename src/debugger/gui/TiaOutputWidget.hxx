@@ -53,15 +53,15 @@ class TiaOutputWidget : public Widget, public CommandSender
 
     int myClickX, myClickY;
 
-    // Create this buffer once, instead of allocating it each time the
-    // TIA image is redrawn
-    uInt32 myLineBuffer[320];
+    // The TIA image, which is scaled onto the dialog by the GPU
+    shared_ptr<FBSurface> mySurface;
 
   private:
     void handleMouseDown(int x, int y, MouseButton b, int clickCount) override;
     void handleCommand(CommandSender* sender, int cmd, int data, int id) override;
 
     void drawWidget(bool hilite) override;
+    void renderFrame();
     bool wantsFocus() const override { return false; }
 
     // Following constructors and assignment operators not supported
@@ -22,6 +22,7 @@
 #include "TIA.hxx"
 #include "FrameBuffer.hxx"
 #include "FBSurface.hxx"
+#include "TIASurface.hxx"
 #include "Widget.hxx"
 #include "GuiObject.hxx"
 #include "ContextMenu.hxx"
@@ -53,6 +54,7 @@ TiaZoomWidget::TiaZoomWidget(GuiObject* boss, const GUI::Font& font,
 
   myMouseMoving = false;
   myClickX = myClickY = 0;
+  myFrameChanged = true;
 
   // Create context menu for zoom levels
   VariantList l;
@@ -67,6 +69,7 @@ TiaZoomWidget::TiaZoomWidget(GuiObject* boss, const GUI::Font& font,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TiaZoomWidget::loadConfig()
 {
+  myFrameChanged = true;
   setDirty();
 }
 
@@ -294,13 +297,38 @@ void TiaZoomWidget::drawWidget(bool hilite)
   s.fillRect(_x+1, _y+1, _w-2, _h-2, kBGColor);
   s.frameRect(_x, _y, _w, _h, hilite ? kWidColorHi : kColor);
 
-  // Draw the zoomed image
-  // This probably isn't as efficient as it can be, but it's a small area
-  // and I don't have time to make it faster :)
-  const uInt8* currentFrame  = instance().console().tia().outputBuffer();
-  const int width = instance().console().tia().width(),
-            wzoom = myZoomLevel << 1,
-            hzoom = myZoomLevel;
+  // The zoomed image has a surface of its own, drawn on top of the dialog;
+  // it is only updated when the frame changes, while panning and zooming
+  // just move the part of it which is shown
+  if(mySurface == nullptr)
+  {
+    mySurface = instance().frameBuffer().allocateSurface(
+        TIAConstants::frameBufferWidth, TIAConstants::frameBufferHeight);
+    dialog().addSurface(mySurface);
+  }
+  if(myFrameChanged)
+  {
+    renderFrame();
+    myFrameChanged = false;
+  }
+
+  const int x = myOffX >> 1, w = ((myNumCols + myOffX) >> 1) - x;
+  mySurface->setSrcPos(x, myOffY);
+  mySurface->setSrcSize(w, myNumRows);
+
+  const uInt32 scale = instance().frameBuffer().hidpiScaleFactor();
+  const Common::Rect& s_dst = s.dstRect();
+  mySurface->setDstPos((_x + 1) * scale + s_dst.x(), (_y + 1) * scale + s_dst.y());
+  mySurface->setDstSize(w * (myZoomLevel << 1) * scale, myNumRows * myZoomLevel * scale);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TiaZoomWidget::renderFrame()
+{
+  const uInt8* currentFrame = instance().console().tia().outputBuffer();
+  const uInt32 width  = instance().console().tia().width(),
+               height = instance().console().tia().height();
+  TIASurface& tiaSurface(instance().frameBuffer().tiaSurface());
 
   // Get current scanline position
   // This determines where the frame greying should start
@@ -308,14 +336,13 @@ void TiaZoomWidget::drawWidget(bool hilite)
   instance().console().tia().electronBeamPos(scanx, scany);
   scanoffset = width * scany + scanx;
 
-  int x, y, col, row;
-  for(y = myOffY, row = 0; y < myNumRows+myOffY; ++y, row += hzoom)
+  uInt32 *pixels, pitch;
+  mySurface->basePtr(pixels, pitch);
+
+  for(uInt32 y = 0, idx = 0; y < height; ++y)
   {
-    for(x = myOffX >> 1, col = 0; x < (myNumCols+myOffX) >> 1; ++x, col += wzoom)
-    {
-      uInt32 idx = y*width + x;
-      ColorId color = ColorId(currentFrame[idx] | (idx > scanoffset ? 1 : 0));
-      s.fillRect(_x + col + 1, _y + row + 1, wzoom, hzoom, color);
-    }
+    uInt32* line_ptr = pixels + y * pitch;
+    for(uInt32 x = 0; x < width; ++x, ++idx)
+      *line_ptr++ = tiaSurface.mapIndexedPixel(currentFrame[idx], idx > scanoffset ? 1 : 0);
   }
 }
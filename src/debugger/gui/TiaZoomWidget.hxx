@@ -20,6 +20,7 @@
 
 class GuiObject;
 class ContextMenu;
+class FBSurface;
 
 #include "Widget.hxx"
 #include "Command.hxx"
@@ -50,6 +51,7 @@ class TiaZoomWidget : public Widget, public CommandSender
     void handleCommand(CommandSender* sender, int cmd, int data, int id) override;
 
     void drawWidget(bool hilite) override;
+    void renderFrame();
     bool wantsFocus() const override { return true; }
 
   private:
@@ -63,6 +65,10 @@ class TiaZoomWidget : public Widget, public CommandSender
     bool myMouseMoving;
     int myClickX, myClickY;
 
+    // The TIA image, which is scaled onto the dialog by the GPU
+    shared_ptr<FBSurface> mySurface;
+    bool myFrameChanged;
+
   private:
     // Following constructors and assignment operators not supported
     TiaZoomWidget() = delete;
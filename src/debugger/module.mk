@@ -6,9 +6,13 @@ MODULE_OBJS := \
         src/debugger/DebuggerParser.o \
         src/debugger/CartDebug.o \
         src/debugger/CpuDebug.o \
+        src/debugger/CycleProfiler.o \
         src/debugger/DiStella.o \
+        src/debugger/ExpressionProgram.o \
+        src/debugger/MemoryWatcher.o \
         src/debugger/RiotDebug.o \
-        src/debugger/TIADebug.o
+        src/debugger/TIADebug.o \
+        src/debugger/TraceRecorder.o
 
 MODULE_DIRS += \
         src/debugger
@@ -25,13 +25,17 @@ AtariVox::AtariVox(Jack jack, const Event& event, const System& system,
                    const string& portname, const string& eepromfile,
                    onMessageCallback callback)
   : SaveKey(jack, event, system, eepromfile, callback, Controller::Type::AtariVox),
+    myWriterDone(false),
     myShiftCount(0),
     myShiftRegister(0),
     myLastDataWriteCycle(0)
 {
   mySerialPort = MediaFactory::createSerialPort();
   if(mySerialPort->openPort(portname))
+  {
     myAboutString = " (using serial port \'" + portname + "\')";
+    myWriterThread = std::thread(&AtariVox::writeSpeechBytes, this);
+  }
   else
     myAboutString = " (invalid serial port \'" + portname + "\')";
 
@@ -39,6 +43,20 @@ AtariVox::AtariVox(Jack jack, const Event& event, const System& system,
   setPin(DigitalPin::Four, true);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+AtariVox::~AtariVox()
+{
+  if(myWriterThread.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(myWriterMutex);
+      myWriterDone = true;
+    }
+    myWriterWakeup.notify_one();
+    myWriterThread.join();
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool AtariVox::read(DigitalPin pin)
 {
@@ -106,8 +124,10 @@ void AtariVox::clockDataIn(bool value)
         cerr << "AtariVox: bad stop bit" << endl;
       else
       {
-        uInt8 data = ((myShiftRegister >> 1) & 0xff);
-        mySerialPort->writeByte(&data);
+        // The byte is dropped if the port can't keep up with the queue
+        if(myWriterThread.joinable() &&
+           mySpeechBytes.push(uInt8((myShiftRegister >> 1) & 0xff)))
+          myWriterWakeup.notify_one();
       }
       myShiftRegister = 0;
     }
@@ -116,6 +136,24 @@ void AtariVox::clockDataIn(bool value)
   myLastDataWriteCycle = cycle;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void AtariVox::writeSpeechBytes()
+{
+  uInt8 data;
+  while(!myWriterDone)
+  {
+    while(mySpeechBytes.pop(data))
+      mySerialPort->writeByte(&data);
+
+    // The emulation never takes the lock, so a wakeup may be missed;
+    // the timeout limits the delay this can cause
+    std::unique_lock<std::mutex> lock(myWriterMutex);
+    myWriterWakeup.wait_for(lock, std::chrono::milliseconds(10), [this] {
+      return myWriterDone.load();
+    });
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void AtariVox::reset()
 {
@@ -20,9 +20,15 @@
 
 class OSystem;
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include "Control.hxx"
 #include "SaveKey.hxx"
 #include "SerialPort.hxx"
+#include "LockFreeQueue.hxx"
 
 /**
   Richard Hutchinson's AtariVox "controller": A speech synthesizer and
@@ -31,6 +37,10 @@ class OSystem;
   This code owes a great debt to Alex Herbert's AtariVox documentation and
   driver code.
 
+  The SpeakJet bytes are written to the serial port by a separate thread,
+  since writing may block (particularly with USB-serial adapters), which
+  would otherwise stall the emulation in the middle of a frame.
+
   @author  B. Watson
 */
 class AtariVox : public SaveKey
@@ -49,7 +59,7 @@ class AtariVox : public SaveKey
     AtariVox(Jack jack, const Event& event, const System& system,
              const string& portname, const string& eepromfile,
              onMessageCallback callback);
-    virtual ~AtariVox() = default;
+    virtual ~AtariVox();
 
   public:
     using Controller::read;
@@ -90,12 +100,24 @@ class AtariVox : public SaveKey
   private:
    void clockDataIn(bool value);
 
+   // Write the queued SpeakJet bytes to the serial port, until the
+   // controller is destroyed; runs on its own thread
+   void writeSpeechBytes();
+
   private:
     // Instance of an real serial port on the system
     // Assuming there's a real AtariVox attached, we can send SpeakJet
     // bytes directly to it
     unique_ptr<SerialPort> mySerialPort;
 
+    // The bytes waiting to be written to the serial port, and the thread
+    // writing them (only started when the port could be opened)
+    Common::LockFreeQueue<uInt8, 1024> mySpeechBytes;
+    std::thread myWriterThread;
+    std::atomic<bool> myWriterDone;
+    std::mutex myWriterMutex;
+    std::condition_variable myWriterWakeup;
+
     // How many bits have been shifted into the shift register?
     uInt8 myShiftCount;
 
@@ -0,0 +1,448 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <chrono>
+#include <map>
+#include <thread>
+
+#include "BatchRunner.hxx"
+#include "FSNode.hxx"
+#include "CartDetector.hxx"
+#include "Cart.hxx"
+#include "MD5.hxx"
+#include "Control.hxx"
+#include "ConsoleIO.hxx"
+#include "M6502.hxx"
+#include "M6532.hxx"
+#include "TIA.hxx"
+#include "ConsoleTiming.hxx"
+#include "FrameManager.hxx"
+#include "YStartDetector.hxx"
+#include "FrameLayoutDetector.hxx"
+#include "EmulationTiming.hxx"
+#include "System.hxx"
+#include "Joystick.hxx"
+#include "Random.hxx"
+#include "DispatchResult.hxx"
+#include "Props.hxx"
+#include "Settings.hxx"
+#include "Switches.hxx"
+#include "ThreadPool.hxx"
+#include "AudioQueue.hxx"
+#include "XXH64.hxx"
+#include "Console.hxx"
+#include "PropsSet.hxx"
+#include "Version.hxx"
+#ifdef PNG_SUPPORT
+  #include "PNGLibrary.hxx"
+#endif
+
+using namespace std::chrono;
+
+namespace {
+  constexpr uInt32 RUNTIME_DEFAULT = 60;
+
+  struct IO: public ConsoleIO {
+    Controller& leftController() const override { return *myLeftControl; }
+    Controller& rightController() const override { return *myRightControl; }
+    Switches& switches() const override { return *mySwitches; }
+
+    unique_ptr<Controller> myLeftControl;
+    unique_ptr<Controller> myRightControl;
+    unique_ptr<Switches> mySwitches;
+  };
+
+  // The inputs which can be used in scripts
+  const std::map<string, Event::Type> ourInputs = {
+    { "reset",   Event::ConsoleReset },
+    { "select",  Event::ConsoleSelect },
+    { "color",   Event::ConsoleColor },
+    { "bw",      Event::ConsoleBlackWhite },
+    { "p0diffa", Event::ConsoleLeftDiffA },
+    { "p0diffb", Event::ConsoleLeftDiffB },
+    { "p1diffa", Event::ConsoleRightDiffA },
+    { "p1diffb", Event::ConsoleRightDiffB },
+    { "p0up",    Event::JoystickZeroUp },
+    { "p0down",  Event::JoystickZeroDown },
+    { "p0left",  Event::JoystickZeroLeft },
+    { "p0right", Event::JoystickZeroRight },
+    { "p0fire",  Event::JoystickZeroFire },
+    { "p1up",    Event::JoystickOneUp },
+    { "p1down",  Event::JoystickOneDown },
+    { "p1left",  Event::JoystickOneLeft },
+    { "p1right", Event::JoystickOneRight },
+    { "p1fire",  Event::JoystickOneFire }
+  };
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+BatchRunner::BatchRunner(int argc, char* argv[])
+  : myThreads(0)
+{
+  int arg = 2;
+  for (; argc > arg + 1; arg += 2) {
+    if (string(argv[arg]) == "-hashes") myHashDir = argv[arg + 1];
+    else if (string(argv[arg]) == "-snapshots") mySnapshotDir = argv[arg + 1];
+    else break;
+  }
+
+  if (argc > arg) myManifestFile = argv[arg];
+  if (argc > arg + 1) myThreads = uInt32(std::max(atoi(argv[arg + 1]), 0));
+
+  if (myThreads == 0)
+    myThreads = std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool BatchRunner::run()
+{
+  if (!loadManifest()) return false;
+
+  // Answers the path of the directory, creating it if necessary
+  auto outputDir = [](const string& name, string& path) {
+    FilesystemNode dir(name);
+    if (!dir.isDirectory() && !dir.makeDir()) {
+      cout << "ERROR: unable to create directory '" << name << "'" << endl;
+      return false;
+    }
+    path = dir.getPath();
+    return true;
+  };
+
+  string hashDir, snapshotDir;
+  if (!myHashDir.empty() && !outputDir(myHashDir, hashDir)) return false;
+  if (!mySnapshotDir.empty() && !outputDir(mySnapshotDir, snapshotDir)) return false;
+
+  for (Job& job: myJobs) {
+    if (!hashDir.empty())
+      job.hashFile = hashDir + FilesystemNode(job.romFile).getName() + ".hashes";
+    job.snapshotDir = snapshotDir;
+  }
+
+  uInt32 threads = std::min(myThreads, uInt32(myJobs.size()));
+  cout << "Running " << myJobs.size() << " ROMs on " << threads << " threads..." << endl;
+
+  time_point<high_resolution_clock> tp = high_resolution_clock::now();
+
+  // Each ROM runs on its own System; nothing is shared between the jobs
+  vector<Result> results(myJobs.size());
+  ThreadPool pool;
+  pool.setThreads(threads);
+  pool.run(uInt32(myJobs.size()), [&](uInt32 i) {
+    try {
+      results[i] = runOne(myJobs[i]);
+    }
+    catch (const runtime_error& e) {
+      results[i].ok = false;
+      results[i].error = e.what();
+    }
+  });
+
+  double realtimeUsed = duration_cast<duration<double>>(high_resolution_clock::now() - tp).count();
+
+  uInt32 failed = 0;
+  for (size_t i = 0; i < myJobs.size(); ++i) {
+    const Result& result = results[i];
+
+    cout << myJobs[i].romFile << ": ";
+    if (result.ok)
+      cout << "ok, " << result.frames << " frames, " << result.scanlines
+           << " scanlines, frame " << result.frameHash << ", "
+           << (result.framesHash.empty() ? "" : "all frames " + result.framesHash + ", ")
+           << result.realtime << " seconds" << endl;
+    else {
+      cout << "ERROR: " << result.error << endl;
+      ++failed;
+    }
+  }
+
+  cout << endl << (myJobs.size() - failed) << " of " << myJobs.size()
+       << " ROMs ok, real time: " << realtimeUsed << " seconds" << endl;
+
+  return failed == 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool BatchRunner::loadManifest()
+{
+  ifstream in(myManifestFile);
+  if (!in.is_open()) {
+    cout << "ERROR: unable to read manifest '" << myManifestFile << "'" << endl;
+    return false;
+  }
+
+  string line;
+  while (std::getline(in, line)) {
+    istringstream buf(line);
+    string rom, script;
+
+    if (!(buf >> rom) || rom[0] == '#') continue;
+    buf >> script;
+
+    Job job;
+    size_t splitPoint = rom.find_last_of(":");
+    int runtime = splitPoint == string::npos ? 0 : atoi(rom.substr(splitPoint+1).c_str());
+
+    job.romFile = runtime > 0 ? rom.substr(0, splitPoint) : rom;
+    job.runtime = runtime > 0 ? runtime : RUNTIME_DEFAULT;
+    job.scriptFile = script;
+
+    myJobs.push_back(job);
+  }
+
+  if (myJobs.empty()) {
+    cout << "ERROR: no ROMs in manifest '" << myManifestFile << "'" << endl;
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool BatchRunner::loadScript(const string& filename, vector<Input>& inputs)
+{
+  ifstream in(filename);
+  if (!in.is_open()) return false;
+
+  string line;
+  while (std::getline(in, line)) {
+    istringstream buf(line);
+    Input input;
+    string name;
+
+    if (!(buf >> input.frame >> name >> input.value)) continue;
+
+    if (!inputEvent(name, input.type)) return false;
+
+    inputs.push_back(input);
+  }
+
+  std::stable_sort(inputs.begin(), inputs.end(),
+    [](const Input& a, const Input& b) { return a.frame < b.frame; });
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool BatchRunner::inputEvent(const string& name, Event::Type& event)
+{
+  auto it = ourInputs.find(name);
+  if (it == ourInputs.end()) return false;
+
+  event = it->second;
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+BatchRunner::Result BatchRunner::runOne(const Job& job)
+{
+  Result result;
+  result.ok = false;
+  result.frames = result.scanlines = 0;
+  result.realtime = 0;
+
+  vector<Input> inputs;
+  if (!job.scriptFile.empty() && !loadScript(job.scriptFile, inputs)) {
+    result.error = "unable to read input script " + job.scriptFile;
+    return result;
+  }
+
+  FilesystemNode imageFile(job.romFile);
+  if (!imageFile.isFile()) {
+    result.error = "not a ROM image";
+    return result;
+  }
+
+  ByteBuffer image;
+  uInt32 size = imageFile.read(image);
+  if (size == 0) {
+    result.error = "unable to read ROM";
+    return result;
+  }
+
+  Settings settings;
+  settings.setValue("fastscbios", true);
+  Properties props;
+
+  string md5 = MD5::hash(image, size);
+  string type = "";
+  unique_ptr<Cartridge> cartridge = CartDetector::create(imageFile, image, size, md5, type, settings);
+
+  if (!cartridge) {
+    result.error = "unable to determine cartridge type";
+    return result;
+  }
+
+  time_point<high_resolution_clock> tp = high_resolution_clock::now();
+
+  IO consoleIO;
+  Random rng(0);
+  Event event;
+
+  M6502 cpu(settings);
+  M6532 riot(consoleIO, settings);
+  TIA tia(consoleIO, []() { return ConsoleTiming::ntsc; }, settings);
+  System system(rng, cpu, riot, tia, *cartridge);
+
+  consoleIO.myLeftControl = make_unique<Joystick>(Controller::Jack::Left, event, system);
+  consoleIO.myRightControl = make_unique<Joystick>(Controller::Jack::Right, event, system);
+  consoleIO.mySwitches = make_unique<Switches>(event, props, settings);
+
+  tia.bindToControllers();
+  cartridge->setStartBankFromPropsFunc([]() { return -1; });
+  system.initialize();
+
+  FrameLayoutDetector frameLayoutDetector;
+  tia.setFrameManager(&frameLayoutDetector);
+  system.reset();
+  for(int i = 0; i < 60 && !frameLayoutDetector.isConfident(); ++i) tia.update();
+
+  FrameLayout frameLayout = frameLayoutDetector.detectedLayout();
+  ConsoleTiming consoleTiming =
+    frameLayout == FrameLayout::pal ? ConsoleTiming::pal : ConsoleTiming::ntsc;
+
+  YStartDetector ystartDetector;
+  tia.setFrameManager(&ystartDetector);
+  system.reset();
+  for (int i = 0; i < 80 && !ystartDetector.isConfident(); i++) tia.update();
+
+  FrameManager frameManager;
+  tia.setFrameManager(&frameManager);
+  tia.setLayout(frameLayout);
+  tia.setYStart(ystartDetector.detectedYStart());
+
+  system.reset();
+
+  EmulationTiming emulationTiming(frameLayout, consoleTiming);
+
+  uInt64 cycles = 0;
+  uInt64 cyclesTarget = job.runtime * emulationTiming.cyclesPerSecond();
+  size_t nextInput = 0;
+
+  // For hashing every frame, the audio is generated as during normal
+  // emulation, and hashed as it is drained after every timeslice
+  ofstream hashes;
+  shared_ptr<AudioQueue> audioQueue;
+  Int16* fragment = nullptr;
+  XXH64::Hasher audioHash, framesHash;
+
+  if (!job.hashFile.empty()) {
+    hashes.open(job.hashFile);
+    if (!hashes.is_open()) {
+      result.error = "unable to create " + job.hashFile;
+      return result;
+    }
+    hashes << "# " << job.romFile << " (" << md5 << "): frame, frame buffer, audio\n";
+
+    audioQueue = make_shared<AudioQueue>(
+      emulationTiming.audioFragmentSize(), emulationTiming.audioQueueCapacity(), false
+    );
+    tia.setAudioQueue(audioQueue);
+  }
+
+  DispatchResult dispatchResult;
+  dispatchResult.setOk(0);
+
+  while (cycles < cyclesTarget && dispatchResult.getStatus() == DispatchResult::Status::ok) {
+    // Apply all inputs due by now, and let the controllers see them
+    uInt32 frame = tia.frameCount();
+    for (; nextInput < inputs.size() && inputs[nextInput].frame <= frame; ++nextInput)
+      event.set(inputs[nextInput].type, inputs[nextInput].value);
+    riot.update();
+
+    tia.update(dispatchResult);
+    cycles += dispatchResult.getCycles();
+
+    if (audioQueue)
+      while (Int16* next = audioQueue->dequeue(fragment)) {
+        audioHash.update(reinterpret_cast<const uInt8*>(next),
+                         audioQueue->fragmentSize() * sizeof(Int16));
+        fragment = next;
+      }
+
+    if (tia.newFramePending()) {
+      tia.renderToFrameBuffer();
+
+      if (hashes.is_open()) {
+        const uInt64 hash[2] = {
+          XXH64::hash(tia.frameBuffer(), TIAConstants::H_PIXEL * tia.height()),
+          audioHash.digest()
+        };
+        hashes << tia.frameCount() << " " << XXH64::toString(hash[0]) << " "
+               << XXH64::toString(hash[1]) << "\n";
+
+        framesHash.update(reinterpret_cast<const uInt8*>(hash), sizeof(hash));
+        audioHash.reset();
+      }
+    }
+  }
+
+  result.realtime = duration_cast<duration<double>>(high_resolution_clock::now() - tp).count();
+  result.frames = tia.frameCount();
+  result.scanlines = tia.scanlinesLastFrame();
+
+  if (dispatchResult.getStatus() != DispatchResult::Status::ok) {
+    result.error = "emulation failed after " + std::to_string(cycles) + " cycles";
+    return result;
+  }
+
+  result.frameHash = MD5::hash(tia.frameBuffer(), TIAConstants::H_PIXEL * tia.height());
+
+#ifdef PNG_SUPPORT
+  if (!job.snapshotDir.empty()) {
+    // Named like the snapshots shown by the launcher
+    Properties romProps;
+    if (!PropertiesSet().getMD5(md5, romProps, true))
+      romProps.set(PropType::Cart_Name, imageFile.getNameWithExt(""));
+    const string& name = romProps.get(PropType::Cart_Name);
+
+    // Every TIA pixel is two pixels wide, as in snapshots taken in 1x mode
+    const uInt32* palette = Console::standardPalette(consoleTiming);
+    const uInt8* tiaIn = tia.frameBuffer();
+    const uInt32 width = TIAConstants::H_PIXEL * 2, height = tia.height();
+    vector<uInt32> pixels(width * height);
+    for (uInt32 i = 0; i < width * height; i += 2)
+      pixels[i] = pixels[i + 1] = palette[*tiaIn++ & 0xfe];
+
+    VariantList comments;
+    VarList::push_back(comments, "Software", string("Stella ") + STELLA_VERSION +
+                       " (Build " + STELLA_BUILD + ") [" + BSPF::ARCH + "]");
+    VarList::push_back(comments, "ROM Name", name);
+    VarList::push_back(comments, "ROM MD5", md5);
+
+    try {
+      PNGLibrary::saveImage(job.snapshotDir + name + ".png", pixels.data(),
+                            width, height, comments);
+    }
+    catch (const runtime_error& e) {
+      result.error = e.what();
+      return result;
+    }
+  }
+#endif
+
+  if (hashes.is_open()) {
+    result.framesHash = XXH64::toString(framesHash.digest());
+    if (!hashes.flush()) {
+      result.error = "unable to write " + job.hashFile;
+      return result;
+    }
+  }
+  result.ok = true;
+
+  return result;
+}
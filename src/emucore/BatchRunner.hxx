@@ -0,0 +1,116 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef BATCH_RUNNER
+#define BATCH_RUNNER
+
+#include "bspf.hxx"
+#include "Event.hxx"
+
+/**
+  Runs a list of ROMs headless, without OSystem, FrameBuffer or Sound,
+  for regression sweeps:
+
+    stella -batch [-hashes <dir>] [-snapshots <dir>] <manifest> [threads]
+
+  Each line of the manifest names a ROM, optionally followed by the
+  number of seconds to emulate (as for '-profile') and an input script:
+
+    <rom>[:seconds] [<script>]
+
+  Empty lines and lines starting with '#' are ignored.  An input script
+  contains lines of the form '<frame> <input> <value>', which set the
+  input (e.g. 'reset', 'p0fire', 'p1left') to the value (0 or 1) at the
+  start of the given frame.
+
+  The ROMs run in parallel on a thread pool (by default one thread per
+  core), each with its own System, and a result line is printed for
+  every ROM in manifest order.  The final frame is reported as an MD5
+  hash, so results can be compared between builds.
+
+  With '-hashes', the frame buffer and the audio of every frame are
+  hashed (with XXH64) as well, and written to '<dir>/<rom name>.hashes',
+  one line per frame.  The result line then has a hash of all of them,
+  which changes if a single frame is different; comparing the files shows
+  the first frame where two builds diverge.
+
+  With '-snapshots', the final frame of every ROM is saved as a PNG
+  snapshot to the directory, named like the snapshots the launcher shows
+  (after the name in the ROM properties).
+*/
+class BatchRunner {
+  public:
+
+    BatchRunner(int argc, char* argv[]);
+
+    bool run();
+
+    /**
+      Get the event for the name of an input in scripts (e.g. 'p0fire').
+
+      @return  False if there is no such input
+    */
+    static bool inputEvent(const string& name, Event::Type& event);
+
+  private:
+
+    struct Input {
+      uInt32 frame;
+      Event::Type type;
+      Int32 value;
+    };
+
+    struct Job {
+      string romFile;
+      uInt32 runtime;
+      string scriptFile;
+      string hashFile;
+      string snapshotDir;
+    };
+
+    struct Result {
+      bool ok;
+      string error;
+      uInt32 frames;
+      uInt32 scanlines;
+      string frameHash;
+      string framesHash;
+      double realtime;
+    };
+
+  private:
+
+    bool loadManifest();
+
+    static bool loadScript(const string& filename, vector<Input>& inputs);
+
+    static Result runOne(const Job& job);
+
+  private:
+
+    string myManifestFile;
+
+    // The directories for the hashes of every frame and the snapshots,
+    // if requested
+    string myHashDir, mySnapshotDir;
+
+    uInt32 myThreads;
+
+    vector<Job> myJobs;
+};
+
+#endif // BATCH_RUNNER
@@ -0,0 +1,555 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <new>
+
+#include "BenchmarkRunner.hxx"
+#include "Cart4K.hxx"
+#include "MD5.hxx"
+#include "Control.hxx"
+#include "ConsoleIO.hxx"
+#include "M6502.hxx"
+#include "M6532.hxx"
+#include "TIA.hxx"
+#include "TIAConstants.hxx"
+#include "DelayQueue.hxx"
+#include "ConsoleTiming.hxx"
+#include "FrameManager.hxx"
+#include "EmulationTiming.hxx"
+#include "System.hxx"
+#include "Joystick.hxx"
+#include "Random.hxx"
+#include "DispatchResult.hxx"
+#include "Props.hxx"
+#include "Settings.hxx"
+#include "Switches.hxx"
+#include "Event.hxx"
+#include "Serializer.hxx"
+#include "Thumbulator.hxx"
+#include "audio/LanczosResampler.hxx"
+#include "AtariNTSC.hxx"
+
+using namespace std::chrono;
+
+namespace {
+  // Heap allocations are counted by replacing the global operator new
+  // (see below); the counter is only read by the benchmarks
+  std::atomic<uInt64> ourAllocations(0);
+
+  constexpr double MIN_TIME_DEFAULT = 1.0;
+
+  // One NTSC frame
+  constexpr uInt32 FRAME_LINES = 262;
+  constexpr uInt32 FRAME_CYCLES = FRAME_LINES * TIAConstants::H_CYCLES;
+
+  // Visible height of the generated frames
+  constexpr uInt32 FRAME_HEIGHT = 210;
+
+  // Audio is resampled to this format
+  constexpr uInt32 OUTPUT_SAMPLE_RATE = 48000;
+  constexpr uInt32 OUTPUT_FRAGMENT_SIZE = 512;
+
+  // A 6507 loop exercising the ALU and zero page RAM; it never touches the
+  // TIA or RIOT, so only the CPU (and the TIA catching up) is measured
+  constexpr uInt8 ourProgram6502[] = {
+    0xA2, 0x00,        //       LDX #$00
+    0xA0, 0x00,        //       LDY #$00
+    0xE8,              // loop: INX
+    0x8A,              //       TXA
+    0x65, 0x80,        //       ADC $80
+    0x85, 0x80,        //       STA $80
+    0x49, 0x5A,        //       EOR #$5A
+    0x0A,              //       ASL
+    0x26, 0x81,        //       ROL $81
+    0xA5, 0x82,        //       LDA $82
+    0xC8,              //       INY
+    0xD0, 0xF0,        //       BNE loop
+    0x4C, 0x04, 0xF0   //       JMP loop
+  };
+
+  // A Thumb loop doing ALU work and RAM accesses, placed where the DPC+
+  // driver calls into custom ARM code; returning to the (even) link
+  // register address ends the run
+  constexpr uInt32 THUMB_START = 0x0C08;
+  constexpr uInt16 ourProgramThumb[] = {
+    0x2000,  //       movs r0, #0
+    0x214E,  //       movs r1, #0x4E
+    0x0209,  //       lsls r1, r1, #8      ; 19968 iterations
+    0x2201,  //       movs r2, #1
+    0x2440,  //       movs r4, #0x40
+    0x0624,  //       lsls r4, r4, #24
+    0x2510,  //       movs r5, #0x10
+    0x022D,  //       lsls r5, r5, #8
+    0x1964,  //       adds r4, r4, r5      ; r4 = 0x40001000 (RAM)
+    0x1880,  // loop: adds r0, r0, r2
+    0x4042,  //       eors r2, r0
+    0x6060,  //       str  r0, [r4, #4]
+    0x6863,  //       ldr  r3, [r4, #4]
+    0x18D2,  //       adds r2, r2, r3
+    0x3901,  //       subs r1, #1
+    0xD1F8,  //       bne  loop
+    0x4770   //       bx   lr
+  };
+
+  struct IO: public ConsoleIO {
+    Controller& leftController() const override { return *myLeftControl; }
+    Controller& rightController() const override { return *myRightControl; }
+    Switches& switches() const override { return *mySwitches; }
+
+    unique_ptr<Controller> myLeftControl;
+    unique_ptr<Controller> myRightControl;
+    unique_ptr<Switches> mySwitches;
+  };
+
+  unique_ptr<Cartridge> createCartridge(const Settings& settings)
+  {
+    constexpr uInt32 size = 4096;
+
+    ByteBuffer image = make_unique<uInt8[]>(size);
+    std::fill_n(image.get(), size, 0xEA);
+    std::copy_n(ourProgram6502, sizeof(ourProgram6502), image.get());
+
+    // Reset and break vectors point to the start of the program
+    image[0xFFC] = image[0xFFE] = 0x00;
+    image[0xFFD] = image[0xFFF] = 0xF0;
+
+    return make_unique<Cartridge4K>(image, size, MD5::hash(image, size), settings);
+  }
+
+  // A complete 2600, running the 6507 program above
+  struct Machine {
+    Machine()
+      : rng(0),
+        cartridge(createCartridge(settings)),
+        cpu(settings),
+        riot(io, settings),
+        tia(io, []() { return ConsoleTiming::ntsc; }, settings),
+        system(rng, cpu, riot, tia, *cartridge)
+    {
+      io.myLeftControl = make_unique<Joystick>(Controller::Jack::Left, event, system);
+      io.myRightControl = make_unique<Joystick>(Controller::Jack::Right, event, system);
+      io.mySwitches = make_unique<Switches>(event, props, settings);
+
+      tia.bindToControllers();
+      cartridge->setStartBankFromPropsFunc([]() { return -1; });
+      system.initialize();
+
+      tia.setFrameManager(&frameManager);
+      tia.setLayout(FrameLayout::ntsc);
+      system.reset();
+    }
+
+    Settings settings;
+    Properties props;
+    Event event;
+    IO io;
+    Random rng;
+    unique_ptr<Cartridge> cartridge;
+    M6502 cpu;
+    M6532 riot;
+    TIA tia;
+    System system;
+    FrameManager frameManager;
+  };
+
+  // Keeps the compiler from optimizing away results
+  volatile uInt32 ourSink = 0;
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  std::function<uInt64()> setupM6502()
+  {
+    shared_ptr<Machine> machine = make_shared<Machine>();
+
+    return [machine] () {
+      DispatchResult result;
+      machine->cpu.execute(FRAME_CYCLES, result);
+
+      return result.getCycles();
+    };
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  std::function<uInt64()> setupTIA()
+  {
+    shared_ptr<Machine> machine = make_shared<Machine>();
+    TIA& tia = machine->tia;
+
+    // Playfield, both players and the ball are visible
+    tia.poke(COLUPF, 0x46);  tia.poke(COLUP0, 0x1E);  tia.poke(COLUP1, 0x86);
+    tia.poke(PF0, 0xA0);     tia.poke(PF1, 0x55);     tia.poke(PF2, 0xAA);
+    tia.poke(ENABL, 0x02);   tia.poke(CTRLPF, 0x31);
+
+    // Draw one frame with the 6507 clock advanced directly, so only the TIA
+    // runs; writing the graphics registers on every line keeps the delay
+    // queue busy
+    return [machine] () {
+      System& system = machine->system;
+      TIA& t = machine->tia;
+
+      t.poke(VSYNC, 0x02);
+      system.incrementCycles(3 * TIAConstants::H_CYCLES);
+      t.poke(VSYNC, 0x00);
+
+      for (uInt32 line = 3; line < FRAME_LINES; ++line) {
+        t.poke(COLUBK, uInt8(line));
+        t.poke(GRP0, uInt8(line * 3));
+        t.poke(GRP1, uInt8(~line));
+        system.incrementCycles(TIAConstants::H_CYCLES);
+      }
+      t.updateEmulation();
+
+      return uInt64(FRAME_CYCLES);
+    };
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  std::function<uInt64()> setupDelayQueue()
+  {
+    shared_ptr<DelayQueue<16, 16>> queue = make_shared<DelayQueue<16, 16>>();
+
+    // One frame worth of color clocks, with a write every four clocks
+    return [queue] () {
+      uInt32 sum = 0;
+      const auto executor = [&sum] (uInt8 address, uInt8 value) { sum += address ^ value; };
+
+      for (uInt32 clock = 0; clock < FRAME_CYCLES * TIAConstants::CYCLE_CLOCKS; ++clock) {
+        if ((clock & 0x03) == 0)
+          queue->push(uInt8(clock >> 2) & 0x3F, uInt8(clock), 1 + (clock >> 2) % 3);
+
+        queue->execute(executor);
+      }
+      ourSink = sum;
+
+      return 0;
+    };
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  std::function<uInt64()> setupThumbulator()
+  {
+    struct Fixture {
+      Fixture()
+        : rom(make_unique<uInt16[]>(ROMSIZE / 2)),
+          ram(make_unique<uInt16[]>(RAMSIZE / 2)),
+          thumb(loadProgram(rom.get()), ram.get(), ROMSIZE, true,
+                Thumbulator::ConfigureFor::DPCplus, nullptr) { }
+
+      // The program must be in place before the Thumbulator decodes the ROM
+      static const uInt16* loadProgram(uInt16* rom) {
+        std::copy_n(ourProgramThumb, sizeof(ourProgramThumb) / sizeof(uInt16),
+                    rom + THUMB_START / 2);
+        return rom;
+      }
+
+      unique_ptr<uInt16[]> rom;
+      unique_ptr<uInt16[]> ram;
+      Thumbulator thumb;
+    };
+
+    shared_ptr<Fixture> fixture = make_shared<Fixture>();
+
+    return [fixture] () {
+      fixture->thumb.run();
+
+      return 0;
+    };
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  std::function<uInt64()> setupSerializerSave()
+  {
+    shared_ptr<Machine> machine = make_shared<Machine>();
+    shared_ptr<Serializer> out = make_shared<Serializer>();
+
+    machine->cpu.execute(FRAME_CYCLES);
+
+    return [machine, out] () {
+      out->rewind();
+      if (!machine->system.save(*out)) throw runtime_error("unable to save state");
+
+      return 0;
+    };
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  std::function<uInt64()> setupSerializerLoad()
+  {
+    shared_ptr<Machine> machine = make_shared<Machine>();
+    shared_ptr<Serializer> state = make_shared<Serializer>();
+
+    machine->cpu.execute(FRAME_CYCLES);
+    if (!machine->system.save(*state)) throw runtime_error("unable to save state");
+
+    return [machine, state] () {
+      state->rewind();
+      if (!machine->system.load(*state)) throw runtime_error("unable to load state");
+
+      return 0;
+    };
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  std::function<uInt64()> setupLanczos()
+  {
+    struct Fixture {
+      Fixture()
+        : timing(FrameLayout::ntsc, ConsoleTiming::ntsc),
+          input(timing.audioFragmentSize()),
+          output(2 * OUTPUT_FRAGMENT_SIZE),
+          resampler(
+            Resampler::Format(timing.audioSampleRate(), timing.audioFragmentSize(), false),
+            Resampler::Format(OUTPUT_SAMPLE_RATE, OUTPUT_FRAGMENT_SIZE, true),
+            [this] () { return input.data(); },
+            3)
+      {
+        // A square wave with some noise
+        Random rng(0);
+        for (size_t i = 0; i < input.size(); ++i)
+          input[i] = Int16(((i & 0x20) ? 8000 : -8000) + Int32(rng.next() & 0xFF));
+      }
+
+      EmulationTiming timing;
+      vector<Int16> input;
+      vector<float> output;
+      LanczosResampler resampler;
+    };
+
+    shared_ptr<Fixture> fixture = make_shared<Fixture>();
+
+    return [fixture] () {
+      fixture->resampler.fillFragment(fixture->output.data(), uInt32(fixture->output.size()));
+
+      return 0;
+    };
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  std::function<uInt64()> setupAtariNTSC()
+  {
+    struct Fixture {
+      Fixture()
+        : input(TIAConstants::frameBufferWidth * FRAME_HEIGHT),
+          output(AtariNTSC::outWidth(TIAConstants::frameBufferWidth) * FRAME_HEIGHT)
+      {
+        uInt8 palette[AtariNTSC::palette_size * 3];
+        for (uInt32 i = 0; i < AtariNTSC::palette_size * 3; ++i)
+          palette[i] = uInt8(i * 7);
+        ntsc.initialize(AtariNTSC::TV_Composite, palette);
+
+        // Vertical color bars, shifted on every line
+        for (uInt32 y = 0; y < FRAME_HEIGHT; ++y)
+          for (uInt32 x = 0; x < TIAConstants::frameBufferWidth; ++x)
+            input[y * TIAConstants::frameBufferWidth + x] = uInt8(((x + y) / 8) << 1);
+      }
+
+      vector<uInt8> input;
+      vector<uInt32> output;
+      AtariNTSC ntsc;
+    };
+
+    shared_ptr<Fixture> fixture = make_shared<Fixture>();
+
+    return [fixture] () {
+      fixture->ntsc.render(fixture->input.data(), TIAConstants::frameBufferWidth, FRAME_HEIGHT,
+                           fixture->output.data(),
+                           AtariNTSC::outWidth(TIAConstants::frameBufferWidth) * 4);
+
+      return 0;
+    };
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void* operator new(std::size_t size)
+{
+  ourAllocations.fetch_add(1, std::memory_order_relaxed);
+
+  void* ptr = std::malloc(size > 0 ? size : 1);
+  if (!ptr) throw std::bad_alloc();
+
+  return ptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+BenchmarkRunner::BenchmarkRunner(int argc, char* argv[])
+  : myMinTime(MIN_TIME_DEFAULT)
+{
+  for (int i = 2; i < argc; i++) {
+    string arg = argv[i];
+
+    if (arg == "-time" && i + 1 < argc) {
+      double time = atof(argv[++i]);
+      if (time > 0) myMinTime = time;
+    }
+    else if (arg == "-json" && i + 1 < argc)
+      myJsonFile = argv[++i];
+    else
+      myFilters.push_back(arg);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool BenchmarkRunner::run()
+{
+  vector<Result> results;
+
+  cout << "Benchmarking Stella..." << endl << endl
+       << std::left << std::setw(24) << "benchmark" << std::right
+       << std::setw(14) << "ns/op" << std::setw(16) << "cycles/s"
+       << std::setw(12) << "allocs/op" << endl;
+
+  try {
+    for (const Benchmark& benchmark : benchmarks()) {
+      if (!selected(benchmark)) continue;
+
+      (cout << std::left << std::setw(24) << benchmark.name << std::right).flush();
+
+      Result result = measure(benchmark);
+      results.push_back(result);
+
+      cout << std::fixed
+           << std::setw(14) << std::setprecision(1) << (result.seconds * 1e9 / result.iterations)
+           << std::setw(16) << std::setprecision(0);
+      if (result.cycles > 0) cout << (result.cycles / result.seconds);
+      else                   cout << "-";
+      cout << std::setw(12) << std::setprecision(2) << (double(result.allocations) / result.iterations)
+           << endl;
+    }
+  }
+  catch (const std::exception& e) {
+    cout << endl << "ERROR: " << e.what() << endl;
+    return false;
+  }
+
+  if (results.empty()) {
+    cout << "ERROR: no matching benchmark" << endl;
+    return false;
+  }
+
+  return myJsonFile.empty() || writeJson(results);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+BenchmarkRunner::Result BenchmarkRunner::measure(const Benchmark& benchmark) const
+{
+  Operation operation = benchmark.setup();
+
+  // Warm up caches and let the operation do any allocations it does
+  // only once
+  operation();
+
+  uInt64 iterations = 1;
+  for (;;) {
+    uInt64 cycles = 0;
+    uInt64 allocations = ourAllocations.load(std::memory_order_relaxed);
+    time_point<high_resolution_clock> start = high_resolution_clock::now();
+
+    for (uInt64 i = 0; i < iterations; ++i) cycles += operation();
+
+    double seconds = duration_cast<duration<double>>(high_resolution_clock::now() - start).count();
+    allocations = ourAllocations.load(std::memory_order_relaxed) - allocations;
+
+    if (seconds >= myMinTime)
+      return { benchmark.name, benchmark.operation, iterations, seconds, cycles, allocations };
+
+    // Aim a little above the minimum time, growing at most tenfold per round
+    iterations = seconds > 0
+      ? std::min(iterations * 10, uInt64(iterations * 1.1 * myMinTime / seconds) + 1)
+      : iterations * 10;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool BenchmarkRunner::selected(const Benchmark& benchmark) const
+{
+  if (myFilters.empty()) return true;
+
+  for (const string& filter : myFilters)
+    if (BSPF::startsWithIgnoreCase(benchmark.name, filter)) return true;
+
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool BenchmarkRunner::writeJson(const vector<Result>& results) const
+{
+  std::ofstream out(myJsonFile);
+
+  out << std::setprecision(10) << "{" << endl
+      << "  \"minTime\": " << myMinTime << "," << endl
+      << "  \"benchmarks\": [" << endl;
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Result& result = results[i];
+
+    out << "    {" << endl
+        << "      \"name\": \"" << result.name << "\"," << endl
+        << "      \"operation\": \"" << result.operation << "\"," << endl
+        << "      \"iterations\": " << result.iterations << "," << endl
+        << "      \"seconds\": " << result.seconds << "," << endl
+        << "      \"nsPerOp\": " << (result.seconds * 1e9 / result.iterations) << "," << endl
+        << "      \"cyclesPerSecond\": ";
+    if (result.cycles > 0) out << (result.cycles / result.seconds);
+    else                   out << "null";
+    out << "," << endl
+        << "      \"allocationsPerOp\": " << (double(result.allocations) / result.iterations) << endl
+        << "    }" << (i + 1 < results.size() ? "," : "") << endl;
+  }
+
+  out << "  ]" << endl << "}" << endl;
+
+  if (!out) {
+    cout << "ERROR: unable to write " << myJsonFile << endl;
+    return false;
+  }
+
+  cout << endl << "results written to " << myJsonFile << endl;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<BenchmarkRunner::Benchmark> BenchmarkRunner::benchmarks()
+{
+  return {
+    { "m6502.execute",   "one frame of 6507 code, including the TIA catching up", setupM6502 },
+    { "tia.cycle",       "one frame of TIA emulation, without the 6507", setupTIA },
+    { "delayqueue",      "one frame of color clocks, a write every four clocks", setupDelayQueue },
+    { "thumbulator.run", "one call into ARM code (about 140k instructions)", setupThumbulator },
+    { "serializer.save", "save the System state", setupSerializerSave },
+    { "serializer.load", "load the System state", setupSerializerLoad },
+    { "lanczos.fill",    "resample one fragment of 512 stereo samples", setupLanczos },
+    { "ntsc.render",     "render a 160x210 frame with the composite filter", setupAtariNTSC }
+  };
+}
@@ -0,0 +1,92 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef BENCHMARK_RUNNER
+#define BENCHMARK_RUNNER
+
+#include <functional>
+
+#include "bspf.hxx"
+
+/**
+  Runs micro-benchmarks of the core emulation components in isolation,
+  without OSystem, FrameBuffer or Sound:
+
+    stella -benchmark [-time <seconds>] [-json <file>] [<name> ...]
+
+  Only the benchmarks whose name starts with one of the given names are
+  run (all of them if none is given).  The components are fed synthetic
+  data (a small 6502 and ARM program, generated frames and audio), so
+  the results don't depend on any ROM and can be compared between builds
+  and machines.  Each benchmark is repeated until it has run for the
+  given time (by default one second).
+
+  The results are printed as a table and optionally written to a JSON
+  file: time per operation, emulated 6507 cycles per second (where this
+  applies) and heap allocations per operation.
+*/
+class BenchmarkRunner {
+  public:
+
+    BenchmarkRunner(int argc, char* argv[]);
+
+    bool run();
+
+  private:
+
+    // A single operation of a benchmark; answers the number of 6507
+    // cycles emulated (or 0)
+    using Operation = std::function<uInt64()>;
+
+    struct Benchmark {
+      string name;
+      string operation;
+      std::function<Operation()> setup;
+    };
+
+    struct Result {
+      string name;
+      string operation;
+      uInt64 iterations;
+      double seconds;
+      uInt64 cycles;
+      uInt64 allocations;
+    };
+
+  private:
+
+    Result measure(const Benchmark& benchmark) const;
+
+    bool selected(const Benchmark& benchmark) const;
+
+    bool writeJson(const vector<Result>& results) const;
+
+    static vector<Benchmark> benchmarks();
+
+  private:
+
+    // Minimum time each benchmark is run
+    double myMinTime;
+
+    // If not empty, the results are written to this file
+    string myJsonFile;
+
+    // Name prefixes of the benchmarks to run
+    vector<string> myFilters;
+};
+
+#endif // BENCHMARK_RUNNER
@@ -18,6 +18,9 @@
 #include "Settings.hxx"
 #include "System.hxx"
 #include "MD5.hxx"
+
+#include <map>
+#include <mutex>
 #ifdef DEBUGGER_SUPPORT
   #include "Debugger.hxx"
   #include "CartDebug.hxx"
@@ -30,6 +33,12 @@ Cartridge::Cartridge(const Settings& settings, const string& md5)
   : mySettings(settings),
     myBankChanged(true),
     myCodeAccessBase(nullptr),
+    myBankPagesStart(0),
+    myBankPagesCount(0),
+    myBankPagesBanks(0),
+    myImageSize(0),
+    myImageShared(false),
+    myMD5(md5),
     myStartBank(0),
     myBankLocked(false)
 {
@@ -121,6 +130,11 @@ void Cartridge::pokeRAM(uInt8& dest, uInt16 address, uInt8 value)
 void Cartridge::createCodeAccessBase(uInt32 size)
 {
 #ifdef DEBUGGER_SUPPORT
+  if(mySettings.getBool("lean"))
+  {
+    myCodeAccessBase = nullptr;
+    return;
+  }
   myCodeAccessBase = make_unique<uInt8[]>(size);
   memset(myCodeAccessBase.get(), CartDebug::ROW, size);
 #else
@@ -128,6 +142,110 @@ void Cartridge::createCodeAccessBase(uInt32 size)
 #endif
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8* Cartridge::shareImage(const ByteBuffer& image, uInt32 size,
+                             uInt32 romSize, uInt8 fill)
+{
+  // All images in use, by MD5, size and padding; entries expire with the
+  // last cart using them
+  static std::mutex mutex;
+  static std::map<string, std::weak_ptr<uInt8>> images;
+
+  const uInt32 copySize = std::min(size, romSize);
+  const string key = myMD5 + ":" + std::to_string(romSize) + ":" +
+                     std::to_string(fill);
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  auto found = images.find(key);
+  if(found != images.end())
+  {
+    mySharedImage = found->second.lock();
+    // Only trust the MD5 if the contents match as well
+    if(mySharedImage && memcmp(mySharedImage.get(), image.get(), copySize) != 0)
+      mySharedImage = nullptr;
+  }
+
+  if(!mySharedImage)
+  {
+    for(auto i = images.begin(); i != images.end(); )
+      i = i->second.expired() ? images.erase(i) : std::next(i);
+
+    mySharedImage = shared_ptr<uInt8>(new uInt8[romSize], std::default_delete<uInt8[]>());
+    memcpy(mySharedImage.get(), image.get(), copySize);
+    memset(mySharedImage.get() + copySize, fill, romSize - copySize);
+    images[key] = mySharedImage;
+  }
+
+  myImageSize = romSize;
+  myImageShared = true;
+
+  return mySharedImage.get();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8* Cartridge::privateImage()
+{
+  if(myImageShared)
+  {
+    uInt8* shared = mySharedImage.get();
+    shared_ptr<uInt8> copy(new uInt8[myImageSize], std::default_delete<uInt8[]>());
+    memcpy(copy.get(), shared, myImageSize);
+
+    // Move all page accesses into the copy
+    auto relocate = [&](System::PageAccess& access) {
+      if(access.directPeekBase >= shared &&
+         access.directPeekBase < shared + myImageSize)
+        access.directPeekBase = copy.get() + (access.directPeekBase - shared);
+    };
+    for(uInt32 i = 0; i < uInt32(myBankPagesBanks) * myBankPagesCount; ++i)
+      relocate(myBankPages[i]);
+    if(mySystem)
+    {
+      for(uInt16 addr = 0; addr < 0x2000; addr += System::PAGE_SIZE)
+      {
+        System::PageAccess access = mySystem->getPageAccess(addr);
+        if(access.device == this)
+        {
+          relocate(access);
+          mySystem->setPageAccess(addr, access);
+        }
+      }
+    }
+
+    mySharedImage = copy;
+    myImageShared = false;
+  }
+
+  return mySharedImage.get();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge::createBankPages(const System::PageAccess& access, uInt8* image,
+                                uInt16 banks, uInt16 start, uInt16 hotspot)
+{
+  const uInt16 hotspotPage = hotspot & ~System::PAGE_MASK;
+
+  myBankPagesStart = start;
+  myBankPagesCount = (0x2000 - start) >> System::PAGE_SHIFT;
+  myBankPagesBanks = banks;
+  myBankPages = make_unique<System::PageAccess[]>(banks * myBankPagesCount);
+
+  System::PageAccess* page = myBankPages.get();
+  for(uInt16 bank = 0; bank < banks; ++bank)
+  {
+    const uInt32 offset = bank << 12;
+
+    for(uInt16 addr = start; addr < 0x2000; addr += System::PAGE_SIZE, ++page)
+    {
+      *page = access;
+      if(addr < hotspotPage)
+        page->directPeekBase = &image[offset + (addr & 0x0FFF)];
+      page->codeAccessBase = &myCodeAccessBase[offset + (addr & 0x0FFF)];
+    }
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge::initializeRAM(uInt8* arr, uInt32 size, uInt8 val) const
 {
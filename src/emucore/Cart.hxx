@@ -23,9 +23,11 @@ class Properties;
 class CartDebugWidget;
 class CartRamWidget;
 class GuiObject;
+class ThumbProfiler;
 
 #include "bspf.hxx"
 #include "Device.hxx"
+#include "System.hxx"
 #include "Settings.hxx"
 #ifdef DEBUGGER_SUPPORT
   #include "Font.hxx"
@@ -185,6 +187,16 @@ class Cartridge : public Device
     */
     virtual const uInt8* getImage(uInt32& size) const = 0;
 
+    /**
+      Access the internal RAM of this cartridge, so that frontends can
+      read and write it directly; not all carts support this.
+
+      @param size  Set to the size of the internal RAM (0 if there is none)
+      @return  A pointer to the internal RAM, which stays valid for the
+               lifetime of the cart, or nullptr if there is none
+    */
+    virtual uInt8* getRAM(uInt32& size) { size = 0;  return nullptr; }
+
     /**
       Get a descriptor for the cart name.
 
@@ -208,6 +220,24 @@ class Cartridge : public Device
     */
     virtual uInt32 thumbCallback(uInt8 function, uInt32 value1, uInt32 value2) { return 0; }
 
+    /**
+      Count the cycles of the ARM code run by the cartridge (if any) in the
+      given profiler; the null pointer stops profiling.  Any ARM code still
+      running is finished first.
+
+      @return  False if the cartridge doesn't run ARM code
+    */
+    virtual bool setThumbProfiler(ThumbProfiler* profiler) { return false; }
+
+    /**
+      Run the ARM code of the cartridge (if any) in the fast mode of the
+      Thumbulator, which the 'Cart.ThumbFast' property enables for ROMs
+      known to work with it.
+
+      @return  False if the cartridge doesn't run ARM code
+    */
+    virtual bool setThumbFastMode(bool enable) { return false; }
+
   #ifdef DEBUGGER_SUPPORT
     /**
       Get optional debugger widget responsible for displaying info about the cart.
@@ -260,12 +290,67 @@ class Cartridge : public Device
     /**
       Create an array that holds code-access information for every byte
       of the ROM (indicated by 'size').  Note that this is only used by
-      the debugger, and is unavailable otherwise.
+      the debugger, and is unavailable otherwise (also for lean consoles).
 
       @param size  The size of the code-access array to create
     */
     void createCodeAccessBase(uInt32 size);
 
+    /**
+      Get the ROM image to use for this cart, which is shared read-only
+      with all other carts created from the same image (e.g. when many
+      consoles run the same ROM), instead of every cart keeping a copy.
+      The image is truncated or padded to 'romSize' bytes.
+
+      @param image    The ROM image as loaded
+      @param size     The size of the loaded image
+      @param romSize  The size of the image used by the cart
+      @param fill     The value to pad the image with
+
+      @return  The shared image, valid for the lifetime of the cart; it
+               must not be changed (see privateImage())
+    */
+    uInt8* shareImage(const ByteBuffer& image, uInt32 size, uInt32 romSize,
+                       uInt8 fill = 0);
+
+    /**
+      Get a private, writable copy of the image returned by shareImage(),
+      which is made on the first call (e.g. when the debugger patches the
+      ROM).  Bank page tables and installed pages which map the shared
+      image are moved to the copy.
+
+      @return  The private image, valid for the lifetime of the cart
+    */
+    uInt8* privateImage();
+
+    /**
+      Create the page access tables of all banks, for the common layout
+      of hotspot bankswitching schemes: the pages from 'start' up to the
+      page containing the first hotspot map the ROM of the bank directly,
+      and the remaining pages go through peek and poke.  Switching banks
+      then only copies a ready-made table (see installBankPages()).
+
+      @param access   The access methods of the hotspot pages, which are
+                      also used as the basis for the directly mapped ones
+      @param image    The ROM image, with all 4K banks back to back
+      @param banks    The number of banks
+      @param start    The first address to map
+      @param hotspot  The address of the first hotspot
+    */
+    void createBankPages(const System::PageAccess& access, uInt8* image,
+                         uInt16 banks, uInt16 start, uInt16 hotspot);
+
+    /**
+      Install the page access table of the given bank, as created by
+      createBankPages().
+
+      @param bank  The bank to install
+    */
+    void installBankPages(uInt16 bank) {
+      mySystem->setPageAccess(myBankPagesStart,
+          &myBankPages[bank * myBankPagesCount], myBankPagesCount);
+    }
+
     /**
       Fill the given RAM array with (possibly random) data.
 
@@ -316,6 +401,16 @@ class Cartridge : public Device
     ByteBuffer myCodeAccessBase;
 
   private:
+    // The page access tables of all banks (see createBankPages())
+    unique_ptr<System::PageAccess[]> myBankPages;
+    uInt16 myBankPagesStart, myBankPagesCount, myBankPagesBanks;
+
+    // The ROM image (see shareImage()), and whether it's still shared
+    shared_ptr<uInt8> mySharedImage;
+    uInt32 myImageSize;
+    bool myImageShared;
+    string myMD5;
+
     // The startup bank to use (where to look for the reset vector address)
     uInt16 myStartBank;
 
@@ -24,8 +24,8 @@ Cartridge0840::Cartridge0840(const ByteBuffer& image, uInt32 size,
   : Cartridge(settings, md5),
     myBankOffset(0)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image.get(), std::min(8192u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, 8192);
   createCodeAccessBase(8192);
 }
 
@@ -159,6 +159,7 @@ uInt16 Cartridge0840::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge0840::patch(uInt16 address, uInt8 value)
 {
+  myImage = privateImage();
   myImage[myBankOffset + (address & 0x0fff)] = value;
   return myBankChanged = true;
 }
@@ -150,8 +150,8 @@ class Cartridge0840 : public Cartridge
     bool poke(uInt16 address, uInt8 value) override;
 
   private:
-    // The 8K ROM image of the cartridge
-    uInt8 myImage[8192];
+    // The 8K ROM image of the cartridge, shared with all carts running it
+    uInt8* myImage;
 
     // Indicates the offset into the ROM image (aligns to current bank)
     uInt16 myBankOffset;
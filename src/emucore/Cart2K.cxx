@@ -34,12 +34,9 @@ Cartridge2K::Cartridge2K(const ByteBuffer& image, uInt32 size,
   // We can't use a size smaller than the minimum page size in Stella
   mySize = std::max<uInt32>(mySize, System::PAGE_SIZE);
 
-  // Initialize ROM with illegal 6502 opcode that causes a real 6502 to jam
-  myImage = make_unique<uInt8[]>(mySize);
-  memset(myImage.get(), 0x02, mySize);
-
-  // Copy the ROM image into my buffer
-  memcpy(myImage.get(), image.get(), size);
+  // Get the (possibly shared) ROM image, padded with an illegal 6502
+  // opcode that causes a real 6502 to jam
+  myImage = shareImage(image, size, mySize, 0x02);
   createCodeAccessBase(mySize);
 
   // Set mask for accessing the image buffer
@@ -73,6 +70,7 @@ void Cartridge2K::install(System& system)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge2K::patch(uInt16 address, uInt8 value)
 {
+  myImage = privateImage();
   myImage[address & myMask] = value;
   return myBankChanged = true;
 }
@@ -81,7 +79,7 @@ bool Cartridge2K::patch(uInt16 address, uInt8 value)
 const uInt8* Cartridge2K::getImage(uInt32& size) const
 {
   size = mySize;
-  return myImage.get();
+  return myImage;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -126,8 +126,8 @@ class Cartridge2K : public Cartridge
     uInt8 peek(uInt16 address) override { return myImage[address & myMask]; }
 
   private:
-    // Pointer to a dynamically allocated ROM image of the cartridge
-    ByteBuffer myImage;
+    // The ROM image of the cartridge, shared with all carts running it
+    uInt8* myImage;
 
     // Size of the ROM image
     uInt32 mySize;
@@ -26,11 +26,8 @@ Cartridge3E::Cartridge3E(const ByteBuffer& image, uInt32 size,
     mySize(size),
     myCurrentBank(0)
 {
-  // Allocate array for the ROM image
-  myImage = make_unique<uInt8[]>(mySize);
-
-  // Copy the ROM image into my buffer
-  memcpy(myImage.get(), image.get(), mySize);
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, mySize);
   createCodeAccessBase(mySize + 32768);
 }
 
@@ -225,12 +222,18 @@ bool Cartridge3E::patch(uInt16 address, uInt8 value)
   if(address < 0x0800)
   {
     if(myCurrentBank < 256)
+    {
+      myImage = privateImage();
       myImage[(address & 0x07FF) + (myCurrentBank << 11)] = value;
+    }
     else
       myRAM[(address & 0x03FF) + ((myCurrentBank - 256) << 10)] = value;
   }
   else
+  {
+    myImage = privateImage();
     myImage[(address & 0x07FF) + mySize - 2048] = value;
+  }
 
   return myBankChanged = true;
 }
@@ -239,7 +242,7 @@ bool Cartridge3E::patch(uInt16 address, uInt8 value)
 const uInt8* Cartridge3E::getImage(uInt32& size) const
 {
   size = mySize;
-  return myImage.get();
+  return myImage;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -179,8 +179,8 @@ class Cartridge3E : public Cartridge
     bool poke(uInt16 address, uInt8 value) override;
 
   private:
-    // Pointer to a dynamically allocated ROM image of the cartridge
-    ByteBuffer myImage;
+    // The ROM image of the cartridge, shared with all carts running it
+    uInt8* myImage;
 
     // RAM contents. For now every ROM gets all 32K of potential RAM
     uInt8 myRAM[32 * 1024];
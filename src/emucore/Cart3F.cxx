@@ -26,11 +26,8 @@ Cartridge3F::Cartridge3F(const ByteBuffer& image, uInt32 size,
     mySize(size),
     myCurrentBank(0)
 {
-  // Allocate array for the ROM image
-  myImage = make_unique<uInt8[]>(mySize);
-
-  // Copy the ROM image into my buffer
-  memcpy(myImage.get(), image.get(), mySize);
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, mySize);
   createCodeAccessBase(mySize);
 }
 
@@ -143,6 +140,7 @@ uInt16 Cartridge3F::bankCount() const
 bool Cartridge3F::patch(uInt16 address, uInt8 value)
 {
   address &= 0x0FFF;
+  myImage = privateImage();
 
   if(address < 0x0800)
     myImage[(address & 0x07FF) + (myCurrentBank << 11)] = value;
@@ -156,7 +154,7 @@ bool Cartridge3F::patch(uInt16 address, uInt8 value)
 const uInt8* Cartridge3F::getImage(uInt32& size) const
 {
   size = mySize;
-  return myImage.get();
+  return myImage;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
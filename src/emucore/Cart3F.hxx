@@ -156,8 +156,8 @@ class Cartridge3F : public Cartridge
     bool poke(uInt16 address, uInt8 value) override;
 
   private:
-    // Pointer to a dynamically allocated ROM image of the cartridge
-    ByteBuffer myImage;
+    // The ROM image of the cartridge, shared with all carts running it
+    uInt8* myImage;
 
     // Size of the ROM image
     uInt32 mySize;
@@ -36,11 +36,17 @@ Cartridge4A50::Cartridge4A50(const ByteBuffer& image, uInt32 size,
 {
   // Copy the ROM image into my buffer
   // Supported file sizes are 32/64/128K, which are duplicated if necessary
+  // (smaller images are padded with zeroes)
+  const uInt32 romSize = std::min(size, 131072u);
   if(size < 65536)        size = 32768;
   else if(size < 131072)  size = 65536;
   else                    size = 131072;
   for(uInt32 slice = 0; slice < 131072 / size; ++slice)
-    memcpy(myImage + (slice*size), image.get(), size);
+  {
+    memcpy(myImage + (slice*size), image.get(), std::min(romSize, size));
+    if(romSize < size)
+      memset(myImage + (slice*size) + romSize, 0, size - romSize);
+  }
 
   // We use System::PageAccess.codeAccessBase, but don't allow its use
   // through a pointer, since the address space of 4A50 carts can change
@@ -23,8 +23,8 @@ Cartridge4K::Cartridge4K(const ByteBuffer& image, uInt32 size,
                          const string& md5, const Settings& settings)
   : Cartridge(settings, md5)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image.get(), std::min(4096u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, 4096);
   createCodeAccessBase(4096);
 }
 
@@ -54,6 +54,7 @@ void Cartridge4K::install(System& system)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge4K::patch(uInt16 address, uInt8 value)
 {
+  myImage = privateImage();
   myImage[address & 0x0FFF] = value;
   return myBankChanged = true;
 }
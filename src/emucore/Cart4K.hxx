@@ -123,8 +123,8 @@ class Cartridge4K : public Cartridge
     uInt8 peek(uInt16 address) override { return myImage[address & 0x0FFF]; }
 
   private:
-    // The 4K ROM image for the cartridge
-    uInt8 myImage[4096];
+    // The 4K ROM image of the cartridge, shared with all carts running it
+    uInt8* myImage;
 
   private:
     // Following constructors and assignment operators not supported
@@ -79,6 +79,14 @@ class Cartridge4KSC : public Cartridge
     */
     const uInt8* getImage(uInt32& size) const override;
 
+    /**
+      Access the internal RAM of this cartridge.
+
+      @param size  Set to the size of the internal RAM
+      @return  A pointer to the internal RAM
+    */
+    uInt8* getRAM(uInt32& size) override { size = sizeof(myRAM);  return myRAM; }
+
     /**
       Save the current state of this cart to the given Serializer.
 
@@ -306,20 +306,34 @@ void CartridgeAR::initializeROM()
   // contents placed in the ourDummyROMCode array), the offsets will
   // almost definitely change
 
+  // Initialize ROM with illegal 6502 opcode that causes a real 6502 to jam
+  memset(myImage + (3<<11), 0x02, 2048);
+
+  // Copy the "dummy" Supercharger BIOS code into the ROM area; the copy is
+  // patched below, since the original is shared by all instances
+  memcpy(myImage + (3<<11), ourDummyROMCode, sizeof(ourDummyROMCode));
+
   // The scrom.asm code checks a value at offset 109 as follows:
   //   0xFF -> do a complete jump over the SC BIOS progress bars code
   //   0x00 -> show SC BIOS progress bars as normal
-  ourDummyROMCode[109] = mySettings.getBool("fastscbios") ? 0xFF : 0x00;
+  bool fastBIOS = mySettings.getBool("fastscbios");
+  myImage[(3<<11) + 109] = fastBIOS ? 0xFF : 0x00;
+
+  // When loading another part of a multiload game, the scrom.asm code
+  // first clears the last page of RAM bank 0 through the write port, one
+  // byte at a time.  The fast BIOS jumps over this to read the load right
+  // away (JMP $F850 at offset 32), and the page is cleared directly when
+  // the load is read instead (see loadIntoRAM()).
+  if(fastBIOS)
+  {
+    myImage[(3<<11) + 32] = 0x4C;
+    myImage[(3<<11) + 33] = 0x50;
+    myImage[(3<<11) + 34] = 0xF8;
+  }
 
   // The accumulator should contain a random value after exiting the
   // SC BIOS code - a value placed in offset 281 will be stored in A
-  ourDummyROMCode[281] = mySystem->randGenerator().next();
-
-  // Initialize ROM with illegal 6502 opcode that causes a real 6502 to jam
-  memset(myImage + (3<<11), 0x02, 2048);
-
-  // Copy the "dummy" Supercharger BIOS code into the ROM area
-  memcpy(myImage + (3<<11), ourDummyROMCode, sizeof(ourDummyROMCode));
+  myImage[(3<<11) + 281] = mySystem->randGenerator().next();
 
   // Finally set 6502 vectors to point to initial load code at 0xF80A of BIOS
   myImage[(3<<11) + 2044] = 0x0A;
@@ -344,6 +358,10 @@ void CartridgeAR::loadIntoRAM(uInt8 load)
 {
   uInt16 image;
 
+  // Clear the page skipped by the fast BIOS (see initializeROM())
+  if(myImage[(3<<11) + 32] == 0x4C && myWriteEnabled)
+    memset(myImage + myImageOffset[0] + 0x0700, 0, 256);
+
   // Scan through all of the loads to see if we find the one we're looking for
   for(image = 0; image < myNumberOfLoadImages; ++image)
   {
@@ -523,7 +541,7 @@ bool CartridgeAR::load(Serializer& in)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8 CartridgeAR::ourDummyROMCode[] = {
+const uInt8 CartridgeAR::ourDummyROMCode[] = {
   0xa5, 0xfa, 0x85, 0x80, 0x4c, 0x18, 0xf8, 0xff,
   0xff, 0xff, 0x78, 0xd8, 0xa0, 0x00, 0xa2, 0x00,
   0x94, 0x00, 0xe8, 0xd0, 0xfb, 0x4c, 0x50, 0xf8,
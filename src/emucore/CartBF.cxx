@@ -24,8 +24,8 @@ CartridgeBF::CartridgeBF(const ByteBuffer& image, uInt32 size,
   : Cartridge(settings, md5),
     myBankOffset(0)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image.get(), std::min(262144u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, 262144);
   createCodeAccessBase(262144);
 }
 
@@ -119,6 +119,7 @@ uInt16 CartridgeBF::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeBF::patch(uInt16 address, uInt8 value)
 {
+  myImage = privateImage();
   myImage[myBankOffset + (address & 0x0FFF)] = value;
   return myBankChanged = true;
 }
@@ -24,8 +24,8 @@ CartridgeBFSC::CartridgeBFSC(const ByteBuffer& image, uInt32 size,
   : Cartridge(settings, md5),
     myBankOffset(0)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image.get(), std::min(262144u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, 262144);
   createCodeAccessBase(262144);
 }
 
@@ -167,7 +167,10 @@ bool CartridgeBFSC::patch(uInt16 address, uInt8 value)
     myRAM[address & 0x007F] = value;
   }
   else
+  {
+    myImage = privateImage();
     myImage[myBankOffset + address] = value;
+  }
 
   return myBankChanged = true;
 }
@@ -70,6 +70,7 @@ CartridgeBUS::CartridgeBUS(const ByteBuffer& image, uInt32 size,
     reinterpret_cast<uInt16*>(myImage), reinterpret_cast<uInt16*>(myBUSRAM), 32768,
     devSettings ? settings.getBool("dev.thumb.trapfatal") : false, Thumbulator::ConfigureFor::BUS, this
   );
+  myThumbEmulator->setAsync(settings.getBool("thumb.async"));
 
   setInitialState();
 }
@@ -77,6 +78,7 @@ CartridgeBUS::CartridgeBUS(const ByteBuffer& image, uInt32 size,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeBUS::reset()
 {
+  waitForARM();
   initializeRAM(myBUSRAM+2048, 8192-2048);
 
   // BUS always starts in bank 6
@@ -109,14 +111,33 @@ void CartridgeBUS::setInitialState()
     mySTYZeroPageAddress = myJMPoperandAddress = 0;
 
   myFastJumpActive = 0;
+
+  myCachedStreams = myDirtyStreams = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeBUS::consoleChanged(ConsoleTiming timing)
 {
+  waitForARM();
   myThumbEmulator->setConsoleTiming(timing);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeBUS::setThumbProfiler(ThumbProfiler* profiler)
+{
+  waitForARM();
+  myThumbEmulator->setProfiler(profiler);
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeBUS::setThumbFastMode(bool enable)
+{
+  waitForARM();
+  myThumbEmulator->setFastMode(enable);
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeBUS::install(System& system)
 {
@@ -124,6 +145,7 @@ void CartridgeBUS::install(System& system)
 
   // Map all of the accesses to call peek and poke
   System::PageAccess access(this, System::PageAccessType::READ);
+  access.useDirectDispatch<CartridgeBUS>();
   for(uInt16 addr = 0x1000; addr < 0x1040; addr += System::PAGE_SIZE)
     mySystem->setPageAccess(addr, access);
 
@@ -167,7 +189,11 @@ inline void CartridgeBUS::callFunction(uInt8 value)
         Int32 cycles = Int32(mySystem->cycles() - myARMCycles);
         myARMCycles = mySystem->cycles();
 
-        myThumbEmulator->run(cycles);
+        // The ARM code works on the datastreams in BUS RAM directly
+        invalidateDatastreams();
+
+        System::ZoneGuard zone(*mySystem, System::Zone::arm);
+        myThumbEmulator->start(cycles);
       }
       catch(const runtime_error& e) {
         if(!mySystem->autodetectMode())
@@ -179,6 +205,20 @@ inline void CartridgeBUS::callFunction(uInt8 value)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeBUS::waitForARM()
+{
+  try {
+    myThumbEmulator->sync();
+  }
+  catch(const runtime_error& e) {
+    if(!mySystem->autodetectMode())
+    {
+      FatalEmulationError::raise(e.what());
+    }
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 CartridgeBUS::peek(uInt16 address)
 {
@@ -209,6 +249,7 @@ uInt8 CartridgeBUS::peek(uInt16 address)
       uInt32 pointer;
       uInt8 value;
 
+      waitForARM();
       --myFastJumpActive;
       ++myJMPoperandAddress;
 
@@ -242,6 +283,8 @@ uInt8 CartridgeBUS::peek(uInt16 address)
     switch(address)
     {
       case 0xFEE: // AMPLITUDE
+        waitForARM();
+
         // Update the music data fetchers (counter & flag)
         updateMusicModeDataFetchers();
 
@@ -276,6 +319,7 @@ uInt8 CartridgeBUS::peek(uInt16 address)
         break;
 
       case 0xFEF: // DSREAD
+        waitForARM();
         peekvalue = readFromDatastream(COMMSTREAM);
         break;
 
@@ -354,6 +398,7 @@ bool CartridgeBUS::poke(uInt16 address, uInt8 value)
     uInt32 pointer;
 
     address &= 0x0FFF;
+    waitForARM();
 
     switch(address)
     {
@@ -438,6 +483,7 @@ bool CartridgeBUS::bank(uInt16 bank)
 
   // Setup the page access methods for the current bank
   System::PageAccess access(this, System::PageAccessType::READ);
+  access.useDirectDispatch<CartridgeBUS>();
 
   // Map Program ROM image into the system
   for(uInt16 addr = 0x1040; addr < 0x2000; addr += System::PAGE_SIZE)
@@ -493,6 +539,8 @@ uInt8 CartridgeBUS::busOverdrive(uInt16 address)
     uInt8 map = address & 0x7f;
     if (map <= 0x24) // map TIA registers VSYNC thru HMBL inclusive
     {
+      waitForARM();
+
       uInt32 alldatastreams = getAddressMap(map);
       uInt8 datastream = alldatastreams & 0x0f;  // lowest nybble has the current datastream to use
       overdrive = readFromDatastream(datastream);
@@ -543,11 +591,21 @@ bool CartridgeBUS::save(Serializer& out) const
 {
   try
   {
+    myThumbEmulator->sync();
+
     // Indicates which bank is currently active
     out.putShort(myBankOffset);
 
-    // Harmony RAM
-    out.putByteArray(myBUSRAM, 8192);
+    // Harmony RAM, including datastream pointers not yet written back
+    if(myDirtyStreams)
+    {
+      uInt8 ram[8192];
+      memcpy(ram, myBUSRAM, 8192);
+      storeDatastreams(ram);
+      out.putByteArray(ram, 8192);
+    }
+    else
+      out.putByteArray(myBUSRAM, 8192);
 
     // Addresses for bus override logic
     out.putShort(myBusOverdriveAddress);
@@ -582,6 +640,8 @@ bool CartridgeBUS::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeBUS::load(Serializer& in)
 {
+  waitForARM();
+
   try
   {
     // Indicates which bank is currently active
@@ -589,6 +649,7 @@ bool CartridgeBUS::load(Serializer& in)
 
     // Harmony RAM
     in.getByteArray(myBUSRAM, 8192);
+    myCachedStreams = myDirtyStreams = 0;
 
     // Addresses for bus override logic
     myBusOverdriveAddress = in.getShort();
@@ -626,32 +687,81 @@ bool CartridgeBUS::load(Serializer& in)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeBUS::getDatastreamPointer(uInt8 index) const
 {
-//  index &= 0x0f;
+  if(myCachedStreams & (uInt64(1) << index))
+    return myStreamPointers[index];
 
-  return myBUSRAM[DSxPTR + index*4 + 0]        +  // low byte
-        (myBUSRAM[DSxPTR + index*4 + 1] << 8)  +
-        (myBUSRAM[DSxPTR + index*4 + 2] << 16) +
-        (myBUSRAM[DSxPTR + index*4 + 3] << 24) ;  // high byte
+  return readRAMWord(DSxPTR + index * 4);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeBUS::setDatastreamPointer(uInt8 index, uInt32 value)
 {
-//  index &= 0x0f;
-  myBUSRAM[DSxPTR + index*4 + 0] = value & 0xff;          // low byte
-  myBUSRAM[DSxPTR + index*4 + 1] = (value >> 8) & 0xff;
-  myBUSRAM[DSxPTR + index*4 + 2] = (value >> 16) & 0xff;
-  myBUSRAM[DSxPTR + index*4 + 3] = (value >> 24) & 0xff;  // high byte
+  if(myCachedStreams & (uInt64(1) << index))
+  {
+    myStreamPointers[index] = value;
+    myDirtyStreams |= uInt64(1) << index;
+  }
+  else
+    writeRAMWord(myBUSRAM, DSxPTR + index * 4, value);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeBUS::getDatastreamIncrement(uInt8 index) const
 {
-//  index &= 0x0f;
-  return myBUSRAM[DSxINC + index*4 + 0]        +   // low byte
-        (myBUSRAM[DSxINC + index*4 + 1] << 8)  +
-        (myBUSRAM[DSxINC + index*4 + 2] << 16) +
-        (myBUSRAM[DSxINC + index*4 + 3] << 24) ;   // high byte
+  if(myCachedStreams & (uInt64(1) << index))
+    return myStreamIncrements[index];
+
+  return readRAMWord(DSxINC + index * 4);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uInt32 CartridgeBUS::readRAMWord(uInt16 address) const
+{
+  return myBUSRAM[address + 0]        +  // low byte
+        (myBUSRAM[address + 1] << 8)  +
+        (myBUSRAM[address + 2] << 16) +
+        (myBUSRAM[address + 3] << 24) ;  // high byte
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void CartridgeBUS::writeRAMWord(uInt8* ram, uInt16 address, uInt32 value)
+{
+  ram[address + 0] = value & 0xff;          // low byte
+  ram[address + 1] = (value >> 8) & 0xff;
+  ram[address + 2] = (value >> 16) & 0xff;
+  ram[address + 3] = (value >> 24) & 0xff;  // high byte
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeBUS::cacheDatastream(uInt8 index)
+{
+  myStreamPointers[index] = readRAMWord(DSxPTR + index * 4);
+  myStreamIncrements[index] = readRAMWord(DSxINC + index * 4);
+  myCachedStreams |= uInt64(1) << index;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeBUS::storeDatastreams(uInt8* ram) const
+{
+  uInt64 dirty = myDirtyStreams;
+  for(uInt8 index = 0; dirty; ++index, dirty >>= 1)
+    if(dirty & 1)
+      writeRAMWord(ram, DSxPTR + index * 4, myStreamPointers[index]);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeBUS::flushDatastreams()
+{
+  waitForARM();
+  storeDatastreams(myBUSRAM);
+  myDirtyStreams = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeBUS::invalidateDatastreams()
+{
+  flushDatastreams();
+  myCachedStreams = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -736,10 +846,13 @@ uInt8 CartridgeBUS::readFromDatastream(uInt8 index)
   // I = Increment
   // F = Fractional
 
-  uInt32 pointer = getDatastreamPointer(index);
-  uInt16 increment = getDatastreamIncrement(index);
+  const uInt64 stream = uInt64(1) << index;
+  if(!(myCachedStreams & stream))
+    cacheDatastream(index);
+
+  uInt32& pointer = myStreamPointers[index];
   uInt8 value = myDisplayImage[ pointer >> 20 ];
-  pointer += (increment << 12);
-  setDatastreamPointer(index, pointer);
+  pointer += (uInt16(myStreamIncrements[index]) << 12);
+  myDirtyStreams |= stream;
   return value;
 }
@@ -73,6 +73,18 @@ class CartridgeBUS : public Cartridge
     */
     void consoleChanged(ConsoleTiming timing) override;
 
+    /**
+      Count the cycles of the ARM code in the given profiler.
+
+      @param profiler  The profiler, or the null pointer to stop profiling
+    */
+    bool setThumbProfiler(ThumbProfiler* profiler) override;
+
+    /**
+      Run the ARM code in the fast mode of the Thumbulator (or not).
+    */
+    bool setThumbFastMode(bool enable) override;
+
     /**
       Install cartridge in the specified system.  Invoked by the system
       when the cartridge is attached to it.
@@ -115,6 +127,14 @@ class CartridgeBUS : public Cartridge
     */
     const uInt8* getImage(uInt32& size) const override;
 
+    /**
+      Access the internal RAM of this cartridge.
+
+      @param size  Set to the size of the internal RAM
+      @return  A pointer to the internal RAM
+    */
+    uInt8* getRAM(uInt32& size) override { size = sizeof(myBUSRAM);  return myBUSRAM; }
+
     /**
       Save the current state of this cart to the given Serializer.
 
@@ -192,6 +212,12 @@ class CartridgeBUS : public Cartridge
     */
     void callFunction(uInt8 value);
 
+    /**
+      Wait for ARM code running on the ARM thread to finish; this must be
+      done before accessing anything the ARM code can change.
+    */
+    void waitForARM();
+
     uInt32 getDatastreamPointer(uInt8 index) const;
     void setDatastreamPointer(uInt8 index, uInt32 value);
 
@@ -203,6 +229,20 @@ class CartridgeBUS : public Cartridge
 
     uInt8 readFromDatastream(uInt8 index);
 
+    uInt32 readRAMWord(uInt16 address) const;
+    static void writeRAMWord(uInt8* ram, uInt16 address, uInt32 value);
+
+    /**
+      Datastream pointers and increments are cached outside of BUS RAM
+      while the 6507 fetches from them.  The pointers are written back
+      (flushed) before anything else looks at BUS RAM, and the cache is
+      dropped (invalidated) whenever something else may change it.
+    */
+    void cacheDatastream(uInt8 index);
+    void storeDatastreams(uInt8* ram) const;
+    void flushDatastreams();
+    void invalidateDatastreams();
+
     uInt32 getWaveform(uInt8 index) const;
     uInt32 getWaveformSize(uInt8 index) const;
     uInt32 getSample();
@@ -269,6 +309,15 @@ class CartridgeBUS : public Cartridge
 
     uInt8 myFastJumpActive;
 
+    // Cached datastream pointers and increments, indexed by stream
+    uInt32 myStreamPointers[64];
+    uInt32 myStreamIncrements[64];
+
+    // Streams present in the cache, and those whose cached pointer has
+    // not yet been written back to BUS RAM (one bit per stream)
+    uInt64 myCachedStreams;
+    uInt64 myDirtyStreams;
+
   private:
     // Following constructors and assignment operators not supported
     CartridgeBUS() = delete;
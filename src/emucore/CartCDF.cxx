@@ -87,6 +87,7 @@ CartridgeCDF::CartridgeCDF(const ByteBuffer& image, uInt32 size,
   myThumbEmulator = make_unique<Thumbulator>(
     reinterpret_cast<uInt16*>(myImage), reinterpret_cast<uInt16*>(myCDFRAM), 32768,
     devSettings ? settings.getBool("dev.thumb.trapfatal") : false, thumulatorConfiguration(myCDFSubtype), this);
+  myThumbEmulator->setAsync(settings.getBool("thumb.async"));
 
   setInitialState();
 }
@@ -94,6 +95,7 @@ CartridgeCDF::CartridgeCDF(const ByteBuffer& image, uInt32 size,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeCDF::reset()
 {
+  waitForARM();
   initializeRAM(myCDFRAM+2048, 8192-2048);
 
   // CDF always starts in bank 6
@@ -123,14 +125,33 @@ void CartridgeCDF::setInitialState()
 
   myBankOffset = myLDAimmediateOperandAddress = myJMPoperandAddress = 0;
   myFastJumpActive = 0;
+
+  myCachedStreams = myDirtyStreams = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeCDF::consoleChanged(ConsoleTiming timing)
 {
+  waitForARM();
   myThumbEmulator->setConsoleTiming(timing);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeCDF::setThumbProfiler(ThumbProfiler* profiler)
+{
+  waitForARM();
+  myThumbEmulator->setProfiler(profiler);
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeCDF::setThumbFastMode(bool enable)
+{
+  waitForARM();
+  myThumbEmulator->setFastMode(enable);
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeCDF::install(System& system)
 {
@@ -138,6 +159,7 @@ void CartridgeCDF::install(System& system)
 
   // Map all of the accesses to call peek and poke
   System::PageAccess access(this, System::PageAccessType::READ);
+  access.useDirectDispatch<CartridgeCDF>();
   for(uInt16 addr = 0x1000; addr < 0x1040; addr += System::PAGE_SIZE)
     mySystem->setPageAccess(addr, access);
 
@@ -176,7 +198,11 @@ inline void CartridgeCDF::callFunction(uInt8 value)
         Int32 cycles = Int32(mySystem->cycles() - myARMCycles);
         myARMCycles = mySystem->cycles();
 
-        myThumbEmulator->run(cycles);
+        // The ARM code works on the datastreams in CDF RAM directly
+        invalidateDatastreams();
+
+        System::ZoneGuard zone(*mySystem, System::Zone::arm);
+        myThumbEmulator->start(cycles);
       }
       catch(const runtime_error& e) {
         if(!mySystem->autodetectMode())
@@ -188,6 +214,20 @@ inline void CartridgeCDF::callFunction(uInt8 value)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeCDF::waitForARM()
+{
+  try {
+    myThumbEmulator->sync();
+  }
+  catch(const runtime_error& e) {
+    if(!mySystem->autodetectMode())
+    {
+      FatalEmulationError::raise(e.what());
+    }
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 CartridgeCDF::peek(uInt16 address)
 {
@@ -207,6 +247,7 @@ uInt8 CartridgeCDF::peek(uInt16 address)
     uInt32 pointer;
     uInt8 value;
 
+    waitForARM();
     --myFastJumpActive;
     ++myJMPoperandAddress;
 
@@ -240,6 +281,7 @@ uInt8 CartridgeCDF::peek(uInt16 address)
      && myLDAimmediateOperandAddress == address
      && peekvalue <= myAmplitudeStream)
   {
+    waitForARM();
     myLDAimmediateOperandAddress = 0;
     if (peekvalue == myAmplitudeStream)
     {
@@ -332,6 +374,7 @@ bool CartridgeCDF::poke(uInt16 address, uInt8 value)
   uInt32 pointer;
 
   address &= 0x0FFF;
+  waitForARM();
 
   switch(address)
   {
@@ -410,6 +453,7 @@ bool CartridgeCDF::bank(uInt16 bank)
 
   // Setup the page access methods for the current bank
   System::PageAccess access(this, System::PageAccessType::READ);
+  access.useDirectDispatch<CartridgeCDF>();
 
   // Map Program ROM image into the system
   for(uInt16 addr = 0x1040; addr < 0x2000; addr += System::PAGE_SIZE)
@@ -490,6 +534,8 @@ bool CartridgeCDF::save(Serializer& out) const
 {
   try
   {
+    myThumbEmulator->sync();
+
     // Indicates which bank is currently active
     out.putShort(myBankOffset);
 
@@ -503,8 +549,16 @@ bool CartridgeCDF::save(Serializer& out) const
     out.putShort(myLDAimmediateOperandAddress);
     out.putShort(myJMPoperandAddress);
 
-    // Harmony RAM
-    out.putByteArray(myCDFRAM, 8192);
+    // Harmony RAM, including datastream pointers not yet written back
+    if(myDirtyStreams)
+    {
+      uInt8 ram[8192];
+      memcpy(ram, myCDFRAM, 8192);
+      storeDatastreams(ram);
+      out.putByteArray(ram, 8192);
+    }
+    else
+      out.putByteArray(myCDFRAM, 8192);
 
     // Audio info
     out.putIntArray(myMusicCounters, 3);
@@ -528,6 +582,8 @@ bool CartridgeCDF::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeCDF::load(Serializer& in)
 {
+  waitForARM();
+
   try
   {
     // Indicates which bank is currently active
@@ -545,6 +601,7 @@ bool CartridgeCDF::load(Serializer& in)
 
     // Harmony RAM
     in.getByteArray(myCDFRAM, 8192);
+    myCachedStreams = myDirtyStreams = 0;
 
     // Audio info
     in.getIntArray(myMusicCounters, 3);
@@ -571,53 +628,81 @@ bool CartridgeCDF::load(Serializer& in)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeCDF::getDatastreamPointer(uInt8 index) const
 {
-  uInt16 address = myDatastreamBase + index * 4;
+  if(myCachedStreams & (uInt64(1) << index))
+    return myStreamPointers[index];
 
-  return myCDFRAM[address + 0]        +  // low byte
-        (myCDFRAM[address + 1] << 8)  +
-        (myCDFRAM[address + 2] << 16) +
-        (myCDFRAM[address + 3] << 24) ;  // high byte
+  return readRAMWord(myDatastreamBase + index * 4);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeCDF::setDatastreamPointer(uInt8 index, uInt32 value)
 {
-  uInt16 address = myDatastreamBase + index * 4;
-
-  myCDFRAM[address + 0] = value & 0xff;          // low byte
-  myCDFRAM[address + 1] = (value >> 8) & 0xff;
-  myCDFRAM[address + 2] = (value >> 16) & 0xff;
-  myCDFRAM[address + 3] = (value >> 24) & 0xff;  // high byte
+  if(myCachedStreams & (uInt64(1) << index))
+  {
+    myStreamPointers[index] = value;
+    myDirtyStreams |= uInt64(1) << index;
+  }
+  else
+    writeRAMWord(myCDFRAM, myDatastreamBase + index * 4, value);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeCDF::getDatastreamIncrement(uInt8 index) const
 {
-  uInt16 address = myDatastreamIncrementBase + index * 4;
+  if(myCachedStreams & (uInt64(1) << index))
+    return myStreamIncrements[index];
 
-  return myCDFRAM[address + 0]        +   // low byte
+  return readRAMWord(myDatastreamIncrementBase + index * 4);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uInt32 CartridgeCDF::readRAMWord(uInt16 address) const
+{
+  return myCDFRAM[address + 0]        +  // low byte
         (myCDFRAM[address + 1] << 8)  +
         (myCDFRAM[address + 2] << 16) +
-        (myCDFRAM[address + 3] << 24) ;   // high byte
+        (myCDFRAM[address + 3] << 24) ;  // high byte
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 CartridgeCDF::getWaveform(uInt8 index) const
+inline void CartridgeCDF::writeRAMWord(uInt8* ram, uInt16 address, uInt32 value)
 {
-  uInt32 result;
-  uInt16 address = myWaveformBase + index * 4;
+  ram[address + 0] = value & 0xff;          // low byte
+  ram[address + 1] = (value >> 8) & 0xff;
+  ram[address + 2] = (value >> 16) & 0xff;
+  ram[address + 3] = (value >> 24) & 0xff;  // high byte
+}
 
-  result = myCDFRAM[address + 0]        +  // low byte
-          (myCDFRAM[address + 1] << 8)  +
-          (myCDFRAM[address + 2] << 16) +
-          (myCDFRAM[address + 3] << 24);   // high byte
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeCDF::cacheDatastream(uInt8 index)
+{
+  myStreamPointers[index] = readRAMWord(myDatastreamBase + index * 4);
+  myStreamIncrements[index] = readRAMWord(myDatastreamIncrementBase + index * 4);
+  myCachedStreams |= uInt64(1) << index;
+}
 
-  result -= (0x40000000 + DSRAM);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeCDF::storeDatastreams(uInt8* ram) const
+{
+  uInt64 dirty = myDirtyStreams;
+  for(uInt8 index = 0; dirty; ++index, dirty >>= 1)
+    if(dirty & 1)
+      writeRAMWord(ram, myDatastreamBase + index * 4, myStreamPointers[index]);
+}
 
-  if (result >= 4096)
-    result &= 4095;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeCDF::flushDatastreams()
+{
+  waitForARM();
+  storeDatastreams(myCDFRAM);
+  myDirtyStreams = 0;
+}
 
-  return result;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeCDF::invalidateDatastreams()
+{
+  flushDatastreams();
+  myCachedStreams = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -634,6 +719,19 @@ uInt32 CartridgeCDF::getSample()
   return result;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 CartridgeCDF::getWaveform(uInt8 index) const
+{
+  uInt32 result = readRAMWord(myWaveformBase + index * 4);
+
+  result -= (0x40000000 + DSRAM);
+
+  if (result >= 4096)
+    result &= 4095;
+
+  return result;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 CartridgeCDF::getWaveformSize(uInt8 index) const
 {
@@ -653,11 +751,14 @@ uInt8 CartridgeCDF::readFromDatastream(uInt8 index)
   // I = Increment
   // F = Fractional
 
-  uInt32 pointer = getDatastreamPointer(index);
-  uInt16 increment = getDatastreamIncrement(index);
+  const uInt64 stream = uInt64(1) << index;
+  if(!(myCachedStreams & stream))
+    cacheDatastream(index);
+
+  uInt32& pointer = myStreamPointers[index];
   uInt8 value = myDisplayImage[ pointer >> 20 ];
-  pointer += (increment << 12);
-  setDatastreamPointer(index, pointer);
+  pointer += (uInt16(myStreamIncrements[index]) << 12);
+  myDirtyStreams |= stream;
   return value;
 }
 
@@ -24,8 +24,8 @@ CartridgeDF::CartridgeDF(const ByteBuffer& image, uInt32 size,
   : Cartridge(settings, md5),
     myBankOffset(0)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image.get(), std::min(131072u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, 131072);
   createCodeAccessBase(131072);
 }
 
@@ -43,6 +43,10 @@ void CartridgeDF::install(System& system)
 {
   mySystem = &system;
 
+  // Create the page access methods of all banks
+  createBankPages(System::PageAccess(this, System::PageAccessType::READ),
+                  myImage, bankCount(), 0x1000, 0x1FC0);
+
   // Install pages for the startup bank
   bank(startBank());
 }
@@ -79,24 +83,9 @@ bool CartridgeDF::bank(uInt16 bank)
   // Remember what bank we're in
   myBankOffset = bank << 12;
 
-  System::PageAccess access(this, System::PageAccessType::READ);
-
-  // Set the page accessing methods for the hot spots
-  for(uInt16 addr = (0x1FC0 & ~System::PAGE_MASK); addr < 0x2000;
-      addr += System::PAGE_SIZE)
-  {
-    access.codeAccessBase = &myCodeAccessBase[myBankOffset + (addr & 0x0FFF)];
-    mySystem->setPageAccess(addr, access);
-  }
-
   // Setup the page access methods for the current bank
-  for(uInt16 addr = 0x1000; addr < (0x1FC0U & ~System::PAGE_MASK);
-      addr += System::PAGE_SIZE)
-  {
-    access.directPeekBase = &myImage[myBankOffset + (addr & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[myBankOffset + (addr & 0x0FFF)];
-    mySystem->setPageAccess(addr, access);
-  }
+  installBankPages(bank);
+
   return myBankChanged = true;
 }
 
@@ -115,6 +104,7 @@ uInt16 CartridgeDF::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeDF::patch(uInt16 address, uInt8 value)
 {
+  myImage = privateImage();
   myImage[myBankOffset + (address & 0x0FFF)] = value;
   return myBankChanged = true;
 }
@@ -24,8 +24,8 @@ CartridgeDFSC::CartridgeDFSC(const ByteBuffer& image, uInt32 size,
   : Cartridge(settings, md5),
     myBankOffset(0)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image.get(), std::min(131072u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, 131072);
   createCodeAccessBase(131072);
 }
 
@@ -44,6 +44,10 @@ void CartridgeDFSC::install(System& system)
 {
   mySystem = &system;
 
+  // Create the page access methods of all banks
+  createBankPages(System::PageAccess(this, System::PageAccessType::READ),
+                  myImage, bankCount(), 0x1100, 0x1FC0);
+
   System::PageAccess access(this, System::PageAccessType::READ);
 
   // Set the page accessing method for the RAM writing pages
@@ -110,24 +114,9 @@ bool CartridgeDFSC::bank(uInt16 bank)
   // Remember what bank we're in
   myBankOffset = bank << 12;
 
-  System::PageAccess access(this, System::PageAccessType::READ);
-
-  // Set the page accessing methods for the hot spots
-  for(uInt16 addr = (0x1FC0 & ~System::PAGE_MASK); addr < 0x2000;
-      addr += System::PAGE_SIZE)
-  {
-    access.codeAccessBase = &myCodeAccessBase[myBankOffset + (addr & 0x0FFF)];
-    mySystem->setPageAccess(addr, access);
-  }
-
   // Setup the page access methods for the current bank
-  for(uInt16 addr = 0x1100; addr < (0x1FC0U & ~System::PAGE_MASK);
-      addr += System::PAGE_SIZE)
-  {
-    access.directPeekBase = &myImage[myBankOffset + (addr & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[myBankOffset + (addr & 0x0FFF)];
-    mySystem->setPageAccess(addr, access);
-  }
+  installBankPages(bank);
+
   return myBankChanged = true;
 }
 
@@ -156,7 +145,10 @@ bool CartridgeDFSC::patch(uInt16 address, uInt8 value)
     myRAM[address & 0x007F] = value;
   }
   else
+  {
+    myImage = privateImage();
     myImage[myBankOffset + address] = value;
+  }
 
   return myBankChanged = true;
 }
@@ -19,13 +19,15 @@
 #include "AudioSettings.hxx"
 #include "CartDPC.hxx"
 
+constexpr uInt64 CartridgeDPC::CLOCK_DIVISOR;
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 CartridgeDPC::CartridgeDPC(const ByteBuffer& image, uInt32 size,
                            const string& md5, const Settings& settings)
   : Cartridge(settings, md5),
     mySize(size),
     myAudioCycles(0),
-    myFractionalClocks(0.0),
+    myFractionalClocks(0),
     myBankOffset(0)
 {
   // Make a copy of the entire image
@@ -56,13 +58,13 @@ CartridgeDPC::CartridgeDPC(const ByteBuffer& image, uInt32 size,
 void CartridgeDPC::reset()
 {
   myAudioCycles = 0;
-  myFractionalClocks = 0.0;
+  myFractionalClocks = 0;
 
   // Upon reset we switch to the startup bank
   initializeStartBank(1);
   bank(startBank());
 
-  myDpcPitch = mySettings.getInt(AudioSettings::SETTING_DPC_PITCH);
+  myDpcPitch = uInt32(mySettings.getInt(AudioSettings::SETTING_DPC_PITCH));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -101,15 +103,19 @@ inline void CartridgeDPC::clockRandomNumberGenerator()
 inline void CartridgeDPC::updateMusicModeDataFetchers()
 {
   // Calculate the number of cycles since the last update
-  uInt32 cycles = uInt32(mySystem->cycles() - myAudioCycles);
+  const uInt64 cycles = mySystem->cycles() - myAudioCycles;
   myAudioCycles = mySystem->cycles();
 
-  // Calculate the number of DPC OSC clocks since the last update
-  double clocks = ((myDpcPitch * cycles) / 1193191.66666667) + myFractionalClocks;
-  uInt32 wholeClocks = uInt32(clocks);
-  myFractionalClocks = clocks - double(wholeClocks);
+  // Without any music, only the reference cycle needs to be kept
+  if(!myMusicMode[0] && !myMusicMode[1] && !myMusicMode[2])
+    return;
+
+  // Calculate the number of DPC OSC clocks since the last update, exactly
+  const uInt64 clocks = cycles * myDpcPitch * 3 + myFractionalClocks;
+  const uInt32 wholeClocks = uInt32(clocks / CLOCK_DIVISOR);
+  myFractionalClocks = clocks % CLOCK_DIVISOR;
 
-  if(wholeClocks <= 0)
+  if(wholeClocks == 0)
     return;
 
   // Let's update counters and flags of the music mode data fetchers
@@ -141,6 +147,14 @@ inline void CartridgeDPC::updateMusicModeDataFetchers()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeDPC::setDpcPitch(uInt32 pitch)
+{
+  // The clocks so far are counted with the old pitch
+  updateMusicModeDataFetchers();
+  myDpcPitch = pitch;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 CartridgeDPC::peek(uInt16 address)
 {
@@ -285,6 +299,10 @@ bool CartridgeDPC::poke(uInt16 address, uInt8 value)
     uInt32 index = address & 0x07;
     uInt32 function = (address >> 3) & 0x07;
 
+    // The music mode data fetchers count with their old registers so far
+    if(index >= 5 && function <= 0x03)
+      updateMusicModeDataFetchers();
+
     switch(function)
     {
       // DFx top count
@@ -466,7 +484,7 @@ bool CartridgeDPC::save(Serializer& out) const
     out.putByte(myRandomNumber);
 
     out.putLong(myAudioCycles);
-    out.putDouble(myFractionalClocks);
+    out.putDouble(double(myFractionalClocks) / CLOCK_DIVISOR);
   }
   catch(...)
   {
@@ -506,7 +524,7 @@ bool CartridgeDPC::load(Serializer& in)
 
     // Get system cycles and fractional clocks
     myAudioCycles = in.getLong();
-    myFractionalClocks = in.getDouble();
+    myFractionalClocks = uInt64(in.getDouble() * CLOCK_DIVISOR + 0.5);
   }
   catch(...)
   {
@@ -125,7 +125,7 @@ class CartridgeDPC : public Cartridge
     */
     string name() const override { return "CartridgeDPC"; }
 
-    void setDpcPitch(double pitch) { myDpcPitch = pitch; }
+    void setDpcPitch(uInt32 pitch);
 
   #ifdef DEBUGGER_SUPPORT
     /**
@@ -164,7 +164,9 @@ class CartridgeDPC : public Cartridge
 
     /**
       Updates any data fetchers in music mode based on the number of
-      CPU cycles which have passed since the last update.
+      CPU cycles which have passed since the last update.  This must be
+      done before the registers of the music mode data fetchers change,
+      as the elapsed clocks are applied all at once.
     */
     void updateMusicModeDataFetchers();
 
@@ -202,14 +204,19 @@ class CartridgeDPC : public Cartridge
     // System cycle count from when the last update to music data fetchers occurred
     uInt64 myAudioCycles;
 
-    // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks;
+    // Fractional DPC music OSC clocks unused during the last update, in
+    // units of 1 / CLOCK_DIVISOR clocks
+    uInt64 myFractionalClocks;
 
     // Indicates the offset into the ROM image (aligns to current bank)
     uInt16 myBankOffset;
 
     // DPC pitch
-    double myDpcPitch;
+    uInt32 myDpcPitch;
+
+    // The OSC clocks per CPU cycle are pitch * 3 / 3579575 (the CPU runs at
+    // a third of the 3579575 Hz NTSC color clock)
+    static constexpr uInt64 CLOCK_DIVISOR = 3579575;
 
   private:
     // Following constructors and assignment operators not supported
@@ -25,6 +25,9 @@
 #include "TIA.hxx"
 #include "exception/FatalEmulationError.hxx"
 
+constexpr uInt64 CartridgeDPCPlus::CLOCK_DIVISOR;
+constexpr uInt64 CartridgeDPCPlus::CLOCKS_PER_CYCLE;
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 CartridgeDPCPlus::CartridgeDPCPlus(const ByteBuffer& image, uInt32 size,
                                    const string& md5, const Settings& settings)
@@ -35,7 +38,7 @@ CartridgeDPCPlus::CartridgeDPCPlus(const ByteBuffer& image, uInt32 size,
     myParameterPointer(0),
     myAudioCycles(0),
     myARMCycles(0),
-    myFractionalClocks(0.0),
+    myFractionalClocks(0),
     myBankOffset(0),
     myFractionalLowMask(0x0F00FF)
 {
@@ -64,6 +67,7 @@ CartridgeDPCPlus::CartridgeDPCPlus(const ByteBuffer& image, uInt32 size,
        devSettings ? settings.getBool("dev.thumb.trapfatal") : false,
        Thumbulator::ConfigureFor::DPCplus,
        this);
+  myThumbEmulator->setAsync(settings.getBool("thumb.async"));
 
   // Currently only one known DPC+ ARM driver exhibits a problem
   // with the default mask to use for DFxFRACLOW
@@ -76,6 +80,7 @@ CartridgeDPCPlus::CartridgeDPCPlus(const ByteBuffer& image, uInt32 size,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeDPCPlus::reset()
 {
+  waitForARM();
   setInitialState();
 
   // DPC+ always starts in bank 5
@@ -111,15 +116,32 @@ void CartridgeDPCPlus::setInitialState()
   // Initialize various other parameters
   myFastFetch = myLDAimmediate = false;
   myAudioCycles = myARMCycles = 0;
-  myFractionalClocks = 0.0;
+  myFractionalClocks = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeDPCPlus::consoleChanged(ConsoleTiming timing)
 {
+  waitForARM();
   myThumbEmulator->setConsoleTiming(timing);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeDPCPlus::setThumbProfiler(ThumbProfiler* profiler)
+{
+  waitForARM();
+  myThumbEmulator->setProfiler(profiler);
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeDPCPlus::setThumbFastMode(bool enable)
+{
+  waitForARM();
+  myThumbEmulator->setFastMode(enable);
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeDPCPlus::install(System& system)
 {
@@ -155,13 +177,13 @@ inline void CartridgeDPCPlus::priorClockRandomNumberGenerator()
 inline void CartridgeDPCPlus::updateMusicModeDataFetchers()
 {
   // Calculate the number of cycles since the last update
-  uInt32 cycles = uInt32(mySystem->cycles() - myAudioCycles);
+  const uInt64 cycles = mySystem->cycles() - myAudioCycles;
   myAudioCycles = mySystem->cycles();
 
-  // Calculate the number of DPC+ OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  uInt32 wholeClocks = uInt32(clocks);
-  myFractionalClocks = clocks - double(wholeClocks);
+  // Calculate the number of DPC+ OSC clocks since the last update, exactly
+  const uInt64 clocks = cycles * CLOCKS_PER_CYCLE + myFractionalClocks;
+  const uInt32 wholeClocks = uInt32(clocks / CLOCK_DIVISOR);
+  myFractionalClocks = clocks % CLOCK_DIVISOR;
 
   // Let's update counters and flags of the music mode data fetchers
   if(wholeClocks > 0)
@@ -197,7 +219,8 @@ inline void CartridgeDPCPlus::callFunction(uInt8 value)
         Int32 cycles = Int32(mySystem->cycles() - myARMCycles);
         myARMCycles = mySystem->cycles();
 
-        myThumbEmulator->run(cycles);
+        System::ZoneGuard zone(*mySystem, System::Zone::arm);
+        myThumbEmulator->start(cycles);
       }
       catch(const runtime_error& e) {
         if(!mySystem->autodetectMode())
@@ -210,6 +233,20 @@ inline void CartridgeDPCPlus::callFunction(uInt8 value)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeDPCPlus::waitForARM()
+{
+  try {
+    myThumbEmulator->sync();
+  }
+  catch(const runtime_error& e) {
+    if(!mySystem->autodetectMode())
+    {
+      FatalEmulationError::raise(e.what());
+    }
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 CartridgeDPCPlus::peek(uInt16 address)
 {
@@ -236,6 +273,8 @@ uInt8 CartridgeDPCPlus::peek(uInt16 address)
   {
     uInt8 result = 0;
 
+    waitForARM();
+
     // Get the index of the data fetcher that's being accessed
     uInt32 index = address & 0x07;
     uInt32 function = (address >> 3) & 0x07;
@@ -399,6 +438,8 @@ bool CartridgeDPCPlus::poke(uInt16 address, uInt8 value)
 
   if((address >= 0x0028) && (address < 0x0080))
   {
+    waitForARM();
+
     // Get the index of the data fetcher that's being accessed
     uInt32 index = address & 0x07;
     uInt32 function = ((address - 0x28) >> 3) & 0x0f;
@@ -514,6 +555,8 @@ bool CartridgeDPCPlus::poke(uInt16 address, uInt8 value)
           case 0x06:  // NOTE1
           case 0x07:  // NOTE2
           {
+            // The counters advance with the old frequency so far
+            updateMusicModeDataFetchers();
             myMusicFrequencies[index-5] = myFrequencyImage[(value<<2)] +
             (myFrequencyImage[(value<<2)+1]<<8) +
             (myFrequencyImage[(value<<2)+2]<<16) +
@@ -641,6 +684,8 @@ bool CartridgeDPCPlus::save(Serializer& out) const
 {
   try
   {
+    myThumbEmulator->sync();
+
     // Indicates which bank is currently active
     out.putShort(myBankOffset);
 
@@ -683,7 +728,7 @@ bool CartridgeDPCPlus::save(Serializer& out) const
 
     // Get system cycles and fractional clocks
     out.putLong(myAudioCycles);
-    out.putDouble(myFractionalClocks);
+    out.putDouble(double(myFractionalClocks) / CLOCK_DIVISOR);
 
     // Clock info for Thumbulator
     out.putLong(myARMCycles);
@@ -700,6 +745,8 @@ bool CartridgeDPCPlus::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeDPCPlus::load(Serializer& in)
 {
+  waitForARM();
+
   try
   {
     // Indicates which bank is currently active
@@ -744,7 +791,7 @@ bool CartridgeDPCPlus::load(Serializer& in)
 
     // Get audio cycles and fractional clocks
     myAudioCycles = in.getLong();
-    myFractionalClocks = in.getDouble();
+    myFractionalClocks = uInt64(in.getDouble() * CLOCK_DIVISOR + 0.5);
 
     // Clock info for Thumbulator
     myARMCycles = in.getLong();
@@ -75,6 +75,18 @@ class CartridgeDPCPlus : public Cartridge
     */
     void consoleChanged(ConsoleTiming timing) override;
 
+    /**
+      Count the cycles of the ARM code in the given profiler.
+
+      @param profiler  The profiler, or the null pointer to stop profiling
+    */
+    bool setThumbProfiler(ThumbProfiler* profiler) override;
+
+    /**
+      Run the ARM code in the fast mode of the Thumbulator (or not).
+    */
+    bool setThumbFastMode(bool enable) override;
+
     /**
       Install cartridge in the specified system.  Invoked by the system
       when the cartridge is attached to it.
@@ -117,6 +129,14 @@ class CartridgeDPCPlus : public Cartridge
     */
     const uInt8* getImage(uInt32& size) const override;
 
+    /**
+      Access the internal RAM of this cartridge.
+
+      @param size  Set to the size of the internal RAM
+      @return  A pointer to the internal RAM
+    */
+    uInt8* getRAM(uInt32& size) override { size = sizeof(myDPCRAM);  return myDPCRAM; }
+
     /**
       Save the current state of this cart to the given Serializer.
 
@@ -187,7 +207,9 @@ class CartridgeDPCPlus : public Cartridge
 
     /**
       Updates any data fetchers in music mode based on the number of
-      CPU cycles which have passed since the last update.
+      CPU cycles which have passed since the last update.  This must be
+      done before the frequencies change, as the elapsed clocks are
+      applied all at once.
     */
     void updateMusicModeDataFetchers();
 
@@ -196,6 +218,12 @@ class CartridgeDPCPlus : public Cartridge
     */
     void callFunction(uInt8 value);
 
+    /**
+      Wait for ARM code running on the ARM thread to finish; this must be
+      done before accessing anything the ARM code can change.
+    */
+    void waitForARM();
+
   private:
     // The ROM image and size
     uInt8 myImage[32768];
@@ -264,8 +292,14 @@ class CartridgeDPCPlus : public Cartridge
     // System cycle count when the last Thumbulator::run() occurred
     uInt64 myARMCycles;
 
-    // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks;
+    // Fractional DPC music OSC clocks unused during the last update, in
+    // units of 1 / CLOCK_DIVISOR clocks
+    uInt64 myFractionalClocks;
+
+    // The OSC runs at 20 kHz, which is 20000 * 3 / 3579575 clocks per CPU
+    // cycle (the CPU runs at a third of the 3579575 Hz NTSC color clock)
+    static constexpr uInt64 CLOCK_DIVISOR = 3579575;
+    static constexpr uInt64 CLOCKS_PER_CYCLE = 20000 * 3;
 
     // Indicates the offset into the ROM image (aligns to current bank)
     uInt16 myBankOffset;
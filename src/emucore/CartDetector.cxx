@@ -61,6 +61,7 @@
 #include "CartX07.hxx"
 #include "MD5.hxx"
 #include "Props.hxx"
+#include "SignatureScanner.hxx"
 
 #include "CartDetector.hxx"
 
@@ -341,6 +342,9 @@ Bankswitch::Type CartDetector::autodetectType(const ByteBuffer& image, uInt32 si
   // Guess type based on size
   Bankswitch::Type type = Bankswitch::Type::_AUTO;
 
+  // Search for all signatures in one go, rather than once per signature
+  const SignatureHits hits = scanSignatures(image, size);
+
   if(isProbablyCVPlus(image, size))
   {
     type = Bankswitch::Type::_CVP;
@@ -356,11 +360,11 @@ Bankswitch::Type CartDetector::autodetectType(const ByteBuffer& image, uInt32 si
   else if((size == 2048) ||
           (size == 4096 && memcmp(image.get(), image.get() + 2048, 2048) == 0))
   {
-    type = isProbablyCV(image, size) ? Bankswitch::Type::_CV : Bankswitch::Type::_2K;
+    type = isProbablyCV(hits) ? Bankswitch::Type::_CV : Bankswitch::Type::_2K;
   }
   else if(size == 4096)
   {
-    if(isProbablyCV(image, size))
+    if(isProbablyCV(hits))
       type = Bankswitch::Type::_CV;
     else if(isProbably4KSC(image, size))
       type = Bankswitch::Type::_4KSC;
@@ -370,30 +374,25 @@ Bankswitch::Type CartDetector::autodetectType(const ByteBuffer& image, uInt32 si
   else if(size == 8*1024)  // 8K
   {
     // First check for *potential* F8
-    uInt8 signature[2][3] = {
-      { 0x8D, 0xF9, 0x1F },  // STA $1FF9
-      { 0x8D, 0xF9, 0xFF }   // STA $FFF9
-    };
-    bool f8 = searchForBytes(image.get(), size, signature[0], 3, 2) ||
-              searchForBytes(image.get(), size, signature[1], 3, 2);
+    bool f8 = hits[size_t(Sig::F8)];
 
     if(isProbablySC(image, size))
       type = Bankswitch::Type::_F8SC;
     else if(memcmp(image.get(), image.get() + 4096, 4096) == 0)
       type = Bankswitch::Type::_4K;
-    else if(isProbablyE0(image, size))
+    else if(isProbablyE0(hits))
       type = Bankswitch::Type::_E0;
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(hits))
       type = Bankswitch::Type::_3E;
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = Bankswitch::Type::_3F;
-    else if(isProbablyUA(image, size))
+    else if(isProbablyUA(hits))
       type = Bankswitch::Type::_UA;
-    else if(isProbablyFE(image, size) && !f8)
+    else if(isProbablyFE(hits) && !f8)
       type = Bankswitch::Type::_FE;
-    else if(isProbably0840(image, size))
+    else if(isProbably0840(hits))
       type = Bankswitch::Type::_0840;
-    else if(isProbablyE78K(image, size))
+    else if(isProbablyE78K(hits))
       type = Bankswitch::Type::_E78K;
     else
       type = Bankswitch::Type::_F8;
@@ -414,12 +413,12 @@ Bankswitch::Type CartDetector::autodetectType(const ByteBuffer& image, uInt32 si
   {
     if(isProbablySC(image, size))
       type = Bankswitch::Type::_F6SC;
-    else if(isProbablyE7(image, size))
+    else if(isProbablyE7(hits))
       type = Bankswitch::Type::_E7;
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(hits))
       type = Bankswitch::Type::_3E;
   /* no known 16K 3F ROMS
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = Bankswitch::Type::_3F;
   */
     else
@@ -433,24 +432,24 @@ Bankswitch::Type CartDetector::autodetectType(const ByteBuffer& image, uInt32 si
   {
     if(isProbablyARM(image, size))
       type = Bankswitch::Type::_FA2;
-    else /*if(isProbablyDPCplus(image, size))*/
+    else /*if(isProbablyDPCplus(hits))*/
       type = Bankswitch::Type::_DPCP;
   }
   else if(size == 32*1024)  // 32K
   {
-    if (isProbablyCTY(image, size))
+    if (isProbablyCTY(hits))
       type = Bankswitch::Type::_CTY;
     else if(isProbablySC(image, size))
       type = Bankswitch::Type::_F4SC;
-    else if(isProbably3E(image, size))
+    else if(isProbably3E(hits))
       type = Bankswitch::Type::_3E;
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = Bankswitch::Type::_3F;
-    else if (isProbablyBUS(image, size))
+    else if (isProbablyBUS(hits))
       type = Bankswitch::Type::_BUS;
-    else if (isProbablyCDF(image, size))
+    else if (isProbablyCDF(hits))
       type = Bankswitch::Type::_CDF;
-    else if(isProbablyDPCplus(image, size))
+    else if(isProbablyDPCplus(hits))
       type = Bankswitch::Type::_DPCP;
     else if(isProbablyFA2(image, size))
       type = Bankswitch::Type::_FA2;
@@ -459,64 +458,64 @@ Bankswitch::Type CartDetector::autodetectType(const ByteBuffer& image, uInt32 si
   }
   else if(size == 60*1024)  // 60K
   {
-    if(isProbablyCTY(image, size))
+    if(isProbablyCTY(hits))
       type = Bankswitch::Type::_CTY;
     else
       type = Bankswitch::Type::_F4;
   }
   else if(size == 64*1024)  // 64K
   {
-    if(isProbably3E(image, size))
+    if(isProbably3E(hits))
       type = Bankswitch::Type::_3E;
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = Bankswitch::Type::_3F;
     else if(isProbably4A50(image, size))
       type = Bankswitch::Type::_4A50;
-    else if(isProbablyEF(image, size, type))
+    else if(isProbablyEF(image, size, hits, type))
       ; // type has been set directly in the function
-    else if(isProbablyX07(image, size))
+    else if(isProbablyX07(hits))
       type = Bankswitch::Type::_X07;
     else
       type = Bankswitch::Type::_F0;
   }
   else if(size == 128*1024)  // 128K
   {
-    if(isProbably3E(image, size))
+    if(isProbably3E(hits))
       type = Bankswitch::Type::_3E;
     else if(isProbablyDF(image, size, type))
       ; // type has been set directly in the function
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = Bankswitch::Type::_3F;
     else if(isProbably4A50(image, size))
       type = Bankswitch::Type::_4A50;
-    else if(isProbablySB(image, size))
+    else if(isProbablySB(hits))
       type = Bankswitch::Type::_SB;
   }
   else if(size == 256*1024)  // 256K
   {
-    if(isProbably3E(image, size))
+    if(isProbably3E(hits))
       type = Bankswitch::Type::_3E;
     else if(isProbablyBF(image, size, type))
       ; // type has been set directly in the function
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = Bankswitch::Type::_3F;
-    else /*if(isProbablySB(image, size))*/
+    else /*if(isProbablySB(hits))*/
       type = Bankswitch::Type::_SB;
   }
   else  // what else can we do?
   {
-    if(isProbably3E(image, size))
+    if(isProbably3E(hits))
       type = Bankswitch::Type::_3E;
-    else if(isProbably3F(image, size))
+    else if(isProbably3F(hits))
       type = Bankswitch::Type::_3F;
     else
       type = Bankswitch::Type::_4K;  // Most common bankswitching type
   }
 
   // Variable sized ROM formats are independent of image size and come last
-  if(isProbablyDASH(image, size))
+  if(isProbablyDASH(hits))
     type = Bankswitch::Type::_DASH;
-  else if(isProbably3EPlus(image, size))
+  else if(isProbably3EPlus(hits))
     type = Bankswitch::Type::_3EP;
   else if(isProbablyMDM(image, size))
     type = Bankswitch::Type::_MDM;
@@ -552,6 +551,151 @@ bool CartDetector::searchForBytes(const uInt8* image, uInt32 imagesize,
   return (count >= minhits);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CartDetector::SignatureHits
+CartDetector::scanSignatures(const ByteBuffer& image, uInt32 size)
+{
+  struct Signature {
+    Sig type;
+    uInt32 minhits;  // The minimum number of times it is to be found
+    ByteArray bytes;
+  };
+  static const Signature signatures[] = {
+    // F8 cart bankswitching (only used to tell F8 from FE)
+    { Sig::F8, 2, { 0x8D, 0xF9, 0x1F } },  // STA $1FF9
+    { Sig::F8, 2, { 0x8D, 0xF9, 0xFF } },  // STA $FFF9
+
+    // 0840 cart bankswitching is triggered by accessing addresses 0x0800
+    // or 0x0840 at least twice
+    { Sig::_0840, 2, { 0xAD, 0x00, 0x08 } },  // LDA $0800
+    { Sig::_0840, 2, { 0xAD, 0x40, 0x08 } },  // LDA $0840
+    { Sig::_0840, 2, { 0x2C, 0x00, 0x08 } },  // BIT $0800
+    { Sig::_0840, 2, { 0x0C, 0x00, 0x08, 0x4C } },  // NOP $0800; JMP ...
+    { Sig::_0840, 2, { 0x0C, 0xFF, 0x0F, 0x4C } },  // NOP $0FFF; JMP ...
+
+    // 3E cart bankswitching is triggered by storing the bank number
+    // in address 3E using 'STA $3E', commonly followed by an
+    // immediate mode LDA
+    { Sig::_3E, 1, { 0x85, 0x3E, 0xA9, 0x00 } },  // STA $3E; LDA #$00
+
+    // 3E+ cart is identified key 'TJ3E' in the ROM
+    { Sig::_3EPlus, 1, { 'T', 'J', '3', 'E' } },
+
+    // 3F cart bankswitching is triggered by storing the bank number
+    // in address 3F using 'STA $3F'
+    // We expect it will be present at least 2 times, since there are
+    // at least two banks
+    { Sig::_3F, 2, { 0x85, 0x3F } },  // STA $3F
+
+    // BUS ARM code has 2 occurrences of the string BUS
+    // Note: all Harmony/Melody custom drivers also contain the value
+    // 0x10adab1e (LOADABLE) if needed for future improvement
+    { Sig::BUS, 2, { 'B', 'U', 'S' } },
+
+    // CDF ARM code has 3 occurrences of the string CDF
+    { Sig::CDF, 3, { 'C', 'D', 'F' } },
+
+    { Sig::CTY, 1, { 'L', 'E', 'N', 'I', 'N' } },
+
+    // CV RAM access occurs at addresses $f3ff and $f400
+    // These signatures are attributed to the MESS project
+    { Sig::CV, 1, { 0x9D, 0xFF, 0xF3 } },  // STA $F3FF.X
+    { Sig::CV, 1, { 0x99, 0x00, 0xF4 } },  // STA $F400.Y
+
+    // DASH cart is identified key 'TJAD' in the ROM
+    { Sig::DASH, 1, { 'T', 'J', 'A', 'D' } },
+
+    // DPC+ ARM code has 2 occurrences of the string DPC+
+    { Sig::DPCplus, 2, { 'D', 'P', 'C', '+' } },
+
+    // E0 cart bankswitching is triggered by accessing addresses
+    // $FE0 to $FF9 using absolute non-indexed addressing
+    // To eliminate false positives (and speed up processing), we
+    // search for only certain known signatures
+    // Thanks to "stella@casperkitty.com" for this advice
+    // These signatures are attributed to the MESS project
+    { Sig::E0, 1, { 0x8D, 0xE0, 0x1F } },  // STA $1FE0
+    { Sig::E0, 1, { 0x8D, 0xE0, 0x5F } },  // STA $5FE0
+    { Sig::E0, 1, { 0x8D, 0xE9, 0xFF } },  // STA $FFE9
+    { Sig::E0, 1, { 0x0C, 0xE0, 0x1F } },  // NOP $1FE0
+    { Sig::E0, 1, { 0xAD, 0xE0, 0x1F } },  // LDA $1FE0
+    { Sig::E0, 1, { 0xAD, 0xE9, 0xFF } },  // LDA $FFE9
+    { Sig::E0, 1, { 0xAD, 0xED, 0xFF } },  // LDA $FFED
+    { Sig::E0, 1, { 0xAD, 0xF3, 0xBF } },  // LDA $BFF3
+
+    // E7 cart bankswitching is triggered by accessing addresses
+    // $FE0 to $FE6 using absolute non-indexed addressing
+    // (same source of signatures as for E0)
+    { Sig::E7, 1, { 0xAD, 0xE2, 0xFF } },  // LDA $FFE2
+    { Sig::E7, 1, { 0xAD, 0xE5, 0xFF } },  // LDA $FFE5
+    { Sig::E7, 1, { 0xAD, 0xE5, 0x1F } },  // LDA $1FE5
+    { Sig::E7, 1, { 0xAD, 0xE7, 0x1F } },  // LDA $1FE7
+    { Sig::E7, 1, { 0x0C, 0xE7, 0x1F } },  // NOP $1FE7
+    { Sig::E7, 1, { 0x8D, 0xE7, 0xFF } },  // STA $FFE7
+    { Sig::E7, 1, { 0x8D, 0xE7, 0x1F } },  // STA $1FE7
+
+    // E78K cart bankswitching is triggered by accessing addresses
+    // $FE4 to $FE6 using absolute non-indexed addressing
+    { Sig::E78K, 1, { 0xAD, 0xE4, 0xFF } },  // LDA $FFE4
+    { Sig::E78K, 1, { 0xAD, 0xE5, 0xFF } },  // LDA $FFE5
+    { Sig::E78K, 1, { 0xAD, 0xE6, 0xFF } },  // LDA $FFE6
+
+    // EF cart bankswitching switches banks by accessing addresses
+    // 0xFE0 to 0xFEF, usually with either a NOP or LDA
+    // It's likely that the code will switch to bank 0, so that's what is tested
+    { Sig::EF, 1, { 0x0C, 0xE0, 0xFF } },  // NOP $FFE0
+    { Sig::EF, 1, { 0xAD, 0xE0, 0xFF } },  // LDA $FFE0
+    { Sig::EF, 1, { 0x0C, 0xE0, 0x1F } },  // NOP $1FE0
+    { Sig::EF, 1, { 0xAD, 0xE0, 0x1F } },  // LDA $1FE0
+
+    // FE bankswitching is very weird, but always seems to include a
+    // 'JSR $xxxx'
+    // These signatures are attributed to the MESS project
+    { Sig::FE, 1, { 0x20, 0x00, 0xD0, 0xC6, 0xC5 } },  // JSR $D000; DEC $C5
+    { Sig::FE, 1, { 0x20, 0xC3, 0xF8, 0xA5, 0x82 } },  // JSR $F8C3; LDA $82
+    { Sig::FE, 1, { 0xD0, 0xFB, 0x20, 0x73, 0xFE } },  // BNE $FB; JSR $FE73
+    { Sig::FE, 1, { 0x20, 0x00, 0xF0, 0x84, 0xD6 } },  // JSR $F000; $84, $D6
+
+    // SB cart bankswitching switches banks by accessing address 0x0800
+    { Sig::SB, 1, { 0xBD, 0x00, 0x08 } },  // LDA $0800,x
+    { Sig::SB, 1, { 0xAD, 0x00, 0x08 } },  // LDA $0800
+
+    // UA cart bankswitching switches to bank 1 by accessing address 0x240
+    // using 'STA $240' or 'LDA $240'
+    // Similar Brazilian cart bankswitching switches to bank 1 by accessing address 0x2C0
+    // using 'BIT $2C0', 'STA $2C0' or 'LDA $2C0'
+    { Sig::UA, 1, { 0x8D, 0x40, 0x02 } },  // STA $240
+    { Sig::UA, 1, { 0xAD, 0x40, 0x02 } },  // LDA $240
+    { Sig::UA, 1, { 0xBD, 0x1F, 0x02 } },  // LDA $21F,X
+    { Sig::UA, 1, { 0x2C, 0xC0, 0x02 } },  // BIT $2C0
+    { Sig::UA, 1, { 0x8D, 0xC0, 0x02 } },  // STA $2C0
+    { Sig::UA, 1, { 0xAD, 0xC0, 0x02 } },  // LDA $2C0
+
+    // X07 bankswitching switches to bank 0, 1, 2, etc by accessing address 0x08xd
+    { Sig::X07, 1, { 0xAD, 0x0D, 0x08 } },  // LDA $080D
+    { Sig::X07, 1, { 0xAD, 0x1D, 0x08 } },  // LDA $081D
+    { Sig::X07, 1, { 0xAD, 0x2D, 0x08 } },  // LDA $082D
+    { Sig::X07, 1, { 0x0C, 0x0D, 0x08 } },  // NOP $080D
+    { Sig::X07, 1, { 0x0C, 0x1D, 0x08 } },  // NOP $081D
+    { Sig::X07, 1, { 0x0C, 0x2D, 0x08 } }   // NOP $082D
+  };
+  static const SignatureScanner scanner([] {
+    vector<ByteArray> bytes;
+    for(const auto& sig: signatures)
+      bytes.push_back(sig.bytes);
+    return bytes;
+  }());
+
+  const vector<uInt32> counts = scanner.scan(image.get(), size);
+
+  SignatureHits hits;
+  for(uInt32 i = 0; i < counts.size(); ++i)
+    if(counts[i] >= signatures[i].minhits)
+      hits.set(size_t(signatures[i].type));
+
+  return hits;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartDetector::isProbablySC(const ByteBuffer& image, uInt32 size)
 {
@@ -585,57 +729,27 @@ bool CartDetector::isProbablyARM(const ByteBuffer& image, uInt32 size)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbably0840(const ByteBuffer& image, uInt32 size)
+bool CartDetector::isProbably0840(const SignatureHits& hits)
 {
-  // 0840 cart bankswitching is triggered by accessing addresses 0x0800
-  // or 0x0840 at least twice
-  uInt8 signature1[3][3] = {
-    { 0xAD, 0x00, 0x08 },  // LDA $0800
-    { 0xAD, 0x40, 0x08 },  // LDA $0840
-    { 0x2C, 0x00, 0x08 }   // BIT $0800
-  };
-  for(uInt32 i = 0; i < 3; ++i)
-    if(searchForBytes(image.get(), size, signature1[i], 3, 2))
-      return true;
-
-  uInt8 signature2[2][4] = {
-    { 0x0C, 0x00, 0x08, 0x4C },  // NOP $0800; JMP ...
-    { 0x0C, 0xFF, 0x0F, 0x4C }   // NOP $0FFF; JMP ...
-  };
-  for(uInt32 i = 0; i < 2; ++i)
-    if(searchForBytes(image.get(), size, signature2[i], 4, 2))
-      return true;
-
-  return false;
+  return hits[size_t(Sig::_0840)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbably3E(const ByteBuffer& image, uInt32 size)
+bool CartDetector::isProbably3E(const SignatureHits& hits)
 {
-  // 3E cart bankswitching is triggered by storing the bank number
-  // in address 3E using 'STA $3E', commonly followed by an
-  // immediate mode LDA
-  uInt8 signature[] = { 0x85, 0x3E, 0xA9, 0x00 };  // STA $3E; LDA #$00
-  return searchForBytes(image.get(), size, signature, 4, 1);
+  return hits[size_t(Sig::_3E)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbably3EPlus(const ByteBuffer& image, uInt32 size)
+bool CartDetector::isProbably3EPlus(const SignatureHits& hits)
 {
-  // 3E+ cart is identified key 'TJ3E' in the ROM
-  uInt8 tj3e[] = { 'T', 'J', '3', 'E' };
-  return searchForBytes(image.get(), size, tj3e, 4, 1);
+  return hits[size_t(Sig::_3EPlus)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbably3F(const ByteBuffer& image, uInt32 size)
+bool CartDetector::isProbably3F(const SignatureHits& hits)
 {
-  // 3F cart bankswitching is triggered by storing the bank number
-  // in address 3F using 'STA $3F'
-  // We expect it will be present at least 2 times, since there are
-  // at least two banks
-  uInt8 signature[] = { 0x85, 0x3F };  // STA $3F
-  return searchForBytes(image.get(), size, signature, 2, 2);
+  return hits[size_t(Sig::_3F)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -648,10 +762,13 @@ bool CartDetector::isProbably4A50(const ByteBuffer& image, uInt32 size)
     return true;
 
   // Program starts at $1Fxx with NOP $6Exx or NOP $6Fxx?
-  if(((image[0xfffd] & 0x1f) == 0x1f) &&
-      (image[image[0xfffd] * 256 + image[0xfffc]] == 0x0c) &&
-      ((image[image[0xfffd] * 256 + image[0xfffc] + 2] & 0xfe) == 0x6e))
-    return true;
+  if((image[0xfffd] & 0x1f) == 0x1f)
+  {
+    const uInt32 start = image[0xfffd] * 256 + image[0xfffc];
+    if(start + 2 < size && image[start] == 0x0c &&
+       (image[start + 2] & 0xfe) == 0x6e)
+      return true;
+  }
 
   return false;
 }
@@ -696,45 +813,27 @@ bool CartDetector::isProbablyBF(const ByteBuffer& image, uInt32 size,
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyBUS(const ByteBuffer& image, uInt32 size)
+bool CartDetector::isProbablyBUS(const SignatureHits& hits)
 {
-  // BUS ARM code has 2 occurrences of the string BUS
-  // Note: all Harmony/Melody custom drivers also contain the value
-  // 0x10adab1e (LOADABLE) if needed for future improvement
-  uInt8 bus[] = { 'B', 'U', 'S'};
-  return searchForBytes(image.get(), size, bus, 3, 2);
+  return hits[size_t(Sig::BUS)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyCDF(const ByteBuffer& image, uInt32 size)
+bool CartDetector::isProbablyCDF(const SignatureHits& hits)
 {
-  // CDF ARM code has 3 occurrences of the string CDF
-  // Note: all Harmony/Melody custom drivers also contain the value
-  // 0x10adab1e (LOADABLE) if needed for future improvement
-  uInt8 cdf[] = { 'C', 'D', 'F' };
-  return searchForBytes(image.get(), size, cdf, 3, 3);
+  return hits[size_t(Sig::CDF)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyCTY(const ByteBuffer& image, uInt32 size)
+bool CartDetector::isProbablyCTY(const SignatureHits& hits)
 {
-  uInt8 lenin[] = { 'L', 'E', 'N', 'I', 'N' };
-  return searchForBytes(image.get(), size, lenin, 5, 1);
+  return hits[size_t(Sig::CTY)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyCV(const ByteBuffer& image, uInt32 size)
+bool CartDetector::isProbablyCV(const SignatureHits& hits)
 {
-  // CV RAM access occurs at addresses $f3ff and $f400
-  // These signatures are attributed to the MESS project
-  uInt8 signature[2][3] = {
-    { 0x9D, 0xFF, 0xF3 },  // STA $F3FF.X
-    { 0x99, 0x00, 0xF4 }   // STA $F400.Y
-  };
-  if(searchForBytes(image.get(), size, signature[0], 3, 1))
-    return true;
-  else
-    return searchForBytes(image.get(), size, signature[1], 3, 1);
+  return hits[size_t(Sig::CV)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -748,11 +847,9 @@ bool CartDetector::isProbablyCVPlus(const ByteBuffer& image, uInt32)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyDASH(const ByteBuffer& image, uInt32 size)
+bool CartDetector::isProbablyDASH(const SignatureHits& hits)
 {
-  // DASH cart is identified key 'TJAD' in the ROM
-  uInt8 tjad[] = { 'T', 'J', 'A', 'D' };
-  return searchForBytes(image.get(), size, tjad, 4, 1);
+  return hits[size_t(Sig::DASH)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -779,87 +876,32 @@ bool CartDetector::isProbablyDF(const ByteBuffer& image, uInt32 size,
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyDPCplus(const ByteBuffer& image, uInt32 size)
+bool CartDetector::isProbablyDPCplus(const SignatureHits& hits)
 {
-  // DPC+ ARM code has 2 occurrences of the string DPC+
-  // Note: all Harmony/Melody custom drivers also contain the value
-  // 0x10adab1e (LOADABLE) if needed for future improvement
-  uInt8 dpcp[] = { 'D', 'P', 'C', '+' };
-  return searchForBytes(image.get(), size, dpcp, 4, 2);
+  return hits[size_t(Sig::DPCplus)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyE0(const ByteBuffer& image, uInt32 size)
+bool CartDetector::isProbablyE0(const SignatureHits& hits)
 {
-  // E0 cart bankswitching is triggered by accessing addresses
-  // $FE0 to $FF9 using absolute non-indexed addressing
-  // To eliminate false positives (and speed up processing), we
-  // search for only certain known signatures
-  // Thanks to "stella@casperkitty.com" for this advice
-  // These signatures are attributed to the MESS project
-  uInt8 signature[8][3] = {
-    { 0x8D, 0xE0, 0x1F },  // STA $1FE0
-    { 0x8D, 0xE0, 0x5F },  // STA $5FE0
-    { 0x8D, 0xE9, 0xFF },  // STA $FFE9
-    { 0x0C, 0xE0, 0x1F },  // NOP $1FE0
-    { 0xAD, 0xE0, 0x1F },  // LDA $1FE0
-    { 0xAD, 0xE9, 0xFF },  // LDA $FFE9
-    { 0xAD, 0xED, 0xFF },  // LDA $FFED
-    { 0xAD, 0xF3, 0xBF }   // LDA $BFF3
-  };
-  for(uInt32 i = 0; i < 8; ++i)
-    if(searchForBytes(image.get(), size, signature[i], 3, 1))
-      return true;
-
-  return false;
+  return hits[size_t(Sig::E0)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyE7(const ByteBuffer& image, uInt32 size)
+bool CartDetector::isProbablyE7(const SignatureHits& hits)
 {
-  // E7 cart bankswitching is triggered by accessing addresses
-  // $FE0 to $FE6 using absolute non-indexed addressing
-  // To eliminate false positives (and speed up processing), we
-  // search for only certain known signatures
-  // Thanks to "stella@casperkitty.com" for this advice
-  // These signatures are attributed to the MESS project
-  uInt8 signature[7][3] = {
-    { 0xAD, 0xE2, 0xFF },  // LDA $FFE2
-    { 0xAD, 0xE5, 0xFF },  // LDA $FFE5
-    { 0xAD, 0xE5, 0x1F },  // LDA $1FE5
-    { 0xAD, 0xE7, 0x1F },  // LDA $1FE7
-    { 0x0C, 0xE7, 0x1F },  // NOP $1FE7
-    { 0x8D, 0xE7, 0xFF },  // STA $FFE7
-    { 0x8D, 0xE7, 0x1F }   // STA $1FE7
-  };
-  for(uInt32 i = 0; i < 7; ++i)
-    if(searchForBytes(image.get(), size, signature[i], 3, 1))
-      return true;
-
-  return false;
+  return hits[size_t(Sig::E7)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyE78K(const ByteBuffer& image, uInt32 size)
+bool CartDetector::isProbablyE78K(const SignatureHits& hits)
 {
-  // E78K cart bankswitching is triggered by accessing addresses
-  // $FE4 to $FE6 using absolute non-indexed addressing
-  // To eliminate false positives (and speed up processing), we
-  // search for only certain known signatures
-  uInt8 signature[3][3] = {
-    { 0xAD, 0xE4, 0xFF },  // LDA $FFE4
-    { 0xAD, 0xE5, 0xFF },  // LDA $FFE5
-    { 0xAD, 0xE6, 0xFF },  // LDA $FFE6
-  };
-  for(uInt32 i = 0; i < 3; ++i)
-    if(searchForBytes(image.get(), size, signature[i], 3, 1))
-      return true;
-
-  return false;
+  return hits[size_t(Sig::E78K)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartDetector::isProbablyEF(const ByteBuffer& image, uInt32 size,
+                                const SignatureHits& hits,
                                 Bankswitch::Type& type)
 {
   // Newer EF carts store strings 'EFEF' and 'EFSC' starting at address $FFF8
@@ -879,22 +921,7 @@ bool CartDetector::isProbablyEF(const ByteBuffer& image, uInt32 size,
 
   // Otherwise, EF cart bankswitching switches banks by accessing addresses
   // 0xFE0 to 0xFEF, usually with either a NOP or LDA
-  // It's likely that the code will switch to bank 0, so that's what is tested
-  bool isEF = false;
-  uInt8 signature[4][3] = {
-    { 0x0C, 0xE0, 0xFF },  // NOP $FFE0
-    { 0xAD, 0xE0, 0xFF },  // LDA $FFE0
-    { 0x0C, 0xE0, 0x1F },  // NOP $1FE0
-    { 0xAD, 0xE0, 0x1F }   // LDA $1FE0
-  };
-  for(uInt32 i = 0; i < 4; ++i)
-  {
-    if(searchForBytes(image.get(), size, signature[i], 3, 1))
-    {
-      isEF = true;
-      break;
-    }
-  }
+  bool isEF = hits[size_t(Sig::EF)];
 
   // Now that we know that the ROM is EF, we need to check if it's
   // the SC variant
@@ -923,22 +950,9 @@ bool CartDetector::isProbablyFA2(const ByteBuffer& image, uInt32)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyFE(const ByteBuffer& image, uInt32 size)
+bool CartDetector::isProbablyFE(const SignatureHits& hits)
 {
-  // FE bankswitching is very weird, but always seems to include a
-  // 'JSR $xxxx'
-  // These signatures are attributed to the MESS project
-  uInt8 signature[4][5] = {
-    { 0x20, 0x00, 0xD0, 0xC6, 0xC5 },  // JSR $D000; DEC $C5
-    { 0x20, 0xC3, 0xF8, 0xA5, 0x82 },  // JSR $F8C3; LDA $82
-    { 0xD0, 0xFB, 0x20, 0x73, 0xFE },  // BNE $FB; JSR $FE73
-    { 0x20, 0x00, 0xF0, 0x84, 0xD6 }   // JSR $F000; $84, $D6
-  };
-  for(uInt32 i = 0; i < 4; ++i)
-    if(searchForBytes(image.get(), size, signature[i], 5, 1))
-      return true;
-
-  return false;
+  return hits[size_t(Sig::FE)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -950,56 +964,19 @@ bool CartDetector::isProbablyMDM(const ByteBuffer& image, uInt32 size)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablySB(const ByteBuffer& image, uInt32 size)
+bool CartDetector::isProbablySB(const SignatureHits& hits)
 {
-  // SB cart bankswitching switches banks by accessing address 0x0800
-  uInt8 signature[2][3] = {
-    { 0xBD, 0x00, 0x08 },  // LDA $0800,x
-    { 0xAD, 0x00, 0x08 }   // LDA $0800
-  };
-  if(searchForBytes(image.get(), size, signature[0], 3, 1))
-    return true;
-  else
-    return searchForBytes(image.get(), size, signature[1], 3, 1);
+  return hits[size_t(Sig::SB)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyUA(const ByteBuffer& image, uInt32 size)
+bool CartDetector::isProbablyUA(const SignatureHits& hits)
 {
-  // UA cart bankswitching switches to bank 1 by accessing address 0x240
-  // using 'STA $240' or 'LDA $240'
-  // Similar Brazilian cart bankswitching switches to bank 1 by accessing address 0x2C0
-  // using 'BIT $2C0', 'STA $2C0' or 'LDA $2C0'
-  uInt8 signature[6][3] = {
-    { 0x8D, 0x40, 0x02 },  // STA $240
-    { 0xAD, 0x40, 0x02 },  // LDA $240
-    { 0xBD, 0x1F, 0x02 },  // LDA $21F,X
-    { 0x2C, 0xC0, 0x02 },  // BIT $2C0
-    { 0x8D, 0xC0, 0x02 },  // STA $2C0
-    { 0xAD, 0xC0, 0x02 }   // LDA $2C0
-  };
-  for(uInt32 i = 0; i < 6; ++i)
-    if(searchForBytes(image.get(), size, signature[i], 3, 1))
-      return true;
-
-  return false;
+  return hits[size_t(Sig::UA)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartDetector::isProbablyX07(const ByteBuffer& image, uInt32 size)
+bool CartDetector::isProbablyX07(const SignatureHits& hits)
 {
-  // X07 bankswitching switches to bank 0, 1, 2, etc by accessing address 0x08xd
-  uInt8 signature[6][3] = {
-    { 0xAD, 0x0D, 0x08 },  // LDA $080D
-    { 0xAD, 0x1D, 0x08 },  // LDA $081D
-    { 0xAD, 0x2D, 0x08 },  // LDA $082D
-    { 0x0C, 0x0D, 0x08 },  // NOP $080D
-    { 0x0C, 0x1D, 0x08 },  // NOP $081D
-    { 0x0C, 0x2D, 0x08 }   // NOP $082D
-  };
-  for(uInt32 i = 0; i < 6; ++i)
-    if(searchForBytes(image.get(), size, signature[i], 3, 1))
-      return true;
-
-  return false;
+  return hits[size_t(Sig::X07)];
 }
@@ -21,6 +21,8 @@
 class Cartridge;
 class Properties;
 
+#include <bitset>
+
 #include "Bankswitch.hxx"
 #include "bspf.hxx"
 #include "Settings.hxx"
@@ -59,6 +61,16 @@ class CartDetector
     */
     static Bankswitch::Type autodetectType(const ByteBuffer& image, uInt32 size);
 
+  private:
+    // The types of cartridge indicated by signatures which are searched
+    // for in the whole ROM image
+    enum class Sig : uInt8 {
+      F8, _0840, _3E, _3EPlus, _3F, BUS, CDF, CTY, CV, DASH, DPCplus,
+      E0, E7, E78K, EF, FE, SB, UA, X07,
+      NumSigs
+    };
+    using SignatureHits = std::bitset<size_t(Sig::NumSigs)>;
+
   private:
     /**
       Create a cartridge from a multi-cart image pointer; internally this
@@ -109,6 +121,17 @@ class CartDetector
                                const uInt8* signature, uInt32 sigsize,
                                uInt32 minhits);
 
+    /**
+      Search the whole image for the signatures of all Sig types at once,
+      in a single pass over the image.
+
+      @param image  A pointer to the ROM image
+      @param size   The size of the ROM image
+
+      @return  The types whose signatures were found often enough
+    */
+    static SignatureHits scanSignatures(const ByteBuffer& image, uInt32 size);
+
     /**
       Returns true if the image is probably a SuperChip (128 bytes RAM)
       Note: should be called only on ROMs with size multiple of 4K
@@ -123,22 +146,22 @@ class CartDetector
     /**
       Returns true if the image is probably a 0840 bankswitching cartridge
     */
-    static bool isProbably0840(const ByteBuffer& image, uInt32 size);
+    static bool isProbably0840(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a 3E bankswitching cartridge
     */
-    static bool isProbably3E(const ByteBuffer& image, uInt32 size);
+    static bool isProbably3E(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a 3E+ bankswitching cartridge
     */
-    static bool isProbably3EPlus(const ByteBuffer& image, uInt32 size);
+    static bool isProbably3EPlus(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a 3F bankswitching cartridge
     */
-    static bool isProbably3F(const ByteBuffer& image, uInt32 size);
+    static bool isProbably3F(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a 4A50 bankswitching cartridge
@@ -158,22 +181,22 @@ class CartDetector
     /**
       Returns true if the image is probably a BUS bankswitching cartridge
     */
-    static bool isProbablyBUS(const ByteBuffer& image, uInt32 size);
+    static bool isProbablyBUS(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a CDF bankswitching cartridge
     */
-    static bool isProbablyCDF(const ByteBuffer& image, uInt32 size);
+    static bool isProbablyCDF(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a CTY bankswitching cartridge
     */
-    static bool isProbablyCTY(const ByteBuffer& image, uInt32 size);
+    static bool isProbablyCTY(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a CV bankswitching cartridge
     */
-    static bool isProbablyCV(const ByteBuffer& image, uInt32 size);
+    static bool isProbablyCV(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a CV+ bankswitching cartridge
@@ -183,7 +206,7 @@ class CartDetector
     /**
       Returns true if the image is probably a DASH bankswitching cartridge
     */
-    static bool isProbablyDASH(const ByteBuffer& image, uInt32 size);
+    static bool isProbablyDASH(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a DF/DFSC bankswitching cartridge
@@ -193,27 +216,28 @@ class CartDetector
     /**
       Returns true if the image is probably a DPC+ bankswitching cartridge
     */
-    static bool isProbablyDPCplus(const ByteBuffer& image, uInt32 size);
+    static bool isProbablyDPCplus(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a E0 bankswitching cartridge
     */
-    static bool isProbablyE0(const ByteBuffer& image, uInt32 size);
+    static bool isProbablyE0(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a E7 bankswitching cartridge
     */
-    static bool isProbablyE7(const ByteBuffer& image, uInt32 size);
+    static bool isProbablyE7(const SignatureHits& hits);
 
     /**
     Returns true if the image is probably a E78K bankswitching cartridge
     */
-    static bool isProbablyE78K(const ByteBuffer& image, uInt32 size);
+    static bool isProbablyE78K(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably an EF/EFSC bankswitching cartridge
     */
-    static bool isProbablyEF(const ByteBuffer& image, uInt32 size, Bankswitch::Type& type);
+    static bool isProbablyEF(const ByteBuffer& image, uInt32 size,
+                             const SignatureHits& hits, Bankswitch::Type& type);
 
     /**
       Returns true if the image is probably an F6 bankswitching cartridge
@@ -228,7 +252,7 @@ class CartDetector
     /**
       Returns true if the image is probably an FE bankswitching cartridge
     */
-    static bool isProbablyFE(const ByteBuffer& image, uInt32 size);
+    static bool isProbablyFE(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a MDM bankswitching cartridge
@@ -238,17 +262,17 @@ class CartDetector
     /**
       Returns true if the image is probably a SB bankswitching cartridge
     */
-    static bool isProbablySB(const ByteBuffer& image, uInt32 size);
+    static bool isProbablySB(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably a UA bankswitching cartridge
     */
-    static bool isProbablyUA(const ByteBuffer& image, uInt32 size);
+    static bool isProbablyUA(const SignatureHits& hits);
 
     /**
       Returns true if the image is probably an X07 bankswitching cartridge
     */
-    static bool isProbablyX07(const ByteBuffer& image, uInt32 size);
+    static bool isProbablyX07(const SignatureHits& hits);
 
   private:
     // Following constructors and assignment operators not supported
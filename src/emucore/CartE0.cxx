@@ -23,8 +23,8 @@ CartridgeE0::CartridgeE0(const ByteBuffer& image, uInt32 size,
                          const string& md5, const Settings& settings)
   : Cartridge(settings, md5)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image.get(), std::min(8192u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, 8192);
   createCodeAccessBase(8192);
 }
 
@@ -55,6 +55,7 @@ void CartridgeE0::install(System& system)
   mySystem = &system;
 
   System::PageAccess access(this, System::PageAccessType::READ);
+  access.useDirectDispatch<CartridgeE0>();
 
   // Set the page acessing methods for the first part of the last segment
   for(uInt16 addr = 0x1C00; addr < (0x1FE0U & ~System::PAGE_MASK);
@@ -140,6 +141,7 @@ void CartridgeE0::segmentZero(uInt16 slice)
 
   // Setup the page access methods for the current bank
   System::PageAccess access(this, System::PageAccessType::READ);
+  access.useDirectDispatch<CartridgeE0>();
 
   for(uInt16 addr = 0x1000; addr < 0x1400; addr += System::PAGE_SIZE)
   {
@@ -161,6 +163,7 @@ void CartridgeE0::segmentOne(uInt16 slice)
 
   // Setup the page access methods for the current bank
   System::PageAccess access(this, System::PageAccessType::READ);
+  access.useDirectDispatch<CartridgeE0>();
 
   for(uInt16 addr = 0x1400; addr < 0x1800; addr += System::PAGE_SIZE)
   {
@@ -182,6 +185,7 @@ void CartridgeE0::segmentTwo(uInt16 slice)
 
   // Setup the page access methods for the current bank
   System::PageAccess access(this, System::PageAccessType::READ);
+  access.useDirectDispatch<CartridgeE0>();
 
   for(uInt16 addr = 0x1800; addr < 0x1C00; addr += System::PAGE_SIZE)
   {
@@ -196,6 +200,7 @@ void CartridgeE0::segmentTwo(uInt16 slice)
 bool CartridgeE0::patch(uInt16 address, uInt8 value)
 {
   address &= 0x0FFF;
+  myImage = privateImage();
   myImage[(myCurrentSlice[address >> 10] << 10) + (address & 0x03FF)] = value;
   return true;
 }
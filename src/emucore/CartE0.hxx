@@ -178,8 +178,8 @@ class CartridgeE0 : public Cartridge
     // Indicates the slice mapped into each of the four segments
     uInt16 myCurrentSlice[4];
 
-    // The 8K ROM image of the cartridge
-    uInt8 myImage[8192];
+    // The 8K ROM image of the cartridge, shared with all carts running it
+    uInt8* myImage;
 
   private:
     // Following constructors and assignment operators not supported
@@ -151,8 +151,8 @@ class CartridgeEF : public Cartridge
     bool poke(uInt16 address, uInt8 value) override;
 
   private:
-    // The 64K ROM image of the cartridge
-    uInt8 myImage[65536];
+    // The 64K ROM image of the cartridge, shared with all carts running it
+    uInt8* myImage;
 
     // Indicates the offset into the ROM image (aligns to current bank)
     uInt16 myBankOffset;
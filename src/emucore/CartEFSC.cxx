@@ -24,8 +24,8 @@ CartridgeEFSC::CartridgeEFSC(const ByteBuffer& image, uInt32 size,
   : Cartridge(settings, md5),
     myBankOffset(0)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image.get(), std::min(65536u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, 65536);
   createCodeAccessBase(65536);
 }
 
@@ -44,6 +44,10 @@ void CartridgeEFSC::install(System& system)
 {
   mySystem = &system;
 
+  // Create the page access methods of all banks
+  createBankPages(System::PageAccess(this, System::PageAccessType::READ),
+                  myImage, bankCount(), 0x1100, 0x1FE0);
+
   System::PageAccess access(this, System::PageAccessType::READ);
 
   // Set the page accessing method for the RAM writing pages
@@ -121,24 +125,9 @@ bool CartridgeEFSC::bank(uInt16 bank)
   // Remember what bank we're in
   myBankOffset = bank << 12;
 
-  System::PageAccess access(this, System::PageAccessType::READ);
-
-  // Set the page accessing methods for the hot spots
-  for(uInt16 addr = (0x1FE0 & ~System::PAGE_MASK); addr < 0x2000;
-      addr += System::PAGE_SIZE)
-  {
-    access.codeAccessBase = &myCodeAccessBase[myBankOffset + (addr & 0x0FFF)];
-    mySystem->setPageAccess(addr, access);
-  }
-
   // Setup the page access methods for the current bank
-  for(uInt16 addr = 0x1100; addr < (0x1FE0U & ~System::PAGE_MASK);
-      addr += System::PAGE_SIZE)
-  {
-    access.directPeekBase = &myImage[myBankOffset + (addr & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[myBankOffset + (addr & 0x0FFF)];
-    mySystem->setPageAccess(addr, access);
-  }
+  installBankPages(bank);
+
   return myBankChanged = true;
 }
 
@@ -167,7 +156,10 @@ bool CartridgeEFSC::patch(uInt16 address, uInt8 value)
     myRAM[address & 0x007F] = value;
   }
   else
+  {
+    myImage = privateImage();
     myImage[myBankOffset + address] = value;
+  }
 
   return myBankChanged = true;
 }
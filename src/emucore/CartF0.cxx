@@ -24,8 +24,8 @@ CartridgeF0::CartridgeF0(const ByteBuffer& image, uInt32 size,
   : Cartridge(settings, md5),
     myBankOffset(0)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image.get(), std::min(65536u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, 65536);
   createCodeAccessBase(65536);
 }
 
@@ -123,6 +123,7 @@ uInt16 CartridgeF0::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeF0::patch(uInt16 address, uInt8 value)
 {
+  myImage = privateImage();
   myImage[myBankOffset + (address & 0x0FFF)] = value;
   return myBankChanged = true;
 }
@@ -157,8 +157,8 @@ class CartridgeF0 : public Cartridge
     void incbank();
 
   private:
-    // The 64K ROM image of the cartridge
-    uInt8 myImage[65536];
+    // The 64K ROM image of the cartridge, shared with all carts running it
+    uInt8* myImage;
 
     // Indicates the offset into the ROM image (aligns to current bank)
     uInt16 myBankOffset;
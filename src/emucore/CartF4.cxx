@@ -25,8 +25,8 @@ CartridgeF4::CartridgeF4(const ByteBuffer& image, uInt32 size,
   : Cartridge(settings, md5),
     myBankOffset(0)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image.get(), std::min(32768u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, 32768);
   createCodeAccessBase(32768);
 }
 
@@ -43,6 +43,11 @@ void CartridgeF4::install(System& system)
 {
   mySystem = &system;
 
+  // Create the page access methods of all banks
+  System::PageAccess access(this, System::PageAccessType::READ);
+  access.useDirectDispatch<CartridgeF4>();
+  createBankPages(access, myImage, bankCount(), 0x1000, 0x1FF4);
+
   // Install pages for the startup bank
   bank(startBank());
 }
@@ -83,24 +88,9 @@ bool CartridgeF4::bank(uInt16 bank)
   // Remember what bank we're in
   myBankOffset = bank << 12;
 
-  System::PageAccess access(this, System::PageAccessType::READ);
-
-  // Set the page accessing methods for the hot spots
-  for(uInt16 addr = (0x1FF4 & ~System::PAGE_MASK); addr < 0x2000;
-      addr += System::PAGE_SIZE)
-  {
-    access.codeAccessBase = &myCodeAccessBase[myBankOffset + (addr & 0x0FFF)];
-    mySystem->setPageAccess(addr, access);
-  }
-
   // Setup the page access methods for the current bank
-  for(uInt16 addr = 0x1000; addr < (0x1FF4U & ~System::PAGE_MASK);
-      addr += System::PAGE_SIZE)
-  {
-    access.directPeekBase = &myImage[myBankOffset + (addr & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[myBankOffset + (addr & 0x0FFF)];
-    mySystem->setPageAccess(addr, access);
-  }
+  installBankPages(bank);
+
   return myBankChanged = true;
 }
 
@@ -119,6 +109,7 @@ uInt16 CartridgeF4::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeF4::patch(uInt16 address, uInt8 value)
 {
+  myImage = privateImage();
   myImage[myBankOffset + (address & 0x0FFF)] = value;
   return myBankChanged = true;
 }
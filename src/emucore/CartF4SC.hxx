@@ -98,6 +98,14 @@ class CartridgeF4SC : public Cartridge
     */
     const uInt8* getImage(uInt32& size) const override;
 
+    /**
+      Access the internal RAM of this cartridge.
+
+      @param size  Set to the size of the internal RAM
+      @return  A pointer to the internal RAM
+    */
+    uInt8* getRAM(uInt32& size) override { size = sizeof(myRAM);  return myRAM; }
+
     /**
       Save the current state of this cart to the given Serializer.
 
@@ -151,8 +159,8 @@ class CartridgeF4SC : public Cartridge
     bool poke(uInt16 address, uInt8 value) override;
 
   private:
-    // The 32K ROM image of the cartridge
-    uInt8 myImage[32768];
+    // The 32K ROM image of the cartridge, shared with all carts running it
+    uInt8* myImage;
 
     // The 128 bytes of RAM
     uInt8 myRAM[128];
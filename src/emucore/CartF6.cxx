@@ -24,8 +24,8 @@ CartridgeF6::CartridgeF6(const ByteBuffer& image, uInt32 size,
   : Cartridge(settings, md5),
     myBankOffset(0)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image.get(), std::min(16384u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, 16384);
   createCodeAccessBase(16384);
 }
 
@@ -42,6 +42,11 @@ void CartridgeF6::install(System& system)
 {
   mySystem = &system;
 
+  // Create the page access methods of all banks
+  System::PageAccess access(this, System::PageAccessType::READ);
+  access.useDirectDispatch<CartridgeF6>();
+  createBankPages(access, myImage, bankCount(), 0x1000, 0x1FF6);
+
   // Upon install we'll setup the startup bank
   bank(startBank());
 }
@@ -123,24 +128,9 @@ bool CartridgeF6::bank(uInt16 bank)
   // Remember what bank we're in
   myBankOffset = bank << 12;
 
-  System::PageAccess access(this, System::PageAccessType::READ);
-
-  // Set the page accessing methods for the hot spots
-  for(uInt16 addr = (0x1FF6 & ~System::PAGE_MASK); addr < 0x2000;
-      addr += System::PAGE_SIZE)
-  {
-    access.codeAccessBase = &myCodeAccessBase[myBankOffset + (addr & 0x0FFF)];
-    mySystem->setPageAccess(addr, access);
-  }
-
   // Setup the page access methods for the current bank
-  for(uInt16 addr = 0x1000; addr < (0x1FF6U & ~System::PAGE_MASK);
-      addr += System::PAGE_SIZE)
-  {
-    access.directPeekBase = &myImage[myBankOffset + (addr & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[myBankOffset + (addr & 0x0FFF)];
-    mySystem->setPageAccess(addr, access);
-  }
+  installBankPages(bank);
+
   return myBankChanged = true;
 }
 
@@ -159,6 +149,7 @@ uInt16 CartridgeF6::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeF6::patch(uInt16 address, uInt8 value)
 {
+  myImage = privateImage();
   myImage[myBankOffset + (address & 0x0FFF)] = value;
   return myBankChanged = true;
 }
@@ -150,8 +150,8 @@ class CartridgeF6 : public Cartridge
     bool poke(uInt16 address, uInt8 value) override;
 
   private:
-    // The 16K ROM image of the cartridge
-    uInt8 myImage[16384];
+    // The 16K ROM image of the cartridge, shared with all carts running it
+    uInt8* myImage;
 
     // Indicates the offset into the ROM image (aligns to current bank)
     uInt16 myBankOffset;
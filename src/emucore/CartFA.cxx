@@ -24,8 +24,8 @@ CartridgeFA::CartridgeFA(const ByteBuffer& image, uInt32 size,
   : Cartridge(settings, md5),
     myBankOffset(0)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image.get(), std::min(12288u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, 12288);
   createCodeAccessBase(12288);
 }
 
@@ -186,7 +186,10 @@ bool CartridgeFA::patch(uInt16 address, uInt8 value)
     myRAM[address & 0x00FF] = value;
   }
   else
+  {
+    myImage = privateImage();
     myImage[myBankOffset + address] = value;
+  }
 
   return myBankChanged = true;
 }
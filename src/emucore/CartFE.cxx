@@ -26,8 +26,8 @@ CartridgeFE::CartridgeFE(const ByteBuffer& image, uInt32 size,
     myBankOffset(0),
     myLastAccessWasFE(false)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image.get(), std::min(8192u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, 8192);
   createCodeAccessBase(8192);
 }
 
@@ -124,6 +124,7 @@ uInt16 CartridgeFE::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeFE::patch(uInt16 address, uInt8 value)
 {
+  myImage = privateImage();
   myImage[myBankOffset + (address & 0x0FFF)] = value;
   return myBankChanged = true;
 }
@@ -200,8 +200,8 @@ class CartridgeFE : public Cartridge
     void checkBankSwitch(uInt16 address, uInt8 value);
 
   private:
-    // The 8K ROM image of the cartridge
-    uInt8 myImage[8192];
+    // The 8K ROM image of the cartridge, shared with all carts running it
+    uInt8* myImage;
 
     // Indicates the offset into the ROM image (aligns to current bank)
     uInt16 myBankOffset;
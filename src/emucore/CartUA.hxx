@@ -151,8 +151,8 @@ class CartridgeUA : public Cartridge
     bool poke(uInt16 address, uInt8 value) override;
 
   private:
-    // The 8K ROM image of the cartridge
-    uInt8 myImage[8192];
+    // The 8K ROM image of the cartridge, shared with all carts running it
+    uInt8* myImage;
 
     // Previous Device's page access
     System::PageAccess myHotSpotPageAccess[2];
@@ -26,8 +26,8 @@ CartridgeX07::CartridgeX07(const ByteBuffer& image, uInt32 size,
   : Cartridge(settings, md5),
     myCurrentBank(0)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image.get(), std::min(65536u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, 65536);
   createCodeAccessBase(65536);
 }
 
@@ -137,6 +137,7 @@ uInt16 CartridgeX07::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeX07::patch(uInt16 address, uInt8 value)
 {
+  myImage = privateImage();
   myImage[(myCurrentBank << 12) + (address & 0x0FFF)] = value;
   return myBankChanged = true;
 }
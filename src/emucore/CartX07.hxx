@@ -160,8 +160,8 @@ class CartridgeX07 : public Cartridge
     bool poke(uInt16 address, uInt8 value) override;
 
   private:
-    // The 64K ROM image of the cartridge
-    uInt8 myImage[65536];
+    // The 64K ROM image of the cartridge, shared with all carts running it
+    uInt8* myImage;
 
     // Indicates which bank is currently active
     uInt16 myCurrentBank;
@@ -17,6 +17,7 @@
 
 #include <cassert>
 #include <stdexcept>
+#include <thread>
 
 #include "AtariVox.hxx"
 #include "Booster.hxx"
@@ -50,14 +51,18 @@
 #include "FrameBuffer.hxx"
 #include "TIASurface.hxx"
 #include "OSystem.hxx"
+#include "DetectionCache.hxx"
+#include "HeadlessConsole.hxx"
 #include "Serializable.hxx"
 #include "Serializer.hxx"
+#include "StateProfile.hxx"
 #include "TimerManager.hxx"
 #include "Version.hxx"
 #include "TIAConstants.hxx"
 #include "FrameLayout.hxx"
 #include "AudioQueue.hxx"
 #include "AudioSettings.hxx"
+#include "InputMovie.hxx"
 #include "frame-manager/FrameManager.hxx"
 #include "frame-manager/FrameLayoutDetector.hxx"
 #include "frame-manager/YStartDetector.hxx"
@@ -81,7 +86,9 @@ Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
   : myOSystem(osystem),
     myEvent(osystem.eventHandler().event()),
     myProperties(props),
+    myArena(Common::Arena::sizeFor<System, M6502, M6532, TIA, FrameManager, Switches>()),
     myCart(std::move(cart)),
+    myInputMoviePlayback(false),
     myDisplayFormat(""),  // Unknown TV format @ start
     myCurrentFormat(0),   // Unknown format @ start,
     myAutodetectedYstart(0),
@@ -94,12 +101,13 @@ Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
   // Load user-defined palette for this ROM
   loadUserPalette();
 
-  // Create subsystems for the console
-  my6502 = make_unique<M6502>(myOSystem.settings());
-  myRiot = make_unique<M6532>(*this, myOSystem.settings());
-  myTIA  = make_unique<TIA>(*this, [this]() { return timing(); },  myOSystem.settings());
-  myFrameManager = make_unique<FrameManager>();
-  mySwitches = make_unique<Switches>(myEvent, myProperties, myOSystem.settings());
+  // Create subsystems for the console; the devices used on every cycle
+  // come first, so that they share one contiguous region of memory
+  my6502 = myArena.create<M6502>(myOSystem.settings());
+  myRiot = myArena.create<M6532>(*this, myOSystem.settings());
+  myTIA  = myArena.create<TIA>(*this, [this]() { return timing(); },  myOSystem.settings());
+  myFrameManager = myArena.create<FrameManager>();
+  mySwitches = myArena.create<Switches>(myEvent, myProperties, myOSystem.settings());
 
   myTIA->setFrameManager(myFrameManager.get());
 
@@ -107,7 +115,7 @@ Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
   myOSystem.random().initSeed(static_cast<uInt32>(TimerManager::getTicks()));
 
   // Construct the system and components
-  mySystem = make_unique<System>(myOSystem.random(), *my6502, *myRiot, *myTIA, *myCart);
+  mySystem = myArena.create<System>(myOSystem.random(), *my6502, *myRiot, *myTIA, *myCart);
 
   // The real controllers for this console will be added later
   // For now, we just add dummy joystick controllers, since autodetection
@@ -122,13 +130,27 @@ Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
     return startbank == EmptyString ? -1 : atoi(startbank.c_str());
   });
 
+  // Run the ARM code (if any) in the fast mode for ROMs known to work with it
+  myCart->setThumbFastMode(myProperties.get(PropType::Cart_ThumbFast) == "YES");
+
   // We can only initialize after all the devices/components have been created
   mySystem->initialize();
 
+#ifdef DEBUGGER_SUPPORT
+  // The disassembly is only improved by the accesses in developer mode
+  mySystem->enableAccessFlags(myOSystem.settings().getBool("dev.settings"));
+#endif
+
   // Auto-detect NTSC/PAL mode if it's requested
   string autodetected = "";
   myDisplayFormat = myProperties.get(PropType::Display_Format);
 
+  const bool detectFormat = myDisplayFormat == "AUTO" || myOSystem.settings().getBool("rominfo");
+  const bool detectYStart = atoi(myProperties.get(PropType::Display_YStart).c_str()) == 0;
+
+  // Autodetection runs in the background while the controllers are set up
+  startAutodetection(detectFormat, detectYStart);
+
   // Add the real controllers for this system
   // This must be done before the debugger is initialized
   const string& md5 = myProperties.get(PropType::Cart_MD5);
@@ -138,7 +160,9 @@ Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
   myOSystem.sound().mute(1);
   myOSystem.frameBuffer().clear();
 
-  if(myDisplayFormat == "AUTO" || myOSystem.settings().getBool("rominfo"))
+  finishAutodetection();
+
+  if(detectFormat)
   {
     autodetectFrameLayout();
 
@@ -150,7 +174,7 @@ Console::Console(OSystem& osystem, unique_ptr<Cartridge>& cart,
     }
   }
 
-  if (atoi(myProperties.get(PropType::Display_YStart).c_str()) == 0) {
+  if (detectYStart) {
     autodetectYStart();
   }
 
@@ -227,9 +251,101 @@ Console::~Console()
   myOSystem.sound().close();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Console::startAutodetection(bool detectFormat, bool detectYStart)
+{
+  // Supercharger loads depend on the 'fastscbios' setting, which is changed
+  // for autodetection, so they are left to the serial code
+  if(std::thread::hardware_concurrency() < 2 || myCart->name() == "CartridgeAR")
+    return;
+
+  const string& md5 = myProperties.get(PropType::Cart_MD5);
+  DetectionCache& cache = myOSystem.detectionCache();
+
+  string format = myDisplayFormat;
+  const bool layoutKnown = !detectFormat || cache.findFormat(md5, format);
+
+  bool yStartNeeded[2] = { false, false };
+  if(detectYStart)
+  {
+    for(FrameLayout layout: { FrameLayout::ntsc, FrameLayout::pal })
+    {
+      uInt32 ystart;
+      const bool isLayout = (format == "PAL") == (layout == FrameLayout::pal);
+
+      yStartNeeded[uInt32(layout)] = (!layoutKnown || isLayout) &&
+          !cache.findYStart(md5, layout, ystart);
+    }
+  }
+
+  if(layoutKnown && !yStartNeeded[0] && !yStartNeeded[1])
+    return;
+
+  // Every step runs on a console of its own, with dummy joysticks as in
+  // the serial detection, and the cart type we already know
+  uInt32 size = 0;
+  const uInt8* image = myCart->getImage(size);
+  auto rom = make_shared<ByteBuffer>(make_unique<uInt8[]>(size));
+  std::copy_n(image, size, rom->get());
+
+  Properties props(myProperties);
+  props.set(PropType::Cart_Type, myCart->detectedType());
+  props.set(PropType::Controller_Left, "JOYSTICK");
+  props.set(PropType::Controller_Right, "JOYSTICK");
+  // Keep the headless consoles from running detection by themselves
+  props.set(PropType::Display_Format, "NTSC");
+  props.set(PropType::Display_YStart, "1");
+
+  Settings& settings = myOSystem.settings();
+  const auto console = [rom, size, props, &settings] {
+    return make_unique<HeadlessConsole>(*rom, size, settings, props);
+  };
+
+  if(!layoutKnown)
+    myLayoutDetection = std::async(std::launch::async, [console] {
+      return console()->detectLayout();
+    });
+
+  for(FrameLayout layout: { FrameLayout::ntsc, FrameLayout::pal })
+    if(yStartNeeded[uInt32(layout)])
+      myYStartDetection[uInt32(layout)] = std::async(std::launch::async, [console, layout] {
+        return console()->detectYStart(layout);
+      });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Console::finishAutodetection()
+{
+  const string& md5 = myProperties.get(PropType::Cart_MD5);
+  DetectionCache& cache = myOSystem.detectionCache();
+
+  // Steps which failed are simply run again by the serial code
+  try
+  {
+    if(myLayoutDetection.valid())
+      cache.insertFormat(md5, myLayoutDetection.get() == FrameLayout::pal ? "PAL" : "NTSC");
+  }
+  catch(const std::exception&) { }
+
+  for(FrameLayout layout: { FrameLayout::ntsc, FrameLayout::pal })
+  {
+    try
+    {
+      if(myYStartDetection[uInt32(layout)].valid())
+        cache.insertYStart(md5, layout, myYStartDetection[uInt32(layout)].get());
+    }
+    catch(const std::exception&) { }
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::autodetectFrameLayout(bool reset)
 {
+  // Use the result of an earlier detection, if there is one
+  const string& md5 = myProperties.get(PropType::Cart_MD5);
+  if(myOSystem.detectionCache().findFormat(md5, myDisplayFormat))
+    return;
+
   // Run the TIA, looking for PAL scanline patterns
   // We turn off the SuperCharger progress bars, otherwise the SC BIOS
   // will take over 250 frames!
@@ -245,11 +361,14 @@ void Console::autodetectFrameLayout(bool reset)
     myRiot->update();
   }
 
-  for(int i = 0; i < 60; ++i) myTIA->update();
+  // Stop as soon as the layout is clear
+  for(int i = 0; i < 60 && !frameLayoutDetector.isConfident(); ++i)
+    myTIA->update();
 
   myTIA->setFrameManager(myFrameManager.get());
 
   myDisplayFormat = frameLayoutDetector.detectedLayout() == FrameLayout::pal ? "PAL" : "NTSC";
+  myOSystem.detectionCache().insertFormat(md5, myDisplayFormat);
 
   // Don't forget to reset the SC progress bars again
   myOSystem.settings().setValue("fastscbios", fastscbios);
@@ -258,6 +377,23 @@ void Console::autodetectFrameLayout(bool reset)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::redetectFrameLayout()
 {
+  // The emulation state only needs to be preserved if detection has to run
+  const string& md5 = myProperties.get(PropType::Cart_MD5);
+  string format;
+  if(myOSystem.detectionCache().findFormat(md5, format))
+  {
+    uInt32 ystart;
+    const FrameLayout layout = format == "PAL" ? FrameLayout::pal : FrameLayout::ntsc;
+
+    if(!myYStartAutodetected ||
+       myOSystem.detectionCache().findYStart(md5, layout, ystart))
+    {
+      autodetectFrameLayout(false);
+      if (myYStartAutodetected) autodetectYStart(false);
+      return;
+    }
+  }
+
   Serializer s;
 
   myOSystem.sound().close();
@@ -273,6 +409,12 @@ void Console::redetectFrameLayout()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::autodetectYStart(bool reset)
 {
+  // Use the result of an earlier detection, if there is one
+  const string& md5 = myProperties.get(PropType::Cart_MD5);
+  const FrameLayout layout = myDisplayFormat == "PAL" ? FrameLayout::pal : FrameLayout::ntsc;
+  if(myOSystem.detectionCache().findYStart(md5, layout, myAutodetectedYstart))
+    return;
+
   // We turn off the SuperCharger progress bars, otherwise the SC BIOS
   // will take over 250 frames!
   // The 'fastscbios' option must be changed before the system is reset
@@ -280,7 +422,7 @@ void Console::autodetectYStart(bool reset)
   myOSystem.settings().setValue("fastscbios", true);
 
   YStartDetector ystartDetector;
-  ystartDetector.setLayout(myDisplayFormat == "PAL" ? FrameLayout::pal : FrameLayout::ntsc);
+  ystartDetector.setLayout(layout);
   myTIA->setFrameManager(&ystartDetector);
 
   if (reset) {
@@ -288,11 +430,13 @@ void Console::autodetectYStart(bool reset)
     myRiot->update();
   }
 
-  for (int i = 0; i < 80; i++) myTIA->update();
+  // Stop as soon as ystart is stable
+  for (int i = 0; i < 80 && !ystartDetector.isConfident(); i++) myTIA->update();
 
   myTIA->setFrameManager(myFrameManager.get());
 
   myAutodetectedYstart = ystartDetector.detectedYStart() - YSTART_EXTRA;
+  myOSystem.detectionCache().insertYStart(md5, layout, myAutodetectedYstart);
 
   // Don't forget to reset the SC progress bars again
   myOSystem.settings().setValue("fastscbios", fastscbios);
@@ -301,6 +445,15 @@ void Console::autodetectYStart(bool reset)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::redetectYStart()
 {
+  // The emulation state only needs to be preserved if detection has to run
+  uInt32 ystart;
+  if(myOSystem.detectionCache().findYStart(myProperties.get(PropType::Cart_MD5),
+      myDisplayFormat == "PAL" ? FrameLayout::pal : FrameLayout::ntsc, ystart))
+  {
+    myAutodetectedYstart = ystart;
+    return;
+  }
+
   Serializer s;
 
   myOSystem.sound().close();
@@ -318,12 +471,13 @@ bool Console::save(Serializer& out) const
   try
   {
     // First save state for the system
-    if(!mySystem->save(out))
+    if(!StateProfile::save(*mySystem, out, "System"))
       return false;
 
     // Now save the console controllers and switches
-    if(!(myLeftControl->save(out) && myRightControl->save(out) &&
-         mySwitches->save(out)))
+    if(!(StateProfile::save(*myLeftControl, out, "LeftController") &&
+         StateProfile::save(*myRightControl, out, "RightController") &&
+         StateProfile::save(*mySwitches, out, "Switches")))
       return false;
   }
   catch(...)
@@ -341,12 +495,13 @@ bool Console::load(Serializer& in)
   try
   {
     // First load state for the system
-    if(!mySystem->load(in))
+    if(!StateProfile::load(*mySystem, in, "System"))
       return false;
 
     // Then load the console controllers and switches
-    if(!(myLeftControl->load(in) && myRightControl->load(in) &&
-         mySwitches->load(in)))
+    if(!(StateProfile::load(*myLeftControl, in, "LeftController") &&
+         StateProfile::load(*myRightControl, in, "RightController") &&
+         StateProfile::load(*mySwitches, in, "Switches")))
       return false;
   }
   catch(...)
@@ -549,6 +704,17 @@ void Console::setPalette(const string& type)
     myTIA->enableFixedColors(true);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uInt32* Console::standardPalette(ConsoleTiming timing)
+{
+  switch(timing)
+  {
+    case ConsoleTiming::pal:    return ourPALPalette;
+    case ConsoleTiming::secam:  return ourSECAMPalette;
+    default:                    return ourNTSCPalette;
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::togglePhosphor()
 {
@@ -643,7 +809,7 @@ void Console::initializeAudio()
     .updatePlaybackPeriod(myAudioSettings.fragmentSize())
     .updateAudioQueueExtraFragments(myAudioSettings.bufferSize())
     .updateAudioQueueHeadroom(myAudioSettings.headroom())
-    .updateSpeedFactor(myOSystem.settings().getFloat("speed"));
+    .updateSpeedFactor(float(myOSystem.settings().getFloat("speed") * myOSystem.speedCorrection()));
 
   createAudioQueue();
   myTIA->setAudioQueue(myAudioQueue);
@@ -651,6 +817,12 @@ void Console::initializeAudio()
   myOSystem.sound().open(myAudioQueue, &myEmulationTiming);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double Console::audioQueueFill() const
+{
+  return myAudioQueue ? double(myAudioQueue->size()) / myAudioQueue->capacity() : 0;
+}
+
 /* Original frying research and code by Fred Quimby.
    I've tried the following variations on this code:
    - Both OR and Exclusive OR instead of AND. This generally crashes the game
@@ -783,13 +955,41 @@ void Console::createAudioQueue()
   bool useStereo = myOSystem.settings().getBool(AudioSettings::SETTING_STEREO)
     || myProperties.get(PropType::Cart_Sound) == "STEREO";
 
-  myAudioQueue = make_shared<AudioQueue>(
+  // The sound driver has been closed, so the queue may be reconfigured
+  myAudioQueue = myOSystem.audioQueue(
     myEmulationTiming.audioFragmentSize(),
     myEmulationTiming.audioQueueCapacity(),
     useStereo
   );
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Console::setInputMovie(const shared_ptr<InputMovie>& movie, bool playback)
+{
+  myInputMovie = movie;
+  myInputMoviePlayback = playback;
+
+  frameComplete();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Console::frameComplete() const
+{
+  if(!myInputMovie)
+    return;
+
+  if(myInputMoviePlayback)
+  {
+    // At the end of the movie, the host input takes over again
+    if(myInputMovie->playFrame())
+      myInputMovie->applyInputs(myOSystem.eventHandler().event());
+  }
+  else
+    myInputMovie->recordFrame(myEvent);
+
+  myRiot->update();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::setControllers(const string& romMd5)
 {
@@ -29,8 +29,12 @@ class CompuMate;
 class Debugger;
 class AudioQueue;
 class AudioSettings;
+class InputMovie;
+
+#include <future>
 
 #include "bspf.hxx"
+#include "Arena.hxx"
 #include "ConsoleIO.hxx"
 #include "Control.hxx"
 #include "Props.hxx"
@@ -38,6 +42,7 @@ class AudioSettings;
 #include "FrameBuffer.hxx"
 #include "Serializable.hxx"
 #include "EventHandlerConstants.hxx"
+#include "FrameLayout.hxx"
 #include "NTSCFilter.hxx"
 #include "EmulationTiming.hxx"
 #include "ConsoleTiming.hxx"
@@ -116,6 +121,27 @@ class Console : public Serializable, public ConsoleIO
     */
     Switches& switches() const override { return *mySwitches; }
 
+    /**
+      Record the inputs into a movie, or play them back from it, once per
+      frame.  Recording and playback start right away, with the inputs of
+      the current frame.
+
+      @param movie     The movie, or nullptr to return to normal input
+      @param playback  Whether to play back the movie, or record into it
+    */
+    void setInputMovie(const shared_ptr<InputMovie>& movie, bool playback);
+
+    /**
+      The movie the inputs are recorded into or played back from, if any.
+    */
+    const shared_ptr<InputMovie>& inputMovie() const { return myInputMovie; }
+
+    /**
+      Records or plays back the inputs of the next frame, if a movie is
+      active.
+    */
+    void frameComplete() const override;
+
     /**
       Get the 6502 based system used by the console to emulate the game
 
@@ -250,6 +276,11 @@ class Console : public Serializable, public ConsoleIO
     */
     void initializeAudio();
 
+    /**
+      The fill level of the audio queue (0 - 1).
+    */
+    double audioQueueFill() const;
+
     /**
       "Fry" the Atari (mangle memory/TIA contents)
     */
@@ -304,7 +335,28 @@ class Console : public Serializable, public ConsoleIO
      */
     void updateYStart(uInt32 ystart);
 
+    /**
+      The standard palette of the given TV format, as RGB values.  Only
+      the even entries are used by the TIA; the odd ones are only valid
+      once a console has been created.
+    */
+    static const uInt32* standardPalette(ConsoleTiming timing);
+
   private:
+    /**
+     * Start those autodetection steps which aren't cached yet in the
+     * background, each on a headless console of its own.  Without a known
+     * frame layout, ystart is detected for both layouts at once.
+     */
+    void startAutodetection(bool detectFormat, bool detectYStart);
+
+    /**
+     * Wait for the background autodetection and put its results into the
+     * detection cache, where autodetectFrameLayout() and autodetectYStart()
+     * find them.
+     */
+    void finishAutodetection();
+
     /**
      * Dry-run the emulation and detect the frame layout (PAL / NTSC).
      */
@@ -368,21 +420,25 @@ class Console : public Serializable, public ConsoleIO
     // Properties for the game
     Properties myProperties;
 
+    // The memory the core devices below are created in, next to each
+    // other; it must outlive them
+    Common::Arena myArena;
+
     // Pointer to the 6502 based system being emulated
-    unique_ptr<System> mySystem;
+    Common::Arena::Ptr<System> mySystem;
 
     // Pointer to the M6502 CPU
-    unique_ptr<M6502> my6502;
+    Common::Arena::Ptr<M6502> my6502;
 
     // Pointer to the 6532 (aka RIOT) (the debugger needs it)
     // A RIOT of my own! (...with apologies to The Clash...)
-    unique_ptr<M6532> myRiot;
+    Common::Arena::Ptr<M6532> myRiot;
 
     // Pointer to the TIA object
-    unique_ptr<TIA> myTIA;
+    Common::Arena::Ptr<TIA> myTIA;
 
     // The frame manager instance that is used during emulation
-    unique_ptr<AbstractFrameManager> myFrameManager;
+    Common::Arena::Ptr<AbstractFrameManager> myFrameManager;
 
     // The audio fragment queue that connects TIA and audio driver
     shared_ptr<AudioQueue> myAudioQueue;
@@ -391,7 +447,7 @@ class Console : public Serializable, public ConsoleIO
     unique_ptr<Cartridge> myCart;
 
     // Pointer to the switches on the front of the console
-    unique_ptr<Switches> mySwitches;
+    Common::Arena::Ptr<Switches> mySwitches;
 
     // Pointers to the left and right controllers
     unique_ptr<Controller> myLeftControl, myRightControl;
@@ -399,6 +455,10 @@ class Console : public Serializable, public ConsoleIO
     // Pointer to CompuMate handler (only used in CompuMate ROMs)
     shared_ptr<CompuMate> myCMHandler;
 
+    // The movie the inputs are recorded into or played back from, if any
+    shared_ptr<InputMovie> myInputMovie;
+    bool myInputMoviePlayback;
+
     // The currently defined display format (NTSC/PAL/SECAM)
     string myDisplayFormat;
 
@@ -414,6 +474,11 @@ class Console : public Serializable, public ConsoleIO
     // Is the TV format autodetected?
     bool myFormatAutodetected;
 
+    // Autodetection running in the background, while the console is set up
+    // (ystart for NTSC and PAL)
+    std::future<FrameLayout> myLayoutDetection;
+    std::future<uInt32> myYStartDetection[2];
+
     // Indicates whether an external palette was found and
     // successfully loaded
     bool myUserPaletteDefined;
@@ -0,0 +1,137 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <thread>
+
+#include "ConsoleBatch.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ConsoleBatch::ConsoleBatch(const Options& options)
+  : myOptions(options)
+{
+  myOptions.lines = BSPF::clamp(myOptions.lines, 1u, uInt32(TIAConstants::frameBufferHeight));
+  myOptions.downsampleX = BSPF::clamp(myOptions.downsampleX, 1u, uInt32(TIAConstants::H_PIXEL));
+  myOptions.downsampleY = BSPF::clamp(myOptions.downsampleY, 1u, myOptions.lines);
+
+  myWidth  = TIAConstants::H_PIXEL / myOptions.downsampleX;
+  myHeight = myOptions.lines / myOptions.downsampleY;
+
+  for(uInt32 i = 0; i < 256; ++i)
+  {
+    if(myOptions.palette)
+    {
+      // ITU-R BT.601 luma
+      const uInt32 rgb = myOptions.palette[i];
+      const uInt32 r = (rgb >> 16) & 0xff, g = (rgb >> 8) & 0xff, b = rgb & 0xff;
+      myLuminance[i] = uInt8((r * 299 + g * 587 + b * 114) / 1000);
+    }
+    else
+      myLuminance[i] = uInt8((i & 0x0e) * 255 / 0x0e);
+  }
+
+  const uInt32 threads = myOptions.threads > 0 ? myOptions.threads :
+    std::max(std::thread::hardware_concurrency(), 1u);
+  myThreadPool.setThreads(threads);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConsoleBatch::add(unique_ptr<HeadlessConsole> console)
+{
+  myConsoles.push_back(std::move(console));
+  myFailed.push_back(0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 ConsoleBatch::step(const HeadlessConsole::Input* inputs,
+                          uInt32 inputsPerConsole, uInt8* observations)
+{
+  // Each console is one job; the pool hands them out one at a time, so
+  // threads which get consoles with cheap frames simply take more of them
+  myThreadPool.run(size(), [&](uInt32 i) {
+    HeadlessConsole& console = *myConsoles[i];
+    if(!console.ok())
+      return;
+
+    const HeadlessConsole::Input* consoleInputs =
+      inputs ? inputs + i * inputsPerConsole : nullptr;
+    if(!console.step(consoleInputs, inputs ? inputsPerConsole : 0))
+    {
+      myFailed[i] = 1;
+      return;
+    }
+
+    if(observations)
+      observe(console, observations + i * observationSize());
+  });
+
+  uInt32 failed = 0;
+  for(uInt8 f: myFailed)
+    failed += f;
+
+  return failed;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConsoleBatch::reset()
+{
+  myThreadPool.run(size(), [&](uInt32 i) {
+    myConsoles[i]->reset();
+    myFailed[i] = 0;
+  });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConsoleBatch::observe(HeadlessConsole& console, uInt8* dst) const
+{
+  const uInt8* frame = console.frame();
+  const uInt32 dx = myOptions.downsampleX, dy = myOptions.downsampleY;
+  const uInt32 pitch = TIAConstants::H_PIXEL;
+
+  // Lines missing from short frames are black
+  const uInt32 lines = std::min(console.frameHeight(), myHeight * dy) / dy;
+
+  for(uInt32 y = 0; y < lines; ++y)
+  {
+    const uInt8* src = frame + y * dy * pitch;
+
+    if(!myOptions.grayscale)
+    {
+      for(uInt32 x = 0; x < myWidth; ++x)
+        *dst++ = src[x * dx];
+    }
+    else if(dx == 1 && dy == 1)
+    {
+      for(uInt32 x = 0; x < myWidth; ++x)
+        *dst++ = myLuminance[src[x]];
+    }
+    else
+    {
+      const uInt32 area = dx * dy;
+      for(uInt32 x = 0; x < myWidth; ++x, src += dx)
+      {
+        uInt32 sum = 0;
+        for(uInt32 j = 0; j < dy; ++j)
+          for(uInt32 i = 0; i < dx; ++i)
+            sum += myLuminance[src[j * pitch + i]];
+
+        *dst++ = uInt8(sum / area);
+      }
+    }
+  }
+
+  memset(dst, 0, (myHeight - lines) * myWidth);
+}
@@ -0,0 +1,127 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef CONSOLE_BATCH_HXX
+#define CONSOLE_BATCH_HXX
+
+#include "bspf.hxx"
+#include "HeadlessConsole.hxx"
+#include "ThreadPool.hxx"
+
+/**
+  Steps a batch of HeadlessConsoles together, as needed for vectorized
+  reinforcement learning environments.  A single call to step() emulates
+  one frame on each console with its own inputs, spread over a thread pool,
+  and writes the observations of all consoles into one caller-provided
+  buffer of 'size() x observationHeight() x observationWidth()' bytes.
+
+  The observations are converted directly from the indexed TIA frames,
+  without going through a TIASurface.  They are either the palette
+  indices, or grayscale values; either can be downsampled.  Grayscale
+  values are averaged over the downsampled area, palette indices are
+  simply taken from its top left pixel.
+
+  @author  Stephen Anthony
+*/
+class ConsoleBatch
+{
+  public:
+    struct Options {
+      // The number of scanlines used from each frame
+      uInt32 lines;
+      // Downsampling factors (1 to keep the full resolution)
+      uInt32 downsampleX, downsampleY;
+      // Convert to grayscale instead of returning palette indices
+      bool grayscale;
+      // The RGB palette used for grayscale; if null, only the luminance
+      // bits of the palette index are used
+      const uInt32* palette;
+      // The number of threads, or 0 for one per core
+      uInt32 threads;
+
+      Options()
+        : lines(210), downsampleX(1), downsampleY(1), grayscale(false),
+          palette(nullptr), threads(0) { }
+    };
+
+  public:
+    explicit ConsoleBatch(const Options& options = Options());
+
+    /**
+      Add a console to the batch.  Consoles are stepped in the order they
+      were added.
+    */
+    void add(unique_ptr<HeadlessConsole> console);
+
+    /**
+      The number of consoles in the batch, and access to each of them.
+    */
+    uInt32 size() const { return uInt32(myConsoles.size()); }
+    HeadlessConsole& console(uInt32 i) { return *myConsoles[i]; }
+
+    /**
+      The dimensions of the observation of a single console, in bytes.
+    */
+    uInt32 observationWidth() const  { return myWidth;  }
+    uInt32 observationHeight() const { return myHeight; }
+    uInt32 observationSize() const   { return myWidth * myHeight; }
+
+    /**
+      Emulate one frame on each console and write the observations.
+
+      @param inputs        'size() x inputsPerConsole' inputs; unused
+                           entries can be set to Event::NoType
+      @param inputsPerConsole  The number of inputs for each console
+      @param observations  Receives 'size() x observationSize()' bytes;
+                           may be null if no observations are needed
+
+      @return  The number of consoles whose emulation failed; those
+               consoles aren't stepped again, and their observations
+               are left unchanged
+    */
+    uInt32 step(const HeadlessConsole::Input* inputs, uInt32 inputsPerConsole,
+                uInt8* observations);
+
+    /**
+      Reset all consoles to their power-on state.
+    */
+    void reset();
+
+  private:
+    void observe(HeadlessConsole& console, uInt8* dst) const;
+
+  private:
+    Options myOptions;
+    uInt32 myWidth, myHeight;
+
+    // Maps palette indices to grayscale values
+    uInt8 myLuminance[256];
+
+    vector<unique_ptr<HeadlessConsole>> myConsoles;
+    vector<uInt8> myFailed;
+
+    ThreadPool myThreadPool;
+
+  private:
+    // Following constructors and assignment operators not supported
+    ConsoleBatch(const ConsoleBatch&) = delete;
+    ConsoleBatch(ConsoleBatch&&) = delete;
+    ConsoleBatch& operator=(const ConsoleBatch&) = delete;
+    ConsoleBatch& operator=(ConsoleBatch&&) = delete;
+};
+
+#endif // CONSOLE_BATCH_HXX
@@ -39,6 +39,12 @@ class ConsoleIO
     */
     virtual Switches& switches() const = 0;
 
+    /**
+      Called at the end of each emulated frame (but not during frame
+      layout autodetection), right after the CPU has been stopped
+    */
+    virtual void frameComplete() const { }
+
     virtual ~ConsoleIO() = default;
 
 };
@@ -18,6 +18,8 @@
 #ifndef CONTROLLER_DETECTOR_HXX
 #define CONTROLLER_DETECTOR_HXX
 
+#include <bitset>
+
 #include "Control.hxx"
 
 /**
@@ -74,42 +76,54 @@ class ControllerDetector
                                            const Settings& settings);
 
     /**
-      Search the image for the specified byte signature.
+      The groups of signatures searched for, one per port where it matters.
+      A group is hit if any of its signatures is found.
+    */
+    enum class Sig : uInt8 {
+      JoyButtonLeft, JoyButtonRight,
+      KeyboardLeft0, KeyboardLeft1, KeyboardRight0, KeyboardRight1,
+      GenesisLeft, GenesisRight, PaddleLeft, PaddleRight,
+      TrakBall, AtariMouse, AmigaMouse, SaveKey,
+      NumSigs
+    };
+    using SignatureHits = std::bitset<size_t(Sig::NumSigs)>;
 
-      @param image      A pointer to the ROM image
-      @param imagesize  The size of the ROM image
-      @param signature  The byte sequence to search for
-      @param sigsize    The number of bytes in the signature
+    /**
+      Search the whole image for the signatures of all Sig groups at once,
+      in a single pass over the image.  The result for the last image is
+      remembered, since both ports are detected from the same image.
+
+      @param image  A pointer to the ROM image
+      @param size   The size of the ROM image
 
-      @return  True if the signature was found, else false
+      @return  The Sig groups found in the image
     */
-    static bool searchForBytes(const uInt8* image, uInt32 imagesize,
-                               const uInt8* signature, uInt32 sigsize);
+    static SignatureHits scanSignatures(const uInt8* image, uInt32 size);
 
     // Returns true if the port's joystick button access code is found.
-    static bool usesJoystickButton(const uInt8* image, uInt32 size, Controller::Jack port);
+    static bool usesJoystickButton(const SignatureHits& hits, Controller::Jack port);
 
     // Returns true if the port's keyboard access code is found.
-    static bool usesKeyboard(const uInt8* image, uInt32 size, Controller::Jack port);
+    static bool usesKeyboard(const SignatureHits& hits, Controller::Jack port);
 
     // Returns true if the port's 2nd Genesis button access code is found.
-    static bool usesGenesisButton(const uInt8* image, uInt32 size, Controller::Jack port);
+    static bool usesGenesisButton(const SignatureHits& hits, Controller::Jack port);
 
     // Returns true if the port's paddle button access code is found.
-    static bool usesPaddle(const uInt8* image, uInt32 size, Controller::Jack port,
+    static bool usesPaddle(const SignatureHits& hits, Controller::Jack port,
                            const Settings& settings);
 
     // Returns true if a Trak-Ball table is found.
-    static bool isProbablyTrakBall(const uInt8* image, uInt32 size);
+    static bool isProbablyTrakBall(const SignatureHits& hits);
 
     // Returns true if an Atari Mouse table is found.
-    static bool isProbablyAtariMouse(const uInt8* image, uInt32 size);
+    static bool isProbablyAtariMouse(const SignatureHits& hits);
 
     // Returns true if an Amiga Mouse table is found.
-    static bool isProbablyAmigaMouse(const uInt8* image, uInt32 size);
+    static bool isProbablyAmigaMouse(const SignatureHits& hits);
 
     // Returns true if a SaveKey code pattern is found.
-    static bool isProbablySaveKey(const uInt8* image, uInt32 size, Controller::Jack port);
+    static bool isProbablySaveKey(const SignatureHits& hits, Controller::Jack port);
 
   private:
     // Following constructors and assignment operators not supported
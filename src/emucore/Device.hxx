@@ -55,6 +55,16 @@ class Device : public Serializable
     */
     virtual void consoleChanged(ConsoleTiming timing) { }
 
+    /**
+      Notification method invoked by the system when a deadline scheduled
+      with System::scheduleDeadline() has been reached.  The CPU checks
+      for deadlines between instructions, so the system cycles may already
+      be a few cycles past it.
+
+      @param cycle  The cycle the deadline was scheduled for
+    */
+    virtual void deadlineReached(uInt64 cycle) { }
+
     /**
       Install device in the specified system.  Invoked by the system
       when the device is attached to it.
@@ -112,6 +122,31 @@ class Device : public Serializable
     */
     virtual void setAccessFlags(uInt16 address, uInt8 flags) { }
 
+  public:
+    /**
+      Handlers used by the system to forward accesses to a device (see
+      System::PageAccess).  The virtual variants dispatch through peek()
+      and poke(), while the direct variants call the implementation of T
+      without going through the vtable.  T must be the most derived type
+      of the device.
+    */
+    using PeekHandler = uInt8 (*)(Device& device, uInt16 address);
+    using PokeHandler = bool (*)(Device& device, uInt16 address, uInt8 value);
+
+    static uInt8 virtualPeek(Device& device, uInt16 address) {
+      return device.peek(address);
+    }
+    static bool virtualPoke(Device& device, uInt16 address, uInt8 value) {
+      return device.poke(address, value);
+    }
+
+    template<class T> static uInt8 directPeek(Device& device, uInt16 address) {
+      return static_cast<T&>(device).T::peek(address);
+    }
+    template<class T> static bool directPoke(Device& device, uInt16 address, uInt8 value) {
+      return static_cast<T&>(device).T::poke(address, value);
+    }
+
   protected:
     /// Pointer to the system the device is installed in or the null pointer
     System* mySystem;
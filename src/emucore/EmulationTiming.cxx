@@ -22,6 +22,17 @@
 namespace {
   constexpr uInt32 AUDIO_HALF_FRAMES_PER_FRAGMENT = 1;
 
+  // The range of the minimum timeslice, relative to half a frame
+  constexpr double MIN_TIMESLICE_SCALE = 0.25;
+  constexpr double MAX_TIMESLICE_SCALE = 2;
+
+  // Above this share of handoff time, or below this audio queue fill level,
+  // timeslices grow; they shrink below the first and above the second
+  constexpr double LOADED_HANDOFF_SHARE = 0.05;
+  constexpr double IDLE_HANDOFF_SHARE = 0.01;
+  constexpr double LOW_AUDIO_QUEUE_FILL = 0.25;
+  constexpr double HEALTHY_AUDIO_QUEUE_FILL = 0.5;
+
   uInt32 discreteDivCeil(uInt32 n, uInt32 d)
   {
     return n / d + ((n % d == 0) ? 0 : 1);
@@ -36,7 +47,8 @@ EmulationTiming::EmulationTiming(FrameLayout frameLayout, ConsoleTiming consoleT
   myPlaybackPeriod(512),
   myAudioQueueExtraFragments(1),
   myAudioQueueHeadroom(2),
-  mySpeedFactor(1)
+  mySpeedFactor(1),
+  myTimesliceScale(1)
 {
   recalculate();
 }
@@ -104,6 +116,18 @@ EmulationTiming& EmulationTiming::updateSpeedFactor(float speedFactor)
   return *this;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+EmulationTiming& EmulationTiming::adaptTimeslice(double handoffShare, double audioQueueFill)
+{
+  // Grow quickly to get out of trouble, and shrink slowly
+  if (handoffShare > LOADED_HANDOFF_SHARE || audioQueueFill < LOW_AUDIO_QUEUE_FILL)
+    myTimesliceScale = std::min(myTimesliceScale * 1.25, MAX_TIMESLICE_SCALE);
+  else if (handoffShare < IDLE_HANDOFF_SHARE && audioQueueFill > HEALTHY_AUDIO_QUEUE_FILL)
+    myTimesliceScale = std::max(myTimesliceScale * 0.95, MIN_TIMESLICE_SCALE);
+
+  return *this;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 EmulationTiming::maxCyclesPerTimeslice() const
 {
@@ -113,7 +137,7 @@ uInt32 EmulationTiming::maxCyclesPerTimeslice() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 EmulationTiming::minCyclesPerTimeslice() const
 {
-  return myMinCyclesPerTimeslice;
+  return uInt32(round(myMinCyclesPerTimeslice * myTimesliceScale));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -41,6 +41,18 @@ class EmulationTiming {
 
     EmulationTiming& updateSpeedFactor(float speedFactor);
 
+    /**
+      Adapt the minimum timeslice after a timeslice was emulated: shorter
+      timeslices (lower input latency) while the audio queue is well filled
+      and handing emulation to the worker thread is cheap, longer ones if
+      either isn't the case.
+
+      @param handoffShare    The time spent starting and stopping the worker,
+                             relative to the length of the timeslice
+      @param audioQueueFill  The fill level of the audio queue (0 - 1)
+    */
+    EmulationTiming& adaptTimeslice(double handoffShare, double audioQueueFill);
+
     uInt32 maxCyclesPerTimeslice() const;
 
     uInt32 minCyclesPerTimeslice() const;
@@ -85,6 +97,9 @@ class EmulationTiming {
 
     double mySpeedFactor;
 
+    // The factor applied to the minimum timeslice by adaptTimeslice()
+    double myTimesliceScale;
+
   private:
 
     EmulationTiming(const EmulationTiming&) = delete;
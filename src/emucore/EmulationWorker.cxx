@@ -17,6 +17,13 @@
 
 #include <exception>
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_IX86)
+  #include <emmintrin.h>
+  #define WORKER_PAUSE _mm_pause()
+#else
+  #define WORKER_PAUSE std::this_thread::yield()
+#endif
+
 #include "EmulationWorker.hxx"
 #include "DispatchResult.hxx"
 #include "TIA.hxx"
@@ -24,7 +31,8 @@
 using namespace std::chrono;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-EmulationWorker::EmulationWorker()
+EmulationWorker::EmulationWorker(uInt32 spinMicroseconds,
+                                 const ThreadPlacement& placement)
   : myPendingSignal(Signal::none),
     myState(State::initializing),
     myTia(nullptr),
@@ -32,7 +40,13 @@ EmulationWorker::EmulationWorker()
     myMaxCycles(0),
     myMinCycles(0),
     myDispatchResult(nullptr),
-    myTotalCycles(0)
+    myUnthrottled(false),
+    myStopRequested(false),
+    myTotalCycles(0),
+    myEmulationTime(0),
+    myLastEmulationTime(0),
+    mySpinTime(duration_cast<high_resolution_clock::duration>(microseconds(spinMicroseconds))),
+    myPlacement(placement)
 {
   std::mutex mutex;
   std::unique_lock<std::mutex> lock(mutex);
@@ -77,7 +91,8 @@ void EmulationWorker::handlePossibleException()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void EmulationWorker::start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 minCycles, DispatchResult* dispatchResult, TIA* tia)
+void EmulationWorker::start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 minCycles, DispatchResult* dispatchResult, TIA* tia,
+                            bool unthrottled)
 {
   // Wait until any pending signal has been processed
   waitUntilPendingSignalHasProcessed();
@@ -105,6 +120,8 @@ void EmulationWorker::start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 min
     myMaxCycles = maxCycles;
     myMinCycles = minCycles;
     myDispatchResult = dispatchResult;
+    myUnthrottled = unthrottled;
+    myStopRequested = false;
 
     // Raise the signal...
     myPendingSignal = Signal::resume;
@@ -117,6 +134,9 @@ void EmulationWorker::start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 min
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 EmulationWorker::stop()
 {
+  // Unthrottled emulation only returns the lock once it sees this
+  myStopRequested = true;
+
   // See EmulationWorker::start above for the gory details
   waitUntilPendingSignalHasProcessed();
 
@@ -127,6 +147,8 @@ uInt64 EmulationWorker::stop()
     // Paranoia: make sure that we don't doublecount an emulation timeslice
     totalCycles = myTotalCycles;
     myTotalCycles = 0;
+    myLastEmulationTime = myEmulationTime;
+    myEmulationTime = high_resolution_clock::duration(0);
 
     handlePossibleException();
 
@@ -152,6 +174,8 @@ void EmulationWorker::threadMain(std::condition_variable* initializedCondition,
 {
   std::unique_lock<std::mutex> lock(myThreadIsRunningMutex);
 
+  myPlacement.apply("emulation");
+
   try {
     {
       // Wait until our parent releases the lock and sleeps
@@ -187,7 +211,7 @@ void EmulationWorker::handleWakeup(std::unique_lock<std::mutex>& lock)
     case State::initialized:
       // Enter waitingForResume and sleep after initialization
       myState = State::waitingForResume;
-      myWakeupCondition.wait(lock);
+      waitForWakeup(lock);
       break;
 
     case State::waitingForResume:
@@ -214,6 +238,7 @@ void EmulationWorker::handleWakeupFromWaitingForResume(std::unique_lock<std::mut
       // Reset virtual clock and cycle counter
       myVirtualTime = high_resolution_clock::now();
       myTotalCycles = 0;
+      myEmulationTime = high_resolution_clock::duration(0);
 
       // Enter emulation. This will emulate a timeslice and set the state upon completion.
       dispatchEmulation(lock);
@@ -221,7 +246,7 @@ void EmulationWorker::handleWakeupFromWaitingForResume(std::unique_lock<std::mut
 
     case Signal::none:
       // Reenter sleep on spurious wakeups
-      myWakeupCondition.wait(lock);
+      waitForWakeup(lock);
       break;
 
     case Signal::quit:
@@ -242,17 +267,20 @@ void EmulationWorker::handleWakeupFromWaitingForStop(std::unique_lock<std::mutex
 
       // Enter waiting for resume and sleep
       myState = State::waitingForResume;
-      myWakeupCondition.wait(lock);
+      waitForWakeup(lock);
       break;
 
     case Signal::none:
-      if (myVirtualTime <= high_resolution_clock::now())
+      if (myUnthrottled)
+        // Unthrottled emulation only ends up here after it has been asked to stop
+        waitForWakeup(lock);
+      else if (myVirtualTime <= high_resolution_clock::now())
         // The time allotted to the emulation timeslice has passed and we haven't been stopped?
         // -> go for another emulation timeslice
         dispatchEmulation(lock);
       else
         // Wakeup was spurious, reenter sleep
-        myWakeupCondition.wait_until(lock, myVirtualTime);
+        waitForWakeup(lock, myVirtualTime);
 
       break;
 
@@ -271,16 +299,28 @@ void EmulationWorker::dispatchEmulation(std::unique_lock<std::mutex>& lock)
   myState = State::running;
 
   uInt64 totalCycles = 0;
+  const time_point<high_resolution_clock> start = high_resolution_clock::now();
 
   do {
-    myTia->update(*myDispatchResult, totalCycles > 0 ? myMinCycles - totalCycles : myMaxCycles);
+    myTia->update(*myDispatchResult,
+      totalCycles > 0 && totalCycles < myMinCycles ? myMinCycles - totalCycles : myMaxCycles);
     totalCycles += myDispatchResult->getCycles();
-  } while (totalCycles < myMinCycles && myDispatchResult->getStatus() == DispatchResult::Status::ok);
+  } while ((totalCycles < myMinCycles || (myUnthrottled && !myStopRequested)) &&
+           myDispatchResult->getStatus() == DispatchResult::Status::ok);
 
   myTotalCycles += totalCycles;
+  myEmulationTime += high_resolution_clock::now() - start;
 
   bool continueEmulating = false;
 
+  if (myUnthrottled && myDispatchResult->getStatus() == DispatchResult::Status::ok) {
+    // We have been asked to stop; wait for the signal without a deadline
+    myState = State::waitingForStop;
+    waitForWakeup(lock);
+
+    return;
+  }
+
   if (myDispatchResult->getStatus() == DispatchResult::Status::ok) {
     // If emulation finished successfully, we are free to go for another round
     duration<double> timesliceSeconds(static_cast<double>(totalCycles) / static_cast<double>(myCyclesPerSecond));
@@ -295,11 +335,11 @@ void EmulationWorker::dispatchEmulation(std::unique_lock<std::mutex>& lock)
     // If we are free to continue emulating, we sleep until either the timeslice has passed or we
     // have been signalled from the main thread
     myState = State::waitingForStop;
-    myWakeupCondition.wait_until(lock, myVirtualTime);
+    waitForWakeup(lock, myVirtualTime);
   } else {
     // If can't continue, we just stop and wait to be signalled
     myState = State::waitingForResume;
-    myWakeupCondition.wait(lock);
+    waitForWakeup(lock);
   }
 }
 
@@ -328,13 +368,71 @@ void EmulationWorker::signalQuit()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void EmulationWorker::waitUntilPendingSignalHasProcessed()
 {
+  auto processed = [this] () {
+    Signal signal = myPendingSignal;
+    return signal == Signal::none || signal == Signal::quit;
+  };
+
+  // In low latency mode, the worker usually picks up the signal while we spin
+  if (mySpinTime.count() > 0 && spinUntil(processed, time_point<high_resolution_clock>::max()))
+    return;
+
   std::unique_lock<std::mutex> lock(mySignalChangeMutex);
 
   // White until there is no pending signal (or the exit condition has been raised)
-  while (myPendingSignal != Signal::none && myPendingSignal != Signal::quit)
+  while (!processed())
     mySignalChangeCondition.wait(lock);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EmulationWorker::waitForWakeup(std::unique_lock<std::mutex>& lock,
+                                    time_point<high_resolution_clock> deadline)
+{
+  if (mySpinTime.count() > 0) {
+    // Spin without holding the lock, so the main thread can raise a signal
+    lock.unlock();
+    spinUntil([this] () { return myPendingSignal != Signal::none; }, deadline);
+    lock.lock();
+
+    // The caller handles the signal (or the expired timeslice) as a wakeup
+    if (myPendingSignal != Signal::none || high_resolution_clock::now() >= deadline) return;
+  }
+
+  myWakeupCondition.wait_until(lock, deadline);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EmulationWorker::waitForWakeup(std::unique_lock<std::mutex>& lock)
+{
+  if (mySpinTime.count() > 0) {
+    lock.unlock();
+    spinUntil([this] () { return myPendingSignal != Signal::none; },
+              time_point<high_resolution_clock>::max());
+    lock.lock();
+
+    if (myPendingSignal != Signal::none) return;
+  }
+
+  myWakeupCondition.wait(lock);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<typename T>
+bool EmulationWorker::spinUntil(const T& predicate,
+                                time_point<high_resolution_clock> deadline) const
+{
+  time_point<high_resolution_clock> spinEnd =
+    std::min(high_resolution_clock::now() + mySpinTime, deadline);
+
+  while (!predicate()) {
+    if (high_resolution_clock::now() >= spinEnd) return predicate();
+
+    WORKER_PAUSE;
+  }
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void EmulationWorker::fatal(string message)
 {
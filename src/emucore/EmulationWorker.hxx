@@ -33,6 +33,15 @@
  * In combination, the scheduling in the main loop and the microscheduling in the worker
  * ensure that the emulation continues to run even if rendering blocks, ensuring the real
  * time scheduling required for cycle exact audio to work.
+ *
+ * Optionally, both threads spin for a short time on the pending signal before going to
+ * sleep on a condition variable. The handoffs in start() and stop() then usually happen
+ * without waking up a sleeping thread, which can take hundreds of microseconds on a
+ * loaded system. The worker can also be placed on chosen cores, at a raised
+ * priority (see ThreadPlacement).
+ *
+ * In unthrottled (turbo) mode, the worker doesn't sleep between timeslices, but emulates
+ * back to back until it is stopped.
  */
 
 #ifndef EMULATION_WORKER_HXX
@@ -46,6 +55,7 @@
 #include <chrono>
 
 #include "bspf.hxx"
+#include "ThreadPlacement.hxx"
 
 class TIA;
 class DispatchResult;
@@ -56,8 +66,13 @@ class EmulationWorker
 
     /**
       The constructor starts the worker thread and waits until it has initialized.
+
+      @param spinMicroseconds  Time to spin before sleeping while waiting for a
+                               signal (0 = never spin)
+      @param placement         The cores and priority of the worker thread
      */
-    EmulationWorker();
+    explicit EmulationWorker(uInt32 spinMicroseconds = 0,
+                             const ThreadPlacement& placement = ThreadPlacement());
 
     /**
       The destructor signals quit to the worker and joins.
@@ -66,14 +81,22 @@ class EmulationWorker
 
     /**
       Wake up the worker and start emulation with the specified parameters.
+      If 'unthrottled' is set, emulation is not synced to real time, but runs
+      as fast as possible until the worker is stopped.
      */
-    void start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 minCycles, DispatchResult* dispatchResult, TIA* tia);
+    void start(uInt32 cyclesPerSecond, uInt64 maxCycles, uInt64 minCycles, DispatchResult* dispatchResult, TIA* tia,
+               bool unthrottled = false);
 
     /**
       Stop emulation and return the number of 6507 cycles emulated.
      */
     uInt64 stop();
 
+    /**
+      The real time the worker spent emulating until the last stop().
+     */
+    std::chrono::high_resolution_clock::duration emulationTime() const { return myLastEmulationTime; }
+
   private:
 
     /**
@@ -125,6 +148,22 @@ class EmulationWorker
      */
     void waitUntilPendingSignalHasProcessed();
 
+    /**
+      Sleep on the wakeup condition until the deadline, or until woken up. In low
+      latency mode, spin for a while before, without holding the lock.
+     */
+    void waitForWakeup(std::unique_lock<std::mutex>& lock,
+                       std::chrono::time_point<std::chrono::high_resolution_clock> deadline);
+    void waitForWakeup(std::unique_lock<std::mutex>& lock);
+
+    /**
+      Spin until the predicate holds, the spin time is up or the deadline has passed.
+      Answers the final value of the predicate.
+     */
+    template<typename T>
+    bool spinUntil(const T& predicate,
+                   std::chrono::time_point<std::chrono::high_resolution_clock> deadline) const;
+
     /**
       Log a fatal error to cerr and throw a runtime exception.
      */
@@ -182,8 +221,9 @@ class EmulationWorker
     // Any exception on the worker thread is saved here to be rethrown on the main thread.
     std::exception_ptr myPendingException;
 
-    // Any pending signal (or Signal::none)
-    Signal myPendingSignal;
+    // Any pending signal (or Signal::none); atomic, since it is polled without a lock
+    // while spinning
+    std::atomic<Signal> myPendingSignal;
     // The initial access to myState is not synchronized -> make this atomic
     std::atomic<State> myState;
 
@@ -193,12 +233,24 @@ class EmulationWorker
     uInt64 myMaxCycles;
     uInt64 myMinCycles;
     DispatchResult* myDispatchResult;
+    bool myUnthrottled;
+
+    // Raised by stop() before it waits for the lock, so unthrottled emulation (which
+    // doesn't release the lock between timeslices) knows when to finish
+    std::atomic<bool> myStopRequested;
 
     // Total number of cycles during this emulation run
     uInt64 myTotalCycles;
+    // Real time spent emulating during this run, and during the last one
+    std::chrono::high_resolution_clock::duration myEmulationTime;
+    std::chrono::high_resolution_clock::duration myLastEmulationTime;
     // 6507 time
     std::chrono::time_point<std::chrono::high_resolution_clock> myVirtualTime;
 
+    // How long to spin before sleeping on a condition variable
+    std::chrono::high_resolution_clock::duration mySpinTime;
+    ThreadPlacement myPlacement;
+
   private:
 
     EmulationWorker(const EmulationWorker&) = delete;
@@ -120,6 +120,12 @@ class Event
       CompuMateQuote, CompuMateBackspace, CompuMateEquals, CompuMatePlus,
       CompuMateSlash,
 
+      ToggleFrameRecording,
+      ToggleTurbo,
+      ToggleTelemetry,
+      ToggleMovieRecord, ToggleMoviePlayback,
+      ToggleLineTiming,
+
       LastType
 
     };
@@ -156,6 +162,8 @@ class Event
 
     /**
       Set the value associated with the event of the specified type.
+      The controllers only pick up the values once per timeslice, before
+      the emulation worker runs (see EventHandler::poll).
     */
     void set(Type type, Int32 value) {
       std::lock_guard<std::mutex> lock(myMutex);
@@ -24,6 +24,8 @@
 #include "Console.hxx"
 #include "FrameBuffer.hxx"
 #include "FSNode.hxx"
+#include "FrameRecorder.hxx"
+#include "FrameTelemetry.hxx"
 #include "OSystem.hxx"
 #include "Joystick.hxx"
 #include "Paddles.hxx"
@@ -224,7 +226,15 @@ void EventHandler::poll(uInt64 time)
   // related to emulation
   if(myState == EventHandlerState::EMULATION)
   {
-    myOSystem.console().riot().update();
+    // Host input reaches the ports here, between timeslices, and not when
+    // the game reads them: SDL events can only be pumped on the main
+    // thread, and the worker emulates the next timeslice in one go right
+    // after this, so there is nothing newer to pick up in the meantime.
+    //
+    // Movies (and the time machine's input log) only take input at the
+    // start of a frame
+    if(!myOSystem.console().inputMovie())
+      myOSystem.console().riot().update();
 
     // Now check if the StateManager should be saving or loading state
     // (for rewind and/or movies
@@ -232,10 +242,13 @@ void EventHandler::poll(uInt64 time)
       myOSystem.state().update();
 
   #ifdef CHEATCODE_SUPPORT
-    for(auto& cheat: myOSystem.cheat().perFrame())
-      cheat->evaluate();
+    myOSystem.cheat().applyPerFrame();
   #endif
 
+    // Record the frame, if a frame dump is running
+    if(myOSystem.frameRecorder().isRecording())
+      myOSystem.frameRecorder().update();
+
   #ifdef PNG_SUPPORT
     // Handle continuous snapshots
     if(myOSystem.png().continuousSnapEnabled())
@@ -527,6 +540,10 @@ void EventHandler::handleEvent(Event::Type event, Int32 value, bool repeated)
       if (pressed) myOSystem.frameBuffer().toggleFrameStats();
       return;
 
+    case Event::ToggleLineTiming:
+      if (pressed && !repeated) myOSystem.frameBuffer().tiaSurface().toggleLineTiming();
+      return;
+
     case Event::ToggleTimeMachine:
       if (pressed && !repeated) myOSystem.state().toggleTimeMachine();
       return;
@@ -536,6 +553,18 @@ void EventHandler::handleEvent(Event::Type event, Int32 value, bool repeated)
       if (pressed && !repeated) myOSystem.png().toggleContinuousSnapshots(false);
       return;
 
+    case Event::ToggleFrameRecording:
+      if (pressed && !repeated) myOSystem.frameRecorder().toggleRecording();
+      return;
+
+    case Event::ToggleTurbo:
+      if (pressed && !repeated) myOSystem.toggleTurbo();
+      return;
+
+    case Event::ToggleTelemetry:
+      if (pressed && !repeated) myOSystem.telemetry().toggleRecording();
+      return;
+
     case Event::ToggleContSnapshotsFrame:
       if (pressed && !repeated) myOSystem.png().toggleContinuousSnapshots(true);
       return;
@@ -643,6 +672,14 @@ void EventHandler::handleEvent(Event::Type event, Int32 value, bool repeated)
       if (pressed) myOSystem.state().toggleAutoSlot();
       return;
 
+    case Event::ToggleMovieRecord:
+      if (pressed && !repeated) myOSystem.state().toggleRecordMode();
+      return;
+
+    case Event::ToggleMoviePlayback:
+      if (pressed && !repeated) myOSystem.state().togglePlaybackMode();
+      return;
+
     case Event::LoadState:
       if(pressed && !repeated) myOSystem.state().loadState();
       return;
@@ -903,7 +940,10 @@ void EventHandler::handleEvent(Event::Type event, Int32 value, bool repeated)
 
   // Otherwise, pass it to the emulation core
   if (!repeated)
+  {
     myEvent.set(event, value);
+    myOSystem.telemetry().inputReceived();
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1737,11 +1777,16 @@ EventHandler::ActionList EventHandler::ourEmulActionList[EMUL_ACTIONLIST_SIZE] =
   { Event::ChangeState,             "Change state slot",                     "" },
   { Event::ToggleAutoSlot,          "Toggle automatic state slot change",    "" },
   { Event::LoadState,               "Load state",                            "" },
+  { Event::ToggleMovieRecord,       "Toggle movie recording",                "" },
+  { Event::ToggleMoviePlayback,     "Toggle movie playback",                 "" },
 #ifdef PNG_SUPPORT
   { Event::TakeSnapshot,            "Snapshot",                              "" },
   { Event::ToggleContSnapshots,     "Save continuous snapsh. (as defined)",  "" },
   { Event::ToggleContSnapshotsFrame,"Save continuous snapsh. (every frame)", "" },
 #endif
+  { Event::ToggleFrameRecording,    "Toggle frame dump recording",           "" },
+  { Event::ToggleTurbo,             "Toggle turbo mode",                     "" },
+  { Event::ToggleTelemetry,         "Toggle frame timing telemetry",         "" },
 
   { Event::JoystickZeroUp,          "P0 Joystick Up",                        "" },
   { Event::JoystickZeroDown,        "P0 Joystick Down",                      "" },
@@ -1832,6 +1877,7 @@ EventHandler::ActionList EventHandler::ourEmulActionList[EMUL_ACTIONLIST_SIZE] =
   { Event::ScanlinesIncrease,       "Increase scanlines",                    "" },
   // Developer keys:
   { Event::ToggleFrameStats,        "Toggle frame stats",                    "" },
+  { Event::ToggleLineTiming,        "Toggle scanline cycle budget",          "" },
   { Event::ToggleP0Bit,             "Toggle TIA Player0 object",             "" },
   { Event::ToggleP0Collision,       "Toggle TIA Player0 collisions",         "" },
   { Event::ToggleP1Bit,             "Toggle TIA Player1 object",             "" },
@@ -1921,6 +1967,7 @@ const Event::EventSet EventHandler::MiscEvents = {
   Event::Quit, Event::ReloadConsole, Event::Fry, Event::StartPauseMode,
   Event::TogglePauseMode, Event::OptionsMenuMode, Event::CmdMenuMode, Event::ExitMode,
   Event::TakeSnapshot, Event::ToggleContSnapshots, Event::ToggleContSnapshotsFrame,
+  Event::ToggleFrameRecording, Event::ToggleTurbo, Event::ToggleTelemetry,
   // Event::MouseAxisXValue, Event::MouseAxisYValue,
   // Event::MouseButtonLeftValue, Event::MouseButtonRightValue,
   Event::HandleMouseControl, Event::ToggleGrabMouse,
@@ -1948,6 +1995,7 @@ const Event::EventSet EventHandler::StateEvents = {
   Event::Rewind1Menu, Event::Rewind10Menu, Event::RewindAllMenu,
   Event::Unwind1Menu, Event::Unwind10Menu, Event::UnwindAllMenu,
   Event::SaveAllStates, Event::LoadAllStates, Event::ToggleAutoSlot,
+  Event::ToggleMovieRecord, Event::ToggleMoviePlayback,
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1997,7 +2045,7 @@ const Event::EventSet EventHandler::ComboEvents = {
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const Event::EventSet EventHandler::DebugEvents = {
   Event::DebuggerMode,
-  Event::ToggleFrameStats,
+  Event::ToggleFrameStats, Event::ToggleLineTiming,
   Event::ToggleP0Collision, Event::ToggleP0Bit, Event::ToggleP1Collision, Event::ToggleP1Bit,
   Event::ToggleM0Collision, Event::ToggleM0Bit, Event::ToggleM1Collision, Event::ToggleM1Bit,
   Event::ToggleBLCollision, Event::ToggleBLBit, Event::TogglePFCollision, Event::TogglePFBit,
@@ -64,6 +64,7 @@ class EventHandler
       @return The event object
     */
     const Event& event() const { return myEvent; }
+    Event& event() { return myEvent; }
 
     /**
       Initialize state of this eventhandler.
@@ -97,6 +98,15 @@ class EventHandler
     */
     void poll(uInt64 time);
 
+    /**
+      Wait until an event is pending (without processing it), or the given
+      time has passed.  Used instead of polling regularly while the GUI is
+      idle.  Backends which can't wait for events return immediately.
+
+      @param timeout  The maximum time to wait in milliseconds
+    */
+    virtual void waitEvent(uInt32) { }
+
     /**
       Get/set the current state of the EventHandler
 
@@ -396,7 +406,7 @@ class EventHandler
     #else
       PNG_SIZE             = 0,
     #endif
-      EMUL_ACTIONLIST_SIZE = 139 + PNG_SIZE + COMBO_SIZE,
+      EMUL_ACTIONLIST_SIZE = 145 + PNG_SIZE + COMBO_SIZE,
       MENU_ACTIONLIST_SIZE = 18
     ;
 
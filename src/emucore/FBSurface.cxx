@@ -177,53 +177,24 @@ void FBSurface::drawChar(const GUI::Font& font, uInt8 chr,
     drawChar(font, chr, tx + 1, ty + 1, shadowColor);
   }
 
-  const FontDesc& desc = font.desc();
-
-  // If this character is not included in the font, use the default char.
-  if(chr < desc.firstchar || chr >= desc.firstchar + desc.size)
-  {
-    if (chr == ' ') return;
-    chr = desc.defaultchar;
-  }
-  chr -= desc.firstchar;
-
-  // Get the bounding box of the character
-  int bbw, bbh, bbx, bby;
-  if(!desc.bbx)
-  {
-    bbw = desc.fbbw;
-    bbh = desc.fbbh;
-    bbx = desc.fbbx;
-    bby = desc.fbby;
-  }
-  else
-  {
-    bbw = desc.bbx[chr].w;
-    bbh = desc.bbx[chr].h;
-    bbx = desc.bbx[chr].x;
-    bby = desc.bbx[chr].y;
-  }
+  // The glyph is pre-rasterized into horizontal spans by the font
+  const GUI::Font::Glyph* glyph = font.getGlyph(chr);
+  if(!glyph)
+    return;
 
-  uInt32 cx = tx + bbx;
-  uInt32 cy = ty + desc.ascent - bby - bbh;
+  const BBX& bbx = glyph->bbx;
+  uInt32 cx = tx + bbx.x;
+  uInt32 cy = ty + font.desc().ascent - bbx.y - bbx.h;
 
-  if(!checkBounds(cx , cy) || !checkBounds(cx + bbw - 1, cy + bbh - 1))
+  if(!checkBounds(cx , cy) || !checkBounds(cx + bbx.w - 1, cy + bbx.h - 1))
     return;
 
-  const uInt16* tmp = desc.bits + (desc.offset ? desc.offset[chr] : (chr * desc.fbbh));
+  const uInt32 pixel = uInt32(myPalette[color]);
   uInt32* buffer = myPixels + cy * myPitch + cx;
+  const GUI::Font::Span* span = font.getSpans(*glyph);
 
-  for(int y = 0; y < bbh; y++)
-  {
-    const uInt16 ptr = *tmp++;
-    uInt16 mask = 0x8000;
-
-    for(int x = 0; x < bbw; x++, mask >>= 1)
-      if(ptr & mask)
-        buffer[x] = uInt32(myPalette[color]);
-
-    buffer += myPitch;
-  }
+  for(uInt32 i = 0; i < glyph->numSpans; ++i, ++span)
+    std::fill_n(buffer + span->row * myPitch + span->col, span->len, pixel);
 #endif
 }
 
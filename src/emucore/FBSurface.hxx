@@ -320,6 +320,52 @@ class FBSurface
     */
     virtual void resize(uInt32 width, uInt32 height) = 0;
 
+    /**
+      This method should be called to enable/disable phosphor persistence
+      in hardware.  When enabled, each rendered image is blended as the
+      maximum of the current pixels and the previously rendered image
+      decayed by the given amount.  Backends which cannot do this leave
+      the surface unchanged and return false, in which case the caller
+      must blend the frames itself.
+
+      @param enable  Whether to enable hardware persistence
+      @param decay   Fraction (0.0 - 1.0) of the previous image to keep
+
+      @return  True if hardware persistence is now active, else false
+    */
+    virtual bool enablePersistence(bool enable, float decay) { return false; }
+
+    /**
+      This method should be called before render() to indicate that only
+      the rows in [top, bottom) of the pixel data changed since the last
+      call to render().  Backends may use this to upload less data; the
+      default is that the whole surface changed.
+
+      @param top     The first row which changed
+      @param bottom  One past the last row which changed (top for none)
+    */
+    virtual void setDirtyRows(uInt32 top, uInt32 bottom) { }
+
+    /**
+      This method can be called instead of writing to basePtr(), to render
+      the rows in [top, bottom) of the next image directly into the memory
+      of the backend (i.e. a locked streaming texture), which saves copying
+      them there in render().  Since the memory has undefined contents,
+      the backend may widen the range to the rows it needs, and the caller
+      must then write all of them before calling render().  The rows not
+      written this way are stale in the pixels of basePtr().
+
+      @param top     The first row to render; updated to the first mapped row
+      @param bottom  One past the last row to render; updated likewise
+      @param pixels  Updated to point to the first mapped row
+      @param pitch   Updated to the pitch (in pixels) of the mapped memory
+
+      @return  True if the rows are mapped, false if the caller must use
+               basePtr() as usual
+    */
+    virtual bool lockRows(uInt32& top, uInt32& bottom, uInt32*& pixels,
+                          uInt32& pitch) { return false; }
+
     /**
       The rendering attributes that can be modified for this texture.
       These probably can only be implemented in child FBSurfaces where
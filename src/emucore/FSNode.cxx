@@ -18,6 +18,7 @@
 //   Copyright (C) 2002-2004 The ScummVM project
 //============================================================================
 
+#include "FSMetadataCache.hxx"
 #include "FSNodeFactory.hxx"
 #include "FSNode.hxx"
 
@@ -213,6 +214,13 @@ bool FilesystemNode::rename(const string& newfile)
   return (_realNode && _realNode->exists()) ? _realNode->rename(newfile) : false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNode::getFileInfo(uInt64& size, uInt64& modified) const
+{
+  return _realNode && _realNode->isFile() ?
+      _realNode->getFileInfo(size, modified) : false;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 FilesystemNode::read(ByteBuffer& image) const
 {
@@ -227,7 +235,6 @@ uInt32 FilesystemNode::read(ByteBuffer& image) const
     return size;
 
   // Otherwise, the default behaviour is to read from a normal C++ ifstream
-  image = make_unique<uInt8[]>(512 * 1024);
   ifstream in(getPath(), std::ios::binary);
   if (in)
   {
@@ -238,7 +245,10 @@ uInt32 FilesystemNode::read(ByteBuffer& image) const
     if (length == 0)
       throw runtime_error("Zero-byte file");
 
+    // Only allocate what is actually read; most ROMs are far smaller
+    // than the maximum size
     size = std::min(uInt32(length), 512u * 1024u);
+    image = make_unique<uInt8[]>(size);
     in.read(reinterpret_cast<char*>(image.get()), size);
   }
   else
@@ -246,3 +256,9 @@ uInt32 FilesystemNode::read(ByteBuffer& image) const
 
   return size;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FilesystemNode::invalidateCache(const string& path)
+{
+  FSMetadataCache::invalidate(path);
+}
@@ -240,6 +240,16 @@ class FilesystemNode
      */
     uInt32 read(ByteBuffer& buffer) const;
 
+    /**
+     * Get the size and modification time of a file, as reported by the
+     * filesystem.  The time is only meaningful for comparing against
+     * another time of the same file.
+     *
+     * @return bool true if the information is available, false otherwise
+     *              (also for nodes inside of archives)
+     */
+    bool getFileInfo(uInt64& size, uInt64& modified) const;
+
     /**
      * The following methods are almost exactly the same as the various
      * getXXXX() methods above.  Internally, they call the respective methods
@@ -249,6 +259,15 @@ class FilesystemNode
     string getNameWithExt(const string& ext) const;
     string getPathWithExt(const string& ext) const;
 
+    /**
+     * The metadata of nodes (e.g. whether they exist) is cached for a
+     * short time.  Code that creates or changes files without using this
+     * class must invalidate their path afterwards.
+     *
+     * @param path  The path of the file that changed
+     */
+    static void invalidateCache(const string& path);
+
   private:
     AbstractFSNodePtr _realNode;
     explicit FilesystemNode(AbstractFSNodePtr realNode);
@@ -399,6 +418,13 @@ class AbstractFSNode
      *          a try-catch block.
      */
     virtual uInt32 read(ByteBuffer& buffer) const { return 0; }
+
+    /**
+     * Get the size and modification time of a file.
+     *
+     * @return bool true if the information is available, false otherwise.
+     */
+    virtual bool getFileInfo(uInt64& size, uInt64& modified) const { return false; }
 };
 
 #endif
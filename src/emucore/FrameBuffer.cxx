@@ -28,6 +28,7 @@
 
 #include "FBSurface.hxx"
 #include "TIASurface.hxx"
+#include "FrameTelemetry.hxx"
 #include "FrameBuffer.hxx"
 
 #ifdef DEBUGGER_SUPPORT
@@ -171,6 +172,9 @@ void FrameBuffer::setUIPalette()
     myPalette[j] = mapRGB(r, g, b);
   }
   FBSurface::setPalette(myPalette);
+
+  // Overlays must be drawn again in the new colors
+  myMsg.dirty = myStatsMsg.dirty = true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -231,8 +235,17 @@ FBInitStatus FrameBuffer::createDisplay(const string& title,
     // sound played may get 'stuck'
     // So we mute the sound until the operation completes
     bool oldMuteState = myOSystem.sound().mute(true);
-    if(setVideoMode(myScreenTitle, mode))
+
+    // Switching between ROMs usually doesn't change the mode; the window,
+    // renderer and all surfaces are kept then, which avoids blank frames
+    const string modeKey = videoModeKey(mode);
+    const bool keepMode = modeKey == myVideoModeKey;
+    if(keepMode)
+      setTitle(myScreenTitle);
+
+    if(keepMode || setVideoMode(myScreenTitle, mode))
     {
+      myVideoModeKey = modeKey;
       myImageRect = mode.image;
       myScreenSize = mode.screen;
       myScreenRect = Common::Rect(mode.screen);
@@ -244,7 +257,8 @@ FBInitStatus FrameBuffer::createDisplay(const string& title,
 
       // Did we get the requested fullscreen state?
       myOSystem.settings().setValue("fullscreen", fullScreen());
-      resetSurfaces();
+      if(!keepMode)
+        resetSurfaces();
       setCursorState();
 
       myOSystem.sound().mute(oldMuteState);
@@ -267,6 +281,7 @@ FBInitStatus FrameBuffer::createDisplay(const string& title,
   myStatsMsg.color = kColorInfo;
   myStatsMsg.w = f.getMaxCharWidth() * 40 + 3;
   myStatsMsg.h = (f.getFontHeight() + 2) * 3;
+  myStatsMsg.dirty = true;
 
   if(!myStatsMsg.surface)
   {
@@ -278,6 +293,16 @@ FBInitStatus FrameBuffer::createDisplay(const string& title,
 
   if(!myMsg.surface)
     myMsg.surface = allocateSurface(FBMinimum::Width, font().getFontHeight()+10);
+
+  // Create surface for the frame timing telemetry graph
+  if(!myTelemetrySurface)
+  {
+    myTelemetrySurface = allocateSurface(TELEMETRY_WIDTH,
+        TELEMETRY_HEIGHT + f.getFontHeight() + 2);
+    myTelemetrySurface->attributes().blending = true;
+    myTelemetrySurface->attributes().blendalpha = 92;
+    myTelemetrySurface->applyAttributes();
+  }
 #endif
 
   // Print initial usage message, but only print it later if the status has changed
@@ -296,7 +321,7 @@ FBInitStatus FrameBuffer::createDisplay(const string& title,
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void FrameBuffer::update(bool force)
+bool FrameBuffer::update(bool force)
 {
   // Onscreen messages are a special case and require different handling than
   // other objects; they aren't UI dialogs in the normal sense nor are they
@@ -320,7 +345,7 @@ void FrameBuffer::update(bool force)
     case EventHandlerState::NONE:
     case EventHandlerState::EMULATION:
       // Do nothing; emulation mode is handled separately (see below)
-      return;
+      return false;
 
     case EventHandlerState::PAUSE:
     {
@@ -412,6 +437,8 @@ void FrameBuffer::update(bool force)
   // Push buffers to screen only when necessary
   if(force)
     renderToScreen();
+
+  return force;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -431,6 +458,10 @@ void FrameBuffer::updateInEmulationMode(float framesPerSecond)
   if(myStatsMsg.enabled)
     drawFrameStats(framesPerSecond);
 
+  // Show frame timing telemetry
+  if(myOSystem.telemetry().isEnabled())
+    drawTelemetry();
+
   myLastScanlines = myOSystem.console().tia().frameBufferScanlinesLastFrame();
   myPausedCount = 0;
 
@@ -463,6 +494,7 @@ void FrameBuffer::showMessage(const string& message, MessagePosition position,
   myMsg.surface->setDstSize(myMsg.w * hidpiScaleFactor(), myMsg.h * hidpiScaleFactor());
   myMsg.position = position;
   myMsg.enabled = true;
+  myMsg.dirty = true;
 #endif
 }
 
@@ -476,8 +508,7 @@ void FrameBuffer::drawFrameStats(float framesPerSecond)
   const int dy = f.getFontHeight() + 2;
 
   ostringstream ss;
-
-  myStatsMsg.surface->invalidate();
+  string lines[3];
 
   // draw scanlines
   ColorId color = myOSystem.console().tia().frameBufferScanlinesLastFrame() != myLastScanlines ?
@@ -489,11 +520,7 @@ void FrameBuffer::drawFrameStats(float framesPerSecond)
     << std::fixed << std::setprecision(1) << myOSystem.console().getFramerate()
     << "Hz => "
     << info.DisplayFormat;
-
-  myStatsMsg.surface->drawString(f, ss.str(), xPos, yPos,
-                                 myStatsMsg.w, color, TextAlign::Left, 0, true, kBGColor);
-
-  yPos += dy;
+  lines[0] = ss.str();
   ss.str("");
 
   ss
@@ -501,18 +528,34 @@ void FrameBuffer::drawFrameStats(float framesPerSecond)
     << "fps @ "
     << std::fixed << std::setprecision(0) << 100 * myOSystem.settings().getFloat("speed")
     << "% speed";
-
-  myStatsMsg.surface->drawString(f, ss.str(), xPos, yPos,
-                                 myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
-
-  yPos += dy;
+  lines[1] = ss.str();
   ss.str("");
 
   ss << info.BankSwitch;
   if (myOSystem.settings().getBool("dev.settings")) ss << "| Developer";
+  lines[2] = ss.str();
 
-  myStatsMsg.surface->drawString(f, ss.str(), xPos, yPos,
-      myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
+  // Only draw the statistics again when they changed; otherwise the
+  // current surface content (and texture) can be shown as is
+  const string text = lines[0] + '\n' + lines[1] + '\n' + lines[2] + char(color);
+  if(myStatsMsg.dirty || text != myStatsMsg.text)
+  {
+    myStatsMsg.surface->invalidate();
+
+    myStatsMsg.surface->drawString(f, lines[0], xPos, yPos,
+                                   myStatsMsg.w, color, TextAlign::Left, 0, true, kBGColor);
+    yPos += dy;
+    myStatsMsg.surface->drawString(f, lines[1], xPos, yPos,
+                                   myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
+    yPos += dy;
+    myStatsMsg.surface->drawString(f, lines[2], xPos, yPos,
+                                   myStatsMsg.w, myStatsMsg.color, TextAlign::Left, 0, true, kBGColor);
+
+    myStatsMsg.text = text;
+    myStatsMsg.dirty = false;
+  }
+  else
+    myStatsMsg.surface->setDirtyRows(0, 0);
 
   myStatsMsg.surface->setDstPos(myImageRect.x() + 10, myImageRect.y() + 8);
   myStatsMsg.surface->setDstSize(myStatsMsg.w * hidpiScaleFactor(),
@@ -521,6 +564,82 @@ void FrameBuffer::drawFrameStats(float framesPerSecond)
 #endif
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FrameBuffer::drawTelemetry()
+{
+#ifdef GUI_SUPPORT
+  const FrameTelemetry& telemetry = myOSystem.telemetry();
+  const GUI::Font& f = hidpiEnabled() ? infoFont() : font();
+  const uInt32 h = myTelemetrySurface->height();
+
+  myTelemetrySurface->invalidate();
+  myTelemetrySurface->fillRect(0, 0, TELEMETRY_WIDTH, h, kBGColor);
+
+  // One frame at the current emulation speed takes half the graph height
+  const double frameMs = 1000.0 / std::max(myOSystem.frameRate(), 1.F);
+  const double scale = TELEMETRY_HEIGHT / (2 * frameMs);
+  const uInt32 base = TELEMETRY_HEIGHT - 1;
+
+  const uInt32 size = telemetry.size();
+  const uInt32 count = std::min(size, uInt32(TELEMETRY_WIDTH));
+  double latencyTotal = 0;
+  uInt32 latencyCount = 0;
+
+  for(uInt32 i = 0; i < count; ++i)
+  {
+    const FrameTelemetry::Sample& sample = telemetry.sample(size - count + i);
+    const uInt32 x = TELEMETRY_WIDTH - count + i;
+
+    // Stacked bars, from the bottom: emulation, handoff, render, present
+    const double parts[] = {
+      sample.emulation, sample.handoff, sample.render, sample.present
+    };
+    static constexpr ColorId colors[] = {
+      kColorInfo, kDbgColorRed, kSliderColorHi, kDbgChangedColor
+    };
+    double top = 0;
+    for(uInt32 p = 0; p < 4; ++p)
+    {
+      const uInt32 y0 = uInt32(std::min(top * scale, double(base)));
+      top += parts[p];
+      const uInt32 y1 = uInt32(std::min(top * scale, double(base)));
+      if(y1 > y0)
+        myTelemetrySurface->fillRect(x, base - y1, 1, y1 - y0, colors[p]);
+    }
+
+    // The fill level of the audio queue as a dot
+    const uInt32 fill = uInt32(BSPF::clamp(sample.audioFill, 0.0, 1.0) * base);
+    myTelemetrySurface->fillRect(x, base - fill, 1, 1, kTextColorHi);
+
+    if(sample.inputLatency >= 0)
+    {
+      latencyTotal += sample.inputLatency;
+      ++latencyCount;
+    }
+  }
+
+  // Mark the duration of one frame
+  myTelemetrySurface->hLine(0, base - uInt32(frameMs * scale),
+                            TELEMETRY_WIDTH - 1, kTextColor);
+
+  ostringstream ss;
+  ss << "input latency ";
+  if(latencyCount)
+    ss << std::fixed << std::setprecision(1) << latencyTotal / latencyCount << "ms";
+  else
+    ss << "-";
+
+  myTelemetrySurface->drawString(f, ss.str(), 2, TELEMETRY_HEIGHT + 1,
+      TELEMETRY_WIDTH - 2, kColorInfo, TextAlign::Left, 0, true, kBGColor);
+
+  myTelemetrySurface->setDstPos(myImageRect.x() + 10,
+      myImageRect.y() + myImageRect.h() - h * hidpiScaleFactor() - 8);
+  myTelemetrySurface->setDstSize(TELEMETRY_WIDTH * hidpiScaleFactor(),
+                                 h * hidpiScaleFactor());
+  myTelemetrySurface->render();
+#endif
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FrameBuffer::toggleFrameStats()
 {
@@ -624,10 +743,19 @@ inline bool FrameBuffer::drawMessage()
   }
 
   myMsg.surface->setDstPos(myMsg.x + myImageRect.x(), myMsg.y + myImageRect.y());
-  myMsg.surface->fillRect(1, 1, myMsg.w-2, myMsg.h-2, kBtnColor);
-  myMsg.surface->frameRect(0, 0, myMsg.w, myMsg.h, kColor);
-  myMsg.surface->drawString(font(), myMsg.text, 5, 4,
-                            myMsg.w, myMsg.color, TextAlign::Left);
+
+  // The message only needs to be drawn once; afterwards, the surface
+  // content (and texture) is simply shown again
+  if(myMsg.dirty)
+  {
+    myMsg.surface->fillRect(1, 1, myMsg.w-2, myMsg.h-2, kBtnColor);
+    myMsg.surface->frameRect(0, 0, myMsg.w, myMsg.h, kColor);
+    myMsg.surface->drawString(font(), myMsg.text, 5, 4,
+                              myMsg.w, myMsg.color, TextAlign::Left);
+    myMsg.dirty = false;
+  }
+  else
+    myMsg.surface->setDirtyRows(0, 0);
   myMsg.surface->render();
   myMsg.counter--;
 #endif
@@ -736,6 +864,7 @@ void FrameBuffer::setFullscreen(bool enable)
   bool oldMuteState = myOSystem.sound().mute(true);
 
   const VideoMode& mode = getSavedVidMode(enable);
+  myVideoModeKey.clear();
   if(setVideoMode(myScreenTitle, mode))
   {
     myImageRect = mode.image;
@@ -807,6 +936,7 @@ bool FrameBuffer::changeVidMode(int direction)
   bool oldMuteState = myOSystem.sound().mute(true);
 
   const VideoMode& mode = myCurrentModeList->current();
+  myVideoModeKey.clear();
   if(setVideoMode(myScreenTitle, mode))
   {
     myImageRect = mode.image;
@@ -891,6 +1021,20 @@ float FrameBuffer::maxZoomForScreen(uInt32 baseWidth, uInt32 baseHeight,
   return multiplier > 1 ? multiplier - ZOOM_STEPS : 1;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string FrameBuffer::videoModeKey(const VideoMode& mode) const
+{
+  const Settings& settings = myOSystem.settings();
+
+  ostringstream buf;
+  buf << mode << " vsync=" << settings.getBool("vsync")
+      << " video=" << settings.getString("video")
+      << " gpusync=" << settings.getBool("gpusync")
+      << " center=" << settings.getBool("center");
+
+  return buf.str();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FrameBuffer::setAvailableVidModes(uInt32 baseWidth, uInt32 baseHeight)
 {
@@ -120,8 +120,10 @@ class FrameBuffer
     /**
       Updates the display, which depending on the current mode could mean
       drawing the TIA, any pending menus, etc.
+
+      @return  True if anything was redrawn
     */
-    void update(bool force = false);
+    bool update(bool force = false);
 
     /**
       There is a dedicated update method for emulation mode.
@@ -467,6 +469,13 @@ class FrameBuffer
     */
     void setAvailableVidModes(uInt32 basewidth, uInt32 baseheight);
 
+    /**
+      Describes the given video mode, along with all settings that
+      setVideoMode() depends on.  If this doesn't change, the current
+      window and renderer can be kept.
+    */
+    string videoModeKey(const VideoMode& mode) const;
+
     /**
       Returns an appropriate video mode based on the current eventhandler
       state, taking into account the maximum size of the window.
@@ -528,9 +537,16 @@ class FrameBuffer
     // Draws the frame stats overlay
     void drawFrameStats(float framesPerSecond);
 
+    // Draws the frame timing telemetry graph
+    void drawTelemetry();
+
     // Indicates the number of times the framebuffer was initialized
     uInt32 myInitializedCount;
 
+    // The video mode last set by createDisplay() (see videoModeKey()), or
+    // empty if the mode has been changed since
+    string myVideoModeKey;
+
     // Used to set intervals between messages while in pause mode
     Int32 myPausedCount;
 
@@ -582,16 +598,21 @@ class FrameBuffer
       ColorId color;
       shared_ptr<FBSurface> surface;
       bool enabled;
+      bool dirty;  // surface content must be drawn again
 
       Message()
         : counter(-1), x(0), y(0), w(0), h(0), position(MessagePosition::BottomCenter),
-          color(kNone), enabled(false) { }
+          color(kNone), enabled(false), dirty(true) { }
     };
     Message myMsg;
     Message myStatsMsg;
     bool myStatsEnabled;
     uInt32 myLastScanlines;
 
+    // Surface and size of the frame timing telemetry graph
+    shared_ptr<FBSurface> myTelemetrySurface;
+    static constexpr uInt32 TELEMETRY_WIDTH = 256, TELEMETRY_HEIGHT = 64;
+
     bool myGrabMouse;
     bool myHiDPIAllowed;
     bool myHiDPIEnabled;
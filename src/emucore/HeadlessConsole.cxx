@@ -0,0 +1,352 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Cart.hxx"
+#include "CartDetector.hxx"
+#include "FSNode.hxx"
+#include "MD5.hxx"
+#include "Joystick.hxx"
+#include "Paddles.hxx"
+#include "Settings.hxx"
+#include "StateProfile.hxx"
+#include "frame-manager/FrameLayoutDetector.hxx"
+#include "frame-manager/YStartDetector.hxx"
+#include "HeadlessConsole.hxx"
+
+namespace {
+  constexpr uInt8 YSTART_EXTRA = 2;
+
+  shared_ptr<ByteBuffer> copyImage(const ByteBuffer& image, uInt32 size)
+  {
+    shared_ptr<ByteBuffer> copy = make_shared<ByteBuffer>(make_unique<uInt8[]>(size));
+    std::copy_n(image.get(), size, copy->get());
+
+    return copy;
+  }
+
+  unique_ptr<Cartridge> createCartridge(const ByteBuffer& image, uInt32 size,
+      const Properties& props, Settings& settings)
+  {
+    string md5 = MD5::hash(image, size);
+    unique_ptr<Cartridge> cart = CartDetector::create(FilesystemNode(), image,
+        size, md5, props.get(PropType::Cart_Type), settings);
+
+    if(!cart)
+      throw runtime_error("Unable to determine cartridge type");
+
+    return cart;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+HeadlessConsole::HeadlessConsole(const ByteBuffer& image, uInt32 size,
+                                 Settings& settings, const Properties& props,
+                                 uInt32 seed)
+  : HeadlessConsole(copyImage(image, size), size, settings, props, seed)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+HeadlessConsole::HeadlessConsole(const shared_ptr<ByteBuffer>& image,
+                                 uInt32 size, Settings& settings,
+                                 const Properties& props, uInt32 seed)
+  : myImage(image),
+    myImageSize(size),
+    mySettings(settings),
+    myProperties(props),
+    myCart(createCartridge(*image, size, props, settings)),
+    myRandom(seed),
+    my6502(settings),
+    myRiot(*this, settings),
+    myTIA(*this, [this]() { return myConsoleTiming; }, settings),
+    mySystem(myRandom, my6502, myRiot, myTIA, *myCart),
+    myConsoleTiming(ConsoleTiming::ntsc),
+    myFrames(0)
+{
+  myLeftControl  = createController(Controller::Jack::Left, PropType::Controller_Left);
+  myRightControl = createController(Controller::Jack::Right, PropType::Controller_Right);
+  mySwitches = make_unique<Switches>(myEvent, myProperties, mySettings);
+
+  myTIA.bindToControllers();
+  myCart->setStartBankFromPropsFunc([this]() {
+    const string& startbank = myProperties.get(PropType::Cart_StartBank);
+    return startbank == EmptyString ? -1 : atoi(startbank.c_str());
+  });
+  myCart->setThumbFastMode(myProperties.get(PropType::Cart_ThumbFast) == "YES");
+  mySystem.initialize();
+
+  detectFrameLayout();
+
+  reset();
+  mySystem.consoleChanged(myConsoleTiming);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+HeadlessConsole::~HeadlessConsole()
+{
+  myLeftControl->close();
+  myRightControl->close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<Controller> HeadlessConsole::createController(
+    Controller::Jack jack, PropType type) const
+{
+  switch(Controller::getType(myProperties.get(type)))
+  {
+    case Controller::Type::Paddles:
+    case Controller::Type::PaddlesIAxis:
+    case Controller::Type::PaddlesIAxDr:
+    {
+      bool swapPaddles = myProperties.get(PropType::Controller_SwapPaddles) == "YES";
+      return make_unique<Paddles>(jack, myEvent, mySystem, swapPaddles, false, false);
+    }
+
+    default:
+      return make_unique<Joystick>(jack, myEvent, mySystem);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FrameLayout HeadlessConsole::detectLayout()
+{
+  FrameLayoutDetector frameLayoutDetector;
+  myTIA.setFrameManager(&frameLayoutDetector);
+  mySystem.reset(true);
+  myRiot.update();
+
+  for(int i = 0; i < 60 && !frameLayoutDetector.isConfident(); ++i) myTIA.update();
+
+  myTIA.setFrameManager(&myFrameManager);
+
+  return frameLayoutDetector.detectedLayout();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 HeadlessConsole::detectYStart(FrameLayout layout)
+{
+  YStartDetector ystartDetector;
+  ystartDetector.setLayout(layout);
+  myTIA.setFrameManager(&ystartDetector);
+  mySystem.reset(true);
+  myRiot.update();
+
+  for(int i = 0; i < 80 && !ystartDetector.isConfident(); ++i) myTIA.update();
+
+  myTIA.setFrameManager(&myFrameManager);
+
+  return ystartDetector.detectedYStart() - YSTART_EXTRA;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void HeadlessConsole::detectFrameLayout()
+{
+  // This mirrors the autodetection in Console, without touching the
+  // (shared) settings
+  string format = myProperties.get(PropType::Display_Format);
+  if(format == "AUTO")
+    format = detectLayout() == FrameLayout::pal ? "PAL" : "NTSC";
+
+  const FrameLayout layout =
+    format == "NTSC" || format == "PAL60" || format == "SECAM60" ?
+    FrameLayout::ntsc : FrameLayout::pal;
+
+  if(format == "PAL" || format == "PAL60")
+    myConsoleTiming = ConsoleTiming::pal;
+  else if(format == "SECAM" || format == "SECAM60")
+    myConsoleTiming = ConsoleTiming::secam;
+  else
+    myConsoleTiming = ConsoleTiming::ntsc;
+
+  uInt32 ystart = atoi(myProperties.get(PropType::Display_YStart).c_str());
+  if(ystart != 0)
+    ystart = BSPF::clamp(ystart, 0u, TIAConstants::maxYStart);
+  else
+    ystart = detectYStart(layout);
+
+  myTIA.setFrameManager(&myFrameManager);
+  myTIA.setLayout(layout);
+  myTIA.setYStart(ystart);
+
+  // Remember the results, so that clones don't need to detect them again
+  myProperties.set(PropType::Display_Format, format);
+  myProperties.set(PropType::Display_YStart, std::to_string(ystart));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void HeadlessConsole::reset()
+{
+  myEvent.clear();
+  myDispatchResult.setOk(0);
+  myFrames = 0;
+
+  mySystem.reset();
+  myRiot.update();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HeadlessConsole::step(const Input* inputs, uInt32 count)
+{
+  if(!ok())
+    return false;
+
+  setInputs(inputs, count);
+
+  // The CPU stops at the end of each frame, so this usually takes a
+  // single update
+  do
+  {
+    myTIA.update(myDispatchResult);
+    if(!ok())
+      return false;
+  }
+  while(!myTIA.newFramePending());
+
+  // The completed frame stays in the back buffer until emulation resumes,
+  // so it isn't copied to the frame buffer
+  myTIA.clearPendingFrame();
+  ++myFrames;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HeadlessConsole::stepInstruction()
+{
+  if(!ok())
+    return false;
+
+  myTIA.update(myDispatchResult, 1);
+  if(!ok())
+    return false;
+
+  if(myTIA.newFramePending())
+  {
+    myTIA.clearPendingFrame();
+    ++myFrames;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void HeadlessConsole::setInputs(const Input* inputs, uInt32 count)
+{
+  myEvent.clear();
+  for(uInt32 i = 0; i < count; ++i)
+    myEvent.set(inputs[i].event, inputs[i].value);
+  myRiot.update();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+unique_ptr<HeadlessConsole> HeadlessConsole::clone() const
+{
+  unique_ptr<HeadlessConsole> console(new HeadlessConsole(
+      myImage, myImageSize, mySettings, myProperties, 0));
+
+  Snapshot snapshot;
+  if(!saveSnapshot(snapshot) || !console->loadSnapshot(snapshot))
+    throw runtime_error("Unable to clone console state");
+
+  return console;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HeadlessConsole::saveSnapshot(Snapshot& snapshot) const
+{
+  // The state has the same size every time, so the buffer is only
+  // allocated (measured by a dry run) on first use
+  if(snapshot.myData.empty())
+  {
+    Serializer sizer(static_cast<void*>(nullptr), ~size_t(0));
+    if(!save(sizer))
+      return false;
+
+    snapshot.myData.resize(sizer.size());
+  }
+
+  Serializer out(snapshot.myData.data(), snapshot.myData.size());
+  if(!save(out))
+  {
+    snapshot.mySize = 0;
+    return false;
+  }
+  snapshot.mySize = out.size();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HeadlessConsole::loadSnapshot(const Snapshot& snapshot)
+{
+  if(snapshot.mySize == 0)
+    return false;
+
+  Serializer in(static_cast<const void*>(snapshot.myData.data()), snapshot.mySize);
+
+  return load(in);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HeadlessConsole::save(Serializer& out) const
+{
+  try
+  {
+    if(!StateProfile::save(mySystem, out, "System"))
+      return false;
+
+    if(!(StateProfile::save(*myLeftControl, out, "LeftController") &&
+         StateProfile::save(*myRightControl, out, "RightController") &&
+         StateProfile::save(*mySwitches, out, "Switches")))
+      return false;
+
+    out.putInt(myFrames);
+  }
+  catch(...)
+  {
+    cerr << "ERROR: HeadlessConsole::save" << endl;
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool HeadlessConsole::load(Serializer& in)
+{
+  try
+  {
+    if(!StateProfile::load(mySystem, in, "System"))
+      return false;
+
+    if(!(StateProfile::load(*myLeftControl, in, "LeftController") &&
+         StateProfile::load(*myRightControl, in, "RightController") &&
+         StateProfile::load(*mySwitches, in, "Switches")))
+      return false;
+
+    myFrames = in.getInt();
+  }
+  catch(...)
+  {
+    cerr << "ERROR: HeadlessConsole::load" << endl;
+    return false;
+  }
+
+  myDispatchResult.setOk(0);
+
+  return true;
+}
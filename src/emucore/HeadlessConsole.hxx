@@ -0,0 +1,292 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef HEADLESS_CONSOLE_HXX
+#define HEADLESS_CONSOLE_HXX
+
+class Cartridge;
+class Settings;
+
+#include "bspf.hxx"
+#include "ConsoleIO.hxx"
+#include "ConsoleTiming.hxx"
+#include "Control.hxx"
+#include "DispatchResult.hxx"
+#include "Event.hxx"
+#include "M6502.hxx"
+#include "M6532.hxx"
+#include "Props.hxx"
+#include "Random.hxx"
+#include "Serializable.hxx"
+#include "Switches.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+#include "frame-manager/FrameManager.hxx"
+#include "FrameLayout.hxx"
+
+/**
+  A console without an OSystem, for embedding the emulation core in
+  applications which run many consoles side by side in one process (for
+  example to train agents with reinforcement learning).
+
+  All state lives in the object: the ROM, the random number generator,
+  the event object carrying the inputs and the emulated devices.  Nothing
+  is drawn, no sound is generated, and no files are read or written.  The
+  settings are only read, so one Settings object can be shared by any
+  number of instances, as long as it isn't changed while they run.
+
+  With the (temporary) setting 'lean' enabled, the devices skip everything
+  only the debugger or a display would use: the access flags of the
+  cartridge, RIOT and TIA, the framebuffer of the TIA and one of its three
+  frame buffers.  This saves about 100 KB per instance (and more for large
+  ROMs), which matters when running thousands of them.
+  Read-only data (ROM images, TIA tables) is shared by all instances
+  anyway.
+
+  Emulation is deterministic for a given ROM, seed and input sequence, and
+  stepping a frame doesn't allocate memory.  Different instances may be
+  stepped concurrently from different threads; a single instance must not.
+
+  Only joysticks and paddles are supported as controllers, as given by the
+  properties (joysticks by default).
+
+  For branching simulations, the state can be saved to and restored from
+  a Snapshot, and a console can be cloned.  Clones share the ROM image and
+  the autodetection results of the original, so cloning doesn't emulate
+  any frames.
+
+  @author  Stephen Anthony
+*/
+class HeadlessConsole : public Serializable, public ConsoleIO
+{
+  public:
+    /**
+      An input for the next frame; 'value' is 1 for pressed buttons and
+      directions, and the resistance for analog paddle events.
+    */
+    struct Input {
+      Event::Type event;
+      Int32 value;
+    };
+
+    /**
+      The saved state of a console.  Its buffer is allocated by the first
+      save, and reused by later saves (of the same console or its clones),
+      so saving and restoring a snapshot doesn't allocate.
+    */
+    class Snapshot
+    {
+      public:
+        Snapshot() : mySize(0) { }
+
+        /**
+          The size of the saved state in bytes, or 0 if nothing was saved.
+        */
+        size_t size() const { return mySize; }
+
+      private:
+        vector<uInt8> myData;
+        size_t mySize;
+
+      friend class HeadlessConsole;
+    };
+
+  public:
+    /**
+      Create a console for the given ROM image.  The display format and
+      controllers are taken from the properties, if given; the bankswitch
+      type and display format are autodetected otherwise.
+
+      @param image     The ROM image
+      @param size      The size of the ROM image
+      @param settings  The settings used by the devices
+      @param props     The properties of the ROM
+      @param seed      The seed for the random number generator
+
+      @throws runtime_error if the ROM can't be used
+    */
+    HeadlessConsole(const ByteBuffer& image, uInt32 size, Settings& settings,
+                    const Properties& props = Properties(), uInt32 seed = 0);
+    virtual ~HeadlessConsole();
+
+  public:
+    /**
+      Create a new console running the same ROM, in the same state.
+    */
+    unique_ptr<HeadlessConsole> clone() const;
+
+    /**
+      Save the current state to the snapshot.
+
+      @return  False on any errors
+    */
+    bool saveSnapshot(Snapshot& snapshot) const;
+
+    /**
+      Restore the state saved in the snapshot, which must have been taken
+      from this console or a clone of it.  The frame isn't part of the
+      state; frame() is valid again after the next step.
+
+      @return  False on any errors
+    */
+    bool loadSnapshot(const Snapshot& snapshot);
+
+    /**
+      Save/load the state of the console (Serializable interface).
+    */
+    bool save(Serializer& out) const override;
+    bool load(Serializer& in) override;
+
+    /**
+      Reset the console to its power-on state.
+    */
+    void reset();
+
+    /**
+      Run frame layout autodetection from power-on.  The console is left
+      in an undefined state; reset() it before stepping.
+
+      @return  The detected frame layout
+    */
+    FrameLayout detectLayout();
+
+    /**
+      Run ystart autodetection for the given frame layout from power-on.
+      The console is left in an undefined state; reset() it before
+      stepping.
+
+      @return  The detected ystart
+    */
+    uInt32 detectYStart(FrameLayout layout);
+
+    /**
+      Emulate one frame with the given inputs.  Inputs hold for the whole
+      frame; all events which are not given are released.
+
+      @param inputs  The inputs for this frame
+      @param count   The number of inputs
+
+      @return  False if the emulation failed (e.g. a fatal ARM error)
+    */
+    bool step(const Input* inputs = nullptr, uInt32 count = 0);
+
+    /**
+      Emulate a single CPU instruction, with the inputs of the last step
+      or setInputs() call.  A frame completed by the instruction counts as
+      a step of its own.
+
+      @return  False if the emulation failed
+    */
+    bool stepInstruction();
+
+    /**
+      Replace the current inputs, without emulating anything; all events
+      which are not given are released.
+
+      @param inputs  The new inputs
+      @param count   The number of inputs
+    */
+    void setInputs(const Input* inputs, uInt32 count);
+
+    /**
+      Answer whether the emulation is still running (i.e. the last step
+      didn't fail).
+    */
+    bool ok() const {
+      return myDispatchResult.getStatus() != DispatchResult::Status::fatal;
+    }
+
+    /**
+      The frame completed by the last step, as indices into the TIA
+      palette, 'frameWidth()' pixels per line and 'frameHeight()' lines.
+      This is the TIA back buffer, which is only valid until the next step.
+    */
+    const uInt8* frame() { return myTIA.outputBuffer(); }
+    uInt32 frameWidth() const  { return myTIA.width();  }
+    uInt32 frameHeight() const { return myTIA.height(); }
+
+    /**
+      The 128 bytes of RIOT RAM, as of the end of the last step.
+    */
+    const uInt8* ram() const { return myRiot.getRAM(); }
+
+    /**
+      The number of frames emulated since the last reset.
+    */
+    uInt32 frames() const { return myFrames; }
+
+    /**
+      The console timing (NTSC, PAL or SECAM) in use.
+    */
+    ConsoleTiming timing() const { return myConsoleTiming; }
+
+    /**
+      Access to the emulated devices.
+    */
+    System& system() { return mySystem; }
+    TIA& tia() { return myTIA; }
+    Event& event() { return myEvent; }
+
+    // ConsoleIO interface
+    Controller& leftController() const override  { return *myLeftControl;  }
+    Controller& rightController() const override { return *myRightControl; }
+    Switches& switches() const override { return *mySwitches; }
+
+  private:
+    HeadlessConsole(const shared_ptr<ByteBuffer>& image, uInt32 size,
+                    Settings& settings, const Properties& props, uInt32 seed);
+
+    unique_ptr<Controller> createController(Controller::Jack jack,
+                                            PropType type) const;
+    void detectFrameLayout();
+
+  private:
+    // The ROM image is shared with all clones
+    shared_ptr<ByteBuffer> myImage;
+    uInt32 myImageSize;
+
+    Settings& mySettings;
+    Properties myProperties;
+
+    unique_ptr<Cartridge> myCart;
+    Random myRandom;
+    Event myEvent;
+
+    M6502 my6502;
+    M6532 myRiot;
+    TIA myTIA;
+    System mySystem;
+    FrameManager myFrameManager;
+
+    unique_ptr<Controller> myLeftControl;
+    unique_ptr<Controller> myRightControl;
+    unique_ptr<Switches> mySwitches;
+
+    ConsoleTiming myConsoleTiming;
+    DispatchResult myDispatchResult;
+    uInt32 myFrames;
+
+  private:
+    // Following constructors and assignment operators not supported
+    HeadlessConsole() = delete;
+    HeadlessConsole(const HeadlessConsole&) = delete;
+    HeadlessConsole(HeadlessConsole&&) = delete;
+    HeadlessConsole& operator=(const HeadlessConsole&) = delete;
+    HeadlessConsole& operator=(HeadlessConsole&&) = delete;
+};
+
+#endif // HEADLESS_CONSOLE_HXX
@@ -0,0 +1,267 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Serializer.hxx"
+#include "InputMovie.hxx"
+
+namespace {
+  constexpr char MOVIE_HEADER[] = "06000003movie";
+
+  // The properties stored in a movie, enough to create a HeadlessConsole
+  constexpr PropType ourProperties[] = {
+    PropType::Cart_MD5, PropType::Cart_Name, PropType::Cart_Type,
+    PropType::Display_Format, PropType::Display_YStart,
+    PropType::Controller_Left, PropType::Controller_Right,
+    PropType::Controller_SwapPaddles
+  };
+
+  // Values are stored zigzag encoded, so that small negative numbers
+  // are short as well
+  uInt32 encodeValue(Int32 value)
+  {
+    return (uInt32(value) << 1) ^ uInt32(value >> 31);
+  }
+
+  Int32 decodeValue(uInt32 number)
+  {
+    return Int32(number >> 1) ^ -Int32(number & 1);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+InputMovie::InputMovie()
+  : myFrames(0),
+    myUnchangedFrames(0),
+    myReadPos(0),
+    myFramesPlayed(0),
+    myFramesToChange(0)
+{
+  std::fill_n(myValues, Event::LastType, 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::isRecorded(Event::Type type)
+{
+  return (type >= Event::ConsoleColor && type <= Event::KeyboardOnePound) ||
+         type == Event::MouseButtonLeftValue ||
+         type == Event::MouseButtonRightValue;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void InputMovie::startRecording(const Properties& props, const uInt8* state,
+                                size_t size)
+{
+  myProperties = Properties();
+  for(PropType key: ourProperties)
+    myProperties.set(key, props.get(key));
+  myState.assign(state, state + size);
+
+  myInputs.clear();
+  myFrames = 0;
+  myUnchangedFrames = 0;
+  std::fill_n(myValues, Event::LastType, 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void InputMovie::recordFrame(const Event& event)
+{
+  myChanges.clear();
+  for(Int32 i = 0; i < Event::LastType; ++i)
+  {
+    const Event::Type type = Event::Type(i);
+    if(!isRecorded(type))
+      continue;
+
+    const Int32 value = event.get(type);
+    if(value != myValues[i])
+    {
+      myValues[i] = value;
+      myChanges.emplace_back(type, value);
+    }
+  }
+  ++myFrames;
+
+  if(myChanges.empty())
+  {
+    ++myUnchangedFrames;
+    return;
+  }
+
+  putNumber(myUnchangedFrames);
+  putNumber(uInt32(myChanges.size()));
+  for(const auto& change: myChanges)
+  {
+    putNumber(change.first);
+    putNumber(encodeValue(change.second));
+  }
+  myUnchangedFrames = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void InputMovie::startPlayback()
+{
+  std::fill_n(myValues, Event::LastType, 0);
+  myReadPos = 0;
+  myFramesPlayed = 0;
+  myFramesToChange = getUnchangedFrames();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::playFrame()
+{
+  if(finished())
+    return false;
+
+  if(myFramesToChange == 0)
+  {
+    // The event types have been validated by load()
+    for(uInt32 count = getNumber(); count > 0; --count)
+    {
+      const uInt32 type = getNumber();
+      myValues[type] = decodeValue(getNumber());
+    }
+    myFramesToChange = getUnchangedFrames();
+  }
+  else
+    --myFramesToChange;
+
+  ++myFramesPlayed;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void InputMovie::applyInputs(Event& event) const
+{
+  for(Int32 i = 0; i < Event::LastType; ++i)
+    if(isRecorded(Event::Type(i)))
+      event.set(Event::Type(i), myValues[i]);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 InputMovie::getUnchangedFrames()
+{
+  // After the last change, the inputs stay the same until the end
+  return myReadPos < myInputs.size() ? getNumber() : myFrames;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void InputMovie::putNumber(uInt32 number)
+{
+  while(number >= 0x80)
+  {
+    myInputs.push_back(uInt8(number | 0x80));
+    number >>= 7;
+  }
+  myInputs.push_back(uInt8(number));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 InputMovie::getNumber()
+{
+  uInt32 number = 0;
+  for(uInt32 shift = 0; shift < 32; shift += 7)
+  {
+    if(myReadPos >= myInputs.size())
+      throw runtime_error("InputMovie: read past end of inputs");
+
+    const uInt8 byte = myInputs[myReadPos++];
+    number |= uInt32(byte & 0x7f) << shift;
+    if(!(byte & 0x80))
+      return number;
+  }
+  throw runtime_error("InputMovie: invalid number");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::save(const string& filename) const
+{
+  Serializer out(filename, Serializer::Mode::ReadWriteTrunc);
+  if(!out)
+    return false;
+
+  try
+  {
+    out.putString(MOVIE_HEADER);
+    out.putInt(Event::VERSION);
+
+    for(PropType key: ourProperties)
+      out.putString(myProperties.get(key));
+
+    out.putInt(uInt32(myState.size()));
+    out.putByteArray(myState.data(), uInt32(myState.size()));
+
+    out.putInt(myFrames);
+    out.putInt(uInt32(myInputs.size()));
+    out.putByteArray(myInputs.data(), uInt32(myInputs.size()));
+  }
+  catch(...)
+  {
+    cerr << "ERROR: InputMovie::save" << endl;
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool InputMovie::load(const string& filename)
+{
+  Serializer in(filename, Serializer::Mode::ReadOnly);
+  if(!in)
+    return false;
+
+  try
+  {
+    if(in.getString() != MOVIE_HEADER || in.getInt() != uInt32(Event::VERSION))
+      return false;
+
+    myProperties = Properties();
+    for(PropType key: ourProperties)
+      myProperties.set(key, in.getString());
+
+    myState.resize(in.getInt());
+    in.getByteArray(myState.data(), uInt32(myState.size()));
+
+    myFrames = in.getInt();
+    myInputs.resize(in.getInt());
+    in.getByteArray(myInputs.data(), uInt32(myInputs.size()));
+
+    // Check the encoded inputs once, so playback can't go astray
+    myReadPos = 0;
+    while(myReadPos < myInputs.size())
+    {
+      getNumber();
+      for(uInt32 count = getNumber(); count > 0; --count)
+      {
+        const uInt32 type = getNumber();
+        if(type >= Event::LastType || !isRecorded(Event::Type(type)))
+          return false;
+        getNumber();
+      }
+    }
+  }
+  catch(...)
+  {
+    cerr << "ERROR: InputMovie::load" << endl;
+    return false;
+  }
+
+  startPlayback();
+
+  return true;
+}
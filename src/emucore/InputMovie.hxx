@@ -0,0 +1,169 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef INPUT_MOVIE_HXX
+#define INPUT_MOVIE_HXX
+
+#include "bspf.hxx"
+#include "Event.hxx"
+#include "Props.hxx"
+
+/**
+  An input movie: a starting state plus the inputs of every following
+  frame, for recording a game session and replaying it deterministically.
+
+  Inputs are sampled once per frame, at the start of the frame, and only
+  changes are stored: a frame without changes costs nothing, and a frame
+  with changes costs a few bytes.  So a movie is typically a few KB,
+  instead of a full state per frame.
+
+  The state has the layout of HeadlessConsole::save() (a Console state
+  followed by the frame count), so a movie can be replayed either by a
+  Console or by a HeadlessConsole.  The properties needed to create a
+  matching HeadlessConsole are stored along with it.
+
+  The recorded inputs are the console switches, the joystick, paddle and
+  keyboard events and the mouse buttons.  Mouse motion is relative to the
+  last host event poll, so it isn't recorded, and neither is the CompuMate
+  keyboard, which the cartridge reads directly.
+
+  @author  Stephen Anthony
+*/
+class InputMovie
+{
+  public:
+    InputMovie();
+
+  public:
+    /**
+      Start a new recording, discarding any recorded frames.
+
+      @param props  The properties of the ROM (see HeadlessConsole)
+      @param state  The starting state
+      @param size   The size of the starting state
+    */
+    void startRecording(const Properties& props, const uInt8* state, size_t size);
+
+    /**
+      Append the inputs of the next frame.
+
+      @param event  The event object holding the current inputs
+    */
+    void recordFrame(const Event& event);
+
+    /**
+      Rewind to the first frame for playback.
+    */
+    void startPlayback();
+
+    /**
+      Advance to the next frame and get its inputs.
+
+      @return  False if all frames have been played; the inputs of the
+               last frame stay in effect
+    */
+    bool playFrame();
+
+    /**
+      Set all recorded events of the event object to the inputs of the
+      current frame.
+    */
+    void applyInputs(Event& event) const;
+
+    /**
+      The value of an event in the current frame (0 for events which
+      aren't recorded).
+    */
+    Int32 value(Event::Type type) const { return myValues[type]; }
+
+    /**
+      Answer whether the given event is recorded in movies.
+    */
+    static bool isRecorded(Event::Type type);
+
+    /**
+      Save the movie to a file, or load it from one.
+
+      @return  False on any errors
+    */
+    bool save(const string& filename) const;
+    bool load(const string& filename);
+
+    /**
+      The properties and starting state of the movie.
+    */
+    const Properties& properties() const { return myProperties; }
+    const vector<uInt8>& state() const { return myState; }
+
+    /**
+      The number of frames recorded, and the number of frames played.
+    */
+    uInt32 frames() const { return myFrames; }
+    uInt32 framesPlayed() const { return myFramesPlayed; }
+
+    /**
+      Answer whether playback has reached the end of the movie.
+    */
+    bool finished() const { return myFramesPlayed >= myFrames; }
+
+    /**
+      The size of the encoded inputs in bytes.
+    */
+    size_t inputSize() const { return myInputs.size(); }
+
+  private:
+    // Variable length numbers in myInputs, 7 bits per byte
+    void putNumber(uInt32 number);
+    uInt32 getNumber();
+
+    // The number of frames before the next change, during playback
+    uInt32 getUnchangedFrames();
+
+  private:
+    Properties myProperties;
+    vector<uInt8> myState;
+
+    // The encoded inputs: for every frame with changes, the number of
+    // preceding frames without changes, the number of changes, and the
+    // event type and value of each change (all variable length numbers);
+    // the frames after the last change have no changes
+    vector<uInt8> myInputs;
+    uInt32 myFrames;
+
+    // The inputs of the current frame
+    Int32 myValues[Event::LastType];
+
+    // Recording: the number of frames since the last change, and the
+    // changes of the current frame
+    uInt32 myUnchangedFrames;
+    vector<std::pair<Event::Type, Int32>> myChanges;
+
+    // Playback: the read position in myInputs, and the number of frames
+    // left before the next change
+    size_t myReadPos;
+    uInt32 myFramesPlayed;
+    uInt32 myFramesToChange;
+
+  private:
+    // Following constructors and assignment operators not supported
+    InputMovie(const InputMovie&) = delete;
+    InputMovie(InputMovie&&) = delete;
+    InputMovie& operator=(const InputMovie&) = delete;
+    InputMovie& operator=(InputMovie&&) = delete;
+};
+
+#endif
@@ -15,10 +15,14 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <type_traits>
+
 #ifdef DEBUGGER_SUPPORT
   #include "Debugger.hxx"
   #include "Expression.hxx"
   #include "CartDebug.hxx"
+  #include "TraceRecorder.hxx"
+  #include "CycleProfiler.hxx"
   #include "Base.hxx"
 
   // Flags for disassembly types
@@ -51,6 +55,57 @@
 #include "exception/EmulationWarning.hxx"
 #include "exception/FatalEmulationError.hxx"
 
+// With THREADED_DISPATCH, the instructions from M6502.ins become labels that
+// are dispatched through a jump table (computed goto). Each instruction then
+// ends with its own indirect jump, which predicts much better than the single
+// jump of a switch. This relies on a GCC / clang extension.
+#if defined(THREADED_DISPATCH) && defined(__GNUC__)
+  #define M6502_THREADED_DISPATCH
+  #define M6502_OPCODE(_op) M6502_op_##_op:
+  #define M6502_OPCODE_END goto M6502_done;
+  #define M6502_LABEL(_op) &&M6502_op_##_op
+#endif
+
+namespace {
+  // How the instructions allowed in a block of code access memory
+  enum class BlockAccess: uInt8 { none, implied, immediate, zpRead, zpWrite, zpModify };
+
+  BlockAccess blockAccess(uInt8 opcode)
+  {
+    switch(opcode)
+    {
+      case 0xaa: case 0xa8: case 0x8a: case 0x98:  // TAX TAY TXA TYA
+      case 0xba: case 0x9a:                        // TSX TXS
+      case 0xe8: case 0xc8: case 0xca: case 0x88:  // INX INY DEX DEY
+      case 0x18: case 0x38: case 0xb8: case 0xea:  // CLC SEC CLV NOP
+      case 0x0a: case 0x4a: case 0x2a: case 0x6a:  // ASL LSR ROL ROR A
+        return BlockAccess::implied;
+
+      case 0xa9: case 0xa2: case 0xa0:             // LDA LDX LDY #
+      case 0x29: case 0x09: case 0x49:             // AND ORA EOR #
+      case 0x69: case 0xe9:                        // ADC SBC #
+      case 0xc9: case 0xe0: case 0xc0:             // CMP CPX CPY #
+        return BlockAccess::immediate;
+
+      case 0xa5: case 0xa6: case 0xa4:             // LDA LDX LDY zp
+      case 0x25: case 0x05: case 0x45:             // AND ORA EOR zp
+      case 0x65: case 0xe5:                        // ADC SBC zp
+      case 0xc5: case 0xe4: case 0xc4: case 0x24:  // CMP CPX CPY BIT zp
+        return BlockAccess::zpRead;
+
+      case 0x85: case 0x86: case 0x84:             // STA STX STY zp
+        return BlockAccess::zpWrite;
+
+      case 0xe6: case 0xc6:                        // INC DEC zp
+      case 0x06: case 0x46: case 0x26: case 0x66:  // ASL LSR ROL ROR zp
+        return BlockAccess::zpModify;
+
+      default:
+        return BlockAccess::none;
+    }
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 M6502::M6502(const Settings& settings)
   : myExecutionStatus(0),
@@ -60,6 +115,7 @@ M6502::M6502(const Settings& settings)
     N(false), V(false), B(false), D(false), I(false), notZ(false), C(false),
     icycles(0),
     myNumberOfDistinctAccesses(0),
+    myInstructions(0),
     myLastAddress(0),
     myLastBreakCycle(ULLONG_MAX),
     myLastPeekAddress(0),
@@ -74,6 +130,7 @@ M6502::M6502(const Settings& settings)
     myDataAddressForPoke(0),
     myOnHaltCallback(nullptr),
     myHaltRequested(false),
+    myBlocksEnabled(false),
     myGhostReadsTrap(false),
     myReadFromWritePortBreak(false),
     myStepStateByInstruction(false)
@@ -81,6 +138,8 @@ M6502::M6502(const Settings& settings)
 #ifdef DEBUGGER_SUPPORT
   myDebugger = nullptr;
   myJustHitReadTrapFlag = myJustHitWriteTrapFlag = false;
+  myTraceRecorder = nullptr;
+  myProfiler = nullptr;
 #endif
 }
 
@@ -126,6 +185,10 @@ void M6502::reset()
   myGhostReadsTrap = mySettings.getBool("dbg.ghostreadstrap");
   myReadFromWritePortBreak = devSettings ? mySettings.getBool("dev.rwportbreak") : false;
 
+  myBlocksEnabled = mySettings.getBool("cpu.blocks");
+  if(myBlocksEnabled && myBlockCache.empty())
+    myBlockCache.resize(BLOCK_CACHE_SIZE);
+
   myLastBreakCycle = ULLONG_MAX;
 }
 
@@ -164,6 +227,8 @@ inline uInt8 M6502::peek(uInt16 address, uInt8 flags)
       myHitTrapInfo.address = address;
     }
   }
+  if(myTraceRecorder && flags == DISASM_CODE)
+    myTraceRecorder->addCodeByte(result);
 #endif  // DEBUGGER_SUPPORT
 
   return result;
@@ -221,7 +286,16 @@ inline void M6502::handleHalt()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::execute(uInt64 number, DispatchResult& result)
 {
-  _execute(number, result);
+  System::ZoneGuard zone(*mySystem, System::Zone::cpu);
+
+#ifdef DEBUGGER_SUPPORT
+  // Only pay for the per-instruction debugger checks when there is
+  // something to check for
+  if(needsDebuggerChecks())
+    _execute<true>(number, result);
+  else
+#endif
+    _execute<false>(number, result);
 
 #ifdef DEBUGGER_SUPPORT
   // Debugger hack: this ensures that stepping a "STA WSYNC" will actually end at the
@@ -249,6 +323,7 @@ bool M6502::execute(uInt64 number)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool debuggerChecks>
 inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
 {
   myExecutionStatus = 0;
@@ -261,14 +336,127 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
   uInt64 previousCycles = mySystem->cycles();
   uInt64 currentCycles = 0;
 
+  // Without debugger checks, the instructions work on copies of the
+  // registers, which the compiler can keep in host registers; they are
+  // written back whenever anything else may look at them.  The debugger
+  // checks (breakpoints, traps, ...) evaluate expressions on the CPU itself,
+  // so the registers are only aliased then.
+  using Reg8  = typename std::conditional<debuggerChecks, uInt8&, uInt8>::type;
+  using Reg16 = typename std::conditional<debuggerChecks, uInt16&, uInt16>::type;
+  using Flag  = typename std::conditional<debuggerChecks, bool&, bool>::type;
+
+  Reg8 A = this->A, X = this->X, Y = this->Y, SP = this->SP;
+  Reg16 PC = this->PC;
+  Flag N = this->N, V = this->V, B = this->B, D = this->D, I = this->I,
+       notZ = this->notZ, C = this->C;
+
+  const auto storeRegisters = [&] {
+    this->A = A;  this->X = X;  this->Y = Y;  this->SP = SP;  this->PC = PC;
+    this->N = N;  this->V = V;  this->B = B;  this->D = D;  this->I = I;
+    this->notZ = notZ;  this->C = C;
+  };
+  const auto loadRegisters = [&] {
+    A = this->A;  X = this->X;  Y = this->Y;  SP = this->SP;  PC = this->PC;
+    N = this->N;  V = this->V;  B = this->B;  D = this->D;  I = this->I;
+    notZ = this->notZ;  C = this->C;
+  };
+
+  // Without debugger checks, blocks of straight-line code (see CodeBlock)
+  // run the same instructions, but reading the code from its page and
+  // accessing the RIOT RAM directly
+  uInt8* blockRAM = nullptr;
+  if(!debuggerChecks && myBlocksEnabled)
+  {
+    M6532& riot = mySystem->m6532();
+    if(mySystem->getPageAccess(0x80).device == &riot &&
+       mySystem->getPageAccess(0xC0).device == &riot)
+      blockRAM = riot.getRAM();
+  #ifdef DEBUGGER_SUPPORT
+    // Every access must be flagged for the disassembly
+    if(mySystem->accessFlagsEnabled())
+      blockRAM = nullptr;
+  #endif
+  }
+
+  const auto runBlock = [&](uInt64 budget) {
+    // The block must neither exceed the timeslice nor pass a deadline
+    const CodeBlock* block = findBlock(PC);
+    const uInt32 blockCycles = block ? block->cycles * SYSTEM_CYCLES_PER_CPU : 0;
+    if(!block || blockCycles > budget ||
+       mySystem->cycles() + blockCycles > mySystem->nextDeadline())
+      return false;
+
+    const uInt8* code = block->start - (PC & System::PAGE_MASK);
+    uInt16 lastAddress = myLastAddress;
+    uInt32 distinctAccesses = 0;
+    uInt8 dataBus = 0;
+
+    const auto access = [&](uInt16 address) {
+      if(address != lastAddress)
+      {
+        ++distinctAccesses;
+        lastAddress = address;
+      }
+    };
+    // These hide M6502::peek() and M6502::poke() from the instructions
+    const auto peek = [&](uInt16 address, uInt8) {
+      access(address);
+      myLastPeekAddress = address;
+      return dataBus = address < 0x100 ? blockRAM[address & 0x7F] : code[address & System::PAGE_MASK];
+    };
+    const auto poke = [&](uInt16 address, uInt8 value, uInt8) {
+      access(address);
+      myLastPokeAddress = address;
+      blockRAM[address & 0x7F] = dataBus = value;
+      mySystem->setDirtyPage(address);
+    };
+
+    for(uInt32 i = 0; i < block->instructions; ++i)
+    {
+      uInt16 operandAddress = 0, intermediateAddress = 0;
+      uInt8 operand = 0;
+
+      myLastPeekAddress = myLastPokeAddress = myDataAddressForPoke = 0;
+
+      IR = peek(PC++, DISASM_CODE);
+
+    #ifdef M6502_THREADED_DISPATCH
+      #undef M6502_OPCODE
+      #undef M6502_OPCODE_END
+    #endif
+      switch(IR)
+      {
+        // Only the instructions accepted by findBlock() get here
+        #include "M6502.ins"
+      }
+    #ifdef M6502_THREADED_DISPATCH
+      #undef M6502_OPCODE
+      #undef M6502_OPCODE_END
+      #define M6502_OPCODE(_op) M6502_op_##_op:
+      #define M6502_OPCODE_END goto M6502_done;
+    #endif
+    }
+
+    mySystem->incrementCycles(blockCycles);
+    mySystem->setDataBusState(dataBus);
+    myLastAddress = lastAddress;
+    myNumberOfDistinctAccesses += distinctAccesses;
+    myInstructions += block->instructions;
+
+    return true;
+  };
+
   // Loop until execution is stopped or a fatal error occurs
   for(;;)
   {
     while (!myExecutionStatus && currentCycles < cycles * SYSTEM_CYCLES_PER_CPU)
     {
   #ifdef DEBUGGER_SUPPORT
+      // The checks look at the TIA, so it must not lag behind
+      if (debuggerChecks) tia.syncRenderThread();
+
       // Don't break if we haven't actually executed anything yet
-      if (myLastBreakCycle != mySystem->cycles()) {
+      if (debuggerChecks && myLastBreakCycle != mySystem->cycles()) {
         if(myJustHitReadTrapFlag || myJustHitWriteTrapFlag)
         {
           bool read = myJustHitReadTrapFlag;
@@ -315,17 +503,41 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
         }
       }
 
-      int cond = evalCondSaveStates();
-      if(cond > -1)
+      if(debuggerChecks)
       {
-        ostringstream msg;
-        msg << "conditional savestate [" << Common::Base::HEX2 << cond << "]";
-        myDebugger->addState(msg.str());
+        int cond = evalCondSaveStates();
+        if(cond > -1)
+        {
+          ostringstream msg;
+          msg << "conditional savestate [" << Common::Base::HEX2 << cond << "]";
+          myDebugger->addState(msg.str());
+        }
       }
 
-      mySystem->cart().clearAllRAMAccesses();
+      if(debuggerChecks && myTraceRecorder)
+        myTraceRecorder->beginInstruction(PC, mySystem->cart().getBank(PC),
+            A, X, Y, SP, PS(), mySystem->cycles(),
+            tia.scanlines(), tia.clocksThisLine());
+
+      if(debuggerChecks && myProfiler)
+        myProfiler->beginInstruction(PC, mySystem->cart().getBank(PC),
+            mySystem->cycles(), icycles, tia.scanlines(), tia.frameCount());
+
+      // Only needed to detect reads from write ports
+      if(debuggerChecks)
+        mySystem->cart().clearAllRAMAccesses();
   #endif  // DEBUGGER_SUPPORT
 
+      if(blockRAM && !myHaltRequested &&
+         runBlock(cycles * SYSTEM_CYCLES_PER_CPU - currentCycles))
+      {
+        currentCycles = (mySystem->cycles() - previousCycles);
+
+        if(mySystem->cycles() >= mySystem->nextDeadline())
+          mySystem->dispatchDeadlines();
+        continue;
+      }
+
       uInt16 operandAddress = 0, intermediateAddress = 0;
       uInt8 operand = 0;
 
@@ -340,8 +552,91 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
 
         // Fetch instruction at the program counter
         IR = peek(PC++, DISASM_CODE);  // This address represents a code section
+        ++myInstructions;
 
         // Call code to execute the instruction
+    #ifdef M6502_THREADED_DISPATCH
+      #pragma GCC diagnostic push
+      #pragma GCC diagnostic ignored "-Wpedantic"
+        static const void* const dispatchTable[256] = {
+          M6502_LABEL(0x00), M6502_LABEL(0x01), M6502_LABEL(invalid), M6502_LABEL(0x03),
+          M6502_LABEL(0x04), M6502_LABEL(0x05), M6502_LABEL(0x06), M6502_LABEL(0x07),
+          M6502_LABEL(0x08), M6502_LABEL(0x09), M6502_LABEL(0x0a), M6502_LABEL(0x0b),
+          M6502_LABEL(0x0c), M6502_LABEL(0x0d), M6502_LABEL(0x0e), M6502_LABEL(0x0f),
+          M6502_LABEL(0x10), M6502_LABEL(0x11), M6502_LABEL(invalid), M6502_LABEL(0x13),
+          M6502_LABEL(0x14), M6502_LABEL(0x15), M6502_LABEL(0x16), M6502_LABEL(0x17),
+          M6502_LABEL(0x18), M6502_LABEL(0x19), M6502_LABEL(0x1a), M6502_LABEL(0x1b),
+          M6502_LABEL(0x1c), M6502_LABEL(0x1d), M6502_LABEL(0x1e), M6502_LABEL(0x1f),
+          M6502_LABEL(0x20), M6502_LABEL(0x21), M6502_LABEL(invalid), M6502_LABEL(0x23),
+          M6502_LABEL(0x24), M6502_LABEL(0x25), M6502_LABEL(0x26), M6502_LABEL(0x27),
+          M6502_LABEL(0x28), M6502_LABEL(0x29), M6502_LABEL(0x2a), M6502_LABEL(0x2b),
+          M6502_LABEL(0x2c), M6502_LABEL(0x2d), M6502_LABEL(0x2e), M6502_LABEL(0x2f),
+          M6502_LABEL(0x30), M6502_LABEL(0x31), M6502_LABEL(invalid), M6502_LABEL(0x33),
+          M6502_LABEL(0x34), M6502_LABEL(0x35), M6502_LABEL(0x36), M6502_LABEL(0x37),
+          M6502_LABEL(0x38), M6502_LABEL(0x39), M6502_LABEL(0x3a), M6502_LABEL(0x3b),
+          M6502_LABEL(0x3c), M6502_LABEL(0x3d), M6502_LABEL(0x3e), M6502_LABEL(0x3f),
+          M6502_LABEL(0x40), M6502_LABEL(0x41), M6502_LABEL(invalid), M6502_LABEL(0x43),
+          M6502_LABEL(0x44), M6502_LABEL(0x45), M6502_LABEL(0x46), M6502_LABEL(0x47),
+          M6502_LABEL(0x48), M6502_LABEL(0x49), M6502_LABEL(0x4a), M6502_LABEL(0x4b),
+          M6502_LABEL(0x4c), M6502_LABEL(0x4d), M6502_LABEL(0x4e), M6502_LABEL(0x4f),
+          M6502_LABEL(0x50), M6502_LABEL(0x51), M6502_LABEL(invalid), M6502_LABEL(0x53),
+          M6502_LABEL(0x54), M6502_LABEL(0x55), M6502_LABEL(0x56), M6502_LABEL(0x57),
+          M6502_LABEL(0x58), M6502_LABEL(0x59), M6502_LABEL(0x5a), M6502_LABEL(0x5b),
+          M6502_LABEL(0x5c), M6502_LABEL(0x5d), M6502_LABEL(0x5e), M6502_LABEL(0x5f),
+          M6502_LABEL(0x60), M6502_LABEL(0x61), M6502_LABEL(invalid), M6502_LABEL(0x63),
+          M6502_LABEL(0x64), M6502_LABEL(0x65), M6502_LABEL(0x66), M6502_LABEL(0x67),
+          M6502_LABEL(0x68), M6502_LABEL(0x69), M6502_LABEL(0x6a), M6502_LABEL(0x6b),
+          M6502_LABEL(0x6c), M6502_LABEL(0x6d), M6502_LABEL(0x6e), M6502_LABEL(0x6f),
+          M6502_LABEL(0x70), M6502_LABEL(0x71), M6502_LABEL(invalid), M6502_LABEL(0x73),
+          M6502_LABEL(0x74), M6502_LABEL(0x75), M6502_LABEL(0x76), M6502_LABEL(0x77),
+          M6502_LABEL(0x78), M6502_LABEL(0x79), M6502_LABEL(0x7a), M6502_LABEL(0x7b),
+          M6502_LABEL(0x7c), M6502_LABEL(0x7d), M6502_LABEL(0x7e), M6502_LABEL(0x7f),
+          M6502_LABEL(0x80), M6502_LABEL(0x81), M6502_LABEL(0x82), M6502_LABEL(0x83),
+          M6502_LABEL(0x84), M6502_LABEL(0x85), M6502_LABEL(0x86), M6502_LABEL(0x87),
+          M6502_LABEL(0x88), M6502_LABEL(0x89), M6502_LABEL(0x8a), M6502_LABEL(0x8b),
+          M6502_LABEL(0x8c), M6502_LABEL(0x8d), M6502_LABEL(0x8e), M6502_LABEL(0x8f),
+          M6502_LABEL(0x90), M6502_LABEL(0x91), M6502_LABEL(invalid), M6502_LABEL(0x93),
+          M6502_LABEL(0x94), M6502_LABEL(0x95), M6502_LABEL(0x96), M6502_LABEL(0x97),
+          M6502_LABEL(0x98), M6502_LABEL(0x99), M6502_LABEL(0x9a), M6502_LABEL(0x9b),
+          M6502_LABEL(0x9c), M6502_LABEL(0x9d), M6502_LABEL(0x9e), M6502_LABEL(0x9f),
+          M6502_LABEL(0xa0), M6502_LABEL(0xa1), M6502_LABEL(0xa2), M6502_LABEL(0xa3),
+          M6502_LABEL(0xa4), M6502_LABEL(0xa5), M6502_LABEL(0xa6), M6502_LABEL(0xa7),
+          M6502_LABEL(0xa8), M6502_LABEL(0xa9), M6502_LABEL(0xaa), M6502_LABEL(0xab),
+          M6502_LABEL(0xac), M6502_LABEL(0xad), M6502_LABEL(0xae), M6502_LABEL(0xaf),
+          M6502_LABEL(0xb0), M6502_LABEL(0xb1), M6502_LABEL(invalid), M6502_LABEL(0xb3),
+          M6502_LABEL(0xb4), M6502_LABEL(0xb5), M6502_LABEL(0xb6), M6502_LABEL(0xb7),
+          M6502_LABEL(0xb8), M6502_LABEL(0xb9), M6502_LABEL(0xba), M6502_LABEL(0xbb),
+          M6502_LABEL(0xbc), M6502_LABEL(0xbd), M6502_LABEL(0xbe), M6502_LABEL(0xbf),
+          M6502_LABEL(0xc0), M6502_LABEL(0xc1), M6502_LABEL(0xc2), M6502_LABEL(0xc3),
+          M6502_LABEL(0xc4), M6502_LABEL(0xc5), M6502_LABEL(0xc6), M6502_LABEL(0xc7),
+          M6502_LABEL(0xc8), M6502_LABEL(0xc9), M6502_LABEL(0xca), M6502_LABEL(0xcb),
+          M6502_LABEL(0xcc), M6502_LABEL(0xcd), M6502_LABEL(0xce), M6502_LABEL(0xcf),
+          M6502_LABEL(0xd0), M6502_LABEL(0xd1), M6502_LABEL(invalid), M6502_LABEL(0xd3),
+          M6502_LABEL(0xd4), M6502_LABEL(0xd5), M6502_LABEL(0xd6), M6502_LABEL(0xd7),
+          M6502_LABEL(0xd8), M6502_LABEL(0xd9), M6502_LABEL(0xda), M6502_LABEL(0xdb),
+          M6502_LABEL(0xdc), M6502_LABEL(0xdd), M6502_LABEL(0xde), M6502_LABEL(0xdf),
+          M6502_LABEL(0xe0), M6502_LABEL(0xe1), M6502_LABEL(0xe2), M6502_LABEL(0xe3),
+          M6502_LABEL(0xe4), M6502_LABEL(0xe5), M6502_LABEL(0xe6), M6502_LABEL(0xe7),
+          M6502_LABEL(0xe8), M6502_LABEL(0xe9), M6502_LABEL(0xea), M6502_LABEL(0xeb),
+          M6502_LABEL(0xec), M6502_LABEL(0xed), M6502_LABEL(0xee), M6502_LABEL(0xef),
+          M6502_LABEL(0xf0), M6502_LABEL(0xf1), M6502_LABEL(invalid), M6502_LABEL(0xf3),
+          M6502_LABEL(0xf4), M6502_LABEL(0xf5), M6502_LABEL(0xf6), M6502_LABEL(0xf7),
+          M6502_LABEL(0xf8), M6502_LABEL(0xf9), M6502_LABEL(0xfa), M6502_LABEL(0xfb),
+          M6502_LABEL(0xfc), M6502_LABEL(0xfd), M6502_LABEL(0xfe), M6502_LABEL(0xff)
+        };
+
+        goto *dispatchTable[IR];
+
+        {
+          // 6502 instruction emulation is generated by an M4 macro file
+          #include "M6502.ins"
+
+          M6502_op_invalid:
+            FatalEmulationError::raise("invalid instruction");
+        }
+        M6502_done: ;
+      #pragma GCC diagnostic pop
+    #else
         switch(IR)
         {
           // 6502 instruction emulation is generated by an M4 macro file
@@ -350,9 +645,19 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
           default:
             FatalEmulationError::raise("invalid instruction");
         }
+    #endif
+
+        // A taken 'Bxx *-3' may close a loop waiting for the timer
+        if(!debuggerChecks && (IR & 0x1F) == 0x10 && operand == 0xFB && icycles > 2)
+        {
+          storeRegisters();
+          skipIdleLoop(std::min(previousCycles + cycles * SYSTEM_CYCLES_PER_CPU,
+                                mySystem->nextDeadline()));
+          loadRegisters();
+        }
 
     #ifdef DEBUGGER_SUPPORT
-        if(myReadFromWritePortBreak)
+        if(debuggerChecks && myReadFromWritePortBreak)
         {
           uInt16 rwpAddr = mySystem->cart().getIllegalRAMAccess();
           if(rwpAddr)
@@ -368,14 +673,19 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
         myExecutionStatus |= FatalErrorBit;
         result.setMessage(e.what());
       } catch (const EmulationWarning& e) {
+        storeRegisters();
         result.setDebugger(currentCycles, e.what(), PC);
         return;
       }
 
       currentCycles = (mySystem->cycles() - previousCycles);
 
+      // Let the devices act on the deadlines which have passed
+      if(mySystem->cycles() >= mySystem->nextDeadline())
+        mySystem->dispatchDeadlines();
+
   #ifdef DEBUGGER_SUPPORT
-      if(myStepStateByInstruction)
+      if(debuggerChecks && myStepStateByInstruction)
       {
         // Check out M6502::execute for an explanation.
         handleHalt();
@@ -386,12 +696,15 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
   #endif
     }
 
+    storeRegisters();
+
     // See if we need to handle an interrupt
     if((myExecutionStatus & MaskableInterruptBit) ||
         (myExecutionStatus & NonmaskableInterruptBit))
     {
       // Yes, so handle the interrupt
       interruptHandler();
+      loadRegisters();
     }
 
     // See if a fatal error has occurred
@@ -418,6 +731,121 @@ inline void M6502::_execute(uInt64 cycles, DispatchResult& result)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::skipIdleLoop(uInt64 endCycle)
+{
+  if(mySystem->cycles() >= endCycle)
+    return;
+
+  // The loop must run from ROM (or RAM) which is read directly, so that
+  // nothing but the CPU notices the skipped code fetches; this includes
+  // the dummy read when the branch crosses a page
+  const bool pageCrossed = NOTSAMEPAGE(PC + 5, PC);
+  const uInt16 fixupAddress = ((PC + 5) & 0xFF00) | (PC & 0x00FF);
+  const System::PageAccess& loopAccess = mySystem->getPageAccess(PC);
+  const System::PageAccess& branchAccess = mySystem->getPageAccess(PC + 5);
+  if(!loopAccess.directPeekBase || !branchAccess.directPeekBase ||
+     (pageCrossed && !mySystem->getPageAccess(fixupAddress).directPeekBase))
+    return;
+
+  const auto code = [&](uInt16 address) {
+    const System::PageAccess& access =
+      (address >> System::PAGE_SHIFT) == (PC >> System::PAGE_SHIFT) ? loopAccess : branchAccess;
+    return access.directPeekBase[address & System::PAGE_MASK];
+  };
+  const uInt8 opcode = code(PC);
+  const uInt16 address = code(PC + 1) | (uInt16(code(PC + 2)) << 8);
+
+  // Only 'LDA/LDX/LDY/BIT abs' are recognized, followed by this branch
+  if((opcode != 0xAD && opcode != 0xAE && opcode != 0xAC && opcode != 0x2C) ||
+     code(PC + 3) != IR || code(PC + 4) != 0xFB)
+    return;
+
+  // The timer registers are mirrored at A12 = 0, A9 = 1, A7 = 1, A2 = 1
+  M6532& riot = mySystem->m6532();
+  if((address & 0x1284) != 0x0284 || mySystem->getPageAccess(address).device != &riot)
+    return;
+
+  uInt32 stableCycles;
+  const uInt8 value = riot.peekTimer(address, stableCycles);
+
+  // Would the loop still be running after reading the value?
+  const bool n = value & 0x80;
+  const bool v = opcode == 0x2C ? value & 0x40 : V;
+  const bool notz = opcode == 0x2C ? A & value : value;
+  const bool flags[4] = { n, v, C, !notz };  // Branches test N, V, C or Z
+  if(flags[IR >> 6] != bool(IR & 0x20))
+    return;
+
+  // One iteration takes 4 + 3 cycles (+1 for a branch across pages), with
+  // the timer read in its 4th cycle; every access in it is distinct
+  const uInt32 loopCycles = pageCrossed ? 8 : 7;
+  if(stableCycles < 4)
+    return;
+
+  const uInt64 iterations = std::min<uInt64>((stableCycles - 4) / loopCycles + 1,
+      (endCycle - mySystem->cycles()) / (loopCycles * SYSTEM_CYCLES_PER_CPU));
+  if(iterations == 0)
+    return;
+
+  // Leave the registers the way the last skipped iteration does
+  switch(opcode)
+  {
+    case 0xAD: A = value; SET_LAST_PEEK(myLastSrcAddressA, address) break;
+    case 0xAE: X = value; SET_LAST_PEEK(myLastSrcAddressX, address) break;
+    case 0xAC: Y = value; SET_LAST_PEEK(myLastSrcAddressY, address) break;
+    default:   V = v;     break;
+  }
+  N = n;
+  notZ = notz;
+
+  mySystem->incrementCycles(uInt32(iterations * loopCycles * SYSTEM_CYCLES_PER_CPU));
+  myNumberOfDistinctAccesses += uInt32(iterations * loopCycles);
+  myInstructions += iterations * 2;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const M6502::CodeBlock* M6502::findBlock(uInt16 pc)
+{
+  const System::PageAccess& access = mySystem->getPageAccess(pc);
+  if(!access.directPeekBase)
+    return nullptr;
+
+  const uInt8* start = access.directPeekBase + (pc & System::PAGE_MASK);
+  const uintptr_t key = reinterpret_cast<uintptr_t>(start);
+  CodeBlock& block = myBlockCache[(key ^ (key >> 11)) & (BLOCK_CACHE_SIZE - 1)];
+
+  if(block.start == start && memcmp(block.code, start, block.size) == 0)
+    return block.instructions ? &block : nullptr;
+
+  // Every instruction reads the byte following its opcode, which must be in
+  // the same page
+  const uInt32 limit = std::min<uInt32>(System::PAGE_SIZE - (pc & System::PAGE_MASK),
+                                        sizeof(block.code));
+  uInt32 size = 0, compared = 0, instructions = 0, cycles = 0;
+  while(size + 2 <= limit)
+  {
+    const BlockAccess mode = blockAccess(start[size]);
+    compared = size + (mode == BlockAccess::implied ? 1 : 2);
+    if(mode == BlockAccess::none ||
+       (mode >= BlockAccess::zpRead && start[size + 1] < 0x80))
+      break;
+
+    size = compared;
+    ++instructions;
+    cycles += mode == BlockAccess::zpModify ? 5 : mode >= BlockAccess::zpRead ? 3 : 2;
+  }
+
+  // A single instruction runs as well without a block
+  block.start = start;
+  block.size = uInt8(compared);
+  block.instructions = instructions > 1 ? uInt8(instructions) : 0;
+  block.cycles = uInt8(cycles);
+  memcpy(block.code, start, block.size);
+
+  return block.instructions ? &block : nullptr;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::interruptHandler()
 {
@@ -446,43 +874,72 @@ void M6502::interruptHandler()
   myExecutionStatus &= ~(MaskableInterruptBit | NonmaskableInterruptBit);
 }
 
+namespace {
+  // The state is saved in blocks, laid out as the values used to be saved
+  // one by one (see Serializer::putBlock())
+  #pragma pack(push, 1)
+  struct RegisterState {
+    uInt8 a, x, y, sp, ir;
+    uInt16 pc;
+    uInt8 n, v, b, d, i, notZ, c;       // see Serializer::boolByte()
+    uInt8 executionStatus;
+    uInt32 distinctAccesses;
+    uInt16 lastAddress;
+  };
+
+  // Only used by the debugger
+  struct AccessState {
+    uInt16 lastPeekAddress, lastPokeAddress, dataAddressForPoke;
+    uInt32 lastSrcAddressS, lastSrcAddressA, lastSrcAddressX, lastSrcAddressY;
+    uInt8 flags;
+  };
+  #pragma pack(pop)
+
+  static_assert(sizeof(RegisterState) == 21, "M6502 state layout changed");
+  static_assert(sizeof(AccessState) == 23, "M6502 state layout changed");
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool M6502::save(Serializer& out) const
 {
   try
   {
-    out.putByte(A);    // Accumulator
-    out.putByte(X);    // X index register
-    out.putByte(Y);    // Y index register
-    out.putByte(SP);   // Stack Pointer
-    out.putByte(IR);   // Instruction register
-    out.putShort(PC);  // Program Counter
-
-    out.putBool(N);    // N flag for processor status register
-    out.putBool(V);    // V flag for processor status register
-    out.putBool(B);    // B flag for processor status register
-    out.putBool(D);    // D flag for processor status register
-    out.putBool(I);    // I flag for processor status register
-    out.putBool(notZ); // Z flag complement for processor status register
-    out.putBool(C);    // C flag for processor status register
-
-    out.putByte(myExecutionStatus);
-
-    // Indicates the number of distinct memory accesses
-    out.putInt(myNumberOfDistinctAccesses);
-    // Indicates the last address(es) which was accessed
-    out.putShort(myLastAddress);
-    out.putShort(myLastPeekAddress);
-    out.putShort(myLastPokeAddress);
-    out.putShort(myDataAddressForPoke);
-    out.putInt(myLastSrcAddressS);
-    out.putInt(myLastSrcAddressA);
-    out.putInt(myLastSrcAddressX);
-    out.putInt(myLastSrcAddressY);
-    out.putByte(myFlags);
+    RegisterState regs;
+    regs.a = A;
+    regs.x = X;
+    regs.y = Y;
+    regs.sp = SP;
+    regs.ir = IR;
+    regs.pc = PC;
+    regs.n = Serializer::boolByte(N);
+    regs.v = Serializer::boolByte(V);
+    regs.b = Serializer::boolByte(B);
+    regs.d = Serializer::boolByte(D);
+    regs.i = Serializer::boolByte(I);
+    regs.notZ = Serializer::boolByte(notZ);
+    regs.c = Serializer::boolByte(C);
+    regs.executionStatus = myExecutionStatus;
+    regs.distinctAccesses = myNumberOfDistinctAccesses;
+    regs.lastAddress = myLastAddress;
+    out.putBlock(regs);
+
+    if(!out.lean())
+    {
+      AccessState access;
+      access.lastPeekAddress = myLastPeekAddress;
+      access.lastPokeAddress = myLastPokeAddress;
+      access.dataAddressForPoke = myDataAddressForPoke;
+      access.lastSrcAddressS = myLastSrcAddressS;
+      access.lastSrcAddressA = myLastSrcAddressA;
+      access.lastSrcAddressX = myLastSrcAddressX;
+      access.lastSrcAddressY = myLastSrcAddressY;
+      access.flags = myFlags;
+      out.putBlock(access);
+    }
 
     out.putBool(myHaltRequested);
-    out.putLong(myLastBreakCycle);
+    if(!out.lean())
+      out.putLong(myLastBreakCycle);
   }
   catch(...)
   {
@@ -498,38 +955,42 @@ bool M6502::load(Serializer& in)
 {
   try
   {
-    A = in.getByte();    // Accumulator
-    X = in.getByte();    // X index register
-    Y = in.getByte();    // Y index register
-    SP = in.getByte();   // Stack Pointer
-    IR = in.getByte();   // Instruction register
-    PC = in.getShort();  // Program Counter
-
-    N = in.getBool();    // N flag for processor status register
-    V = in.getBool();    // V flag for processor status register
-    B = in.getBool();    // B flag for processor status register
-    D = in.getBool();    // D flag for processor status register
-    I = in.getBool();    // I flag for processor status register
-    notZ = in.getBool(); // Z flag complement for processor status register
-    C = in.getBool();    // C flag for processor status register
-
-    myExecutionStatus = in.getByte();
-
-    // Indicates the number of distinct memory accesses
-    myNumberOfDistinctAccesses = in.getInt();
-    // Indicates the last address(es) which was accessed
-    myLastAddress = in.getShort();
-    myLastPeekAddress = in.getShort();
-    myLastPokeAddress = in.getShort();
-    myDataAddressForPoke = in.getShort();
-    myLastSrcAddressS = in.getInt();
-    myLastSrcAddressA = in.getInt();
-    myLastSrcAddressX = in.getInt();
-    myLastSrcAddressY = in.getInt();
-    myFlags = in.getByte();
+    RegisterState regs;
+    in.getBlock(regs);
+    A = regs.a;
+    X = regs.x;
+    Y = regs.y;
+    SP = regs.sp;
+    IR = regs.ir;
+    PC = regs.pc;
+    N = Serializer::byteBool(regs.n);
+    V = Serializer::byteBool(regs.v);
+    B = Serializer::byteBool(regs.b);
+    D = Serializer::byteBool(regs.d);
+    I = Serializer::byteBool(regs.i);
+    notZ = Serializer::byteBool(regs.notZ);
+    C = Serializer::byteBool(regs.c);
+    myExecutionStatus = regs.executionStatus;
+    myNumberOfDistinctAccesses = regs.distinctAccesses;
+    myLastAddress = regs.lastAddress;
+
+    if(!in.lean())
+    {
+      AccessState access;
+      in.getBlock(access);
+      myLastPeekAddress = access.lastPeekAddress;
+      myLastPokeAddress = access.lastPokeAddress;
+      myDataAddressForPoke = access.dataAddressForPoke;
+      myLastSrcAddressS = access.lastSrcAddressS;
+      myLastSrcAddressA = access.lastSrcAddressA;
+      myLastSrcAddressX = access.lastSrcAddressX;
+      myLastSrcAddressY = access.lastSrcAddressY;
+      myFlags = access.flags;
+    }
 
     myHaltRequested = in.getBool();
-    myLastBreakCycle = in.getLong();
+    if(!in.lean())
+      myLastBreakCycle = in.getLong();
 
   #ifdef DEBUGGER_SUPPORT
     updateStepStateByInstruction();
@@ -553,7 +1014,7 @@ void M6502::attach(Debugger& debugger)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 M6502::addCondBreak(Expression* e, const string& name, bool oneShot)
+uInt32 M6502::addCondBreak(shared_ptr<const Expression> e, const string& name, bool oneShot)
 {
   myCondBreaks.emplace_back(e);
   myCondBreakNames.push_back(name);
@@ -594,7 +1055,7 @@ const StringList& M6502::getCondBreakNames() const
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 M6502::addCondSaveState(Expression* e, const string& name)
+uInt32 M6502::addCondSaveState(shared_ptr<const Expression> e, const string& name)
 {
   myCondSaveStates.emplace_back(e);
   myCondSaveStateNames.push_back(name);
@@ -635,7 +1096,7 @@ const StringList& M6502::getCondSaveStateNames() const
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 M6502::addCondTrap(Expression* e, const string& name)
+uInt32 M6502::addCondTrap(shared_ptr<const Expression> e, const string& name)
 {
   myTrapConds.emplace_back(e);
   myTrapCondNames.push_back(name);
@@ -675,10 +1136,26 @@ const StringList& M6502::getCondTrapNames() const
   return myTrapCondNames;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::setTraceRecorder(TraceRecorder* recorder)
+{
+  myTraceRecorder = recorder;
+  updateStepStateByInstruction();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::setProfiler(CycleProfiler* profiler)
+{
+  myProfiler = profiler;
+  updateStepStateByInstruction();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::updateStepStateByInstruction()
 {
+  // The beam position is recorded in traces and profiles, so keep the TIA
+  // in lockstep
   myStepStateByInstruction = myCondBreaks.size() || myCondSaveStates.size() ||
-                             myTrapConds.size();
+                             myTrapConds.size() || myTraceRecorder || myProfiler;
 }
 #endif  // DEBUGGER_SUPPORT
@@ -27,6 +27,8 @@ class DispatchResult;
 #ifdef DEBUGGER_SUPPORT
   class Debugger;
   class CpuDebug;
+  class TraceRecorder;
+  class CycleProfiler;
 
   #include "Expression.hxx"
   #include "TrapArray.hxx"
@@ -136,11 +138,17 @@ class M6502 : public Serializable
     bool fatalError() const { return myExecutionStatus & FatalErrorBit; }
 
     /**
-      Get the 16-bit value of the Program Counter register.
+      Get the values of the registers.  These are meant for tools running
+      without the debugger, which uses CpuDebug instead.
 
-      @return The program counter register
+      @return The value of the register
     */
-    // uInt16 getPC() const { return PC; }
+    uInt16 getPC() const { return PC; }
+    uInt8 getA() const   { return A;  }
+    uInt8 getX() const   { return X;  }
+    uInt8 getY() const   { return Y;  }
+    uInt8 getSP() const  { return SP; }
+    uInt8 getPS() const  { return PS(); }
 
     /**
       Check the type of the last peek().
@@ -191,6 +199,14 @@ class M6502 : public Serializable
     */
     uInt32 distinctAccesses() const { return myNumberOfDistinctAccesses; }
 
+    /**
+      Get the number of instructions executed since the processor was
+      created (used for profiling).
+
+      @return The number of instructions executed
+    */
+    uInt64 instructions() const { return myInstructions; }
+
     /**
       Saves the current state of this device to the given Serializer.
 
@@ -218,28 +234,57 @@ class M6502 : public Serializable
     BreakpointMap& breakPoints() { return myBreakPoints; }
 
     // methods for 'breakif' handling
-    uInt32 addCondBreak(Expression* e, const string& name, bool oneShot = false);
+    uInt32 addCondBreak(shared_ptr<const Expression> e, const string& name, bool oneShot = false);
     bool delCondBreak(uInt32 idx);
     void clearCondBreaks();
     const StringList& getCondBreakNames() const;
 
     // methods for 'savestateif' handling
-    uInt32 addCondSaveState(Expression* e, const string& name);
+    uInt32 addCondSaveState(shared_ptr<const Expression> e, const string& name);
     bool delCondSaveState(uInt32 idx);
     void clearCondSaveStates();
     const StringList& getCondSaveStateNames() const;
 
     // methods for 'trapif' handling
-    uInt32 addCondTrap(Expression* e, const string& name);
+    uInt32 addCondTrap(shared_ptr<const Expression> e, const string& name);
     bool delCondTrap(uInt32 brk);
     void clearCondTraps();
     const StringList& getCondTrapNames() const;
 
     void setGhostReadsTrap(bool enable) { myGhostReadsTrap = enable; }
     void setReadFromWritePortBreak(bool enable) { myReadFromWritePortBreak = enable; }
+
+    // Record each executed instruction into the given recorder
+    // (the null pointer stops recording)
+    void setTraceRecorder(TraceRecorder* recorder);
+
+    // Count the cycles of each executed instruction in the given profiler
+    // (the null pointer stops profiling)
+    void setProfiler(CycleProfiler* profiler);
 #endif  // DEBUGGER_SUPPORT
 
   private:
+    /**
+      A run of two or more instructions which only work on the registers and
+      the zero page RAM: implied, accumulator and immediate instructions, and
+      zero page instructions addressing $80 - $FF.  The whole run can't
+      access any device, nor change the banking, so _execute() runs it at
+      once, without the bookkeeping (and the checks) between the accesses.
+
+      Only code which is read directly (from ROM, or the read port of a
+      cartridge RAM) forms blocks.  They are cached by the address of the
+      code in host memory, which tells the banks apart, and checked against
+      a copy of the code before every run, so changed (or patched) code is
+      simply rebuilt.
+    */
+    struct CodeBlock {
+      const uInt8* start;    // the first byte of the code, or the null pointer
+      uInt8 code[32];        // a copy of the code the block was built from
+      uInt8 size;            // the bytes of code to compare
+      uInt8 instructions;    // the instructions in the block, 0 for none
+      uInt8 cycles;          // the CPU cycles of all of them
+    };
+
     /**
       Get the byte at the specified address and update the cycle count.
       Addresses marked as code are hints to the debugger/disassembler to
@@ -268,7 +313,21 @@ class M6502 : public Serializable
 
       @return The processor status register
     */
-    uInt8 PS() const {
+    uInt8 PS() const { return packPS(N, V, B, D, I, notZ, C); }
+
+    /**
+      Change the Processor Status register to correspond to the given value.
+
+      @param ps The value to set the processor status register to
+    */
+    void PS(uInt8 ps) { unpackPS(ps, N, V, B, D, I, notZ, C); }
+
+    /**
+      Pack the given flags into the Processor Status register, and unpack
+      it into them.  The instructions use these with the flags they work on,
+      which are copies of the members while executing without debugger checks.
+    */
+    static uInt8 packPS(bool N, bool V, bool B, bool D, bool I, bool notZ, bool C) {
       uInt8 ps = 0x20;
 
       if(N)     ps |= 0x80;
@@ -281,13 +340,8 @@ class M6502 : public Serializable
 
       return ps;
     }
-
-    /**
-      Change the Processor Status register to correspond to the given value.
-
-      @param ps The value to set the processor status register to
-    */
-    void PS(uInt8 ps) {
+    static void unpackPS(uInt8 ps, bool& N, bool& V, bool& B, bool& D, bool& I,
+                         bool& notZ, bool& C) {
       N = ps & 0x80;
       V = ps & 0x40;
       B = true;        // B = ps & 0x10;  The 6507's B flag always true
@@ -307,10 +361,34 @@ class M6502 : public Serializable
     */
     void handleHalt();
 
+    /**
+      Called after a branch back to the previous instruction has been taken.
+      If the two form a loop polling the RIOT timer from ROM (for example
+      'LDA INTIM / BNE *-3'), all further iterations which are sure to
+      read the same value are skipped at once.
+
+      @param endCycle  The end of the timeslice, which is never passed
+    */
+    void skipIdleLoop(uInt64 endCycle);
+
+    /**
+      Look up the block of straight-line code starting at the given address,
+      building it if the code isn't cached yet (or has changed).
+
+      @param pc  The address of the first instruction
+      @return  The block, or the null pointer if there's none at this address
+    */
+    const CodeBlock* findBlock(uInt16 pc);
+
     /**
       This is the actual dispatch function that does the grunt work. M6502::execute
       wraps it and makes sure that any pending halt is processed before returning.
+
+      @param debuggerChecks  Evaluate breakpoints, traps and conditional
+                             breaks/savestates before each instruction; the
+                             unchecked variant is used while none are defined
     */
+    template<bool debuggerChecks>
     void _execute(uInt64 cycles, DispatchResult& result);
 
 #ifdef DEBUGGER_SUPPORT
@@ -319,6 +397,19 @@ class M6502 : public Serializable
       with the CPU and update the flag accordingly.
     */
     void updateStepStateByInstruction();
+
+    /**
+      Answer whether any breakpoint, trap, conditional break/savestate or
+      read-from-write-port break is active, requiring the checked dispatch
+      loop to be used.
+    */
+    bool needsDebuggerChecks() const {
+      return myBreakPoints.isInitialized() ||
+             myReadTraps.isInitialized() || myWriteTraps.isInitialized() ||
+             myJustHitReadTrapFlag || myJustHitWriteTrapFlag ||
+             myStepStateByInstruction || myReadFromWritePortBreak ||
+             myTraceRecorder != nullptr || myProfiler != nullptr;
+    }
 #endif  // DEBUGGER_SUPPORT
 
   private:
@@ -361,6 +452,10 @@ class M6502 : public Serializable
     /// Indicates the numer of distinct memory accesses
     uInt32 myNumberOfDistinctAccesses;
 
+    /// Number of instructions executed since the processor was created
+    /// (for profiling, not part of the state)
+    uInt64 myInstructions;
+
     /// Indicates the last address which was accessed
     uInt16 myLastAddress;
 
@@ -396,10 +491,18 @@ class M6502 : public Serializable
     /// Indicates whether RDY was pulled low
     bool myHaltRequested;
 
+    /// The blocks of straight-line code (direct mapped), only allocated
+    /// when enabled
+    static constexpr uInt32 BLOCK_CACHE_SIZE = 2048;
+    vector<CodeBlock> myBlockCache;
+
+    /// Indicates whether blocks of code are run at once ('cpu.blocks')
+    bool myBlocksEnabled;
+
 #ifdef DEBUGGER_SUPPORT
     Int32 evalCondBreaks() {
       for(Int32 i = Int32(myCondBreaks.size()) - 1; i >= 0; --i)
-        if(myCondBreaks[i]->evaluate())
+        if(myCondBreaks[i].run())
           return i;
 
       return -1; // no break hit
@@ -408,7 +511,7 @@ class M6502 : public Serializable
     Int32 evalCondSaveStates()
     {
       for(Int32 i = Int32(myCondSaveStates.size()) - 1; i >= 0; --i)
-        if(myCondSaveStates[i]->evaluate())
+        if(myCondSaveStates[i].run())
           return i;
 
       return -1; // no save state point hit
@@ -417,7 +520,7 @@ class M6502 : public Serializable
     Int32 evalCondTraps()
     {
       for(Int32 i = Int32(myTrapConds.size()) - 1; i >= 0; --i)
-        if(myTrapConds[i]->evaluate())
+        if(myTrapConds[i].run())
           return i;
 
       return -1; // no trapif hit
@@ -439,12 +542,19 @@ class M6502 : public Serializable
     HitTrapInfo myHitTrapInfo;
 
     BreakpointMap myBreakPoints;
-    vector<unique_ptr<Expression>> myCondBreaks;
+    // Conditions are compiled, since they're checked for each instruction
+    vector<ExpressionProgram> myCondBreaks;
     StringList myCondBreakNames;
-    vector<unique_ptr<Expression>> myCondSaveStates;
+    vector<ExpressionProgram> myCondSaveStates;
     StringList myCondSaveStateNames;
-    vector<unique_ptr<Expression>> myTrapConds;
+    vector<ExpressionProgram> myTrapConds;
     StringList myTrapCondNames;
+
+    // Receives every executed instruction, if not the null pointer
+    TraceRecorder* myTraceRecorder;
+
+    // Counts the cycles of every executed instruction, if not the null pointer
+    CycleProfiler* myProfiler;
 #endif  // DEBUGGER_SUPPORT
 
     bool myGhostReadsTrap;          // trap on ghost reads
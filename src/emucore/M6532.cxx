@@ -31,7 +31,7 @@
 M6532::M6532(const ConsoleIO& console, const Settings& settings)
   : myConsole(console),
     mySettings(settings),
-    myTimer(0), mySubTimer(0), myDivider(1),
+    myTimer(0), mySubTimer(0), myDivider(1), myDividerShift(0),
     myTimerWrapped(false), myWrappedThisCycle(false),
     mySetTimerCycle(0), myLastCycle(0),
     myDDRA(0), myDDRB(0), myOutA(0), myOutB(0),
@@ -67,11 +67,13 @@ void M6532::reset()
 
   myTimer = mySystem->randGenerator().next() & 0xff;
   myDivider = 1024;
+  myDividerShift = 10;
   mySubTimer = 0;
   myTimerWrapped = false;
   myWrappedThisCycle = false;
 
   mySetTimerCycle = myLastCycle = 0;
+  scheduleTimerDeadline();
 
   // Zero the I/O registers
   myDDRA = myDDRB = myOutA = myOutB = 0x00;
@@ -90,7 +92,8 @@ void M6532::reset()
   myConsole.rightController().reset();
 
 #ifdef DEBUGGER_SUPPORT
-  createAccessBases();
+  if(!mySettings.getBool("lean"))
+    createAccessBases();
 #endif // DEBUGGER_SUPPORT
 }
 
@@ -128,11 +131,11 @@ void M6532::updateEmulation()
   if (cycles == 0) return;
 
   myWrappedThisCycle = false;
-  mySubTimer = (cycles + mySubTimer) % myDivider;
+  mySubTimer = (cycles + mySubTimer) & (myDivider - 1);
 
   if(!myTimerWrapped)
   {
-    uInt32 timerTicks = (cycles + subTimer) / myDivider;
+    uInt32 timerTicks = (cycles + subTimer) >> myDividerShift;
 
     if(timerTicks > myTimer)
     {
@@ -155,6 +158,50 @@ void M6532::updateEmulation()
   myLastCycle = mySystem->cycles();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6532::deadlineReached(uInt64)
+{
+  updateEmulation();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6532::scheduleTimerDeadline()
+{
+  // Once wrapped, the timer counts down every cycle without any events
+  if(myTimerWrapped)
+    mySystem->cancelDeadline(*this);
+  else
+    mySystem->scheduleDeadline(*this,
+      myLastCycle + (myTimer + 1) * myDivider - mySubTimer);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 M6532::peekTimer(uInt16 addr, uInt32& stableCycles)
+{
+  updateEmulation();
+
+  // Both registers change when the timer ticks next; once it has wrapped,
+  // that happens every cycle
+  stableCycles = myTimerWrapped ? 0 : myDivider - mySubTimer - 1;
+
+  if(addr & 0x01)   // TIMINT/INSTAT
+  {
+    // Reading clears the PA7 flag
+    if(myInterruptFlag & PA7Bit)
+      stableCycles = 0;
+
+    return myInterruptFlag;
+  }
+  else              // INTIM
+  {
+    // Reading clears the timer flag
+    if(myInterruptFlag & TimerBit)
+      stableCycles = 0;
+
+    return myTimer;
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6532::install(System& system)
 {
@@ -186,14 +233,17 @@ void M6532::installDelegate(System& system, Device& device)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 M6532::peek(uInt16 addr)
 {
-  updateEmulation();
-
   // A9 distinguishes I/O registers from ZP RAM
   // A9 = 1 is read from I/O
   // A9 = 0 is read from RAM
   if((addr & 0x0200) == 0x0000)
     return myRAM[addr & 0x007f];
 
+  // Only the timer registers depend on the timer state; it isn't updated
+  // for anything else (see updateEmulation())
+  if(addr & 0x04)
+    updateEmulation();
+
   switch(addr & 0x07)
   {
     case 0x00:    // SWCHA - Port A I/O Register (Joystick)
@@ -254,8 +304,6 @@ uInt8 M6532::peek(uInt16 addr)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool M6532::poke(uInt16 addr, uInt8 value)
 {
-  updateEmulation();
-
   // A9 distinguishes I/O registers from ZP RAM
   // A9 = 1 is write to I/O
   // A9 = 0 is write to RAM
@@ -273,7 +321,10 @@ bool M6532::poke(uInt16 addr, uInt8 value)
     // A4 = 1 is write to TIMxT (x = 1, 8, 64, 1024)
     // A4 = 0 is write to edge detect control
     if((addr & 0x10) != 0)
+    {
+      updateEmulation();
       setTimerRegister(value, addr & 0x03);  // A1A0 determines interval
+    }
     else
       myEdgeDetectPositive = addr & 0x01;    // A0 determines direction
   }
@@ -314,9 +365,10 @@ bool M6532::poke(uInt16 addr, uInt8 value)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6532::setTimerRegister(uInt8 value, uInt8 interval)
 {
-  static constexpr uInt32 divider[] = { 1, 8, 64, 1024 };
+  static constexpr uInt32 dividerShift[] = { 0, 3, 6, 10 };
 
-  myDivider = divider[interval];
+  myDividerShift = dividerShift[interval];
+  myDivider = 1 << myDividerShift;
   myOutTimer[interval] = value;
 
   myTimer = value;
@@ -327,6 +379,7 @@ void M6532::setTimerRegister(uInt8 value, uInt8 interval)
   myInterruptFlag &= ~TimerBit;
 
   mySetTimerCycle = mySystem->cycles();
+  scheduleTimerDeadline();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -363,29 +416,47 @@ void M6532::setPinState(bool swcha)
   }
 }
 
+namespace {
+  // The state is saved in one block, laid out as the values used to be
+  // saved one by one (see Serializer::putBlock())
+  #pragma pack(push, 1)
+  struct RiotState {
+    uInt8 ram[128];
+    uInt32 timer, subTimer, divider;
+    uInt8 timerWrapped, wrappedThisCycle;  // see Serializer::boolByte()
+    uInt64 lastCycle, setTimerCycle;
+    uInt8 ddra, ddrb, outA, outB;
+    uInt8 interruptFlag;
+    uInt8 edgeDetectPositive;
+    uInt8 outTimer[4];
+  };
+  #pragma pack(pop)
+
+  static_assert(sizeof(RiotState) == 168, "M6532 state layout changed");
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool M6532::save(Serializer& out) const
 {
   try
   {
-    out.putByteArray(myRAM, 128);
-
-    out.putInt(myTimer);
-    out.putInt(mySubTimer);
-    out.putInt(myDivider);
-    out.putBool(myTimerWrapped);
-    out.putBool(myWrappedThisCycle);
-    out.putLong(myLastCycle);
-    out.putLong(mySetTimerCycle);
-
-    out.putByte(myDDRA);
-    out.putByte(myDDRB);
-    out.putByte(myOutA);
-    out.putByte(myOutB);
-
-    out.putByte(myInterruptFlag);
-    out.putBool(myEdgeDetectPositive);
-    out.putByteArray(myOutTimer, 4);
+    RiotState state;
+    std::copy_n(myRAM, 128, state.ram);
+    state.timer = myTimer;
+    state.subTimer = mySubTimer;
+    state.divider = myDivider;
+    state.timerWrapped = Serializer::boolByte(myTimerWrapped);
+    state.wrappedThisCycle = Serializer::boolByte(myWrappedThisCycle);
+    state.lastCycle = myLastCycle;
+    state.setTimerCycle = mySetTimerCycle;
+    state.ddra = myDDRA;
+    state.ddrb = myDDRB;
+    state.outA = myOutA;
+    state.outB = myOutB;
+    state.interruptFlag = myInterruptFlag;
+    state.edgeDetectPositive = Serializer::boolByte(myEdgeDetectPositive);
+    std::copy_n(myOutTimer, 4, state.outTimer);
+    out.putBlock(state);
   }
   catch(...)
   {
@@ -401,24 +472,28 @@ bool M6532::load(Serializer& in)
 {
   try
   {
-    in.getByteArray(myRAM, 128);
-
-    myTimer = in.getInt();
-    mySubTimer = in.getInt();
-    myDivider = in.getInt();
-    myTimerWrapped = in.getBool();
-    myWrappedThisCycle = in.getBool();
-    myLastCycle = in.getLong();
-    mySetTimerCycle = in.getLong();
-
-    myDDRA = in.getByte();
-    myDDRB = in.getByte();
-    myOutA = in.getByte();
-    myOutB = in.getByte();
-
-    myInterruptFlag = in.getByte();
-    myEdgeDetectPositive = in.getBool();
-    in.getByteArray(myOutTimer, 4);
+    RiotState state;
+    in.getBlock(state);
+    std::copy_n(state.ram, 128, myRAM);
+    myTimer = state.timer;
+    mySubTimer = state.subTimer;
+    myDivider = state.divider;
+    myDividerShift = 0;
+    while((1u << myDividerShift) < myDivider)
+      ++myDividerShift;
+    myTimerWrapped = Serializer::byteBool(state.timerWrapped);
+    myWrappedThisCycle = Serializer::byteBool(state.wrappedThisCycle);
+    myLastCycle = state.lastCycle;
+    mySetTimerCycle = state.setTimerCycle;
+    myDDRA = state.ddra;
+    myDDRB = state.ddrb;
+    myOutA = state.outA;
+    myOutB = state.outB;
+    myInterruptFlag = state.interruptFlag;
+    myEdgeDetectPositive = Serializer::byteBool(state.edgeDetectPositive);
+    std::copy_n(state.outTimer, 4, myOutTimer);
+
+    scheduleTimerDeadline();
   }
   catch(...)
   {
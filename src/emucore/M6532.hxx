@@ -119,20 +119,52 @@ class M6532 : public Device
     bool poke(uInt16 address, uInt8 value) override;
 
     /**
-     * Update RIOT state to the current timestamp.
+     * Update RIOT state to the current timestamp.  The timer state is
+     * only brought up to date when it's accessed, since it can be computed
+     * for any number of elapsed cycles at once.
      */
     void updateEmulation();
 
+    /**
+      Bring the timer up to date when it underflows, which is scheduled as
+      a deadline with the system.
+    */
+    void deadlineReached(uInt64 cycle) override;
+
+    /**
+      Get the value a read of the given timer register (INTIM or TIMINT)
+      returns right now, without actually reading it.  The CPU uses this
+      to fast-forward through loops waiting for the timer.
+
+      @param addr          The address of the register
+      @param stableCycles  Set to the number of following cycles during
+                           which reads return the same value, with no side
+                           effects (0 if reading has side effects)
+
+      @return  The value of the register
+    */
+    uInt8 peekTimer(uInt16 addr, uInt32& stableCycles);
+
     /**
       Get a pointer to the RAM contents.
 
       @return  Pointer to RAM array.
     */
     const uInt8* getRAM() const { return myRAM; }
+    uInt8* getRAM() { return myRAM; }
+
+    /**
+      Change a RAM location directly, without going through the System.
+
+      @param addr   The RAM address ($80 - $FF, mirrors allowed)
+      @param value  The value to store
+    */
+    void setRAM(uInt16 addr, uInt8 value) { myRAM[addr & 0x7f] = value; }
 
   private:
 
     void setTimerRegister(uInt8 data, uInt8 interval);
+    void scheduleTimerDeadline();
     void setPinState(bool shcha);
 
     // The following are used by the debugger to read INTIM/TIMINT
@@ -177,8 +209,9 @@ class M6532 : public Device
     // Current number of clocks "queued" for the divider
     uInt32 mySubTimer;
 
-    // The divider
+    // The divider, and its log2 (the dividers are powers of two)
     uInt32 myDivider;
+    uInt32 myDividerShift;
 
     // Has the timer wrapped?
     bool myTimerWrapped;
@@ -18,6 +18,14 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define MD5_SSE2
+#elif defined(__ARM_NEON)
+  #include <arm_neon.h>
+  #define MD5_NEON
+#endif
+
 #include "FSNode.hxx"
 #include "MD5.hxx"
 
@@ -49,14 +57,6 @@ namespace MD5 {
 // Setup the types used by the MD5 routines
 using POINTER = uInt8*;
 
-// MD5 context.
-struct MD5_CTX
-{
-  uInt32 state[4];    /* state (ABCD) */
-  uInt32 count[2];    /* number of bits, modulo 2^64 (lsb first) */
-  uInt8 buffer[64];   /* input buffer */
-};
-
 // Constants for MD5Transform routine.
 #define S11 7
 #define S12 12
@@ -75,11 +75,8 @@ struct MD5_CTX
 #define S43 15
 #define S44 21
 
-static void MD5Init(MD5_CTX*);
-static void MD5Update(MD5_CTX*, const uInt8*, uInt32);
-static void MD5Final(uInt8[16], MD5_CTX*);
 static void MD5Transform(uInt32 [4], const uInt8 [64]);
-static void Encode(uInt8*, uInt32*, uInt32);
+static void Encode(uInt8*, const uInt32*, uInt32);
 static void Decode(uInt32*, const uInt8*, uInt32);
 
 static uInt8 PADDING[64] = {
@@ -88,6 +85,11 @@ static uInt8 PADDING[64] = {
   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
 };
 
+// Magic initialization constants
+static const uInt32 INITIAL_STATE[4] = {
+  0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476
+};
+
 // F, G, H and I are basic MD5 functions.
 #define F(x, y, z) (((x) & (y)) | ((~x) & (z)))
 #define G(x, y, z) (((x) & (z)) | ((y) & (~z)))
@@ -120,79 +122,6 @@ static uInt8 PADDING[64] = {
  (a) += (b); \
   }
 
-// MD5 initialization. Begins an MD5 operation, writing a new context.
-static void MD5Init(MD5_CTX* context)
-{
-  context->count[0] = context->count[1] = 0;
-  /* Load magic initialization constants. */
-  context->state[0] = 0x67452301;
-  context->state[1] = 0xefcdab89;
-  context->state[2] = 0x98badcfe;
-  context->state[3] = 0x10325476;
-}
-
-// MD5 block update operation. Continues an MD5 message-digest
-// operation, processing another message block, and updating the
-// context.
-static void MD5Update(MD5_CTX* context, const uInt8* input,
-    uInt32 inputLen)
-{
-  uInt32 i, index, partLen;
-
-  /* Compute number of bytes mod 64 */
-  index = uInt32((context->count[0] >> 3) & 0x3F);
-
-  /* Update number of bits */
-  if ((context->count[0] += (uInt32(inputLen) << 3))
-   < (uInt32(inputLen) << 3))
-    context->count[1]++;
-  context->count[1] += (uInt32(inputLen) >> 29);
-
-  partLen = 64 - index;
-
-  /* Transform as many times as possible. */
-  if (inputLen >= partLen) {
-    memcpy (const_cast<POINTER>(&context->buffer[index]),
-            const_cast<POINTER>(input), partLen);
-    MD5Transform (context->state, context->buffer);
-
-    for (i = partLen; i + 63 < inputLen; i += 64)
-      MD5Transform (context->state, &input[i]);
-
-    index = 0;
-  }
-  else
-    i = 0;
-
-  /* Buffer remaining input */
-  memcpy(const_cast<POINTER>(&context->buffer[index]),
-         const_cast<POINTER>(&input[i]), inputLen-i);
-}
-
-// MD5 finalization. Ends an MD5 message-digest operation, writing the
-// the message digest and zeroizing the context.
-static void MD5Final(uInt8 digest[16], MD5_CTX* context)
-{
-  uInt8 bits[8];
-  uInt32 index, padLen;
-
-  /* Save number of bits */
-  Encode (bits, context->count, 8);
-
-  /* Pad out to 56 mod 64. */
-  index = uInt32((context->count[0] >> 3) & 0x3f);
-  padLen = (index < 56) ? (56 - index) : (120 - index);
-  MD5Update (context, PADDING, padLen);
-
-  /* Append length (before padding) */
-  MD5Update (context, bits, 8);
-  /* Store state in digest */
-  Encode (digest, context->state, 16);
-
-  /* Zeroize sensitive information. */
-  memset (reinterpret_cast<POINTER>(context), 0, sizeof(*context));
-}
-
 // MD5 basic transformation. Transforms state based on block.
 static void MD5Transform(uInt32 state[4], const uInt8 block[64])
 {
@@ -283,7 +212,7 @@ static void MD5Transform(uInt32 state[4], const uInt8 block[64])
 
 // Encodes input (uInt32) into output (uInt8). Assumes len is
 // a multiple of 4.
-static void Encode(uInt8* output, uInt32* input, uInt32 len)
+static void Encode(uInt8* output, const uInt32* input, uInt32 len)
 {
   uInt32 i, j;
 
@@ -306,31 +235,413 @@ static void Decode(uInt32* output, const uInt8* input, uInt32 len)
     ((uInt32(input[j+2])) << 16) | ((uInt32(input[j+3])) << 24);
 }
 
+// Convert a digest to 32 hexadecimal digits
+static string toHex(const uInt8 digest[16])
+{
+  static const char hex[] = "0123456789abcdef";
+
+  string result(32, '0');
+  for(int t = 0; t < 16; ++t)
+  {
+    result[2*t]   = hex[(digest[t] >> 4) & 0x0f];
+    result[2*t+1] = hex[digest[t] & 0x0f];
+  }
+
+  return result;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-string hash(const ByteBuffer& buffer, uInt32 length)
+Hasher::Hasher()
 {
-  return hash(buffer.get(), length);
+  reset();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-string hash(const uInt8* buffer, uInt32 length)
+void Hasher::reset()
+{
+  memcpy(myState, INITIAL_STATE, sizeof(myState));
+  myLength = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Hasher::update(const uInt8* buffer, uInt32 length)
 {
-  char hex[] = "0123456789abcdef";
-  MD5_CTX context;
-  uInt8 md5[16];
+  if(length == 0)
+    return;
 
-  MD5Init(&context);
-  MD5Update(&context, buffer, length);
-  MD5Final(md5, &context);
+  uInt32 index = uInt32(myLength & 0x3f);
+  myLength += length;
 
-  string result;
-  for(int t = 0; t < 16; ++t)
+  // Complete a partial block first, then transform directly from the input
+  uInt32 i = 0;
+  if(index > 0)
   {
-    result += hex[(md5[t] >> 4) & 0x0f];
-    result += hex[md5[t] & 0x0f];
+    i = std::min(64 - index, length);
+    memcpy(myBuffer + index, buffer, i);
+    if(index + i < 64)
+      return;
+
+    MD5Transform(myState, myBuffer);
   }
 
-  return result;
+  for(; i + 63 < length; i += 64)
+    MD5Transform(myState, buffer + i);
+
+  memcpy(myBuffer, buffer + i, length - i);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string Hasher::digest()
+{
+  uInt8 bits[8];
+  const uInt32 count[2] = { uInt32(myLength << 3), uInt32(myLength >> 29) };
+  Encode(bits, count, 8);
+
+  // Pad out to 56 mod 64, and append the length (before padding)
+  const uInt32 index = uInt32(myLength & 0x3f);
+  update(PADDING, (index < 56) ? (56 - index) : (120 - index));
+  update(bits, 8);
+
+  uInt8 digest[16];
+  Encode(digest, myState, 16);
+  reset();
+
+  return toHex(digest);
+}
+
+/*
+  The multi-buffer hashing runs the MD5 transformation on four messages
+  at once, each in one 32-bit lane of a SIMD register.  Without SIMD
+  support, the lanes are plain arrays, which the compiler may still be
+  able to vectorize.
+*/
+namespace {
+
+constexpr uInt32 LANES = 4;
+
+#if defined(MD5_SSE2)
+  using Lanes = __m128i;
+
+  inline Lanes splat(uInt32 c) { return _mm_set1_epi32(int(c)); }
+  inline Lanes load(const uInt32* w) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(w));
+  }
+  inline void store(uInt32* w, Lanes x) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(w), x);
+  }
+  inline Lanes add(Lanes x, Lanes y) { return _mm_add_epi32(x, y); }
+  inline Lanes bitAnd(Lanes x, Lanes y) { return _mm_and_si128(x, y); }
+  inline Lanes bitOr(Lanes x, Lanes y) { return _mm_or_si128(x, y); }
+  inline Lanes bitXor(Lanes x, Lanes y) { return _mm_xor_si128(x, y); }
+  // x & ~y, and x | ~y
+  inline Lanes andNot(Lanes x, Lanes y) { return _mm_andnot_si128(y, x); }
+  inline Lanes orNot(Lanes x, Lanes y) {
+    return _mm_or_si128(x, _mm_xor_si128(y, _mm_set1_epi32(-1)));
+  }
+  template<int n> inline Lanes rotateLeft(Lanes x) {
+    return _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - n));
+  }
+#elif defined(MD5_NEON)
+  using Lanes = uint32x4_t;
+
+  inline Lanes splat(uInt32 c) { return vdupq_n_u32(c); }
+  inline Lanes load(const uInt32* w) { return vld1q_u32(w); }
+  inline void store(uInt32* w, Lanes x) { vst1q_u32(w, x); }
+  inline Lanes add(Lanes x, Lanes y) { return vaddq_u32(x, y); }
+  inline Lanes bitAnd(Lanes x, Lanes y) { return vandq_u32(x, y); }
+  inline Lanes bitOr(Lanes x, Lanes y) { return vorrq_u32(x, y); }
+  inline Lanes bitXor(Lanes x, Lanes y) { return veorq_u32(x, y); }
+  inline Lanes andNot(Lanes x, Lanes y) { return vbicq_u32(x, y); }
+  inline Lanes orNot(Lanes x, Lanes y) { return vornq_u32(x, y); }
+  template<int n> inline Lanes rotateLeft(Lanes x) {
+    return vorrq_u32(vshlq_n_u32(x, n), vshrq_n_u32(x, 32 - n));
+  }
+#else
+  struct Lanes { uInt32 v[LANES]; };
+
+  #define MD5_LANEWISE(expr) \
+    Lanes r; for(uInt32 i = 0; i < LANES; ++i) r.v[i] = (expr); return r;
+
+  inline Lanes splat(uInt32 c) { MD5_LANEWISE(c) }
+  inline Lanes load(const uInt32* w) { MD5_LANEWISE(w[i]) }
+  inline void store(uInt32* w, Lanes x) { memcpy(w, x.v, sizeof(x.v)); }
+  inline Lanes add(Lanes x, Lanes y) { MD5_LANEWISE(x.v[i] + y.v[i]) }
+  inline Lanes bitAnd(Lanes x, Lanes y) { MD5_LANEWISE(x.v[i] & y.v[i]) }
+  inline Lanes bitOr(Lanes x, Lanes y) { MD5_LANEWISE(x.v[i] | y.v[i]) }
+  inline Lanes bitXor(Lanes x, Lanes y) { MD5_LANEWISE(x.v[i] ^ y.v[i]) }
+  inline Lanes andNot(Lanes x, Lanes y) { MD5_LANEWISE(x.v[i] & ~y.v[i]) }
+  inline Lanes orNot(Lanes x, Lanes y) { MD5_LANEWISE(x.v[i] | ~y.v[i]) }
+  template<int n> inline Lanes rotateLeft(Lanes x) {
+    MD5_LANEWISE(ROTATE_LEFT(x.v[i], n))
+  }
+
+  #undef MD5_LANEWISE
+#endif
+
+// The basic MD5 functions and transformations, on all lanes
+inline Lanes F4(Lanes x, Lanes y, Lanes z) {
+  return bitOr(bitAnd(x, y), andNot(z, x));
+}
+inline Lanes G4(Lanes x, Lanes y, Lanes z) {
+  return bitOr(bitAnd(x, z), andNot(y, z));
+}
+inline Lanes H4(Lanes x, Lanes y, Lanes z) {
+  return bitXor(bitXor(x, y), z);
+}
+inline Lanes I4(Lanes x, Lanes y, Lanes z) {
+  return bitXor(y, orNot(x, z));
+}
+
+template<int s>
+inline void step4(Lanes& a, Lanes b, Lanes f, Lanes x, uInt32 ac) {
+  a = add(rotateLeft<s>(add(add(a, f), add(x, splat(ac)))), b);
+}
+
+#define FF4(a, b, c, d, x, s, ac) step4<s>(a, b, F4(b, c, d), x, ac);
+#define GG4(a, b, c, d, x, s, ac) step4<s>(a, b, G4(b, c, d), x, ac);
+#define HH4(a, b, c, d, x, s, ac) step4<s>(a, b, H4(b, c, d), x, ac);
+#define II4(a, b, c, d, x, s, ac) step4<s>(a, b, I4(b, c, d), x, ac);
+
+// MD5 basic transformation, for one block of each lane.  The state is
+// stored word by word, i.e. state[1][2] is the second word of lane 2.
+void MD5Transform4(uInt32 state[4][LANES], const uInt8* const block[LANES])
+{
+  uInt32 words[16][LANES];
+  for(uInt32 lane = 0; lane < LANES; ++lane)
+  {
+    uInt32 w[16];
+    Decode(w, block[lane], 64);
+    for(uInt32 i = 0; i < 16; ++i)
+      words[i][lane] = w[i];
+  }
+
+  Lanes x[16];
+  for(uInt32 i = 0; i < 16; ++i)
+    x[i] = load(words[i]);
+
+  Lanes a = load(state[0]), b = load(state[1]),
+        c = load(state[2]), d = load(state[3]);
+
+  /* Round 1 */
+  FF4 (a, b, c, d, x[ 0], S11, 0xd76aa478)
+  FF4 (d, a, b, c, x[ 1], S12, 0xe8c7b756)
+  FF4 (c, d, a, b, x[ 2], S13, 0x242070db)
+  FF4 (b, c, d, a, x[ 3], S14, 0xc1bdceee)
+  FF4 (a, b, c, d, x[ 4], S11, 0xf57c0faf)
+  FF4 (d, a, b, c, x[ 5], S12, 0x4787c62a)
+  FF4 (c, d, a, b, x[ 6], S13, 0xa8304613)
+  FF4 (b, c, d, a, x[ 7], S14, 0xfd469501)
+  FF4 (a, b, c, d, x[ 8], S11, 0x698098d8)
+  FF4 (d, a, b, c, x[ 9], S12, 0x8b44f7af)
+  FF4 (c, d, a, b, x[10], S13, 0xffff5bb1)
+  FF4 (b, c, d, a, x[11], S14, 0x895cd7be)
+  FF4 (a, b, c, d, x[12], S11, 0x6b901122)
+  FF4 (d, a, b, c, x[13], S12, 0xfd987193)
+  FF4 (c, d, a, b, x[14], S13, 0xa679438e)
+  FF4 (b, c, d, a, x[15], S14, 0x49b40821)
+
+  /* Round 2 */
+  GG4 (a, b, c, d, x[ 1], S21, 0xf61e2562)
+  GG4 (d, a, b, c, x[ 6], S22, 0xc040b340)
+  GG4 (c, d, a, b, x[11], S23, 0x265e5a51)
+  GG4 (b, c, d, a, x[ 0], S24, 0xe9b6c7aa)
+  GG4 (a, b, c, d, x[ 5], S21, 0xd62f105d)
+  GG4 (d, a, b, c, x[10], S22,  0x2441453)
+  GG4 (c, d, a, b, x[15], S23, 0xd8a1e681)
+  GG4 (b, c, d, a, x[ 4], S24, 0xe7d3fbc8)
+  GG4 (a, b, c, d, x[ 9], S21, 0x21e1cde6)
+  GG4 (d, a, b, c, x[14], S22, 0xc33707d6)
+  GG4 (c, d, a, b, x[ 3], S23, 0xf4d50d87)
+  GG4 (b, c, d, a, x[ 8], S24, 0x455a14ed)
+  GG4 (a, b, c, d, x[13], S21, 0xa9e3e905)
+  GG4 (d, a, b, c, x[ 2], S22, 0xfcefa3f8)
+  GG4 (c, d, a, b, x[ 7], S23, 0x676f02d9)
+  GG4 (b, c, d, a, x[12], S24, 0x8d2a4c8a)
+
+  /* Round 3 */
+  HH4 (a, b, c, d, x[ 5], S31, 0xfffa3942)
+  HH4 (d, a, b, c, x[ 8], S32, 0x8771f681)
+  HH4 (c, d, a, b, x[11], S33, 0x6d9d6122)
+  HH4 (b, c, d, a, x[14], S34, 0xfde5380c)
+  HH4 (a, b, c, d, x[ 1], S31, 0xa4beea44)
+  HH4 (d, a, b, c, x[ 4], S32, 0x4bdecfa9)
+  HH4 (c, d, a, b, x[ 7], S33, 0xf6bb4b60)
+  HH4 (b, c, d, a, x[10], S34, 0xbebfbc70)
+  HH4 (a, b, c, d, x[13], S31, 0x289b7ec6)
+  HH4 (d, a, b, c, x[ 0], S32, 0xeaa127fa)
+  HH4 (c, d, a, b, x[ 3], S33, 0xd4ef3085)
+  HH4 (b, c, d, a, x[ 6], S34,  0x4881d05)
+  HH4 (a, b, c, d, x[ 9], S31, 0xd9d4d039)
+  HH4 (d, a, b, c, x[12], S32, 0xe6db99e5)
+  HH4 (c, d, a, b, x[15], S33, 0x1fa27cf8)
+  HH4 (b, c, d, a, x[ 2], S34, 0xc4ac5665)
+
+  /* Round 4 */
+  II4 (a, b, c, d, x[ 0], S41, 0xf4292244)
+  II4 (d, a, b, c, x[ 7], S42, 0x432aff97)
+  II4 (c, d, a, b, x[14], S43, 0xab9423a7)
+  II4 (b, c, d, a, x[ 5], S44, 0xfc93a039)
+  II4 (a, b, c, d, x[12], S41, 0x655b59c3)
+  II4 (d, a, b, c, x[ 3], S42, 0x8f0ccc92)
+  II4 (c, d, a, b, x[10], S43, 0xffeff47d)
+  II4 (b, c, d, a, x[ 1], S44, 0x85845dd1)
+  II4 (a, b, c, d, x[ 8], S41, 0x6fa87e4f)
+  II4 (d, a, b, c, x[15], S42, 0xfe2ce6e0)
+  II4 (c, d, a, b, x[ 6], S43, 0xa3014314)
+  II4 (b, c, d, a, x[13], S44, 0x4e0811a1)
+  II4 (a, b, c, d, x[ 4], S41, 0xf7537e82)
+  II4 (d, a, b, c, x[11], S42, 0xbd3af235)
+  II4 (c, d, a, b, x[ 2], S43, 0x2ad7d2bb)
+  II4 (b, c, d, a, x[ 9], S44, 0xeb86d391)
+
+  store(state[0], add(load(state[0]), a));
+  store(state[1], add(load(state[1]), b));
+  store(state[2], add(load(state[2]), c));
+  store(state[3], add(load(state[3]), d));
+}
+
+#undef FF4
+#undef GG4
+#undef HH4
+#undef II4
+
+// A message being hashed in one lane.  The full blocks are read from the
+// message itself, the last (padded) one or two from 'tail'.
+struct Lane
+{
+  const uInt8* data;
+  uInt32 fullBlocks;
+  uInt32 blocks;
+  uInt32 block;
+  uInt32 message;
+  uInt8 tail[128];
+
+  void start(const uInt8* buffer, uInt32 length, uInt32 idx)
+  {
+    data = buffer;
+    fullBlocks = length / 64;
+    block = 0;
+    message = idx;
+
+    const uInt32 rest = length % 64;
+    const uInt32 tailBlocks = rest < 56 ? 1 : 2;
+    blocks = fullBlocks + tailBlocks;
+
+    memset(tail, 0, sizeof(tail));
+    memcpy(tail, buffer + fullBlocks * 64, rest);
+    tail[rest] = 0x80;
+
+    const uInt32 count[2] = { length << 3, length >> 29 };
+    Encode(tail + tailBlocks * 64 - 8, count, 8);
+  }
+
+  const uInt8* current() const
+  {
+    return block < fullBlocks ? data + block * 64
+                              : tail + (block - fullBlocks) * 64;
+  }
+};
+
+}  // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<string> hash(const vector<const uInt8*>& buffers,
+                    const vector<uInt32>& lengths)
+{
+  static const uInt8 idleBlock[64] = { 0 };
+
+  vector<string> digests(buffers.size());
+  uInt32 next = 0;
+
+  Lane lane[LANES];
+  bool active[LANES];
+  uInt32 state[4][LANES];
+
+  const auto startLane = [&](uInt32 l) {
+    active[l] = next < buffers.size();
+    if(active[l])
+    {
+      lane[l].start(buffers[next], lengths[next], next);
+      for(uInt32 i = 0; i < 4; ++i)
+        state[i][l] = INITIAL_STATE[i];
+      ++next;
+    }
+  };
+
+  for(uInt32 l = 0; l < LANES; ++l)
+    startLane(l);
+
+  for(;;)
+  {
+    // Run all lanes until the first message is complete
+    uInt32 count = 0, run = ~0u;
+    for(uInt32 l = 0; l < LANES; ++l)
+      if(active[l])
+      {
+        ++count;
+        run = std::min(run, lane[l].blocks - lane[l].block);
+      }
+
+    if(count == 0)
+      break;
+    else if(count == 1)
+    {
+      // A single message is left; the scalar code is faster for that
+      for(uInt32 l = 0; l < LANES; ++l)
+        if(active[l])
+        {
+          uInt32 s[4] = { state[0][l], state[1][l], state[2][l], state[3][l] };
+          for(; lane[l].block < lane[l].blocks; ++lane[l].block)
+            MD5Transform(s, lane[l].current());
+          for(uInt32 i = 0; i < 4; ++i)
+            state[i][l] = s[i];
+        }
+    }
+    else
+    {
+      const uInt8* block[LANES];
+      for(uInt32 b = 0; b < run; ++b)
+      {
+        for(uInt32 l = 0; l < LANES; ++l)
+          block[l] = active[l] ? lane[l].current() : idleBlock;
+
+        MD5Transform4(state, block);
+
+        for(uInt32 l = 0; l < LANES; ++l)
+          if(active[l])
+            ++lane[l].block;
+      }
+    }
+
+    // Collect the finished messages, and start the next ones in their lanes
+    for(uInt32 l = 0; l < LANES; ++l)
+      if(active[l] && lane[l].block == lane[l].blocks)
+      {
+        const uInt32 s[4] = { state[0][l], state[1][l], state[2][l], state[3][l] };
+        uInt8 digest[16];
+        Encode(digest, s, 16);
+        digests[lane[l].message] = toHex(digest);
+
+        startLane(l);
+      }
+  }
+
+  return digests;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string hash(const ByteBuffer& buffer, uInt32 length)
+{
+  return hash(buffer.get(), length);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string hash(const uInt8* buffer, uInt32 length)
+{
+  Hasher hasher;
+  hasher.update(buffer, length);
+
+  return hasher.digest();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
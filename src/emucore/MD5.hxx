@@ -35,6 +35,19 @@ namespace MD5 {
 string hash(const ByteBuffer& buffer, uInt32 length);
 string hash(const uInt8* buffer, uInt32 length);
 
+/**
+  Get the MD5 Message-Digests of several messages at once.  The messages
+  are hashed in parallel, four at a time, using SIMD instructions where
+  available.  This is much faster than hashing them one after another,
+  in particular for messages of similar length.
+
+  @param buffers The messages to compute the digests of
+  @param lengths The lengths of the messages
+  @return The message-digests, in the same order as the messages
+*/
+vector<string> hash(const vector<const uInt8*>& buffers,
+                    const vector<uInt32>& lengths);
+
 /**
   Get the MD5 Message-Digest of the file contained in 'node'.
   The digest consists of 32 hexadecimal digits.
@@ -44,6 +57,35 @@ string hash(const uInt8* buffer, uInt32 length);
 */
 string hash(const FilesystemNode& node);
 
+/**
+  Calculates an MD5 Message-Digest incrementally, for messages which are
+  processed in pieces (e.g. while they are read).
+*/
+class Hasher
+{
+  public:
+    Hasher();
+
+    /**
+      Append the given data to the message.
+    */
+    void update(const uInt8* buffer, uInt32 length);
+
+    /**
+      Get the digest of the message; the hasher is reset afterwards.
+      The digest consists of 32 hexadecimal digits.
+    */
+    string digest();
+
+  private:
+    void reset();
+
+  private:
+    uInt32 myState[4];
+    uInt64 myLength;
+    uInt8 myBuffer[64];
+};
+
 }  // Namespace MD5
 
 #endif
@@ -17,6 +17,14 @@
 
 #include <cstdio>
 
+#if defined(BSPF_UNIX) || defined(BSPF_MACOS)
+  #include <unistd.h>
+#elif defined(BSPF_WINDOWS)
+  #include <io.h>
+  #include <windows.h>
+#endif
+
+#include "FSNode.hxx"
 #include "System.hxx"
 #include "MT24LC256.hxx"
 
@@ -42,6 +50,8 @@
     4 - Chip waiting for acknowledgement
 */
 
+constexpr uInt32 MT24LC256::FLUSH_DELAY;
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 MT24LC256::MT24LC256(const string& filename, const System& system,
                      Controller::onMessageCallback callback)
@@ -56,6 +66,8 @@ MT24LC256::MT24LC256(const string& filename, const System& system,
     myDataFile(filename),
     myDataFileExists(false),
     myDataChanged(false),
+    myFlushPending(false),
+    myFlushQuit(false),
     jpee_mdat(0),
     jpee_sdat(0),
     jpee_mclk(0),
@@ -88,19 +100,29 @@ MT24LC256::MT24LC256(const string& filename, const System& system,
   // Then initialize the I2C state
   jpee_init();
 
+  // Nothing needs to be written back yet
+  memcpy(myFileData, myData, FLASH_SIZE);
+  std::fill(myPageDirty, myPageDirty + PAGE_NUM, false);
+
   systemReset();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 MT24LC256::~MT24LC256()
 {
-  // Save EEPROM data to external file only when necessary
-  if(!myDataFileExists || myDataChanged)
+  if(myFlushThread.joinable())
   {
-    ofstream out(myDataFile, std::ios_base::binary);
-    if(out.is_open())
-      out.write(reinterpret_cast<char*>(myData), FLASH_SIZE);
+    {
+      std::lock_guard<std::mutex> lock(myFlushMutex);
+      myFlushQuit = true;
+    }
+    myFlushCondition.notify_one();
+    myFlushThread.join();
   }
+
+  // Save EEPROM data to external file only when necessary
+  if(!myDataFileExists || myFlushPending)
+    flush();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -156,18 +178,25 @@ void MT24LC256::systemReset()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void MT24LC256::eraseAll()
 {
+  std::lock_guard<std::mutex> lock(myFlushMutex);
+
   memset(myData, INIT_VALUE, FLASH_SIZE);
+  for(uInt32 page = 0; page < PAGE_NUM; ++page)
+    pageChanged(page);
   myDataChanged = true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void MT24LC256::eraseCurrent()
 {
+  std::lock_guard<std::mutex> lock(myFlushMutex);
+
   for(uInt32 page = 0; page < PAGE_NUM; ++page)
   {
     if(myPageHit[page])
     {
       memset(myData + page * PAGE_SIZE, INIT_VALUE, PAGE_SIZE);
+      pageChanged(page);
       myDataChanged = true;
     }
   }
@@ -247,10 +276,12 @@ void MT24LC256::jpee_data_stop()
       jpee_pptr = 4+jpee_pagemask-(jpee_address & jpee_pagemask);
       JPEE_LOG1("I2C_WARNING PAGECROSSING!(Truncate to %d bytes)",jpee_pptr-3)
     }
+    std::lock_guard<std::mutex> lock(myFlushMutex);
     for (int i=3; i<jpee_pptr; i++)
     {
       myDataChanged = true;
       myPageHit[jpee_address / PAGE_SIZE] = true;
+      pageChanged((jpee_address & jpee_sizemask) / PAGE_SIZE);
 
       myCallback("AtariVox/SaveKey EEPROM write");
 
@@ -407,3 +438,98 @@ bool MT24LC256::jpee_timercheck(int mode)
     return myTimerActive;
   }
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MT24LC256::pageChanged(uInt32 page)
+{
+  myPageDirty[page] = true;
+
+  // Every write postpones writing back, so a burst of writes (e.g. a game
+  // saving its state) ends up in the file in one go
+  myFlushTime = std::chrono::steady_clock::now() +
+                std::chrono::milliseconds(FLUSH_DELAY);
+  myFlushPending = true;
+
+  if(!myFlushThread.joinable())
+    myFlushThread = std::thread([this] { flushLoop(); });
+  myFlushCondition.notify_one();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MT24LC256::flush()
+{
+  // Only the changed pages are copied while holding the lock; writing the
+  // file happens without it, so the emulation is never held up by it
+  {
+    std::lock_guard<std::mutex> lock(myFlushMutex);
+
+    for(uInt32 page = 0; page < PAGE_NUM; ++page)
+    {
+      if(myPageDirty[page])
+      {
+        memcpy(myFileData + page * PAGE_SIZE, myData + page * PAGE_SIZE, PAGE_SIZE);
+        myPageDirty[page] = false;
+      }
+    }
+    myFlushPending = false;
+  }
+
+  if(writeDataFile(myFileData))
+    myDataFileExists = true;
+  FilesystemNode::invalidateCache(myDataFile);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MT24LC256::flushLoop()
+{
+  std::unique_lock<std::mutex> lock(myFlushMutex);
+
+  while(!myFlushQuit)
+  {
+    if(!myFlushPending)
+      myFlushCondition.wait(lock);
+    else if(std::chrono::steady_clock::now() < myFlushTime)
+    {
+      const auto flushTime = myFlushTime;
+      myFlushCondition.wait_until(lock, flushTime);
+    }
+    else
+    {
+      lock.unlock();
+      flush();
+      lock.lock();
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MT24LC256::writeDataFile(const uInt8* data) const
+{
+  // Write to a temporary file first and make sure it's on disk, so that
+  // the data file is either the old or the new one, even after a crash
+  const string tmpFile = myDataFile + ".tmp";
+
+  FILE* out = fopen(tmpFile.c_str(), "wb");
+  if(out == nullptr)
+    return false;
+
+  bool ok = fwrite(data, 1, FLASH_SIZE, out) == FLASH_SIZE && fflush(out) == 0;
+#if defined(BSPF_UNIX) || defined(BSPF_MACOS)
+  ok = ok && fsync(fileno(out)) == 0;
+#elif defined(BSPF_WINDOWS)
+  ok = ok && _commit(_fileno(out)) == 0;
+#endif
+  ok = fclose(out) == 0 && ok;
+
+#if defined(BSPF_WINDOWS)
+  ok = ok && MoveFileEx(tmpFile.c_str(), myDataFile.c_str(),
+                        MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+  ok = ok && std::rename(tmpFile.c_str(), myDataFile.c_str()) == 0;
+#endif
+
+  if(!ok)
+    std::remove(tmpFile.c_str());
+
+  return ok;
+}
@@ -20,6 +20,11 @@
 
 class System;
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include "Control.hxx"
 #include "bspf.hxx"
 
@@ -28,6 +33,10 @@ class System;
   Erasable PROM accessed using the I2C protocol.  Thanks to J. Payson
   (aka Supercat) for the bulk of this code.
 
+  Changes are written back to the data file from a thread of its own,
+  shortly after the last write, so that little is lost when the process
+  dies.  The file is replaced atomically, so it's never left half written.
+
   @author  Stephen Anthony & J. Payson
 */
 class MT24LC256
@@ -82,10 +91,27 @@ class MT24LC256
 
     void update();
 
+    // Mark the given page as changed, and schedule writing it back
+    // (must be called with myFlushMutex held)
+    void pageChanged(uInt32 page);
+
+    // Write back all changed pages to the data file
+    void flush();
+
+    // The loop of the flush thread
+    void flushLoop();
+
+    // Write the given data to a temporary file, and then replace the data
+    // file with it
+    bool writeDataFile(const uInt8* data) const;
+
   private:
     // Inital state value of flash EEPROM
     static constexpr uInt8 INIT_VALUE = 0xff;
 
+    // How long after the last write the data is written back (in msec)
+    static constexpr uInt32 FLUSH_DELAY = 1000;
+
     // The system of the parent controller
     const System& mySystem;
 
@@ -120,6 +146,22 @@ class MT24LC256
     // Indicates if the EEPROM has changed since class invocation
     bool myDataChanged;
 
+    // The pages changed since they were last written back
+    bool myPageDirty[PAGE_NUM];
+
+    // The contents of the data file, as last written back (only used by
+    // the flush thread)
+    uInt8 myFileData[FLASH_SIZE];
+
+    // The flush thread, started on the first change; it writes back
+    // the changed pages once no writes happened for FLUSH_DELAY.
+    // myFlushMutex guards changes to myData and the state below.
+    std::thread myFlushThread;
+    std::mutex myFlushMutex;
+    std::condition_variable myFlushCondition;
+    std::chrono::steady_clock::time_point myFlushTime;
+    bool myFlushPending, myFlushQuit;
+
     // Required for I2C functionality
     Int32 jpee_mdat, jpee_sdat, jpee_mclk;
     Int32 jpee_sizemask, jpee_pagemask, jpee_smallmode, jpee_logmode;
@@ -56,22 +56,43 @@
 #include "Console.hxx"
 #include "Random.hxx"
 #include "StateManager.hxx"
+#include "Serializer.hxx"
 #include "TimerManager.hxx"
+#include "FrameRecorder.hxx"
+#include "FrameTelemetry.hxx"
+#include "FrameServer.hxx"
+#include "StreamServer.hxx"
+#include "CpuFeatures.hxx"
+#include "RomIndex.hxx"
+#include "DetectionCache.hxx"
+#include "HeadlessConsole.hxx"
+#include "FSNodeZIP.hxx"
 #include "Version.hxx"
 #include "TIA.hxx"
 #include "DispatchResult.hxx"
 #include "EmulationWorker.hxx"
 #include "AudioSettings.hxx"
+#include "AudioQueue.hxx"
 #include "repository/KeyValueRepositoryNoop.hxx"
 #include "repository/KeyValueRepositoryConfigfile.hxx"
 #include "M6532.hxx"
 
 #include "OSystem.hxx"
 
-using namespace std::chrono;
-
 namespace {
   constexpr uInt32 FPS_METER_QUEUE_SIZE = 100;
+
+  // How long the main loop lets the worker run unthrottled in turbo mode
+  // before it polls events again
+  constexpr double TURBO_TIMESLICE = 1. / 60.;
+
+  // After this many GUI updates without a redraw, the main loop sleeps until
+  // the next event, but for at most the given time (in milliseconds)
+  constexpr uInt32 IDLE_UPDATES = 60;
+  constexpr uInt32 IDLE_WAIT = 100;
+
+  // Weight of the previous average when averaging the cost of presenting
+  constexpr double PRESENT_COST_SMOOTHING = 0.9;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -79,7 +100,12 @@ OSystem::OSystem()
   : myLauncherUsed(false),
     myQuitLoop(false),
     mySettingsLoaded(false),
-    myFpsMeter(FPS_METER_QUEUE_SIZE)
+    myFpsMeter(FPS_METER_QUEUE_SIZE),
+    myRunAheadFrames(0),
+    myTurbo(false),
+    myTurboSkip(1),
+    myMaxFrameSkip(0),
+    myPresentCost(0)
 {
   // Get built-in features
   #ifdef SOUND_SUPPORT
@@ -121,14 +147,23 @@ OSystem::OSystem()
 OSystem::~OSystem()
 {
   Logger::instance().clearLogCallback();
+
+#if defined(ZIP_SUPPORT)
+  // The index may live in our database, which must not outlive us
+  FilesystemNodeZIP::setIndexRepository(nullptr);
+#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool OSystem::create()
 {
+  // Kernels are selected for the CPU as their users are created
+  CpuFeatures::detect();
+
   ostringstream buf;
   buf << "Stella " << STELLA_VERSION << endl
       << "  Features: " << myFeatures << endl
+      << "  CPU: " << CpuFeatures::features() << endl
       << "  " << myBuildInfo << endl << endl
       << "Base directory:     '"
       << FilesystemNode(myBaseDir).getShortPath() << "'" << endl
@@ -164,6 +199,34 @@ bool OSystem::create()
 
   myStateManager = make_unique<StateManager>(*this);
   myTimerManager = make_unique<TimerManager>();
+  myFrameRecorder = make_unique<FrameRecorder>(*this);
+  myTelemetry = make_unique<FrameTelemetry>(*this);
+
+  // Publish frames and audio to other processes, if requested
+  const string& frameServerFile = mySettings->getString("frameserver");
+  if(frameServerFile != "")
+  {
+    myFrameServer = make_unique<FrameServer>();
+    if(!myFrameServer->open(frameServerFile))
+    {
+      Logger::error("ERROR: Couldn't create frame server file " + frameServerFile);
+      myFrameServer.reset();
+    }
+  }
+
+  // Stream frames and audio to remote players, if requested
+  const int streamPort = mySettings->getInt("stream.port");
+  if(streamPort > 0)
+  {
+    const string& streamAddress = mySettings->getString("stream.bind");
+    myStreamServer = make_unique<StreamServer>();
+    if(!myStreamServer->open(uInt16(streamPort), streamAddress))
+    {
+      Logger::error("ERROR: Couldn't stream on UDP " + streamAddress + ":" +
+                    std::to_string(streamPort));
+      myStreamServer.reset();
+    }
+  }
   myAudioSettings = make_unique<AudioSettings>(*mySettings);
 
   // Create the sound object; the sound subsystem isn't actually
@@ -179,13 +242,8 @@ bool OSystem::create()
   myCheatManager->loadCheatDatabase();
 #endif
 
-#ifdef GUI_SUPPORT
-  // Create various subsystems (menu and launcher GUI objects, etc)
-  myMenu = make_unique<Menu>(*this);
-  myCommandMenu = make_unique<CommandMenu>(*this);
-  myTimeMachine = make_unique<TimeMachine>(*this);
-  myLauncher = make_unique<Launcher>(*this);
-#endif
+  // The GUI subsystems (menu and launcher GUI objects, etc) are created
+  // when first used
 
 #ifdef PNG_SUPPORT
   // Create PNG handler
@@ -197,6 +255,44 @@ bool OSystem::create()
   return true;
 }
 
+#ifdef GUI_SUPPORT
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Menu& OSystem::menu()
+{
+  if(!myMenu)
+    myMenu = make_unique<Menu>(*this);
+
+  return *myMenu;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CommandMenu& OSystem::commandMenu()
+{
+  if(!myCommandMenu)
+    myCommandMenu = make_unique<CommandMenu>(*this);
+
+  return *myCommandMenu;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Launcher& OSystem::launcher()
+{
+  if(!myLauncher)
+    myLauncher = make_unique<Launcher>(*this);
+
+  return *myLauncher;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TimeMachine& OSystem::timeMachine()
+{
+  if(!myTimeMachine)
+    myTimeMachine = make_unique<TimeMachine>(*this);
+
+  return *myTimeMachine;
+}
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void OSystem::loadConfig(const Settings::Options& options)
 {
@@ -231,6 +327,11 @@ void OSystem::loadConfig(const Settings::Options& options)
 #endif
 
   mySettings->setRepository(createSettingsRepository());
+  myRomIndex = make_unique<RomIndex>(createRomIndexRepository());
+  myDetectionCache = make_unique<DetectionCache>(createDetectionCacheRepository());
+#if defined(ZIP_SUPPORT)
+  FilesystemNodeZIP::setIndexRepository(createZipIndexRepository());
+#endif
 
   Logger::debug("Loading config options ...");
   mySettings->load(options);
@@ -329,7 +430,7 @@ FBInitStatus OSystem::createFrameBuffer()
 
   #ifdef GUI_SUPPORT
     case EventHandlerState::LAUNCHER:
-      if((fbstatus = myLauncher->initializeVideo()) != FBInitStatus::Success)
+      if((fbstatus = launcher().initializeVideo()) != FBInitStatus::Success)
         return fbstatus;
       break;
   #endif
@@ -416,7 +517,14 @@ string OSystem::createConsole(const FilesystemNode& rom, const string& md5sum,
       myEventHandler->reset(EventHandlerState::LAUNCHER);
       return "ERROR: Couldn't create framebuffer for console";
     }
+    myTurbo = false;
     myConsole->initializeAudio();
+    myRunAheadFrames = mySettings->getInt("runahead");
+    myMaxFrameSkip = mySettings->getInt("frameskip");
+    myPresentCost = 0;
+    myFramePacer.setMode(
+      mySettings->getString("pacing") == "display" && mySettings->getBool("vsync")
+        ? FramePacer::Mode::display : FramePacer::Mode::timer);
 
     if(showmessage)
     {
@@ -458,6 +566,24 @@ bool OSystem::hasConsole() const
          myEventHandler->state() != EventHandlerState::LAUNCHER;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<AudioQueue> OSystem::audioQueue(uInt32 fragmentSize, uInt32 capacity, bool isStereo)
+{
+  if(myAudioQueue)
+    myAudioQueue->reconfigure(fragmentSize, capacity, isStereo);
+  else
+  {
+    myAudioQueue = make_shared<AudioQueue>(fragmentSize, capacity, isStereo);
+    if(myFrameServer || myStreamServer)
+      myAudioQueue->setFragmentCallback([this](const Int16* fragment, uInt32 samples) {
+        if(myFrameServer) myFrameServer->publishAudio(fragment, samples);
+        if(myStreamServer) myStreamServer->sendAudio(fragment, samples);
+      });
+  }
+
+  return myAudioQueue;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool OSystem::createLauncher(const string& startdir)
 {
@@ -473,7 +599,7 @@ bool OSystem::createLauncher(const string& startdir)
   myEventHandler->reset(EventHandlerState::LAUNCHER);
   if(createFrameBuffer() == FBInitStatus::Success)
   {
-    myLauncher->reStack();
+    launcher().reStack();
     myFrameBuffer->setCursorState();
 
     status = true;
@@ -583,6 +709,7 @@ unique_ptr<Console> OSystem::openConsole(const FilesystemNode& romfile, string&
     CMDLINE_PROPS_UPDATE("cp", PropType::Controller_SwapPaddles);
     CMDLINE_PROPS_UPDATE("ma", PropType::Controller_MouseAxis);
     CMDLINE_PROPS_UPDATE("channels", PropType::Cart_Sound);
+    CMDLINE_PROPS_UPDATE("thumbfast", PropType::Cart_ThumbFast);
     CMDLINE_PROPS_UPDATE("ld", PropType::Console_LeftDiff);
     CMDLINE_PROPS_UPDATE("rd", PropType::Console_RightDiff);
     CMDLINE_PROPS_UPDATE("tv", PropType::Console_TVType);
@@ -604,6 +731,9 @@ void OSystem::closeConsole()
 {
   if(myConsole)
   {
+    myFrameRecorder->stop();
+    myStateManager->stopMovie();
+
   #ifdef CHEATCODE_SUPPORT
     // If a previous console existed, save cheats before creating a new one
     myCheatManager->saveCheats(myConsole->properties().get(PropType::Cart_MD5));
@@ -621,7 +751,22 @@ ByteBuffer OSystem::openROM(const FilesystemNode& rom, string& md5, uInt32& size
   // contain a valid name
 
   ByteBuffer image;
-  if((size = rom.read(image)) == 0)
+  size = 0;
+  if(myPrefetch.valid() && rom == myPrefetchedFile)
+  {
+    // A failed prefetch is simply read again
+    try
+    {
+      PrefetchedROM prefetched = myPrefetch.get();
+      image = std::move(prefetched.image);
+      size = prefetched.size;
+      md5 = prefetched.md5;
+      if(prefetched.format != "")
+        insertPrefetchedDetection(rom, prefetched);
+    }
+    catch(const std::exception&) { }
+  }
+  if(size == 0 && (size = rom.read(image)) == 0)
     return nullptr;
 
   // If we get to this point, we know we have a valid file to open
@@ -639,6 +784,70 @@ ByteBuffer OSystem::openROM(const FilesystemNode& rom, string& md5, uInt32& size
   return image;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::prefetchROM(const FilesystemNode& rom)
+{
+  Settings& settings = *mySettings;
+
+  myPrefetchedFile = rom;
+  myPrefetch = std::async(std::launch::async, [rom, &settings] {
+    PrefetchedROM prefetched;
+    prefetched.size = rom.read(prefetched.image);
+    if(prefetched.size == 0)
+      return prefetched;
+
+    prefetched.md5 = MD5::hash(prefetched.image, prefetched.size);
+    prefetched.type = CartDetector::autodetectType(prefetched.image, prefetched.size);
+
+    // Multicarts depend on the load count, and Supercharger loads on the
+    // 'fastscbios' setting, which are both changed while loading
+    if((prefetched.type >= Bankswitch::Type::_2IN1 &&
+        prefetched.type <= Bankswitch::Type::_128IN1) ||
+       prefetched.type == Bankswitch::Type::_AR)
+      return prefetched;
+
+    // Detect on a headless console, as Console::startAutodetection() does
+    Properties props;
+    props.set(PropType::Cart_Type, Bankswitch::typeToName(prefetched.type));
+    props.set(PropType::Controller_Left, "JOYSTICK");
+    props.set(PropType::Controller_Right, "JOYSTICK");
+    props.set(PropType::Display_Format, "NTSC");
+    props.set(PropType::Display_YStart, "1");
+    try
+    {
+      HeadlessConsole console(prefetched.image, prefetched.size, settings, props);
+      const FrameLayout layout = console.detectLayout();
+      prefetched.ystart = console.detectYStart(layout);
+      prefetched.format = layout == FrameLayout::pal ? "PAL" : "NTSC";
+    }
+    catch(const std::exception&) { }
+
+    return prefetched;
+  });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::insertPrefetchedDetection(const FilesystemNode& rom,
+                                        const PrefetchedROM& prefetched)
+{
+  // The detection is only valid for the bankswitch type it ran with
+  Properties props;
+  myPropSet->getMD5(prefetched.md5, props);
+
+  const auto matches = [&prefetched](Bankswitch::Type type) {
+    return type == Bankswitch::Type::_AUTO || type == prefetched.type;
+  };
+  if(!matches(Bankswitch::nameToType(props.get(PropType::Cart_Type))) ||
+     !matches(Bankswitch::nameToType(mySettings->getString("bs"))) ||
+     !matches(Bankswitch::nameToType(mySettings->getString("type"))) ||
+     !matches(Bankswitch::typeFromExtension(rom)))
+    return;
+
+  myDetectionCache->insertFormat(prefetched.md5, prefetched.format);
+  myDetectionCache->insertYStart(prefetched.md5,
+    prefetched.format == "PAL" ? FrameLayout::pal : FrameLayout::ntsc, prefetched.ystart);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string OSystem::getROMInfo(const Console& console)
 {
@@ -669,32 +878,92 @@ double OSystem::dispatchEmulation(EmulationWorker& emulationWorker)
   TIA& tia(myConsole->tia());
   EmulationTiming& timing(myConsole->emulationTiming());
   DispatchResult dispatchResult;
+  bool speedCorrectionChanged = false;
 
-  // Check whether we have a frame pending for rendering...
-  bool framePending = tia.newFramePending();
+  // Check whether we have a frame pending for rendering (in turbo mode, only
+  // every few frames are rendered)...
+  bool framePending = myTurbo
+    ? tia.framesSinceLastRender() >= myTurboSkip
+    : tia.framesSinceLastRender() > frameSkip();
   // ... and copy it to the frame buffer. It is important to do this before
   // the worker is started to avoid racing.
+  FrameTelemetry::clock::time_point start = FrameTelemetry::clock::now();
   if (framePending) {
     myFpsMeter.render(tia.framesSinceLastRender());
-    tia.renderToFrameBuffer();
+    if (myRunAheadFrames > 0 && !myTurbo && !myConsole->inputMovie())
+      runAhead(myRunAheadFrames);
+    else
+      tia.renderToFrameBuffer();
+
+    if (myFrameServer) {
+      myFrameServer->publishFrame(tia.frameBuffer(), tia.height(), tia.frameCount(),
+                                  uInt32(myConsole->timing()));
+      if (myAudioQueue)
+        myFrameServer->setAudioFormat(myConsole->emulationTiming().audioSampleRate(),
+                                      myAudioQueue->isStereo());
+    }
+    if (myStreamServer) {
+      myStreamServer->sendFrame(tia.frameBuffer(), tia.height(), tia.frameCount(),
+                                uInt32(myConsole->timing()));
+      if (myAudioQueue)
+        myStreamServer->setAudioFormat(myConsole->emulationTiming().audioSampleRate(),
+                                       myAudioQueue->isStereo());
+    }
   }
+  FrameTelemetry::clock::time_point end = FrameTelemetry::clock::now();
+  const FrameTelemetry::clock::duration renderTime = end - start;
 
   // Start emulation on a dedicated thread. It will do its own scheduling to sync 6507 and real time
-  // and will run until we stop the worker.
+  // (unless in turbo mode) and will run until we stop the worker.
+  start = end;
   emulationWorker.start(
     timing.cyclesPerSecond(),
     timing.maxCyclesPerTimeslice(),
     timing.minCyclesPerTimeslice(),
     &dispatchResult,
-    &tia
+    &tia,
+    myTurbo
   );
+  end = FrameTelemetry::clock::now();
+  FrameTelemetry::clock::duration handoffTime = end - start;
 
   // Render the frame. This may block, but emulation will continue to run on the worker, so the
   // audio pipeline is kept fed :)
-  if (framePending) myFrameBuffer->updateInEmulationMode(myFpsMeter.fps());
+  FrameTelemetry::clock::duration presentTime(0);
+  if (framePending) {
+    start = FrameTelemetry::clock::now();
+    myFrameBuffer->updateInEmulationMode(myFpsMeter.fps());
+    end = FrameTelemetry::clock::now();
+    presentTime = end - start;
+
+    if (!myTurbo)
+      myPresentCost = PRESENT_COST_SMOOTHING * myPresentCost + (1 - PRESENT_COST_SMOOTHING) *
+        std::chrono::duration<double>(renderTime + presentTime).count();
+
+    if (!myTurbo &&
+        myFramePacer.presented(start, end,
+                               myConsole->getFramerate() * mySettings->getFloat("speed")))
+      speedCorrectionChanged = true;
+  }
+
+  // In turbo mode, the worker keeps emulating while we wait for the next main
+  // loop iteration
+  if (myTurbo) myFramePacer.wait(TURBO_TIMESLICE, TURBO_TIMESLICE);
+
+  // Stopping includes waiting for the current timeslice, so the cost of a
+  // handoff (for sizing the timeslices) is estimated as twice the start
+  const FrameTelemetry::clock::duration resumeTime = handoffTime;
 
   // Stop the worker and wait until it has finished
+  start = FrameTelemetry::clock::now();
   uInt64 totalCycles = emulationWorker.stop();
+  handoffTime += FrameTelemetry::clock::now() - start;
+
+  if (myTelemetry->isEnabled()) {
+    myTelemetry->addEmulation(emulationWorker.emulationTime(), handoffTime);
+    if (framePending)
+      myTelemetry->framePresented(renderTime, presentTime, myConsole->audioQueueFill());
+  }
 
   // Handle the dispatch result
   switch (dispatchResult.getStatus()) {
@@ -729,46 +998,156 @@ double OSystem::dispatchEmulation(EmulationWorker& emulationWorker)
     myConsole->fry();
 
   // Return the 6507 time used in seconds
-  return static_cast<double>(totalCycles) / static_cast<double>(timing.cyclesPerSecond());
+  double timeslice = static_cast<double>(totalCycles) / static_cast<double>(timing.cyclesPerSecond());
+
+  // Size the next timeslices by what handing over this one cost
+  if (!myTurbo && timeslice > 0)
+    timing.adaptTimeslice(2 * std::chrono::duration<double>(resumeTime).count() / timeslice,
+                          myConsole->audioQueueFill());
+
+  // Switch emulation (and audio) to the new speed only after the timeslice
+  // has been calculated at the old one
+  if (speedCorrectionChanged) myConsole->initializeAudio();
+
+  // The main loop doesn't have to wait in turbo mode, this has happened above
+  return myTurbo ? 0. : timeslice;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 OSystem::frameSkip() const
+{
+  if (myMaxFrameSkip == 0) return 0;
+
+  // Rendering and presenting a frame happens in parallel to the emulation of
+  // the next one; if it takes longer, the main loop falls behind real time
+  // (and audio drops out), so only every few frames are presented then
+  const double frameTime = 1. / (myConsole->getFramerate() * mySettings->getFloat("speed"));
+
+  return std::min(myMaxFrameSkip, static_cast<uInt32>(myPresentCost / frameTime));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::setTurbo(bool enable)
+{
+  if(!myConsole || enable == myTurbo) return;
+
+  myTurbo = enable;
+  myTurboSkip = std::max(mySettings->getInt("turbo.skip"), 1);
+
+  // Don't generate samples, and stop the sound driver (and thus the
+  // resampler) from asking for them
+  myConsole->tia().setAudioMuted(myTurbo);
+  if(myTurbo)
+    mySound->mute(true);
+  else
+  {
+    // Start over with an empty audio queue, and pace from now on
+    myConsole->initializeAudio();
+    myFramePacer.reset();
+  }
+
+  myFrameBuffer->showMessage(myTurbo ? "Turbo mode enabled" : "Turbo mode disabled");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OSystem::runAhead(uInt32 frames)
+{
+  TIA& tia(myConsole->tia());
+
+  if(!myRunAheadState)
+    myRunAheadState = make_unique<Serializer>();
+  Serializer& state = *myRunAheadState;
+
+  state.rewind();
+  if(!(myStateManager->saveState(state) && tia.saveDisplay(state)))
+  {
+    tia.renderToFrameBuffer();
+    return;
+  }
+
+  // Emulate the requested number of frames; a frame normally completes in
+  // one timeslice, the bound only guards against a stalled TIA
+  const uInt32 target = tia.framesSinceLastRender() + frames;
+  DispatchResult dispatchResult;
+  tia.setAudioMuted(true);
+  for(uInt32 slices = 0; tia.framesSinceLastRender() < target &&
+      slices < frames * 10; ++slices)
+  {
+    tia.update(dispatchResult);
+    if(dispatchResult.getStatus() != DispatchResult::Status::ok)
+      break;  // the real timeline will run into this again
+  }
+
+  // Keep the predicted frame, then return to the real timeline
+  tia.renderToFrameBuffer();
+  const size_t size = TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight;
+  myRunAheadFrame.assign(tia.frameBuffer(), tia.frameBuffer() + size);
+
+  state.rewind();
+  myStateManager->loadState(state);
+  tia.loadDisplay(state);
+  tia.setAudioMuted(false);
+
+  tia.renderToFrameBuffer();
+  std::copy(myRunAheadFrame.begin(), myRunAheadFrame.end(), tia.frameBuffer());
+  tia.invalidateFrameBuffer();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void OSystem::mainLoop()
 {
-  // 6507 time
-  time_point<high_resolution_clock> virtualTime = high_resolution_clock::now();
   // The emulation worker
-  EmulationWorker emulationWorker;
+  EmulationWorker emulationWorker(
+    mySettings->getInt("worker.spin"),
+    ThreadPlacement::fromSettings(*mySettings, "worker"));
 
   myFpsMeter.reset(TIAConstants::initialGarbageFrames);
+  myFramePacer.reset();
+
+  // The number of GUI updates in a row which didn't redraw anything
+  uInt32 idleUpdates = 0;
 
   for(;;)
   {
     bool wasEmulation = myEventHandler->state() == EventHandlerState::EMULATION;
 
     myEventHandler->poll(TimerManager::getTicks());
+
+    // Remote players only control the emulation
+    if (myStreamServer && myEventHandler->state() == EventHandlerState::EMULATION)
+      myStreamServer->receive([this](Event::Type type, Int32 value) {
+        myEventHandler->handleEvent(type, value);
+      });
     if(myQuitLoop) break;  // Exit if the user wants to quit
 
     if (!wasEmulation && myEventHandler->state() == EventHandlerState::EMULATION) {
       myFpsMeter.reset();
-      virtualTime = high_resolution_clock::now();
+      myFramePacer.reset();
+
+      // Returning to emulation unmutes the sound driver
+      if (myTurbo) mySound->mute(true);
     }
 
     double timesliceSeconds;
 
-    if (myEventHandler->state() == EventHandlerState::EMULATION)
+    if (myEventHandler->state() == EventHandlerState::EMULATION) {
       // Dispatch emulation and render frame (if applicable)
       timesliceSeconds = dispatchEmulation(emulationWorker);
+      idleUpdates = 0;
+    }
     else {
-      // Render the GUI with 60 Hz in all other modes
+      // Render the GUI with 60 Hz in all other modes; once nothing has
+      // changed for a while, sleep until something happens instead (the
+      // emulation worker is suspended outside of emulation anyway)
       timesliceSeconds = 1. / 60.;
-      myFrameBuffer->update();
+      if (myFrameBuffer->update())
+        idleUpdates = 0;
+      else if (++idleUpdates >= IDLE_UPDATES) {
+        myEventHandler->waitEvent(IDLE_WAIT);
+        timesliceSeconds = 0;
+      }
     }
 
-    duration<double> timeslice(timesliceSeconds);
-    virtualTime += duration_cast<high_resolution_clock::duration>(timeslice);
-    time_point<high_resolution_clock> now = high_resolution_clock::now();
-
     // We allow 6507 time to lag behind by one frame max
     double maxLag = myConsole
       ? (
@@ -777,13 +1156,10 @@ void OSystem::mainLoop()
       )
       : 0;
 
-    if (duration_cast<duration<double>>(now - virtualTime).count() > maxLag)
-      // If 6507 time is lagging behind more than one frame we reset it to real time
-      virtualTime = now;
-    else if (virtualTime > now) {
-      // Wait until we have caught up with 6507 time
-      std::this_thread::sleep_until(virtualTime);
-    }
+    myFramePacer.wait(timesliceSeconds, maxLag);
+
+    // Pick up the messages logged by other threads
+    Logger::instance().flush();
   }
 
   // Cleanup time
@@ -810,6 +1186,42 @@ shared_ptr<KeyValueRepository> OSystem::createSettingsRepository()
   #endif
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<KeyValueRepository> OSystem::createRomIndexRepository()
+{
+  // Without a database, the index only lasts for the current session
+  #ifdef SQLITE_SUPPORT
+    if(mySettingsDb)
+      return shared_ptr<KeyValueRepository>(mySettingsDb, &mySettingsDb->romIndexRepository());
+  #endif
+
+  return make_shared<KeyValueRepositoryNoop>();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<KeyValueRepository> OSystem::createZipIndexRepository()
+{
+  // Without a database, archives are only indexed for the current session
+  #ifdef SQLITE_SUPPORT
+    if(mySettingsDb)
+      return shared_ptr<KeyValueRepository>(mySettingsDb, &mySettingsDb->zipIndexRepository());
+  #endif
+
+  return make_shared<KeyValueRepositoryNoop>();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<KeyValueRepository> OSystem::createDetectionCacheRepository()
+{
+  // Without a database, detection results are only kept for the current session
+  #ifdef SQLITE_SUPPORT
+    if(mySettingsDb)
+      return shared_ptr<KeyValueRepository>(mySettingsDb, &mySettingsDb->detectionCacheRepository());
+  #endif
+
+  return make_shared<KeyValueRepositoryNoop>();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string OSystem::ourOverrideBaseDir = "";
 bool OSystem::ourOverrideBaseDirWithApp = false;
@@ -26,9 +26,17 @@ class PropertiesSet;
 class Random;
 class Sound;
 class StateManager;
+class Serializer;
 class TimerManager;
 class EmulationWorker;
 class AudioSettings;
+class AudioQueue;
+class FrameRecorder;
+class FrameTelemetry;
+class FrameServer;
+class StreamServer;
+class RomIndex;
+class DetectionCache;
 #ifdef CHEATCODE_SUPPORT
   class CheatManager;
 #endif
@@ -50,11 +58,14 @@ class AudioSettings;
 #endif
 
 #include <chrono>
+#include <future>
 
+#include "Bankswitch.hxx"
 #include "FSNode.hxx"
 #include "FrameBufferConstants.hxx"
 #include "EventHandlerConstants.hxx"
 #include "FpsMeter.hxx"
+#include "FramePacer.hxx"
 #include "Settings.hxx"
 #include "Logger.hxx"
 #include "bspf.hxx"
@@ -147,6 +158,19 @@ class OSystem
     */
     AudioSettings& audioSettings() { return *myAudioSettings; }
 
+    /**
+      Get the audio queue, configured as requested.  The queue outlives
+      the consoles, so its fragments are reused rather than reallocated
+      whenever a ROM is loaded or the audio settings change.
+
+      @param fragmentSize  The size (in stereo / mono samples) of each fragment
+      @param capacity      The number of fragments that can be queued
+      @param isStereo      Whether samples are stereo or mono
+
+      @return The audio queue
+    */
+    shared_ptr<AudioQueue> audioQueue(uInt32 fragmentSize, uInt32 capacity, bool isStereo);
+
     /**
       Get the state manager of the system.
 
@@ -161,6 +185,34 @@ class OSystem
     */
     TimerManager& timer() const { return *myTimerManager; }
 
+    /**
+      Get the frame dump recorder of the system.
+
+      @return The framerecorder object
+    */
+    FrameRecorder& frameRecorder() const { return *myFrameRecorder; }
+
+    /**
+      Get the frame timing telemetry of the system.
+
+      @return The frametelemetry object
+    */
+    FrameTelemetry& telemetry() const { return *myTelemetry; }
+
+    /**
+      Get the index of ROM files (MD5 and bankswitch type) of the system.
+
+      @return The romindex object
+    */
+    RomIndex& romIndex() const { return *myRomIndex; }
+
+    /**
+      Get the cache of autodetected display formats and ystart values.
+
+      @return The detectioncache object
+    */
+    DetectionCache& detectionCache() const { return *myDetectionCache; }
+
     /**
       This method should be called to initiate the process of loading settings
       from the config file.  It takes care of loading settings, applying
@@ -195,32 +247,34 @@ class OSystem
 
   #ifdef GUI_SUPPORT
     /**
-      Get the settings menu of the system.
+      Get the settings menu of the system.  Like the other GUI objects
+      below, it is only created when first used, so that starting directly
+      into a ROM doesn't have to build any dialogs.
 
       @return The settings menu object
     */
-    Menu& menu() const { return *myMenu; }
+    Menu& menu();
 
     /**
       Get the command menu of the system.
 
       @return The command menu object
     */
-    CommandMenu& commandMenu() const { return *myCommandMenu; }
+    CommandMenu& commandMenu();
 
     /**
       Get the ROM launcher of the system.
 
       @return The launcher object
     */
-    Launcher& launcher() const { return *myLauncher; }
+    Launcher& launcher();
 
     /**
       Get the time machine of the system (manages state files).
 
       @return The time machine object
     */
-    TimeMachine& timeMachine() const { return *myTimeMachine; }
+    TimeMachine& timeMachine();
   #endif
 
   #ifdef PNG_SUPPORT
@@ -321,6 +375,18 @@ class OSystem
     string createConsole(const FilesystemNode& rom, const string& md5 = "",
                          bool newrom = true);
 
+    /**
+      Prepare loading the given ROM on a background thread (e.g. the next
+      entry of a playlist): the file (or ZIP archive) is read, its MD5
+      computed, and the bankswitch type, frame layout and ystart are
+      autodetected.  A following openROM() (and thus createConsole()) of the
+      same file picks up these results instead of doing the work itself.
+      Only the latest prefetch is kept; a new one waits for the previous one.
+
+      @param rom  The FSNode of the ROM to prefetch
+    */
+    void prefetchROM(const FilesystemNode& rom);
+
     /**
       Reloads the current console (essentially deletes and re-creates it).
       This can be thought of as a real console off/on toggle.
@@ -389,6 +455,23 @@ class OSystem
 
     float frameRate() const;
 
+    /**
+      The factor by which emulation speed is currently corrected to match
+      the display refresh rate (see FramePacer); 1 if not locked.
+    */
+    double speedCorrection() const { return myFramePacer.speedCorrection(); }
+
+    /**
+      Turbo mode runs the emulation as fast as possible.  Only every
+      'turbo.skip'-th emulated frame is rendered, and no audio is generated
+      or played, so neither costs time that emulation could use.
+
+      @param enable  Whether to enable turbo mode
+    */
+    void setTurbo(bool enable);
+    void toggleTurbo() { setTurbo(!myTurbo); }
+    bool turbo() const { return myTurbo; }
+
     /**
       Attempt to override the base directory that will be used by derived
       classes, and use this one instead.  Note that this is only a hint;
@@ -424,6 +507,12 @@ class OSystem
 
     virtual shared_ptr<KeyValueRepository> createSettingsRepository();
 
+    virtual shared_ptr<KeyValueRepository> createRomIndexRepository();
+
+    virtual shared_ptr<KeyValueRepository> createZipIndexRepository();
+
+    virtual shared_ptr<KeyValueRepository> createDetectionCacheRepository();
+
     /**
       Append a message to the internal log
       (a newline is automatically added).
@@ -483,6 +572,9 @@ class OSystem
     // Pointer to audio settings object
     unique_ptr<AudioSettings> myAudioSettings;
 
+    // The audio queue, shared with the (currently defined) Console object
+    shared_ptr<AudioQueue> myAudioQueue;
+
   #ifdef CHEATCODE_SUPPORT
     // Pointer to the CheatManager object
     unique_ptr<CheatManager> myCheatManager;
@@ -518,6 +610,24 @@ class OSystem
     // Pointer to the TimerManager object
     unique_ptr<TimerManager> myTimerManager;
 
+    // Pointer to the FrameRecorder object
+    unique_ptr<FrameRecorder> myFrameRecorder;
+
+    // Pointer to the FrameTelemetry object
+    unique_ptr<FrameTelemetry> myTelemetry;
+
+    // Publishes frames and audio to other processes (if enabled)
+    unique_ptr<FrameServer> myFrameServer;
+
+    // Streams frames and audio to remote players (if enabled)
+    unique_ptr<StreamServer> myStreamServer;
+
+    // Pointer to the RomIndex object
+    unique_ptr<RomIndex> myRomIndex;
+
+    // Pointer to the DetectionCache object
+    unique_ptr<DetectionCache> myDetectionCache;
+
     // The list of log messages
     string myLogMessages;
 
@@ -551,6 +661,38 @@ class OSystem
 
     FpsMeter myFpsMeter;
 
+    // Paces the main loop, and locks emulation speed to the display
+    FramePacer myFramePacer;
+
+    // Number of frames to emulate ahead of the real timeline (0 = disabled),
+    // the state used to return to it, and the frame shown from the future
+    uInt32 myRunAheadFrames;
+    unique_ptr<Serializer> myRunAheadState;
+    ByteArray myRunAheadFrame;
+
+    // A ROM read and autodetected in advance by prefetchROM(); the format is
+    // empty if the layout wasn't detected
+    struct PrefetchedROM {
+      ByteBuffer image;
+      uInt32 size;
+      string md5;
+      Bankswitch::Type type;
+      string format;
+      uInt32 ystart;
+    };
+    FilesystemNode myPrefetchedFile;
+    std::future<PrefetchedROM> myPrefetch;
+
+    // Turbo mode, and the number of emulated frames per rendered frame
+    bool myTurbo;
+    uInt32 myTurboSkip;
+
+    // The maximum number of frames not presented in a row when presenting is
+    // too slow (0 = disabled), and the average time (in seconds) it takes to
+    // render and present a frame
+    uInt32 myMaxFrameSkip;
+    double myPresentCost;
+
     // If not empty, a hint for derived classes to use this as the
     // base directory (where all settings are stored)
     // Derived classes are free to ignore it and use their own defaults
@@ -592,6 +734,28 @@ class OSystem
 
     double dispatchEmulation(EmulationWorker& emulationWorker);
 
+    /**
+      Render the frame the console will produce the given number of frames
+      from now, then return to the current state.  Audio is muted while
+      running ahead, so the sound stays on the real timeline.
+
+      @param frames  The number of frames to emulate ahead
+    */
+    void runAhead(uInt32 frames);
+
+    /**
+      The number of frames to skip before presenting the next one, based on
+      how long presenting took recently (0 if it keeps up with emulation).
+    */
+    uInt32 frameSkip() const;
+
+    /**
+      Put the frame layout and ystart detected by prefetchROM() into the
+      detection cache, if they apply to how the ROM is loaded.
+    */
+    void insertPrefetchedDetection(const FilesystemNode& rom,
+                                   const PrefetchedROM& prefetched);
+
     // Following constructors and assignment operators not supported
     OSystem(const OSystem&) = delete;
     OSystem(OSystem&&) = delete;
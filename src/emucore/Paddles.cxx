@@ -19,6 +19,7 @@
 
 #include "Event.hxx"
 #include "Paddles.hxx"
+#include "System.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Paddles::Paddles(Jack jack, const Event& event, const System& system,
@@ -187,11 +188,22 @@ Paddles::Paddles(Jack jack, const Event& event, const System& system,
 
   myCharge[0] = myCharge[1] = TRIGRANGE / 2;
   myLastCharge[0] = myLastCharge[1] = 0;
+
+  myMoveFrom[0] = myMoveFrom[1] = MIN_RESISTANCE;
+  myMoveStart = myMoveCycles = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Paddles::update()
 {
+  // The paddle moves from the current to the new position until the next
+  // update is due
+  const uInt64 cycles = mySystem.cycles();
+  myMoveFrom[0] = getPin(AnalogPin::Five);
+  myMoveFrom[1] = getPin(AnalogPin::Nine);
+  myMoveCycles = cycles >= myMoveStart ? cycles - myMoveStart : 0;
+  myMoveStart = cycles;
+
   setPin(DigitalPin::Three, true);
   setPin(DigitalPin::Four, true);
 
@@ -355,6 +367,63 @@ void Paddles::update()
   myLastCharge[0] = myCharge[0];
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 Paddles::read(AnalogPin pin)
+{
+  const Int32 current = getPin(pin);
+  const Int32 previous = myMoveFrom[pin == AnalogPin::Five ? 0 : 1];
+
+  if(myMoveCycles == 0 || previous == current ||
+     previous == Controller::MAX_RESISTANCE || current == Controller::MAX_RESISTANCE)
+    return current;
+
+  const uInt64 elapsed = std::min(mySystem.cycles() - myMoveStart, myMoveCycles);
+
+  return previous + Int32((current - Int64(previous)) * Int64(elapsed) / Int64(myMoveCycles));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Paddles::save(Serializer& out) const
+{
+  if(!Controller::save(out))
+    return false;
+
+  try
+  {
+    out.putInt(myMoveFrom[0]);
+    out.putInt(myMoveFrom[1]);
+    out.putLong(myMoveStart);
+    out.putLong(myMoveCycles);
+  }
+  catch(...)
+  {
+    cerr << "ERROR: Paddles::save() exception\n";
+    return false;
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Paddles::load(Serializer& in)
+{
+  if(!Controller::load(in))
+    return false;
+
+  try
+  {
+    myMoveFrom[0] = in.getInt();
+    myMoveFrom[1] = in.getInt();
+    myMoveStart = in.getLong();
+    myMoveCycles = in.getLong();
+  }
+  catch(...)
+  {
+    cerr << "ERROR: Paddles::load() exception\n";
+    return false;
+  }
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Paddles::setMouseControl(
     Controller::Type xtype, int xid, Controller::Type ytype, int yid)
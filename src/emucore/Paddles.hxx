@@ -60,6 +60,34 @@ class Paddles : public Controller
     */
     void update() override;
 
+    /**
+      Read the resistance at the specified analog pin.  After each update,
+      the paddle moves from the previous to the newly read position, over
+      as many cycles as the last two updates were apart, so that the TIA
+      sees it move smoothly (at the granularity of INPTx reads) rather than
+      jump once per frame.  It never goes beyond the positions read.
+
+      @param pin The pin of the controller jack to read
+      @return The resistance at the specified pin
+    */
+    Int32 read(AnalogPin pin) override;
+
+    /**
+      Saves the current state of this controller to the given Serializer.
+
+      @param out The serializer device to save to.
+      @return The result of the save.  True on success, false on failure.
+    */
+    bool save(Serializer& out) const override;
+
+    /**
+      Loads the current state of this controller from the given Serializer.
+
+      @param in The serializer device to load from.
+      @return The result of the load.  True on success, false on failure.
+    */
+    bool load(Serializer& in) override;
+
     /**
       Returns the name of this controller.
     */
@@ -151,6 +179,11 @@ class Paddles : public Controller
     int myLastAxisX, myLastAxisY;
     int myAxisDigitalZero, myAxisDigitalOne;
 
+    // The resistance of each analog pin at the update before the last one
+    // (see read()), and the system cycles between the last two updates
+    Int32 myMoveFrom[2];
+    uInt64 myMoveStart, myMoveCycles;
+
     // Range of values over which digital and mouse movement is scaled
     // to paddle resistance
     static constexpr int TRIGMIN = 1;
@@ -15,8 +15,17 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <thread>
+
+#if defined(BSPF_UNIX) || defined(BSPF_MACOS)
+  #include <sys/resource.h>
+#endif
 
 #include "ProfilingRunner.hxx"
 #include "FSNode.hxx"
@@ -37,11 +46,18 @@
 #include "Joystick.hxx"
 #include "Random.hxx"
 #include "DispatchResult.hxx"
+#include "AudioQueue.hxx"
+#include "WavFileSink.hxx"
+#include "Serializer.hxx"
 
 using namespace std::chrono;
 
 namespace {
   static constexpr uInt32 RUNTIME_DEFAULT = 60;
+  static constexpr double TOLERANCE_DEFAULT = 5;
+
+  // How often the emulated zone is sampled
+  static constexpr microseconds SAMPLE_INTERVAL(250);
 
   void updateProgress(uInt32 from, uInt32 to) {
     while (from < to) {
@@ -53,43 +69,164 @@ namespace {
       from++;
     }
   }
+
+  double secondsSince(const time_point<high_resolution_clock>& tp) {
+    return duration_cast<duration<double>>(high_resolution_clock::now() - tp).count();
+  }
+
+  // Peak resident set size of the process in bytes (0 if unknown)
+  uInt64 peakRSS() {
+  #if defined(BSPF_UNIX) || defined(BSPF_MACOS)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+
+    #ifdef __APPLE__
+      return uInt64(usage.ru_maxrss);
+    #else
+      return uInt64(usage.ru_maxrss) * 1024;
+    #endif
+  #else
+    return 0;
+  #endif
+  }
+
+  string jsonEscape(const string& s) {
+    string result;
+    for (char c : s) {
+      if (c == '"' || c == '\\') result += '\\';
+      result += c;
+    }
+    return result;
+  }
+
+  /**
+    Samples the zone the emulation is in from a separate thread, so the
+    time spent emulating can be split between 6507, TIA and ARM without
+    timing every single TIA access.
+  */
+  class ZoneSampler {
+    public:
+      explicit ZoneSampler(const System& system)
+        : mySystem(system), myStop(false), myCounts()
+      {
+        myThread = std::thread([this] () {
+          while (!myStop) {
+            std::this_thread::sleep_for(SAMPLE_INTERVAL);
+            ++myCounts[uInt8(mySystem.zone())];
+          }
+        });
+      }
+
+      ~ZoneSampler() { stop(); }
+
+      void stop() {
+        myStop = true;
+        if (myThread.joinable()) myThread.join();
+      }
+
+      // Share of the samples taken during emulation (i.e. not in zone none)
+      double share(System::Zone zone) const {
+        uInt64 total = 0;
+        for (uInt8 i = uInt8(System::Zone::cpu); i < uInt8(System::Zone::numZones); ++i)
+          total += myCounts[i];
+
+        if (total == 0) return zone == System::Zone::cpu ? 1 : 0;
+
+        return double(myCounts[uInt8(zone)]) / total;
+      }
+
+    private:
+      const System& mySystem;
+      std::atomic<bool> myStop;
+      uInt64 myCounts[uInt8(System::Zone::numZones)];
+      std::thread myThread;
+  };
 }
 
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 ProfilingRunner::ProfilingRunner(int argc, char* argv[])
-  : profilingRuns(std::max(argc - 2, 0))
+  : myWarmup(0),
+    myRepeat(1),
+    myTolerance(TOLERANCE_DEFAULT)
 {
-  for (int i = 2; i < argc; i++) {
-    ProfilingRun& run(profilingRuns[i-2]);
+  int firstRun = 2;
 
-    string arg = argv[i];
-    size_t splitPoint = arg.find_first_of(":");
+  if (argc > 1 && string(argv[1]) == "-renderaudio") {
+    if (argc > 2) myAudioFile = argv[2];
 
-    run.romFile = splitPoint == string::npos ? arg : arg.substr(0, splitPoint);
+    // Only one ROM can be rendered to the file
+    firstRun = 3;
+    argc = std::min(argc, 4);
+  }
 
-    if (splitPoint == string::npos) run.runtime = RUNTIME_DEFAULT;
-    else  {
-      int runtime = atoi(arg.substr(splitPoint+1, string::npos).c_str());
-      run.runtime = runtime > 0 ? runtime : RUNTIME_DEFAULT;
+  for (int i = firstRun; i < argc; i++) {
+    string arg = argv[i];
+
+    if (arg == "-warmup" && i + 1 < argc)
+      myWarmup = std::max(atof(argv[++i]), 0.0);
+    else if (arg == "-repeat" && i + 1 < argc)
+      myRepeat = std::max(atoi(argv[++i]), 1);
+    else if (arg == "-json" && i + 1 < argc)
+      myJsonFile = argv[++i];
+    else if (arg == "-baseline" && i + 1 < argc)
+      myBaselineFile = argv[++i];
+    else if (arg == "-tolerance" && i + 1 < argc)
+      myTolerance = std::max(atof(argv[++i]), 0.0);
+    else {
+      ProfilingRun run;
+      size_t splitPoint = arg.find_first_of(":");
+
+      run.romFile = splitPoint == string::npos ? arg : arg.substr(0, splitPoint);
+
+      if (splitPoint == string::npos) run.runtime = RUNTIME_DEFAULT;
+      else  {
+        int runtime = atoi(arg.substr(splitPoint+1, string::npos).c_str());
+        run.runtime = runtime > 0 ? runtime : RUNTIME_DEFAULT;
+      }
+
+      profilingRuns.push_back(run);
     }
   }
 
+  // The audio is rendered exactly once
+  if (!myAudioFile.empty()) {
+    myWarmup = 0;
+    myRepeat = 1;
+  }
+
   mySettings.setValue("fastscbios", true);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool ProfilingRunner::run()
 {
-  cout << "Profiling Stella..." << endl;
+  if (!myAudioFile.empty()) {
+  #ifdef SOUND_SUPPORT
+    if (profilingRuns.empty()) {
+      cout << "ERROR: no ROM to render audio from" << endl;
+      return false;
+    }
+    cout << "Rendering audio to " << myAudioFile << "..." << endl;
+  #else
+    cout << "ERROR: rendering audio requires sound support" << endl;
+    return false;
+  #endif
+  }
+  else
+    cout << "Profiling Stella..." << endl;
 
   for (ProfilingRun& run : profilingRuns) {
-    cout << endl << "running " << run.romFile << " for " << run.runtime << " seconds..." << endl;
+    cout << endl << "running " << run.romFile << " for " << run.runtime << " seconds";
+    if (myRepeat > 1) cout << ", " << myRepeat << " times";
+    cout << "..." << endl;
 
     if (!runOne(run)) return false;
   }
 
-  return true;
+  if (!myJsonFile.empty() && !writeJson()) return false;
+
+  return myBaselineFile.empty() || compareToBaseline();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -140,7 +277,7 @@ bool ProfilingRunner::runOne(const ProfilingRun run)
   system.reset();
 
   (cout << "detecting frame layout... ").flush();
-  for(int i = 0; i < 60; ++i) tia.update();
+  for(int i = 0; i < 60 && !frameLayoutDetector.isConfident(); ++i) tia.update();
 
   FrameLayout frameLayout = frameLayoutDetector.detectedLayout();
   ConsoleTiming consoleTiming = ConsoleTiming::ntsc;
@@ -164,7 +301,7 @@ bool ProfilingRunner::runOne(const ProfilingRun run)
   system.reset();
 
   (cout << "detecting ystart... ").flush();
-  for (int i = 0; i < 80; i++) tia.update();
+  for (int i = 0; i < 80 && !ystartDetector.isConfident(); i++) tia.update();
 
   uInt32 yStart = ystartDetector.detectedYStart();
   (cout << yStart << endl).flush();
@@ -177,38 +314,250 @@ bool ProfilingRunner::runOne(const ProfilingRun run)
   system.reset();
 
   EmulationTiming emulationTiming(frameLayout, consoleTiming);
-  uInt64 cycles = 0;
-  uInt64 cyclesTarget = run.runtime * emulationTiming.cyclesPerSecond();
+
+  // Audio is generated as during normal emulation, and drained after
+  // every timeslice; if requested, it is written to a file, without
+  // pacing the emulation
+  shared_ptr<AudioQueue> audioQueue = make_shared<AudioQueue>(
+    emulationTiming.audioFragmentSize(), emulationTiming.audioQueueCapacity(), false
+  );
+  tia.setAudioQueue(audioQueue);
+
+  WavFileSink wavSink;
+  Int16* currentFragment = nullptr;
+
+  if (!myAudioFile.empty() &&
+      !wavSink.open(myAudioFile, emulationTiming.audioSampleRate(), false)) {
+    cout << "ERROR: unable to create " << myAudioFile << endl;
+    return false;
+  }
 
   DispatchResult dispatchResult;
   dispatchResult.setOk(0);
 
-  uInt32 percent = 0;
-  (cout << "0%").flush();
+  double emulationTime = 0, audioTime = 0;
+
+  // Run for the given number of cycles; answers false on errors
+  auto emulate = [&] (uInt64 cyclesTarget, bool showProgress) {
+    uInt64 cycles = 0;
+    uInt32 percent = 0;
+
+    if (showProgress) (cout << "0%").flush();
+
+    while (cycles < cyclesTarget && dispatchResult.getStatus() == DispatchResult::Status::ok) {
+      time_point<high_resolution_clock> tp = high_resolution_clock::now();
+
+      tia.update(dispatchResult);
+      cycles += dispatchResult.getCycles();
+
+      emulationTime += secondsSince(tp);
+
+      if (tia.newFramePending()) tia.renderToFrameBuffer();
+
+      tp = high_resolution_clock::now();
+
+      if (!myAudioFile.empty()) {
+        if (!wavSink.drain(*audioQueue)) {
+          cout << endl << "ERROR: unable to write " << myAudioFile << endl;
+          return false;
+        }
+      }
+      else
+        while (Int16* fragment = audioQueue->dequeue(currentFragment))
+          currentFragment = fragment;
+
+      audioTime += secondsSince(tp);
+
+      if (showProgress) {
+        uInt32 percentNow = uInt32(std::min((100 * cycles) / cyclesTarget, static_cast<uInt64>(100)));
+        updateProgress(percent, percentNow);
+
+        percent = percentNow;
+      }
+    }
+
+    if (dispatchResult.getStatus() != DispatchResult::Status::ok) {
+      cout << endl << "ERROR: emulation failed after " << cycles << " cycles" << endl;
+      return false;
+    }
+
+    if (showProgress) (cout << "100%" << endl).flush();
+
+    return true;
+  };
+
+  if (myWarmup > 0) {
+    (cout << "warming up for " << myWarmup << " seconds..." << endl).flush();
+    if (!emulate(uInt64(myWarmup * emulationTiming.cyclesPerSecond()), false)) return false;
+  }
+
+  // All repeated runs start from the same state
+  Serializer snapshot;
+  if (myRepeat > 1 && !system.save(snapshot)) {
+    cout << "ERROR: unable to save state" << endl;
+    return false;
+  }
+
+  vector<Report> reports;
+
+  for (uInt32 i = 0; i < myRepeat; ++i) {
+    if (i > 0) {
+      snapshot.rewind();
+      if (!system.load(snapshot)) {
+        cout << "ERROR: unable to load state" << endl;
+        return false;
+      }
+    }
+
+    Report report;
+    report.romFile = run.romFile;
+    report.md5 = md5;
+    report.runtime = run.runtime;
+
+    uInt64 cycles = system.cycles();
+    uInt32 frames = tia.frameCount();
+    uInt64 instructions = cpu.instructions();
+    emulationTime = audioTime = 0;
+
+    ZoneSampler sampler(system);
+    time_point<high_resolution_clock> tp = high_resolution_clock::now();
+
+    if (!emulate(uInt64(run.runtime) * emulationTiming.cyclesPerSecond(), true)) return false;
+
+    report.realtime = secondsSince(tp);
+    sampler.stop();
 
-  time_point<high_resolution_clock> tp = high_resolution_clock::now();
+    report.cycles = system.cycles() - cycles;
+    report.frames = tia.frameCount() - frames;
+    report.instructions = cpu.instructions() - instructions;
+    report.cpuTime = emulationTime * sampler.share(System::Zone::cpu);
+    report.tiaTime = emulationTime * sampler.share(System::Zone::tia);
+    report.armTime = emulationTime * sampler.share(System::Zone::arm);
+    report.audioTime = audioTime;
+    report.otherTime = std::max(report.realtime - emulationTime - audioTime, 0.0);
 
-  while (cycles < cyclesTarget && dispatchResult.getStatus() == DispatchResult::Status::ok) {
-    tia.update(dispatchResult);
-    cycles += dispatchResult.getCycles();
+    reports.push_back(report);
+  }
+
+  // Report the median run
+  std::sort(reports.begin(), reports.end(), [] (const Report& a, const Report& b) {
+    return a.realtime < b.realtime;
+  });
+
+  Report report = reports[reports.size() / 2];
+  report.minCyclesPerSecond = reports.back().cyclesPerSecond();
+  report.maxCyclesPerSecond = reports.front().cyclesPerSecond();
+  report.peakRSS = peakRSS();
+
+  cout << "real time: " << report.realtime << " seconds" << endl
+       << "emulation: " << uInt64(report.cyclesPerSecond()) << " cycles/s, "
+       << (report.frames / report.realtime) << " frames/s, "
+       << report.instructions << " instructions" << endl
+       << "time split: cpu " << report.cpuTime << "s, tia " << report.tiaTime
+       << "s, arm " << report.armTime << "s, audio " << report.audioTime
+       << "s, other " << report.otherTime << "s" << endl;
+  if (report.peakRSS > 0)
+    cout << "peak RSS: " << (report.peakRSS >> 10) << " kB" << endl;
+
+  if (!myAudioFile.empty()) {
+    wavSink.close(audioQueue.get());
+    cout << "audio: " << wavSink.samples() << " samples at "
+         << emulationTiming.audioSampleRate() << " Hz" << endl;
+  }
 
-    if (tia.newFramePending()) tia.renderToFrameBuffer();
+  myReports.push_back(report);
 
-    uInt32 percentNow = uInt32(std::min((100 * cycles) / cyclesTarget, static_cast<uInt64>(100)));
-    updateProgress(percent, percentNow);
+  return true;
+}
 
-    percent = percentNow;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ProfilingRunner::writeJson() const
+{
+  std::ofstream out(myJsonFile);
+
+  // One value per line, so compareToBaseline() can read the report back
+  out << std::setprecision(10) << "{" << endl
+      << "  \"version\": 1," << endl
+      << "  \"warmup\": " << myWarmup << "," << endl
+      << "  \"repeat\": " << myRepeat << "," << endl
+      << "  \"runs\": [" << endl;
+
+  for (size_t i = 0; i < myReports.size(); ++i) {
+    const Report& r = myReports[i];
+
+    out << "    {" << endl
+        << "      \"rom\": \"" << jsonEscape(r.romFile) << "\"," << endl
+        << "      \"md5\": \"" << r.md5 << "\"," << endl
+        << "      \"runtime\": " << r.runtime << "," << endl
+        << "      \"cycles\": " << r.cycles << "," << endl
+        << "      \"frames\": " << r.frames << "," << endl
+        << "      \"instructions\": " << r.instructions << "," << endl
+        << "      \"realTime\": " << r.realtime << "," << endl
+        << "      \"cyclesPerSecond\": " << r.cyclesPerSecond() << "," << endl
+        << "      \"minCyclesPerSecond\": " << r.minCyclesPerSecond << "," << endl
+        << "      \"maxCyclesPerSecond\": " << r.maxCyclesPerSecond << "," << endl
+        << "      \"framesPerSecond\": " << (r.frames / r.realtime) << "," << endl
+        << "      \"time\": { \"cpu\": " << r.cpuTime << ", \"tia\": " << r.tiaTime
+        << ", \"arm\": " << r.armTime << ", \"audio\": " << r.audioTime
+        << ", \"other\": " << r.otherTime << " }," << endl
+        << "      \"peakRSS\": " << r.peakRSS << endl
+        << "    }" << (i + 1 < myReports.size() ? "," : "") << endl;
   }
 
-  double realtimeUsed = duration_cast<duration<double>>(high_resolution_clock::now () - tp).count();
+  out << "  ]" << endl << "}" << endl;
 
-  if (dispatchResult.getStatus() != DispatchResult::Status::ok) {
-    cout << endl << "ERROR: emulation failed after " << cycles << " cycles";
+  if (!out) {
+    cout << "ERROR: unable to write " << myJsonFile << endl;
     return false;
   }
 
-  (cout << "100%" << endl).flush();
-  cout << "real time: " << realtimeUsed << " seconds" << endl;
+  cout << endl << "report written to " << myJsonFile << endl;
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ProfilingRunner::compareToBaseline() const
+{
+  std::ifstream in(myBaselineFile);
+  if (!in) {
+    cout << "ERROR: unable to read baseline " << myBaselineFile << endl;
+    return false;
+  }
+
+  // Reads back what writeJson() wrote: ROMs are identified by MD5
+  std::map<string, double> baseline;
+  string line, md5;
+  while (std::getline(in, line)) {
+    size_t pos;
+
+    if ((pos = line.find("\"md5\": \"")) != string::npos)
+      md5 = line.substr(pos + 8, 32);
+    else if ((pos = line.find("\"cyclesPerSecond\": ")) != string::npos && !md5.empty())
+      baseline[md5] = atof(line.c_str() + pos + 19);
+  }
+
+  bool ok = true;
+
+  cout << endl << "comparing to " << myBaselineFile << " (tolerance "
+       << myTolerance << "%)" << endl;
+
+  for (const Report& r : myReports) {
+    auto it = baseline.find(r.md5);
+    if (it == baseline.end() || it->second <= 0) {
+      cout << r.romFile << ": not in baseline" << endl;
+      continue;
+    }
+
+    double change = 100 * (r.cyclesPerSecond() / it->second - 1);
+    bool regressed = change < -myTolerance;
+
+    cout << r.romFile << ": " << uInt64(it->second) << " -> " << uInt64(r.cyclesPerSecond())
+         << " cycles/s (" << (change >= 0 ? "+" : "") << std::fixed << std::setprecision(1)
+         << change << "%)" << std::defaultfloat << (regressed ? "  REGRESSION" : "") << endl;
+
+    ok = ok && !regressed;
+  }
+
+  return ok;
+}
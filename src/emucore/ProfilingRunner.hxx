@@ -29,6 +29,19 @@ class Switches;
 class ProfilingRunner {
   public:
 
+    /**
+      Parse the command line: either '-profile [options] <rom>[:seconds] ...',
+      or '-renderaudio <wav file> <rom>[:seconds]' to render the audio of a
+      ROM to a file as fast as possible.  The options are
+
+        -warmup <seconds>    Emulate this long before measuring
+        -repeat <n>          Measure n times (from the same state) and
+                             report the median run
+        -json <file>         Write a report to the file
+        -baseline <file>     Compare against a report written before, and
+                             fail if a ROM got slower than the tolerance
+        -tolerance <percent> Tolerance for the comparison (default 5)
+    */
     ProfilingRunner(int argc, char* argv[]);
 
     bool run();
@@ -50,14 +63,55 @@ class ProfilingRunner {
         unique_ptr<Switches> mySwitches;
     };
 
+    // The measurements of a single run (or the median of several runs)
+    struct Report {
+      string romFile;
+      string md5;
+      uInt32 runtime;
+      uInt64 cycles;
+      uInt32 frames;
+      uInt64 instructions;
+      double realtime;
+      double minCyclesPerSecond;
+      double maxCyclesPerSecond;
+
+      // The time spent in the 6507, TIA, ARM and audio, and outside of
+      // the emulation
+      double cpuTime, tiaTime, armTime, audioTime, otherTime;
+
+      uInt64 peakRSS;
+
+      double cyclesPerSecond() const { return cycles / realtime; }
+    };
+
   private:
 
     bool runOne(const ProfilingRun run);
 
+    bool writeJson() const;
+
+    bool compareToBaseline() const;
+
   private:
 
     vector<ProfilingRun> profilingRuns;
 
+    // If not empty, the audio is written to this file
+    string myAudioFile;
+
+    // Emulated time before measuring, and number of measured runs
+    double myWarmup;
+    uInt32 myRepeat;
+
+    // If not empty, a report is written to this file
+    string myJsonFile;
+
+    // If not empty, the results are compared against this report
+    string myBaselineFile;
+    double myTolerance;
+
+    vector<Report> myReports;
+
     Settings mySettings;
 
     Properties myProps;
@@ -15,7 +15,9 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <mutex>
 #include <sstream>
+#include <unordered_set>
 
 #include "bspf.hxx"
 #include "Props.hxx"
@@ -38,13 +40,14 @@ void Properties::set(PropType key, const string& value)
   uInt8 pos = static_cast<uInt8>(key);
   if(pos < static_cast<uInt8>(PropType::NumTypes))
   {
-    myProperties[pos] = value;
-    if(BSPF::equalsIgnoreCase(myProperties[pos], "AUTO-DETECT"))
-      myProperties[pos] = "AUTO";
+    string property = value;
+    if(BSPF::equalsIgnoreCase(property, "AUTO-DETECT"))
+      property = "AUTO";
 
     switch(key)
     {
       case PropType::Cart_Sound:
+      case PropType::Cart_ThumbFast:
       case PropType::Cart_Type:
       case PropType::Console_LeftDiff:
       case PropType::Console_RightDiff:
@@ -57,21 +60,22 @@ void Properties::set(PropType key, const string& value)
       case PropType::Display_Format:
       case PropType::Display_Phosphor:
       {
-        BSPF::toUpperCase(myProperties[pos]);
+        BSPF::toUpperCase(property);
         break;
       }
 
       case PropType::Display_PPBlend:
       {
-        int blend = atoi(myProperties[pos].c_str());
+        int blend = atoi(property.c_str());
         if(blend < 0 || blend > 100)
-          myProperties[pos] = ourDefaultProperties[pos];
+          property = *ourDefaultProperties[pos];
         break;
       }
 
       default:
         break;
     }
+    myProperties[pos] = intern(property);
   }
 }
 
@@ -122,7 +126,7 @@ ostream& operator<<(ostream& os, const Properties& p)
     {
       p.writeQuotedString(os, Properties::ourPropertyNames[i]);
       os.put(' ');
-      p.writeQuotedString(os, p.myProperties[i]);
+      p.writeQuotedString(os, *p.myProperties[i]);
       os.put('\n');
       changed = true;
     }
@@ -221,7 +225,7 @@ Properties& Properties::operator=(const Properties& properties)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Properties::setDefault(PropType key, const string& value)
 {
-  ourDefaultProperties[static_cast<uInt8>(key)] = value;
+  ourDefaultProperties[static_cast<uInt8>(key)] = intern(value);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -243,6 +247,7 @@ void Properties::print() const
        << get(PropType::Cart_Rarity)            << "|"
        << get(PropType::Cart_Sound)             << "|"
        << get(PropType::Cart_StartBank)         << "|"
+       << get(PropType::Cart_ThumbFast)         << "|"
        << get(PropType::Cart_Type)              << "|"
        << get(PropType::Console_LeftDiff)       << "|"
        << get(PropType::Console_RightDiff)      << "|"
@@ -277,6 +282,18 @@ PropType Properties::getPropType(const string& name)
   return PropType::NumTypes;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const string* Properties::intern(const string& value)
+{
+  // The elements of an unordered_set don't move when it grows, and are
+  // never erased
+  static std::mutex mutex;
+  static std::unordered_set<string> pool;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  return &*pool.insert(value).first;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Properties::printHeader()
 {
@@ -288,6 +305,7 @@ void Properties::printHeader()
        << "Cart_Rarity|"
        << "Cart_Sound|"
        << "Cart_StartBank|"
+       << "Cart_ThumbFast|"
        << "Cart_Type|"
        << "Console_LeftDiff|"
        << "Console_RightDiff|"
@@ -305,29 +323,30 @@ void Properties::printHeader()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-string Properties::ourDefaultProperties[static_cast<uInt8>(PropType::NumTypes)] =
+const string* Properties::ourDefaultProperties[static_cast<uInt8>(PropType::NumTypes)] =
 {
-  "",       // Cart.MD5
-  "",       // Cart.Manufacturer
-  "",       // Cart.ModelNo
-  "",       // Cart.Name
-  "",       // Cart.Note
-  "",       // Cart.Rarity
-  "MONO",   // Cart.Sound
-  "",       // Cart.StartBank
-  "AUTO",   // Cart.Type
-  "B",      // Console.LeftDiff
-  "B",      // Console.RightDiff
-  "COLOR",  // Console.TVType
-  "NO",     // Console.SwapPorts
-  "AUTO",   // Controller.Left
-  "AUTO",   // Controller.Right
-  "NO",     // Controller.SwapPaddles
-  "AUTO",   // Controller.MouseAxis
-  "AUTO",   // Display.Format
-  "0",      // Display.YStart
-  "NO",     // Display.Phosphor
-  "0"       // Display.PPBlend
+  intern(""),       // Cart.MD5
+  intern(""),       // Cart.Manufacturer
+  intern(""),       // Cart.ModelNo
+  intern(""),       // Cart.Name
+  intern(""),       // Cart.Note
+  intern(""),       // Cart.Rarity
+  intern("MONO"),   // Cart.Sound
+  intern(""),       // Cart.StartBank
+  intern("NO"),     // Cart.ThumbFast
+  intern("AUTO"),   // Cart.Type
+  intern("B"),      // Console.LeftDiff
+  intern("B"),      // Console.RightDiff
+  intern("COLOR"),  // Console.TVType
+  intern("NO"),     // Console.SwapPorts
+  intern("AUTO"),   // Controller.Left
+  intern("AUTO"),   // Controller.Right
+  intern("NO"),     // Controller.SwapPaddles
+  intern("AUTO"),   // Controller.MouseAxis
+  intern("AUTO"),   // Display.Format
+  intern("0"),      // Display.YStart
+  intern("NO"),     // Display.Phosphor
+  intern("0")       // Display.PPBlend
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -341,6 +360,7 @@ const char* const Properties::ourPropertyNames[static_cast<uInt8>(PropType::NumT
   "Cart.Rarity",
   "Cart.Sound",
   "Cart.StartBank",
+  "Cart.ThumbFast",
   "Cart.Type",
   "Console.LeftDiff",
   "Console.RightDiff",
@@ -29,6 +29,7 @@ enum class PropType : uInt8 {
   Cart_Rarity,
   Cart_Sound,
   Cart_StartBank,
+  Cart_ThumbFast,
   Cart_Type,
   Console_LeftDiff,
   Console_RightDiff,
@@ -53,6 +54,11 @@ enum class PropType : uInt8 {
   object as its "defaults"; this second properties object is searched
   if the property key is not found in the original property list.
 
+  The values are interned: each distinct value is stored once in a pool
+  shared by all properties objects, which only hold pointers to them.
+  Most values repeat across the ROMs ("AUTO", "NO", empty ...), so a
+  properties object is small and cheap to copy.
+
   @author  Bradford W. Mott
 */
 class Properties
@@ -83,7 +89,7 @@ class Properties
     */
     const string& get(PropType key) const {
       uInt8 pos = static_cast<uInt8>(key);
-      return pos < static_cast<uInt8>(PropType::NumTypes) ? myProperties[pos] : EmptyString;
+      return pos < static_cast<uInt8>(PropType::NumTypes) ? *myProperties[pos] : EmptyString;
     }
 
     /**
@@ -180,6 +186,14 @@ class Properties
     */
     static PropType getPropType(const string& name);
 
+    /**
+      Get the pooled copy of the given value, adding it to the pool if
+      necessary.  The copy lives as long as the program.
+
+      @param value  The value to look up
+    */
+    static const string* intern(const string& value);
+
     /**
       When printing each collection of ROM properties, it is useful to
       see which columns correspond to the output fields; this method
@@ -188,11 +202,11 @@ class Properties
     static void printHeader();
 
   private:
-    // The array of properties
-    string myProperties[static_cast<uInt8>(PropType::NumTypes)];
+    // The array of properties (interned)
+    const string* myProperties[static_cast<uInt8>(PropType::NumTypes)];
 
     // List of default properties to use when none have been provided
-    static string ourDefaultProperties[static_cast<uInt8>(PropType::NumTypes)];
+    static const string* ourDefaultProperties[static_cast<uInt8>(PropType::NumTypes)];
 
     // The text strings associated with each property type
     static const char* const ourPropertyNames[static_cast<uInt8>(PropType::NumTypes)];
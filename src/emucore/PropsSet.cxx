@@ -88,35 +88,57 @@ bool PropertiesSet::getMD5(const string& md5, Properties& properties,
     }
   }
 
-  // Otherwise, search the internal database using binary search
+  // Otherwise, search the internal database
   if(!found)
   {
-    int low = 0, high = DEF_PROPS_SIZE - 1;
-    while(low <= high)
+    const int i = builtinIndex(md5);
+    if(i >= 0)
     {
-      int i = (low + high) / 2;
-      int cmp = BSPF::compareIgnoreCase(md5,
-          DefProps[i][static_cast<uInt8>(PropType::Cart_MD5)]);
+      for(uInt8 p = 0; p < static_cast<uInt8>(PropType::NumTypes); ++p)
+        if(DefProps[i][p][0] != 0)
+          properties.set(PropType(p), DefProps[i][p]);
 
-      if(cmp == 0)  // found it
-      {
-        for(uInt8 p = 0; p < static_cast<uInt8>(PropType::NumTypes); ++p)
-          if(DefProps[i][p][0] != 0)
-            properties.set(PropType(p), DefProps[i][p]);
-
-        found = true;
-        break;
-      }
-      else if(cmp < 0)
-        high = i - 1; // look at lower range
-      else
-        low = i + 1;  // look at upper range
+      found = true;
     }
   }
 
   return found;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int PropertiesSet::builtinIndex(const string& md5)
+{
+  if(md5.length() != 32)
+    return -1;
+
+  // Convert the md5sum into four 32-bit words
+  uInt32 words[4] = { 0 };
+  for(uInt32 i = 0; i < 32; ++i)
+  {
+    const char c = md5[i];
+    uInt32 nibble;
+    if(c >= '0' && c <= '9')       nibble = c - '0';
+    else if(c >= 'a' && c <= 'f')  nibble = c - 'a' + 10;
+    else if(c >= 'A' && c <= 'F')  nibble = c - 'A' + 10;
+    else                           return -1;
+
+    words[i / 8] = (words[i / 8] << 4) | nibble;
+  }
+
+  // Look up the only slot the md5sum can be in (see create_props.pl)
+  const uInt64 displacement =
+      DefPropsBuckets[words[0] % DEF_PROPS_HASH_BUCKETS];
+  const uInt16 idx = DefPropsSlots[(words[1] + displacement * (words[2] | 1))
+                                   % DEF_PROPS_HASH_SLOTS];
+
+  if(idx != 0xffff && DefPropsKeys[idx][0] == words[0] &&
+     DefPropsKeys[idx][1] == words[1] && DefPropsKeys[idx][2] == words[2] &&
+     DefPropsKeys[idx][3] == words[3])
+    return idx;
+
+  return -1;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void PropertiesSet::getMD5WithInsert(const FilesystemNode& rom,
                                      const string& md5, Properties& properties)
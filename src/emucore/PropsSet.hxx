@@ -106,6 +106,14 @@ class PropertiesSet
     */
     void print() const;
 
+  private:
+    /**
+      Get the index of the given md5sum in the built-in properties.
+
+      @return  The index, or -1 if the md5sum isn't built-in
+    */
+    static int builtinIndex(const string& md5);
+
   private:
     using PropsList = std::map<string, Properties>;
 
@@ -0,0 +1,150 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <chrono>
+
+#include "FSNode.hxx"
+#include "HeadlessConsole.hxx"
+#include "InputMovie.hxx"
+#include "MD5.hxx"
+#include "Serializer.hxx"
+#include "Settings.hxx"
+#include "ReplayRunner.hxx"
+
+using namespace std::chrono;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ReplayRunner::ReplayRunner(int argc, char* argv[])
+  : myRepeat(1)
+{
+  if(argc > 2) myMovieFile = argv[2];
+  if(argc > 3) myRomFile = argv[3];
+  if(argc > 4) myRepeat = uInt32(std::max(atoi(argv[4]), 1));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ReplayRunner::run()
+{
+  if(myMovieFile.empty() || myRomFile.empty())
+  {
+    cout << "usage: stella -replay <movie> <rom> [repeat]" << endl;
+    return false;
+  }
+
+  InputMovie movie;
+  if(!movie.load(myMovieFile))
+  {
+    cout << "ERROR: unable to load movie '" << myMovieFile << "'" << endl;
+    return false;
+  }
+  const Properties& props = movie.properties();
+
+  FilesystemNode node(myRomFile);
+  ByteBuffer image;
+  const uInt32 size = node.isFile() ? uInt32(node.read(image)) : 0;
+  if(size == 0)
+  {
+    cout << "ERROR: unable to read ROM '" << myRomFile << "'" << endl;
+    return false;
+  }
+  if(MD5::hash(image, size) != props.get(PropType::Cart_MD5))
+  {
+    cout << "ERROR: the movie was recorded with a different ROM" << endl;
+    return false;
+  }
+
+  for(PropType type: { PropType::Controller_Left, PropType::Controller_Right })
+  {
+    switch(Controller::getType(props.get(type)))
+    {
+      case Controller::Type::Joystick:
+      case Controller::Type::Paddles:
+      case Controller::Type::PaddlesIAxis:
+      case Controller::Type::PaddlesIAxDr:
+        break;
+
+      default:
+        cout << "ERROR: controller '" << props.get(type)
+             << "' is not supported headless" << endl;
+        return false;
+    }
+  }
+
+  try
+  {
+    // The default settings are used, as in all headless runs
+    Settings settings;
+    HeadlessConsole console(image, size, settings, props);
+    vector<HeadlessConsole::Input> inputs;
+    double fastest = 0;
+
+    for(uInt32 run = 0; run < myRepeat; ++run)
+    {
+      Serializer state(static_cast<const void*>(movie.state().data()),
+                       movie.state().size());
+      if(!console.load(state))
+      {
+        cout << "ERROR: invalid state in movie" << endl;
+        return false;
+      }
+      movie.startPlayback();
+
+      time_point<high_resolution_clock> start = high_resolution_clock::now();
+
+      while(movie.playFrame())
+      {
+        inputs.clear();
+        for(Int32 i = 0; i < Event::LastType; ++i)
+        {
+          const Event::Type type = Event::Type(i);
+          if(InputMovie::isRecorded(type) && movie.value(type) != 0)
+            inputs.push_back({ type, movie.value(type) });
+        }
+
+        if(!console.step(inputs.data(), uInt32(inputs.size())))
+        {
+          cout << "ERROR: emulation failed in frame " << movie.framesPlayed()
+               << endl;
+          return false;
+        }
+      }
+
+      const double seconds =
+        duration_cast<duration<double>>(high_resolution_clock::now() - start).count();
+      if(run == 0 || seconds < fastest)
+        fastest = seconds;
+    }
+
+    const double realtime = movie.frames() /
+      (console.timing() == ConsoleTiming::ntsc ? 60.0 : 50.0);
+
+    cout << props.get(PropType::Cart_Name) << ": " << movie.frames()
+         << " frames (" << movie.inputSize() << " bytes of input)" << endl
+         << "  frame " << MD5::hash(console.frame(),
+                                    console.frameWidth() * console.frameHeight())
+         << ", RAM " << MD5::hash(console.ram(), 128) << endl
+         << "  " << fastest << " seconds (fastest of " << myRepeat << "), "
+         << (fastest > 0 ? realtime / fastest : 0) << "x real time" << endl;
+  }
+  catch(const runtime_error& e)
+  {
+    cout << "ERROR: " << e.what() << endl;
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,59 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef REPLAY_RUNNER_HXX
+#define REPLAY_RUNNER_HXX
+
+#include "bspf.hxx"
+
+/**
+  Replays an input movie (see InputMovie) headless, without OSystem,
+  FrameBuffer or Sound, as fast as possible:
+
+    stella -replay <movie> <rom> [repeat]
+
+  The movie is replayed by a HeadlessConsole, from its starting state,
+  'repeat' times (by default once).  Since a replay is deterministic, the
+  final frame and RAM are the same on every run and every build (unless
+  the emulation changes), and are reported as MD5 hashes along with the
+  time of the fastest run.  This makes replays a reproducible benchmark
+  workload as well as a regression test.
+
+  Only joysticks and paddles are supported as controllers.
+*/
+class ReplayRunner
+{
+  public:
+    ReplayRunner(int argc, char* argv[]);
+
+    bool run();
+
+  private:
+    string myMovieFile;
+    string myRomFile;
+    uInt32 myRepeat;
+
+  private:
+    // Following constructors and assignment operators not supported
+    ReplayRunner() = delete;
+    ReplayRunner(const ReplayRunner&) = delete;
+    ReplayRunner(ReplayRunner&&) = delete;
+    ReplayRunner& operator=(const ReplayRunner&) = delete;
+    ReplayRunner& operator=(ReplayRunner&&) = delete;
+};
+
+#endif // REPLAY_RUNNER_HXX
@@ -0,0 +1,488 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <thread>
+
+#include "BatchRunner.hxx"
+#include "Base.hxx"
+#include "Cart.hxx"
+#include "FSNode.hxx"
+#include "Settings.hxx"
+#include "ThreadPool.hxx"
+#include "ScriptRunner.hxx"
+
+using Common::Base;
+
+namespace {
+  using Value = std::function<Int32(HeadlessConsole&)>;
+
+  // The binary operators, longest first, with their precedence
+  struct Operator {
+    const char* name;
+    int precedence;
+  };
+  const Operator ourOperators[] = {
+    { "||", 1 }, { "&&", 2 }, { "==", 6 }, { "!=", 6 }, { "<=", 7 },
+    { ">=", 7 }, { "<<", 8 }, { ">>", 8 }, { "|",  3 }, { "^",  4 },
+    { "&",  5 }, { "<",  7 }, { ">",  7 }, { "+",  9 }, { "-",  9 }
+  };
+
+  /**
+    A recursive descent parser, turning an expression into nested
+    functions evaluating it.
+  */
+  class ExpressionCompiler
+  {
+    public:
+      explicit ExpressionCompiler(const string& text) : myText(text), myPos(0) { }
+
+      Value compile()
+      {
+        Value value = binary(1);
+        skipSpace();
+        if(myPos != myText.size())
+          error();
+
+        return value;
+      }
+
+    private:
+      Value binary(int precedence)
+      {
+        Value lhs = unary();
+
+        for(;;)
+        {
+          skipSpace();
+          const Operator* op = nullptr;
+          for(const Operator& o: ourOperators)
+            if(myText.compare(myPos, strlen(o.name), o.name) == 0)
+            {
+              op = &o;
+              break;
+            }
+          if(!op || op->precedence < precedence)
+            return lhs;
+
+          myPos += strlen(op->name);
+          lhs = combine(op->name, lhs, binary(op->precedence + 1));
+        }
+      }
+
+      Value unary()
+      {
+        skipSpace();
+        if(myPos == myText.size())
+          error();
+
+        const char c = myText[myPos];
+        switch(c)
+        {
+          case '!': case '~': case '-': case '*': case '@':
+          {
+            ++myPos;
+            Value v = unary();
+            switch(c)
+            {
+              case '!': return [v](HeadlessConsole& con) { return Int32(!v(con)); };
+              case '~': return [v](HeadlessConsole& con) { return ~v(con); };
+              case '-': return [v](HeadlessConsole& con) { return -v(con); };
+              case '*':
+                return [v](HeadlessConsole& con) {
+                  return Int32(con.system().peek(uInt16(v(con))));
+                };
+              default:
+                return [v](HeadlessConsole& con) {
+                  const uInt16 addr = uInt16(v(con));
+                  return Int32(con.system().peek(addr) |
+                               con.system().peek(uInt16(addr + 1)) << 8);
+                };
+            }
+          }
+
+          case '(':
+          {
+            ++myPos;
+            Value v = binary(1);
+            skipSpace();
+            if(myPos == myText.size() || myText[myPos] != ')')
+              error();
+            ++myPos;
+            return v;
+          }
+
+          case '$':  ++myPos;  return constant(16);
+          case '#':  ++myPos;  return constant(10);
+          case '%':  ++myPos;  return constant(2);
+
+          default:
+            break;
+        }
+
+        // Registers take precedence over hex numbers (as in the debugger)
+        string name = word();
+        BSPF::toLowerCase(name);
+        if(name == "a")  return [](HeadlessConsole& con) { return Int32(con.system().m6502().getA()); };
+        if(name == "x")  return [](HeadlessConsole& con) { return Int32(con.system().m6502().getX()); };
+        if(name == "y")  return [](HeadlessConsole& con) { return Int32(con.system().m6502().getY()); };
+        if(name == "sp") return [](HeadlessConsole& con) { return Int32(con.system().m6502().getSP()); };
+        if(name == "ps") return [](HeadlessConsole& con) { return Int32(con.system().m6502().getPS()); };
+        if(name == "pc") return [](HeadlessConsole& con) { return Int32(con.system().m6502().getPC()); };
+        if(name == "_bank")
+          return [](HeadlessConsole& con) {
+            return Int32(con.system().cart().getBank(con.system().m6502().getPC()));
+          };
+        if(name == "_scan")
+          return [](HeadlessConsole& con) { return Int32(con.tia().scanlines()); };
+        if(name == "_fcount")
+          return [](HeadlessConsole& con) { return Int32(con.tia().frameCount()); };
+
+        myPos -= name.size();
+        return constant(16);
+      }
+
+      Value constant(int base)
+      {
+        const string digits = word();
+        size_t end = 0;
+        Int32 value = 0;
+        try {
+          value = Int32(std::stoul(digits, &end, base));
+        }
+        catch(...) { }
+        if(digits.empty() || end != digits.size())
+          error();
+
+        return [value](HeadlessConsole&) { return value; };
+      }
+
+      static Value combine(const string& op, const Value& l, const Value& r)
+      {
+        if(op == "||") return [l, r](HeadlessConsole& c) { return Int32(l(c) || r(c)); };
+        if(op == "&&") return [l, r](HeadlessConsole& c) { return Int32(l(c) && r(c)); };
+        if(op == "==") return [l, r](HeadlessConsole& c) { return Int32(l(c) == r(c)); };
+        if(op == "!=") return [l, r](HeadlessConsole& c) { return Int32(l(c) != r(c)); };
+        if(op == "<=") return [l, r](HeadlessConsole& c) { return Int32(l(c) <= r(c)); };
+        if(op == ">=") return [l, r](HeadlessConsole& c) { return Int32(l(c) >= r(c)); };
+        if(op == "<<") return [l, r](HeadlessConsole& c) { return l(c) << r(c); };
+        if(op == ">>") return [l, r](HeadlessConsole& c) { return l(c) >> r(c); };
+        if(op == "|")  return [l, r](HeadlessConsole& c) { return l(c) | r(c); };
+        if(op == "^")  return [l, r](HeadlessConsole& c) { return l(c) ^ r(c); };
+        if(op == "&")  return [l, r](HeadlessConsole& c) { return l(c) & r(c); };
+        if(op == "<")  return [l, r](HeadlessConsole& c) { return Int32(l(c) < r(c)); };
+        if(op == ">")  return [l, r](HeadlessConsole& c) { return Int32(l(c) > r(c)); };
+        if(op == "+")  return [l, r](HeadlessConsole& c) { return l(c) + r(c); };
+        return [l, r](HeadlessConsole& c) { return l(c) - r(c); };
+      }
+
+      string word()
+      {
+        const size_t start = myPos;
+        while(myPos < myText.size() && (isalnum(myText[myPos]) || myText[myPos] == '_'))
+          ++myPos;
+
+        return myText.substr(start, myPos - start);
+      }
+
+      void skipSpace()
+      {
+        while(myPos < myText.size() && isspace(myText[myPos]))
+          ++myPos;
+      }
+
+      [[noreturn]] void error() const
+      {
+        throw runtime_error("invalid expression '" + myText + "'");
+      }
+
+    private:
+      const string& myText;
+      size_t myPos;
+  };
+}
+
+constexpr uInt32 ScriptRunner::MAX_STEPS;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ScriptRunner::ScriptRunner(int argc, char* argv[])
+{
+  if(argc > 2) myScriptFile = argv[2];
+  for(int i = 3; i < argc; ++i)
+    myRomFiles.push_back(argv[i]);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ScriptRunner::run()
+{
+  if(myScriptFile.empty() || myRomFiles.empty())
+  {
+    cout << "usage: stella -script <script> <rom> [<rom> ...]" << endl;
+    return false;
+  }
+  if(!loadScript())
+    return false;
+
+  // The consoles only read the settings, so they can share them
+  Settings settings;
+  settings.setValue("fastscbios", true);
+
+  vector<ostringstream> output(myRomFiles.size());
+  vector<char> ok(myRomFiles.size(), false);
+
+  ThreadPool pool;
+  pool.setThreads(std::min(std::max(std::thread::hardware_concurrency(), 1u),
+                           uInt32(myRomFiles.size())));
+  pool.run(uInt32(myRomFiles.size()), [&](uInt32 i) {
+    try {
+      ok[i] = runOne(myRomFiles[i], settings, output[i]);
+    }
+    catch(const runtime_error& e) {
+      output[i] << "  ERROR: " << e.what() << endl;
+    }
+  });
+
+  uInt32 failed = 0;
+  for(size_t i = 0; i < myRomFiles.size(); ++i)
+  {
+    cout << myRomFiles[i] << ":" << endl << output[i].str()
+         << (ok[i] ? "  ok" : "  FAILED") << endl;
+    if(!ok[i])
+      ++failed;
+  }
+  cout << endl << (myRomFiles.size() - failed) << " of " << myRomFiles.size()
+       << " ROMs ok" << endl;
+
+  return failed == 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ScriptRunner::loadScript()
+{
+  static const std::map<string, Type> commands = {
+    { "frame",     Type::Frame     },
+    { "scanline",  Type::Scanline  },
+    { "step",      Type::Step      },
+    { "runtopc",   Type::RunToPc   },
+    { "stepwhile", Type::StepWhile },
+    { "print",     Type::Print     },
+    { "assert",    Type::Assert    },
+    { "input",     Type::Input     },
+    { "reset",     Type::Reset     }
+  };
+
+  ifstream in(myScriptFile);
+  if(!in.is_open())
+  {
+    cout << "ERROR: unable to read script '" << myScriptFile << "'" << endl;
+    return false;
+  }
+
+  string line;
+  for(uInt32 lineNo = 1; std::getline(in, line); ++lineNo)
+  {
+    istringstream buf(line);
+    string name;
+    if(!(buf >> name) || name[0] == '#')
+      continue;
+
+    Command command;
+    command.line = lineNo;
+    command.event = Event::NoType;
+    command.pressed = 0;
+    std::getline(buf >> std::ws, command.text);
+    command.text.erase(command.text.find_last_not_of(" \t\r") + 1);
+
+    auto it = commands.find(BSPF::toLowerCase(name));
+    if(it == commands.end())
+    {
+      cout << "ERROR: line " << lineNo << ": unknown command '" << name << "'" << endl;
+      return false;
+    }
+    command.type = it->second;
+
+    try {
+      switch(command.type)
+      {
+        case Type::Frame:
+        case Type::Scanline:
+        case Type::Step:
+          command.value = compile(command.text.empty() ? "1" : command.text);
+          break;
+
+        case Type::RunToPc:
+        case Type::StepWhile:
+        case Type::Print:
+        case Type::Assert:
+          command.value = compile(command.text);
+          break;
+
+        case Type::Input:
+        {
+          istringstream args(command.text);
+          string input;
+          if(!(args >> input >> command.pressed) ||
+             !BatchRunner::inputEvent(input, command.event))
+            throw runtime_error("invalid input '" + command.text + "'");
+          break;
+        }
+
+        case Type::Reset:
+          break;
+      }
+    }
+    catch(const runtime_error& e)
+    {
+      cout << "ERROR: line " << lineNo << ": " << e.what() << endl;
+      return false;
+    }
+
+    myCommands.push_back(command);
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ScriptRunner::Value ScriptRunner::compile(const string& expression)
+{
+  return ExpressionCompiler(expression).compile();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ScriptRunner::runOne(const string& romFile, Settings& settings,
+                          ostream& out) const
+{
+  FilesystemNode node(romFile);
+  ByteBuffer image;
+  const uInt32 size = node.isFile() ? uInt32(node.read(image)) : 0;
+  if(size == 0)
+    throw runtime_error("unable to read ROM");
+
+  HeadlessConsole console(image, size, settings);
+  vector<HeadlessConsole::Input> inputs;
+
+  for(const Command& command: myCommands)
+    if(!execute(command, console, inputs, out))
+      return false;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool ScriptRunner::execute(const Command& command, HeadlessConsole& console,
+                           vector<HeadlessConsole::Input>& inputs, ostream& out)
+{
+  M6502& cpu = console.system().m6502();
+  uInt32 steps = 0;
+
+  // Execute one instruction, within the limit of a loop
+  const auto step = [&]() {
+    if(++steps > MAX_STEPS)
+    {
+      out << "  line " << command.line << ": gave up after " << MAX_STEPS
+          << " instructions" << endl;
+      return false;
+    }
+    if(!console.stepInstruction())
+    {
+      out << "  line " << command.line << ": emulation failed" << endl;
+      return false;
+    }
+    return true;
+  };
+
+  switch(command.type)
+  {
+    case Type::Frame:
+      for(Int32 i = command.value(console); i > 0; --i)
+        if(!console.step(inputs.data(), uInt32(inputs.size())))
+        {
+          out << "  line " << command.line << ": emulation failed" << endl;
+          return false;
+        }
+      return true;
+
+    case Type::Scanline:
+      for(Int32 i = command.value(console); i > 0; --i)
+      {
+        const uInt32 line = console.tia().scanlines(),
+                     frame = console.tia().frameCount();
+        do
+          if(!step())
+            return false;
+        while(line == console.tia().scanlines() &&
+              frame == console.tia().frameCount());
+      }
+      return true;
+
+    case Type::Step:
+      for(Int32 i = command.value(console); i > 0; --i)
+        if(!step())
+          return false;
+      return true;
+
+    case Type::RunToPc:
+    {
+      const uInt16 target = uInt16(command.value(console));
+      do
+        if(!step())
+          return false;
+      while(cpu.getPC() != target);
+      return true;
+    }
+
+    case Type::StepWhile:
+      do
+        if(!step())
+          return false;
+      while(command.value(console));
+      return true;
+
+    case Type::Print:
+    {
+      const Int32 value = command.value(console);
+      out << "  " << command.text << " = $" << Base::HEX4 << (value & 0xffff)
+          << " #" << std::dec << value << endl;
+      return true;
+    }
+
+    case Type::Assert:
+      if(command.value(console))
+        return true;
+      out << "  line " << command.line << ": assertion failed: "
+          << command.text << endl;
+      return false;
+
+    case Type::Input:
+    {
+      auto it = std::find_if(inputs.begin(), inputs.end(),
+          [&](const HeadlessConsole::Input& i) { return i.event == command.event; });
+      if(it != inputs.end())
+        inputs.erase(it);
+      if(command.pressed)
+        inputs.push_back({command.event, command.pressed});
+      console.setInputs(inputs.data(), uInt32(inputs.size()));
+      return true;
+    }
+
+    case Type::Reset:
+      console.reset();
+      return true;
+  }
+
+  return true;
+}
@@ -0,0 +1,121 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef SCRIPT_RUNNER_HXX
+#define SCRIPT_RUNNER_HXX
+
+class Settings;
+
+#include <functional>
+
+#include "bspf.hxx"
+#include "Event.hxx"
+#include "HeadlessConsole.hxx"
+
+/**
+  Runs debugger scripts against headless consoles, without OSystem,
+  FrameBuffer or the debugger GUI, for automated assertions on the game
+  state (e.g. in CI):
+
+    stella -script <script> <rom> [<rom> ...]
+
+  The script is parsed once and then run for every ROM, in parallel on a
+  thread pool with one HeadlessConsole per ROM.  The output of each run
+  is buffered and printed in ROM order.  The exit code is non-zero if an
+  assertion failed or the emulation didn't get to the end of a script.
+
+  Scripts contain one command per line; empty lines and lines starting
+  with '#' are ignored.  The commands are a subset of the debugger's:
+
+    frame [xx]         advance xx frames (default 1)
+    scanline [xx]      advance xx scanlines (default 1)
+    step [xx]          execute xx instructions (default 1)
+    runtopc xx         run until the PC is xx
+    stepwhile <cond>   execute instructions while the condition holds
+    print <value>      print the value in hex and decimal
+    assert <cond>      fail the run if the condition doesn't hold
+    input <name> <0|1> press or release an input (as in '-batch' scripts)
+    reset              reset the console
+
+  Values and conditions are expressions as in the debugger: numbers are
+  hex by default ('#' for decimal, '%' for binary), the registers are
+  'a', 'x', 'y', 'sp', 'ps' and 'pc', along with '_bank', '_scan' and
+  '_fcount'.  '*' reads a byte and '@' a word from memory.  The C
+  operators (except for the assignments, '*', '/' and '%') are
+  supported, with the usual precedence.
+
+  Loops are run natively on the compiled conditions, and give up after
+  MAX_STEPS instructions.
+*/
+class ScriptRunner
+{
+  public:
+    ScriptRunner(int argc, char* argv[]);
+
+    bool run();
+
+    static constexpr uInt32 MAX_STEPS = 10000000;
+
+  private:
+    using Value = std::function<Int32(HeadlessConsole&)>;
+
+    enum class Type {
+      Frame, Scanline, Step, RunToPc, StepWhile, Print, Assert, Input, Reset
+    };
+
+    struct Command {
+      Type type;
+      uInt32 line;
+      string text;      // the argument, as written in the script
+      Value value;      // the compiled count, address or condition
+      Event::Type event;
+      Int32 pressed;    // the value of an input
+    };
+
+  private:
+    bool loadScript();
+
+    /**
+      Compile the expression into a function evaluating it.
+
+      @throws runtime_error  if the expression isn't valid
+    */
+    static Value compile(const string& expression);
+
+    // Run the script on the given ROM, writing its output to 'out'
+    bool runOne(const string& romFile, Settings& settings, ostream& out) const;
+
+    // Execute a single command; false if the run must stop
+    static bool execute(const Command& command, HeadlessConsole& console,
+                        vector<HeadlessConsole::Input>& inputs, ostream& out);
+
+  private:
+    string myScriptFile;
+    StringList myRomFiles;
+
+    vector<Command> myCommands;
+
+  private:
+    // Following constructors and assignment operators not supported
+    ScriptRunner() = delete;
+    ScriptRunner(const ScriptRunner&) = delete;
+    ScriptRunner(ScriptRunner&&) = delete;
+    ScriptRunner& operator=(const ScriptRunner&) = delete;
+    ScriptRunner& operator=(ScriptRunner&&) = delete;
+};
+
+#endif // SCRIPT_RUNNER_HXX
@@ -23,7 +23,15 @@ using std::ios_base;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Serializer::Serializer(const string& filename, Mode m)
-  : myStream(nullptr)
+  : myStream(nullptr),
+    myBackend(Backend::stream),
+    myReadPos(0),
+    myWritePos(0),
+    myExternal(nullptr),
+    myExternalSize(0),
+    myExternalReadOnly(false),
+    myLean(false),
+    myProfile(nullptr)
 {
   if(m == Mode::ReadOnly)
   {
@@ -50,6 +58,7 @@ Serializer::Serializer(const string& filename, Mode m)
     // already exists
     fstream temp(filename, ios::out | ios::app);
     temp.close();
+    FilesystemNode::invalidateCache(filename);
 
     ios_base::openmode stream_mode = ios::in | ios::out | ios::binary;
     if(m == Mode::ReadWriteTrunc)
@@ -66,95 +75,71 @@ Serializer::Serializer(const string& filename, Mode m)
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Serializer::Serializer()
-  : myStream(nullptr)
+  : myStream(nullptr),
+    myBackend(Backend::buffer),
+    myReadPos(0),
+    myWritePos(0),
+    myExternal(nullptr),
+    myExternalSize(0),
+    myExternalReadOnly(false),
+    myLean(false),
+    myProfile(nullptr)
 {
-  myStream = make_unique<stringstream>(ios::in | ios::out | ios::binary);
-
-  // For some reason, Windows and possibly macOS needs to store something in
-  // the stream before it is used for the first time
-  if(myStream)
-  {
-    myStream->exceptions( ios_base::failbit | ios_base::badbit | ios_base::eofbit );
-    putBool(true);
-    rewind();
-  }
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::rewind()
-{
-  myStream->clear();
-  myStream->seekg(ios_base::beg);
-  myStream->seekp(ios_base::beg);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-size_t Serializer::size() const
-{
-  return myStream->tellp();
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8 Serializer::getByte() const
-{
-  char buf;
-  myStream->read(&buf, 1);
-
-  return buf;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::getByteArray(uInt8* array, uInt32 size) const
-{
-  myStream->read(reinterpret_cast<char*>(array), size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt16 Serializer::getShort() const
+Serializer::Serializer(void* buffer, size_t size)
+  : myStream(nullptr),
+    myBackend(Backend::external),
+    myReadPos(0),
+    myWritePos(0),
+    myExternal(static_cast<uInt8*>(buffer)),
+    myExternalSize(size),
+    myExternalReadOnly(false),
+    myLean(false),
+    myProfile(nullptr)
 {
-  uInt16 val = 0;
-  myStream->read(reinterpret_cast<char*>(&val), sizeof(uInt16));
-
-  return val;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::getShortArray(uInt16* array, uInt32 size) const
+Serializer::Serializer(const void* buffer, size_t size)
+  : myStream(nullptr),
+    myBackend(Backend::external),
+    myReadPos(0),
+    myWritePos(0),
+    // never written to, see writeBytes()
+    myExternal(static_cast<uInt8*>(const_cast<void*>(buffer))),
+    myExternalSize(size),
+    myExternalReadOnly(true),
+    myLean(false),
+    myProfile(nullptr)
 {
-  myStream->read(reinterpret_cast<char*>(array), sizeof(uInt16)*size);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 Serializer::getInt() const
+void Serializer::rewind()
 {
-  uInt32 val = 0;
-  myStream->read(reinterpret_cast<char*>(&val), sizeof(uInt32));
-
-  return val;
-}
+  if(myBackend != Backend::stream)
+  {
+    myReadPos = myWritePos = 0;
+    return;
+  }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::getIntArray(uInt32* array, uInt32 size) const
-{
-  myStream->read(reinterpret_cast<char*>(array), sizeof(uInt32)*size);
+  myStream->clear();
+  myStream->seekg(ios_base::beg);
+  myStream->seekp(ios_base::beg);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt64 Serializer::getLong() const
+size_t Serializer::size() const
 {
-  uInt64 val = 0;
-  myStream->read(reinterpret_cast<char*>(&val), sizeof(uInt64));
-
-  return val;
+  return myBackend != Backend::stream ? myWritePos : size_t(myStream->tellp());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double Serializer::getDouble() const
+size_t Serializer::readPosition() const
 {
-  double val = 0.0;
-  myStream->read(reinterpret_cast<char*>(&val), sizeof(double));
-
-  return val;
+  return myBackend != Backend::stream ? myReadPos : size_t(myStream->tellg());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -163,75 +148,15 @@ string Serializer::getString() const
   int len = getInt();
   string str;
   str.resize(len);
-  myStream->read(&str[0], len);
+  readBytes(&str[0], len);
 
   return str;
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Serializer::getBool() const
-{
-  return getByte() == TruePattern;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putByte(uInt8 value)
-{
-  myStream->write(reinterpret_cast<char*>(&value), 1);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putByteArray(const uInt8* array, uInt32 size)
-{
-  myStream->write(reinterpret_cast<const char*>(array), size);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putShort(uInt16 value)
-{
-  myStream->write(reinterpret_cast<char*>(&value), sizeof(uInt16));
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putShortArray(const uInt16* array, uInt32 size)
-{
-  myStream->write(reinterpret_cast<const char*>(array), sizeof(uInt16)*size);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putInt(uInt32 value)
-{
-  myStream->write(reinterpret_cast<char*>(&value), sizeof(uInt32));
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putIntArray(const uInt32* array, uInt32 size)
-{
-  myStream->write(reinterpret_cast<const char*>(array), sizeof(uInt32)*size);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putLong(uInt64 value)
-{
-  myStream->write(reinterpret_cast<char*>(&value), sizeof(uInt64));
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putDouble(double value)
-{
-  myStream->write(reinterpret_cast<char*>(&value), sizeof(double));
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Serializer::putString(const string& str)
 {
   uInt32 len = uInt32(str.length());
   putInt(len);
-  myStream->write(str.data(), len);
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Serializer::putBool(bool b)
-{
-  putByte(b ? TruePattern: FalsePattern);
+  writeBytes(str.data(), len);
 }
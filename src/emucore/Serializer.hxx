@@ -18,12 +18,18 @@
 #ifndef SERIALIZER_HXX
 #define SERIALIZER_HXX
 
+class StateProfile;
+
+#include <type_traits>
+
 #include "bspf.hxx"
 
 /**
   This class implements a Serializer device, whereby data is serialized and
   read from/written to a binary stream in a system-independent way.  The
-  stream can be either an actual file, or an in-memory structure.
+  stream can be either an actual file, or an in-memory buffer.  The
+  in-memory buffer is a contiguous, growable block of bytes which can be
+  accessed directly through data()/size().
 
   Bytes are written as characters, shorts as 2 characters (16-bits),
   integers as 4 characters (32-bits), long integers as 8 bytes (64-bits),
@@ -52,12 +58,26 @@ class Serializer
     Serializer(const string& filename, Mode m = Mode::ReadWrite);
     Serializer();
 
+    /**
+      Creates a new Serializer device operating directly on a block of memory
+      of the given size provided by the caller; no data is copied, and
+      accessing data beyond 'size' bytes fails.
+
+      A writable buffer may be the null pointer, in which case nothing is
+      stored and only size() is updated.  This can be used to determine the
+      size of a state without actually saving it.
+    */
+    Serializer(void* buffer, size_t size);
+    Serializer(const void* buffer, size_t size);
+
   public:
     /**
       Answers whether the serializer is currently initialized for reading
       and writing.
     */
-    explicit operator bool() const { return myStream != nullptr; }
+    explicit operator bool() const {
+      return myBackend != Backend::stream || myStream != nullptr;
+    }
 
     /**
       Resets the read/write location to the beginning of the stream.
@@ -69,12 +89,41 @@ class Serializer
     */
     size_t size() const;
 
+    /**
+      Returns the current read pointer location.
+    */
+    size_t readPosition() const;
+
+    /**
+      Returns the contents of an in-memory serializer; the first size()
+      bytes are the data written since the last rewind().  Answers the
+      null pointer for file-based serializers.
+    */
+    const uInt8* data() const {
+      return myBackend == Backend::buffer ? myBuffer.data() : myExternal;
+    }
+
+    /**
+      Lean states leave out everything not needed to continue emulation
+      deterministically, like the data only kept for the debugger.  They
+      can only be loaded by a serializer in lean mode as well.
+    */
+    void setLean(bool lean) { myLean = lean; }
+    bool lean() const { return myLean; }
+
+    /**
+      Measure the components saved or loaded from now on (see StateProfile),
+      or stop measuring when null.
+    */
+    void setProfile(StateProfile* profile) { myProfile = profile; }
+    StateProfile* profile() const { return myProfile; }
+
     /**
       Reads a byte value (unsigned 8-bit) from the current input stream.
 
       @result The byte value which has been read from the stream.
     */
-    uInt8 getByte() const;
+    inline uInt8 getByte() const;
 
     /**
       Reads a byte array (unsigned 8-bit) from the current input stream.
@@ -82,14 +131,14 @@ class Serializer
       @param array  The location to store the bytes read
       @param size   The size of the array (number of bytes to read)
     */
-    void getByteArray(uInt8* array, uInt32 size) const;
+    inline void getByteArray(uInt8* array, uInt32 size) const;
 
     /**
       Reads a short value (unsigned 16-bit) from the current input stream.
 
       @result The short value which has been read from the stream.
     */
-    uInt16 getShort() const;
+    inline uInt16 getShort() const;
 
     /**
       Reads a short array (unsigned 16-bit) from the current input stream.
@@ -97,14 +146,14 @@ class Serializer
       @param array  The location to store the shorts read
       @param size   The size of the array (number of shorts to read)
     */
-    void getShortArray(uInt16* array, uInt32 size) const;
+    inline void getShortArray(uInt16* array, uInt32 size) const;
 
     /**
       Reads an int value (unsigned 32-bit) from the current input stream.
 
       @result The int value which has been read from the stream.
     */
-    uInt32 getInt() const;
+    inline uInt32 getInt() const;
 
     /**
       Reads an integer array (unsigned 32-bit) from the current input stream.
@@ -112,21 +161,21 @@ class Serializer
       @param array  The location to store the integers read
       @param size   The size of the array (number of integers to read)
     */
-    void getIntArray(uInt32* array, uInt32 size) const;
+    inline void getIntArray(uInt32* array, uInt32 size) const;
 
     /**
       Reads a long int value (unsigned 64-bit) from the current input stream.
 
       @result The long int value which has been read from the stream.
     */
-    uInt64 getLong() const;
+    inline uInt64 getLong() const;
 
     /**
       Reads a double value (signed 64-bit) from the current input stream.
 
       @result The double value which has been read from the stream.
     */
-    double getDouble() const;
+    inline double getDouble() const;
 
     /**
       Reads a string from the current input stream.
@@ -140,14 +189,14 @@ class Serializer
 
       @result The boolean value which has been read from the stream.
     */
-    bool getBool() const;
+    inline bool getBool() const;
 
     /**
       Writes an byte value (unsigned 8-bit) to the current output stream.
 
       @param value The byte value to write to the output stream.
     */
-    void putByte(uInt8 value);
+    inline void putByte(uInt8 value);
 
     /**
       Writes a byte array (unsigned 8-bit) to the current output stream.
@@ -155,14 +204,14 @@ class Serializer
       @param array  The bytes to write
       @param size   The size of the array (number of bytes to write)
     */
-    void putByteArray(const uInt8* array, uInt32 size);
+    inline void putByteArray(const uInt8* array, uInt32 size);
 
     /**
       Writes a short value (unsigned 16-bit) to the current output stream.
 
       @param value The short value to write to the output stream.
     */
-    void putShort(uInt16 value);
+    inline void putShort(uInt16 value);
 
     /**
       Writes a short array (unsigned 16-bit) to the current output stream.
@@ -170,14 +219,14 @@ class Serializer
       @param array  The short to write
       @param size   The size of the array (number of shorts to write)
     */
-    void putShortArray(const uInt16* array, uInt32 size);
+    inline void putShortArray(const uInt16* array, uInt32 size);
 
     /**
       Writes an int value (unsigned 32-bit) to the current output stream.
 
       @param value The int value to write to the output stream.
     */
-    void putInt(uInt32 value);
+    inline void putInt(uInt32 value);
 
     /**
       Writes an integer array (unsigned 32-bit) to the current output stream.
@@ -185,21 +234,21 @@ class Serializer
       @param array  The integers to write
       @param size   The size of the array (number of integers to write)
     */
-    void putIntArray(const uInt32* array, uInt32 size);
+    inline void putIntArray(const uInt32* array, uInt32 size);
 
     /**
       Writes a long int value (unsigned 64-bit) to the current output stream.
 
       @param value The long int value to write to the output stream.
     */
-    void putLong(uInt64 value);
+    inline void putLong(uInt64 value);
 
     /**
       Writes a double value (signed 64-bit) to the current output stream.
 
       @param value The double value to write to the output stream.
     */
-    void putDouble(double value);
+    inline void putDouble(double value);
 
     /**
       Writes a string to the current output stream.
@@ -213,12 +262,56 @@ class Serializer
 
       @param b The boolean value to write to the output stream.
     */
-    void putBool(bool b);
+    inline void putBool(bool b);
+
+    /**
+      Reads/writes a block of plain state (usually a packed struct of several
+      values) in one go, in the native byte order like all other values.
+      Booleans are stored in blocks as boolByte(), so a block is read and
+      written the same as its values one by one.
+
+      @param block The block to read into/write
+    */
+    template<typename T> inline void getBlock(T& block) const;
+    template<typename T> inline void putBlock(const T& block);
+
+    static constexpr uInt8 boolByte(bool b) { return b ? TruePattern : FalsePattern; }
+    static constexpr bool byteBool(uInt8 b) { return b == TruePattern; }
+
+  private:
+    /**
+      Read/write raw bytes from/to the underlying stream or buffer.
+    */
+    inline void readBytes(void* dest, size_t len) const;
+    inline void writeBytes(const void* src, size_t len);
 
   private:
-    // The stream to send the serialized data to.
+    // The stream to send the serialized data to (file-based serializers)
     unique_ptr<iostream> myStream;
 
+    // Where the data is stored: a file (stream), the internal buffer, or
+    // memory provided by the caller
+    enum class Backend { stream, buffer, external };
+    Backend myBackend;
+
+    // The buffer holding the serialized data (in-memory serializers)
+    // As for a stringstream, data beyond the write position remains valid
+    // after a rewind, and reads and writes use separate positions
+    vector<uInt8> myBuffer;
+    mutable size_t myReadPos;
+    size_t myWritePos;
+
+    // The memory provided by the caller (external serializers)
+    uInt8* myExternal;
+    size_t myExternalSize;
+    bool myExternalReadOnly;
+
+    // Whether to read/write lean states (see setLean())
+    bool myLean;
+
+    // Measures the components, if set
+    StateProfile* myProfile;
+
     static constexpr uInt8 TruePattern = 0xfe, FalsePattern = 0x01;
 
   private:
@@ -229,4 +322,202 @@ class Serializer
     Serializer& operator=(Serializer&&) = delete;
 };
 
+// ############################################################################
+// Implementation
+// ############################################################################
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::readBytes(void* dest, size_t len) const
+{
+  switch(myBackend)
+  {
+    case Backend::buffer:
+      if(myReadPos + len > myBuffer.size())
+        throw runtime_error("Serializer: read past end of buffer");
+
+      std::copy_n(myBuffer.data() + myReadPos, len, static_cast<uInt8*>(dest));
+      myReadPos += len;
+      break;
+
+    case Backend::external:
+      if(myReadPos + len > myExternalSize || !myExternal)
+        throw runtime_error("Serializer: read past end of buffer");
+
+      std::copy_n(myExternal + myReadPos, len, static_cast<uInt8*>(dest));
+      myReadPos += len;
+      break;
+
+    case Backend::stream:
+      myStream->read(static_cast<char*>(dest), len);
+      break;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::writeBytes(const void* src, size_t len)
+{
+  switch(myBackend)
+  {
+    case Backend::buffer:
+      if(myWritePos + len > myBuffer.size())
+        myBuffer.resize(myWritePos + len);
+
+      std::copy_n(static_cast<const uInt8*>(src), len, myBuffer.data() + myWritePos);
+      myWritePos += len;
+      break;
+
+    case Backend::external:
+      if(myWritePos + len > myExternalSize || myExternalReadOnly)
+        throw runtime_error("Serializer: write past end of buffer");
+
+      if(myExternal)
+        std::copy_n(static_cast<const uInt8*>(src), len, myExternal + myWritePos);
+      myWritePos += len;
+      break;
+
+    case Backend::stream:
+      myStream->write(static_cast<const char*>(src), len);
+      break;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 Serializer::getByte() const
+{
+  uInt8 val = 0;
+  readBytes(&val, 1);
+
+  return val;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::getByteArray(uInt8* array, uInt32 size) const
+{
+  readBytes(array, size);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt16 Serializer::getShort() const
+{
+  uInt16 val = 0;
+  readBytes(&val, sizeof(uInt16));
+
+  return val;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::getShortArray(uInt16* array, uInt32 size) const
+{
+  readBytes(array, sizeof(uInt16)*size);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Serializer::getInt() const
+{
+  uInt32 val = 0;
+  readBytes(&val, sizeof(uInt32));
+
+  return val;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::getIntArray(uInt32* array, uInt32 size) const
+{
+  readBytes(array, sizeof(uInt32)*size);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 Serializer::getLong() const
+{
+  uInt64 val = 0;
+  readBytes(&val, sizeof(uInt64));
+
+  return val;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double Serializer::getDouble() const
+{
+  double val = 0.0;
+  readBytes(&val, sizeof(double));
+
+  return val;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Serializer::getBool() const
+{
+  return getByte() == TruePattern;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::putByte(uInt8 value)
+{
+  writeBytes(&value, 1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::putByteArray(const uInt8* array, uInt32 size)
+{
+  writeBytes(array, size);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::putShort(uInt16 value)
+{
+  writeBytes(&value, sizeof(uInt16));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::putShortArray(const uInt16* array, uInt32 size)
+{
+  writeBytes(array, sizeof(uInt16)*size);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::putInt(uInt32 value)
+{
+  writeBytes(&value, sizeof(uInt32));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::putIntArray(const uInt32* array, uInt32 size)
+{
+  writeBytes(array, sizeof(uInt32)*size);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::putLong(uInt64 value)
+{
+  writeBytes(&value, sizeof(uInt64));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::putDouble(double value)
+{
+  writeBytes(&value, sizeof(double));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::putBool(bool b)
+{
+  putByte(b ? TruePattern: FalsePattern);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<typename T>
+void Serializer::getBlock(T& block) const
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Blocks must be plain data");
+  readBytes(&block, sizeof(T));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<typename T>
+void Serializer::putBlock(const T& block)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Blocks must be plain data");
+  writeBytes(&block, sizeof(T));
+}
+
 #endif
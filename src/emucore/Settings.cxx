@@ -21,6 +21,7 @@
 #include "Version.hxx"
 #include "Logger.hxx"
 #include "AudioSettings.hxx"
+#include "ThreadPlacement.hxx"
 
 #ifdef DEBUGGER_SUPPORT
   #include "DebuggerDialog.hxx"
@@ -37,7 +38,15 @@ Settings::Settings()
   // Video-related options
   setPermanent("video", "");
   setPermanent("speed", "1.0");
+  setPermanent("runahead", "0");
+  setPermanent("turbo.skip", "10");
+  setPermanent("frameskip", "0");
+  setPermanent("frameserver", "");
+  setPermanent("stream.port", "0");
+  setPermanent("stream.bind", "127.0.0.1");
   setPermanent("vsync", "true");
+  setPermanent("pacing", "timer");
+  setPermanent("gpusync", "false");
   setPermanent("center", "true");
   setPermanent("windowedpos", Common::Point(50, 50));
   setPermanent("display", 0);
@@ -47,17 +56,20 @@ Settings::Settings()
   // TIA specific options
   setPermanent("tia.zoom", "3");
   setPermanent("tia.inter", "false");
+  setPermanent("tia.direct", "true");
   setPermanent("tia.aspectn", "100");
   setPermanent("tia.aspectp", "100");
   setPermanent("fullscreen", "false");
   setPermanent("tia.fs_stretch", "false");
   setPermanent("tia.fs_overscan", "0");
   setPermanent("tia.dbgcolors", "roygpb");
+  setPermanent("tia.threaded", "false");
 
   // TV filtering options
   setPermanent("tv.filter", "0");
   setPermanent("tv.phosphor", "byrom");
   setPermanent("tv.phosblend", "50");
+  setPermanent("tv.phoshw", "false");
   setPermanent("tv.scanlines", "25");
   // TV options when using 'custom' mode
   setPermanent("tv.contrast", "0.0");
@@ -78,10 +90,15 @@ Settings::Settings()
   setPermanent(AudioSettings::SETTING_FRAGMENT_SIZE, AudioSettings::DEFAULT_FRAGMENT_SIZE);
   setPermanent(AudioSettings::SETTING_SAMPLE_RATE, AudioSettings::DEFAULT_SAMPLE_RATE);
   setPermanent(AudioSettings::SETTING_RESAMPLING_QUALITY, static_cast<int>(AudioSettings::DEFAULT_RESAMPLING_QUALITY));
+  setPermanent(AudioSettings::SETTING_RESAMPLING_TAPS, AudioSettings::DEFAULT_RESAMPLING_TAPS);
   setPermanent(AudioSettings::SETTING_HEADROOM, AudioSettings::DEFAULT_HEADROOM);
   setPermanent(AudioSettings::SETTING_BUFFER_SIZE, AudioSettings::DEFAULT_BUFFER_SIZE);
   setPermanent(AudioSettings::SETTING_STEREO, AudioSettings::DEFAULT_STEREO);
   setPermanent(AudioSettings::SETTING_DPC_PITCH, AudioSettings::DEFAULT_DPC_PITCH);
+  setPermanent(AudioSettings::SETTING_AUTOTUNE, AudioSettings::DEFAULT_AUTOTUNE);
+  setPermanent(AudioSettings::SETTING_DYNAMIC_RATE, AudioSettings::DEFAULT_DYNAMIC_RATE);
+  setPermanent("audio.core", "-1");
+  setPermanent("audio.priority", "normal");
 
   // Input event options
   setPermanent("event_ver", "1");
@@ -111,6 +128,7 @@ Settings::Settings()
   setPermanent("snapname", "int");
   setPermanent("sssingle", "false");
   setPermanent("ss1x", "false");
+  setPermanent("ssformat", "rgb");
   setPermanent("ssinterval", "2");
   setPermanent("autoslot", "false");
   setPermanent("saveonexit", "none");
@@ -148,7 +166,15 @@ Settings::Settings()
   setPermanent("avoxport", "");
   setPermanent("fastscbios", "true");
   setPermanent("threads", "false");
+  setPermanent("threads.core", "-1");
+  setPermanent("threads.priority", "normal");
+  setPermanent("worker.spin", "0");
+  setPermanent("worker.core", "-1");
+  setPermanent("worker.priority", "normal");
+  setPermanent("thumb.async", "false");
+  setPermanent("cpu.blocks", "true");
   setTemporary("romloadcount", "0");
+  setTemporary("lean", "false");
   setTemporary("maxres", "");
 
 #ifdef DEBUGGER_SUPPORT
@@ -179,6 +205,7 @@ Settings::Settings()
   setPermanent("plr.tm.uncompressed", 60);
   setPermanent("plr.tm.interval", "30f"); // = 0.5 seconds
   setPermanent("plr.tm.horizon", "10m"); // = ~10 minutes
+  setPermanent("plr.tm.replay", "false");
   setPermanent("plr.eepromaccess", "false");
 
   // Developer settings
@@ -206,6 +233,7 @@ Settings::Settings()
   setPermanent("dev.tm.uncompressed", 600);
   setPermanent("dev.tm.interval", "1f"); // = 1 frame
   setPermanent("dev.tm.horizon", "30s"); // = ~30 seconds
+  setPermanent("dev.tm.replay", "false");
   // Thumb ARM emulation options
   setPermanent("dev.thumb.trapfatal", "true");
   setPermanent("dev.eepromaccess", "true");
@@ -222,8 +250,13 @@ void Settings::load(const Options& options)
 {
   Options fromFile =  myRespository->load();
   for (const auto& opt: fromFile)
+  {
     setValue(opt.first, opt.second, false);
 
+    // The repository already holds this value
+    mySettings[find(Key(opt.first))].dirty = false;
+  }
+
   // Apply commandline options, which override those from settings file
   for(const auto& opt: options)
     setValue(opt.first, opt.second, false);
@@ -236,7 +269,21 @@ void Settings::load(const Options& options)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Settings::save()
 {
-  myRespository->save(myPermanentSettings);
+  // Only write to the repository when something has changed; the
+  // repository is free to only store the changed values, but it
+  // always gets all of them (e.g. a config file is rewritten as a whole)
+  bool dirty = false;
+  Options permanent;
+  for(auto& s: mySettings)
+    if(s.permanent)
+    {
+      permanent.emplace(s.key, s.value);
+      dirty = dirty || s.dirty;
+      s.dirty = false;
+    }
+
+  if(dirty)
+    myRespository->save(permanent);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -249,6 +296,37 @@ void Settings::validate()
   f = getFloat("speed");
   if (f <= 0) setValue("speed", "1.0");
 
+  // Only headless consoles can be lean, since they are never debugged
+  setValue("lean", "false");
+
+  i = getInt("runahead");
+  if(i < 0 || i > 5)  setValue("runahead", "0");
+
+  i = getInt("stream.port");
+  if(i < 0 || i > 65535)  setValue("stream.port", "0");
+
+  i = getInt("turbo.skip");
+  if(i < 1 || i > 100)  setValue("turbo.skip", "10");
+
+  i = getInt("frameskip");
+  if(i < 0 || i > 10)  setValue("frameskip", "0");
+
+  s = getString("pacing");
+  if(s != "timer" && s != "display")  setValue("pacing", "timer");
+
+  i = getInt("worker.spin");
+  if(i < 0 || i > 1000)  setValue("worker.spin", "0");
+
+  vector<uInt32> cores;
+  ThreadPlacement::Priority priority;
+  for(const string prefix: { "worker", "audio", "threads" })
+  {
+    if(!ThreadPlacement::parseCores(getString(prefix + ".core"), cores))
+      setValue(prefix + ".core", "-1");
+    if(!ThreadPlacement::parsePriority(getString(prefix + ".priority"), priority))
+      setValue(prefix + ".priority", "normal");
+  }
+
   i = getInt("tia.aspectn");
   if(i < 80 || i > 120)  setValue("tia.aspectn", "90");
   i = getInt("tia.aspectp");
@@ -333,6 +411,9 @@ void Settings::validate()
   if(i < 1)        setValue("ssinterval", "2");
   else if(i > 10)  setValue("ssinterval", "10");
 
+  s = getString("ssformat");
+  if(s != "rgb" && s != "indexed" && s != "native")  setValue("ssformat", "rgb");
+
   s = getString("palette");
   if(s != "standard" && s != "z26" && s != "user")
     setValue("palette", "standard");
@@ -376,6 +457,10 @@ void Settings::usage() const
     << "                 software        Software mode (no acceleration)\n"
     << endl
     << "  -vsync        <1|0>          Enable 'synchronize to vertical blank interrupt'\n"
+    << "  -pacing       <timer|        Pace frames by timer, or lock emulation speed to\n"
+    << "                 display>       a (vsynced) display with a similar refresh rate\n"
+    << "  -gpusync      <1|0>          Wait for the GPU after each vsynced frame, for\n"
+    << "                                less latency (OpenGL renderers only)\n"
     << "  -fullscreen   <1|0>          Enable fullscreen mode\n"
     << "  -center       <1|0>          Centers game window in windowed modes\n"
     << "  -windowedpos  <XxY>          Sets the window position in windowed modes\n"
@@ -384,6 +469,14 @@ void Settings::usage() const
     << "                 z26|\n"
     << "                 user>\n"
     << "  -speed        <number>       Run emulation at the given speed\n"
+    << "  -runahead     <0-5>          Emulate frames ahead to reduce input latency\n"
+    << "  -turbo.skip   <1-100>        Render every n-th frame in turbo mode\n"
+    << "  -frameskip    <0-10>         Skip up to n frames when rendering is too slow\n"
+    << "  -frameserver  <file>         Publish frames and audio to other processes in file\n"
+    << "  -stream.port  <number>       Stream frames and audio to remote players on this\n"
+    << "                                UDP port (0 = off)\n"
+    << "  -stream.bind  <address>      Accept remote players on this IPv4 address only\n"
+    << "                                (0.0.0.0 = all)\n"
     << "  -uimessages   <1|0>          Show onscreen UI messages for different events\n"
     << endl
   #ifdef SOUND_SUPPORT
@@ -393,16 +486,25 @@ void Settings::usage() const
     << "  -audio.sample_rate        <number>   Output sample rate (44100|48000|96000)\n"
     << "  -audio.fragment_size      <number>   Fragment size (128|256|512|1024|\n"
     << "                                        2048|4096)\n"
-    << "  -audio.resampling_quality <1-3>      Resampling quality\n"
+    << "  -audio.resampling_quality <1-4>      Resampling quality\n"
+    << "  -audio.resampling_taps    <2-16>     Taps of the polyphase resampler\n"
     << "  -audio.headroom           <0-20>     Additional half-frames to prebuffer\n"
     << "  -audio.buffer_size        <0-20>     Max. number of additional half-\n"
     << "                                        frames to buffer\n"
     << "  -audio.stereo             <1|0>      Enable stereo mode for all ROMs\n"
+    << "  -audio.autotune           <1|0>      Adapt buffering to the host at runtime\n"
+    << "  -audio.dynamic_rate       <1|0>      Keep the audio buffer filled by slightly\n"
+    << "                                        varying the playback rate\n"
+    << "  -audio.core               <list>     Cores for the audio thread, e.g. 2,4-7\n"
+    << "                                        (-1 = any)\n"
+    << "  -audio.priority           <normal|   Priority of the audio thread\n"
+    << "                             high|realtime>\n"
     << endl
   #endif
     << "  -tia.zoom      <zoom>         Use the specified zoom level (windowed mode)\n"
     << "                                 for TIA image\n"
     << "  -tia.inter     <1|0>          Enable interpolated (smooth) scaling for TIA\n"
+    << "  -tia.direct    <1|0>          Render TIA image directly into texture memory\n"
     << "                                 image\n"
     << "  -tia.aspectn   <number>       Scale TIA width by the given percentage in NTS\n"
     << "                                 mode\n"
@@ -412,11 +514,14 @@ void Settings::usage() const
     << "  -tia.fs_overscan <0-10>       Add overscan to TIA image in fill fullscreen mode\n"
     << "  -tia.dbgcolors <string>       Debug colors to use for each object (see manual\n"
     << "                                 for description)\n"
+    << "  -tia.threaded  <1|0>          Emulate the TIA on a separate thread\n"
+    << "                                 (experimental)\n"
     << endl
     << "  -tv.filter    <0-5>           Set TV effects off (0) or to specified mode\n"
     << "                                 (1-5)\n"
     << "  -tv.phosphor  <always|byrom>  When to use phosphor mode\n"
     << "  -tv.phosblend <0-100>         Set default blend level in phosphor mode\n"
+    << "  -tv.phoshw    <1|0>           Blend phosphor mode in hardware, if possible\n"
     << "  -tv.scanlines <0-100>         Set scanline intensity to percentage\n"
     << "                                 (0 disables completely)\n"
     << "  -tv.contrast    <-1.0 - 1.0>  Set TV effects custom contrast\n"
@@ -456,6 +561,19 @@ void Settings::usage() const
     << "  -fastscbios   <1|0>          Disable Supercharger BIOS progress loading bars\n"
     << "  -threads      <1|0>          Whether to using multi-threading during\n"
     << "                                emulation\n"
+    << "  -threads.core <list>         Cores for the filter threads, e.g. 2,4-7\n"
+    << "                                (-1 = any)\n"
+    << "  -threads.priority <normal|high|realtime>\n"
+    << "                               Priority of the filter threads\n"
+    << "  -worker.spin  <0-1000>       Microseconds to spin before sleeping when handing\n"
+    << "                                frames to/from the emulation thread\n"
+    << "  -worker.core  <list>         Cores for the emulation thread, e.g. 2,4-7\n"
+    << "                                (-1 = any)\n"
+    << "  -worker.priority <normal|high|realtime>\n"
+    << "                               Priority of the emulation thread\n"
+    << "  -thumb.async  <1|0>          Run the ARM code of DPC+/CDF/BUS carts on a\n"
+    << "                                thread of its own\n"
+    << "  -cpu.blocks   <1|0>          Run blocks of straight-line 6507 code at once\n"
     << "  -snapsavedir  <path>         The directory to save snapshot files to\n"
     << "  -snaploaddir  <path>         The directory to load snapshot files from\n"
     << "  -snapname     <int|rom>      Name snapshots according to internal database or\n"
@@ -463,6 +581,8 @@ void Settings::usage() const
     << "  -sssingle     <1|0>          Generate single snapshot instead of many\n"
     << "  -ss1x         <1|0>          Generate TIA snapshot in 1x mode (ignore\n"
     << "                                scaling/effects)\n"
+    << "  -ssformat     <rgb|indexed|  Without TV effects, save TIA snapshots as\n"
+    << "                 native>        palette images (at 160 pixels width if native)\n"
     << "  -ssinterval   <number>       Number of seconds between snapshots in\n"
     << "                                continuous snapshot mode\n"
     << "  -autoslot     <1|0>          Automatically switch to next save slot when\n"
@@ -538,6 +658,7 @@ void Settings::usage() const
     << "   -type        <arg>          Same as using -bs\n"
     << "   -startbank   <bank>         Sets the ROM's startup bank\n"
     << "   -channels    <arg>          Sets the 'Cartridge.Sound' property\n"
+    << "   -thumbfast   <arg>          Sets the 'Cartridge.ThumbFast' property\n"
     << "   -ld          <arg>          Sets the 'Console.LeftDifficulty' property\n"
     << "   -rd          <arg>          Sets the 'Console.RightDifficulty' property\n"
     << "   -tv          <arg>          Sets the 'Console.TelevisionType' property\n"
@@ -609,41 +730,122 @@ void Settings::usage() const
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const Variant& Settings::value(const string& key) const
+const Variant& Settings::value(const Key& key) const
 {
-  // Try to find the named setting and answer its value
-  auto it = myPermanentSettings.find(key);
-  if(it != myPermanentSettings.end())
-    return it->second;
-  else
-  {
-    it = myTemporarySettings.find(key);
-    if(it != myTemporarySettings.end())
-      return it->second;
-  }
-  return EmptyVariant;
+  return setting(key).value;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Settings::setValue(const string& key, const Variant& value, bool persist)
 {
-  auto it = myPermanentSettings.find(key);
-  if(it != myPermanentSettings.end()) {
-    if (persist && it->second != value) myRespository->save(key, value);
-    it->second = value;
+  const Key k(key);
+  Int32 idx = find(k);
+
+  if(idx >= 0 && mySettings[idx].permanent)
+  {
+    if(persist && mySettings[idx].value != value)
+      myRespository->save(key, value);
   }
-  else
-    myTemporarySettings[key] = value;
+  else if(idx < 0)
+    idx = insert(key, k.id(), false);
+
+  mySettings[idx].set(value);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Settings::setPermanent(const string& key, const Variant& value)
 {
-  myPermanentSettings[key] = value;
+  const Key k(key);
+  Int32 idx = find(k);
+  if(idx < 0)
+    idx = insert(key, k.id(), true);
+
+  mySettings[idx].permanent = true;
+  mySettings[idx].set(value);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Settings::setTemporary(const string& key, const Variant& value)
 {
-  myTemporarySettings[key] = value;
+  const Key k(key);
+  Int32 idx = find(k);
+
+  // A permanent setting always takes precedence
+  if(idx >= 0 && mySettings[idx].permanent)
+    return;
+  if(idx < 0)
+    idx = insert(key, k.id(), false);
+
+  mySettings[idx].set(value);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const Settings::Setting& Settings::setting(const Key& key) const
+{
+  static const Setting EmptySetting = { "", 0, EmptyVariant, 0, 0.F, false, false, false };
+
+  const Int32 idx = find(key);
+  return idx >= 0 ? mySettings[idx] : EmptySetting;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 Settings::find(const Key& key) const
+{
+  if(mySlots.empty())
+    return -1;
+
+  // Different names may hash to the same ID, so compare the names too
+  const uInt64 id = key.id();
+  const uInt32 mask = uInt32(mySlots.size()) - 1;
+  for(uInt32 slot = uInt32(id) & mask; mySlots[slot] != 0; slot = (slot + 1) & mask)
+  {
+    const Setting& s = mySettings[mySlots[slot] - 1];
+    if(s.id == id && s.key == key.name())
+      return mySlots[slot] - 1;
+  }
+
+  return -1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Settings::insert(const string& key, uInt64 id, bool permanent)
+{
+  mySettings.push_back({ key, id, EmptyVariant, 0, 0.F, false, permanent, false });
+
+  // Keep the table at most half full, so probe sequences stay short
+  if(mySettings.size() * 2 > mySlots.size())
+  {
+    mySlots.assign(std::max<size_t>(mySlots.size() * 2, 512), 0);
+    const uInt32 mask = uInt32(mySlots.size()) - 1;
+
+    for(uInt32 i = 0; i < mySettings.size(); ++i)
+    {
+      uInt32 slot = uInt32(mySettings[i].id) & mask;
+      while(mySlots[slot] != 0)
+        slot = (slot + 1) & mask;
+      mySlots[slot] = i + 1;
+    }
+  }
+  else
+  {
+    const uInt32 mask = uInt32(mySlots.size()) - 1;
+    uInt32 slot = uInt32(id) & mask;
+    while(mySlots[slot] != 0)
+      slot = (slot + 1) & mask;
+    mySlots[slot] = uInt32(mySettings.size());
+  }
+
+  return uInt32(mySettings.size()) - 1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Settings::Setting::set(const Variant& v)
+{
+  if(v != value)
+    dirty = true;
+  value = v;
+
+  intValue = v.toInt();
+  floatValue = v.toFloat();
+  boolValue = v.toBool();
 }
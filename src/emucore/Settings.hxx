@@ -18,6 +18,7 @@
 #ifndef SETTINGS_HXX
 #define SETTINGS_HXX
 
+#include <deque>
 #include <map>
 
 #include "Variant.hxx"
@@ -38,6 +39,12 @@
   If an option isn't registered as permanent, it will be considered
   temporary and will not be saved.
 
+  Internally, all options are kept in a flat array, which is indexed by
+  a hash of the key.  Options can be accessed either by name, or through
+  a Key which is hashed at compile time; the latter should be used in
+  code which is called often.  The numeric types are converted once when
+  an option is set, not every time it is read.
+
   @author  Stephen Anthony
 */
 class Settings
@@ -51,6 +58,40 @@ class Settings
 
     using Options = std::map<string, Variant>;
 
+    /**
+      The ID of a setting, calculated from its name.  When defined as
+      constexpr, e.g.
+
+        constexpr Settings::Key TIA_ZOOM("tia.zoom");
+
+      the name is hashed at compile time.  The name itself is only
+      referenced, so a Key must not outlive the string it was built from.
+    */
+    class Key
+    {
+      public:
+        constexpr explicit Key(const char* name)
+          : myName(name), myId(hash(name)) { }
+        explicit Key(const string& name)
+          : myName(name.c_str()), myId(hash(name.c_str())) { }
+
+        constexpr const char* name() const { return myName; }
+        constexpr uInt64 id() const { return myId; }
+
+      private:
+        // 64-bit FNV-1a hash of the name
+        static constexpr uInt64 hash(const char* name) {
+          uInt64 h = 0xcbf29ce484222325ULL;
+          while(*name)
+            h = (h ^ uInt8(*name++)) * 0x100000001b3ULL;
+          return h;
+        }
+
+      private:
+        const char* myName{nullptr};
+        uInt64 myId{0};
+    };
+
   public:
     /**
       This method should be called to display usage information.
@@ -80,7 +121,8 @@ class Settings
       @param key  The key of the setting to lookup
       @return  The value of the setting; EmptyVariant if none exists
     */
-    const Variant& value(const string& key) const;
+    const Variant& value(const string& key) const { return value(Key(key)); }
+    const Variant& value(const Key& key) const;
 
     /**
       Set the value associated with the specified key.
@@ -96,13 +138,18 @@ class Settings
       @param key  The key of the setting to lookup
       @return  The specific type value of the variant
     */
-    int getInt(const string& key) const     { return value(key).toInt();   }
-    float getFloat(const string& key) const { return value(key).toFloat(); }
-    bool getBool(const string& key) const   { return value(key).toBool();  }
+    int getInt(const string& key) const     { return getInt(Key(key));   }
+    float getFloat(const string& key) const { return getFloat(Key(key)); }
+    bool getBool(const string& key) const   { return getBool(Key(key));  }
     const string& getString(const string& key) const { return value(key).toString(); }
     const Common::Size getSize(const string& key) const { return value(key).toSize(); }
     const Common::Point getPoint(const string& key) const { return value(key).toPoint(); }
 
+    int getInt(const Key& key) const     { return setting(key).intValue;   }
+    float getFloat(const Key& key) const { return setting(key).floatValue; }
+    bool getBool(const Key& key) const   { return setting(key).boolValue;  }
+    const string& getString(const Key& key) const { return value(key).toString(); }
+
   protected:
     /**
       Add key/value pair to specified map.  Note that these should only be called
@@ -121,27 +168,49 @@ class Settings
               str.substr(first, str.find_last_not_of(' ')-first+1);
     }
 
-    // FIXME - Rework so that these aren't needed; hence no commenting added
-    const Options& getPermanentSettings() const
-      { return myPermanentSettings; }
-    const Options& getTemporarySettings() const
-      { return myTemporarySettings; }
-
   private:
+    struct Setting {
+      string key;
+      uInt64 id;
+      Variant value;
+
+      // The value converted to the numeric types
+      Int32 intValue;
+      float floatValue;
+      bool boolValue;
+
+      // Permanent settings are saved on each program exit
+      bool permanent;
+
+      // Whether the value changed since it was last loaded or saved
+      bool dirty;
+
+      void set(const Variant& v);
+    };
+
     /**
       This method must be called *after* settings have been fully loaded
       to validate (and change, if necessary) any improper settings.
     */
     void validate();
 
+    // Get the setting with the given key, or an empty one if none exists
+    const Setting& setting(const Key& key) const;
+
+    // Get the index of the setting with the given key, or -1 if none exists
+    Int32 find(const Key& key) const;
+
+    // Add a new setting, and return its index
+    uInt32 insert(const string& key, uInt64 id, bool permanent);
+
   private:
-    // Holds key/value pairs that are necessary for Stella to
-    // function and must be saved on each program exit.
-    Options myPermanentSettings;
+    // All settings, in the order they were added; a deque, so references
+    // returned by value() and getString() survive adding new settings
+    std::deque<Setting> mySettings;
 
-    // Holds auxiliary key/value pairs that shouldn't be saved on
-    // program exit.
-    Options myTemporarySettings;
+    // Open addressing hash table over the setting IDs; each slot holds
+    // the index into 'mySettings' plus one, or zero if it is empty
+    vector<uInt32> mySlots;
 
     shared_ptr<KeyValueRepository> myRespository;
 
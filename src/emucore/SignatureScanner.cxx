@@ -0,0 +1,144 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <cstring>
+#include <queue>
+
+#include "SignatureScanner.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+SignatureScanner::SignatureScanner(const vector<ByteArray>& signatures)
+{
+  // Build the trie of all signatures; 0 means 'no transition' for now,
+  // which is never ambiguous since no signature leads back to the root
+  vector<vector<uInt32>> outputs(1);
+  myTransitions.assign(256, 0);
+
+  for(uInt32 sig = 0; sig < signatures.size(); ++sig)
+  {
+    uInt32 state = 0;
+    for(uInt8 byte: signatures[sig])
+    {
+      if(myTransitions[state * 256 + byte] == 0)
+      {
+        myTransitions[state * 256 + byte] = uInt16(outputs.size());
+        myTransitions.resize(myTransitions.size() + 256, 0);
+        outputs.emplace_back();
+      }
+      state = myTransitions[state * 256 + byte];
+    }
+    outputs[state].push_back(sig);
+    mySizes.push_back(uInt32(signatures[sig].size()));
+  }
+
+  // Now add the failure transitions in breadth first order, so that the
+  // failure state of each state is complete before it is needed; this
+  // turns the trie into a DFA with a transition for every byte
+  vector<uInt32> failure(outputs.size(), 0);
+  std::queue<uInt32> pending;
+
+  for(uInt32 byte = 0; byte < 256; ++byte)
+    if(myTransitions[byte] != 0)
+      pending.push(myTransitions[byte]);
+
+  while(!pending.empty())
+  {
+    uInt32 state = pending.front();
+    pending.pop();
+
+    const vector<uInt32>& inherited = outputs[failure[state]];
+    outputs[state].insert(outputs[state].end(), inherited.begin(), inherited.end());
+
+    for(uInt32 byte = 0; byte < 256; ++byte)
+    {
+      uInt16& next = myTransitions[state * 256 + byte];
+      uInt16 fallback = myTransitions[failure[state] * 256 + byte];
+
+      if(next != 0)
+      {
+        failure[next] = fallback;
+        pending.push(next);
+      }
+      else
+        next = fallback;
+    }
+  }
+
+  // If all signatures start with the same byte, it can be searched for
+  // directly
+  for(uInt32 byte = 0; byte < 256; ++byte)
+    if(myTransitions[byte] != 0)
+      myFirstByte = myFirstByte == -1 ? Int32(byte) : -2;
+  if(myFirstByte == -2)
+    myFirstByte = -1;
+
+  // Flatten the outputs
+  for(const auto& out: outputs)
+  {
+    myOutputStart.push_back(uInt32(myOutputs.size()));
+    myOutputs.insert(myOutputs.end(), out.begin(), out.end());
+  }
+  myOutputStart.push_back(uInt32(myOutputs.size()));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<uInt32> SignatureScanner::scan(const uInt8* image, uInt32 size) const
+{
+  vector<uInt32> counts(mySizes.size(), 0);
+  // The first position at which each signature may be counted again
+  vector<uInt32> nextStart(mySizes.size(), 0);
+
+  uInt32 state = 0;
+  for(uInt32 i = 0; i < size; ++i)
+  {
+    // Outside of a partial match, skip straight to the next byte which
+    // starts a signature; memchr is vectorized by most C libraries
+    if(state == 0)
+    {
+      if(myFirstByte >= 0)
+      {
+        const void* next = std::memchr(image + i, myFirstByte, size - i);
+        if(next == nullptr)
+          break;
+        i = uInt32(static_cast<const uInt8*>(next) - image);
+      }
+      else
+      {
+        while(i < size && myTransitions[image[i]] == 0)
+          ++i;
+        if(i == size)
+          break;
+      }
+    }
+
+    state = myTransitions[state * 256 + image[i]];
+
+    for(uInt32 o = myOutputStart[state]; o < myOutputStart[state + 1]; ++o)
+    {
+      const uInt32 sig = myOutputs[o];
+      const uInt32 start = i + 1 - mySizes[sig];
+
+      if(start >= nextStart[sig] && i + 1 < size)
+      {
+        ++counts[sig];
+        nextStart[sig] = start + mySizes[sig] + 1;
+      }
+    }
+  }
+
+  return counts;
+}
@@ -0,0 +1,80 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef SIGNATURE_SCANNER_HXX
+#define SIGNATURE_SCANNER_HXX
+
+#include "bspf.hxx"
+
+/**
+  Searches a ROM image for any number of byte signatures at once, using
+  an Aho-Corasick automaton.  The automaton is built once for a fixed set
+  of signatures, and then finds all of them in a single pass over an
+  image, no matter how many signatures there are.
+
+  @author  Stephen Anthony
+*/
+class SignatureScanner
+{
+  public:
+    /**
+      Create a scanner for the given signatures.
+
+      @param signatures  The signatures to search for (none may be empty)
+    */
+    explicit SignatureScanner(const vector<ByteArray>& signatures);
+
+    /**
+      Count the occurrences of each signature in the given image.  This
+      counts in the same way as CartDetector::searchForBytes(): after a
+      hit, the following bytes up to the signature size are skipped, and
+      a signature ending on the last byte of the image isn't counted.
+
+      @param image  The image to search
+      @param size   The size of the image
+
+      @return  The number of hits for each signature, in the order given
+               to the constructor
+    */
+    vector<uInt32> scan(const uInt8* image, uInt32 size) const;
+
+  private:
+    // The transitions of the automaton, 256 per state; state 0 is the root
+    vector<uInt16> myTransitions;
+
+    // The signatures ending in each state (including those ending in
+    // shorter suffixes of it) are myOutputs[myOutputStart[s] ...
+    // myOutputStart[s+1]-1]
+    vector<uInt32> myOutputStart;
+    vector<uInt32> myOutputs;
+
+    // The size of each signature
+    vector<uInt32> mySizes;
+
+    // The first byte of all signatures, or -1 if they don't all share one
+    Int32 myFirstByte{-1};
+
+  private:
+    // Following constructors and assignment operators not supported
+    SignatureScanner() = delete;
+    SignatureScanner(const SignatureScanner&) = delete;
+    SignatureScanner(SignatureScanner&&) = delete;
+    SignatureScanner& operator=(const SignatureScanner&) = delete;
+    SignatureScanner& operator=(SignatureScanner&&) = delete;
+};
+
+#endif
@@ -0,0 +1,129 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <functional>
+#include <iomanip>
+
+#include "Serializable.hxx"
+#include "StateProfile.hxx"
+
+using namespace std::chrono;
+
+constexpr uInt32 StateProfile::NO_PARENT;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateProfile::StateProfile()
+  : myLoading(false),
+    myRuns(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateProfile::measure(Serializable& object, uInt32 runs)
+{
+  myComponents.clear();
+  myStack.clear();
+  myRuns = std::max(runs, 1u);
+
+  Serializer state;
+  state.setProfile(this);
+
+  myLoading = false;
+  for(uInt32 run = 0; run < myRuns; ++run)
+  {
+    state.rewind();
+
+    Scope scope(state, "Total");
+    if(!object.save(state))
+      return false;
+  }
+
+  // The state saved last is loaded every time, so nothing changes
+  myLoading = true;
+  for(uInt32 run = 0; run < myRuns; ++run)
+  {
+    state.rewind();
+
+    Scope scope(state, "Total");
+    if(!object.load(state))
+      return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string StateProfile::report() const
+{
+  ostringstream buf;
+  buf << std::left << std::setw(28) << "Component" << std::right
+      << std::setw(10) << "Bytes" << std::setw(12) << "Save (us)"
+      << std::setw(12) << "Load (us)";
+
+  const double runs = std::max(myRuns, 1u);
+  const std::function<void(uInt32)> children = [&](uInt32 parent) {
+    for(uInt32 i = 0; i < myComponents.size(); ++i)
+    {
+      const Component& c = myComponents[i];
+      if(c.parent != parent)
+        continue;
+
+      buf << "\n" << std::left << std::setw(28)
+          << (string(2 * c.depth, ' ') + c.name) << std::right
+          << std::setw(10) << uInt64((c.bytes[0] ? c.bytes[0] : c.bytes[1]) / runs)
+          << std::fixed << std::setprecision(2)
+          << std::setw(12) << c.seconds[0] * 1e6 / runs
+          << std::setw(12) << c.seconds[1] * 1e6 / runs;
+      children(i);
+    }
+  };
+  children(NO_PARENT);
+
+  return buf.str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateProfile::enter(const Serializer& serializer, const char* name)
+{
+  const uInt32 parent = myStack.empty() ? NO_PARENT : myStack.back().component;
+
+  // Components saved more than once (e.g. the paddle readers) add up
+  uInt32 i = 0;
+  while(i < myComponents.size() &&
+        (myComponents[i].parent != parent || myComponents[i].name != name))
+    ++i;
+
+  if(i == myComponents.size())
+    myComponents.push_back({ name, parent, uInt32(myStack.size()), { 0, 0 }, { 0, 0 } });
+
+  myStack.push_back({ i, &serializer,
+                      myLoading ? serializer.readPosition() : serializer.size(),
+                      Clock::now() });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StateProfile::leave()
+{
+  const Measurement& m = myStack.back();
+  Component& c = myComponents[m.component];
+  const size_t position = myLoading ? m.serializer->readPosition() : m.serializer->size();
+
+  c.bytes[myLoading] += position - m.position;
+  c.seconds[myLoading] += duration<double>(Clock::now() - m.start).count();
+
+  myStack.pop_back();
+}
@@ -0,0 +1,144 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef STATE_PROFILE_HXX
+#define STATE_PROFILE_HXX
+
+class Serializable;
+
+#include <chrono>
+
+#include "bspf.hxx"
+#include "Serializer.hxx"
+
+/**
+  Measures the size and the save/load time of the state of each component
+  (M6502, M6532, TIA and its objects, cartridge, controllers ...), e.g. to
+  find the cartridges with a large state, which is what the time machine
+  and the run-ahead have to store and restore for every frame.
+
+  The components are measured when a Serializer with a profile attached
+  saves or loads them through StateProfile::save() / load(); without a
+  profile, this costs a single test.  Components nest, so each one
+  includes the ones it saves itself.
+
+  @author  Stephen Anthony
+*/
+class StateProfile
+{
+  public:
+    /**
+      Measures the component saved or loaded while the object lives.
+    */
+    class Scope
+    {
+      public:
+        Scope(const Serializer& serializer, const char* name)
+          : myProfile(serializer.profile())
+        {
+          if(myProfile) myProfile->enter(serializer, name);
+        }
+        ~Scope()
+        {
+          if(myProfile) myProfile->leave();
+        }
+
+      private:
+        StateProfile* myProfile;
+
+      private:
+        // Following constructors and assignment operators not supported
+        Scope() = delete;
+        Scope(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope& operator=(Scope&&) = delete;
+    };
+
+    /**
+      Save/load a component, measured under the given name.
+    */
+    template<class T>
+    static bool save(const T& object, Serializer& out, const char* name)
+    {
+      Scope scope(out, name);
+      return object.save(out);
+    }
+    template<class T>
+    static bool load(T& object, Serializer& in, const char* name)
+    {
+      Scope scope(in, name);
+      return object.load(in);
+    }
+
+  public:
+    StateProfile();
+
+    /**
+      Save the state of the object the given number of times, and load it
+      back as often; the object is left in the state it had before.
+
+      @return  False if the state couldn't be saved or loaded
+    */
+    bool measure(Serializable& object, uInt32 runs);
+
+    /**
+      The state size and the average save/load time of each component,
+      as a table.
+    */
+    string report() const;
+
+  private:
+    using Clock = std::chrono::high_resolution_clock;
+
+    static constexpr uInt32 NO_PARENT = ~0u;
+
+    struct Component {
+      string name;
+      uInt32 parent;
+      uInt32 depth;
+      uInt64 bytes[2];     // saved, loaded
+      double seconds[2];
+    };
+
+    struct Measurement {
+      uInt32 component;
+      const Serializer* serializer;
+      size_t position;
+      Clock::time_point start;
+    };
+
+    void enter(const Serializer& serializer, const char* name);
+    void leave();
+
+  private:
+    // In the order they are first saved, i.e. depth first
+    vector<Component> myComponents;
+    vector<Measurement> myStack;
+
+    bool myLoading;
+    uInt32 myRuns;
+
+  private:
+    // Following constructors and assignment operators not supported
+    StateProfile(const StateProfile&) = delete;
+    StateProfile(StateProfile&&) = delete;
+    StateProfile& operator=(const StateProfile&) = delete;
+    StateProfile& operator=(StateProfile&&) = delete;
+};
+
+#endif
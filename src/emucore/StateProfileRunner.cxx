@@ -0,0 +1,103 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "FSNode.hxx"
+#include "HeadlessConsole.hxx"
+#include "Settings.hxx"
+#include "StateProfile.hxx"
+#include "StateProfileRunner.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+StateProfileRunner::StateProfileRunner(int argc, char* argv[])
+  : myFrames(600),
+    myRuns(1000)
+{
+  int arg = 2;
+  for(; argc > arg + 1; arg += 2)
+  {
+    if(string(argv[arg]) == "-frames") myFrames = uInt32(std::max(atoi(argv[arg + 1]), 0));
+    else if(string(argv[arg]) == "-runs") myRuns = uInt32(std::max(atoi(argv[arg + 1]), 1));
+    else break;
+  }
+
+  for(; arg < argc; ++arg)
+    myRomFiles.emplace_back(argv[arg]);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateProfileRunner::run()
+{
+  if(myRomFiles.empty())
+  {
+    cout << "usage: stella -stateprofile [-frames <n>] [-runs <n>] <rom> ..."
+         << endl;
+    return false;
+  }
+
+  bool ok = true;
+  for(const string& romFile: myRomFiles)
+    ok = profile(romFile) && ok;
+
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StateProfileRunner::profile(const string& romFile) const
+{
+  FilesystemNode node(romFile);
+  ByteBuffer image;
+  const uInt32 size = node.isFile() ? uInt32(node.read(image)) : 0;
+  if(size == 0)
+  {
+    cout << "ERROR: unable to read ROM '" << romFile << "'" << endl;
+    return false;
+  }
+
+  try
+  {
+    // The default settings are used, as in all headless runs
+    Settings settings;
+    HeadlessConsole console(image, size, settings);
+
+    for(uInt32 frame = 0; frame < myFrames; ++frame)
+    {
+      if(!console.step())
+      {
+        cout << "ERROR: " << node.getName() << ": emulation failed in frame "
+             << frame << endl;
+        return false;
+      }
+    }
+
+    StateProfile profile;
+    if(!profile.measure(console, myRuns))
+    {
+      cout << "ERROR: " << node.getName() << ": unable to save/load state" << endl;
+      return false;
+    }
+
+    cout << node.getName() << " (after " << myFrames << " frames, average of "
+         << myRuns << " runs)" << endl << profile.report() << endl << endl;
+  }
+  catch(const runtime_error& e)
+  {
+    cout << "ERROR: " << node.getName() << ": " << e.what() << endl;
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,57 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef STATE_PROFILE_RUNNER_HXX
+#define STATE_PROFILE_RUNNER_HXX
+
+#include "bspf.hxx"
+
+/**
+  Reports the state size and the save/load time of each component of the
+  console (see StateProfile) for one or more ROMs, headless:
+
+    stella -stateprofile [-frames <n>] [-runs <n>] <rom> ...
+
+  Each ROM is run by a HeadlessConsole for the given number of frames (by
+  default 600), so the cartridge has set up its state, without any input.
+  The state is then saved and loaded 'runs' times (by default 1000).
+*/
+class StateProfileRunner
+{
+  public:
+    StateProfileRunner(int argc, char* argv[]);
+
+    bool run();
+
+  private:
+    bool profile(const string& romFile) const;
+
+  private:
+    vector<string> myRomFiles;
+    uInt32 myFrames;
+    uInt32 myRuns;
+
+  private:
+    // Following constructors and assignment operators not supported
+    StateProfileRunner() = delete;
+    StateProfileRunner(const StateProfileRunner&) = delete;
+    StateProfileRunner(StateProfileRunner&&) = delete;
+    StateProfileRunner& operator=(const StateProfileRunner&) = delete;
+    StateProfileRunner& operator=(StateProfileRunner&&) = delete;
+};
+
+#endif // STATE_PROFILE_RUNNER_HXX
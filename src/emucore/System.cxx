@@ -24,6 +24,7 @@
 #include "TIA.hxx"
 #include "Cart.hxx"
 #include "TimerManager.hxx"
+#include "StateProfile.hxx"
 #include "System.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -35,9 +36,12 @@ System::System(Random& random, M6502& m6502, M6532& m6532,
     myTIA(mTIA),
     myCart(mCart),
     myCycles(0),
+    myNextDeadline(ULLONG_MAX),
     myDataBusState(0),
     myDataBusLocked(false),
-    mySystemInAutodetect(false)
+    myAccessFlagsEnabled(false),
+    mySystemInAutodetect(false),
+    myZone(Zone::none)
 {
   // Initialize page access table
   PageAccess access(&myNullDevice, System::PageAccessType::READ);
@@ -69,6 +73,7 @@ void System::reset(bool autodetect)
 
   // Reset all devices
   myCycles = 0;     // Must be done first (the reset() methods may use its value)
+  clearDeadlines();
   myM6532.reset();
   myTIA.reset();
   myCart.reset();
@@ -78,6 +83,54 @@ void System::reset(bool autodetect)
   clearDirtyPages();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::scheduleDeadline(Device& device, uInt64 cycle)
+{
+  cancelDeadline(device);
+
+  myDeadlines.push_back({ cycle, &device });
+  std::push_heap(myDeadlines.begin(), myDeadlines.end(), laterDeadline);
+  myNextDeadline = myDeadlines.front().cycle;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::cancelDeadline(Device& device)
+{
+  // There are only a few devices, so a linear search is fine
+  for(size_t i = 0; i < myDeadlines.size(); ++i)
+  {
+    if(myDeadlines[i].device == &device)
+    {
+      myDeadlines.erase(myDeadlines.begin() + i);
+      std::make_heap(myDeadlines.begin(), myDeadlines.end(), laterDeadline);
+      myNextDeadline = myDeadlines.empty() ? ULLONG_MAX : myDeadlines.front().cycle;
+      return;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::dispatchDeadlines()
+{
+  while(!myDeadlines.empty() && myDeadlines.front().cycle <= myCycles)
+  {
+    std::pop_heap(myDeadlines.begin(), myDeadlines.end(), laterDeadline);
+    const Deadline deadline = myDeadlines.back();
+    myDeadlines.pop_back();
+    myNextDeadline = myDeadlines.empty() ? ULLONG_MAX : myDeadlines.front().cycle;
+
+    // The device may schedule its next deadline right away
+    deadline.device->deadlineReached(deadline.cycle);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::clearDeadlines()
+{
+  myDeadlines.clear();
+  myNextDeadline = ULLONG_MAX;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void System::consoleChanged(ConsoleTiming timing)
 {
@@ -106,67 +159,6 @@ void System::clearDirtyPages()
     myPageIsDirtyTable[i] = false;
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8 System::peek(uInt16 addr, uInt8 flags)
-{
-  const PageAccess& access = getPageAccess(addr);
-
-#ifdef DEBUGGER_SUPPORT
-  // Set access type
-  if(access.codeAccessBase)
-    *(access.codeAccessBase + (addr & PAGE_MASK)) |= flags;
-  else
-    access.device->setAccessFlags(addr, flags);
-#endif
-
-  // See if this page uses direct accessing or not
-  uInt8 result;
-  if(access.directPeekBase)
-    result = *(access.directPeekBase + (addr & PAGE_MASK));
-  else
-    result = access.device->peek(addr);
-
-#ifdef DEBUGGER_SUPPORT
-  if(!myDataBusLocked)
-#endif
-    myDataBusState = result;
-
-  return result;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void System::poke(uInt16 addr, uInt8 value, uInt8 flags)
-{
-  uInt16 page = (addr & ADDRESS_MASK) >> PAGE_SHIFT;
-  const PageAccess& access = myPageAccessTable[page];
-
-#ifdef DEBUGGER_SUPPORT
-  // Set access type
-  if (access.codeAccessBase)
-    *(access.codeAccessBase + (addr & PAGE_MASK)) |= flags;
-  else
-    access.device->setAccessFlags(addr, flags);
-#endif
-
-  // See if this page uses direct accessing or not
-  if(access.directPokeBase)
-  {
-    // Since we have direct access to this poke, we can dirty its page
-    *(access.directPokeBase + (addr & PAGE_MASK)) = value;
-    myPageIsDirtyTable[page] = true;
-  }
-  else
-  {
-    // The specific device informs us if the poke succeeded
-    myPageIsDirtyTable[page] = access.device->poke(addr, value);
-  }
-
-#ifdef DEBUGGER_SUPPORT
-  if(!myDataBusLocked)
-#endif
-    myDataBusState = value;
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 System::getAccessFlags(uInt16 addr) const
 {
@@ -186,6 +178,9 @@ uInt8 System::getAccessFlags(uInt16 addr) const
 void System::setAccessFlags(uInt16 addr, uInt8 flags)
 {
 #ifdef DEBUGGER_SUPPORT
+  if(!myAccessFlagsEnabled)
+    return;
+
   const PageAccess& access = getPageAccess(addr);
 
   if(access.codeAccessBase)
@@ -204,15 +199,15 @@ bool System::save(Serializer& out) const
     out.putByte(myDataBusState);
 
     // Save the state of each device
-    if(!myM6502.save(out))
+    if(!StateProfile::save(myM6502, out, "M6502"))
       return false;
-    if(!myM6532.save(out))
+    if(!StateProfile::save(myM6532, out, "M6532"))
       return false;
-    if(!myTIA.save(out))
+    if(!StateProfile::save(myTIA, out, "TIA"))
       return false;
-    if(!myCart.save(out))
+    if(!StateProfile::save(myCart, out, "Cartridge"))
       return false;
-    if(!randGenerator().save(out))
+    if(!StateProfile::save(randGenerator(), out, "Random"))
       return false;
   }
   catch(...)
@@ -231,17 +226,18 @@ bool System::load(Serializer& in)
   {
     myCycles = in.getLong();
     myDataBusState = in.getByte();
+    clearDeadlines();
 
     // Load the state of each device
-    if(!myM6502.load(in))
+    if(!StateProfile::load(myM6502, in, "M6502"))
       return false;
-    if(!myM6532.load(in))
+    if(!StateProfile::load(myM6532, in, "M6532"))
       return false;
-    if(!myTIA.load(in))
+    if(!StateProfile::load(myTIA, in, "TIA"))
       return false;
-    if(!myCart.load(in))
+    if(!StateProfile::load(myCart, in, "Cartridge"))
       return false;
-    if(!randGenerator().load(in))
+    if(!StateProfile::load(randGenerator(), in, "Random"))
       return false;
   }
   catch(...)
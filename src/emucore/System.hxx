@@ -24,11 +24,14 @@ class M6532;
 class TIA;
 class NullDevice;
 
+#include <atomic>
+
 #include "bspf.hxx"
 #include "Device.hxx"
 #include "NullDev.hxx"
 #include "Random.hxx"
 #include "Serializable.hxx"
+#include "PerfCounters.hxx"
 
 /**
   This class represents a system consisting of a 6502 microprocessor
@@ -150,6 +153,36 @@ class System : public Serializable
     */
     void incrementCycles(uInt32 amount) { myCycles += amount; }
 
+    /**
+      Schedule a call of the device's deadlineReached() method once the
+      system cycles reach the given cycle, replacing the deadline the device
+      has scheduled before (if any).  Instead of every device checking the
+      elapsed cycles, the CPU only compares the cycles with the earliest
+      deadline after each instruction.
+
+      All deadlines are dropped when the system is reset or its state is
+      loaded; devices must schedule them again from reset() and load().
+
+      @param device  The device to notify
+      @param cycle   The cycle at which to notify it
+    */
+    void scheduleDeadline(Device& device, uInt64 cycle);
+
+    /**
+      Remove the deadline scheduled by the given device (if any).
+    */
+    void cancelDeadline(Device& device);
+
+    /**
+      The earliest deadline scheduled (ULLONG_MAX if there is none).
+    */
+    uInt64 nextDeadline() const { return myNextDeadline; }
+
+    /**
+      Notify the devices whose deadlines have been reached.
+    */
+    void dispatchDeadlines();
+
     /**
       Informs all attached devices that the console type has changed.
     */
@@ -160,6 +193,37 @@ class System : public Serializable
     */
     bool autodetectMode() const { return mySystemInAutodetect; }
 
+    /**
+      The part of the system which is currently being emulated.  This is
+      only tracked for sampling profilers (see ProfilingRunner), which read
+      it from another thread; marking a zone is just a relaxed store.
+    */
+    enum class Zone : uInt8 { none, cpu, tia, arm, numZones };
+
+    Zone zone() const { return myZone.load(std::memory_order_relaxed); }
+
+    /**
+      Marks a zone as being emulated for the lifetime of the guard, and
+      restores the previous zone afterwards.
+    */
+    class ZoneGuard {
+      public:
+        ZoneGuard(System& system, Zone zone)
+          : mySystem(system), myPreviousZone(system.zone()) {
+          mySystem.myZone.store(zone, std::memory_order_relaxed);
+        }
+        ~ZoneGuard() { mySystem.myZone.store(myPreviousZone, std::memory_order_relaxed); }
+
+      private:
+        System& mySystem;
+        Zone myPreviousZone;
+
+      private:
+        ZoneGuard() = delete;
+        ZoneGuard(const ZoneGuard&) = delete;
+        ZoneGuard& operator=(const ZoneGuard&) = delete;
+    };
+
   public:
     /**
       Get the current state of the data bus in the system.  The current
@@ -169,6 +233,14 @@ class System : public Serializable
     */
     uInt8 getDataBusState() const { return myDataBusState; }
 
+    /**
+      Set the state of the data bus, after accesses which were made
+      directly rather than through peek() and poke().
+
+      @param value  The data last accessed
+    */
+    void setDataBusState(uInt8 value) { myDataBusState = value; }
+
     /**
       Get the current state of the data bus in the system, taking into
       account that certain bits are in Z-state (undriven).  In those
@@ -202,7 +274,7 @@ class System : public Serializable
 
       @return The byte at the specified address
     */
-    uInt8 peek(uInt16 address, uInt8 flags = 0);
+    inline uInt8 peek(uInt16 address, uInt8 flags = 0);
 
     /**
       Change the byte at the specified address to the given value.
@@ -217,7 +289,7 @@ class System : public Serializable
       @param address  The address where the value should be stored
       @param value    The value to be stored at the address
     */
-    void poke(uInt16 address, uInt8 value, uInt8 flags = 0);
+    inline void poke(uInt16 address, uInt8 value, uInt8 flags = 0);
 
     /**
       Lock/unlock the data bus. When the bus is locked, peek() and
@@ -239,6 +311,17 @@ class System : public Serializable
     uInt8 getAccessFlags(uInt16 address) const;
     void setAccessFlags(uInt16 address, uInt8 flags);
 
+  #ifdef DEBUGGER_SUPPORT
+    /**
+      Enable/disable tracking the access flags in peek() and poke().  This
+      costs time on every access, so it is only enabled when the flags are
+      going to be used (with the developer settings, or while the debugger
+      is open); it is disabled by default.
+    */
+    void enableAccessFlags(bool enable) { myAccessFlagsEnabled = enable; }
+    bool accessFlagsEnabled() const { return myAccessFlagsEnabled; }
+  #endif
+
   public:
     /**
       Describes how a page can be accessed
@@ -285,6 +368,15 @@ class System : public Serializable
       */
       Device* device;
 
+      /**
+        Functions used to forward reads and writes to the device if there
+        is no direct peek and poke base, respectively.  These dispatch
+        through the virtual Device::peek and Device::poke methods unless
+        direct dispatch was requested (see below).
+      */
+      Device::PeekHandler peekHandler;
+      Device::PokeHandler pokeHandler;
+
       /**
         The manner in which the pages are accessed by the system
         (READ, WRITE, READWRITE)
@@ -297,6 +389,8 @@ class System : public Serializable
           directPokeBase(nullptr),
           codeAccessBase(nullptr),
           device(nullptr),
+          peekHandler(&Device::virtualPeek),
+          pokeHandler(&Device::virtualPoke),
           type(System::PageAccessType::READ) { }
 
       PageAccess(Device* dev, PageAccessType access)
@@ -304,7 +398,18 @@ class System : public Serializable
           directPokeBase(nullptr),
           codeAccessBase(nullptr),
           device(dev),
+          peekHandler(&Device::virtualPeek),
+          pokeHandler(&Device::virtualPoke),
           type(access) { }
+
+      /**
+        Forward accesses straight to T::peek and T::poke, bypassing the
+        vtable.  T must be the most derived type of the device.
+      */
+      template<class T> void useDirectDispatch() {
+        peekHandler = &Device::directPeek<T>;
+        pokeHandler = &Device::directPoke<T>;
+      }
     };
 
     /**
@@ -317,6 +422,18 @@ class System : public Serializable
       myPageAccessTable[(addr & ADDRESS_MASK) >> PAGE_SHIFT] = access;
     }
 
+    /**
+      Set the page accessing methods for a number of consecutive pages.
+
+      @param addr   The address of the first page
+      @param access The accessing methods to be used by the pages
+      @param count  The number of pages
+    */
+    void setPageAccess(uInt16 addr, const PageAccess* access, uInt16 count) {
+      std::copy(access, access + count,
+                &myPageAccessTable[(addr & ADDRESS_MASK) >> PAGE_SHIFT]);
+    }
+
     /**
       Get the page accessing method for the specified address.
 
@@ -376,6 +493,20 @@ class System : public Serializable
     */
     bool load(Serializer& in) override;
 
+  private:
+    struct Deadline {
+      uInt64 cycle;
+      Device* device;
+    };
+
+    // Order of the deadline heap, which has the earliest deadline on top
+    static bool laterDeadline(const Deadline& a, const Deadline& b) {
+      return a.cycle > b.cycle;
+    }
+
+    // Drop all deadlines (on reset and when loading a state)
+    void clearDeadlines();
+
   private:
     // The system RNG
     Random& myRandom;
@@ -395,6 +526,11 @@ class System : public Serializable
     // Number of system cycles executed since last reset
     uInt64 myCycles;
 
+    // The deadlines scheduled by the devices, as a min-heap by cycle, and
+    // the earliest of them
+    vector<Deadline> myDeadlines;
+    uInt64 myNextDeadline;
+
     // Null device to use for page which are not installed
     NullDevice myNullDevice;
 
@@ -412,11 +548,17 @@ class System : public Serializable
     // debugger is active.
     bool myDataBusLocked;
 
+    // Whether or not peek() and poke() track the access flags
+    bool myAccessFlagsEnabled;
+
     // Whether autodetection is currently running (ie, the emulation
     // core is attempting to autodetect display settings, cart modes, etc)
     // Some parts of the codebase need to act differently in such a case
     bool mySystemInAutodetect;
 
+    // The zone currently being emulated
+    std::atomic<Zone> myZone;
+
   private:
     // Following constructors and assignment operators not supported
     System() = delete;
@@ -426,4 +568,79 @@ class System : public Serializable
     System& operator=(System&&) = delete;
 };
 
+// ############################################################################
+// Implementation
+// ############################################################################
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 System::peek(uInt16 addr, uInt8 flags)
+{
+  const PageAccess& access = getPageAccess(addr);
+
+#ifdef DEBUGGER_SUPPORT
+  // Set access type
+  if(myAccessFlagsEnabled)
+  {
+    if(access.codeAccessBase)
+      *(access.codeAccessBase + (addr & PAGE_MASK)) |= flags;
+    else
+      access.device->setAccessFlags(addr, flags);
+  }
+#endif
+
+  // See if this page uses direct accessing or not
+  uInt8 result;
+  if(access.directPeekBase)
+    result = *(access.directPeekBase + (addr & PAGE_MASK));
+  else
+  {
+    PERF_COUNT(systemDevicePeek);
+    result = access.peekHandler(*access.device, addr);
+  }
+
+#ifdef DEBUGGER_SUPPORT
+  if(!myDataBusLocked)
+#endif
+    myDataBusState = result;
+
+  return result;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::poke(uInt16 addr, uInt8 value, uInt8 flags)
+{
+  uInt16 page = (addr & ADDRESS_MASK) >> PAGE_SHIFT;
+  const PageAccess& access = myPageAccessTable[page];
+
+#ifdef DEBUGGER_SUPPORT
+  // Set access type
+  if(myAccessFlagsEnabled)
+  {
+    if(access.codeAccessBase)
+      *(access.codeAccessBase + (addr & PAGE_MASK)) |= flags;
+    else
+      access.device->setAccessFlags(addr, flags);
+  }
+#endif
+
+  // See if this page uses direct accessing or not
+  if(access.directPokeBase)
+  {
+    // Since we have direct access to this poke, we can dirty its page
+    *(access.directPokeBase + (addr & PAGE_MASK)) = value;
+    myPageIsDirtyTable[page] = true;
+  }
+  else
+  {
+    // The specific device informs us if the poke succeeded
+    PERF_COUNT(systemDevicePoke);
+    myPageIsDirtyTable[page] = access.pokeHandler(*access.device, addr, value);
+  }
+
+#ifdef DEBUGGER_SUPPORT
+  if(!myDataBusLocked)
+#endif
+    myDataBusState = value;
+}
+
 #endif
@@ -17,6 +17,12 @@
 
 #include <cmath>
 
+#include "CpuFeatures.hxx"
+
+#ifdef CPU_X86_KERNELS
+  #include <immintrin.h>
+#endif
+
 #include "FBSurface.hxx"
 #include "Settings.hxx"
 #include "OSystem.hxx"
@@ -25,18 +31,131 @@
 #include "PNGLibrary.hxx"
 #include "TIASurface.hxx"
 
+constexpr uInt32 TIASurface::TIMING_WIDTH;
+
+namespace {
+  // The phosphor kernels blend as many pixels of a line as they can handle
+  // at once, and return how many; renderPhosphorLine() does the rest.  The
+  // decay uses the same single precision multiply and truncation as
+  // getPhosphor(), so the result is identical to the lookup table.
+
+#ifdef CPU_X86_KERNELS
+  CPU_TARGET("sse2")
+  inline __m128i decaySSE2(const __m128i v, const __m128 percent)
+  {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo = _mm_cvttps_epi32(
+        _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero)), percent));
+    const __m128i hi = _mm_cvttps_epi32(
+        _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero)), percent));
+    return _mm_packs_epi32(lo, hi);
+  }
+
+  // Four pixels at a time
+  CPU_TARGET("sse2")
+  uInt32 phosphorSSE2(const uInt8* tiaIn, uInt32* rgbIn, uInt32* out,
+                      uInt32 width, const uInt32* palette, float percent)
+  {
+    const __m128 factor = _mm_set1_ps(percent);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rgbMask = _mm_set1_epi32(0x00ffffff);
+
+    uInt32 x = 0;
+    for(; x + 4 <= width; x += 4)
+    {
+      const __m128i c = _mm_set_epi32(
+          Int32(palette[tiaIn[x + 3]]), Int32(palette[tiaIn[x + 2]]),
+          Int32(palette[tiaIn[x + 1]]), Int32(palette[tiaIn[x]]));
+      const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgbIn + x));
+
+      const __m128i d = _mm_packus_epi16(decaySSE2(_mm_unpacklo_epi8(p, zero), factor),
+                                         decaySSE2(_mm_unpackhi_epi8(p, zero), factor));
+      const __m128i n = _mm_and_si128(_mm_max_epu8(c, d), rgbMask);
+
+      // Store back into displayed frame buffer (for next frame)
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(rgbIn + x), n);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x), n);
+    }
+    return x;
+  }
+
+  CPU_TARGET("avx2")
+  inline __m256i decayAVX2(const __m256i v, const __m256 percent)
+  {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i lo = _mm256_cvttps_epi32(
+        _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_unpacklo_epi16(v, zero)), percent));
+    const __m256i hi = _mm256_cvttps_epi32(
+        _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_unpackhi_epi16(v, zero)), percent));
+    return _mm256_packs_epi32(lo, hi);
+  }
+
+  // Eight pixels at a time, gathering the colors from the palette; the
+  // unpacking and packing work within 128 bit lanes, so the order of the
+  // pixels is kept
+  CPU_TARGET("avx2")
+  uInt32 phosphorAVX2(const uInt8* tiaIn, uInt32* rgbIn, uInt32* out,
+                      uInt32 width, const uInt32* palette, float percent)
+  {
+    const __m256 factor = _mm256_set1_ps(percent);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i rgbMask = _mm256_set1_epi32(0x00ffffff);
+
+    uInt32 x = 0;
+    for(; x + 8 <= width; x += 8)
+    {
+      const __m256i index = _mm256_cvtepu8_epi32(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(tiaIn + x)));
+      const __m256i c = _mm256_i32gather_epi32(
+          reinterpret_cast<const int*>(palette), index, 4);
+      const __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgbIn + x));
+
+      const __m256i d = _mm256_packus_epi16(decayAVX2(_mm256_unpacklo_epi8(p, zero), factor),
+                                            decayAVX2(_mm256_unpackhi_epi8(p, zero), factor));
+      const __m256i n = _mm256_and_si256(_mm256_max_epu8(c, d), rgbMask);
+
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgbIn + x), n);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + x), n);
+    }
+    return x;
+  }
+#endif
+
+  uInt32 phosphorScalar(const uInt8*, uInt32*, uInt32*, uInt32, const uInt32*, float)
+  {
+    return 0;
+  }
+
+  const CpuFeatures::Variant<TIASurface::PhosphorKernel> phosphorKernels[] = {
+  #ifdef CPU_X86_KERNELS
+    { "avx2",   CpuFeatures::AVX2, phosphorAVX2 },
+    { "sse2",   CpuFeatures::SSE2, phosphorSSE2 },
+  #endif
+    { "scalar", CpuFeatures::NONE, phosphorScalar }
+  };
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TIASurface::TIASurface(OSystem& system)
   : myOSystem(system),
     myFB(system.frameBuffer()),
     myTIA(nullptr),
+    myLineTimingEnabled(false),
+    myOverrunColor(0),
     myFilter(Filter::Normal),
     myUsePhosphor(false),
+    myHWPhosphor(false),
     myPhosphorPercent(0.60f),
     myScanlinesEnabled(false),
     myPalette(nullptr),
-    mySaveSnapFlag(false)
+    myRGBPalette(nullptr),
+    mySaveSnapFlag(false),
+    myRenderAll(true),
+    myDirectRender(false),
+    myDirectFrame(false)
 {
+  myPhosphorKernel = CpuFeatures::select("phosphor", phosphorKernels);
+
   // Load NTSC filter settings
   myNTSCFilter.loadConfig(myOSystem.settings());
 
@@ -58,10 +177,25 @@ TIASurface::TIASurface(OSystem& system)
   myBaseTiaSurface = myFB.allocateSurface(TIAConstants::frameBufferWidth*2,
                                           TIAConstants::frameBufferHeight);
 
+  // Cycle budget overlay, blended over the right edge of the TIA image
+  myTimingSurface = myFB.allocateSurface(TIMING_WIDTH, TIAConstants::frameBufferHeight);
+  FBSurface::Attributes& timing_attr = myTimingSurface->attributes();
+  timing_attr.smoothing  = false;
+  timing_attr.blending   = true;
+  timing_attr.blendalpha = 80;
+  myTimingSurface->applyAttributes();
+
   memset(myRGBFramebuffer, 0, sizeof(myRGBFramebuffer));
+  memset(myTimingColors, 0, sizeof(myTimingColors));
 
-  // Enable/disable threading in the NTSC TV effects renderer
-  myNTSCFilter.enableThreading(myOSystem.settings().getBool("threads"));
+  // Enable/disable threading in the NTSC TV effects and phosphor renderers
+  myNTSCFilter.setThreadPool(&myThreadPool);
+  myThreadPool.setPlacement(
+    ThreadPlacement::fromSettings(myOSystem.settings(), "threads"), "filter");
+  enableThreading(myOSystem.settings().getBool("threads"));
+
+  // Render straight into the texture memory, if the surface supports it
+  myDirectRender = myOSystem.settings().getBool("tia.direct");
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -69,12 +203,31 @@ void TIASurface::initialize(const Console& console,
                             const FrameBuffer::VideoMode& mode)
 {
   myTIA = &(console.tia());
+  myRenderAll = true;
 
   myTiaSurface->setDstPos(mode.image.x(), mode.image.y());
   myTiaSurface->setDstSize(mode.image.w(), mode.image.h());
   mySLineSurface->setDstPos(mode.image.x(), mode.image.y());
   mySLineSurface->setDstSize(mode.image.w(), mode.image.h());
 
+  // The cycle budget overlay covers about a quarter of the image, and
+  // follows its scanlines
+  const uInt32 timingWidth = mode.image.w() * TIMING_WIDTH /
+                             (2 * TIAConstants::frameBufferWidth);
+  myTimingSurface->setSrcSize(TIMING_WIDTH, myTIA->height());
+  myTimingSurface->setDstPos(mode.image.x() + mode.image.w() - timingWidth, mode.image.y());
+  myTimingSurface->setDstSize(timingWidth, mode.image.h());
+
+  // Green for idle lines, through yellow to red for lines using all cycles
+  for(uInt32 cycles = 0; cycles <= TIMING_WIDTH; ++cycles)
+  {
+    const uInt32 heat = cycles * 510 / TIMING_WIDTH;
+    myTimingColors[cycles] = myFB.mapRGB(uInt8(std::min(heat, 255u)),
+                                         uInt8(std::min(510 - heat, 255u)), 0);
+  }
+  myOverrunColor = myFB.mapRGB(255, 0, 255);
+  myTIA->enableLineTiming(myLineTimingEnabled);
+
   // Phosphor mode can be enabled either globally or per-ROM
   int p_blend = 0;
   bool enable = false;
@@ -117,6 +270,8 @@ cerr << "SLine:\n"
 void TIASurface::setPalette(const uInt32* tia_palette, const uInt32* rgb_palette)
 {
   myPalette = tia_palette;
+  myRGBPalette = rgb_palette;
+  myRenderAll = true;
 
   // The NTSC filtering needs access to the raw RGB data, since it calculates
   // its own internal palette
@@ -124,7 +279,7 @@ void TIASurface::setPalette(const uInt32* tia_palette, const uInt32* rgb_palette
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-const FBSurface& TIASurface::baseSurface(Common::Rect& rect) const
+const FBSurface& TIASurface::baseSurface(Common::Rect& rect)
 {
   uInt32 tiaw = myTIA->width(), width = tiaw * 2, height = myTIA->height();
   rect.setBounds(0, 0, width, height);
@@ -135,6 +290,10 @@ const FBSurface& TIASurface::baseSurface(Common::Rect& rect) const
   double blarggXFactor = double(blarggPitch) / width;
   bool useBlargg = ntscEnabled();
 
+  // The last image went to the texture directly, so filter it again
+  if(useBlargg && myDirectFrame)
+    myNTSCFilter.render(myTIA->frameBuffer(), tiaw, height, blarggBuf, blarggPitch << 2);
+
   // Fill the surface with pixels from the TIA, scaled 2x horizontally
   uInt32 *buf_ptr, pitch;
   myBaseTiaSurface->basePtr(buf_ptr, pitch);
@@ -217,6 +376,7 @@ void TIASurface::enablePhosphor(bool enable, int blend)
   myFilter = Filter(enable ? uInt8(myFilter) | 0x01 : uInt8(myFilter) & 0x10);
 
   memset(myRGBFramebuffer, 0, sizeof(myRGBFramebuffer));
+  updatePersistence();
 
   // Precalculate the average colors for the 'phosphor' effect
   if(myUsePhosphor)
@@ -229,6 +389,17 @@ void TIASurface::enablePhosphor(bool enable, int blend)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASurface::updatePersistence()
+{
+  // Only the plain phosphor filter can be blended by the surface; the
+  // NTSC filter blends its own output
+  const bool enable = myFilter == Filter::Phosphor &&
+                      myOSystem.settings().getBool("tv.phoshw");
+
+  myHWPhosphor = myTiaSurface->enablePersistence(enable, myPhosphorPercent) && enable;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline uInt32 TIASurface::getRGBPhosphor(const uInt32 c, const uInt32 p) const
 {
@@ -246,10 +417,21 @@ inline uInt32 TIASurface::getRGBPhosphor(const uInt32 c, const uInt32 p) const
   return (rn << 16) | (gn << 8) | bn;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASurface::renderPhosphorLine(const uInt8* tiaIn, uInt32* rgbIn,
+                                    uInt32* out, uInt32 width) const
+{
+  uInt32 x = myPhosphorKernel(tiaIn, rgbIn, out, width, myPalette, myPhosphorPercent);
+
+  for(; x < width; ++x)
+    rgbIn[x] = out[x] = getRGBPhosphor(myPalette[tiaIn[x]], rgbIn[x]);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASurface::enableNTSC(bool enable)
 {
   myFilter = Filter(enable ? uInt8(myFilter) | 0x10 : uInt8(myFilter) & 0x01);
+  updatePersistence();
 
   // Normal vs NTSC mode uses different source widths
   myTiaSurface->setSrcSize(enable ? AtariNTSC::outWidth(TIAConstants::frameBufferWidth)
@@ -269,6 +451,16 @@ void TIASurface::enableNTSC(bool enable)
   memset(myRGBFramebuffer, 0, sizeof(myRGBFramebuffer));
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASurface::enableThreading(bool enable)
+{
+  // Leave one core for the emulation, and use at most four
+  const uInt32 systemThreads = enable ? std::thread::hardware_concurrency() : 0;
+
+  myThreadPool.setThreads(systemThreads <= 1 ? 1 :
+                          BSPF::clamp(systemThreads - 1, 1u, 4u));
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string TIASurface::effectsInfo() const
 {
@@ -314,6 +506,51 @@ inline uInt32 TIASurface::averageBuffers(uInt32 bufOfs)
   return  (rn << 16) | (gn << 8) | bn;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASurface::enableLineTiming(bool enable)
+{
+  myLineTimingEnabled = enable;
+  if(myTIA)
+    myTIA->enableLineTiming(enable);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASurface::toggleLineTiming()
+{
+  enableLineTiming(!myLineTimingEnabled);
+
+  myFB.showMessage(myLineTimingEnabled ? "Cycle budget overlay enabled"
+                                       : "Cycle budget overlay disabled");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASurface::renderLineTiming()
+{
+  const uInt8* waits = myTIA->lineWaits();
+  const uInt32 height = std::min(myTIA->height(), TIAConstants::frameBufferHeight);
+
+  uInt32 *out, outPitch;
+  myTimingSurface->basePtr(out, outPitch);
+
+  for(uInt32 y = 0; y < height; ++y, out += outPitch)
+  {
+    // A line without WSYNC has used all of its cycles, or more
+    if(waits[y] == TIA::NO_WSYNC)
+    {
+      std::fill_n(out, TIMING_WIDTH, myOverrunColor);
+      continue;
+    }
+
+    // The cycles used as a bar, the remaining ones stay transparent
+    const uInt32 cycles = TIMING_WIDTH - std::min(uInt32(waits[y]), TIMING_WIDTH);
+    std::fill_n(out, cycles, myTimingColors[cycles]);
+    std::fill_n(out + cycles, TIMING_WIDTH - cycles, 0);
+  }
+
+  myTimingSurface->setDirtyRows(0, height);
+  myTimingSurface->render();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASurface::render()
 {
@@ -323,23 +560,64 @@ void TIASurface::render()
   uInt32 *out, outPitch;
   myTiaSurface->basePtr(out, outPitch);
 
-  switch(myFilter)
+  // Snapshots read the image back from the base pixels, and the NTSC
+  // phosphor filter reads its output back, so these are never rendered
+  // directly into the surface's texture
+  const Filter filter = myHWPhosphor ? Filter::Normal : myFilter;
+  const bool direct = myDirectRender && !mySaveSnapFlag &&
+                      filter != Filter::BlarggPhosphor;
+  bool locked = false;
+
+  // With hardware phosphor, only the palette converted image is needed
+  switch(filter)
   {
     case Filter::Normal:
     {
       uInt8* tiaIn = myTIA->frameBuffer();
+      const auto& dirty = myTIA->dirtyLines();
 
-      uInt32 bufofs = 0, screenofsY = 0, pos;
+      // After direct rendering, the base pixels are stale
+      if(myDirectFrame && !direct)
+        myRenderAll = true;
+
+      // Only convert (and upload) the scanlines which changed
+      uInt32 top = height, bottom = 0;
       for(uInt32 y = 0; y < height; ++y)
+        if(myRenderAll || dirty[y])
+        {
+          top = std::min(top, y);
+          bottom = y + 1;
+        }
+      bottom = std::max(top, bottom);
+
+      // The surface may need more rows to be rendered into its texture
+      uInt32 first = top, last = bottom;
+      locked = direct && myTiaSurface->lockRows(first, last, out, outPitch);
+      if(locked)
       {
-        pos = screenofsY;
-        for (uInt32 x = width / 2; x; --x)
+        top = first;  bottom = std::max(first, std::min(last, height));
+      }
+
+      uInt32 bufofs, screenofsY = 0, pos;
+      for(uInt32 y = top; y < bottom; ++y)
+      {
+        if(locked || myRenderAll || dirty[y])
         {
-          out[pos++] = myPalette[tiaIn[bufofs++]];
-          out[pos++] = myPalette[tiaIn[bufofs++]];
+          pos = locked ? screenofsY : y * outPitch;
+          bufofs = y * width;
+          for (uInt32 x = width / 2; x; --x)
+          {
+            out[pos++] = myPalette[tiaIn[bufofs++]];
+            out[pos++] = myPalette[tiaIn[bufofs++]];
+          }
         }
         screenofsY += outPitch;
       }
+      if(locked)
+        clearRows(out + (bottom - top) * outPitch, outPitch, bottom, last);
+      else
+        myTiaSurface->setDirtyRows(top, bottom);
+      myRenderAll = false;
       break;
     }
 
@@ -351,26 +629,30 @@ void TIASurface::render()
       if (mySaveSnapFlag)
         memcpy(myPrevRGBFramebuffer, myRGBFramebuffer, width * height * sizeof(uInt32));
 
-      uInt32 bufofs = 0, screenofsY = 0, pos;
-      for(uInt32 y = height; y ; --y)
-      {
-        pos = screenofsY;
-        for(uInt32 x = width / 2; x ; --x)
-        {
-          // Store back into displayed frame buffer (for next frame)
-          rgbIn[bufofs] = out[pos++] = getRGBPhosphor(myPalette[tiaIn[bufofs]], rgbIn[bufofs]);
-          ++bufofs;
-          rgbIn[bufofs] = out[pos++] = getRGBPhosphor(myPalette[tiaIn[bufofs]], rgbIn[bufofs]);
-          ++bufofs;
-        }
-        screenofsY += outPitch;
-      }
+      uInt32 top = 0, bottom = height;
+      locked = direct && myTiaSurface->lockRows(top, bottom, out, outPitch);
+      const uInt32 rows = locked ? std::min(height, bottom) : height;
+
+      // Split the rows into a few parts per thread
+      const uInt32 parts = std::min(rows, myThreadPool.threads() * 4);
+      myThreadPool.run(parts, [&](uInt32 part) {
+        for(uInt32 y = rows * part / parts; y < rows * (part + 1) / parts; ++y)
+          renderPhosphorLine(tiaIn + y * width, rgbIn + y * width, out + y * outPitch, width);
+      });
+      if(locked)
+        clearRows(out + rows * outPitch, outPitch, rows, bottom);
       break;
     }
 
     case Filter::BlarggNormal:
     {
-      myNTSCFilter.render(myTIA->frameBuffer(), width, height, out, outPitch << 2);
+      uInt32 top = 0, bottom = height;
+      locked = direct && myTiaSurface->lockRows(top, bottom, out, outPitch);
+      const uInt32 rows = locked ? std::min(height, bottom) : height;
+
+      myNTSCFilter.render(myTIA->frameBuffer(), width, rows, out, outPitch << 2);
+      if(locked)
+        clearRows(out + rows * outPitch, outPitch, rows, bottom);
       break;
     }
 
@@ -383,6 +665,12 @@ void TIASurface::render()
       break;
     }
   }
+  myDirectFrame = locked;
+
+  // The other filters redraw everything, so the next Normal frame must too
+  if(myFilter != Filter::Normal && !myHWPhosphor)
+    myRenderAll = true;
+  myTIA->clearDirtyLines();
 
   // Draw TIA image
   myTiaSurface->render();
@@ -391,6 +679,10 @@ void TIASurface::render()
   if(myScanlinesEnabled)
     mySLineSurface->render();
 
+  // Draw the cycle budget of the scanlines
+  if(myLineTimingEnabled)
+    renderLineTiming();
+
   if(mySaveSnapFlag)
   {
     mySaveSnapFlag = false;
@@ -400,6 +692,14 @@ void TIASurface::render()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASurface::clearRows(uInt32* out, uInt32 pitch, uInt32 top, uInt32 bottom)
+{
+  // Rows mapped below the image must not show undefined contents
+  for(uInt32 y = top; y < bottom; ++y, out += pitch)
+    std::fill_n(out, pitch, 0);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASurface::renderForSnapshot()
 {
@@ -428,6 +728,11 @@ void TIASurface::renderForSnapshot()
     // For phosphor modes, copy the phosphor framebuffer
     case Filter::Phosphor:
     {
+      // The surface re-blends its last image below, which slightly
+      // shortens the decay just like the averaging does
+      if(myHWPhosphor)
+        break;
+
       uInt32 bufofs = 0, screenofsY = 0;
       for(uInt32 y = height; y; --y)
       {
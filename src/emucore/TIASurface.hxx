@@ -28,6 +28,7 @@ class FBSurface;
 #include "Rect.hxx"
 #include "FrameBuffer.hxx"
 #include "NTSCFilter.hxx"
+#include "ThreadPool.hxx"
 #include "bspf.hxx"
 #include "TIAConstants.hxx"
 
@@ -42,6 +43,14 @@ class FBSurface;
 
 class TIASurface
 {
+  public:
+    /**
+      A phosphor kernel blends the first pixels of a scanline like
+      renderPhosphorLine(), and returns the number of pixels blended.
+    */
+    using PhosphorKernel = uInt32 (*)(const uInt8* tiaIn, uInt32* rgbIn,
+        uInt32* out, uInt32 width, const uInt32* palette, float percent);
+
   public:
     /**
       Creates a new TIASurface object
@@ -69,7 +78,7 @@ class TIASurface
     /**
       Get the TIA base surface for use in saving to a PNG image.
     */
-    const FBSurface& baseSurface(Common::Rect& rect) const;
+    const FBSurface& baseSurface(Common::Rect& rect);
 
     /**
       Use the palette to map a single indexed pixel color. This is used by the TIA output widget.
@@ -106,6 +115,18 @@ class TIASurface
     */
     void enablePhosphor(bool enable, int blend = -1);
     bool phosphorEnabled() const { return myUsePhosphor; }
+    float phosphorPercent() const { return myPhosphorPercent; }
+
+    /**
+      The palette currently used for converting TIA pixels, as set by
+      setPalette().
+    */
+    const uInt32* palette() const { return myPalette; }
+
+    /**
+      The RGB components of the current palette, as set by setPalette().
+    */
+    const uInt32* rgbPalette() const { return myRGBPalette; }
 
     /**
       Used to calculate an averaged color for the 'phosphor' effect.
@@ -139,6 +160,21 @@ class TIASurface
     bool ntscEnabled() const { return uInt8(myFilter) & 0x10; }
     string effectsInfo() const;
 
+    /**
+      Enable/disable spreading the CPU post-processing (NTSC filtering and
+      phosphor blending) across several threads.
+    */
+    void enableThreading(bool enable);
+
+    /**
+      Enable/disable/query the cycle budget overlay, a bar along the right
+      edge of the TIA image showing the CPU cycles each scanline used
+      before its WSYNC.
+    */
+    void enableLineTiming(bool enable);
+    void toggleLineTiming();
+    bool lineTimingEnabled() const { return myLineTimingEnabled; }
+
     /**
       This method should be called to draw the TIA image(s) to the screen.
     */
@@ -157,11 +193,37 @@ class TIASurface
     void saveSnapShot() { mySaveSnapFlag = true; }
 
   private:
+    /**
+      Enable/disable phosphor blending in the TIA surface itself, when
+      requested and supported by the backend.
+    */
+    void updatePersistence();
+
+    /**
+      Clear the rows in [top, bottom) of a directly rendered image, which
+      are below the TIA image.
+    */
+    static void clearRows(uInt32* out, uInt32 pitch, uInt32 top, uInt32 bottom);
+
+    /**
+      Render one scanline in phosphor mode, blending the current TIA pixels
+      with the previous frame and storing the result back into 'rgbIn'.
+      Uses the best phosphor kernel for the CPU, and getRGBPhosphor() for
+      the pixels it leaves.
+    */
+    void renderPhosphorLine(const uInt8* tiaIn, uInt32* rgbIn,
+                            uInt32* out, uInt32 width) const;
+
     /**
       Average current calculated buffer's pixel with previous calculated buffer's pixel (50:50).
     */
     uInt32 averageBuffers(uInt32 bufOfs);
 
+    /**
+      Draw the cycle budget of each scanline of the current frame.
+    */
+    void renderLineTiming();
+
   private:
     OSystem& myOSystem;
     FrameBuffer& myFB;
@@ -169,6 +231,17 @@ class TIASurface
 
     shared_ptr<FBSurface> myTiaSurface, mySLineSurface, myBaseTiaSurface;
 
+    /////////////////////////////////////////////////////////////
+    // Cycle budget overlay, one pixel per CPU cycle of a scanline
+    static constexpr uInt32 TIMING_WIDTH = 76;
+    shared_ptr<FBSurface> myTimingSurface;
+    bool myLineTimingEnabled;
+
+    // Colors by the cycles used, and for lines without WSYNC
+    uInt32 myTimingColors[TIMING_WIDTH + 1];
+    uInt32 myOverrunColor;
+    /////////////////////////////////////////////////////////////
+
     // Enumeration created such that phosphor off/on is in LSB,
     // and Blargg off/on is in MSB
     enum class Filter: uInt8 {
@@ -182,6 +255,9 @@ class TIASurface
     // NTSC object to use in TIA rendering mode
     NTSCFilter myNTSCFilter;
 
+    // Threads used for NTSC filtering and phosphor blending
+    ThreadPool myThreadPool;
+
     /////////////////////////////////////////////////////////////
     // Phosphor mode items (aka reduced flicker on 30Hz screens)
     // RGB frame buffer
@@ -193,11 +269,17 @@ class TIASurface
     // Use phosphor effect
     bool myUsePhosphor;
 
+    // Phosphor blending is done by the TIA surface (in hardware)
+    bool myHWPhosphor;
+
     // Amount to blend when using phosphor effect
     float myPhosphorPercent;
 
     // Precalculated averaged phosphor colors
     uInt8 myPhosphorPalette[256][256];
+
+    // SIMD blending of whole groups of pixels, selected for the CPU
+    PhosphorKernel myPhosphorKernel;
     /////////////////////////////////////////////////////////////
 
     // Use scanlines in TIA rendering mode
@@ -205,10 +287,19 @@ class TIASurface
 
     // Palette for normal TIA rendering mode
     const uInt32* myPalette;
+    const uInt32* myRGBPalette;
 
     // Flag for saving a snapshot
     bool mySaveSnapFlag;
 
+    // Convert all scanlines in the next frame, not only the changed ones
+    bool myRenderAll;
+
+    // Render into the texture of the surface directly, if possible, and
+    // whether the last frame was (leaving the base pixels stale)
+    bool myDirectRender;
+    bool myDirectFrame;
+
   private:
     // Following constructors and assignment operators not supported
     TIASurface() = delete;
@@ -0,0 +1,168 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "FSNode.hxx"
+#include "Version.hxx"
+#include "ThumbProfiler.hxx"
+
+constexpr uInt32 ThumbProfiler::ROM_SIZE;
+constexpr uInt32 ThumbProfiler::RAM_SIZE;
+constexpr uInt32 ThumbProfiler::RAM_BASE;
+constexpr uInt32 ThumbProfiler::MAX_DEPTH;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThumbProfiler::ThumbProfiler()
+  : myRomCosts(ROM_SIZE / 2),
+    myRamCosts(RAM_SIZE / 2),
+    myCycles(0),
+    myInstructions(0),
+    myRuns(0),
+    myRunStart(0),
+    myMaxRunCycles(0),
+    myTimingFactor(1)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbProfiler::beginRun(uInt32 entry, double timingFactor)
+{
+  myFunctions.insert(entry);
+  myTimingFactor = timingFactor;
+  myRunStart = myCycles;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbProfiler::call(uInt32 addr, uInt32 target)
+{
+  myFunctions.insert(target);
+  ++myCalls[std::make_pair(addr, target)].calls;
+
+  // Both BL (the second half) and BLX are followed by the return address
+  if(myStack.size() < MAX_DEPTH)
+    myStack.push_back({ addr, target, addr + 2, myCycles, myInstructions });
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbProfiler::branch(uInt32 target)
+{
+  // Returning from a call may skip calls which never return themselves
+  for(size_t i = myStack.size(); i-- > 0; )
+  {
+    if(myStack[i].returnAddr == target)
+    {
+      while(myStack.size() > i)
+      {
+        returnFrom(myStack.back());
+        myStack.pop_back();
+      }
+      return;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbProfiler::returnFrom(const Frame& frame)
+{
+  Call& call = myCalls[std::make_pair(frame.site, frame.target)];
+  call.cycles += myCycles - frame.cycles;
+  call.instructions += myInstructions - frame.instructions;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThumbProfiler::endRun()
+{
+  while(!myStack.empty())
+  {
+    returnFrom(myStack.back());
+    myStack.pop_back();
+  }
+
+  myMaxRunCycles = std::max(myMaxRunCycles, myCycles - myRunStart);
+  ++myRuns;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 ThumbProfiler::functionOf(uInt32 addr) const
+{
+  // Code without a known entry belongs to the start of its memory
+  const uInt32 base = addr < ROM_SIZE ? 0 : RAM_BASE;
+  const auto iter = myFunctions.upper_bound(addr);
+
+  return iter != myFunctions.begin() && *std::prev(iter) >= base
+    ? *std::prev(iter) : base;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string ThumbProfiler::save(const FilesystemNode& node, const string& name) const
+{
+  ofstream out(node.getPath());
+  if(!out.is_open())
+    return "unable to save ARM profile to " + node.getShortPath();
+
+  const auto position = [](uInt32 addr) {
+    ostringstream buf;
+    buf << "0x" << std::hex << std::setw(8) << std::setfill('0') << addr;
+    return buf.str();
+  };
+
+  // Collect the costs and calls of each function, in address order
+  std::map<uInt32, ostringstream> functions;
+  const auto addCosts = [&](const vector<Cost>& costs, uInt32 base) {
+    for(uInt32 i = 0; i < costs.size(); ++i)
+    {
+      if(costs[i].executions == 0)
+        continue;
+
+      const uInt32 addr = base + i * 2;
+      functions[functionOf(addr)] << position(addr) << " " << costs[i].cycles
+                                  << " " << costs[i].executions << "\n";
+    }
+  };
+  addCosts(myRomCosts, 0);
+  addCosts(myRamCosts, RAM_BASE);
+
+  for(const auto& call: myCalls)
+  {
+    const uInt32 site = call.first.first, target = call.first.second;
+    functions[functionOf(site)]
+      << "cfn=" << position(target) << "\n"
+      << "calls=" << call.second.calls << " " << position(target) << "\n"
+      << position(site) << " " << call.second.cycles << " "
+      << call.second.instructions << "\n";
+  }
+
+  out << "# callgrind format\n"
+      << "version: 1\n"
+      << "creator: Stella " << STELLA_VERSION << "\n"
+      << "cmd: " << name << "\n"
+      << "# " << myRuns << " runs of the ARM code, "
+      << (myRuns > 0 ? myCycles / myRuns : 0) << " cycles on average, "
+      << myMaxRunCycles << " at most (" << uInt64(myMaxRunCycles / myTimingFactor)
+      << " 6507 cycles)\n"
+      << "positions: instr\n"
+      << "events: Cycles Instructions\n"
+      << "summary: " << myCycles << " " << myInstructions << "\n\n"
+      << "fl=" << name << "\n";
+
+  for(const auto& function: functions)
+    out << "\nfn=" << position(function.first) << "\n" << function.second.str();
+
+  if(!out)
+    return "unable to save ARM profile to " + node.getShortPath();
+
+  return "saved ARM profile to " + node.getShortPath();
+}
@@ -0,0 +1,169 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef THUMB_PROFILER_HXX
+#define THUMB_PROFILER_HXX
+
+class FilesystemNode;
+
+#include <map>
+#include <set>
+
+#include "bspf.hxx"
+
+/**
+  Counts the cycles of every ARM instruction the Thumbulator executes, and
+  the calls between functions (BL and BLX), for profiling the ARM code of
+  BUS, CDF and DPC+ cartridges.
+
+  The cycles follow the ARM7TDMI timing (one cycle per memory access, plus
+  internal cycles for loads and multiplies, and two cycles to refill the
+  pipeline after a branch), without the wait states of the flash memory.
+  Every instruction is counted, so the profile is exact for this model.
+
+  Functions are identified by their entry points (the start of each run and
+  every call target); an address belongs to the nearest function entry
+  below it.  A call returns when the code branches to its return address,
+  whichever instruction does that (BX LR, POP {PC} or POP {Rx} / BX Rx).
+
+  The profile is saved in the callgrind format, which can be viewed by
+  KCachegrind, QCachegrind and other tools.
+
+  @author  Stephen Anthony
+*/
+class ThumbProfiler
+{
+  public:
+    ThumbProfiler();
+
+    /**
+      Start a run of the ARM code.
+
+      @param entry         The address of the first instruction
+      @param timingFactor  ARM cycles per 6507 cycle
+    */
+    void beginRun(uInt32 entry, double timingFactor);
+
+    /**
+      Account for an executed instruction.
+    */
+    void instruction(uInt32 addr, uInt32 cycles)
+    {
+      Cost* cost = this->cost(addr);
+      if(cost)
+      {
+        cost->cycles += cycles;
+        ++cost->executions;
+      }
+      myCycles += cycles;
+      ++myInstructions;
+    }
+
+    /**
+      Account for a call from the given address, and a branch to a new
+      address (which may return from a call).
+    */
+    void call(uInt32 addr, uInt32 target);
+    void branch(uInt32 target);
+
+    /**
+      Finish the current run; calls still active are returned from.
+    */
+    void endRun();
+
+    /**
+      The cycles and instructions executed and the number of runs so far.
+    */
+    uInt64 cycles() const { return myCycles; }
+    uInt64 instructions() const { return myInstructions; }
+    uInt64 runs() const { return myRuns; }
+
+    /**
+      Save the profile in the callgrind format.
+
+      @param node  The file to create
+      @param name  The name of the ROM
+      @return  A message describing the result
+    */
+    string save(const FilesystemNode& node, const string& name) const;
+
+  private:
+    struct Cost {
+      uInt64 cycles;
+      uInt64 executions;
+    };
+
+    struct Call {
+      uInt64 calls;
+      uInt64 cycles;        // including the cycles of all calls made
+      uInt64 instructions;  // including the instructions of all calls made
+    };
+
+    struct Frame {
+      uInt32 site, target, returnAddr;
+      uInt64 cycles, instructions;  // at the time of the call
+    };
+
+    // The costs of the ROM and the RAM, by halfword
+    static constexpr uInt32 ROM_SIZE = 0x8000;
+    static constexpr uInt32 RAM_SIZE = 0x2000;
+    static constexpr uInt32 RAM_BASE = 0x40000000;
+
+    // Deeper calls aren't followed (the code may not return at all)
+    static constexpr uInt32 MAX_DEPTH = 256;
+
+    Cost* cost(uInt32 addr)
+    {
+      if(addr < ROM_SIZE)
+        return &myRomCosts[addr >> 1];
+      else if(addr - RAM_BASE < RAM_SIZE)
+        return &myRamCosts[(addr - RAM_BASE) >> 1];
+      else
+        return nullptr;
+    }
+
+    void returnFrom(const Frame& frame);
+
+    // The function the given address belongs to
+    uInt32 functionOf(uInt32 addr) const;
+
+  private:
+    vector<Cost> myRomCosts, myRamCosts;
+
+    // Calls by (call site, target)
+    std::map<std::pair<uInt32, uInt32>, Call> myCalls;
+
+    // Entry points of all known functions
+    std::set<uInt32> myFunctions;
+
+    vector<Frame> myStack;
+
+    uInt64 myCycles, myInstructions;
+
+    // Cycles per run
+    uInt64 myRuns, myRunStart, myMaxRunCycles;
+    double myTimingFactor;
+
+  private:
+    // Following constructors and assignment operators not supported
+    ThumbProfiler(const ThumbProfiler&) = delete;
+    ThumbProfiler(ThumbProfiler&&) = delete;
+    ThumbProfiler& operator=(const ThumbProfiler&) = delete;
+    ThumbProfiler& operator=(ThumbProfiler&&) = delete;
+};
+
+#endif
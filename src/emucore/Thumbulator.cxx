@@ -25,7 +25,9 @@
 #include "bspf.hxx"
 #include "Base.hxx"
 #include "Cart.hxx"
+#include "PerfCounters.hxx"
 #include "Thumbulator.hxx"
+#include "ThumbProfiler.hxx"
 using Common::Base;
 
 // Uncomment the following to enable specific functionality
@@ -60,14 +62,89 @@ Thumbulator::Thumbulator(const uInt16* rom_ptr, uInt16* ram_ptr, uInt16 rom_size
     romSize(rom_size),
     decodedRom(new Op[romSize / 2]),
     ram(ram_ptr),
+#ifndef UNSAFE_OPTIMIZATIONS
+    decodedRam(new DecodedRamWord[RAMSIZE / 2]),
+#endif
     T1TCR(0),
     T1TC(0),
     configuration(configurefor),
-    myCartridge(cartridge)
+    myCartridge(cartridge),
+    myProfiler(nullptr),
+    myFastMode(false),
+    myCycles(0),
+    myStart(false),
+    myDone(false),
+    myQuit(false),
+    myPending(false)
 {
   for(uInt16 i = 0; i < romSize / 2; ++i)
     decodedRom[i] = decodeInstructionWord(CONV_RAMROM(rom[i]));
 
+#ifndef UNSAFE_OPTIMIZATIONS
+  const Op decodedZero = decodeInstructionWord(0);
+  for(uInt32 i = 0; i < RAMSIZE / 2; ++i)
+    decodedRam[i] = { 0, decodedZero };
+#endif
+
+  for(MemoryRegion& region: regions)
+    region = { nullptr, nullptr, 0 };
+  regions[0x0] = { rom, nullptr, ROMSIZE };
+  regions[0x4] = { ram, ram, RAMSIZE };
+
+  // Every call into the driver starts out with the same registers, so
+  // they're worked out once here instead of on each call
+  std::fill(reg_entry, reg_entry+16, 0);
+  reg_entry[13] = 0x40001FB4;
+
+  switch(configuration)
+  {
+    // future 2K Harmony/Melody drivers will most likely use these settings
+    case ConfigureFor::BUS:
+    case ConfigureFor::CDF:
+    case ConfigureFor::CDF1:
+    case ConfigureFor::CDFJ:
+      reg_entry[14] = 0x00000800; // Link Register
+      reg_entry[15] = 0x0000080B; // Program Counter
+      break;
+
+    // future 3K Harmony/Melody drivers will most likely use these settings
+    case ConfigureFor::DPCplus:
+      reg_entry[14] = 0x00000C00; // Link Register
+      reg_entry[15] = 0x00000C0B; // Program Counter
+      break;
+  }
+
+#ifndef UNSAFE_OPTIMIZATIONS
+  // The driver area, and the parts of it the ARM code may write to
+  unprotectedStart = unprotectedEnd = 0;
+  switch(configuration)
+  {
+    case ConfigureFor::DPCplus:
+      protectedEnd = 0x0c00;
+      break;
+
+    case ConfigureFor::CDF:
+      protectedEnd = 0x0800;
+      unprotectedStart = 0x06e0;  unprotectedEnd = 0x0e60 + 284;
+      break;
+
+    case ConfigureFor::CDF1:
+      protectedEnd = 0x0800;
+      unprotectedStart = 0x00a0;  unprotectedEnd = 0x00a0 + 284;
+      break;
+
+    case ConfigureFor::CDFJ:
+      protectedEnd = 0x0800;
+      unprotectedStart = 0x0098;  unprotectedEnd = 0x0098 + 292;
+      break;
+
+    case ConfigureFor::BUS:
+      protectedEnd = 0x06d8;
+      break;
+  }
+#endif
+  reg_norm[12] = 0;
+
   setConsoleTiming(ConsoleTiming::ntsc);
 #ifndef UNSAFE_OPTIMIZATIONS
   trapFatalErrors(traponfatal);
@@ -78,15 +155,18 @@ Thumbulator::Thumbulator(const uInt16* rom_ptr, uInt16* ram_ptr, uInt16 rom_size
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string Thumbulator::run()
 {
+  PERF_TIME(thumbulatorRun);
+
   reset();
-  for(;;)
-  {
-    if(execute()) break;
-#ifndef UNSAFE_OPTIMIZATIONS
-    if(instructions > 500000) // way more than would otherwise be possible
-      throw runtime_error("instructions > 500000");
+#ifndef NO_THUMB_STATS
+  if(myProfiler)
+    runProfiled();
+  else
 #endif
-  }
+  if(myFastMode)
+    runUntilExit<true>();
+  else
+    runUntilExit<false>();
 #if defined(THUMB_DISS) || defined(THUMB_DBUG)
   dump_counters();
   cout << statusMsg.str() << endl;
@@ -96,6 +176,191 @@ string Thumbulator::run()
 #endif
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool fast>
+void Thumbulator::runUntilExit()
+{
+  for(;;)
+  {
+    if(execute<fast>()) break;
+#ifndef UNSAFE_OPTIMIZATIONS
+    if(instructions > 500000) // way more than would otherwise be possible
+      throw runtime_error("instructions > 500000");
+#endif
+  }
+}
+
+#ifndef NO_THUMB_STATS
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::runProfiled()
+{
+  myProfiler->beginRun((reg_norm[15] & ~1u) - 2, timing_factor);
+
+  for(;;)
+  {
+    // The PC points two bytes past the next instruction
+    const uInt32 addr = (reg_norm[15] & ~1u) - 2;
+    const uInt32 inst = peekInstruction(addr);
+    const uInt64 oldReads = reads, oldWrites = writes;
+
+    // MUL takes one to four internal cycles, depending on the multiplier
+    // (Rd, which is also the destination)
+    uInt32 internal = 0;
+    if((inst & 0xFFC0) == 0x4340)
+    {
+      const uInt32 rs = reg_norm[inst & 0x07];
+      internal = ((rs & 0xFFFFFF00) == 0 || (rs & 0xFFFFFF00) == 0xFFFFFF00) ? 1
+               : ((rs & 0xFFFF0000) == 0 || (rs & 0xFFFF0000) == 0xFFFF0000) ? 2
+               : ((rs & 0xFF000000) == 0 || (rs & 0xFF000000) == 0xFF000000) ? 3 : 4;
+    }
+
+    const bool done = execute<false>() != 0;
+
+    // One cycle per fetch, read and write, one internal cycle for each
+    // load, and two cycles to refill the pipeline after a branch
+    const uInt32 next = (reg_norm[15] & ~1u) - 2;
+    const bool branched = next != addr + 2;
+    uInt32 cycles = 1 + uInt32(reads - oldReads) + uInt32(writes - oldWrites) + internal;
+    if(reads != oldReads)
+      ++cycles;
+    if(branched && !done)
+      cycles += 2;
+    myProfiler->instruction(addr, cycles);
+
+    if(done)
+      break;
+
+    // BL (the second half), BLX (1) and BLX (2)
+    if((inst & 0xE800) == 0xE800 || (inst & 0xFF87) == 0x4780)
+      myProfiler->call(addr, next);
+    else if(branched)
+      myProfiler->branch(next);
+
+#ifndef UNSAFE_OPTIMIZATIONS
+    if(instructions > 500000) // way more than would otherwise be possible
+      throw runtime_error("instructions > 500000");
+#endif
+  }
+
+  myProfiler->endRun();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Thumbulator::peekInstruction(uInt32 addr) const
+{
+  if((addr & 0xF0000000) == 0x40000000)
+    return CONV_RAMROM(ram[(addr & RAMADDMASK) >> 1]);
+  else
+    return CONV_RAMROM(rom[(addr & ROMADDMASK) >> 1]);
+}
+#endif
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Thumbulator::~Thumbulator()
+{
+  stopThread();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::setAsync(bool enable)
+{
+  if(enable == myThread.joinable())
+    return;
+
+  if(enable)
+  {
+    myQuit = false;
+    myThread = std::thread([this] { threadLoop(); });
+  }
+  else
+  {
+    sync();
+    stopThread();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::start(uInt32 cycles)
+{
+  if(!myThread.joinable())
+  {
+    run(cycles);
+    return;
+  }
+
+  sync();
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myCycles = cycles;
+    myStart = true;
+    myDone = false;
+  }
+  myCondition.notify_all();
+  myPending = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::finish()
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+  myCondition.wait(lock, [this] { return myDone; });
+  myPending = false;
+
+  if(!myError.empty())
+  {
+    string error;
+    error.swap(myError);
+    throw runtime_error(error);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::threadLoop()
+{
+  std::unique_lock<std::mutex> lock(myMutex);
+
+  for(;;)
+  {
+    myCondition.wait(lock, [this] { return myStart || myQuit; });
+    if(!myStart)
+      return;
+    myStart = false;
+
+    // The ARM code runs without the lock; the thread which started it
+    // doesn't touch any of the state used here until finish()
+    lock.unlock();
+    string error;
+    try
+    {
+      run(myCycles);
+    }
+    catch(const runtime_error& e)
+    {
+      error = e.what();
+    }
+    lock.lock();
+
+    myError = error;
+    myDone = true;
+    myCondition.notify_all();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Thumbulator::stopThread()
+{
+  if(!myThread.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myQuit = true;
+  }
+  myCondition.notify_all();
+  myThread.join();
+  myPending = false;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Thumbulator::setConsoleTiming(ConsoleTiming timing)
 {
@@ -178,6 +443,101 @@ void Thumbulator::dump_regs()
 }
 #endif
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool fast>
+inline uInt32 Thumbulator::read16(uInt32 addr)
+{
+  const MemoryRegion& region = regions[addr >> 28];
+  const uInt32 offset = addr & 0x0FFFFFFF;
+#ifndef UNSAFE_OPTIMIZATIONS
+  if(region.directReadBase && (fast || (offset < region.size && !(addr & 1))))
+#else
+  if(region.directReadBase)
+#endif
+  {
+#ifndef NO_THUMB_STATS
+    if(!fast) ++reads;
+#endif
+    const uInt32 data = CONV_RAMROM(region.directReadBase[(offset & (region.size - 1)) >> 1]);
+    DO_DBUG(statusMsg << "read16(" << Base::HEX8 << addr << ")=" << Base::HEX4 << data << endl);
+    return data;
+  }
+  return readSlow16(addr);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool fast>
+inline uInt32 Thumbulator::read32(uInt32 addr)
+{
+  const MemoryRegion& region = regions[addr >> 28];
+  const uInt32 offset = addr & 0x0FFFFFFF & ~3u;
+#ifndef UNSAFE_OPTIMIZATIONS
+  if(region.directReadBase && (fast || (offset < region.size && !(addr & 3))))
+#else
+  if(region.directReadBase)
+#endif
+  {
+#ifndef NO_THUMB_STATS
+    if(!fast) reads += 2;
+#endif
+    const uInt16* data = region.directReadBase + ((offset & (region.size - 1)) >> 1);
+    const uInt32 low = CONV_RAMROM(data[0]), high = CONV_RAMROM(data[1]);
+    const uInt32 result = low | (high << 16);
+    DO_DBUG(statusMsg << "read32(" << Base::HEX8 << addr << ")=" << Base::HEX8 << result << endl);
+    return result;
+  }
+  return readSlow32(addr);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool fast>
+inline void Thumbulator::write16(uInt32 addr, uInt32 data)
+{
+  const MemoryRegion& region = regions[addr >> 28];
+  const uInt32 offset = addr & 0x0FFFFFFF;
+#ifndef UNSAFE_OPTIMIZATIONS
+  if(region.directWriteBase &&
+     (fast || (offset < region.size && !(addr & 1) && !isProtected(addr))))
+#else
+  if(region.directWriteBase)
+#endif
+  {
+#ifndef NO_THUMB_STATS
+    if(!fast) ++writes;
+#endif
+    DO_DBUG(statusMsg << "write16(" << Base::HEX8 << addr << "," << Base::HEX8 << data << ")" << endl);
+    region.directWriteBase[(offset & (region.size - 1)) >> 1] = CONV_DATA(data);
+    return;
+  }
+  writeSlow16(addr, data);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool fast>
+inline void Thumbulator::write32(uInt32 addr, uInt32 data)
+{
+  const MemoryRegion& region = regions[addr >> 28];
+  const uInt32 offset = addr & 0x0FFFFFFF & ~3u;
+#ifndef UNSAFE_OPTIMIZATIONS
+  if(region.directWriteBase &&
+     (fast || (offset < region.size && !(addr & 3) &&
+               !isProtected(addr) && !isProtected(addr + 2))))
+#else
+  if(region.directWriteBase)
+#endif
+  {
+#ifndef NO_THUMB_STATS
+    if(!fast) writes += 2;
+#endif
+    DO_DBUG(statusMsg << "write32(" << Base::HEX8 << addr << "," << Base::HEX8 << data << ")" << endl);
+    uInt16* ptr = region.directWriteBase + ((offset & (region.size - 1)) >> 1);
+    ptr[0] = CONV_DATA(data);
+    ptr[1] = CONV_DATA(data >> 16);
+    return;
+  }
+  writeSlow32(addr, data);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 Thumbulator::fetch16(uInt32 addr)
 {
@@ -214,7 +574,7 @@ uInt32 Thumbulator::fetch16(uInt32 addr)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Thumbulator::write16(uInt32 addr, uInt32 data)
+void Thumbulator::writeSlow16(uInt32 addr, uInt32 data)
 {
 #ifndef UNSAFE_OPTIMIZATIONS
   if((addr > 0x40001fff) && (addr < 0x50000000))
@@ -257,7 +617,7 @@ void Thumbulator::write16(uInt32 addr, uInt32 data)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Thumbulator::write32(uInt32 addr, uInt32 data)
+void Thumbulator::writeSlow32(uInt32 addr, uInt32 data)
 {
 #ifndef UNSAFE_OPTIMIZATIONS
   if(addr & 3)
@@ -343,8 +703,8 @@ void Thumbulator::write32(uInt32 addr, uInt32 data)
 #else
     default:
 #endif
-      write16(addr+0, (data >>  0) & 0xFFFF);
-      write16(addr+2, (data >> 16) & 0xFFFF);
+      write16<false>(addr+0, (data >>  0) & 0xFFFF);
+      write16<false>(addr+2, (data >> 16) & 0xFFFF);
       return;
   }
 #ifndef UNSAFE_OPTIMIZATIONS
@@ -352,36 +712,8 @@ void Thumbulator::write32(uInt32 addr, uInt32 data)
 #endif
 }
 
-#ifndef UNSAFE_OPTIMIZATIONS
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Thumbulator::isProtected(uInt32 addr)
-{
-  if (addr < 0x40000000) return false;
-  addr -= 0x40000000;
-
-  switch (configuration) {
-    case ConfigureFor::DPCplus:
-      return (addr < 0x0c00) && (addr > 0x0028);
-
-    case ConfigureFor::CDF:
-      return  (addr < 0x0800) && (addr > 0x0028) && !((addr >= 0x06e0) && (addr < (0x0e60 + 284)));
-
-    case ConfigureFor::CDF1:
-      return  (addr < 0x0800) && (addr > 0x0028) && !((addr >= 0x00a0) && (addr < (0x00a0 + 284)));
-
-    case ConfigureFor::CDFJ:
-      return  (addr < 0x0800) && (addr > 0x0028) && !((addr >= 0x0098) && (addr < (0x0098 + 292)));
-
-    case ConfigureFor::BUS:
-      return  (addr < 0x06d8) && (addr > 0x0028);
-  }
-
-  return false;
-}
-#endif
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 Thumbulator::read16(uInt32 addr)
+uInt32 Thumbulator::readSlow16(uInt32 addr)
 {
   uInt32 data;
 #ifndef UNSAFE_OPTIMIZATIONS
@@ -429,7 +761,7 @@ uInt32 Thumbulator::read16(uInt32 addr)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt32 Thumbulator::read32(uInt32 addr)
+uInt32 Thumbulator::readSlow32(uInt32 addr)
 {
 #ifndef UNSAFE_OPTIMIZATIONS
   if(addr & 3)
@@ -441,8 +773,8 @@ uInt32 Thumbulator::read32(uInt32 addr)
   {
     case 0x00000000: //ROM
     case 0x40000000: //RAM
-      data = read16(addr+0);
-      data |= (uInt32(read16(addr+2))) << 16;
+      data = read16<false>(addr+0);
+      data |= (uInt32(read16<false>(addr+2))) << 16;
       DO_DBUG(statusMsg << "read32(" << Base::HEX8 << addr << ")=" << Base::HEX8 << data << endl);
       return data;
 
@@ -523,56 +855,75 @@ void Thumbulator::write_register(uInt32 reg, uInt32 data)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Thumbulator::do_zflag(uInt32 x)
+inline void Thumbulator::do_zflag(uInt32 x)
 {
-  if(x == 0) cpsr |= CPSR_Z;  else cpsr &= ~CPSR_Z;
+  flagZ = x;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Thumbulator::do_nflag(uInt32 x)
+inline void Thumbulator::do_nflag(uInt32 x)
 {
-  if(x & 0x80000000) cpsr |= CPSR_N;  else cpsr &= ~CPSR_N;
+  flagN = x;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Thumbulator::do_cflag(uInt32 a, uInt32 b, uInt32 c)
+inline void Thumbulator::do_cflag(uInt32 a, uInt32 b, uInt32 c)
 {
-  uInt32 rc;
+  flagCa = a;  flagCb = b;  flagCc = c;
+}
 
-  rc = (a & 0x7FFFFFFF) + (b & 0x7FFFFFFF) + c; //carry in
-  rc = (rc >> 31) + (a >> 31) + (b >> 31);      //carry out
-  if(rc & 2)
-    cpsr |= CPSR_C;
-  else
-    cpsr &= ~CPSR_C;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Thumbulator::do_vflag(uInt32 a, uInt32 b, uInt32 c)
+{
+  flagVa = a;  flagVb = b;  flagVc = c;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Thumbulator::do_vflag(uInt32 a, uInt32 b, uInt32 c)
+inline void Thumbulator::do_cflag_bit(uInt32 x)
 {
-  uInt32 rc, rd;
-
-  rc = (a & 0x7FFFFFFF) + (b & 0x7FFFFFFF) + c; //carry in
-  rc >>= 31; //carry in in lsbit
-  rd = (rc & 1) + ((a >> 31) & 1) + ((b >> 31) & 1); //carry out
-  rd >>= 1; //carry out in lsbit
-  rc = (rc^rd) & 1; //if carry in != carry out then signed overflow
-  if(rc)
-    cpsr |= CPSR_V;
-  else
-    cpsr &= ~CPSR_V;
+  // ~0 + 0 + 1 carries out, 0 + 0 + 0 doesn't
+  flagCa = x ? ~0u : 0;  flagCb = 0;  flagCc = x ? 1 : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void Thumbulator::do_vflag_bit(uInt32 x)
+{
+  // 0x7FFFFFFF + 0 + 1 overflows, 0 + 0 + 0 doesn't
+  flagVa = x ? 0x7FFFFFFF : 0;  flagVb = 0;  flagVc = x ? 1 : 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Thumbulator::do_cflag_bit(uInt32 x)
+inline bool Thumbulator::cpsrN() const
 {
-  if(x) cpsr |= CPSR_C;  else cpsr &= ~CPSR_C;
+  return flagN & 0x80000000;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Thumbulator::do_vflag_bit(uInt32 x)
+inline bool Thumbulator::cpsrZ() const
 {
-  if(x) cpsr |= CPSR_V;  else cpsr &= ~CPSR_V;
+  return flagZ == 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline bool Thumbulator::cpsrC() const
+{
+  return (uInt64(flagCa) + flagCb + flagCc) >> 32;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline bool Thumbulator::cpsrV() const
+{
+  uInt32 rc = flagVa + flagVb + flagVc;
+
+  // signed overflow if both operands have the same sign, but the result differs
+  return ((flagVa ^ rc) & (flagVb ^ rc)) >> 31;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Thumbulator::read_cpsr() const
+{
+  return (cpsrN() ? CPSR_N : 0) | (cpsrZ() ? CPSR_Z : 0) |
+         (cpsrC() ? CPSR_C : 0) | (cpsrV() ? CPSR_V : 0);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -800,33 +1151,62 @@ Thumbulator::Op Thumbulator::decodeInstructionWord(uint16_t inst) {
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool fast>
 int Thumbulator::execute()
 {
   uInt32 pc, sp, inst, ra, rb, rc, rm, rd, rn, rs, op;
 
   pc = read_register(15);
 
+  // Flash and RAM are fetched from directly, along with the decoded op;
+  // fetch16() only handles the errors
   uInt32 instructionPtr = pc - 2;
-  inst = fetch16(instructionPtr);
-
-  pc += 2;
-  write_register(15, pc);
-  DO_DISS(statusMsg << Base::HEX8 << (pc-5) << ": " << Base::HEX4 << inst << " ");
-
-#ifndef UNSAFE_OPTIMIZATIONS
-  ++instructions;
-#endif
-
   Op decodedOp;
 #ifndef UNSAFE_OPTIMIZATIONS
-  if ((instructionPtr & 0xF0000000) == 0 && instructionPtr < romSize)
+  if((instructionPtr & 0xF0000000) == 0 && (fast || instructionPtr >= 0x50) &&
+     instructionPtr < romSize)
+  {
+  #ifndef NO_THUMB_STATS
+    if(!fast) ++fetches;
+  #endif
+    inst = CONV_RAMROM(rom[instructionPtr >> 1]);
     decodedOp = decodedRom[instructionPtr >> 1];
+  }
+  else if((instructionPtr & 0xF0000000) == 0x40000000)
+  {
+  #ifndef NO_THUMB_STATS
+    if(!fast) ++fetches;
+  #endif
+    inst = CONV_RAMROM(ram[(instructionPtr & RAMADDMASK) >> 1]);
+    DecodedRamWord& cached = decodedRam[(instructionPtr & RAMADDMASK) >> 1];
+    if(cached.inst != inst)
+    {
+      cached.inst = inst;
+      cached.op = decodeInstructionWord(inst);
+    }
+    decodedOp = cached.op;
+  }
   else
+  {
+    inst = fetch16(instructionPtr);
     decodedOp = decodeInstructionWord(inst);
+  }
 #else
+  #ifndef NO_THUMB_STATS
+    if(!fast) ++fetches;
+  #endif
+  inst = CONV_RAMROM(rom[(instructionPtr & ROMADDMASK) >> 1]);
   decodedOp = decodedRom[(instructionPtr & ROMADDMASK) >> 1];
 #endif
 
+  pc += 2;
+  write_register(15, pc);
+  DO_DISS(statusMsg << Base::HEX8 << (pc-5) << ": " << Base::HEX4 << inst << " ");
+
+#ifndef UNSAFE_OPTIMIZATIONS
+  ++instructions;
+#endif
+
   switch (decodedOp) {
     //ADC
     case Op::adc: {
@@ -836,12 +1216,12 @@ int Thumbulator::execute()
       ra = read_register(rd);
       rb = read_register(rm);
       rc = ra + rb;
-      if(cpsr & CPSR_C)
+      if(cpsrC())
         ++rc;
       write_register(rd, rc);
       do_nflag(rc);
       do_zflag(rc);
-      if(cpsr & CPSR_C) { do_cflag(ra, rb, 1); do_vflag(ra, rb, 1); }
+      if(cpsrC()) { do_cflag(ra, rb, 1); do_vflag(ra, rb, 1); }
       else              { do_cflag(ra, rb, 0); do_vflag(ra, rb, 0); }
       return 0;
     }
@@ -921,7 +1301,7 @@ int Thumbulator::execute()
       if(rd == 15)
       {
 #ifndef UNSAFE_OPTIMIZATIONS
-        if((rc & 1) == 0)
+        if(!fast && (rc & 1) == 0)
           fatalError("add pc", pc, rc, " produced an arm address");
 #endif
         //rc &= ~1; //write_register may do this as well
@@ -1068,93 +1448,93 @@ int Thumbulator::execute()
       {
         case 0x0: //b eq  z set
           DO_DISS(statusMsg << "beq 0x" << Base::HEX8 << (rb-3) << endl);
-          if(cpsr & CPSR_Z)
+          if(cpsrZ())
             write_register(15, rb);
           return 0;
 
         case 0x1: //b ne  z clear
           DO_DISS(statusMsg << "bne 0x" << Base::HEX8 << (rb-3) << endl);
-          if(!(cpsr & CPSR_Z))
+          if(!(cpsrZ()))
             write_register(15, rb);
           return 0;
 
         case 0x2: //b cs c set
           DO_DISS(statusMsg << "bcs 0x" << Base::HEX8 << (rb-3) << endl);
-          if(cpsr & CPSR_C)
+          if(cpsrC())
             write_register(15, rb);
           return 0;
 
         case 0x3: //b cc c clear
           DO_DISS(statusMsg << "bcc 0x" << Base::HEX8 << (rb-3) << endl);
-          if(!(cpsr & CPSR_C))
+          if(!(cpsrC()))
             write_register(15, rb);
           return 0;
 
         case 0x4: //b mi n set
           DO_DISS(statusMsg << "bmi 0x" << Base::HEX8 << (rb-3) << endl);
-          if(cpsr & CPSR_N)
+          if(cpsrN())
             write_register(15, rb);
           return 0;
 
         case 0x5: //b pl n clear
           DO_DISS(statusMsg << "bpl 0x" << Base::HEX8 << (rb-3) << endl);
-          if(!(cpsr & CPSR_N))
+          if(!(cpsrN()))
             write_register(15, rb);
           return 0;
 
         case 0x6: //b vs v set
           DO_DISS(statusMsg << "bvs 0x" << Base::HEX8 << (rb-3) << endl);
-          if(cpsr & CPSR_V)
+          if(cpsrV())
             write_register(15,rb);
           return 0;
 
         case 0x7: //b vc v clear
           DO_DISS(statusMsg << "bvc 0x" << Base::HEX8 << (rb-3) << endl);
-          if(!(cpsr & CPSR_V))
+          if(!(cpsrV()))
             write_register(15, rb);
           return 0;
 
         case 0x8: //b hi c set z clear
           DO_DISS(statusMsg << "bhi 0x" << Base::HEX8 << (rb-3) << endl);
-          if((cpsr & CPSR_C) && (!(cpsr & CPSR_Z)))
+          if((cpsrC()) && (!(cpsrZ())))
             write_register(15, rb);
           return 0;
 
         case 0x9: //b ls c clear or z set
           DO_DISS(statusMsg << "bls 0x" << Base::HEX8 << (rb-3) << endl);
-          if((cpsr & CPSR_Z) || (!(cpsr & CPSR_C)))
+          if((cpsrZ()) || (!(cpsrC())))
             write_register(15, rb);
           return 0;
 
         case 0xA: //b ge N == V
           DO_DISS(statusMsg << "bge 0x" << Base::HEX8 << (rb-3) << endl);
-          if(((cpsr & CPSR_N) && (cpsr & CPSR_V)) ||
-             ((!(cpsr & CPSR_N)) && (!(cpsr & CPSR_V))))
+          if(((cpsrN()) && (cpsrV())) ||
+             ((!(cpsrN())) && (!(cpsrV()))))
             write_register(15, rb);
           return 0;
 
         case 0xB: //b lt N != V
           DO_DISS(statusMsg << "blt 0x" << Base::HEX8 << (rb-3) << endl);
-          if((!(cpsr & CPSR_N) && (cpsr & CPSR_V)) ||
-            (((cpsr & CPSR_N)) && !(cpsr & CPSR_V)))
+          if((!(cpsrN()) && (cpsrV())) ||
+            (((cpsrN())) && !(cpsrV())))
             write_register(15, rb);
           return 0;
 
         case 0xC: //b gt Z==0 and N == V
           DO_DISS(statusMsg << "bgt 0x" << Base::HEX8 << (rb-3) << endl);
-          if(!(cpsr & CPSR_Z))
+          if(!(cpsrZ()))
           {
-            if(((cpsr & CPSR_N) && (cpsr & CPSR_V)) ||
-               ((!(cpsr & CPSR_N)) && (!(cpsr & CPSR_V))))
+            if(((cpsrN()) && (cpsrV())) ||
+               ((!(cpsrN())) && (!(cpsrV()))))
               write_register(15, rb);
           }
           return 0;
 
         case 0xD: //b le Z==1 or N != V
           DO_DISS(statusMsg << "ble 0x" << Base::HEX8 << (rb-3) << endl);
-          if((cpsr & CPSR_Z) ||
-            (!(cpsr & CPSR_N) && (cpsr & CPSR_V)) ||
-            (((cpsr & CPSR_N)) && !(cpsr & CPSR_V)))
+          if((cpsrZ()) ||
+            (!(cpsrN()) && (cpsrV())) ||
+            (((cpsrN())) && !(cpsrV())))
               write_register(15, rb);
           return 0;
 
@@ -1619,7 +1999,7 @@ int Thumbulator::execute()
       {
         if(inst & rb)
         {
-          write_register(ra, read32(sp));
+          write_register(ra, read32<fast>(sp));
           sp += 4;
         }
       }
@@ -1638,7 +2018,7 @@ int Thumbulator::execute()
       rb <<= 2;
       DO_DISS(statusMsg << "ldr r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
       rb = read_register(rn) + rb;
-      rc = read32(rb);
+      rc = read32<fast>(rb);
       write_register(rd, rc);
       return 0;
     }
@@ -1650,7 +2030,7 @@ int Thumbulator::execute()
       rm = (inst >> 6) & 0x7;
       DO_DISS(statusMsg << "ldr r" << dec << rd << ",[r" << dec << rn << ",r" << dec << "]" << endl);
       rb = read_register(rn) + read_register(rm);
-      rc = read32(rb);
+      rc = read32<fast>(rb);
       write_register(rd, rc);
       return 0;
     }
@@ -1665,7 +2045,7 @@ int Thumbulator::execute()
       ra &= ~3;
       rb += ra;
       DO_DISS(statusMsg << ";@ 0x" << Base::HEX2 << rb << endl);
-      rc = read32(rb);
+      rc = read32<fast>(rb);
       write_register(rd, rc);
       return 0;
     }
@@ -1679,7 +2059,7 @@ int Thumbulator::execute()
       ra = read_register(13);
       //ra&=~3;
       rb += ra;
-      rc = read32(rb);
+      rc = read32<fast>(rb);
       write_register(rd, rc);
       return 0;
     }
@@ -1692,9 +2072,9 @@ int Thumbulator::execute()
       DO_DISS(statusMsg << "ldrb r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
       rb = read_register(rn) + rb;
 #ifndef UNSAFE_OPTIMIZATIONS
-      rc = read16(rb & (~1u));
+      rc = read16<fast>(rb & (~1u));
 #else
-      rc = read16(rb);
+      rc = read16<fast>(rb);
 #endif
       if(rb & 1)
       {
@@ -1715,9 +2095,9 @@ int Thumbulator::execute()
       DO_DISS(statusMsg << "ldrb r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
       rb = read_register(rn) + read_register(rm);
 #ifndef UNSAFE_OPTIMIZATIONS
-      rc = read16(rb & (~1u));
+      rc = read16<fast>(rb & (~1u));
 #else
-      rc = read16(rb);
+      rc = read16<fast>(rb);
 #endif
       if(rb & 1)
       {
@@ -1735,7 +2115,7 @@ int Thumbulator::execute()
       rb <<= 1;
       DO_DISS(statusMsg << "ldrh r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
       rb = read_register(rn) + rb;
-      rc = read16(rb);
+      rc = read16<fast>(rb);
       write_register(rd, rc & 0xFFFF);
       return 0;
     }
@@ -1747,7 +2127,7 @@ int Thumbulator::execute()
       rm = (inst >> 6) & 0x7;
       DO_DISS(statusMsg << "ldrh r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
       rb = read_register(rn) + read_register(rm);
-      rc = read16(rb);
+      rc = read16<fast>(rb);
       write_register(rd, rc & 0xFFFF);
       return 0;
     }
@@ -1760,9 +2140,9 @@ int Thumbulator::execute()
       DO_DISS(statusMsg << "ldrsb r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
       rb = read_register(rn) + read_register(rm);
 #ifndef UNSAFE_OPTIMIZATIONS
-      rc = read16(rb & (~1u));
+      rc = read16<fast>(rb & (~1u));
 #else
-      rc = read16(rb);
+      rc = read16<fast>(rb);
 #endif
       if(rb & 1)
       {
@@ -1782,7 +2162,7 @@ int Thumbulator::execute()
       rm = (inst >> 6) & 0x7;
       DO_DISS(statusMsg << "ldrsh r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
       rb = read_register(rn) + read_register(rm);
-      rc = read16(rb);
+      rc = read16<fast>(rb);
       rc &= 0xFFFF;
       if(rc & 0x8000)
         rc |= ((~0u) << 16);
@@ -2031,13 +2411,13 @@ int Thumbulator::execute()
       {
         if(inst & rb)
         {
-          write_register(ra, read32(sp));
+          write_register(ra, read32<fast>(sp));
           sp += 4;
         }
       }
       if(inst & 0x100)
       {
-        rc = read32(sp);
+        rc = read32<fast>(sp);
         rc += 2;
         write_register(15, rc);
         sp += 4;
@@ -2084,14 +2464,14 @@ int Thumbulator::execute()
       {
         if(inst & rb)
         {
-          write32(rd, read_register(ra));
+          write32<fast>(rd, read_register(ra));
           rd += 4;
         }
       }
       if(inst & 0x100)
       {
         rc = read_register(14);
-        write32(rd, rc);
+        write32<fast>(rd, rc);
         if((rc & 1) == 0)
         {
           // FIXME fprintf(stderr,"push {lr} with an ARM address pc 0x%08X popped 0x%08X\n",pc,rc);
@@ -2183,11 +2563,11 @@ int Thumbulator::execute()
       ra = read_register(rd);
       rb = read_register(rm);
       rc = ra - rb;
-      if(!(cpsr & CPSR_C)) --rc;
+      if(!(cpsrC())) --rc;
       write_register(rd, rc);
       do_nflag(rc);
       do_zflag(rc);
-      if(cpsr & CPSR_C)
+      if(cpsrC())
       {
         do_cflag(ra, ~rb, 1);
         do_vflag(ra, ~rb, 1);
@@ -2230,7 +2610,7 @@ int Thumbulator::execute()
       {
         if(inst & rb)
         {
-          write32(sp, read_register(ra));
+          write32<fast>(sp, read_register(ra));
           sp += 4;
         }
       }
@@ -2247,7 +2627,7 @@ int Thumbulator::execute()
       DO_DISS(statusMsg << "str r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
       rb = read_register(rn) + rb;
       rc = read_register(rd);
-      write32(rb, rc);
+      write32<fast>(rb, rc);
       return 0;
     }
 
@@ -2259,7 +2639,7 @@ int Thumbulator::execute()
       DO_DISS(statusMsg << "str r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
       rb = read_register(rn) + read_register(rm);
       rc = read_register(rd);
-      write32(rb, rc);
+      write32<fast>(rb, rc);
       return 0;
     }
 
@@ -2272,7 +2652,7 @@ int Thumbulator::execute()
       rb = read_register(13) + rb;
       //fprintf(stderr,"0x%08X\n",rb);
       rc = read_register(rd);
-      write32(rb, rc);
+      write32<fast>(rb, rc);
       return 0;
     }
 
@@ -2285,9 +2665,9 @@ int Thumbulator::execute()
       rb = read_register(rn) + rb;
       rc = read_register(rd);
 #ifndef UNSAFE_OPTIMIZATIONS
-      ra = read16(rb & (~1u));
+      ra = read16<fast>(rb & (~1u));
 #else
-      ra = read16(rb);
+      ra = read16<fast>(rb);
 #endif
       if(rb & 1)
       {
@@ -2299,7 +2679,7 @@ int Thumbulator::execute()
         ra &= 0xFF00;
         ra |= rc & 0x00FF;
       }
-      write16(rb & (~1u), ra & 0xFFFF);
+      write16<fast>(rb & (~1u), ra & 0xFFFF);
       return 0;
     }
 
@@ -2312,9 +2692,9 @@ int Thumbulator::execute()
       rb = read_register(rn) + read_register(rm);
       rc = read_register(rd);
 #ifndef UNSAFE_OPTIMIZATIONS
-      ra = read16(rb & (~1u));
+      ra = read16<fast>(rb & (~1u));
 #else
-      ra = read16(rb);
+      ra = read16<fast>(rb);
 #endif
       if(rb & 1)
       {
@@ -2326,7 +2706,7 @@ int Thumbulator::execute()
         ra &= 0xFF00;
         ra |= rc & 0x00FF;
       }
-      write16(rb & (~1u), ra & 0xFFFF);
+      write16<fast>(rb & (~1u), ra & 0xFFFF);
       return 0;
     }
 
@@ -2339,7 +2719,7 @@ int Thumbulator::execute()
       DO_DISS(statusMsg << "strh r" << dec << rd << ",[r" << dec << rn << ",#0x" << Base::HEX2 << rb << "]" << endl);
       rb = read_register(rn) + rb;
       rc=  read_register(rd);
-      write16(rb, rc & 0xFFFF);
+      write16<fast>(rb, rc & 0xFFFF);
       return 0;
     }
 
@@ -2351,7 +2731,7 @@ int Thumbulator::execute()
       DO_DISS(statusMsg << "strh r" << dec << rd << ",[r" << dec << rn << ",r" << dec << rm << "]" << endl);
       rb = read_register(rn) + read_register(rm);
       rc = read_register(rd);
-      write16(rb, rc & 0xFFFF);
+      write16<fast>(rb, rc & 0xFFFF);
       return 0;
     }
 
@@ -2421,7 +2801,7 @@ int Thumbulator::execute()
 
       if((inst & 0xFF) == 0xCC)
       {
-        write_register(0, cpsr);
+        write_register(0, read_cpsr());
         return 0;
       }
       else
@@ -2512,28 +2892,15 @@ int Thumbulator::execute()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int Thumbulator::reset()
 {
-  std::fill(reg_norm, reg_norm+12, 0);
-  reg_norm[13] = 0x40001FB4;
-
-  switch(configuration)
-  {
-    // future 2K Harmony/Melody drivers will most likely use these settings
-    case ConfigureFor::BUS:
-    case ConfigureFor::CDF:
-    case ConfigureFor::CDF1:
-    case ConfigureFor::CDFJ:
-      reg_norm[14] = 0x00000800; // Link Register
-      reg_norm[15] = 0x0000080B; // Program Counter
-      break;
-
-    // future 3K Harmony/Melody drivers will most likely use these settings
-    case ConfigureFor::DPCplus:
-      reg_norm[14] = 0x00000C00; // Link Register
-      reg_norm[15] = 0x00000C0B; // Program Counter
-      break;
-  }
-
-  cpsr = mamcr = 0;
+  // r12 is carried over from the previous call
+  std::copy(reg_entry, reg_entry+12, reg_norm);
+  std::copy(reg_entry+13, reg_entry+16, reg_norm+13);
+
+  // clear all flags
+  flagN = 0;  flagZ = 1;
+  flagCa = flagCb = flagCc = 0;
+  flagVa = flagVb = flagVc = 0;
+  mamcr = 0;
   handler_mode = false;
 
   systick_ctrl = 0x00000004;
@@ -2544,7 +2911,8 @@ int Thumbulator::reset()
   // fxq: don't care about below so much (maybe to guess timing???)
 #ifndef UNSAFE_OPTIMIZATIONS
   instructions = 0;
-  statusMsg.str("");
+  if(statusMsg.tellp() > 0)
+    statusMsg.str("");
 #endif
 #ifndef NO_THUMB_STATS
   fetches = reads = writes = 0;
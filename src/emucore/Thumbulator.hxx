@@ -26,6 +26,11 @@
 #define THUMBULATOR_HXX
 
 class Cartridge;
+class ThumbProfiler;
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #include "bspf.hxx"
 #include "Console.hxx"
@@ -62,6 +67,7 @@ class Thumbulator
     Thumbulator(const uInt16* rom_ptr, uInt16* ram_ptr, uInt16 rom_size,
                 bool traponfatal, Thumbulator::ConfigureFor configurefor,
                 Cartridge* cartridge);
+    ~Thumbulator();
 
     /**
       Run the ARM code, and return when finished.  A runtime_error exception is
@@ -74,6 +80,28 @@ class Thumbulator
     string run();
     string run(uInt32 cycles);
 
+    /**
+      Run the ARM code on a thread of its own instead of in the caller.
+      While enabled, start() returns immediately, and the caller must call
+      sync() before it touches anything the ARM code can access as well
+      (cartridge RAM and any state changed through thumbCallback()).
+
+      @param enable  Use the ARM thread or not (the default)
+    */
+    void setAsync(bool enable);
+
+    /**
+      Start running the ARM code, either right away (as run() does) or on
+      the ARM thread (see setAsync()).  Errors are thrown from whichever of
+      start() and sync() waits for the ARM code to finish.
+    */
+    void start(uInt32 cycles);
+
+    /**
+      Wait until ARM code started by start() has finished.
+    */
+    void sync() { if(myPending) finish(); }
+
 #ifndef UNSAFE_OPTIMIZATIONS
     /**
       Normally when a fatal error is encountered, the ARM emulation
@@ -97,6 +125,25 @@ class Thumbulator
     */
     void setConsoleTiming(ConsoleTiming timing);
 
+    /**
+      Count the cycles of all ARM code run from now on in the given
+      profiler; the null pointer stops profiling.  The ARM code must not be
+      running (see sync()).
+    */
+    void setProfiler(ThumbProfiler* profiler) { myProfiler = profiler; }
+
+    /**
+      Run the ARM code in fast mode, for drivers known not to depend on the
+      details of the emulation: accesses to flash and RAM aren't checked for
+      being misaligned or writing to the driver area, and aren't counted.
+      The ARM timer and the instruction limit of a run are kept.  Profiling
+      always runs in the normal mode.  The ARM code must not be running
+      (see sync()).
+
+      @param enable  Use the fast mode or not (the default)
+    */
+    void setFastMode(bool enable) { myFastMode = enable; }
+
   private:
 
     enum class Op : uInt8 {
@@ -153,13 +200,24 @@ class Thumbulator
     uInt32 read_register(uInt32 reg);
     void write_register(uInt32 reg, uInt32 data);
     uInt32 fetch16(uInt32 addr);
-    uInt32 read16(uInt32 addr);
-    uInt32 read32(uInt32 addr);
+    template<bool fast> uInt32 read16(uInt32 addr);
+    template<bool fast> uInt32 read32(uInt32 addr);
 #ifndef UNSAFE_OPTIMIZATIONS
-    bool isProtected(uInt32 addr);
+    bool isProtected(uInt32 addr) const {
+      addr -= 0x40000000;
+      return addr > 0x0028 && addr < protectedEnd &&
+             (addr < unprotectedStart || addr >= unprotectedEnd);
+    }
 #endif
-    void write16(uInt32 addr, uInt32 data);
-    void write32(uInt32 addr, uInt32 data);
+    template<bool fast> void write16(uInt32 addr, uInt32 data);
+    template<bool fast> void write32(uInt32 addr, uInt32 data);
+
+    // Accesses which don't go to flash or RAM directly: the peripherals,
+    // and anything out of range or misaligned
+    uInt32 readSlow16(uInt32 addr);
+    uInt32 readSlow32(uInt32 addr);
+    void writeSlow16(uInt32 addr, uInt32 data);
+    void writeSlow32(uInt32 addr, uInt32 data);
     void updateTimer(uInt32 cycles);
 
     static Op decodeInstructionWord(uint16_t inst);
@@ -171,6 +229,13 @@ class Thumbulator
     void do_cflag_bit(uInt32 x);
     void do_vflag_bit(uInt32 x);
 
+    // Materialize the (lazily evaluated) condition flags
+    bool cpsrN() const;
+    bool cpsrZ() const;
+    bool cpsrC() const;
+    bool cpsrV() const;
+    uInt32 read_cpsr() const;
+
 #ifndef UNSAFE_OPTIMIZATIONS
     // Throw a runtime_error exception containing an error referencing the
     // given message and variables
@@ -181,17 +246,68 @@ class Thumbulator
     void dump_counters();
     void dump_regs();
 #endif
-    int execute();
+    template<bool fast> int execute();
+    template<bool fast> void runUntilExit();
     int reset();
 
+#ifndef NO_THUMB_STATS
+    // Run the ARM code, counting the cycles of each instruction
+    void runProfiled();
+
+    // The instruction at the given address, without counting a fetch
+    uInt32 peekInstruction(uInt32 addr) const;
+#endif
+
+    void finish();
+    void threadLoop();
+    void stopThread();
+
+    // The memory map by the top four bits of the address, in the style of
+    // System::PageAccess; flash and RAM are accessed through the direct
+    // pointers, everything else is left to the slow paths
+    struct MemoryRegion {
+      const uInt16* directReadBase;
+      uInt16* directWriteBase;
+      uInt32 size;  // in bytes, a power of two
+    };
+
+#ifndef UNSAFE_OPTIMIZATIONS
+    // RAM may be rewritten at any time (by the ARM code itself as well as
+    // by the cartridge), so each decoded op remembers the instruction word
+    // it was decoded from and is only reused while that word is unchanged
+    struct DecodedRamWord {
+      uInt16 inst;
+      Op op;
+    };
+#endif
+
   private:
     const uInt16* rom;
     uInt16 romSize;
     const unique_ptr<Op[]> decodedRom;
     uInt16* ram;
+#ifndef UNSAFE_OPTIMIZATIONS
+    const unique_ptr<DecodedRamWord[]> decodedRam;
+#endif
+    MemoryRegion regions[16];
+#ifndef UNSAFE_OPTIMIZATIONS
+    // The driver area in RAM the ARM code must not write to, at offsets
+    // 0x29 to protectedEnd except for [unprotectedStart, unprotectedEnd)
+    uInt32 protectedEnd, unprotectedStart, unprotectedEnd;
+#endif
 
     uInt32 reg_norm[16]; // normal execution mode, do not have a thread mode
-    uInt32 cpsr, mamcr;
+    uInt32 reg_entry[16]; // registers on entry to the driver
+    // The condition flags are evaluated lazily; ALU ops only record the
+    // values a flag is derived from, since most flags are overwritten
+    // before anything reads them:
+    //   N = bit 31 of flagN, Z = (flagZ == 0),
+    //   C = carry out of flagCa + flagCb + flagCc,
+    //   V = signed overflow of flagVa + flagVb + flagVc
+    uInt32 flagN, flagZ;
+    uInt32 flagCa, flagCb, flagCc;
+    uInt32 flagVa, flagVb, flagVc;
+    uInt32 mamcr;
     bool handler_mode;
     uInt32 systick_ctrl, systick_reload, systick_count, systick_calibrate;
 #ifndef UNSAFE_OPTIMIZATIONS
@@ -218,6 +334,22 @@ class Thumbulator
 
     Cartridge* myCartridge;
 
+    ThumbProfiler* myProfiler;
+
+    bool myFastMode;
+
+    // The ARM thread, and the state used to hand runs to it and back
+    std::thread myThread;
+    std::mutex myMutex;
+    std::condition_variable myCondition;
+    uInt32 myCycles;
+    bool myStart, myDone, myQuit;
+    string myError;
+
+    // Set while a run started on the ARM thread hasn't been synced yet;
+    // only accessed by the thread calling start() and sync()
+    bool myPending;
+
   private:
     // Following constructors and assignment operators not supported
     Thumbulator() = delete;
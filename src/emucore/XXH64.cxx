@@ -0,0 +1,184 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#include "XXH64.hxx"
+
+namespace {
+  constexpr uInt64 PRIME1 = 0x9E3779B185EBCA87ULL;
+  constexpr uInt64 PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+  constexpr uInt64 PRIME3 = 0x165667B19E3779F9ULL;
+  constexpr uInt64 PRIME4 = 0x85EBCA77C2B2AE63ULL;
+  constexpr uInt64 PRIME5 = 0x27D4EB2F165667C5ULL;
+
+  inline uInt64 rotl(uInt64 x, uInt32 r)
+  {
+    return (x << r) | (x >> (64 - r));
+  }
+
+  // Compilers turn these into plain loads on little endian CPUs
+  inline uInt64 read64(const uInt8* p)
+  {
+    return uInt64(p[0])       | uInt64(p[1]) << 8  | uInt64(p[2]) << 16 |
+           uInt64(p[3]) << 24 | uInt64(p[4]) << 32 | uInt64(p[5]) << 40 |
+           uInt64(p[6]) << 48 | uInt64(p[7]) << 56;
+  }
+
+  inline uInt32 read32(const uInt8* p)
+  {
+    return uInt32(p[0]) | uInt32(p[1]) << 8 | uInt32(p[2]) << 16 | uInt32(p[3]) << 24;
+  }
+
+  inline uInt64 round(uInt64 acc, uInt64 input)
+  {
+    return rotl(acc + input * PRIME2, 31) * PRIME1;
+  }
+
+  inline uInt64 mergeRound(uInt64 acc, uInt64 lane)
+  {
+    return (acc ^ round(0, lane)) * PRIME1 + PRIME4;
+  }
+
+  // Consume as many 32 byte stripes as possible, one lane per 8 bytes
+  inline size_t stripes(uInt64* lanes, const uInt8* p, size_t length)
+  {
+    uInt64 v1 = lanes[0], v2 = lanes[1], v3 = lanes[2], v4 = lanes[3];
+    size_t i = 0;
+
+    for(; i + 32 <= length; i += 32)
+    {
+      v1 = round(v1, read64(p + i));
+      v2 = round(v2, read64(p + i + 8));
+      v3 = round(v3, read64(p + i + 16));
+      v4 = round(v4, read64(p + i + 24));
+    }
+
+    lanes[0] = v1;  lanes[1] = v2;  lanes[2] = v3;  lanes[3] = v4;
+    return i;
+  }
+}
+
+namespace XXH64 {
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 hash(const uInt8* buffer, size_t length, uInt64 seed)
+{
+  Hasher hasher(seed);
+  hasher.update(buffer, length);
+
+  return hasher.digest();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string toString(uInt64 hash)
+{
+  static constexpr char HEX[] = "0123456789abcdef";
+  char digits[16];
+
+  for(int i = 15; i >= 0; --i, hash >>= 4)
+    digits[i] = HEX[hash & 0xf];
+
+  return string(digits, 16);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Hasher::Hasher(uInt64 seed)
+  : mySeed(seed)
+{
+  reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Hasher::reset()
+{
+  myLanes[0] = mySeed + PRIME1 + PRIME2;
+  myLanes[1] = mySeed + PRIME2;
+  myLanes[2] = mySeed;
+  myLanes[3] = mySeed - PRIME1;
+  myLength = 0;
+  myBuffered = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Hasher::update(const uInt8* buffer, size_t length)
+{
+  myLength += length;
+
+  // Complete a stripe started by the last update
+  if(myBuffered > 0)
+  {
+    const size_t fill = std::min(length, size_t(32 - myBuffered));
+    memcpy(myBuffer + myBuffered, buffer, fill);
+    myBuffered += uInt32(fill);
+    buffer += fill;
+    length -= fill;
+
+    if(myBuffered < 32)
+      return;
+
+    stripes(myLanes, myBuffer, 32);
+    myBuffered = 0;
+  }
+
+  const size_t done = stripes(myLanes, buffer, length);
+
+  memcpy(myBuffer, buffer + done, length - done);
+  myBuffered = uInt32(length - done);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 Hasher::digest() const
+{
+  uInt64 h;
+
+  if(myLength >= 32)
+  {
+    h = rotl(myLanes[0], 1) + rotl(myLanes[1], 7) +
+        rotl(myLanes[2], 12) + rotl(myLanes[3], 18);
+    for(uInt32 i = 0; i < 4; ++i)
+      h = mergeRound(h, myLanes[i]);
+  }
+  else
+    h = mySeed + PRIME5;
+
+  h += myLength;
+
+  // The remaining bytes, which don't fill a stripe
+  const uInt8* p = myBuffer;
+  uInt32 left = myBuffered;
+
+  for(; left >= 8; p += 8, left -= 8)
+    h = rotl(h ^ round(0, read64(p)), 27) * PRIME1 + PRIME4;
+  if(left >= 4)
+  {
+    h = rotl(h ^ (uInt64(read32(p)) * PRIME1), 23) * PRIME2 + PRIME3;
+    p += 4;  left -= 4;
+  }
+  for(; left > 0; ++p, --left)
+    h = rotl(h ^ (*p * PRIME5), 11) * PRIME1;
+
+  // Avalanche
+  h ^= h >> 33;
+  h *= PRIME2;
+  h ^= h >> 29;
+  h *= PRIME3;
+  h ^= h >> 32;
+
+  return h;
+}
+
+}  // Namespace XXH64
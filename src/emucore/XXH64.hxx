@@ -0,0 +1,86 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+
+#ifndef XXH64_HXX
+#define XXH64_HXX
+
+#include "bspf.hxx"
+
+/**
+  The XXH64 hash by Yann Collet, a fast non-cryptographic 64-bit hash.
+  It processes 32 bytes at a time in four independent lanes, which keeps
+  the pipelines of the CPU busy, and hashes several GB per second.
+
+  It is meant for comparing large amounts of data quickly (e.g. the frame
+  buffer and the audio of every frame, in regression tests); use MD5 where
+  the hash identifies something (e.g. a ROM).  Data is read as little
+  endian, so the results are the same as those of the reference
+  implementation on all platforms.
+*/
+namespace XXH64 {
+
+/**
+  Get the hash of the given data.
+
+  @param buffer The data to compute the hash of
+  @param length The length of the data
+  @param seed   The seed, which gives a different hash function
+  @return The hash
+*/
+uInt64 hash(const uInt8* buffer, size_t length, uInt64 seed = 0);
+
+/**
+  Get a hash as 16 hexadecimal digits.
+*/
+string toString(uInt64 hash);
+
+/**
+  Calculates a hash incrementally, for data which is processed in pieces.
+  The result is the same as hashing all pieces at once.
+*/
+class Hasher
+{
+  public:
+    explicit Hasher(uInt64 seed = 0);
+
+    /**
+      Append the given data.
+    */
+    void update(const uInt8* buffer, size_t length);
+
+    /**
+      Get the hash of the data appended so far.
+    */
+    uInt64 digest() const;
+
+    /**
+      Start over with no data.
+    */
+    void reset();
+
+  private:
+    uInt64 mySeed;
+    uInt64 myLanes[4];
+    uInt64 myLength;
+    uInt8 myBuffer[32];
+    uInt32 myBuffered;
+};
+
+}  // Namespace XXH64
+
+#endif
@@ -3,6 +3,8 @@ MODULE := src/emucore
 MODULE_OBJS := \
 	src/emucore/AtariVox.o \
 	src/emucore/Bankswitch.o \
+	src/emucore/BatchRunner.o \
+	src/emucore/BenchmarkRunner.o \
 	src/emucore/Booster.o \
 	src/emucore/Cart.o \
 	src/emucore/CartDetector.o \
@@ -51,6 +53,7 @@ MODULE_OBJS := \
 	src/emucore/CartX07.o \
 	src/emucore/CompuMate.o \
 	src/emucore/Console.o \
+	src/emucore/ConsoleBatch.o \
 	src/emucore/Control.o \
 	src/emucore/ControllerDetector.o \
 	src/emucore/DispatchResult.o \
@@ -62,6 +65,8 @@ MODULE_OBJS := \
 	src/emucore/FBSurface.o \
 	src/emucore/FSNode.o \
 	src/emucore/Genesis.o \
+	src/emucore/HeadlessConsole.o \
+	src/emucore/InputMovie.o \
 	src/emucore/Joystick.o \
 	src/emucore/Keyboard.o \
 	src/emucore/KidVid.o \
@@ -74,15 +79,22 @@ MODULE_OBJS := \
 	src/emucore/Paddles.o \
 	src/emucore/PointingDevice.o \
 	src/emucore/ProfilingRunner.o \
+	src/emucore/ReplayRunner.o \
 	src/emucore/Props.o \
 	src/emucore/PropsSet.o \
 	src/emucore/SaveKey.o \
+	src/emucore/ScriptRunner.o \
 	src/emucore/Serializer.o \
 	src/emucore/Settings.o \
+	src/emucore/SignatureScanner.o \
+	src/emucore/StateProfile.o \
+	src/emucore/StateProfileRunner.o \
 	src/emucore/Switches.o \
 	src/emucore/System.o \
 	src/emucore/TIASurface.o \
-	src/emucore/Thumbulator.o
+	src/emucore/ThumbProfiler.o \
+	src/emucore/Thumbulator.o \
+	src/emucore/XXH64.o
 
 MODULE_DIRS += \
 	src/emucore
@@ -36,7 +36,12 @@ namespace {
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Audio::Audio()
   : myAudioQueue(nullptr),
-    myCurrentFragment(nullptr)
+    myCurrentFragment(nullptr),
+    myMuted(false),
+    mySampleBuffer(nullptr),
+    mySampleBufferCapacity(0),
+    mySampleBufferSize(0),
+    myStereo(false)
 {
   for (uInt8 i = 0; i <= 0x1e; ++i) myMixingTableSum[i] = mixingTableEntry(i, 0x1e);
   for (uInt8 i = 0; i <= 0x0f; ++i) myMixingTableIndividual[i] = mixingTableEntry(i, 0x0f);
@@ -61,6 +66,24 @@ void Audio::setAudioQueue(shared_ptr<AudioQueue> queue)
 
   myCurrentFragment = myAudioQueue->enqueue();
   mySampleIndex = 0;
+  myStereo = myAudioQueue->isStereo();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Audio::setSampleBuffer(Int16* buffer, uInt32 capacity)
+{
+  mySampleBuffer = buffer;
+  mySampleBufferCapacity = buffer ? capacity : 0;
+  mySampleBufferSize = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Audio::takeSamples()
+{
+  const uInt32 samples = mySampleBufferSize;
+  mySampleBufferSize = 0;
+
+  return samples;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -83,15 +106,51 @@ void Audio::tick()
   if (++myCounter == 228) myCounter = 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Audio::tick(uInt32 clocks)
+{
+  while (clocks > 0) {
+    // The next clock handled by tick(), or the end of the line
+    const uInt32 next =
+      myCounter <= 9 ? 9 : myCounter <= 37 ? 37 : myCounter <= 81 ? 81 :
+      myCounter <= 149 ? 149 : 228;
+    const uInt32 skip = std::min(clocks, next - myCounter);
+
+    myCounter += skip;
+    clocks -= skip;
+
+    if (myCounter == 228) myCounter = 0;
+    else if (clocks > 0) {
+      tick();
+      --clocks;
+    }
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Audio::phase1()
 {
   uInt8 sample0 = myChannel0.phase1();
   uInt8 sample1 = myChannel1.phase1();
 
+  if (myMuted) return;
+
+  if (mySampleBuffer) {
+    if (mySampleBufferSize < mySampleBufferCapacity) {
+      Int16* out = mySampleBuffer + 2 * mySampleBufferSize++;
+
+      if (myStereo) {
+        out[0] = myMixingTableIndividual[sample0];
+        out[1] = myMixingTableIndividual[sample1];
+      } else
+        out[0] = out[1] = myMixingTableSum[sample0 + sample1];
+    }
+    return;
+  }
+
   if (!myAudioQueue) return;
 
-  if (myAudioQueue->isStereo()) {
+  if (myStereo) {
     myCurrentFragment[2*mySampleIndex] = myMixingTableIndividual[sample0];
     myCurrentFragment[2*mySampleIndex + 1] = myMixingTableIndividual[sample1];
   } else {
@@ -33,8 +33,38 @@ class Audio : public Serializable
 
     void setAudioQueue(shared_ptr<AudioQueue> queue);
 
+    /**
+      While muted, the channels are still clocked but no samples are
+      pushed to the audio queue.
+    */
+    void setMuted(bool muted) { myMuted = muted; }
+
+    /**
+      Write the samples straight into the given buffer, as interleaved
+      stereo, instead of pushing them to the audio queue.  This is for
+      frontends which take all samples of a frame at once, and do their
+      own resampling.  Samples which don't fit are dropped.
+
+      @param buffer    The buffer, or nullptr to use the audio queue again
+      @param capacity  The size of the buffer, in stereo samples
+    */
+    void setSampleBuffer(Int16* buffer, uInt32 capacity);
+
+    /**
+      Get the number of stereo samples written to the sample buffer since
+      the last call; the buffer is then filled from its start again.
+    */
+    uInt32 takeSamples();
+
     void tick();
 
+    /**
+      Advance the audio by the given number of color clocks, as if tick()
+      was called for each of them.  The channels only change on four clocks
+      of every line, so everything in between is skipped in one go.
+    */
+    void tick(uInt32 clocks);
+
     AudioChannel& channel0();
 
     AudioChannel& channel1();
@@ -62,6 +92,14 @@ class Audio : public Serializable
     Int16* myCurrentFragment;
     uInt32 mySampleIndex;
 
+    bool myMuted;
+
+    // Direct output of the samples, bypassing the audio queue
+    Int16* mySampleBuffer;
+    uInt32 mySampleBufferCapacity;
+    uInt32 mySampleBufferSize;
+    bool myStereo;
+
   private:
     Audio(const Audio&) = delete;
     Audio(Audio&&) = delete;
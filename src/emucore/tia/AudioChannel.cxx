@@ -17,6 +17,104 @@
 
 #include "AudioChannel.hxx"
 
+namespace {
+  /**
+    The polynomial counter logic of phase0() and phase1(), evaluated in
+    advance for all AUDC values and counter states.
+  */
+  struct CounterTables
+  {
+    // The clocked part of phase0(), indexed by AUDC, noise counter and
+    // pulse counter; bit 0 is the new noise counter bit 4, bit 1 the pulse
+    // counter hold, and bit 2 the noise feedback
+    uInt8 phase0[16][32][16];
+
+    // The pulse feedback of phase1(), indexed by AUDC, pulse counter and
+    // noise counter bit 4
+    bool pulseFeedback[16][16][2];
+
+    CounterTables();
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  CounterTables::CounterTables()
+  {
+    for (uInt8 audc = 0; audc < 16; ++audc)
+      for (uInt8 noise = 0; noise < 32; ++noise)
+        for (uInt8 pulse = 0; pulse < 16; ++pulse) {
+          const bool noiseCounterBit4 = noise & 0x01;
+          bool pulseCounterHold = false, noiseFeedback = false;
+
+          switch (audc & 0x03) {
+            case 0x00:
+            case 0x01:
+              pulseCounterHold = false;
+              break;
+
+            case 0x02:
+              pulseCounterHold = (noise & 0x1e) != 0x02;
+              break;
+
+            case 0x03:
+              pulseCounterHold = !noiseCounterBit4;
+              break;
+          }
+
+          switch (audc & 0x03) {
+            case 0x00:
+              noiseFeedback =
+                ((pulse ^ noise) & 0x01) ||
+                !(noise || (pulse != 0x0a)) ||
+                !(audc & 0x0c);
+
+              break;
+
+            default:
+              noiseFeedback =
+                (((noise & 0x04) ? 1 : 0) ^ (noise & 0x01)) ||
+                noise == 0;
+
+            break;
+          }
+
+          phase0[audc][noise][pulse] =
+            (noiseCounterBit4 ? 0x01 : 0) | (pulseCounterHold ? 0x02 : 0) | (noiseFeedback ? 0x04 : 0);
+        }
+
+    for (uInt8 audc = 0; audc < 16; ++audc)
+      for (uInt8 pulse = 0; pulse < 16; ++pulse)
+        for (uInt8 noiseCounterBit4 = 0; noiseCounterBit4 < 2; ++noiseCounterBit4) {
+          bool feedback = false;
+
+          switch (audc >> 2) {
+            case 0x00:
+              feedback =
+                (((pulse & 0x02) ? 1 : 0) ^ (pulse & 0x01)) &&
+                (pulse != 0x0a) &&
+                (audc & 0x03);
+
+              break;
+
+            case 0x01:
+              feedback = !(pulse & 0x08);
+              break;
+
+            case 0x02:
+              feedback = !noiseCounterBit4;
+              break;
+
+            case 0x03:
+              feedback = !((pulse & 0x02) || !(pulse & 0x0e));
+              break;
+          }
+
+          pulseFeedback[audc][pulse][noiseCounterBit4] = feedback;
+        }
+  }
+
+  const CounterTables counterTables;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 AudioChannel::AudioChannel()
 {
@@ -35,39 +133,11 @@ void AudioChannel::reset()
 void AudioChannel::phase0()
 {
   if (myClockEnable) {
-    myNoiseCounterBit4 = myNoiseCounter & 0x01;
+    const uInt8 outcome = counterTables.phase0[myAudc][myNoiseCounter & 0x1f][myPulseCounter & 0x0f];
 
-    switch (myAudc & 0x03) {
-      case 0x00:
-      case 0x01:
-        myPulseCounterHold = false;
-        break;
-
-      case 0x02:
-        myPulseCounterHold = (myNoiseCounter & 0x1e) != 0x02;
-        break;
-
-      case 0x03:
-        myPulseCounterHold = !myNoiseCounterBit4;
-        break;
-    }
-
-    switch (myAudc & 0x03) {
-      case 0x00:
-        myNoiseFeedback =
-          ((myPulseCounter ^ myNoiseCounter) & 0x01) ||
-          !(myNoiseCounter || (myPulseCounter != 0x0a)) ||
-          !(myAudc & 0x0c);
-
-        break;
-
-      default:
-        myNoiseFeedback =
-          (((myNoiseCounter & 0x04) ? 1 : 0) ^ (myNoiseCounter & 0x01)) ||
-          myNoiseCounter == 0;
-
-      break;
-    }
+    myNoiseCounterBit4 = outcome & 0x01;
+    myPulseCounterHold = outcome & 0x02;
+    myNoiseFeedback = outcome & 0x04;
   }
 
   myClockEnable = myDivCounter == myAudf;
@@ -83,28 +153,8 @@ void AudioChannel::phase0()
 uInt8 AudioChannel::phase1()
 {
   if (myClockEnable) {
-    bool pulseFeedback = false;
-    switch (myAudc >> 2) {
-      case 0x00:
-        pulseFeedback =
-          (((myPulseCounter & 0x02) ? 1 : 0) ^ (myPulseCounter & 0x01)) &&
-          (myPulseCounter != 0x0a) &&
-          (myAudc & 0x03);
-
-        break;
-
-      case 0x01:
-        pulseFeedback = !(myPulseCounter & 0x08);
-        break;
-
-      case 0x02:
-        pulseFeedback = !myNoiseCounterBit4;
-        break;
-
-      case 0x03:
-        pulseFeedback = !((myPulseCounter & 0x02) || !(myPulseCounter & 0x0e));
-        break;
-    }
+    const bool pulseFeedback =
+      counterTables.pulseFeedback[myAudc][myPulseCounter & 0x0f][myNoiseCounterBit4];
 
     myNoiseCounter >>= 1;
     if (myNoiseFeedback) {
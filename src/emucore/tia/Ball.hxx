@@ -108,6 +108,7 @@ class Ball : public Serializable
       Aid Man bug on some Jr. models.
      */
     void setInvertedPhaseClock(bool enable);
+    bool hasInvertedPhaseClock() const { return myUseInvertedPhaseClock; }
 
     /**
       Start movement --- this is triggered by strobing HMOVE.
@@ -171,8 +172,23 @@ class Ball : public Serializable
 
     /**
       Tick one color clock. Inline for performance (implementation below).
+      Without quirks, the inverted phase clock isn't checked (it must not be
+      enabled then).
      */
-    inline void tick(bool isReceivingRegularClock = true);
+    template<bool quirks = true> inline void tick(bool isReceivingRegularClock = true);
+
+    /**
+      The number of upcoming color clocks during which tick() would do nothing
+      but advance the counter (zero if the next tick must be processed). Only
+      valid while no movement is in progress.
+     */
+    template<bool quirks = true> inline uInt32 idleClocks() const;
+
+    /**
+      Equivalent to ticking the given number of idle clocks (as determined by
+      idleClocks()), but without processing each of them individually.
+     */
+    inline void skipIdleClocks(uInt32 clocks);
 
   public:
 
@@ -362,11 +378,12 @@ void Ball::movementTick(uInt32 clock, bool hblank)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool quirks>
 void Ball::tick(bool isReceivingRegularClock)
 {
   // If we are in inverted movement clock phase mode and a movement tick occurred, it
   // will supress the tick.
-  if(myUseInvertedPhaseClock && myInvertedPhaseClock)
+  if(quirks && myUseInvertedPhaseClock && myInvertedPhaseClock)
   {
     myInvertedPhaseClock = false;
     return;
@@ -412,4 +429,23 @@ void Ball::tick(bool isReceivingRegularClock)
       myCounter = 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool quirks>
+uInt32 Ball::idleClocks() const
+{
+  if (myIsRendering || (quirks && myUseInvertedPhaseClock && myInvertedPhaseClock))
+    return 0;
+
+  // Nothing happens until the counter reaches the decode value
+  return (156 + TIAConstants::H_PIXEL - myCounter) % TIAConstants::H_PIXEL;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Ball::skipIdleClocks(uInt32 clocks)
+{
+  mySignalActive = false;
+  collision = myCollisionMaskDisabled;
+  myCounter = uInt8((myCounter + clocks) % TIAConstants::H_PIXEL);
+}
+
 #endif // TIA_BALL
@@ -22,6 +22,7 @@
 #include "bspf.hxx"
 #include "smartmod.hxx"
 #include "DelayQueueMember.hxx"
+#include "PerfCounters.hxx"
 
 template<unsigned length, unsigned capacity>
 class DelayQueueIteratorImpl;
@@ -29,6 +30,8 @@ class DelayQueueIteratorImpl;
 template<unsigned length, unsigned capacity>
 class DelayQueue : public Serializable
 {
+  static_assert(length <= 32, "delay queue occupancy must fit into 32 bits");
+
   public:
     friend DelayQueueIteratorImpl<length, capacity>;
 
@@ -43,6 +46,25 @@ class DelayQueue : public Serializable
 
     template<class T> void execute(T executor);
 
+    /**
+      Answers whether there are no writes scheduled in any slot.
+    */
+    bool isEmpty() const { return myOccupancy == 0; }
+
+    /**
+      Answers the number of clocks that will pass before execute() picks
+      up the next scheduled write. If nothing is scheduled, the result is
+      larger than any possible delay.
+    */
+    uInt32 clocksToNextWrite() const;
+
+    /**
+      Advance the queue by the given number of clocks without executing
+      anything. Only valid if no writes become due during these clocks
+      (see clocksToNextWrite).
+    */
+    void skip(uInt32 clocks);
+
     /**
       Serializable methods (see that class for more information).
     */
@@ -54,6 +76,9 @@ class DelayQueue : public Serializable
     uInt8 myIndex;
     uInt8 myIndices[0xFF];
 
+    // Bit n is set if there are writes scheduled in myMembers[n]
+    uInt32 myOccupancy;
+
   private:
     DelayQueue(const DelayQueue&) = delete;
     DelayQueue(DelayQueue&&) = delete;
@@ -68,7 +93,8 @@ class DelayQueue : public Serializable
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 template<unsigned length, unsigned capacity>
 DelayQueue<length, capacity>::DelayQueue()
-  : myIndex(0)
+  : myIndex(0),
+    myOccupancy(0)
 {
   memset(myIndices, 0xFF, 0xFF);
 }
@@ -80,15 +106,20 @@ void DelayQueue<length, capacity>::push(uInt8 address, uInt8 value, uInt8 delay)
   if (delay >= length)
     throw runtime_error("delay exceeds queue length");
 
+  PERF_COUNT(delayQueuePush);
+
   uInt8 currentIndex = myIndices[address];
 
-  if (currentIndex < length)
+  if (currentIndex < length) {
     myMembers[currentIndex].remove(address);
+    if (myMembers[currentIndex].mySize == 0) myOccupancy &= ~(1 << currentIndex);
+  }
 
   uInt8 index = smartmod<length>(myIndex + delay);
   myMembers[index].push(address, value);
 
   myIndices[address] = index;
+  myOccupancy |= 1 << index;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -99,6 +130,7 @@ void DelayQueue<length, capacity>::reset()
     myMembers[i].clear();
 
   myIndex = 0;
+  myOccupancy = 0;
   memset(myIndices, 0xFF, 0xFF);
 }
 
@@ -107,6 +139,11 @@ template<unsigned length, unsigned capacity>
 template<class T>
 void DelayQueue<length, capacity>::execute(T executor)
 {
+  if ((myOccupancy & (1 << myIndex)) == 0) {
+    myIndex = smartmod<length>(myIndex + 1);
+    return;
+  }
+
   DelayQueueMember<capacity>& currentMember = myMembers[myIndex];
 
   for (uInt8 i = 0; i < currentMember.mySize; ++i) {
@@ -115,10 +152,30 @@ void DelayQueue<length, capacity>::execute(T executor)
   }
 
   currentMember.clear();
+  myOccupancy &= ~(1 << myIndex);
 
   myIndex = smartmod<length>(myIndex + 1);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<unsigned length, unsigned capacity>
+uInt32 DelayQueue<length, capacity>::clocksToNextWrite() const
+{
+  if (myOccupancy == 0) return ~0U;
+
+  uInt32 clocks = 0;
+  while ((myOccupancy & (1 << smartmod<length>(myIndex + clocks))) == 0) ++clocks;
+
+  return clocks;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<unsigned length, unsigned capacity>
+void DelayQueue<length, capacity>::skip(uInt32 clocks)
+{
+  myIndex = (myIndex + clocks) % length;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 template<unsigned length, unsigned capacity>
 bool DelayQueue<length, capacity>::save(Serializer& out) const
@@ -155,6 +212,10 @@ bool DelayQueue<length, capacity>::load(Serializer& in)
 
     myIndex = in.getByte();
     in.getByteArray(myIndices, 0xFF);
+
+    myOccupancy = 0;
+    for (uInt8 i = 0; i < length; ++i)
+      if (myMembers[i].mySize > 0) myOccupancy |= 1 << i;
   }
   catch(...)
   {
@@ -204,6 +204,43 @@ void Missile::setInvertedPhaseClock(bool enable)
   myUseInvertedPhaseClock = enable;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Missile::emitCopy(uInt32 clocks, uInt16* collision)
+{
+  if (myIsRendering || myResmp || !myDecodes[myCounter] || isMoving ||
+      (myUseInvertedPhaseClock && myInvertedPhaseClock) || clocks == 0)
+    return 0;
+
+  // A copy is cut short if the next one starts while it is rendered
+  const uInt32 maxClocks = std::min(clocks, uInt32(myWidth - renderCounterOffset + 1));
+
+  uInt32 copyClocks = 1;
+  for (uInt32 counter = myCounter; copyClocks < maxClocks; ++copyClocks)
+  {
+    if (++counter >= TIAConstants::H_PIXEL) counter = 0;
+    if (myDecodes[counter]) break;
+  }
+
+  // The first clock triggers the copy, every following one samples the
+  // state left by the clock before
+  const uInt32 firstVisible = 1 - renderCounterOffset;
+  const uInt16 visibleMask = uInt16(myIsEnabled ? myCollisionMaskEnabled : myCollisionMaskDisabled);
+
+  for (uInt32 i = 0; i < copyClocks; ++i)
+    collision[i] = i >= firstVisible ? visibleMask : uInt16(myCollisionMaskDisabled);
+
+  // Leave the missile in the state that ticking would have left it in
+  myIsVisible = copyClocks > firstVisible;
+  this->collision = (myIsVisible && myIsEnabled) ?
+                    myCollisionMaskEnabled : myCollisionMaskDisabled;
+  if (copyClocks >= firstVisible) myEffectiveWidth = myWidth;
+  myRenderCounter = Int8(renderCounterOffset + Int32(copyClocks) - 1);
+  myIsRendering = myRenderCounter < myWidth;
+  myCounter = uInt8((myCounter + copyClocks) % TIAConstants::H_PIXEL);
+
+  return copyClocks;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Missile::updateEnabled()
 {
@@ -59,6 +59,7 @@ class Missile : public Serializable
     void applyColorLoss();
 
     void setInvertedPhaseClock(bool enable);
+    bool hasInvertedPhaseClock() const { return myUseInvertedPhaseClock; }
 
     void toggleCollisions(bool enabled);
 
@@ -78,7 +79,36 @@ class Missile : public Serializable
 
     inline void movementTick(uInt8 clock, uInt8 hclock, bool hblank);
 
-    inline void tick(uInt8 hclock, bool isReceivingMclock = true);
+    /**
+      Tick one color clock. Without quirks, the inverted phase clock isn't
+      checked (it must not be enabled then).
+     */
+    template<bool quirks = true> inline void tick(uInt8 hclock, bool isReceivingMclock = true);
+
+    /**
+      The number of upcoming color clocks during which tick() would do nothing
+      but advance the counter (zero if the next tick must be processed). Only
+      valid while no movement is in progress.
+     */
+    template<bool quirks = true> inline uInt32 idleClocks() const;
+
+    /**
+      Equivalent to ticking the given number of idle clocks (as determined by
+      idleClocks()), but without processing each of them individually.
+     */
+    inline void skipIdleClocks(uInt32 clocks);
+
+    /**
+      If a copy of the missile starts at the next color clock, process up to
+      the given number of clocks of it in one go, storing the collision word
+      of each clock. Only valid while no movement is in progress.
+
+      @param clocks     The maximum number of clocks to process
+      @param collision  Receives the collision word of each clock
+      @return  The number of clocks processed (zero if the next tick must be
+               processed on its own)
+     */
+    uInt32 emitCopy(uInt32 clocks, uInt16* collision);
 
   public:
 
@@ -152,9 +182,10 @@ void Missile::movementTick(uInt8 clock, uInt8 hclock, bool hblank)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool quirks>
 void Missile::tick(uInt8 hclock, bool isReceivingMclock)
 {
-  if(myUseInvertedPhaseClock && myInvertedPhaseClock)
+  if(quirks && myUseInvertedPhaseClock && myInvertedPhaseClock)
   {
     myInvertedPhaseClock = false;
     return;
@@ -198,4 +229,30 @@ void Missile::tick(uInt8 hclock, bool isReceivingMclock)
   if (++myCounter >= TIAConstants::H_PIXEL) myCounter = 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool quirks>
+uInt32 Missile::idleClocks() const
+{
+  if (myIsRendering || (quirks && myUseInvertedPhaseClock && myInvertedPhaseClock))
+    return 0;
+
+  // A missile locked to its player never starts rendering
+  if (myResmp) return TIAConstants::H_PIXEL;
+
+  // Nothing happens until the counter reaches the next copy's decode value
+  uInt32 clocks = 0;
+  for (uInt32 counter = myCounter; clocks < TIAConstants::H_PIXEL && !myDecodes[counter]; ++clocks)
+    if (++counter >= TIAConstants::H_PIXEL) counter = 0;
+
+  return clocks;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Missile::skipIdleClocks(uInt32 clocks)
+{
+  myIsVisible = false;
+  collision = myCollisionMaskDisabled;
+  myCounter = uInt8((myCounter + clocks) % TIAConstants::H_PIXEL);
+}
+
 #endif // TIA_MISSILE
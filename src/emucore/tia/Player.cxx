@@ -21,8 +21,11 @@
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Player::Player(uInt32 collisionMask)
-  : myCollisionMaskDisabled(collisionMask),
+  : myCopyCoverage(0),
+    myCollisionMaskDisabled(collisionMask),
     myCollisionMaskEnabled(0xFFFF),
+    myCopyPattern(0),
+    myCopyDivider(0),
     myIsSuppressed(false),
     myDecodesOffset(0),
     myTIA(nullptr)
@@ -347,6 +350,78 @@ void Player::setDivider(uInt8 divider)
   myRenderCounterTripPoint = divider == 1 ? 0 : 1;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Player::emitCopy(uInt32 clocks, uInt16* collision)
+{
+  if (myIsRendering || !myDecodes[myCounter] || myDividerChangeCounter >= 0 ||
+      (myUseInvertedPhaseClock && myInvertedPhaseClock) || clocks == 0)
+    return 0;
+
+  // A copy is cut short if the next one starts while it is rendered
+  const uInt32 maxClocks = std::min(clocks, copyLength());
+
+  uInt32 copyClocks = 1;
+  for (uInt32 counter = myCounter; copyClocks < maxClocks; ++copyClocks)
+  {
+    if (++counter >= TIAConstants::H_PIXEL) counter = 0;
+    if (myDecodes[counter]) break;
+  }
+
+  if (myCopyPattern != myPattern || myCopyDivider != myDivider)
+    updateCopyCoverage();
+
+  for (uInt32 i = 0; i < copyClocks; ++i)
+    collision[i] = uInt16(((myCopyCoverage >> i) & 0x01) ?
+                          myCollisionMaskEnabled : myCollisionMaskDisabled);
+
+  // Leave the player in the state that ticking would have left it in
+  this->collision = ((myCopyCoverage >> (copyClocks - 1)) & 0x01) ?
+                    myCollisionMaskEnabled : myCollisionMaskDisabled;
+  myRenderCounter = Int8(renderCounterOffset + Int32(copyClocks) - 1);
+  mySampleCounter = sampleCounter(myRenderCounter);
+  myIsRendering = mySampleCounter <= 7;
+  myCounter = uInt8((myCounter + copyClocks) % TIAConstants::H_PIXEL);
+
+  return copyClocks;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Player::copyLength() const
+{
+  // The clock at which the sample counter passes the last pixel
+  return (myDivider == 1 ? 8 : 8 * myDivider + 1) - renderCounterOffset + 1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 Player::sampleCounter(Int32 renderCounter) const
+{
+  if (myDivider == 1)
+    return uInt8(std::max(renderCounter, 0));
+  else
+    return uInt8(renderCounter > 1 ? (renderCounter - 1) / myDivider : 0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Player::updateCopyCoverage()
+{
+  const uInt32 length = copyLength();
+
+  // The first clock triggers the copy, every following one samples the
+  // state left by the clock before
+  myCopyCoverage = 0;
+  for (uInt32 i = 1; i < length; ++i)
+  {
+    const Int32 renderCounter = renderCounterOffset + Int32(i) - 1;
+
+    if (renderCounter >= myRenderCounterTripPoint &&
+        (myPattern & (1 << sampleCounter(renderCounter))))
+      myCopyCoverage |= uInt64(1) << i;
+  }
+
+  myCopyPattern = myPattern;
+  myCopyDivider = myDivider;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Player::applyColors()
 {
@@ -59,6 +59,7 @@ class Player : public Serializable
     void applyColorLoss();
 
     void setInvertedPhaseClock(bool enable);
+    bool hasInvertedPhaseClock() const { return myUseInvertedPhaseClock; }
 
     void startMovement();
 
@@ -89,7 +90,38 @@ class Player : public Serializable
 
     inline void movementTick(uInt32 clock, bool hblank);
 
-    inline void tick();
+    /**
+      Tick one color clock. Without quirks, the inverted phase clock isn't
+      checked (it must not be enabled then).
+     */
+    template<bool quirks = true> inline void tick();
+
+    /**
+      The number of upcoming color clocks during which tick() would do nothing
+      but advance the counter (zero if the next tick must be processed). Only
+      valid while no movement is in progress.
+     */
+    template<bool quirks = true> inline uInt32 idleClocks() const;
+
+    /**
+      Equivalent to ticking the given number of idle clocks (as determined by
+      idleClocks()), but without processing each of them individually.
+     */
+    inline void skipIdleClocks(uInt32 clocks);
+
+    /**
+      If a copy of the player starts at the next color clock, process up to
+      the given number of clocks of it in one go, storing the collision word
+      of each clock. The coverage of a copy only depends on the pattern (GRP,
+      VDELP and REFP) and the size (NUSIZ), and is cached for those. Only
+      valid while no movement is in progress.
+
+      @param clocks     The maximum number of clocks to process
+      @param collision  Receives the collision word of each clock
+      @return  The number of clocks processed (zero if the next tick must be
+               processed on its own)
+     */
+    uInt32 emitCopy(uInt32 clocks, uInt16* collision);
 
   public:
 
@@ -102,6 +134,21 @@ class Player : public Serializable
     void applyColors();
     void setDivider(uInt8 divider);
 
+    /**
+      The number of clocks a copy takes, from the clock triggering it.
+     */
+    uInt32 copyLength() const;
+
+    /**
+      The sample counter while rendering, for the given render counter.
+     */
+    uInt8 sampleCounter(Int32 renderCounter) const;
+
+    /**
+      Recalculate the coverage of a copy for the current pattern and size.
+     */
+    void updateCopyCoverage();
+
   private:
 
     enum Count: Int8 {
@@ -110,37 +157,55 @@ class Player : public Serializable
 
   private:
 
-    uInt32 myCollisionMaskDisabled;
-    uInt32 myCollisionMaskEnabled;
+    // The state needed by every tick comes first, so that it shares a cache
+    // line with the collision mask; configuration and debugging state follows
 
-    uInt8 myColor;
-    uInt8 myObjectColor, myDebugColor;
-    bool myDebugEnabled;
+    const uInt8* myDecodes;
 
-    bool myIsSuppressed;
+    /**
+      The clocks of a copy which enable the collision mask (bit n for the n-th
+      clock after the copy is triggered), and the pattern and divider they
+      were calculated for.
+     */
+    uInt64 myCopyCoverage;
+
+    uInt32 myCollisionMaskDisabled;
+    uInt32 myCollisionMaskEnabled;
 
-    uInt8 myHmmClocks;
     uInt8 myCounter;
 
     bool myIsRendering;
     Int8 myRenderCounter;
     Int8 myRenderCounterTripPoint;
     uInt8 myDivider;
-    uInt8 myDividerPending;
     uInt8 mySampleCounter;
     Int8 myDividerChangeCounter;
 
-    const uInt8* myDecodes;
+    uInt8 myPattern;
+
+    bool myInvertedPhaseClock;
+    bool myUseInvertedPhaseClock;
+
+    uInt8 myColor;
+
+    uInt8 myCopyPattern;
+    uInt8 myCopyDivider;
+
+    uInt8 myObjectColor, myDebugColor;
+    bool myDebugEnabled;
+
+    bool myIsSuppressed;
+
+    uInt8 myHmmClocks;
+    uInt8 myDividerPending;
+
     uInt8 myDecodesOffset;  // needed for state saving
 
     uInt8 myPatternOld;
     uInt8 myPatternNew;
-    uInt8 myPattern;
 
     bool myIsReflected;
     bool myIsDelaying;
-    bool myInvertedPhaseClock;
-    bool myUseInvertedPhaseClock;
 
     TIA* myTIA;
 
@@ -169,9 +234,10 @@ void Player::movementTick(uInt32 clock, bool hblank)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool quirks>
 void Player::tick()
 {
-  if(myUseInvertedPhaseClock && myInvertedPhaseClock)
+  if(quirks && myUseInvertedPhaseClock && myInvertedPhaseClock)
   {
     myInvertedPhaseClock = false;
     return;
@@ -215,4 +281,26 @@ void Player::tick()
   if (++myCounter >= TIAConstants::H_PIXEL) myCounter = 0;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool quirks>
+uInt32 Player::idleClocks() const
+{
+  if (myIsRendering || (quirks && myUseInvertedPhaseClock && myInvertedPhaseClock))
+    return 0;
+
+  // Nothing happens until the counter reaches the next copy's decode value
+  uInt32 clocks = 0;
+  for (uInt32 counter = myCounter; clocks < TIAConstants::H_PIXEL && !myDecodes[counter]; ++clocks)
+    if (++counter >= TIAConstants::H_PIXEL) counter = 0;
+
+  return clocks;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Player::skipIdleClocks(uInt32 clocks)
+{
+  collision = myCollisionMaskDisabled;
+  myCounter = uInt8((myCounter + clocks) % TIAConstants::H_PIXEL);
+}
+
 #endif // TIA_PLAYER
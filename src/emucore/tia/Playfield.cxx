@@ -223,18 +223,18 @@ void Playfield::applyColors()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8 Playfield::getColor() const
+uInt8 Playfield::colorAt(uInt32 x) const
 {
   if (!myDebugEnabled)
-    return myX < TIAConstants::H_PIXEL / 2 ? myColorLeft : myColorRight;
+    return x < TIAConstants::H_PIXEL / 2 ? myColorLeft : myColorRight;
   else
   {
-    if (myX < TIAConstants::H_PIXEL / 2)
+    if (x < TIAConstants::H_PIXEL / 2)
     {
       // left side:
-      if(myX < 16)
+      if(x < 16)
         return myDebugColor - 2;    // PF0
-      if(myX < 48)
+      if(x < 48)
         return myDebugColor;        // PF1
     }
     else
@@ -242,16 +242,16 @@ uInt8 Playfield::getColor() const
       // right side:
       if(!myReflected)
       {
-        if(myX < TIAConstants::H_PIXEL / 2 + 16)
+        if(x < TIAConstants::H_PIXEL / 2 + 16)
           return myDebugColor - 2;  // PF0
-        if(myX < TIAConstants::H_PIXEL / 2 + 48)
+        if(x < TIAConstants::H_PIXEL / 2 + 48)
           return myDebugColor;      // PF1
       }
       else
       {
-        if(myX >= TIAConstants::H_PIXEL - 16)
+        if(x >= TIAConstants::H_PIXEL - 16)
           return myDebugColor - 2;  // PF0
-        if(myX >= TIAConstants::H_PIXEL - 48)
+        if(x >= TIAConstants::H_PIXEL - 48)
           return myDebugColor;      // PF1
       }
     }
@@ -259,10 +259,40 @@ uInt8 Playfield::getColor() const
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Playfield::tickSpan(uInt32 x, uInt32 clocks, uInt16* collision)
+{
+  uInt32 i = 0;
+
+  while (i < clocks) {
+    // A playfield pixel starts at a multiple of 4, which includes the
+    // positions the reflected flag is latched at
+    if ((x & 0x03) == 0) {
+      if (x == TIAConstants::H_PIXEL / 2 || x == 0) myRefp = myReflected;
+      updatePixel(x);
+    }
+
+    const uInt32 run = std::min(4 - (x & 0x03), clocks - i);
+    std::fill_n(collision + i, run, uInt16(this->collision));
+
+    i += run;
+    x += run;
+  }
+
+  if (clocks > 0) myX = x - 1;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Playfield::updatePattern()
 {
   myEffectivePattern = myIsSuppressed ? 0 : myPattern;
+
+  uInt64 reflected = 0;
+  for (uInt32 i = 0; i < 20; ++i)
+    if (myEffectivePattern & (1 << i)) reflected |= uInt64(1) << (39 - i);
+
+  myLinePattern[0] = myEffectivePattern | (uInt64(myEffectivePattern) << 20);
+  myLinePattern[1] = myEffectivePattern | reflected;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -118,7 +118,12 @@ class Playfield : public Serializable
     /**
       Get the current color.
      */
-    uInt8 getColor() const;
+    uInt8 getColor() const { return colorAt(myX); }
+
+    /**
+      Get the color at the given scanline position.
+     */
+    uInt8 colorAt(uInt32 x) const;
 
     /**
       Serializable methods (see that class for more information).
@@ -131,6 +136,17 @@ class Playfield : public Serializable
      */
     inline void tick(uInt32 x);
 
+    /**
+      Tick a span of color clocks, storing the collision word of each clock.
+      Equivalent to calling tick() for every clock, but the words are filled
+      a whole playfield pixel at a time.
+
+      @param x          The scanline position of the first clock
+      @param clocks     The number of clocks to tick
+      @param collision  Receives the collision word of each clock
+     */
+    void tickSpan(uInt32 x, uInt32 clocks, uInt16* collision);
+
   public:
 
     /**
@@ -160,8 +176,16 @@ class Playfield : public Serializable
      */
     void updatePattern();
 
+    /**
+      Update the collision word for the playfield pixel at the given position.
+     */
+    inline void updatePixel(uInt32 x);
+
   private:
 
+    // The state needed by every tick and by every rendered pixel comes first,
+    // so that it shares a cache line with the collision mask
+
     /**
       Collision mask values for active / inactive states. Disabling collisions
       will change those.
@@ -170,56 +194,68 @@ class Playfield : public Serializable
     uInt32 myCollisionMaskEnabled;
 
     /**
-      Enable / disable PF (debugging).
+      The current scanline position (0 .. 159).
      */
-    bool myIsSuppressed;
+    uInt32 myX;
 
     /**
-      Left / right PF colors. Derifed from P0 / P1 color, COLUPF and playfield mode.
+      The effective pattern expanded to the 40 pixels of a whole scanline, with
+      the right half repeated (index 0) and reflected (index 1). Derived from
+      myEffectivePattern, so only PF writes have to recalculate it.
      */
-    uInt8 myColorLeft;
-    uInt8 myColorRight;
+    uInt64 myLinePattern[2];
 
     /**
-      P0 / P1 colors
+     * Are we currently drawing the reflected PF?
      */
-    uInt8 myColorP0;
-    uInt8 myColorP1;
+    bool myRefp;
 
     /**
-      COLUPF and debug colors
+      Reflected mode on / off.
      */
-    uInt8 myObjectColor, myDebugColor;
+    bool myReflected;
+
+    /**
+      Left / right PF colors. Derifed from P0 / P1 color, COLUPF and playfield mode.
+     */
+    uInt8 myColorLeft;
+    uInt8 myColorRight;
 
     /**
       Debug colors enabled?
      */
     bool myDebugEnabled;
 
+    /**
+      COLUPF and debug colors
+     */
+    uInt8 myObjectColor, myDebugColor;
+
     /**
      * Plafield mode.
      */
     ColorMode myColorMode;
 
     /**
-      Pattern derifed from PF0, PF1, PF2
+      Enable / disable PF (debugging).
      */
-    uInt32 myPattern;
+    bool myIsSuppressed;
 
     /**
-      "Effective pattern". Will be 0 if playfield is disabled (debug), otherwise the same as myPattern.
+      P0 / P1 colors
      */
-    uInt32 myEffectivePattern;
+    uInt8 myColorP0;
+    uInt8 myColorP1;
 
     /**
-      Reflected mode on / off.
+      Pattern derifed from PF0, PF1, PF2
      */
-    bool myReflected;
+    uInt32 myPattern;
 
     /**
-     * Are we currently drawing the reflected PF?
+      "Effective pattern". Will be 0 if playfield is disabled (debug), otherwise the same as myPattern.
      */
-    bool myRefp;
+    uInt32 myEffectivePattern;
 
     /**
       PF registers.
@@ -228,11 +264,6 @@ class Playfield : public Serializable
     uInt8 myPf1;
     uInt8 myPf2;
 
-    /**
-      The current scanline position (0 .. 159).
-     */
-    uInt32 myX;
-
     /**
       TIA instance. Required for flushing the line cache.
      */
@@ -260,17 +291,15 @@ void Playfield::tick(uInt32 x)
 
   if (x & 0x03) return;
 
-  uInt32 currentPixel;
-
-  if (myEffectivePattern == 0) {
-      currentPixel = 0;
-  } else if (x < TIAConstants::H_PIXEL / 2) {
-      currentPixel = myEffectivePattern & (1 << (x >> 2));
-  } else if (myRefp) {
-      currentPixel = myEffectivePattern & (1 << (39 - (x >> 2)));
-  } else {
-      currentPixel = myEffectivePattern & (1 << ((x >> 2) - 20));
-  }
+  updatePixel(x);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Playfield::updatePixel(uInt32 x)
+{
+  const uInt32 pixel = x >> 2;
+  const bool currentPixel =
+    pixel < TIAConstants::H_PIXEL / 4 && ((myLinePattern[myRefp] >> pixel) & 0x01);
 
   collision = currentPixel ? myCollisionMaskEnabled : myCollisionMaskDisabled;
 }
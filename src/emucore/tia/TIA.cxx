@@ -24,11 +24,19 @@
 #include "frame-manager/FrameManager.hxx"
 #include "AudioQueue.hxx"
 #include "DispatchResult.hxx"
+#include "PerfCounters.hxx"
+#include "StateProfile.hxx"
 
 #ifdef DEBUGGER_SUPPORT
   #include "CartDebug.hxx"
 #endif
 
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON)
+  #include <arm_neon.h>
+#endif
+
 enum CollisionMask: uInt32 {
   player0   = 0b0111110000000000,
   player1   = 0b0100001111000000,
@@ -60,25 +68,124 @@ enum ResxCounter: uInt8 {
   frame = 157
 };
 
+constexpr uInt8 TIA::NO_WSYNC;
+constexpr uInt32 TIA::FRAME_BUFFERS;
+constexpr uInt32 TIA::FRONT_BUFFER_FRESH;
+constexpr uInt8 TIA::NO_WRITE;
+
+namespace {
+  // The settings read on every reset, hashed at compile time
+  constexpr Settings::Key DEV_SETTINGS("dev.settings");
+  constexpr Settings::Key DEV_TIA_TYPE("dev.tia.type");
+  constexpr Settings::Key DEV_TIA_PLINVPHASE("dev.tia.plinvphase");
+  constexpr Settings::Key DEV_TIA_MSINVPHASE("dev.tia.msinvphase");
+  constexpr Settings::Key DEV_TIA_BLINVPHASE("dev.tia.blinvphase");
+  constexpr Settings::Key DEV_TIA_DELAYPFBITS("dev.tia.delaypfbits");
+  constexpr Settings::Key DEV_TIA_DELAYPFCOLOR("dev.tia.delaypfcolor");
+  constexpr Settings::Key DEV_TIA_DELAYPLSWAP("dev.tia.delayplswap");
+  constexpr Settings::Key DEV_TIA_DELAYBLSWAP("dev.tia.delayblswap");
+  constexpr Settings::Key DEV_TIADRIVEN("dev.tiadriven");
+  constexpr Settings::Key DEV_TV_JITTER("dev.tv.jitter");
+  constexpr Settings::Key PLR_TV_JITTER("plr.tv.jitter");
+  constexpr Settings::Key DEV_TV_JITTER_RECOVERY("dev.tv.jitter_recovery");
+  constexpr Settings::Key PLR_TV_JITTER_RECOVERY("plr.tv.jitter_recovery");
+  constexpr Settings::Key DEV_COLORLOSS("dev.colorloss");
+  constexpr Settings::Key PLR_COLORLOSS("plr.colorloss");
+  constexpr Settings::Key DEV_DEBUGCOLORS("dev.debugcolors");
+  constexpr Settings::Key PLR_DEBUGCOLORS("plr.debugcolors");
+  constexpr Settings::Key TIA_DBGCOLORS("tia.dbgcolors");
+  constexpr Settings::Key TIA_THREADED("tia.threaded");
+
+  // Idle loops of the render thread before it goes to sleep
+  constexpr uInt32 RENDER_THREAD_SPINS = 1000;
+}
+
 // This parameter still has room for tuning. If we go lower than 73, long005 will show
 // a slight artifact (still have to crosscheck on real hardware), if we go lower than
 // 70, the G.I. Joe will show an artifact (hole in roof).
 static constexpr uInt8 resxLateHblankThreshold = TIAConstants::H_CYCLES - 3;
 
+// Number of objects that take part in collision detection
+static constexpr uInt32 collisionObjects = 6;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Combine the collision words that the objects reported for each clock of a
+// span into the bits of the collision latches that were set during the span.
+static uInt32 accumulateCollisions(
+  const uInt16 collision[collisionObjects][TIAConstants::H_CLOCKS], uInt32 clocks)
+{
+  uInt32 i = 0;
+  uInt16 mask = 0;
+
+#if defined(__SSE2__)
+  __m128i acc = _mm_setzero_si128();
+
+  for (; i + 8 <= clocks; i += 8) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(collision[0] + i));
+
+    for (uInt32 obj = 1; obj < collisionObjects; ++obj)
+      v = _mm_and_si128(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(collision[obj] + i)));
+
+    acc = _mm_or_si128(acc, v);
+  }
+
+  acc = _mm_or_si128(acc, _mm_srli_si128(acc, 8));
+  acc = _mm_or_si128(acc, _mm_srli_si128(acc, 4));
+  acc = _mm_or_si128(acc, _mm_srli_si128(acc, 2));
+  mask = uInt16(_mm_cvtsi128_si32(acc));
+#elif defined(__ARM_NEON)
+  uint16x8_t acc = vdupq_n_u16(0);
+
+  for (; i + 8 <= clocks; i += 8) {
+    uint16x8_t v = vld1q_u16(collision[0] + i);
+
+    for (uInt32 obj = 1; obj < collisionObjects; ++obj)
+      v = vandq_u16(v, vld1q_u16(collision[obj] + i));
+
+    acc = vorrq_u16(acc, v);
+  }
+
+  uint16x4_t acc4 = vorr_u16(vget_low_u16(acc), vget_high_u16(acc));
+  acc4 = vorr_u16(acc4, vext_u16(acc4, acc4, 2));
+  acc4 = vorr_u16(acc4, vext_u16(acc4, acc4, 1));
+  mask = vget_lane_u16(acc4, 0);
+#endif
+
+  for (; i < clocks; ++i)
+    mask |=
+      collision[0][i] & collision[1][i] & collision[2][i] &
+      collision[3][i] & collision[4][i] & collision[5][i];
+
+  return mask;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TIA::TIA(ConsoleIO& console, ConsoleTimingProvider timingProvider, Settings& settings)
   : myConsole(console),
     myTimingProvider(timingProvider),
     mySettings(settings),
+    myQuirksEnabled(false),
     myFrameManager(nullptr),
+    myRegularFrameManager(nullptr),
+    myDetectionMode(false),
     myPlayfield(~CollisionMask::playfield & 0x7FFF),
     myMissile0(~CollisionMask::missile0 & 0x7FFF),
     myMissile1(~CollisionMask::missile1 & 0x7FFF),
     myPlayer0(~CollisionMask::player0 & 0x7FFF),
     myPlayer1(~CollisionMask::player1 & 0x7FFF),
     myBall(~CollisionMask::ball & 0x7FFF),
+    myLineTimingEnabled(false),
     mySpriteEnabledBits(0xFF),
-    myCollisionsEnabledBits(0xFF)
+    myCollisionsEnabledBits(0xFF),
+    myRenderThreadEnabled(false),
+    myLoggedWrites(0),
+    myAppliedWrites(0),
+    myRenderThreadDone(false),
+    myRenderThreadSleeping(false),
+    myOnRenderThread(false),
+    myRenderThreadCycle(0),
+    myFrameCompletePending(false),
+    myShadowHctr(0)
 {
   myBackground.setTIA(this);
   myPlayfield.setTIA(this);
@@ -88,15 +195,35 @@ TIA::TIA(ConsoleIO& console, ConsoleTimingProvider timingProvider, Settings& set
   myMissile1.setTIA(this);
   myBall.setTIA(this);
 
+  // Without rendering, the render buffer is only read as the frame before
+  // the first one, and can share the (still blank) front buffer
+  constexpr uInt32 size = TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight;
+  const bool lean = mySettings.getBool("lean");
+
+  myFrameStorage = make_unique<uInt8[]>(size * (lean ? 2 : FRAME_BUFFERS + 1));
+  for(uInt32 i = 0; i < FRAME_BUFFERS; ++i)
+    myFrameBuffers[i] = myFrameStorage.get() + size * (lean ? std::min(i, 1u) : i);
+  myFramebuffer = lean ? nullptr : myFrameStorage.get() + size * FRAME_BUFFERS;
+
+  setupPriorityLookup();
+
   reset();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TIA::~TIA()
+{
+  enableRenderThread(false);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::setFrameManager(AbstractFrameManager* frameManager)
 {
   clearFrameManager();
 
   myFrameManager = frameManager;
+  myDetectionMode = myFrameManager->isDetector();
+  myRegularFrameManager = myFrameManager->regularFrameManager();
 
   myFrameManager->setHandlers(
     [this] () {
@@ -109,6 +236,9 @@ void TIA::setFrameManager(AbstractFrameManager* frameManager)
 
   myFrameManager->enableJitter(myEnableJitter);
   myFrameManager->setJitterFactor(myJitterFactor);
+
+  // Autodetection runs in lockstep
+  enableRenderThread(!myDetectionMode && mySettings.getBool(TIA_THREADED));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -122,15 +252,21 @@ void TIA::clearFrameManager()
 {
   if (!myFrameManager) return;
 
+  enableRenderThread(false);
+
   myFrameManager->clearHandlers();
 
   myFrameManager = nullptr;
+  myRegularFrameManager = nullptr;
+  myDetectionMode = false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::reset()
 {
-  myHctr = 0;
+  syncRenderThread();
+
+  myHctr = myShadowHctr = 0;
   myMovementInProgress = false;
   myExtendedHblank = false;
   myMovementClock = 0;
@@ -172,24 +308,36 @@ void TIA::reset()
   if (myFrameManager)
     myFrameManager->reset();
 
-  myFrontBufferScanlines = myFrameBufferScanlines = 0;
-
   myFramesSinceLastRender = 0;
 
   // Blank the various framebuffers; they may contain graphical garbage
-  memset(myBackBuffer, 0,  TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight);
-  memset(myFrontBuffer, 0, TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight);
-  memset(myFramebuffer, 0, TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight);
+  myBackBufferIndex = 0;
+  myFrontBufferIndex = 1;
+  myRenderBufferIndex = myLastFrameIndex = 2;
+  myRenderEndY = myRenderEndX = 0;
+  myBackBuffer = myFrameBuffers[myBackBufferIndex];
+  for(uInt32 i = 0; i < FRAME_BUFFERS; ++i)
+  {
+    memset(myFrameBuffers[i], 0, TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight);
+    myBufferScanlines[i] = 0;
+    myBufferLineWaits[i].fill(NO_WSYNC);
+  }
+  myFrameBufferScanlines = 0;
+  if(myFramebuffer)
+    memset(myFramebuffer, 0, TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight);
+  myDirtyLines.set();
+  myFrameLineWaits.fill(NO_WSYNC);
 
   applyDeveloperSettings();
 
   // Must be done last, after all other items have reset
-  bool devSettings = mySettings.getBool("dev.settings");
-  enableFixedColors(mySettings.getBool(devSettings ? "dev.debugcolors" : "plr.debugcolors"));
-  setFixedColorPalette(mySettings.getString("tia.dbgcolors"));
+  bool devSettings = mySettings.getBool(DEV_SETTINGS);
+  enableFixedColors(mySettings.getBool(devSettings ? DEV_DEBUGCOLORS : PLR_DEBUGCOLORS));
+  setFixedColorPalette(mySettings.getString(TIA_DBGCOLORS));
 
 #ifdef DEBUGGER_SUPPORT
-  createAccessBase();
+  if(!mySettings.getBool("lean"))
+    createAccessBase();
 #endif // DEBUGGER_SUPPORT
 }
 
@@ -222,63 +370,86 @@ void TIA::installDelegate(System& system, Device& device)
   );
 }
 
+namespace {
+  // The registers and counters are saved in one block, laid out as the
+  // values used to be saved one by one (see Serializer::putBlock())
+  #pragma pack(push, 1)
+  struct TIAState {
+    uInt32 hstate;
+    uInt32 hctr, hctrDelta, xAtRenderingStart;
+    uInt8 collisionUpdateRequired, collisionUpdateScheduled;  // see Serializer::boolByte()
+    uInt32 collisionMask;
+    uInt32 movementClock;
+    uInt8 movementInProgress, extendedHblank;
+    uInt32 linesSinceChange;
+    uInt32 priority;
+    uInt8 subClock;
+    uInt64 lastCycle;
+    uInt8 spriteEnabledBits, collisionsEnabledBits;
+    uInt8 colorHBlank;
+    uInt64 timestamp;
+  };
+  #pragma pack(pop)
+
+  static_assert(sizeof(TIAState) == 56, "TIA state layout changed");
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool TIA::save(Serializer& out) const
 {
   try
   {
-    if(!myDelayQueue.save(out))   return false;
-    if(!myFrameManager->save(out)) return false;
-
-    if(!myBackground.save(out)) return false;
-    if(!myPlayfield.save(out))  return false;
-    if(!myMissile0.save(out))   return false;
-    if(!myMissile1.save(out))   return false;
-    if(!myPlayer0.save(out))    return false;
-    if(!myPlayer1.save(out))    return false;
-    if(!myBall.save(out))       return false;
-    if(!myAudio.save(out))      return false;
+    if(!StateProfile::save(myDelayQueue, out, "DelayQueue")) return false;
+    if(!StateProfile::save(*myFrameManager, out, "FrameManager")) return false;
+
+    if(!StateProfile::save(myBackground, out, "Background")) return false;
+    if(!StateProfile::save(myPlayfield, out, "Playfield")) return false;
+    if(!StateProfile::save(myMissile0, out, "Missile0")) return false;
+    if(!StateProfile::save(myMissile1, out, "Missile1")) return false;
+    if(!StateProfile::save(myPlayer0, out, "Player0")) return false;
+    if(!StateProfile::save(myPlayer1, out, "Player1")) return false;
+    if(!StateProfile::save(myBall, out, "Ball")) return false;
+    if(!StateProfile::save(myAudio, out, "Audio")) return false;
 
     for (const PaddleReader& paddleReader : myPaddleReaders)
-      if(!paddleReader.save(out)) return false;
-
-    if(!myInput0.save(out)) return false;
-    if(!myInput1.save(out)) return false;
-
-    out.putInt(int(myHstate));
-
-    out.putInt(myHctr);
-    out.putInt(myHctrDelta);
-    out.putInt(myXAtRenderingStart);
-
-    out.putBool(myCollisionUpdateRequired);
-    out.putBool(myCollisionUpdateScheduled);
-    out.putInt(myCollisionMask);
-
-    out.putInt(myMovementClock);
-    out.putBool(myMovementInProgress);
-    out.putBool(myExtendedHblank);
-
-    out.putInt(myLinesSinceChange);
-
-    out.putInt(int(myPriority));
-
-    out.putByte(mySubClock);
-    out.putLong(myLastCycle);
-
-    out.putByte(mySpriteEnabledBits);
-    out.putByte(myCollisionsEnabledBits);
-
-    out.putByte(myColorHBlank);
-
-    out.putLong(myTimestamp);
-
-    out.putByteArray(myShadowRegisters, 64);
+      if(!StateProfile::save(paddleReader, out, "PaddleReader")) return false;
+
+    if(!StateProfile::save(myInput0, out, "Input0")) return false;
+    if(!StateProfile::save(myInput1, out, "Input1")) return false;
+
+    TIAState state;
+    state.hstate = uInt32(myHstate);
+    state.hctr = myHctr;
+    state.hctrDelta = myHctrDelta;
+    state.xAtRenderingStart = myXAtRenderingStart;
+    state.collisionUpdateRequired = Serializer::boolByte(myCollisionUpdateRequired);
+    state.collisionUpdateScheduled = Serializer::boolByte(myCollisionUpdateScheduled);
+    state.collisionMask = myCollisionMask;
+    state.movementClock = myMovementClock;
+    state.movementInProgress = Serializer::boolByte(myMovementInProgress);
+    state.extendedHblank = Serializer::boolByte(myExtendedHblank);
+    state.linesSinceChange = myLinesSinceChange;
+    state.priority = uInt32(myPriority);
+    state.subClock = mySubClock;
+    state.lastCycle = myLastCycle;
+    state.spriteEnabledBits = mySpriteEnabledBits;
+    state.collisionsEnabledBits = myCollisionsEnabledBits;
+    state.colorHBlank = myColorHBlank;
+    state.timestamp = myTimestamp;
+    out.putBlock(state);
+
+    // Only used by the debugger
+    if(!out.lean())
+      out.putByteArray(myShadowRegisters, 64);
 
     out.putLong(myCyclesAtFrameStart);
 
-    out.putInt(myFrameBufferScanlines);
-    out.putInt(myFrontBufferScanlines);
+    // Only describe the frames already rendered
+    if(!out.lean())
+    {
+      out.putInt(myFrameBufferScanlines);
+      out.putInt(myBufferScanlines[myLastFrameIndex]);
+    }
 
     out.putByte(myPFBitsDelay);
     out.putByte(myPFColorDelay);
@@ -296,60 +467,59 @@ bool TIA::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool TIA::load(Serializer& in)
 {
+  syncRenderThread();
+
   try
   {
-    if(!myDelayQueue.load(in))   return false;
-    if(!myFrameManager->load(in)) return false;
-
-    if(!myBackground.load(in)) return false;
-    if(!myPlayfield.load(in))  return false;
-    if(!myMissile0.load(in))   return false;
-    if(!myMissile1.load(in))   return false;
-    if(!myPlayer0.load(in))    return false;
-    if(!myPlayer1.load(in))    return false;
-    if(!myBall.load(in))       return false;
-    if(!myAudio.load(in))       return false;
+    if(!StateProfile::load(myDelayQueue, in, "DelayQueue")) return false;
+    if(!StateProfile::load(*myFrameManager, in, "FrameManager")) return false;
+
+    if(!StateProfile::load(myBackground, in, "Background")) return false;
+    if(!StateProfile::load(myPlayfield, in, "Playfield")) return false;
+    if(!StateProfile::load(myMissile0, in, "Missile0")) return false;
+    if(!StateProfile::load(myMissile1, in, "Missile1")) return false;
+    if(!StateProfile::load(myPlayer0, in, "Player0")) return false;
+    if(!StateProfile::load(myPlayer1, in, "Player1")) return false;
+    if(!StateProfile::load(myBall, in, "Ball")) return false;
+    if(!StateProfile::load(myAudio, in, "Audio")) return false;
 
     for (PaddleReader& paddleReader : myPaddleReaders)
-      if(!paddleReader.load(in)) return false;
-
-    if(!myInput0.load(in)) return false;
-    if(!myInput1.load(in)) return false;
-
-    myHstate = HState(in.getInt());
-
-    myHctr = in.getInt();
-    myHctrDelta = in.getInt();
-    myXAtRenderingStart = in.getInt();
-
-    myCollisionUpdateRequired = in.getBool();
-    myCollisionUpdateScheduled = in.getBool();
-    myCollisionMask = in.getInt();
-
-    myMovementClock = in.getInt();
-    myMovementInProgress = in.getBool();
-    myExtendedHblank = in.getBool();
-
-    myLinesSinceChange = in.getInt();
-
-    myPriority = Priority(in.getInt());
-
-    mySubClock = in.getByte();
-    myLastCycle = in.getLong();
-
-    mySpriteEnabledBits = in.getByte();
-    myCollisionsEnabledBits = in.getByte();
-
-    myColorHBlank = in.getByte();
-
-    myTimestamp = in.getLong();
-
-    in.getByteArray(myShadowRegisters, 64);
+      if(!StateProfile::load(paddleReader, in, "PaddleReader")) return false;
+
+    if(!StateProfile::load(myInput0, in, "Input0")) return false;
+    if(!StateProfile::load(myInput1, in, "Input1")) return false;
+
+    TIAState state;
+    in.getBlock(state);
+    myHstate = HState(state.hstate);
+    myHctr = state.hctr;
+    myHctrDelta = state.hctrDelta;
+    myXAtRenderingStart = state.xAtRenderingStart;
+    myCollisionUpdateRequired = Serializer::byteBool(state.collisionUpdateRequired);
+    myCollisionUpdateScheduled = Serializer::byteBool(state.collisionUpdateScheduled);
+    myCollisionMask = state.collisionMask;
+    myMovementClock = state.movementClock;
+    myMovementInProgress = Serializer::byteBool(state.movementInProgress);
+    myExtendedHblank = Serializer::byteBool(state.extendedHblank);
+    myLinesSinceChange = state.linesSinceChange;
+    myPriority = Priority(state.priority);
+    mySubClock = state.subClock;
+    myLastCycle = state.lastCycle;
+    mySpriteEnabledBits = state.spriteEnabledBits;
+    myCollisionsEnabledBits = state.collisionsEnabledBits;
+    myColorHBlank = state.colorHBlank;
+    myTimestamp = state.timestamp;
+
+    if(!in.lean())
+      in.getByteArray(myShadowRegisters, 64);
 
     myCyclesAtFrameStart = in.getLong();
 
-    myFrameBufferScanlines = in.getInt();
-    myFrontBufferScanlines = in.getInt();
+    if(!in.lean())
+    {
+      myFrameBufferScanlines = in.getInt();
+      myBufferScanlines[myLastFrameIndex] = in.getInt();
+    }
 
     myPFBitsDelay = in.getByte();
     myPFColorDelay = in.getByte();
@@ -357,6 +527,8 @@ bool TIA::load(Serializer& in)
 
     // Re-apply dev settings
     applyDeveloperSettings();
+
+    myShadowHctr = myHctr;
   }
   catch(...)
   {
@@ -495,10 +667,33 @@ uInt8 TIA::peek(uInt16 address)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool TIA::poke(uInt16 address, uInt8 value)
 {
+  address &= 0x3F;
+
+#ifdef DEBUGGER_SUPPORT
+  // Mark the graphics data written
+  if (address == PF0 || address == PF1 || address == PF2 ||
+      address == GRP0 || address == GRP1)
+  {
+    uInt16 dataAddr = mySystem->m6502().lastDataAddressForPoke();
+    if(dataAddr)
+      mySystem->setAccessFlags(dataAddr,
+        address == GRP0 || address == GRP1 ? CartDebug::GFX : CartDebug::PGFX);
+  }
+#endif
+
+  if (myRenderThreadEnabled && logWrite(address, value))
+    return true;
+
   updateEmulation();
+  writeRegister(address, value);
+  myShadowHctr = myHctr;
 
-  address &= 0x3F;
+  return true;
+}
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::writeRegister(uInt8 address, uInt8 value)
+{
   switch (address)
   {
     case WSYNC:
@@ -512,9 +707,13 @@ bool TIA::poke(uInt16 address, uInt8 value)
       break;
 
     case VSYNC:
+    {
+      const bool rendering = myFrameManager->isRendering();
       myFrameManager->setVsync(value & 0x02);
+      if (rendering && !myFrameManager->isRendering()) onRenderingStopped(false);
       myShadowRegisters[address] = value;
       break;
+    }
 
     case VBLANK:
       myInput0.vblank(value);
@@ -605,37 +804,16 @@ bool TIA::poke(uInt16 address, uInt8 value)
       break;
 
     case PF0:
-    {
       myDelayQueue.push(PF0, value, myPFBitsDelay);
-    #ifdef DEBUGGER_SUPPORT
-      uInt16 dataAddr = mySystem->m6502().lastDataAddressForPoke();
-      if(dataAddr)
-        mySystem->setAccessFlags(dataAddr, CartDebug::PGFX);
-    #endif
       break;
-    }
 
     case PF1:
-    {
       myDelayQueue.push(PF1, value, myPFBitsDelay);
-    #ifdef DEBUGGER_SUPPORT
-      uInt16 dataAddr = mySystem->m6502().lastDataAddressForPoke();
-      if(dataAddr)
-        mySystem->setAccessFlags(dataAddr, CartDebug::PGFX);
-    #endif
       break;
-    }
 
     case PF2:
-    {
       myDelayQueue.push(PF2, value, myPFBitsDelay);
-    #ifdef DEBUGGER_SUPPORT
-      uInt16 dataAddr = mySystem->m6502().lastDataAddressForPoke();
-      if(dataAddr)
-        mySystem->setAccessFlags(dataAddr, CartDebug::PGFX);
-    #endif
       break;
-    }
 
     case ENAM0:
       myDelayQueue.push(ENAM0, value, Delay::enam);
@@ -694,29 +872,15 @@ bool TIA::poke(uInt16 address, uInt8 value)
       break;
 
     case GRP0:
-    {
       myDelayQueue.push(GRP0, value, Delay::grp);
       myDelayQueue.push(DummyRegisters::shuffleP1, 0, myPlSwapDelay);
-    #ifdef DEBUGGER_SUPPORT
-      uInt16 dataAddr = mySystem->m6502().lastDataAddressForPoke();
-      if(dataAddr)
-        mySystem->setAccessFlags(dataAddr, CartDebug::GFX);
-    #endif
       break;
-    }
 
     case GRP1:
-    {
       myDelayQueue.push(GRP1, value, Delay::grp);
       myDelayQueue.push(DummyRegisters::shuffleP0, 0, myPlSwapDelay);
       myDelayQueue.push(DummyRegisters::shuffleBL, 0, Delay::shuffleBall);
-    #ifdef DEBUGGER_SUPPORT
-      uInt16 dataAddr = mySystem->m6502().lastDataAddressForPoke();
-      if(dataAddr)
-        mySystem->setAccessFlags(dataAddr, CartDebug::GFX);
-    #endif
       break;
-    }
 
     case RESP0:
       flushLineCache();
@@ -781,18 +945,19 @@ bool TIA::poke(uInt16 address, uInt8 value)
       myShadowRegisters[address] = value;
       break;
   }
-
-  return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool TIA::saveDisplay(Serializer& out) const
 {
+  if(!myFramebuffer) return false;
+
   try
   {
     out.putByteArray(myFramebuffer, TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight);
     out.putByteArray(myBackBuffer,  TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight);
-    out.putByteArray(myFrontBuffer, TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight);
+    out.putByteArray(myFrameBuffers[myLastFrameIndex],
+                     TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight);
     out.putInt(myFramesSinceLastRender);
   }
   catch(...)
@@ -807,13 +972,17 @@ bool TIA::saveDisplay(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool TIA::loadDisplay(Serializer& in)
 {
+  if(!myFramebuffer) return false;
+
   try
   {
     // Reset frame buffer pointer and data
     in.getByteArray(myFramebuffer, TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight);
     in.getByteArray(myBackBuffer,  TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight);
-    in.getByteArray(myFrontBuffer, TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight);
+    in.getByteArray(myFrameBuffers[myLastFrameIndex],
+                    TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight);
     myFramesSinceLastRender = in.getInt();
+    myDirtyLines.set();
   }
   catch(...)
   {
@@ -824,31 +993,49 @@ bool TIA::loadDisplay(Serializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::showFrame(const uInt8* frame)
+{
+  if(!myFramebuffer) return;
+
+  uInt8* dst = myFramebuffer;
+  for(uInt32 y = 0; y < TIAConstants::frameBufferHeight; ++y)
+  {
+    if(memcmp(dst, frame, TIAConstants::H_PIXEL) != 0)
+    {
+      memcpy(dst, frame, TIAConstants::H_PIXEL);
+      myDirtyLines.set(y);
+    }
+    frame += TIAConstants::H_PIXEL;
+    dst += TIAConstants::H_PIXEL;
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::applyDeveloperSettings()
 {
-  bool devSettings = mySettings.getBool("dev.settings");
+  bool devSettings = mySettings.getBool(DEV_SETTINGS);
   if(devSettings)
   {
-    bool custom = BSPF::equalsIgnoreCase("custom", mySettings.getString("dev.tia.type"));
+    bool custom = BSPF::equalsIgnoreCase("custom", mySettings.getString(DEV_TIA_TYPE));
 
     setPlInvertedPhaseClock(custom
-                            ? mySettings.getBool("dev.tia.plinvphase")
-                            : BSPF::equalsIgnoreCase("koolaidman", mySettings.getString("dev.tia.type")));
+                            ? mySettings.getBool(DEV_TIA_PLINVPHASE)
+                            : BSPF::equalsIgnoreCase("koolaidman", mySettings.getString(DEV_TIA_TYPE)));
     setMsInvertedPhaseClock(custom
-                            ? mySettings.getBool("dev.tia.msinvphase")
-                            : BSPF::equalsIgnoreCase("cosmicark", mySettings.getString("dev.tia.type")));
-    setBlInvertedPhaseClock(custom ? mySettings.getBool("dev.tia.blinvphase") : false);
+                            ? mySettings.getBool(DEV_TIA_MSINVPHASE)
+                            : BSPF::equalsIgnoreCase("cosmicark", mySettings.getString(DEV_TIA_TYPE)));
+    setBlInvertedPhaseClock(custom ? mySettings.getBool(DEV_TIA_BLINVPHASE) : false);
     setPFBitsDelay(custom
-                   ? mySettings.getBool("dev.tia.delaypfbits")
-                   : BSPF::equalsIgnoreCase("pesco", mySettings.getString("dev.tia.type")));
+                   ? mySettings.getBool(DEV_TIA_DELAYPFBITS)
+                   : BSPF::equalsIgnoreCase("pesco", mySettings.getString(DEV_TIA_TYPE)));
     setPFColorDelay(custom
-                    ? mySettings.getBool("dev.tia.delaypfcolor")
-                    : BSPF::equalsIgnoreCase("quickstep", mySettings.getString("dev.tia.type")));
+                    ? mySettings.getBool(DEV_TIA_DELAYPFCOLOR)
+                    : BSPF::equalsIgnoreCase("quickstep", mySettings.getString(DEV_TIA_TYPE)));
     setPlSwapDelay(custom
-                   ? mySettings.getBool("dev.tia.delayplswap")
-                   : BSPF::equalsIgnoreCase("heman", mySettings.getString("dev.tia.type")));
-    setBlSwapDelay(custom ? mySettings.getBool("dev.tia.delayblswap") : false);
+                   ? mySettings.getBool(DEV_TIA_DELAYPLSWAP)
+                   : BSPF::equalsIgnoreCase("heman", mySettings.getString(DEV_TIA_TYPE)));
+    setBlSwapDelay(custom ? mySettings.getBool(DEV_TIA_DELAYBLSWAP) : false);
   }
   else
   {
@@ -861,13 +1048,13 @@ void TIA::applyDeveloperSettings()
     setBlSwapDelay(false);
   }
 
-  myTIAPinsDriven = devSettings ? mySettings.getBool("dev.tiadriven") : false;
+  myTIAPinsDriven = devSettings ? mySettings.getBool(DEV_TIADRIVEN) : false;
 
-  myEnableJitter = mySettings.getBool(devSettings ? "dev.tv.jitter" : "plr.tv.jitter");
-  myJitterFactor = mySettings.getInt(devSettings ? "dev.tv.jitter_recovery" : "plr.tv.jitter_recovery");
+  myEnableJitter = mySettings.getBool(devSettings ? DEV_TV_JITTER : PLR_TV_JITTER);
+  myJitterFactor = mySettings.getInt(devSettings ? DEV_TV_JITTER_RECOVERY : PLR_TV_JITTER_RECOVERY);
 
   if(myFrameManager)
-    enableColorLoss(mySettings.getBool(devSettings ? "dev.colorloss" : "plr.colorloss"));
+    enableColorLoss(mySettings.getBool(devSettings ? DEV_COLORLOSS : PLR_COLORLOSS));
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -881,13 +1068,44 @@ void TIA::update(DispatchResult& result, uInt64 maxCycles)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::renderToFrameBuffer()
 {
-  if (myFramesSinceLastRender == 0) return;
+  if (myFramesSinceLastRender == 0 || !myFramebuffer) return;
 
   myFramesSinceLastRender = 0;
 
-  memcpy(myFramebuffer, myFrontBuffer, TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight);
+  // Take over the front buffer if it holds a new frame; the emulation may
+  // complete further frames meanwhile, which go to the other two buffers
+  if (myFrontBufferIndex.load(std::memory_order_relaxed) & FRONT_BUFFER_FRESH)
+    myRenderBufferIndex =
+      myFrontBufferIndex.exchange(myRenderBufferIndex, std::memory_order_acq_rel) & ~FRONT_BUFFER_FRESH;
+
+  // Only copy the scanlines which changed, and remember them
+  const uInt8* src = myFrameBuffers[myRenderBufferIndex];
+  uInt8* dst = myFramebuffer;
+  for(uInt32 y = 0; y < TIAConstants::frameBufferHeight; ++y)
+  {
+    if(memcmp(dst, src, TIAConstants::H_PIXEL) != 0)
+    {
+      memcpy(dst, src, TIAConstants::H_PIXEL);
+      myDirtyLines.set(y);
+    }
+    src += TIAConstants::H_PIXEL;
+    dst += TIAConstants::H_PIXEL;
+  }
+
+  myFrameBufferScanlines = myBufferScanlines[myRenderBufferIndex];
+
+  if (myLineTimingEnabled)
+    myFrameLineWaits = myBufferLineWaits[myRenderBufferIndex];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::enableLineTiming(bool enable)
+{
+  myLineTimingEnabled = enable;
 
-  myFrameBufferScanlines = myFrontBufferScanlines;
+  for(LineWaits& waits: myBufferLineWaits)
+    waits.fill(NO_WSYNC);
+  myFrameLineWaits.fill(NO_WSYNC);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -898,6 +1116,20 @@ void TIA::update(uInt64 maxCycles)
   update(dispatchResult, maxCycles);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::updateFrame(DispatchResult& result)
+{
+  // A frame normally completes in one dispatch; it takes more only when
+  // started mid-frame, and the bound guards against a stalled TIA
+  const uInt32 frame = frameCount();
+  for(uInt32 slices = 0; slices < 10; ++slices)
+  {
+    update(result);
+    if(frameCount() != frame || result.getStatus() != DispatchResult::Status::ok)
+      break;
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool TIA::enableColorLoss(bool enabled)
 {
@@ -1180,6 +1412,10 @@ uInt8 TIA::registerValue(uInt8 reg) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::updateEmulation()
 {
+  if (myRenderThreadEnabled) syncRenderThread();
+
+  System::ZoneGuard zone(*mySystem, System::Zone::tia);
+
   const uInt64 systemCycles = mySystem->cycles();
 
   if (mySubClock > TIAConstants::CYCLE_CLOCKS - 1)
@@ -1191,12 +1427,125 @@ void TIA::updateEmulation()
   myLastCycle = systemCycles;
 
   cycle(cyclesToRun);
+  myShadowHctr = myHctr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::syncRenderThread()
+{
+  if (!myRenderThreadEnabled) return;
+
+  const uInt64 logged = myLoggedWrites.load(std::memory_order_relaxed);
+  while (myAppliedWrites.load(std::memory_order_acquire) != logged)
+    std::this_thread::yield();
+
+  if (myFrameCompletePending)
+  {
+    myFrameCompletePending = false;
+    mySystem->m6502().stop();
+    myConsole.frameComplete();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIA::logWrite(uInt8 address, uInt8 value)
+{
+  // These change what the CPU sees (the position of the beam, or whether
+  // the frame is complete)
+  if (address == RSYNC || address == VSYNC) return false;
+
+  const uInt64 systemCycles = mySystem->cycles();
+  const uInt32 clocks = TIAConstants::CYCLE_CLOCKS * uInt32(systemCycles - myLastCycle) + mySubClock;
+
+  mySubClock = 0;
+  myLastCycle = systemCycles;
+  myShadowHctr = (myShadowHctr + clocks) % TIAConstants::H_CLOCKS;
+
+  const LoggedWrite write{ systemCycles, clocks, address == WSYNC ? NO_WRITE : address, value };
+  while (!myWriteLog->push(write))
+    std::this_thread::yield();
+
+  myLoggedWrites.fetch_add(1);
+  if (myRenderThreadSleeping)
+  {
+    std::lock_guard<std::mutex> lock(myRenderThreadMutex);
+    myRenderThreadWakeup.notify_one();
+  }
+
+  if (address == WSYNC)
+    mySystem->m6502().requestHalt();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::runRenderThread()
+{
+  LoggedWrite write;
+  uInt64 applied = 0;
+  uInt32 idle = 0;
+
+  while (!myRenderThreadDone)
+  {
+    if (myWriteLog->pop(write))
+    {
+      myOnRenderThread = true;
+      myRenderThreadCycle = write.cycle;
+      cycle(write.clocks);
+      if (write.address != NO_WRITE) writeRegister(write.address, write.value);
+      myOnRenderThread = false;
+
+      myAppliedWrites.store(++applied, std::memory_order_release);
+      idle = 0;
+    }
+    else if (++idle < RENDER_THREAD_SPINS)
+      std::this_thread::yield();
+    else
+    {
+      std::unique_lock<std::mutex> lock(myRenderThreadMutex);
+      myRenderThreadSleeping = true;
+      myRenderThreadWakeup.wait(lock, [&] {
+        return myLoggedWrites.load() != applied || myRenderThreadDone;
+      });
+      myRenderThreadSleeping = false;
+      idle = 0;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::enableRenderThread(bool enable)
+{
+  if (enable == myRenderThreadEnabled) return;
+
+  if (enable)
+  {
+    if (!myWriteLog)
+      myWriteLog = make_unique<Common::LockFreeQueue<LoggedWrite, 4096>>();
+    myLoggedWrites = myAppliedWrites = 0;
+    myRenderThreadDone = false;
+    myShadowHctr = myHctr;
+    myRenderThread = std::thread(&TIA::runRenderThread, this);
+    myRenderThreadEnabled = true;
+  }
+  else
+  {
+    syncRenderThread();
+    myRenderThreadEnabled = false;
+    {
+      std::lock_guard<std::mutex> lock(myRenderThreadMutex);
+      myRenderThreadDone = true;
+    }
+    myRenderThreadWakeup.notify_one();
+    myRenderThread.join();
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::onFrameStart()
 {
   myXAtRenderingStart = 0;
+  myRenderEndY = myRenderEndX = 0;
 
   // Check for colour-loss emulation
   if (myColorLossEnabled)
@@ -1221,8 +1570,20 @@ void TIA::onFrameStart()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::onFrameComplete()
 {
-  mySystem->m6502().stop();
-  myCyclesAtFrameStart = mySystem->cycles();
+  // On the render thread, the CPU is stopped once it catches up
+  if (myOnRenderThread)
+  {
+    myFrameCompletePending = true;
+    myCyclesAtFrameStart = myRenderThreadCycle;
+  }
+  else
+  {
+    mySystem->m6502().stop();
+    myCyclesAtFrameStart = mySystem->cycles();
+  }
+
+  // Nothing is drawn during autodetection
+  if (myDetectionMode) return;
 
   if (myXAtRenderingStart > 0)
     memset(myBackBuffer, 0, myXAtRenderingStart);
@@ -1232,26 +1593,78 @@ void TIA::onFrameComplete()
   if (missingScanlines > 0)
     memset(myBackBuffer + TIAConstants::H_PIXEL * myFrameManager->getY(), 0, missingScanlines * TIAConstants::H_PIXEL);
 
-  memcpy(myFrontBuffer, myBackBuffer, TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight);
+  // Pixels the frame didn't reach keep their content from the frame before
+  const uInt32 end = myRenderEndY * TIAConstants::H_PIXEL + myRenderEndX;
+  const uInt32 height = std::min(myFrameManager->height(), TIAConstants::frameBufferHeight);
+  if (missingScanlines <= 0 && end < height * TIAConstants::H_PIXEL)
+    memcpy(myBackBuffer + end, myFrameBuffers[myLastFrameIndex] + end,
+           height * TIAConstants::H_PIXEL - end);
+
+  myBufferScanlines[myBackBufferIndex] = scanlinesLastFrame();
+  myLastFrameIndex = myBackBufferIndex;
+
+  // Hand the frame over, and continue with the buffer it replaces
+  myBackBufferIndex =
+    myFrontBufferIndex.exchange(myBackBufferIndex | FRONT_BUFFER_FRESH, std::memory_order_acq_rel) & ~FRONT_BUFFER_FRESH;
+  myBackBuffer = myFrameBuffers[myBackBufferIndex];
 
-  myFrontBufferScanlines = scanlinesLastFrame();
+  if (myLineTimingEnabled)
+    myBufferLineWaits[myBackBufferIndex].fill(NO_WSYNC);
 
   ++myFramesSinceLastRender;
+
+  if (!myOnRenderThread) myConsole.frameComplete();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::onHalt()
 {
-  mySubClock += (TIAConstants::H_CLOCKS - myHctr) % TIAConstants::H_CLOCKS;
+  if (myRenderThreadEnabled && myLineTimingEnabled) syncRenderThread();
+
+  const uInt32 hctr = myRenderThreadEnabled ? myShadowHctr : myHctr;
+  const uInt32 clocks = (TIAConstants::H_CLOCKS - hctr) % TIAConstants::H_CLOCKS;
+
+  // Remember how long the CPU waits on the current line
+  if (myLineTimingEnabled && myFrameManager->isRendering())
+  {
+    const uInt32 y = myFrameManager->getY();
+    if (y < TIAConstants::frameBufferHeight)
+      myBufferLineWaits[myBackBufferIndex][y] = uInt8(clocks / TIAConstants::CYCLE_CLOCKS);
+  }
+
+  mySubClock += clocks;
   mySystem->incrementCycles(mySubClock / TIAConstants::CYCLE_CLOCKS);
   mySubClock %= TIAConstants::CYCLE_CLOCKS;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::cycle(uInt32 colorClocks)
+{
+  if (myQuirksEnabled)
+    cycleClocks<true>(colorClocks);
+  else
+    cycleClocks<false>(colorClocks);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool quirks>
+void TIA::cycleClocks(uInt32 colorClocks)
 {
   for (uInt32 i = 0; i < colorClocks; ++i)
   {
+    // Nothing but the beam moves until the next (possibly delayed) register
+    // write or the end of the line -> process this in one go
+    if (myDetectionMode || (!myMovementInProgress &&
+        (myHstate == HState::frame || myLinesSinceChange >= 2)))
+    {
+      const uInt32 clocksToNextWrite = myDelayQueue.clocksToNextWrite();
+
+      if (clocksToNextWrite > 0) {
+        i += cycleSpan<quirks>(std::min(colorClocks - i, clocksToNextWrite)) - 1;
+        continue;
+      }
+    }
+
     myDelayQueue.execute(
       [this] (uInt8 address, uInt8 value) {delayedWrite(address, value);}
     );
@@ -1259,13 +1672,13 @@ void TIA::cycle(uInt32 colorClocks)
     myCollisionUpdateRequired = myCollisionUpdateScheduled;
     myCollisionUpdateScheduled = false;
 
-    if (myLinesSinceChange < 2) {
+    if (myLinesSinceChange < 2 && !myDetectionMode) {
       tickMovement();
 
       if (myHstate == HState::blank)
         tickHblank();
       else
-        tickHframe();
+        tickHframe<quirks>();
 
       if (myCollisionUpdateRequired && !myFrameManager->vblank()) updateCollision();
     }
@@ -1281,6 +1694,90 @@ void TIA::cycle(uInt32 colorClocks)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool quirks>
+uInt32 TIA::cycleSpan(uInt32 maxClocks)
+{
+  const uInt32 clocks = std::min(maxClocks, uInt32(TIAConstants::H_CLOCKS - myHctr));
+
+  myDelayQueue.skip(clocks);
+
+  if (myLinesSinceChange < 2 && !myDetectionMode) {
+    // These are constant until the next line or register write
+    const bool rendering = myFrameManager->isRendering();
+    const bool vblank = myFrameManager->vblank();
+    const uInt32 y = myFrameManager->getY();
+    uInt32 x = myHctr - TIAConstants::H_BLANK_CLOCKS - myHctrDelta;
+
+    // The collision words of all objects for each clock of the span; these
+    // are combined into the collision latches once the span is complete
+    uInt16 collision[collisionObjects][TIAConstants::H_CLOCKS];
+
+    // The objects do not affect each other until the next register write, so
+    // each one is processed for the whole span before the pixels are drawn.
+    // Idle sprites are fast-forwarded and the copies of players and missiles
+    // emitted in one go; anything else is ticked clock by clock.
+    const auto tickObject = [clocks] (auto& object, uInt16* words, auto emitCopy, auto tick) {
+      for (uInt32 i = 0; i < clocks; ) {
+        uInt32 run = std::min(object.template idleClocks<quirks>(), clocks - i);
+
+        if (run > 0) {
+          object.skipIdleClocks(run);
+          std::fill_n(words + i, run, uInt16(object.collision));
+        } else if ((run = emitCopy(clocks - i, words + i)) == 0) {
+          tick(i);
+          words[i] = uInt16(object.collision);
+          run = 1;
+        }
+
+        i += run;
+      }
+    };
+    const auto noCopy = [] (uInt32, uInt16*) { return uInt32(0); };
+
+    myPlayfield.tickSpan(x, clocks, collision[5]);
+    tickObject(myMissile0, collision[2],
+      [this] (uInt32 n, uInt16* words) { return myMissile0.emitCopy(n, words); },
+      [this] (uInt32 i) { myMissile0.tick<quirks>(uInt8(myHctr + i)); });
+    tickObject(myMissile1, collision[3],
+      [this] (uInt32 n, uInt16* words) { return myMissile1.emitCopy(n, words); },
+      [this] (uInt32 i) { myMissile1.tick<quirks>(uInt8(myHctr + i)); });
+    tickObject(myPlayer0, collision[0],
+      [this] (uInt32 n, uInt16* words) { return myPlayer0.emitCopy(n, words); },
+      [this] (uInt32) { myPlayer0.tick<quirks>(); });
+    tickObject(myPlayer1, collision[1],
+      [this] (uInt32 n, uInt16* words) { return myPlayer1.emitCopy(n, words); },
+      [this] (uInt32) { myPlayer1.tick<quirks>(); });
+    tickObject(myBall, collision[4], noCopy, [this] (uInt32) { myBall.tick<quirks>(); });
+
+    if (rendering) renderSpan(x, y, collision, clocks);
+
+    myHctr += clocks;
+    if (clocks > 0) {
+      myCollisionUpdateScheduled = false;
+      myCollisionUpdateRequired = true;
+    }
+
+    if (!vblank) myCollisionMask |= accumulateCollisions(collision, clocks);
+  } else {
+    myCollisionUpdateRequired = clocks > 1 ? false : myCollisionUpdateScheduled;
+    myCollisionUpdateScheduled = false;
+
+    myHctr += clocks;
+  }
+
+  #ifdef SOUND_SUPPORT
+    myAudio.tick(clocks);
+  #endif
+
+  myTimestamp += clocks;
+
+  if (myHctr >= TIAConstants::H_CLOCKS)
+    nextLine();
+
+  return clocks;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::tickMovement()
 {
@@ -1330,6 +1827,7 @@ void TIA::tickHblank()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool quirks>
 void TIA::tickHframe()
 {
   const uInt32 y = myFrameManager->getY();
@@ -1338,11 +1836,11 @@ void TIA::tickHframe()
   myCollisionUpdateRequired = true;
 
   myPlayfield.tick(x);
-  myMissile0.tick(myHctr);
-  myMissile1.tick(myHctr);
-  myPlayer0.tick();
-  myPlayer1.tick();
-  myBall.tick();
+  myMissile0.tick<quirks>(myHctr);
+  myMissile1.tick<quirks>(myHctr);
+  myPlayer0.tick<quirks>();
+  myPlayer1.tick<quirks>();
+  myBall.tick<quirks>();
 
   if (myFrameManager->isRendering())
     renderPixel(x, y);
@@ -1360,6 +1858,19 @@ void TIA::applyRsync()
   myHctr = TIAConstants::H_CLOCKS - 3;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::onRenderingStopped(bool endOfLine)
+{
+  // Called after the frame manager left the line, or in the middle of it;
+  // a cached line isn't drawn before its end
+  myRenderEndY = myFrameManager->getY() + (endOfLine ? 1 : 0);
+  myRenderEndX = 0;
+
+  if (!endOfLine && myHstate == HState::frame && myLinesSinceChange < 2)
+    myRenderEndX = BSPF::clamp(Int32(myHctr) - Int32(TIAConstants::H_BLANK_CLOCKS) - myHctrDelta,
+                               0, Int32(TIAConstants::H_PIXEL));
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::nextLine()
 {
@@ -1374,7 +1885,10 @@ void TIA::nextLine()
   myHstate = HState::blank;
   myHctrDelta = 0;
 
-  myFrameManager->nextLine();
+  const bool rendering = myFrameManager->isRendering();
+  if (myRegularFrameManager) myRegularFrameManager->nextLine();
+  else myFrameManager->nextLine();
+  if (rendering && !myFrameManager->isRendering()) onRenderingStopped(true);
   myMissile0.nextLine();
   myMissile1.nextLine();
   myPlayer0.nextLine();
@@ -1384,7 +1898,8 @@ void TIA::nextLine()
 
   if (myFrameManager->isRendering() && myFrameManager->getY() == 0) flushLineCache();
 
-  mySystem->m6502().clearHaltRequest();
+  // A pending WSYNC is consumed before the render thread gets to this line
+  if (!myOnRenderThread) mySystem->m6502().clearHaltRequest();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1427,58 +1942,110 @@ void TIA::renderPixel(uInt32 x, uInt32 y)
 
   if (!myFrameManager->vblank())
   {
-    switch (myPriority)
-    {
-      case Priority::pfp:  // CTRLPF D2=1, D1=ignored
-        // Playfield has priority so ScoreBit isn't used
-        // Priority from highest to lowest:
-        //   BL/PF => P0/M0 => P1/M1 => BK
-        if (myPlayfield.isOn())       color = myPlayfield.getColor();
-        else if (myBall.isOn())       color = myBall.getColor();
-        else if (myPlayer0.isOn())    color = myPlayer0.getColor();
-        else if (myMissile0.isOn())   color = myMissile0.getColor();
-        else if (myPlayer1.isOn())    color = myPlayer1.getColor();
-        else if (myMissile1.isOn())   color = myMissile1.getColor();
-        else                          color = myBackground.getColor();
-        break;
+    const uInt32 mask =
+      ((myPlayer0.collision   >> 15) & 0x01) |
+      ((myMissile0.collision  >> 14) & 0x02) |
+      ((myPlayer1.collision   >> 13) & 0x04) |
+      ((myMissile1.collision  >> 12) & 0x08) |
+      ((myPlayfield.collision >> 11) & 0x10) |
+      ((myBall.collision      >> 10) & 0x20);
+
+    const uInt8 colors[] = {
+      myPlayer0.getColor(), myMissile0.getColor(),
+      myPlayer1.getColor(), myMissile1.getColor(),
+      myPlayfield.getColor(), myBall.getColor(),
+      myBackground.getColor()
+    };
+
+    color = colors[myPriorityLookup[uInt8(myPriority)][mask]];
+  }
 
-      case Priority::score:  // CTRLPF D2=0, D1=1
-        // Formally we have (priority from highest to lowest)
-        //   PF/P0/M0 => P1/M1 => BL => BK
-        // for the first half and
-        //   P0/M0 => PF/P1/M1 => BL => BK
-        // for the second half. However, the first ordering is equivalent
-        // to the second (PF has the same color as P0/M0), so we can just
-        // write
-        if (myPlayer0.isOn())         color = myPlayer0.getColor();
-        else if (myMissile0.isOn())   color = myMissile0.getColor();
-        else if (myPlayfield.isOn())  color = myPlayfield.getColor();
-        else if (myPlayer1.isOn())    color = myPlayer1.getColor();
-        else if (myMissile1.isOn())   color = myMissile1.getColor();
-        else if (myBall.isOn())       color = myBall.getColor();
-        else                          color = myBackground.getColor();
-        break;
+  myBackBuffer[y * TIAConstants::H_PIXEL + x] = color;
+}
 
-      case Priority::normal:  // CTRLPF D2=0, D1=0
-        // Priority from highest to lowest:
-        //   P0/M0 => P1/M1 => BL/PF => BK
-        if (myPlayer0.isOn())         color = myPlayer0.getColor();
-        else if (myMissile0.isOn())   color = myMissile0.getColor();
-        else if (myPlayer1.isOn())    color = myPlayer1.getColor();
-        else if (myMissile1.isOn())   color = myMissile1.getColor();
-        else if (myPlayfield.isOn())  color = myPlayfield.getColor();
-        else if (myBall.isOn())       color = myBall.getColor();
-        else                          color = myBackground.getColor();
-        break;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::renderSpan(uInt32 x, uInt32 y,
+                     const uInt16 collision[][TIAConstants::H_CLOCKS], uInt32 clocks)
+{
+  uInt8* line = myBackBuffer + y * TIAConstants::H_PIXEL;
+  const bool vblank = myFrameManager->vblank();
+
+  // Only the playfield color depends on the position
+  const uInt8 colors[] = {
+    myPlayer0.getColor(), myMissile0.getColor(),
+    myPlayer1.getColor(), myMissile1.getColor(),
+    0, myBall.getColor(),
+    myBackground.getColor()
+  };
+  const uInt8* lookup = myPriorityLookup[uInt8(myPriority)];
+
+  for (uInt32 i = 0; i < clocks; ++i, ++x)
+  {
+    if (x >= TIAConstants::H_PIXEL) continue;
+
+    if (vblank)
+    {
+      line[x] = 0;
+      continue;
     }
+
+    const uInt32 mask =
+      ((collision[0][i] >> 15) & 0x01) |
+      ((collision[2][i] >> 14) & 0x02) |
+      ((collision[1][i] >> 13) & 0x04) |
+      ((collision[3][i] >> 12) & 0x08) |
+      ((collision[5][i] >> 11) & 0x10) |
+      ((collision[4][i] >> 10) & 0x20);
+
+    const uInt8 object = lookup[mask];
+    line[x] = object == PF ? myPlayfield.colorAt(x) : colors[object];
   }
+}
 
-  myBackBuffer[y * TIAConstants::H_PIXEL + x] = color;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::setupPriorityLookup()
+{
+  // Priority from highest to lowest for each mode of the priority encoder
+  static constexpr FixedObject order[3][BK] = {
+    // Priority::pfp (CTRLPF D2=1, D1=ignored):
+    //   Playfield has priority so ScoreBit isn't used
+    //   BL/PF => P0/M0 => P1/M1 => BK
+    { PF, BL, P0, M0, P1, M1 },
+
+    // Priority::score (CTRLPF D2=0, D1=1):
+    //   Formally we have (priority from highest to lowest)
+    //     PF/P0/M0 => P1/M1 => BL => BK
+    //   for the first half and
+    //     P0/M0 => PF/P1/M1 => BL => BK
+    //   for the second half. However, the first ordering is equivalent
+    //   to the second (PF has the same color as P0/M0), so we can just
+    //   use the second
+    { P0, M0, PF, P1, M1, BL },
+
+    // Priority::normal (CTRLPF D2=0, D1=0):
+    //   P0/M0 => P1/M1 => BL/PF => BK
+    { P0, M0, P1, M1, PF, BL }
+  };
+
+  for (uInt32 priority = 0; priority < 3; ++priority)
+    for (uInt32 mask = 0; mask < (1 << BK); ++mask)
+    {
+      myPriorityLookup[priority][mask] = BK;
+
+      for (uInt32 i = 0; i < BK; ++i)
+        if (mask & (1 << order[priority][i]))
+        {
+          myPriorityLookup[priority][mask] = order[priority][i];
+          break;
+        }
+    }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::flushLineCache()
 {
+  PERF_COUNT(tiaFlushLineCache);
+
   const bool wasCaching = myLinesSinceChange >= 2;
 
   myLinesSinceChange = 0;
@@ -1489,8 +2056,10 @@ void TIA::flushLineCache()
     for (myHctr = 0; myHctr < rewindCycles; ++myHctr) {
       if (myHstate == HState::blank)
         tickHblank();
+      else if (myQuirksEnabled)
+        tickHframe<true>();
       else
-        tickHframe();
+        tickHframe<false>();
     }
   }
 }
@@ -1531,6 +2100,7 @@ void TIA::setPlInvertedPhaseClock(bool enable)
 {
   myPlayer0.setInvertedPhaseClock(enable);
   myPlayer1.setInvertedPhaseClock(enable);
+  updateQuirks();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1538,12 +2108,28 @@ void TIA::setMsInvertedPhaseClock(bool enable)
 {
   myMissile0.setInvertedPhaseClock(enable);
   myMissile1.setInvertedPhaseClock(enable);
+  updateQuirks();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::setBlInvertedPhaseClock(bool enable)
 {
   myBall.setInvertedPhaseClock(enable);
+  updateQuirks();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::updateQuirks()
+{
+  // The delays of PF and swaps act on register writes, and jitter and color
+  // loss once per frame, so only the inverted phase clocks need the general
+  // version of the object clocks
+  myQuirksEnabled =
+    myPlayer0.hasInvertedPhaseClock() ||
+    myPlayer1.hasInvertedPhaseClock() ||
+    myMissile0.hasInvertedPhaseClock() ||
+    myMissile1.hasInvertedPhaseClock() ||
+    myBall.hasInvertedPhaseClock();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -18,9 +18,16 @@
 #ifndef TIA_TIA
 #define TIA_TIA
 
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <condition_variable>
 #include <functional>
+#include <mutex>
+#include <thread>
 
 #include "bspf.hxx"
+#include "LockFreeQueue.hxx"
 #include "ConsoleIO.hxx"
 #include "ConsoleTiming.hxx"
 #include "Settings.hxx"
@@ -44,6 +51,7 @@
 #include "System.hxx"
 
 class AudioQueue;
+class FrameManager;
 class DispatchResult;
 
 /**
@@ -117,7 +125,7 @@ class TIA : public Device
     */
     TIA(ConsoleIO& console, ConsoleTimingProvider timingProvider, Settings& settings);
 
-    virtual ~TIA() = default;
+    virtual ~TIA();
 
   public:
     /**
@@ -131,6 +139,26 @@ class TIA : public Device
     */
     void setAudioQueue(shared_ptr<AudioQueue> audioQueue);
 
+    /**
+      Suppress audio output, used while emulating frames that are not
+      part of the real timeline (eg. run-ahead).
+    */
+    void setAudioMuted(bool muted) { myAudio.setMuted(muted); }
+
+    /**
+      Write the audio samples straight into the given buffer, rather than
+      into the audio queue (see Audio::setSampleBuffer()).
+    */
+    void setAudioBuffer(Int16* buffer, uInt32 capacity) {
+      myAudio.setSampleBuffer(buffer, capacity);
+    }
+
+    /**
+      Get the number of stereo samples written to the audio buffer since
+      the last call.
+    */
+    uInt32 takeAudioSamples() { return myAudio.takeSamples(); }
+
     /**
       Clear the configured frame manager and deteach the lifecycle callbacks.
      */
@@ -204,6 +232,20 @@ class TIA : public Device
     bool saveDisplay(Serializer& out) const;
     bool loadDisplay(Serializer& in);
 
+    /**
+      The size of the data written by saveDisplay(), which starts with the
+      frame buffer (the frame currently shown).
+    */
+    static constexpr uInt32 DISPLAY_SIZE =
+        3 * TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight + 4;
+
+    /**
+      Show the given frame (H_PIXEL x frameBufferHeight pixels) instead of
+      the current one, until the next frame is rendered or the display is
+      loaded.  Used for previews, without changing the emulation state.
+    */
+    void showFrame(const uInt8* frame);
+
     /**
       This method should be called at an interval corresponding to the
       desired frame rate to update the TIA.  Invoking this method will update
@@ -213,6 +255,16 @@ class TIA : public Device
 
     void update(uInt64 maxCycles = 50000);
 
+    /**
+      Run the emulation until the current frame is complete.  The CPU
+      runs in as few dispatches as possible, as it is stopped by the
+      frame manager once the frame ends.
+
+      @param result  Set to the result of the last dispatch; emulation stops
+                     early if this is not 'ok' (e.g. on a breakpoint)
+    */
+    void updateFrame(DispatchResult& result);
+
     /**
       Did we generate a new frame?
      */
@@ -244,6 +296,33 @@ class TIA : public Device
     */
     uInt8* frameBuffer() { return static_cast<uInt8*>(myFramebuffer); }
 
+    /**
+      Answers which scanlines of the framebuffer changed since the last
+      call to clearDirtyLines(), so that the video pipeline can skip the
+      others.  Code writing to frameBuffer() directly must call
+      invalidateFrameBuffer() afterwards.
+    */
+    const std::bitset<TIAConstants::frameBufferHeight>& dirtyLines() const {
+      return myDirtyLines;
+    }
+    void clearDirtyLines() { myDirtyLines.reset(); }
+    void invalidateFrameBuffer() { myDirtyLines.set(); }
+
+    /**
+      Enables recording the CPU cycles each scanline of the framebuffer
+      waited for WSYNC, for the cycle budget overlay.
+    */
+    void enableLineTiming(bool enable);
+    bool lineTimingEnabled() const { return myLineTimingEnabled; }
+
+    /**
+      The CPU cycles each scanline of the framebuffer waited for WSYNC, or
+      NO_WSYNC for lines without any WSYNC (the kernel overran, or is
+      timed without WSYNC).  Only valid while line timing is enabled.
+    */
+    const uInt8* lineWaits() const { return myFrameLineWaits.data(); }
+    static constexpr uInt8 NO_WSYNC = 0xff;
+
     /**
       Answers dimensional info about the framebuffer.
     */
@@ -522,6 +601,12 @@ class TIA : public Device
      */
     void updateEmulation();
 
+    /**
+     * Wait until the render thread (if enabled) has applied all register
+     * writes, so that the TIA state can be looked at again.
+     */
+    void syncRenderThread();
+
   private:
     /**
      * During each line, the TIA cycles through these two states.
@@ -552,6 +637,27 @@ class TIA : public Device
      */
     void onFrameComplete();
 
+    /**
+     * Start or stop the render thread (see myRenderThreadEnabled).
+     */
+    void enableRenderThread(bool enable);
+
+    /**
+     * Pass a register write to the render thread, rather than applying it
+     * right away; returns false for the writes which must be synchronous.
+     */
+    bool logWrite(uInt8 address, uInt8 value);
+
+    /**
+     * The main loop of the render thread.
+     */
+    void runRenderThread();
+
+    /**
+     * Apply a register write, once the emulation has caught up with it.
+     */
+    void writeRegister(uInt8 address, uInt8 value);
+
     /**
      * Called when the CPU enters halt state (RDY pulled low). Execution continues
      * immediatelly afterwards, so we have to adjust the system clock to account
@@ -564,6 +670,23 @@ class TIA : public Device
      */
     void cycle(uInt32 colorClocks);
 
+    /**
+     * The loop of cycle(), specialized for stock hardware (no developer quirks
+     * which act on every clock) and for the general case.
+     */
+    template<bool quirks> void cycleClocks(uInt32 colorClocks);
+
+    /**
+     * Execute a span of clocks in one go. This is only valid if no delayed
+     * write becomes due during the span, no movement is in progress and we are either in the visible
+     * part of the line or replaying a cached line. The span ends with the
+     * current line at the latest.
+     *
+     * @param maxClocks  The maximum number of clocks to execute
+     * @return           The number of clocks actually executed
+     */
+    template<bool quirks> uInt32 cycleSpan(uInt32 maxClocks);
+
     /**
      * Advance the movement logic by a single clock.
      */
@@ -577,7 +700,12 @@ class TIA : public Device
     /**
      * Advance a single clock duing the visible part of the scanline.
      */
-    void tickHframe();
+    template<bool quirks> void tickHframe();
+
+    /**
+     * Check whether any developer quirk that affects every clock is enabled.
+     */
+    void updateQuirks();
 
     /**
      * Update the collision bitfield.
@@ -589,11 +717,28 @@ class TIA : public Device
      */
     void applyRsync();
 
+    /**
+     * Remember where the beam was when rendering of the frame stopped.
+     */
+    void onRenderingStopped(bool endOfLine);
+
     /**
      * Render the current pixel into the framebuffer.
      */
     void renderPixel(uInt32 x, uInt32 y);
 
+    /**
+     * Render a span of pixels from the collision words the objects reported
+     * for each of its clocks (the same as rendering each pixel on its own).
+     */
+    void renderSpan(uInt32 x, uInt32 y,
+                    const uInt16 collision[][TIAConstants::H_CLOCKS], uInt32 clocks);
+
+    /**
+     * Fill the lookup table used by the priority encoder in renderPixel.
+     */
+    void setupPriorityLookup();
+
     /**
      * Clear the first 8 pixels of a scanline with black if we are in hblank
      * (called during HMOVE).
@@ -712,12 +857,31 @@ class TIA : public Device
     uInt8 myPlSwapDelay;
     uInt8 myBlSwapDelay;
 
+    /**
+      Whether any of the inverted phase clocks is enabled; the object clocks
+      only check for these then.
+    */
+    bool myQuirksEnabled;
+
     /**
      * The frame manager is responsible for detecting frame boundaries and the visible
      * region of each frame.
      */
     AbstractFrameManager* myFrameManager;
 
+    /**
+     * The frame manager if it is the regular one (and not one of the detectors),
+     * so that the per-scanline calls into it can be made directly.
+     */
+    FrameManager* myRegularFrameManager;
+
+    /**
+     * Is the frame manager only autodetecting the frame layout / ystart? In this
+     * case, only the beam and the sync signals are emulated; objects, collisions
+     * and frame buffers are left alone.
+     */
+    bool myDetectionMode;
+
     /**
      * The various TIA objects.
      */
@@ -742,17 +906,48 @@ class TIA : public Device
     LatchedInput myInput0;
     LatchedInput myInput1;
 
-    // Pointer to the internal color-index-based frame buffer
-    uInt8 myFramebuffer[TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight];
-
-    // The frame is rendered to the backbuffer and only copied to the framebuffer
-    // upon completion
-    uInt8 myBackBuffer[TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight];
-    uInt8 myFrontBuffer[TIAConstants::H_PIXEL * TIAConstants::frameBufferHeight];
-
-    // We snapshot frame statistics when the back buffer is copied to the front buffer
-    // and when the front buffer is copied to the frame buffer
-    uInt32 myFrontBufferScanlines, myFrameBufferScanlines;
+    // Pointer to the internal color-index-based frame buffer; lean
+    // consoles (see the 'lean' setting) are never rendered, and don't
+    // have one
+    uInt8* myFramebuffer;
+
+    // The frame is rendered to the back buffer, which is exchanged with the
+    // front buffer (the last completed frame) upon completion.  Rendering to
+    // the framebuffer exchanges the front buffer with the render buffer in
+    // turn, so completed frames are handed over without copying them.
+    static constexpr uInt32 FRAME_BUFFERS = 3;
+    uInt8* myFrameBuffers[FRAME_BUFFERS];
+    uInt8* myBackBuffer;
+    uInt32 myBackBufferIndex, myRenderBufferIndex;
+
+    // The memory of the frame buffers and the framebuffer
+    ByteBuffer myFrameStorage;
+
+    // The buffer holding the last completed frame (the front buffer until
+    // it is rendered, the render buffer afterwards)
+    uInt32 myLastFrameIndex;
+
+    // Where rendering of the current frame stopped; the pixels after this
+    // keep their content from the previous frame, as if there was only one
+    // back buffer
+    uInt32 myRenderEndY, myRenderEndX;
+
+    // The index of the front buffer, with FRONT_BUFFER_FRESH set while it
+    // holds a frame which hasn't been rendered yet
+    std::atomic<uInt32> myFrontBufferIndex;
+    static constexpr uInt32 FRONT_BUFFER_FRESH = 0x80;
+
+    // Frame statistics are kept with each buffer, and snapshot when a frame
+    // is rendered to the framebuffer
+    uInt32 myBufferScanlines[FRAME_BUFFERS], myFrameBufferScanlines;
+
+    // Scanlines of the framebuffer which changed since they were last consumed
+    std::bitset<TIAConstants::frameBufferHeight> myDirtyLines;
+
+    // The WSYNC waits of each scanline, in the same stages as the buffers
+    bool myLineTimingEnabled;
+    using LineWaits = std::array<uInt8, TIAConstants::frameBufferHeight>;
+    LineWaits myBufferLineWaits[FRAME_BUFFERS], myFrameLineWaits;
 
     // Frames since the last time a frame was rendered to the render buffer
     uInt32 myFramesSinceLastRender;
@@ -828,6 +1023,13 @@ class TIA : public Device
      */
     Priority myPriority;
 
+    /**
+     * The priority encoder as a lookup table. For each priority mode, the mask of
+     * the objects that are currently on (bit n corresponds to FixedObject n) is
+     * mapped to the object that determines the color of the pixel.
+     */
+    uInt8 myPriorityLookup[3][1 << BK];
+
     /**
      * The index of the last CPU cycle that was included in the simulation.
      */
@@ -855,6 +1057,50 @@ class TIA : public Device
      */
     uInt64 myTimestamp;
 
+    /**
+     * The TIA may run on a thread of its own (the "render thread"), behind
+     * the CPU: the CPU logs its register writes, along with the clocks
+     * leading up to them, and the render thread replays them.  Reading the
+     * TIA, and the writes which affect the CPU (RSYNC, VSYNC), wait for the
+     * render thread to catch up.  WSYNC only needs the horizontal counter,
+     * which the CPU tracks itself (myShadowHctr).
+     *
+     * While the render thread is enabled, myLastCycle and mySubClock belong
+     * to the CPU, and the rest of the TIA to the render thread until it has
+     * caught up.
+     */
+    struct LoggedWrite {
+      uInt64 cycle;     // the system cycle of the write
+      uInt32 clocks;    // the clocks to run before applying it
+      uInt8 address;    // NO_WRITE if only the clocks are run
+      uInt8 value;
+    };
+    static constexpr uInt8 NO_WRITE = 0xff;
+
+    bool myRenderThreadEnabled;
+    std::thread myRenderThread;
+    // Allocated when the render thread is first enabled; at about 100 KB,
+    // it would be most of the size of a TIA otherwise
+    unique_ptr<Common::LockFreeQueue<LoggedWrite, 4096>> myWriteLog;
+    std::atomic<uInt64> myLoggedWrites, myAppliedWrites;
+
+    // The render thread sleeps when there is nothing to do for a while
+    std::atomic<bool> myRenderThreadDone, myRenderThreadSleeping;
+    std::mutex myRenderThreadMutex;
+    std::condition_variable myRenderThreadWakeup;
+
+    // Set while the render thread applies a write, with the system cycle of
+    // the write
+    bool myOnRenderThread;
+    uInt64 myRenderThreadCycle;
+
+    // A frame completed on the render thread; the CPU is told when it next
+    // waits for the render thread
+    bool myFrameCompletePending;
+
+    // The horizontal counter as of the last logged write
+    uInt32 myShadowHctr;
+
     /**
      * The "shadow registers" track the last written register value for the
      * debugger.
@@ -23,6 +23,8 @@
 #include "Serializable.hxx"
 #include "FrameLayout.hxx"
 
+class FrameManager;
+
 class AbstractFrameManager : public Serializable
 {
   public:
@@ -74,6 +76,19 @@ class AbstractFrameManager : public Serializable
      */
     bool isRendering() const { return myIsRendering; }
 
+    /**
+     * Is this frame manager only used for autodetection? If so, the TIA skips
+     * all work that doesn't affect frame timing (objects, collisions, frame
+     * buffers).
+     */
+    virtual bool isDetector() const { return false; }
+
+    /**
+     * The regular frame manager, if this is it (the libretro core is built
+     * without RTTI, so no dynamic_cast).
+     */
+    virtual FrameManager* regularFrameManager() { return nullptr; }
+
     /**
      * Is vsync on?
      */
@@ -32,6 +32,9 @@ enum Metrics: uInt32 {
   // tolerance window around ideal frame size for TV mode detection
   tvModeDetectionTolerance  = 20,
 
+  // detection is stopped once one frame layout leads by this number of frames
+  confidentFrames           = 15,
+
   // these frames will not be considered for detection
   initialGarbageFrames      = TIAConstants::initialGarbageFrames
 };
@@ -42,6 +45,13 @@ FrameLayout FrameLayoutDetector::detectedLayout() const{
   return myPalFrames > myNtscFrames ? FrameLayout::pal : FrameLayout::ntsc;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FrameLayoutDetector::isConfident() const
+{
+  return std::max(myPalFrames, myNtscFrames) >=
+         std::min(myPalFrames, myNtscFrames) + Metrics::confidentFrames;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 FrameLayoutDetector::FrameLayoutDetector()
   : myState(State::waitForVsyncStart)
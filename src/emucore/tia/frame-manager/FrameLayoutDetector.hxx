@@ -37,6 +37,17 @@ class FrameLayoutDetector: public AbstractFrameManager {
      */
     FrameLayout detectedLayout() const;
 
+    /**
+     * Is the detected frame layout clear enough already, so that detection can
+     * be stopped?
+     */
+    bool isConfident() const;
+
+    /**
+     * We only do autodetection.
+     */
+    bool isDetector() const override { return true; }
+
   protected:
 
     /**
@@ -23,13 +23,25 @@
 #include "bspf.hxx"
 #include "JitterEmulation.hxx"
 
-class FrameManager: public AbstractFrameManager {
+class FrameManager final : public AbstractFrameManager {
   public:
 
     FrameManager();
 
   public:
 
+    /**
+      Same as AbstractFrameManager::nextLine(), but calls onNextLine()
+      directly instead of through the vtable; used by the TIA for every
+      scanline when this is the frame manager in use.
+    */
+    void nextLine() {
+      ++myCurrentFrameTotalLines;
+      FrameManager::onNextLine();
+    }
+
+    FrameManager* regularFrameManager() override { return this; }
+
     void setJitterFactor(uInt8 factor) override { myJitterEmulation.setJitterFactor(factor); }
 
     bool jitterEnabled() const override { return myJitterEnabled; }
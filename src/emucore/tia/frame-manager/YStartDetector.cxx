@@ -42,6 +42,9 @@ enum Metrics: uInt32 {
   // switch to fixed mode after this number of stable frames (+1)
   minStableVblankFrames     = 1,
 
+  // detection is stopped after this number of frames in fixed mode without violations
+  confidentLockedFrames     = 30,
+
   // no transitions to fixed mode will happend during those
   initialGarbageFrames      = TIAConstants::initialGarbageFrames
 };
@@ -61,6 +64,12 @@ uInt32 YStartDetector::detectedYStart() const
   return myLastVblankLines;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool YStartDetector::isConfident() const
+{
+  return myLockedFrames >= Metrics::confidentLockedFrames;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void YStartDetector::onReset()
 {
@@ -71,6 +80,7 @@ void YStartDetector::onReset()
   myLastVblankLines = 0;
   myVblankViolations = 0;
   myStableVblankFrames = 0;
+  myLockedFrames = 0;
   myVblankViolated = false;
 }
 
@@ -210,6 +220,9 @@ void YStartDetector::setState(State state)
       break;
 
     case State::waitForVsyncStart:
+      if (myVblankMode == VblankMode::locked && !myVblankViolated) ++myLockedFrames;
+      else myLockedFrames = 0;
+
       notifyFrameComplete();
       notifyFrameStart();
       break;
@@ -42,6 +42,16 @@ class YStartDetector: public AbstractFrameManager {
      */
     void setLayout(FrameLayout layout) override { this->layout(layout); }
 
+    /**
+     * Has ystart been stable for long enough, so that detection can be stopped?
+     */
+    bool isConfident() const;
+
+    /**
+     * We only do autodetection.
+     */
+    bool isDetector() const override { return true; }
+
   protected:
 
     /**
@@ -138,6 +148,11 @@ class YStartDetector: public AbstractFrameManager {
      */
     uInt32 myStableVblankFrames;
 
+    /**
+     * The number of consecutive frames in locked mode without a violation.
+     */
+    uInt32 myLockedFrames;
+
     /**
      * Tracks deviations from the determined ystart value during a fixed mode frame in order to
      * avoid double counting.
@@ -20,6 +20,7 @@
 #include "Version.hxx"
 #include "Widget.hxx"
 #include "Font.hxx"
+#include "ThreadPlacement.hxx"
 #include "AboutDialog.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -103,6 +104,7 @@ void AboutDialog::updateStrings(int page, int lines, string& title)
       ADD_ATEXT("\\CA multi-platform Atari 2600 VCS emulator");
       ADD_ATEXT(string("\\C\\c2Features: ") + instance().features());
       ADD_ATEXT(string("\\C\\c2") + instance().buildInfo());
+      ADD_ATEXT(string("\\C\\c2Threads: ") + ThreadPlacement::applied());
       ADD_ALINE();
       ADD_ATEXT("\\CCopyright (c) 1995-2019 The Stella Team");
       ADD_ATEXT("\\C(https://stella-emu.github.io)");
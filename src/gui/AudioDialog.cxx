@@ -120,6 +120,7 @@ AudioDialog::AudioDialog(OSystem& osystem, DialogContainer& parent,
   VarList::push_back(items, "Low", static_cast<int>(AudioSettings::ResamplingQuality::nearestNeightbour));
   VarList::push_back(items, "High", static_cast<int>(AudioSettings::ResamplingQuality::lanczos_2));
   VarList::push_back(items, "Ultra", static_cast<int>(AudioSettings::ResamplingQuality::lanczos_3));
+  VarList::push_back(items, "Polyphase", static_cast<int>(AudioSettings::ResamplingQuality::polyphase));
   myResamplingPopup = new PopUpWidget(this, font, xpos, ypos,
                                 pwidth, lineHeight,
                                 items, "Resampling quality ", lwidth);
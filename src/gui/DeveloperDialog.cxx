@@ -937,6 +937,11 @@ void DeveloperDialog::saveConfig()
   // Read from write ports break
   if(instance().hasConsole())
     instance().console().system().m6502().setReadFromWritePortBreak(myRWPortBreakWidget->getState());
+
+  // Access tracking for the disassembly (always enabled in the debugger)
+  if(instance().hasConsole() &&
+     instance().eventHandler().state() != EventHandlerState::DEBUGGER)
+    instance().console().system().enableAccessFlags(instance().settings().getBool("dev.settings"));
 #endif
 }
 
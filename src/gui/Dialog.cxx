@@ -64,6 +64,7 @@ Dialog::Dialog(OSystem& instance, DialogContainer& parent, const GUI::Font& font
     _surface(nullptr),
     _tabID(0),
     _flags(Widget::FLAG_ENABLED | Widget::FLAG_BORDER | Widget::FLAG_CLEARBG),
+    _widgetDirty(false),
     _max_w(0),
     _max_h(0)
 {
@@ -208,14 +209,33 @@ void Dialog::positionAt(uInt32 pos)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool Dialog::render()
+bool Dialog::render(bool present)
 {
-  if(!_dirty || !isVisible())
+  if(!(isDirty() || present) || !isVisible())
     return false;
 
-  // Draw this dialog
-  center();
-  drawDialog();
+  if(_dirty)
+  {
+    // Draw this dialog
+    center();
+    drawDialog();
+  }
+  else if(_widgetDirty)
+  {
+    // Only redraw the widgets which changed, and upload only their rows
+    uInt32 top = _surface->height(), bottom = 0;
+    drawDirtyWidgets(_firstWidget, top, bottom);
+    if(_focusedWidget && top < bottom)
+    {
+      const int y = _focusedWidget->getAbsY() - 1;
+      top = std::min(top, uInt32(std::max(y, 0)));
+      bottom = std::max(bottom, uInt32(y + _focusedWidget->getHeight() + 2));
+      drawFocus();
+    }
+    _surface->setDirtyRows(top, bottom);
+  }
+  else
+    _surface->setDirtyRows(0, 0);
 
   // Update dialog surface; also render any extra surfaces
   // Extra surfaces must be rendered afterwards, so they are drawn on top
@@ -225,11 +245,47 @@ bool Dialog::render()
       surface->render();
     });
   }
-  _dirty = false;
+  _dirty = _widgetDirty = false;
 
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Dialog::drawDirtyWidgets(Widget* w, uInt32& top, uInt32& bottom)
+{
+  while(w)
+  {
+    if(w->_dirty)
+    {
+      // Account for the focus outline surrounding the widget
+      const int y = w->getAbsY() - 1;
+      top = std::min(top, uInt32(std::max(y, 0)));
+      bottom = std::max(bottom, uInt32(y + w->getHeight() + 2));
+
+      // This also draws all its children
+      w->draw();
+    }
+    else
+      drawDirtyWidgets(w->_firstWidget, top, bottom);
+
+    w = w->_next;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Dialog::drawFocus()
+{
+  // Don't change focus, since this will trigger lost and received
+  // focus events
+  if(_focusedWidget)
+  {
+    _focusedWidget = Widget::setFocusForChain(this, getFocusList(),
+      _focusedWidget, 0, false);
+    if(_focusedWidget)
+      _focusedWidget->draw(); // make sure the highlight color is drawn initially
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Dialog::releaseFocus()
 {
@@ -423,15 +479,7 @@ void Dialog::drawDialog()
   }
 
   // Draw outlines for focused widgets
-  // Don't change focus, since this will trigger lost and received
-  // focus events
-  if(_focusedWidget)
-  {
-    _focusedWidget = Widget::setFocusForChain(this, getFocusList(),
-      _focusedWidget, 0, false);
-    if(_focusedWidget)
-      _focusedWidget->draw(); // make sure the highlight color is drawn initially
-  }
+  drawFocus();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -618,6 +666,12 @@ Event::Type Dialog::getJoyAxisEvent(int stick, JoyAxis axis, JoyDir adir, int bu
   return instance().eventHandler().eventForJoyAxis(EventMode::kMenuMode, stick, axis, adir, button);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Dialog::tick()
+{
+  Widget::tickInChain(_firstWidget);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Dialog::handleJoyAxis(int stick, JoyAxis axis, JoyDir adir, int button)
 {
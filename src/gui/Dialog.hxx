@@ -66,8 +66,12 @@ class Dialog : public GuiObject
     // A dialog being dirty indicates that its underlying surface needs to be
     // redrawn and then re-rendered; this is taken care of in ::render()
     void setDirty() override { _dirty = true; }
-    bool isDirty() const { return _dirty; }
-    bool render();
+    // Only some of the widgets need to be redrawn (see Widget::setDirty())
+    void setWidgetDirty() { _widgetDirty = true; }
+    bool isDirty() const { return _dirty || _widgetDirty; }
+    // Redraw whatever is dirty; with 'present', the surface is re-rendered
+    // even if nothing changed
+    bool render(bool present = false);
 
     void addFocusWidget(Widget* w) override;
     void addToFocusList(WidgetArray& list) override;
@@ -129,6 +133,12 @@ class Dialog : public GuiObject
     virtual void draw() override { }
     void releaseFocus() override;
 
+    /** Draw all dirty widgets in the chain, and extend the given range of
+        surface rows by the area they cover */
+    void drawDirtyWidgets(Widget* w, uInt32& top, uInt32& bottom);
+    /** Redraw the outline of the focused widget */
+    void drawFocus();
+
     virtual void handleText(char text);
     virtual void handleKeyDown(StellaKey key, StellaMod modifiers, bool repeated = false);
     virtual void handleKeyUp(StellaKey key, StellaMod modifiers);
@@ -143,6 +153,7 @@ class Dialog : public GuiObject
     virtual bool handleJoyHat(int stick, int hat, JoyHatDir hdir, int button = JOY_CTRL_NONE);
     virtual void handleCommand(CommandSender* sender, int cmd, int data, int id) override;
     virtual Event::Type getJoyAxisEvent(int stick, JoyAxis axis, JoyDir adir, int button);
+    virtual void tick();
 
     Widget* findWidget(int x, int y) const; // Find the widget at pos x,y if any
 
@@ -231,6 +242,7 @@ class Dialog : public GuiObject
     int _tabID;
     int _flags;
     bool _dirty;
+    bool _widgetDirty;
     uInt32 _max_w; // maximum wanted width
     uInt32 _max_h; // maximum wanted height
 
@@ -53,6 +53,9 @@ void DialogContainer::updateTime(uInt64 time)
   // Check for pending continuous events and send them to the active dialog box
   Dialog* activeDialog = myDialogStack.top();
 
+  // Let the widgets pick up any results of background work
+  activeDialog->tick();
+
   // Mouse button still pressed
   if(myCurrentMouseDown.b != MouseButton::NONE && myClickRepeatTime < myTime)
   {
@@ -103,13 +106,15 @@ bool DialogContainer::draw(bool full)
   if(full)
     myDialogStack.top()->setDirty();
 
-  // If the top dialog is dirty, then all below it must be redrawn too
+  // If the top dialog is dirty, then all below it must be rendered too
+  // They only have to be redrawn when the top one is completely redrawn
   const bool dirty = needsRedraw();
+  const bool redraw = myDialogStack.top()->_dirty;
 
   myDialogStack.applyAll([&](Dialog*& d){
-    if(dirty)
+    if(redraw)
       d->setDirty();
-    full |= d->render();
+    full |= d->render(dirty);
   });
 
   return full;
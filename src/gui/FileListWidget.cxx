@@ -16,6 +16,8 @@
 //============================================================================
 
 #include <cctype>
+#include <chrono>
+#include <thread>
 
 #include "ScrollBarWidget.hxx"
 #include "FileListWidget.hxx"
@@ -29,6 +31,7 @@ FileListWidget::FileListWidget(GuiObject* boss, const GUI::Font& font,
   : StringListWidget(boss, font, x, y, w, h),
     _fsmode(FilesystemNode::ListMode::All),
     _selected(0),
+    _cacheTime(0),
     _quickSelectTime(0)
 {
   // This widget is special, in that it catches signals and redirects them
@@ -75,22 +78,146 @@ void FileListWidget::setLocation(const FilesystemNode& node, string select)
 {
   _node = node;
 
-  // Read in the data from the file system (start with an empty list)
-  _fileList.clear();
-  _fileList.reserve(512);
-  _node.getChildren(_fileList, _fsmode, _filter);
+  // Use the cached listing, as long as the directory hasn't changed since
+  uInt64 size = 0, modified = 0;
+  auto it = _cache.find(_node.getPath());
+  if(it != _cache.end() && _node.getFileInfo(size, modified) &&
+     it->second.modified == modified)
+  {
+    _loading = std::future<FSList>();
+    it->second.lastUsed = ++_cacheTime;
+    showListing(it->second.files, select);
+    return;
+  }
 
-  // Now fill the list widget with the names from the file list
-  StringList l;
-  for(const auto& file: _fileList)
-    l.push_back(file.getName());
+  // Otherwise read in the data from the file system in the background
+  // Filtering is left to the UI thread, since the filter may access widgets
+  std::promise<FSList> promise;
+  _loading = promise.get_future();
+  std::thread([dir = _node, mode = _fsmode, promise = std::move(promise)]() mutable
+  {
+    FSList files;
+    files.reserve(512);
+    try
+    {
+      dir.getChildren(files, mode);
+    }
+    catch(...)
+    {
+      files.clear();
+    }
+    promise.set_value(std::move(files));
+  }).detach();
+
+  // Most directories are read almost instantly, so wait for a moment
+  // before falling back to showing the listing whenever it arrives
+  if(_loading.wait_for(std::chrono::milliseconds(_LOADING_DELAY)) ==
+     std::future_status::ready)
+  {
+    const FSList& files = _loading.get();
+    cacheListing(files);
+    showListing(files, select);
+    return;
+  }
+
+  // In the meantime, only allow going back up
+  _loadingSelect = select;
+  FSList parent;
+  if(_node.hasParent())
+  {
+    parent.emplace_back(_node.getParent());
+    parent.back().setName(" [..]");
+  }
+  showListing(parent, select);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FileListWidget::showListing(const FSList& listing, const string& select)
+{
+  // The parent entry is always shown, everything else must pass the filter
+  _listing = listing;
+  _lowerNames.clear();
+  _filtered.clear();
+  for(uInt32 i = 0; i < listing.size(); ++i)
+    if((i == 0 && _node.hasParent()) || _filter(listing[i]))
+      _filtered.push_back(i);
+  applyPattern(_filtered);
 
-  setList(l);
+  // The list widget takes the names directly from the file list
+  ListWidget::recalc();
   setSelected(select);
 
   ListWidget::recalc();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FileListWidget::setNamePattern(const string& pattern)
+{
+  string lowerPattern = pattern;
+  BSPF::toLowerCase(lowerPattern);
+  if(lowerPattern == _pattern)
+    return;
+
+  // Only the files matching the previous pattern can match a longer one
+  const bool narrow = _pattern != "" && lowerPattern.find(_pattern) != string::npos;
+  const string select = selected().getName();
+
+  _pattern = lowerPattern;
+  applyPattern(narrow ? _matches : _filtered);
+
+  ListWidget::recalc();
+  setSelected(select);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FileListWidget::applyPattern(const vector<uInt32>& entries)
+{
+  if(_pattern != "" && _lowerNames.size() != _listing.size())
+  {
+    _lowerNames.clear();
+    _lowerNames.reserve(_listing.size());
+    for(const auto& file: _listing)
+    {
+      string name = file.getName();
+      _lowerNames.push_back(BSPF::toLowerCase(name));
+    }
+  }
+
+  vector<uInt32> matches;
+  matches.reserve(entries.size());
+  for(uInt32 i: entries)
+    if(_pattern == "" || _listing[i].isDirectory() ||
+       _lowerNames[i].find(_pattern) != string::npos)
+      matches.push_back(i);
+  _matches = std::move(matches);
+
+  _fileList.clear();
+  _fileList.reserve(_matches.size());
+  for(uInt32 i: _matches)
+    _fileList.push_back(_listing[i]);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FileListWidget::cacheListing(const FSList& listing)
+{
+  uInt64 size = 0, modified = 0;
+  if(!_node.getFileInfo(size, modified))
+    return;
+
+  // Make room by forgetting the directory visited the longest time ago
+  if(_cache.size() >= _CACHE_SIZE && _cache.find(_node.getPath()) == _cache.end())
+    _cache.erase(std::min_element(_cache.begin(), _cache.end(),
+      [](const std::pair<const string, Listing>& a,
+         const std::pair<const string, Listing>& b) {
+        return a.second.lastUsed < b.second.lastUsed;
+      }));
+
+  Listing& entry = _cache[_node.getPath()];
+  entry.files = listing;
+  entry.modified = modified;
+  entry.lastUsed = ++_cacheTime;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FileListWidget::selectDirectory()
 {
@@ -112,6 +239,30 @@ void FileListWidget::reload()
     setLocation(_node, selected().getName());
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FileListWidget::refresh()
+{
+  _cache.erase(_node.getPath());
+  reload();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void FileListWidget::tick()
+{
+  if(!_loading.valid() ||
+     _loading.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    return;
+
+  const FSList& files = _loading.get();
+  cacheListing(files);
+  showListing(files, _loadingSelect);
+
+  // Let the boss know the listing has changed
+  setTarget(_boss);
+  sendCommand(ItemChanged, _selected, _id);
+  setTarget(this);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool FileListWidget::handleText(char text)
 {
@@ -135,9 +286,9 @@ bool FileListWidget::handleText(char text)
   _quickSelectTime = time + _QUICK_SELECT_DELAY;
 
   int selectedItem = 0;
-  for(const auto& i: _list)
+  for(const auto& file: _fileList)
   {
-    if(BSPF::startsWithIgnoreCase(i, _quickSelectStr))
+    if(BSPF::startsWithIgnoreCase(file.getName(), _quickSelectStr))
       break;
     selectedItem++;
   }
@@ -192,3 +343,5 @@ void FileListWidget::handleCommand(CommandSender* sender, int cmd, int data, int
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt64 FileListWidget::_QUICK_SELECT_DELAY = 300;
+constexpr size_t FileListWidget::_CACHE_SIZE;
+constexpr uInt32 FileListWidget::_LOADING_DELAY;
@@ -20,6 +20,9 @@
 
 class CommandSender;
 
+#include <future>
+#include <map>
+
 #include "FSNode.hxx"
 #include "Stack.hxx"
 #include "StringListWidget.hxx"
@@ -38,6 +41,13 @@ class CommandSender;
 
   Widgets wishing to enforce their own filename filtering are able
   to use a 'NameFilter' as described below.
+
+  Directories are read and sorted in the background, so that slow
+  filesystems (network shares, etc) don't block the UI; if reading takes
+  longer than a moment, only the parent entry is shown until the listing
+  arrives, at which point ItemChanged is emitted.  Listings of recently
+  visited directories are cached for as long as the directory hasn't been
+  modified.
 */
 class FileListWidget : public StringListWidget
 {
@@ -54,9 +64,17 @@ class FileListWidget : public StringListWidget
 
     /** Determines how to display files/folders; either setDirectory or reload
         must be called after any of these are called. */
-    void setListMode(FilesystemNode::ListMode mode) { _fsmode = mode; }
+    void setListMode(FilesystemNode::ListMode mode) {
+      if(mode != _fsmode)  _cache.clear();
+      _fsmode = mode;
+    }
     void setNameFilter(const FilesystemNode::NameFilter& filter) { _filter = filter; }
 
+    /** Only show the files whose names contain the given text (ignoring
+        case); directories are always shown.  This takes effect directly,
+        and extending the text only searches the files still shown. */
+    void setNamePattern(const string& pattern);
+
     /**
       Set initial directory, and optionally select the given item.
 
@@ -69,18 +87,34 @@ class FileListWidget : public StringListWidget
     /** Select parent directory (if applicable) */
     void selectParent();
 
-    /** Reload current location (file or directory) */
+    /** Reload current location (file or directory), e.g. after changing
+        the filter; the directory is only reread if it has been modified */
     void reload();
 
+    /** Reload current location, always rereading it from the file system */
+    void refresh();
+
+    /** Indicates whether the current directory is still being read */
+    bool isLoading() const { return _loading.valid(); }
+
     /** Gets current node(s) */
     const FilesystemNode& selected() {
+      if(_fileList.empty())
+        return _node;
       _selected = BSPF::clamp(_selected, 0u, uInt32(_fileList.size()-1));
       return _fileList[_selected];
     }
     const FilesystemNode& currentDir() const { return _node; }
+    const FSList& fileList() const { return _fileList; }
 
     static void setQuickSelectDelay(uInt64 time) { _QUICK_SELECT_DELAY = time; }
 
+    /** The names are taken directly from the file list when needed */
+    int getListSize() const override { return int(_fileList.size()); }
+    const string& getListItem(int item) const override {
+      return _fileList[item].getName();
+    }
+
   private:
     /** Very similar to setDirectory(), but also updates the history */
     void setLocation(const FilesystemNode& node, string select = EmptyString);
@@ -88,6 +122,17 @@ class FileListWidget : public StringListWidget
     /** Descend into currently selected directory */
     void selectDirectory();
 
+    /** Fill the list from the given (unfiltered) directory listing */
+    void showListing(const FSList& listing, const string& select);
+
+    /** Fill the file list from the given entries of the listing which
+        match the name pattern */
+    void applyPattern(const vector<uInt32>& entries);
+
+    /** Remember the listing of the current directory, if it can be dated */
+    void cacheListing(const FSList& listing);
+
+    void tick() override;
     bool handleText(char text) override;
     void handleCommand(CommandSender* sender, int cmd, int data, int id) override;
 
@@ -97,9 +142,36 @@ class FileListWidget : public StringListWidget
     FilesystemNode _node;
     FSList _fileList;
 
+    // The (unfiltered) listing shown, the lower-case names of its entries
+    // (only created once a pattern is used), and the entries which pass
+    // the filter, and the pattern as well
+    FSList _listing;
+    StringList _lowerNames;
+    vector<uInt32> _filtered, _matches;
+    string _pattern;
+
     Common::FixedStack<string> _history;
     uInt32 _selected;
 
+    // The listing of the current directory while it's being read
+    std::future<FSList> _loading;
+    string _loadingSelect;
+
+    // Unfiltered listings of recently visited directories, along with the
+    // modification time of each directory when it was read
+    struct Listing
+    {
+      FSList files;
+      uInt64 modified;
+      uInt64 lastUsed;
+    };
+    std::map<string, Listing> _cache;
+    uInt64 _cacheTime;
+    static constexpr size_t _CACHE_SIZE = 32;
+
+    // How long to wait for a listing before showing it in the background
+    static constexpr uInt32 _LOADING_DELAY = 100;  // in milliseconds
+
     string _quickSelectStr;
     uInt64 _quickSelectTime;
     static uInt64 _QUICK_SELECT_DELAY;
@@ -28,6 +28,46 @@ Font::Font(const FontDesc& desc)
 {
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Font::buildGlyphs() const
+{
+  const FontDesc& desc = myFontDesc;
+
+  myGlyphs.reserve(desc.size);
+  for(int chr = 0; chr < desc.size; ++chr)
+  {
+    Glyph glyph;
+
+    if(!desc.bbx)
+      glyph.bbx = { Int8(desc.fbbw), Int8(desc.fbbh), Int8(desc.fbbx), Int8(desc.fbby) };
+    else
+      glyph.bbx = desc.bbx[chr];
+    glyph.firstSpan = uInt32(mySpans.size());
+
+    const uInt16* bits = desc.bits + (desc.offset ? desc.offset[chr] : (chr * desc.fbbh));
+    for(int y = 0; y < glyph.bbx.h; ++y)
+    {
+      const uInt16 row = *bits++;
+
+      for(int x = 0; x < glyph.bbx.w; )
+      {
+        if(!(row & (0x8000 >> x)))
+        {
+          ++x;
+          continue;
+        }
+        const int start = x;
+        while(x < glyph.bbx.w && (row & (0x8000 >> x)))
+          ++x;
+        mySpans.push_back({ uInt8(y), uInt8(start), uInt8(x - start) });
+      }
+    }
+    glyph.numSpans = uInt32(mySpans.size()) - glyph.firstSpan;
+
+    myGlyphs.push_back(glyph);
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int Font::getCharWidth(uInt8 chr) const
 {
@@ -46,6 +86,24 @@ int Font::getCharWidth(uInt8 chr) const
   return myFontDesc.width[chr - myFontDesc.firstchar];
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const Font::Glyph* Font::getGlyph(uInt8 chr) const
+{
+  // If this character is not included in the font, use the default char.
+  if(chr < myFontDesc.firstchar || chr >= myFontDesc.firstchar + myFontDesc.size)
+  {
+    if(chr == ' ')
+      return nullptr;
+    chr = myFontDesc.defaultchar;
+  }
+
+  // Only fonts which are actually drawn with are rasterized
+  if(myGlyphs.empty())
+    buildGlyphs();
+
+  return &myGlyphs[chr - myFontDesc.firstchar];
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 int Font::getStringWidth(const string& str) const
 {
@@ -54,6 +54,29 @@ namespace GUI {
 
 class Font
 {
+  public:
+    /**
+      A horizontal run of set pixels within a glyph, relative to the
+      top-left corner of its bounding box.
+    */
+    struct Span
+    {
+      uInt8 row;
+      uInt8 col;
+      uInt8 len;
+    };
+
+    /**
+      A pre-rasterized glyph; its pixels are stored as spans, so that it
+      can be drawn with one fill per run rather than testing each bit.
+    */
+    struct Glyph
+    {
+      BBX bbx;
+      uInt32 firstSpan;
+      uInt32 numSpans;
+    };
+
   public:
     explicit Font(const FontDesc& desc);
 
@@ -67,9 +90,28 @@ class Font
 
     int getStringWidth(const string& str) const;
 
+    /**
+      Get the pre-rasterized glyph for the given character.
+
+      @return  The glyph, or nullptr if nothing is to be drawn
+    */
+    const Glyph* getGlyph(uInt8 chr) const;
+
+    const Span* getSpans(const Glyph& glyph) const {
+      return mySpans.data() + glyph.firstSpan;
+    }
+
+  private:
+    void buildGlyphs() const;
+
   private:
     FontDesc myFontDesc;
 
+    // The glyphs of all characters in the font, and their spans
+    // (built when first drawn)
+    mutable vector<Glyph> myGlyphs;
+    mutable vector<Span> mySpans;
+
   private:
     // Following constructors and assignment operators not supported
     Font() = delete;
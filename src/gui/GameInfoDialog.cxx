@@ -67,7 +67,7 @@ GameInfoDialog::GameInfoDialog(
 
   // Set real dimensions
   setSize(53 * fontWidth + 8,
-          8 * (lineHeight + VGAP) + 1 * (infoLineHeight + VGAP) + VBORDER * 2 + _th +
+          9 * (lineHeight + VGAP) + 1 * (infoLineHeight + VGAP) + VBORDER * 2 + _th +
           buttonHeight + fontHeight + ifont.getLineHeight() + 20,
           max_w, max_h);
 
@@ -137,6 +137,10 @@ GameInfoDialog::GameInfoDialog(
   mySound = new CheckboxWidget(myTab, font, HBORDER, ypos + 1, "Stereo sound");
   wid.push_back(mySound);
 
+  ypos += lineHeight + VGAP;
+  myThumbFast = new CheckboxWidget(myTab, font, HBORDER, ypos + 1, "Fast ARM emulation");
+  wid.push_back(myThumbFast);
+
   // Add message concerning usage
   ypos = myTab->getHeight() - 5 - fontHeight - ifont.getFontHeight() - 10;
   new StaticTextWidget(myTab, ifont, HBORDER, ypos,
@@ -449,6 +453,8 @@ void GameInfoDialog::loadEmulationProperties(const Properties& props)
   mySound->setState(props.get(PropType::Cart_Sound) == "STEREO");
   // if stereo is always enabled, disable game specific stereo setting
   mySound->setEnabled(!instance().audioSettings().stereo());
+
+  myThumbFast->setState(props.get(PropType::Cart_ThumbFast) == "YES");
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -522,6 +528,7 @@ void GameInfoDialog::saveConfig()
   myGameProperties.set(PropType::Display_PPBlend, myPPBlend->getValueLabel() == "Off" ? "0" :
                        myPPBlend->getValueLabel());
   myGameProperties.set(PropType::Cart_Sound, mySound->getState() ? "STEREO" : "MONO");
+  myGameProperties.set(PropType::Cart_ThumbFast, myThumbFast->getState() ? "YES" : "NO");
 
   // Console properties
   myGameProperties.set(PropType::Console_TVType, myTVTypeGroup->getSelected() ? "BW" : "COLOR");
@@ -564,6 +571,7 @@ void GameInfoDialog::saveConfig()
     instance().console().setFormat(myFormat->getSelected());
     instance().frameBuffer().tiaSurface().enablePhosphor(myPhosphor->getState(), myPPBlend->getValue());
     instance().console().initializeAudio();
+    instance().console().cartridge().setThumbFastMode(myThumbFast->getState());
 
     // update 'Console' tab settings immediately
     instance().console().switches().setTvColor(myTVTypeGroup->getSelected() == 0);
@@ -70,6 +70,7 @@ class GameInfoDialog : public Dialog, public CommandSender
     CheckboxWidget*   myPhosphor;
     SliderWidget*     myPPBlend;
     CheckboxWidget*   mySound;
+    CheckboxWidget*   myThumbFast;
 
     // Console properties
     RadioButtonGroup* myLeftDiffGroup;
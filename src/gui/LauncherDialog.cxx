@@ -24,7 +24,7 @@
 #include "EditTextWidget.hxx"
 #include "FileListWidget.hxx"
 #include "FSNode.hxx"
-#include "MD5.hxx"
+#include "RomIndex.hxx"
 #include "OptionsDialog.hxx"
 #include "GlobalPropsDialog.hxx"
 #include "StellaSettingsDialog.hxx"
@@ -249,9 +249,10 @@ const string& LauncherDialog::selectedRomMD5()
     myMD5List.clear();
 
   // Lookup MD5, and if not present, cache it
+  // The ROM index only needs to read the file if it changed or is new
   auto iter = myMD5List.find(currentNode().getPath());
   if(iter == myMD5List.end())
-    myMD5List[currentNode().getPath()] = MD5::hash(currentNode());
+    myMD5List[currentNode().getPath()] = instance().romIndex().md5(currentNode());
 
   return myMD5List[currentNode().getPath()];
 }
@@ -266,7 +267,8 @@ const FilesystemNode& LauncherDialog::currentNode() const
 void LauncherDialog::reload()
 {
   myMD5List.clear();
-  myList->reload();
+  myIndexedDir = "";
+  myList->refresh();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -280,7 +282,7 @@ void LauncherDialog::loadConfig()
 
   // Assume that if the list is empty, this is the first time that loadConfig()
   // has been called (and we should reload the list)
-  if(myList->getList().empty())
+  if(myList->getListSize() == 0)
   {
     FilesystemNode node(romdir == "" ? "~" : romdir);
     if(!(node.exists() && node.isDirectory()))
@@ -307,9 +309,20 @@ void LauncherDialog::updateUI()
 
   // Indicate how many files were found
   ostringstream buf;
-  buf << (myList->getList().size() - 1) << " items found";
+  if(myList->isLoading())
+    buf << "Reading directory...";
+  else
+    buf << (myList->getListSize() - 1) << " items found";
   myRomCount->setLabel(buf.str());
 
+  // Index the files of a new directory in the background, so that the
+  // ROM info is available without delay when browsing through it
+  if(!myList->isLoading() && myList->currentDir().getPath() != myIndexedDir)
+  {
+    myIndexedDir = myList->currentDir().getPath();
+    instance().romIndex().queue(myList->fileList());
+  }
+
   // Update ROM info UI item
   loadRomInfo();
 }
@@ -322,13 +335,9 @@ void LauncherDialog::applyFiltering()
       if(!node.isDirectory())
       {
         // Do we want to show only ROMs or all files?
+        // The pattern in the 'pattern' textbox is matched by the list itself
         if(myShowOnlyROMs && !Bankswitch::isValidRomName(node))
           return false;
-
-        // Skip over files that don't match the pattern in the 'pattern' textbox
-        if(myPattern && myPattern->getText() != "" &&
-          !BSPF::containsIgnoreCase(node.getName(), myPattern->getText()))
-          return false;
       }
       return true;
     }
@@ -352,6 +361,29 @@ void LauncherDialog::loadRomInfo()
   }
   else
     myRomInfoWidget->clearProperties();
+
+  // Prepare the snapshots of the surrounding entries, nearest first, so
+  // that scrolling through the list doesn't wait for them to be decoded
+  // Only entries which are already indexed are considered, since hashing
+  // the others here would take longer than decoding their snapshots
+  const FSList& files = myList->fileList();
+  const int selected = myList->getSelected();
+  StringList names;
+  for(int offset: { 1, -1, 2, -2 })
+  {
+    const int i = selected + offset;
+    RomIndex::Entry entry;
+    if(i < 0 || i >= int(files.size()) || !files[i].isFile() ||
+       !instance().romIndex().find(files[i], entry) || entry.md5.empty())
+      continue;
+
+    Properties props;
+    if(instance().propSet().getMD5(entry.md5, props))
+      names.push_back(props.get(PropType::Cart_Name));
+    else
+      names.push_back(files[i].getNameWithExt(""));
+  }
+  myRomInfoWidget->prefetchSnapshots(names);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -486,7 +518,7 @@ void LauncherDialog::handleCommand(CommandSender* sender, int cmd,
   {
     case kAllfilesCmd:
       showOnlyROMs(myAllFiles ? !myAllFiles->getState() : true);
-      reload();
+      myList->reload();
       break;
 
     case kLoadROMCmd:
@@ -512,8 +544,8 @@ void LauncherDialog::handleCommand(CommandSender* sender, int cmd,
       break;
 
     case EditableWidget::kChangedCmd:
-      applyFiltering();  // pattern matching taken care of directly in this method
-      reload();
+      if(myPattern)
+        myList->setNamePattern(myPattern->getText());
       break;
 
     case kQuitCmd:
@@ -126,6 +126,9 @@ class LauncherDialog : public Dialog
     RomInfoWidget* myRomInfoWidget;
     std::unordered_map<string,string> myMD5List;
 
+    // The directory last queued for indexing
+    string myIndexedDir;
+
     int mySelectedItem;
 
     bool myShowOnlyROMs;
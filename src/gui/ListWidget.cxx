@@ -58,7 +58,7 @@ void ListWidget::setSelected(int item)
 {
   setDirty();
 
-  if(item < 0 || item >= int(_list.size()))
+  if(item < 0 || item >= getListSize())
     return;
 
   if(isEnabled())
@@ -78,23 +78,22 @@ void ListWidget::setSelected(int item)
 void ListWidget::setSelected(const string& item)
 {
   int selected = -1;
-  if(!_list.empty())
+  const int size = getListSize();
+  if(size > 0)
   {
     if(item == "")
       selected = 0;
     else
     {
-      uInt32 itemToSelect = 0;
-      for(const auto& iter: _list)
+      for(int i = 0; i < size; ++i)
       {
-        if(item == iter)
+        if(item == getListItem(i))
         {
-          selected = itemToSelect;
+          selected = i;
           break;
         }
-        ++itemToSelect;
       }
-      if(itemToSelect > _list.size() || selected == -1)
+      if(selected == -1)
         selected = 0;
     }
   }
@@ -104,7 +103,7 @@ void ListWidget::setSelected(const string& item)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ListWidget::setHighlighted(int item)
 {
-  if(item < -1 || item >= int(_list.size()))
+  if(item < -1 || item >= getListSize())
     return;
 
   if(isEnabled())
@@ -127,14 +126,14 @@ void ListWidget::setHighlighted(int item)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const string& ListWidget::getSelectedString() const
 {
-  return (_selectedItem >= 0 && _selectedItem < int(_list.size()))
-            ? _list[_selectedItem] : EmptyString;
+  return (_selectedItem >= 0 && _selectedItem < getListSize())
+            ? getListItem(_selectedItem) : EmptyString;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ListWidget::scrollTo(int item)
 {
-  int size = int(_list.size());
+  int size = getListSize();
   if (item >= size)
     item = size - 1;
   if (item < 0)
@@ -156,7 +155,7 @@ int ListWidget::getWidth() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ListWidget::recalc()
 {
-  int size = int(_list.size());
+  int size = getListSize();
 
   if(_currentPos >= size)
   {
@@ -173,7 +172,7 @@ void ListWidget::recalc()
 
   _editMode = false;
 
-  _scrollBar->_numEntries     = int(_list.size());
+  _scrollBar->_numEntries     = getListSize();
   _scrollBar->_entriesPerPage = _rows;
   // disable scrollbar if no longer necessary
   scrollBarRecalc();
@@ -201,7 +200,7 @@ void ListWidget::handleMouseDown(int x, int y, MouseButton b, int clickCount)
   // First check whether the selection changed
   int newSelectedItem;
   newSelectedItem = findItem(x, y);
-  if (newSelectedItem >= int(_list.size()))
+  if (newSelectedItem >= getListSize())
     return;
 
   if (_selectedItem != newSelectedItem)
@@ -311,7 +310,7 @@ bool ListWidget::handleEvent(Event::Type e)
 
   bool handled = true;
   int oldSelectedItem = _selectedItem;
-  int size = int(_list.size());
+  int size = getListSize();
 
   switch(e)
   {
@@ -418,10 +417,10 @@ void ListWidget::scrollToCurrent(int item)
     _currentPos = item - _rows + 1;
   }
 
-  if (_currentPos < 0 || _rows > int(_list.size()))
+  if (_currentPos < 0 || _rows > getListSize())
     _currentPos = 0;
-  else if (_currentPos + _rows > int(_list.size()))
-    _currentPos = int(_list.size()) - _rows;
+  else if (_currentPos + _rows > getListSize())
+    _currentPos = getListSize() - _rows;
 
   int oldScrollPos = _scrollBar->_currentPos;
   _scrollBar->_currentPos = _currentPos;
@@ -439,7 +438,7 @@ void ListWidget::startEditMode()
   if (isEditable() && !_editMode && _selectedItem >= 0)
   {
     _editMode = true;
-    setText(_list[_selectedItem]);
+    setText(getListItem(_selectedItem));
 
     // Widget gets raw data while editing
     EditableWidget::startEditMode();
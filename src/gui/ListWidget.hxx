@@ -58,8 +58,16 @@ class ListWidget : public EditableWidget
     const StringList& getList()	const { return _list; }
     const string& getSelectedString() const;
 
+    /**
+      The number of items, and the item at the given position. Items are
+      only fetched when needed (ie, for the visible rows), so subclasses may
+      provide them on demand from their own data instead of the string list.
+    */
+    virtual int getListSize() const { return int(_list.size()); }
+    virtual const string& getListItem(int item) const { return _list[item]; }
+
     void scrollTo(int item);
-    void scrollToEnd() { scrollToCurrent(int(_list.size())); }
+    void scrollToEnd() { scrollToCurrent(getListSize()); }
 
     // Account for the extra width of embedded scrollbar
     int getWidth() const override;
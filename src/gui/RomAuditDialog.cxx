@@ -26,7 +26,8 @@
 #include "Font.hxx"
 #include "MessageBox.hxx"
 #include "FrameBuffer.hxx"
-#include "MD5.hxx"
+#include "RomIndex.hxx"
+#include "RomHasher.hxx"
 #include "Props.hxx"
 #include "PropsSet.hxx"
 #include "Settings.hxx"
@@ -126,29 +127,46 @@ void RomAuditDialog::auditRoms()
                           "Auditing ROM files ...");
   progress.setRange(0, int(files.size()) - 1, 5);
 
+  // Only valid ROM files are hashed; the rest are skipped
+  vector<bool> valid(files.size());
+  vector<string> extensions(files.size());
+  for(uInt32 idx = 0; idx < files.size(); ++idx)
+    valid[idx] = files[idx].isFile() &&
+                 Bankswitch::isValidRomName(files[idx], extensions[idx]);
+
+  // The MD5s are calculated in the background; here we only commit the
+  // results in order
+  RomHasher hasher(files, valid, instance().romIndex());
+
   Properties props;
   int renamed = 0, notfound = 0;
-  for(uInt32 idx = 0; idx < files.size(); ++idx)
+  while(hasher.position() < files.size())
   {
-    string extension;
-    if(files[idx].isFile() &&
-       Bankswitch::isValidRomName(files[idx], extension))
+    const uInt32 idx = hasher.position();
+    string md5;
+    if(!hasher.next(md5, 50))
+      continue;
+
+    if(valid[idx])
     {
       bool renameSucceeded = false;
 
-      // Calculate the MD5 so we can get the rest of the info
-      // from the PropertiesSet (stella.pro)
-      const string& md5 = MD5::hash(files[idx]);
-      if(instance().propSet().getMD5(md5, props))
+      // Use the MD5 to get the rest of the info from the PropertiesSet
+      // (stella.pro)
+      if(md5 != "" && instance().propSet().getMD5(md5, props))
       {
         const string& name = props.get(PropType::Cart_Name);
 
         // Only rename the file if we found a valid properties entry
         if(name != "" && name != files[idx].getName())
         {
-          const string& newfile = node.getPath() + name + "." + extension;
-          if(files[idx].getPath() != newfile && files[idx].rename(newfile))
+          const string& newfile = node.getPath() + name + "." + extensions[idx];
+          const string oldfile = files[idx].getPath();
+          if(oldfile != newfile && files[idx].rename(newfile))
+          {
+            instance().romIndex().renamed(oldfile, files[idx].getPath());
             renameSucceeded = true;
+          }
         }
       }
       if(renameSucceeded)
@@ -158,9 +176,10 @@ void RomAuditDialog::auditRoms()
     }
 
     // Update the progress bar, indicating one more ROM has been processed
-    progress.setProgress(idx);
+    progress.setProgress(int(idx));
   }
   progress.close();
+  instance().romIndex().save();
 
   myResults1->setText(Variant(renamed).toString());
   myResults2->setText(Variant(notfound).toString());
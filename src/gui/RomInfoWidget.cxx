@@ -24,6 +24,7 @@
 #include "ControllerDetector.hxx"
 #include "Props.hxx"
 #include "PNGLibrary.hxx"
+#include "SnapshotCache.hxx"
 #include "Rect.hxx"
 #include "Widget.hxx"
 #include "TIAConstants.hxx"
@@ -42,6 +43,15 @@ RomInfoWidget::RomInfoWidget(GuiObject* boss, const GUI::Font& font,
   _flags = Widget::FLAG_ENABLED;
   _bgcolor = kDlgColor;
   _bgcolorlo = kBGColorLo;
+
+#ifdef PNG_SUPPORT
+  mySnapshots = make_unique<SnapshotCache>(_SNAPSHOT_CACHE_SIZE);
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RomInfoWidget::~RomInfoWidget()
+{
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -50,10 +60,25 @@ void RomInfoWidget::reloadProperties(const FilesystemNode& node)
   // The ROM may have changed since we were last in the browser, either
   // by saving a different image or through a change in video renderer,
   // so we reload the properties
+#ifdef PNG_SUPPORT
+  mySnapshots->clear();
+#endif
   if(myHaveProperties)
     parseProperties(node);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RomInfoWidget::prefetchSnapshots(const StringList& names)
+{
+#ifdef PNG_SUPPORT
+  StringList filenames;
+  for(const auto& name: names)
+    filenames.push_back(instance().snapshotLoadDir() + name + ".png");
+
+  mySnapshots->prefetch(filenames);
+#endif
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void RomInfoWidget::setProperties(const Properties& props, const FilesystemNode& node)
 {
@@ -106,7 +131,7 @@ void RomInfoWidget::parseProperties(const FilesystemNode& node)
   // Read the PNG file
   try
   {
-    instance().png().loadImage(filename, *mySurface);
+    instance().png().loadImage(*mySnapshots->get(filename), *mySurface);
 
     // Scale surface to available image area
     const Common::Rect& src = mySurface->srcRect();
@@ -20,6 +20,7 @@
 
 class FBSurface;
 class Properties;
+class SnapshotCache;
 namespace GUI {
   struct Size;
 }
@@ -32,12 +33,18 @@ class RomInfoWidget : public Widget
   public:
     RomInfoWidget(GuiObject *boss, const GUI::Font& font,
                   int x, int y, int w, int h);
-    virtual ~RomInfoWidget() = default;
+    virtual ~RomInfoWidget();
 
     void setProperties(const Properties& props, const FilesystemNode& node);
     void clearProperties();
     void reloadProperties(const FilesystemNode& node);
 
+    /**
+      Decode the snapshots for the given cart names in the background, so
+      that they can be shown without delay when selected.
+    */
+    void prefetchSnapshots(const StringList& names);
+
   protected:
     void drawWidget(bool hilite) override;
 
@@ -51,6 +58,11 @@ class RomInfoWidget : public Widget
     // Whether the surface should be redrawn by drawWidget()
     bool mySurfaceIsValid;
 
+  #ifdef PNG_SUPPORT
+    // The most recently used snapshots, already decoded
+    unique_ptr<SnapshotCache> mySnapshots;
+  #endif
+
     // Some ROM properties info, as well as 'tEXt' chunks from the PNG image
     StringList myRomInfo;
 
@@ -66,6 +78,9 @@ class RomInfoWidget : public Widget
     // How much space available for the PNG image
     Common::Size myAvail;
 
+    // The number of decoded snapshots to keep
+    static constexpr size_t _SNAPSHOT_CACHE_SIZE = 16;
+
   private:
     // Following constructors and assignment operators not supported
     RomInfoWidget() = delete;
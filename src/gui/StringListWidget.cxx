@@ -58,7 +58,7 @@ void StringListWidget::drawWidget(bool hilite)
 {
   FBSurface& s = _boss->dialog().surface();
   bool onTop = _boss->dialog().isOnTop();
-  int i, pos, len = int(_list.size());
+  int i, pos, len = getListSize();
 
   // Draw a thin frame around the list.
   s.frameRect(_x, _y, _w + 1, _h, onTop && hilite && _hilite ? kWidColorHi : kColor);
@@ -90,7 +90,7 @@ void StringListWidget::drawWidget(bool hilite)
                    TextAlign::Left, -_editScrollOffset, false);
     }
     else
-      s.drawString(_font, _list[pos], _x + r.x(), y, r.w(), textColor);
+      s.drawString(_font, getListItem(pos), _x + r.x(), y, r.w(), textColor);
   }
 
   // Only draw the caret while editing, and if it's in the current viewport
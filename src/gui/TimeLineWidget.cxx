@@ -123,8 +123,10 @@ void TimeLineWidget::handleMouseDown(int x, int y, MouseButton b, int clickCount
 void TimeLineWidget::handleMouseUp(int x, int y, MouseButton b, int clickCount)
 {
   if(isEnabled() && _isDragging)
+  {
+    _isDragging = false;
     sendCommand(_cmd, _value, _id);
-
+  }
   _isDragging = false;
 }
 
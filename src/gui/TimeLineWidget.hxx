@@ -35,6 +35,12 @@ class TimeLineWidget : public ButtonWidget
     uInt32 getMinValue() const { return _valueMin; }
     uInt32 getMaxValue() const { return _valueMax; }
 
+    /**
+      Answer whether the handle is being dragged; the command is sent for
+      each move, and once more (no longer dragging) when it is released.
+    */
+    bool isDragging() const { return _isDragging; }
+
     /**
       Steps are not necessarily linear in a timeline, so we need info
       on each interval instead.
@@ -196,7 +196,8 @@ static uInt32 LOAD_ALL[BUTTON_H] =
 TimeMachineDialog::TimeMachineDialog(OSystem& osystem, DialogContainer& parent,
                                      int width)
   : Dialog(osystem, parent),
-    _enterWinds(0)
+    _enterWinds(0),
+    myPreviewShown(false)
 {
   const GUI::Font& font = instance().frameBuffer().font();
   const int H_BORDER = 6, BUTTON_GAP = 4, V_BORDER = 4;
@@ -346,8 +347,18 @@ void TimeMachineDialog::handleCommand(CommandSender* sender, int cmd,
   {
     case kTimeline:
     {
+      // Loading states is too slow to follow the mouse, so only the frames
+      // are shown while dragging; the state is loaded on release
+      if(myTimeline->isDragging())
+      {
+        handlePreview(myTimeline->getValue());
+        break;
+      }
       Int32 winds = myTimeline->getValue() -
           instance().state().rewindManager().getCurrentIdx() + 1;
+      if(winds == 0 && myPreviewShown)
+        handlePreview(myTimeline->getValue());
+      myPreviewShown = false;
       handleWinds(winds);
       break;
     }
@@ -476,6 +487,24 @@ void TimeMachineDialog::handleWinds(Int32 numWinds)
   mySaveAllWidget->setEnabled(r.getLastIdx() != 0);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TimeMachineDialog::handlePreview(uInt32 index)
+{
+  RewindManager& r = instance().state().rewindManager();
+  const uInt8* frame = r.previewFrame(index);
+  if(!frame)
+    return;
+
+  instance().console().tia().showFrame(frame);
+  myPreviewShown = true;
+
+  const IntArray cycles = r.cyclesList();
+  if(index < cycles.size())
+    myCurrentTimeWidget->setLabel(getTimeString(cycles[index]));
+  myCurrentIdxWidget->setValue(index + 1);
+  myMessageWidget->setLabel("");
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TimeMachineDialog::handleToggle()
 {
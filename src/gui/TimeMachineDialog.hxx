@@ -50,6 +50,8 @@ class TimeMachineDialog : public Dialog
     string getTimeString(uInt64 cycles);
     /** re/unwind and update display */
     void handleWinds(Int32 numWinds = 0);
+    /** show the frame of a state while dragging, without loading it */
+    void handlePreview(uInt32 index);
     /** toggle Time Machine mode */
     void handleToggle();
 
@@ -88,6 +90,7 @@ class TimeMachineDialog : public Dialog
     StaticTextWidget* myMessageWidget;
 
     Int32 _enterWinds;
+    bool myPreviewShown;
 
   private:
     // Following constructors and assignment operators not supported
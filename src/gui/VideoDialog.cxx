@@ -458,7 +458,7 @@ void VideoDialog::saveConfig()
   // Multi-threaded rendering
   instance().settings().setValue("threads", myUseThreads->getState());
   if(instance().hasConsole())
-    instance().frameBuffer().tiaSurface().ntsc().enableThreading(myUseThreads->getState());
+    instance().frameBuffer().tiaSurface().enableThreading(myUseThreads->getState());
 
   // TV Mode
   instance().settings().setValue("tv.filter",
@@ -36,6 +36,7 @@ Widget::Widget(GuiObject* boss, const GUI::Font& font,
     _id(0),
     _flags(0),
     _hasFocus(false),
+    _dirty(true),
     _bgcolor(kWidColor),
     _bgcolorhi(kWidColor),
     _bgcolorlo(kBGColorLo),
@@ -66,14 +67,23 @@ Widget::~Widget()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Widget::setDirty()
 {
-  // A widget being dirty indicates that its parent dialog is dirty
-  // So we inform the parent about it
-  _boss->dialog().setDirty();
+  // A widget which clears its own background can be redrawn on its own,
+  // so the dialog only needs to redraw this widget
+  // Otherwise whatever is behind it (ie, the boss) must be redrawn too
+  if((_flags & Widget::FLAG_CLEARBG) && isVisible())
+  {
+    _dirty = true;
+    _boss->dialog().setWidgetDirty();
+  }
+  else
+    _boss->setDirty();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Widget::draw()
 {
+  _dirty = false;
+
   if(!isVisible() || !_boss->isVisible())
     return;
 
@@ -302,7 +312,17 @@ void Widget::setDirtyInChain(Widget* start)
 {
   while(start)
   {
-    start->setDirty();
+    start->_dirty = true;
+    start = start->_next;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Widget::tickInChain(Widget* start)
+{
+  while(start)
+  {
+    start->tick();
     start = start->_next;
   }
 }
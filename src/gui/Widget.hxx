@@ -83,6 +83,10 @@ class Widget : public GuiObject
     virtual bool handleJoyHat(int stick, int hat, JoyHatDir hdir, int button = JOY_CTRL_NONE) { return false; }
     virtual bool handleEvent(Event::Type event) { return false; }
 
+    /** Called once per frame while the dialog containing it is active,
+        allowing widgets to pick up results of background work */
+    virtual void tick() { }
+
     void setDirty() override;
     void draw() override;
     void receivedFocus();
@@ -139,6 +143,7 @@ class Widget : public GuiObject
     uInt32     _id;
     uInt32     _flags;
     bool       _hasFocus;
+    bool       _dirty;
     int        _fontWidth;
     int        _fontHeight;
     ColorId    _bgcolor;
@@ -164,9 +169,13 @@ class Widget : public GuiObject
                                     Widget* w, int direction,
                                     bool emitFocusEvents = true);
 
-    /** Sets all widgets in this chain to be dirty (must be redrawn) */
+    /** Sets all widgets in this chain to be dirty (must be redrawn); this is
+        meant to be used while drawing, and doesn't notify the dialog */
     static void setDirtyInChain(Widget* start);
 
+    /** Calls tick() on all widgets in this chain */
+    static void tickInChain(Widget* start);
+
   private:
     // Following constructors and assignment operators not supported
     Widget() = delete;
@@ -0,0 +1,519 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <algorithm>
+#include <type_traits>
+
+#include "GLRendererLIBRETRO.hxx"
+#include "AtariNTSC.hxx"
+#include "TIAConstants.hxx"
+#include "Logger.hxx"
+
+namespace {
+  // The GL types, constants and functions used below; they are declared
+  // here, since the headers differ between GL and GLES (and platforms)
+  using GLenum = unsigned int;
+  using GLuint = unsigned int;
+  using GLint = int;
+  using GLsizei = int;
+  using GLfloat = float;
+  using GLbitfield = unsigned int;
+  using GLchar = char;
+
+  constexpr GLenum GL_TRIANGLES = 0x0004;
+  constexpr GLenum GL_CULL_FACE = 0x0B44;
+  constexpr GLenum GL_DEPTH_TEST = 0x0B71;
+  constexpr GLenum GL_STENCIL_TEST = 0x0B90;
+  constexpr GLenum GL_BLEND = 0x0BE2;
+  constexpr GLenum GL_SCISSOR_TEST = 0x0C11;
+  constexpr GLenum GL_UNPACK_ALIGNMENT = 0x0CF5;
+  constexpr GLenum GL_TEXTURE_2D = 0x0DE1;
+  constexpr GLenum GL_UNSIGNED_BYTE = 0x1401;
+  constexpr GLenum GL_UNSIGNED_INT = 0x1405;
+  constexpr GLenum GL_RGBA = 0x1908;
+  constexpr GLenum GL_NEAREST = 0x2600;
+  constexpr GLenum GL_TEXTURE_MAG_FILTER = 0x2800;
+  constexpr GLenum GL_TEXTURE_MIN_FILTER = 0x2801;
+  constexpr GLenum GL_TEXTURE_WRAP_S = 0x2802;
+  constexpr GLenum GL_TEXTURE_WRAP_T = 0x2803;
+  constexpr GLenum GL_COLOR_BUFFER_BIT = 0x4000;
+  constexpr GLenum GL_RGBA8 = 0x8058;
+  constexpr GLenum GL_CLAMP_TO_EDGE = 0x812F;
+  constexpr GLenum GL_R8UI = 0x8232;
+  constexpr GLenum GL_R32UI = 0x8236;
+  constexpr GLenum GL_TEXTURE0 = 0x84C0;
+  constexpr GLenum GL_FRAGMENT_SHADER = 0x8B30;
+  constexpr GLenum GL_VERTEX_SHADER = 0x8B31;
+  constexpr GLenum GL_COMPILE_STATUS = 0x8B81;
+  constexpr GLenum GL_LINK_STATUS = 0x8B82;
+  constexpr GLenum GL_READ_FRAMEBUFFER = 0x8CA8;
+  constexpr GLenum GL_DRAW_FRAMEBUFFER = 0x8CA9;
+  constexpr GLenum GL_COLOR_ATTACHMENT0 = 0x8CE0;
+  constexpr GLenum GL_FRAMEBUFFER = 0x8D40;
+  constexpr GLenum GL_RED_INTEGER = 0x8D94;
+
+#ifdef _WIN32
+  #define GL_CALL __stdcall
+#else
+  #define GL_CALL
+#endif
+
+  void (GL_CALL *glActiveTexture)(GLenum);
+  void (GL_CALL *glAttachShader)(GLuint, GLuint);
+  void (GL_CALL *glBindFramebuffer)(GLenum, GLuint);
+  void (GL_CALL *glBindTexture)(GLenum, GLuint);
+  void (GL_CALL *glBindVertexArray)(GLuint);
+  void (GL_CALL *glBlitFramebuffer)(GLint, GLint, GLint, GLint, GLint, GLint,
+                                    GLint, GLint, GLbitfield, GLenum);
+  void (GL_CALL *glClear)(GLbitfield);
+  void (GL_CALL *glClearColor)(GLfloat, GLfloat, GLfloat, GLfloat);
+  void (GL_CALL *glCompileShader)(GLuint);
+  GLuint (GL_CALL *glCreateProgram)();
+  GLuint (GL_CALL *glCreateShader)(GLenum);
+  void (GL_CALL *glDeleteFramebuffers)(GLsizei, const GLuint*);
+  void (GL_CALL *glDeleteProgram)(GLuint);
+  void (GL_CALL *glDeleteShader)(GLuint);
+  void (GL_CALL *glDeleteTextures)(GLsizei, const GLuint*);
+  void (GL_CALL *glDeleteVertexArrays)(GLsizei, const GLuint*);
+  void (GL_CALL *glDisable)(GLenum);
+  void (GL_CALL *glDrawArrays)(GLenum, GLint, GLsizei);
+  void (GL_CALL *glFramebufferTexture2D)(GLenum, GLenum, GLenum, GLuint, GLint);
+  void (GL_CALL *glGenFramebuffers)(GLsizei, GLuint*);
+  void (GL_CALL *glGenTextures)(GLsizei, GLuint*);
+  void (GL_CALL *glGenVertexArrays)(GLsizei, GLuint*);
+  void (GL_CALL *glGetProgramInfoLog)(GLuint, GLsizei, GLsizei*, GLchar*);
+  void (GL_CALL *glGetProgramiv)(GLuint, GLenum, GLint*);
+  void (GL_CALL *glGetShaderInfoLog)(GLuint, GLsizei, GLsizei*, GLchar*);
+  void (GL_CALL *glGetShaderiv)(GLuint, GLenum, GLint*);
+  GLint (GL_CALL *glGetUniformLocation)(GLuint, const GLchar*);
+  void (GL_CALL *glLinkProgram)(GLuint);
+  void (GL_CALL *glPixelStorei)(GLenum, GLint);
+  void (GL_CALL *glShaderSource)(GLuint, GLsizei, const GLchar* const*, const GLint*);
+  void (GL_CALL *glTexImage2D)(GLenum, GLint, GLint, GLsizei, GLsizei, GLint,
+                               GLenum, GLenum, const void*);
+  void (GL_CALL *glTexParameteri)(GLenum, GLenum, GLint);
+  void (GL_CALL *glTexSubImage2D)(GLenum, GLint, GLint, GLint, GLsizei, GLsizei,
+                                  GLenum, GLenum, const void*);
+  void (GL_CALL *glUniform1f)(GLint, GLfloat);
+  void (GL_CALL *glUniform1i)(GLint, GLint);
+  void (GL_CALL *glUseProgram)(GLuint);
+  void (GL_CALL *glViewport)(GLint, GLint, GLsizei, GLsizei);
+
+  // One triangle covering the whole viewport
+  const char* const vertexShader = R"(
+    void main()
+    {
+      gl_Position = vec4(gl_VertexID == 1 ? 3.0 : -1.0,
+                         gl_VertexID == 2 ? 3.0 : -1.0, 0.0, 1.0);
+    }
+  )";
+
+  // Integer arithmetic throughout, so that the result is the same as
+  // that of TIASurface and AtariNTSC
+  const char* const fragmentShader = R"(
+    uniform highp usampler2D frame;     // TIA frame (palette indices)
+    uniform highp usampler2D colors;    // palette, or the NTSC kernels
+    uniform sampler2D previous;         // the last output (for phosphor)
+
+    uniform bool ntsc;
+    uniform int width;                  // width of the TIA frame
+    uniform bool phosphor;
+    uniform float percent;
+
+    out vec4 color;
+
+    // Pixels left and right of the frame are black (palette index 0)
+    uint pixel(int x, int y)
+    {
+      return x >= 0 && x < width ? texelFetch(frame, ivec2(x, y), 0).r : 0u;
+    }
+
+    uint kernel(uint c, int i)
+    {
+      return texelFetch(colors, ivec2(i, int(c)), 0).r;
+    }
+
+    // See AtariNTSC::renderThread(): every chunk of seven output pixels
+    // is generated from two input pixels (and the two before them), and
+    // the output is shifted right by two pixels
+    uvec3 ntscPixel(int x, int y)
+    {
+      int t = x - 2;
+      if(t < 0 || t >= ((width - 1) / 2 + 2) * 7 - 2)
+        return uvec3(0u);
+
+      int p = t / 7 * 2, i = t % 7;
+      uint kernel0 = pixel(p + 1, y), kernelx0 = pixel(p - 1, y);
+      uint kernel1 = i < 4 ? pixel(p, y) : pixel(p + 2, y);
+      uint kernelx1 = i < 4 ? pixel(p - 2, y) : pixel(p, y);
+
+      // ATARI_NTSC_RGB_OUT_8888 and ATARI_NTSC_CLAMP_
+      uint raw = kernel(kernel0, i) + kernel(kernel1, (i + 10) % 7 + 14) +
+                 kernel(kernelx0, (i + 7) % 14) + kernel(kernelx1, (i + 3) % 7 + 21);
+      uint sub = raw >> 9 & 0x300C03u;
+      uint clamp = 0x20280A02u - sub;
+      raw |= clamp;
+      clamp -= sub;
+      raw &= clamp;
+
+      return uvec3(raw >> 21, raw >> 11, raw >> 1) & 0xFFu;
+    }
+
+    void main()
+    {
+      ivec2 pos = ivec2(gl_FragCoord.xy);
+      uvec3 rgb;
+
+      if(ntsc)
+        rgb = ntscPixel(pos.x, pos.y);
+      else
+      {
+        uint c = kernel(0u, int(pixel(pos.x, pos.y)));
+        rgb = uvec3(c >> 16, c >> 8, c) & 0xFFu;
+      }
+
+      // See TIASurface::getPhosphor()
+      if(phosphor)
+      {
+        vec3 last = floor(texelFetch(previous, pos, 0).rgb * 255.0 + 0.5);
+        rgb = max(rgb, uvec3(last * percent));
+      }
+
+      color = vec4(vec3(rgb) / 255.0, 1.0);
+    }
+  )";
+
+  // The size of the output textures; NTSC filtering widens the frame
+  constexpr uInt32 outputWidth = AtariNTSC::outWidth(TIAConstants::frameBufferWidth);
+  constexpr uInt32 outputHeight = TIAConstants::frameBufferHeight;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+GLRendererLIBRETRO::GLRendererLIBRETRO()
+  : myGLES(false),
+    myFrameTexture(0),
+    myColorTexture(0),
+    myCurrentOutput(0),
+    myVertexArray(0),
+    myProgram(0),
+    myNTSCUniform(-1),
+    myWidthUniform(-1),
+    myPhosphorUniform(-1),
+    myPercentUniform(-1),
+    myLastNTSC(false),
+    myLastPhosphor(false),
+    myLastPercent(0),
+    myLastHeight(0)
+{
+  memset(&myHWRender, 0, sizeof(myHWRender));
+  myOutputTexture[0] = myOutputTexture[1] = 0;
+  myOutputFramebuffer[0] = myOutputFramebuffer[1] = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool GLRendererLIBRETRO::initialize(retro_environment_t environment,
+                                    retro_hw_context_reset_t reset,
+                                    retro_hw_context_reset_t destroy)
+{
+  memset(&myHWRender, 0, sizeof(myHWRender));
+  myHWRender.context_reset = reset;
+  myHWRender.context_destroy = destroy;
+  myHWRender.depth = false;
+  myHWRender.stencil = false;
+  myHWRender.bottom_left_origin = false;
+
+  // Desktop GL first, then GLES (as on most ARM boards)
+  myHWRender.context_type = RETRO_HW_CONTEXT_OPENGL_CORE;
+  myHWRender.version_major = 3;
+  myHWRender.version_minor = 3;
+  myGLES = false;
+  if(environment(RETRO_ENVIRONMENT_SET_HW_RENDER, &myHWRender))
+    return true;
+
+  myHWRender.context_type = RETRO_HW_CONTEXT_OPENGLES3;
+  myHWRender.version_major = 3;
+  myHWRender.version_minor = 0;
+  myGLES = true;
+  return environment(RETRO_ENVIRONMENT_SET_HW_RENDER, &myHWRender);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool GLRendererLIBRETRO::loadFunctions()
+{
+  bool ok = true;
+  const auto load = [&](auto& function, const char* name) {
+    function = reinterpret_cast<typename std::remove_reference<decltype(function)>::type>(
+        myHWRender.get_proc_address(name));
+    if(function == nullptr)
+    {
+      Logger::error(string("GL function ") + name + " not available");
+      ok = false;
+    }
+  };
+
+  load(glActiveTexture, "glActiveTexture");
+  load(glAttachShader, "glAttachShader");
+  load(glBindFramebuffer, "glBindFramebuffer");
+  load(glBindTexture, "glBindTexture");
+  load(glBindVertexArray, "glBindVertexArray");
+  load(glBlitFramebuffer, "glBlitFramebuffer");
+  load(glClear, "glClear");
+  load(glClearColor, "glClearColor");
+  load(glCompileShader, "glCompileShader");
+  load(glCreateProgram, "glCreateProgram");
+  load(glCreateShader, "glCreateShader");
+  load(glDeleteFramebuffers, "glDeleteFramebuffers");
+  load(glDeleteProgram, "glDeleteProgram");
+  load(glDeleteShader, "glDeleteShader");
+  load(glDeleteTextures, "glDeleteTextures");
+  load(glDeleteVertexArrays, "glDeleteVertexArrays");
+  load(glDisable, "glDisable");
+  load(glDrawArrays, "glDrawArrays");
+  load(glFramebufferTexture2D, "glFramebufferTexture2D");
+  load(glGenFramebuffers, "glGenFramebuffers");
+  load(glGenTextures, "glGenTextures");
+  load(glGenVertexArrays, "glGenVertexArrays");
+  load(glGetProgramInfoLog, "glGetProgramInfoLog");
+  load(glGetProgramiv, "glGetProgramiv");
+  load(glGetShaderInfoLog, "glGetShaderInfoLog");
+  load(glGetShaderiv, "glGetShaderiv");
+  load(glGetUniformLocation, "glGetUniformLocation");
+  load(glLinkProgram, "glLinkProgram");
+  load(glPixelStorei, "glPixelStorei");
+  load(glShaderSource, "glShaderSource");
+  load(glTexImage2D, "glTexImage2D");
+  load(glTexParameteri, "glTexParameteri");
+  load(glTexSubImage2D, "glTexSubImage2D");
+  load(glUniform1f, "glUniform1f");
+  load(glUniform1i, "glUniform1i");
+  load(glUseProgram, "glUseProgram");
+  load(glViewport, "glViewport");
+
+  return ok;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 GLRendererLIBRETRO::compileShader(uInt32 type, const char* source)
+{
+  const char* const header = myGLES
+    ? "#version 300 es\nprecision highp float;\nprecision highp int;\n"
+    : "#version 330 core\n";
+  const GLchar* const sources[] = { header, source };
+
+  GLuint shader = glCreateShader(type);
+  glShaderSource(shader, 2, sources, nullptr);
+  glCompileShader(shader);
+
+  GLint status = 0;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+  if(!status)
+  {
+    GLchar log[1024] = { 0 };
+    glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+    Logger::error(string("GL shader compilation failed: ") + log);
+
+    glDeleteShader(shader);
+    return 0;
+  }
+
+  return shader;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool GLRendererLIBRETRO::createProgram()
+{
+  GLuint vertex = compileShader(GL_VERTEX_SHADER, vertexShader);
+  GLuint fragment = compileShader(GL_FRAGMENT_SHADER, fragmentShader);
+
+  if(vertex && fragment)
+  {
+    myProgram = glCreateProgram();
+    glAttachShader(myProgram, vertex);
+    glAttachShader(myProgram, fragment);
+    glLinkProgram(myProgram);
+
+    GLint status = 0;
+    glGetProgramiv(myProgram, GL_LINK_STATUS, &status);
+    if(!status)
+    {
+      GLchar log[1024] = { 0 };
+      glGetProgramInfoLog(myProgram, sizeof(log), nullptr, log);
+      Logger::error(string("GL shader linking failed: ") + log);
+
+      glDeleteProgram(myProgram);
+      myProgram = 0;
+    }
+  }
+  if(vertex)    glDeleteShader(vertex);
+  if(fragment)  glDeleteShader(fragment);
+
+  if(myProgram == 0)
+    return false;
+
+  glUseProgram(myProgram);
+  glUniform1i(glGetUniformLocation(myProgram, "frame"), 0);
+  glUniform1i(glGetUniformLocation(myProgram, "colors"), 1);
+  glUniform1i(glGetUniformLocation(myProgram, "previous"), 2);
+  myNTSCUniform = glGetUniformLocation(myProgram, "ntsc");
+  myWidthUniform = glGetUniformLocation(myProgram, "width");
+  myPhosphorUniform = glGetUniformLocation(myProgram, "phosphor");
+  myPercentUniform = glGetUniformLocation(myProgram, "percent");
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void GLRendererLIBRETRO::contextReset()
+{
+  // Any objects of a previous context are gone already
+  myProgram = 0;
+  myColors.clear();
+
+  if(!loadFunctions() || !createProgram())
+    return;
+
+  const auto createTexture = [](GLuint& texture, GLenum format, uInt32 width,
+                                uInt32 height, GLenum dataFormat, GLenum type) {
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, dataFormat, type, nullptr);
+  };
+
+  createTexture(myFrameTexture, GL_R8UI, TIAConstants::frameBufferWidth,
+                TIAConstants::frameBufferHeight, GL_RED_INTEGER, GL_UNSIGNED_BYTE);
+
+  // The colors are uploaded with the first frame
+  glGenTextures(1, &myColorTexture);
+  glBindTexture(GL_TEXTURE_2D, myColorTexture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  glGenFramebuffers(2, myOutputFramebuffer);
+  for(uInt32 i = 0; i < 2; ++i)
+  {
+    createTexture(myOutputTexture[i], GL_RGBA8, outputWidth, outputHeight,
+                  GL_RGBA, GL_UNSIGNED_BYTE);
+    glBindFramebuffer(GL_FRAMEBUFFER, myOutputFramebuffer[i]);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                           myOutputTexture[i], 0);
+    glClearColor(0, 0, 0, 1);
+    glClear(GL_COLOR_BUFFER_BIT);
+  }
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+  glGenVertexArrays(1, &myVertexArray);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void GLRendererLIBRETRO::contextDestroy()
+{
+  if(!ready())
+    return;
+
+  glDeleteVertexArrays(1, &myVertexArray);
+  glDeleteFramebuffers(2, myOutputFramebuffer);
+  glDeleteTextures(2, myOutputTexture);
+  glDeleteTextures(1, &myColorTexture);
+  glDeleteTextures(1, &myFrameTexture);
+  glDeleteProgram(myProgram);
+
+  myProgram = 0;
+  myColors.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void GLRendererLIBRETRO::updateColors(const uInt32* colors, uInt32 width,
+                                      uInt32 height)
+{
+  const uInt32 size = width * height;
+
+  if(myColors.size() == size && std::equal(colors, colors + size, myColors.begin()))
+    return;
+
+  myColors.assign(colors, colors + size);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, width, height, 0,
+               GL_RED_INTEGER, GL_UNSIGNED_INT, colors);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void GLRendererLIBRETRO::render(const uInt8* frame, uInt32 width, uInt32 height,
+                                const uInt32* palette, const uInt32* ntsc,
+                                bool phosphor, float percent, uInt32 left)
+{
+  const uInt32 outWidth = ntsc ? AtariNTSC::outWidth(width) : width;
+
+  // The previous frame only counts when it was rendered the same way
+  // (the CPU implementation also starts anew then)
+  if((ntsc != nullptr) != myLastNTSC || phosphor != myLastPhosphor ||
+     percent != myLastPercent || height != myLastHeight)
+  {
+    glBindFramebuffer(GL_FRAMEBUFFER, myOutputFramebuffer[myCurrentOutput]);
+    glClearColor(0, 0, 0, 1);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    myLastNTSC = ntsc != nullptr;
+    myLastPhosphor = phosphor;
+    myLastPercent = percent;
+    myLastHeight = height;
+  }
+
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, myFrameTexture);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RED_INTEGER,
+                  GL_UNSIGNED_BYTE, frame);
+
+  glActiveTexture(GL_TEXTURE0 + 1);
+  glBindTexture(GL_TEXTURE_2D, myColorTexture);
+  if(ntsc)
+    updateColors(ntsc, AtariNTSC::entry_size, AtariNTSC::palette_size);
+  else
+    updateColors(palette, AtariNTSC::palette_size, 1);
+
+  glActiveTexture(GL_TEXTURE0 + 2);
+  glBindTexture(GL_TEXTURE_2D, myOutputTexture[myCurrentOutput]);
+
+  // Render into the other output texture, and copy that to the frontend
+  myCurrentOutput ^= 1;
+  glBindFramebuffer(GL_FRAMEBUFFER, myOutputFramebuffer[myCurrentOutput]);
+  glViewport(0, 0, outWidth, height);
+  glDisable(GL_BLEND);
+  glDisable(GL_CULL_FACE);
+  glDisable(GL_DEPTH_TEST);
+  glDisable(GL_SCISSOR_TEST);
+  glDisable(GL_STENCIL_TEST);
+
+  glUseProgram(myProgram);
+  glUniform1i(myNTSCUniform, ntsc != nullptr);
+  glUniform1i(myWidthUniform, width);
+  glUniform1i(myPhosphorUniform, phosphor);
+  glUniform1f(myPercentUniform, percent);
+
+  glBindVertexArray(myVertexArray);
+  glDrawArrays(GL_TRIANGLES, 0, 3);
+  glBindVertexArray(0);
+
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, myOutputFramebuffer[myCurrentOutput]);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, GLuint(myHWRender.get_current_framebuffer()));
+  glBlitFramebuffer(left, 0, outWidth, height, 0, 0, outWidth - left, height,
+                    GL_COLOR_BUFFER_BIT, GL_NEAREST);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
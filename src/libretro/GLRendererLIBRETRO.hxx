@@ -0,0 +1,126 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2019 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef GL_RENDERER_LIBRETRO_HXX
+#define GL_RENDERER_LIBRETRO_HXX
+
+#include "bspf.hxx"
+#include "libretro.h"
+
+/**
+  Converts the TIA frame with OpenGL (3.3 core or ES 3.0) shaders, using a
+  hardware context provided by the frontend.  The palette lookup, the NTSC
+  filter and phosphor blending all happen on the GPU, giving the same
+  result as TIASurface and AtariNTSC do on the CPU.
+
+  The GL functions are fetched from the frontend, so the core doesn't link
+  against any GL library.
+*/
+class GLRendererLIBRETRO
+{
+  public:
+    GLRendererLIBRETRO();
+    ~GLRendererLIBRETRO() = default;
+
+  public:
+    /**
+      Ask the frontend for a hardware context; must be called from
+      retro_load_game().  The callbacks must forward to contextReset()
+      and contextDestroy().
+
+      @return  False if the frontend provides no suitable context
+    */
+    bool initialize(retro_environment_t environment,
+                    retro_hw_context_reset_t reset,
+                    retro_hw_context_reset_t destroy);
+
+    /**
+      Create/delete the GL objects, whenever the frontend (re)creates or
+      destroys its context.
+    */
+    void contextReset();
+    void contextDestroy();
+
+    /**
+      Is a context available, and are the shaders ready to use?
+    */
+    bool ready() const { return myProgram != 0; }
+
+    /**
+      Convert a frame into the frontend's framebuffer, with the origin at
+      the top-left like a software frame.
+
+      @param frame     The TIA frame (palette indices)
+      @param width     The width of the TIA frame
+      @param height    The height of the TIA frame
+      @param palette   The palette used when not NTSC filtering
+      @param ntsc      The NTSC filter kernels (AtariNTSC::colorTable()),
+                       or nullptr to just look up the palette
+      @param phosphor  Whether to blend with the previous frame
+      @param percent   The decay of the previous frame, when blending
+      @param left      The number of columns to crop on the left
+    */
+    void render(const uInt8* frame, uInt32 width, uInt32 height,
+                const uInt32* palette, const uInt32* ntsc,
+                bool phosphor, float percent, uInt32 left);
+
+  private:
+    bool loadFunctions();
+    bool createProgram();
+    uInt32 compileShader(uInt32 type, const char* source);
+
+    /**
+      Upload the palette or the NTSC kernels, if they changed.
+    */
+    void updateColors(const uInt32* colors, uInt32 width, uInt32 height);
+
+  private:
+    // The hardware context requested from the frontend
+    retro_hw_render_callback myHWRender;
+    bool myGLES;
+
+    // Textures: the TIA frame, the colors (palette or NTSC kernels),
+    // and the last two output frames (the previous one is needed for
+    // phosphor blending)
+    uInt32 myFrameTexture;
+    uInt32 myColorTexture;
+    uInt32 myOutputTexture[2];
+    uInt32 myOutputFramebuffer[2];
+    uInt32 myCurrentOutput;
+
+    uInt32 myVertexArray;
+    uInt32 myProgram;
+    Int32 myNTSCUniform, myWidthUniform, myPhosphorUniform, myPercentUniform;
+
+    // The colors currently in myColorTexture
+    vector<uInt32> myColors;
+
+    // Settings of the last frame; when they change, the previous output
+    // is no longer used for phosphor blending
+    bool myLastNTSC, myLastPhosphor;
+    float myLastPercent;
+    uInt32 myLastHeight;
+
+  private:
+    // Following constructors and assignment operators not supported
+    GLRendererLIBRETRO(const GLRendererLIBRETRO&) = delete;
+    GLRendererLIBRETRO(GLRendererLIBRETRO&&) = delete;
+    GLRendererLIBRETRO& operator=(const GLRendererLIBRETRO&) = delete;
+    GLRendererLIBRETRO& operator=(GLRendererLIBRETRO&&) = delete;
+};
+
+#endif
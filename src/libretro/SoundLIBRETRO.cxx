@@ -82,42 +82,4 @@ void SoundLIBRETRO::close()
   Logger::debug("SoundLIBRETRO::close");
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void SoundLIBRETRO::dequeue(Int16* stream, uInt32* samples)
-{
-  uInt32 outIndex = 0;
-
-  while (myAudioQueue->size())
-  {
-    Int16* nextFragment = myAudioQueue->dequeue(myCurrentFragment);
-
-    if (!nextFragment)
-    {
-      *samples = outIndex / 2;
-      return;
-    }
-
-    myCurrentFragment = nextFragment;
-
-
-    for (uInt32 i = 0; i < myAudioQueue->fragmentSize(); ++i)
-    {
-      Int16 sampleL, sampleR;
-
-      if (myAudioQueue->isStereo())
-      {
-        sampleL = static_cast<Int16>(myCurrentFragment[2*i + 0]);
-        sampleR = static_cast<Int16>(myCurrentFragment[2*i + 1]);
-      }
-      else
-        sampleL = sampleR = static_cast<Int16>(myCurrentFragment[i]);
-
-      stream[outIndex++] = sampleL;
-      stream[outIndex++] = sampleR;
-    }
-  }
-
-  *samples = outIndex / 2;
-}
-
 #endif  // SOUND_SUPPORT
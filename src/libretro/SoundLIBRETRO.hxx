@@ -106,15 +106,6 @@ class SoundLIBRETRO : public Sound
     */
     string about() const override { return ""; }
 
-  public:
-    /**
-      Empties the playback buffer.
-
-      @param stream   Output audio buffer
-      @param samples  Number of audio samples read
-    */
-    void dequeue(Int16* stream, uInt32* samples);
-
   private:
     // Indicates if the sound device was successfully initialized
     bool myIsInitializedFlag;
@@ -22,11 +22,14 @@
 
 #include "AtariNTSC.hxx"
 #include "AudioSettings.hxx"
+#include "Cart.hxx"
 #include "Serializer.hxx"
 #include "StateManager.hxx"
 #include "Switches.hxx"
 #include "TIA.hxx"
+#include "DispatchResult.hxx"
 #include "TIASurface.hxx"
+#include "Logger.hxx"
 
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -127,6 +130,9 @@ bool StellaLIBRETRO::create(bool logging)
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  // Samples go straight into our buffer, bypassing the audio queue
+  myOSystem->console().tia().setAudioBuffer(audio_buffer.get(), audio_buffer_max / 2);
+
   video_ready = false;
   audio_samples = 0;
 
@@ -148,10 +154,6 @@ void StellaLIBRETRO::destroy()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StellaLIBRETRO::runFrame()
 {
-  // write ram updates
-  for(int lcv = 0; lcv <= 127; lcv++)
-    myOSystem->console().system().m6532().poke(lcv | 0x80, system_ram[lcv]);
-
   // poll input right at vsync
   updateInput();
 
@@ -161,8 +163,8 @@ void StellaLIBRETRO::runFrame()
   // drain generated audio
   updateAudio();
 
-  // refresh ram copy
-  memcpy(system_ram, myOSystem->console().system().m6532().getRAM(), 128);
+  // pick up messages logged by other threads
+  Logger::instance().flush();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -181,68 +183,108 @@ void StellaLIBRETRO::updateVideo()
 {
   TIA& tia = myOSystem->console().tia();
 
-  while (1)
-  {
-    tia.updateScanline();
-
-    if(tia.scanlines() == 0) break;
-  }
-
+  DispatchResult result;
+  tia.updateFrame(result);
 
   video_ready = tia.newFramePending();
 
+  // The frame is converted later, by renderVideo() or renderVideoDirect()
   if (video_ready)
+    tia.renderToFrameBuffer();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StellaLIBRETRO::renderVideo()
+{
+  myOSystem->frameBuffer().updateInEmulationMode(0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool StellaLIBRETRO::getVideoDirect()
+{
+  // Without TV effects and phosphor mode, the frame is just a palette lookup
+  const TIASurface& surface = myOSystem->frameBuffer().tiaSurface();
+
+  return getVideoZoom() == 1 && !surface.phosphorEnabled();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StellaLIBRETRO::renderVideoDirect(uInt32* buffer, size_t pitch, uInt32 left)
+{
+  TIA& tia = myOSystem->console().tia();
+  const uInt32* palette = myOSystem->frameBuffer().tiaSurface().palette();
+  const uInt8* in = tia.frameBuffer() + left;
+  const uInt32 width = tia.width() - left, height = tia.height();
+
+  for(uInt32 y = 0; y < height; ++y)
   {
-    FrameBuffer& frame = myOSystem->frameBuffer();
+    for(uInt32 x = 0; x < width; ++x)
+      buffer[x] = palette[in[x]];
 
-    tia.renderToFrameBuffer();
-    frame.updateInEmulationMode(0);
+    in += tia.width();
+    buffer = reinterpret_cast<uInt32*>(reinterpret_cast<uInt8*>(buffer) + pitch);
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void StellaLIBRETRO::renderVideoGL(GLRendererLIBRETRO& renderer, uInt32 left)
+{
+  TIA& tia = myOSystem->console().tia();
+  TIASurface& surface = myOSystem->frameBuffer().tiaSurface();
+
+  renderer.render(tia.frameBuffer(), tia.width(), tia.height(), surface.palette(),
+                  surface.ntscEnabled() ? surface.ntsc().colorTable() : nullptr,
+                  surface.phosphorEnabled(), surface.phosphorPercent(), left);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StellaLIBRETRO::updateAudio()
 {
-  static_cast<SoundLIBRETRO&>(myOSystem->sound()).dequeue(audio_buffer.get(), &audio_samples);
+  audio_samples = myOSystem->console().tia().takeAudioSamples();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StellaLIBRETRO::loadState(const void* data, size_t size)
 {
-  Serializer state;
-
-  state.putByteArray(reinterpret_cast<const uInt8*>(data), static_cast<uInt32>(size));
+  Serializer state(data, size);
 
-  if(!myOSystem->state().loadState(state))
-    return false;
-
-  memcpy(system_ram, myOSystem->console().system().m6532().getRAM(), 128);
-  return true;
+  return myOSystem->state().loadState(state);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool StellaLIBRETRO::saveState(void* data, size_t size)
+bool StellaLIBRETRO::saveState(void* data, size_t size, bool lean)
 {
-  Serializer state;
+  // Serialize directly into the frontend's buffer
+  Serializer state(data, size);
+  state.setLean(lean);
 
-  if (!myOSystem->state().saveState(state))
-    return false;
-
-  if (state.size() > size)
+  if(!myOSystem->state().saveState(state))
     return false;
 
-  state.getByteArray(reinterpret_cast<uInt8*>(data), static_cast<uInt32>(state.size()));
+  // Clear the rest of the buffer, so that equal states compare equal
+  memset(static_cast<uInt8*>(data) + state.size(), 0, size - state.size());
   return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-size_t StellaLIBRETRO::getStateSize()
+size_t StellaLIBRETRO::getStateSize(bool lean)
 {
-  Serializer state;
+  // The state size only depends on the cartridge type (and size), so
+  // the counting pass is only done once for each of them
+  const string key = myOSystem->console().cartridge().name() + ":" +
+                     std::to_string(rom_size) + (lean ? ":lean" : "");
+  const auto it = state_size_cache.find(key);
+  if(it != state_size_cache.end())
+    return it->second;
+
+  // Only count the bytes, don't store anything
+  Serializer state(static_cast<void*>(nullptr), ~size_t(0));
+  state.setLean(lean);
 
   if (!myOSystem->state().saveState(state))
     return 0;
 
+  state_size_cache[key] = state.size();
   return state.size();
 }
 
@@ -341,6 +383,19 @@ void StellaLIBRETRO::setROM(const void* data, size_t size)
   rom_size = static_cast<uInt32>(size);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8* StellaLIBRETRO::getRAM()
+{
+  return system_ready ? myOSystem->console().system().m6532().getRAM() : nullptr;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8* StellaLIBRETRO::getCartRAM(uInt32& size)
+{
+  size = 0;
+  return system_ready ? myOSystem->console().cartridge().getRAM(size) : nullptr;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StellaLIBRETRO::setConsoleFormat(uInt32 mode)
 {
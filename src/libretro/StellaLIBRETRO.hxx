@@ -18,8 +18,11 @@
 #ifndef STELLA_LIBRETRO_HXX
 #define STELLA_LIBRETRO_HXX
 
+#include <map>
+
 #include "bspf.hxx"
 #include "OSystemLIBRETRO.hxx"
+#include "GLRendererLIBRETRO.hxx"
 
 #include "Console.hxx"
 #include "ConsoleTiming.hxx"
@@ -52,7 +55,7 @@ class StellaLIBRETRO
     void runFrame();
 
     bool loadState(const void* data, size_t size);
-    bool saveState(void* data, size_t size);
+    bool saveState(void* data, size_t size, bool lean = false);
 
   public:
     const char* getCoreName() { return "Stella"; }
@@ -62,10 +65,12 @@ class StellaLIBRETRO
     uInt32 getROMSize() { return rom_size; }
     uInt32 getROMMax() { return 512 * 1024; }
 
-    uInt8* getRAM() { return system_ram; }
+    // The live RIOT and cart RAM, valid until the system is re-created
+    uInt8* getRAM();
     uInt32 getRAMSize() { return 128; }
+    uInt8* getCartRAM(uInt32& size);
 
-    size_t getStateSize();
+    size_t getStateSize(bool lean = false);
 
     bool   getConsoleNTSC() { return console_timing == ConsoleTiming::ntsc; }
 
@@ -79,6 +84,10 @@ class StellaLIBRETRO
     bool   getVideoResize();
 
     void*  getVideoBuffer();
+    bool   getVideoDirect();
+    void   renderVideo();
+    void   renderVideoDirect(uInt32* buffer, size_t pitch, uInt32 left);
+    void   renderVideoGL(GLRendererLIBRETRO& renderer, uInt32 left);
     uInt32 getVideoWidth() { return getVideoZoom()==1 ? myOSystem->console().tia().width() : getVideoWidthMax(); }
     uInt32 getVideoHeight() { return myOSystem->console().tia().height(); }
     uInt32 getVideoPitch() { return getVideoWidthMax() * 4; }
@@ -153,7 +162,8 @@ class StellaLIBRETRO
     // (31440 rate / 50 Hz) * 16-bit stereo * 1.25x padding
     const uInt32 audio_buffer_max = (31440 / 50 * 4 * 5) / 4;
 
-    uInt8 system_ram[128];
+    // serialized state size for each cartridge type
+    std::map<string, size_t> state_size_cache;
 
   private:
     string video_palette;
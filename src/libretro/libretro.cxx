@@ -5,6 +5,7 @@
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #ifdef _MSC_VER
 #define snprintf _snprintf
@@ -19,6 +20,7 @@
 
 
 static StellaLIBRETRO stella;
+static GLRendererLIBRETRO gl_renderer;
 
 static retro_log_printf_t log_cb;
 static retro_video_refresh_t video_cb;
@@ -37,6 +39,7 @@ static int setting_crop_hoverscan, crop_left;
 static NTSCFilter::Preset setting_filter;
 
 static bool system_reset;
+static bool hw_render;
 
 static unsigned input_devices[4];
 static Controller::Type input_type[2];
@@ -54,6 +57,21 @@ uint32_t libretro_read_rom(void* data)
   return stella.getROMSize();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static void hw_context_reset()
+{
+  gl_renderer.contextReset();
+
+  if(!gl_renderer.ready() && log_cb)
+    log_cb(RETRO_LOG_ERROR, "[Stella]: GPU rendering failed to initialize.\n");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static void hw_context_destroy()
+{
+  gl_renderer.contextDestroy();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 static void update_input()
 {
@@ -380,6 +398,39 @@ static void update_variables(bool init = false)
 #undef RETRO_GET
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static void update_memory_maps()
+{
+  // Expose the emulated RAM itself, so the frontend (cheats, achievements)
+  // reads and writes it directly
+  static struct retro_memory_descriptor descs[2];
+  static struct retro_memory_map map;
+  unsigned count = 0;
+
+  memset(descs, 0, sizeof(descs));
+
+  // RIOT RAM, as seen by the 6507
+  descs[count].ptr = stella.getRAM();
+  descs[count].start = 0x80;
+  descs[count].len = stella.getRAMSize();
+  count++;
+
+  // Extra RAM in the cartridge (SC, FA and ARM based carts)
+  uInt32 size = 0;
+  uInt8* cartRAM = stella.getCartRAM(size);
+  if(cartRAM && size > 0)
+  {
+    descs[count].ptr = cartRAM;
+    descs[count].len = size;
+    descs[count].addrspace = "CART";
+    count++;
+  }
+
+  map.descriptors = descs;
+  map.num_descriptors = count;
+  environ_cb(RETRO_ENVIRONMENT_SET_MEMORY_MAPS, &map);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 static bool reset_system()
 {
@@ -392,6 +443,9 @@ static bool reset_system()
   // start system
   if(!stella.create(log_cb ? true : false)) return false;
 
+  // the RAM now lives in a new console
+  update_memory_maps();
+
   // get auto-detect controllers
   input_type[0] = stella.getLeftControllerType();
   input_type[1] = stella.getRightControllerType();
@@ -503,6 +557,7 @@ void retro_set_environment(retro_environment_t cb)
     { "stella_phosphor", "Phosphor mode; auto|off|on" },
     { "stella_phosphor_blend", "Phosphor blend %; 60|65|70|75|80|85|90|95|100|0|5|10|15|20|25|30|35|40|45|50|55" },
     { "stella_paddle_joypad_sensitivity", "Paddle joypad sensitivity; 3|4|5|6|7|8|9|10|11|12|13|14|15|16|17|18|19|20|1|2" },
+    { "stella_hw_render", "GPU rendering (restart); disabled|enabled" },
     { NULL, NULL },
   };
 
@@ -519,6 +574,10 @@ void retro_init()
   if(environ_cb(RETRO_ENVIRONMENT_GET_LOG_INTERFACE, &log)) log_cb = log.log;
 
   environ_cb(RETRO_ENVIRONMENT_SET_PERFORMANCE_LEVEL, &level);
+
+  // States are stored in native byte order
+  uint64_t quirks = RETRO_SERIALIZATION_QUIRK_ENDIAN_DEPENDENT;
+  environ_cb(RETRO_ENVIRONMENT_SET_SERIALIZATION_QUIRKS, &quirks);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -573,6 +632,15 @@ bool retro_load_game(const struct retro_game_info *info)
     return false;
   }
 
+  // Let the GPU do the palette lookup and TV effects, if the frontend allows
+  struct retro_variable var = { "stella_hw_render", NULL };
+  hw_render = false;
+  if(environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value && !strcmp(var.value, "enabled"))
+  {
+    hw_render = gl_renderer.initialize(environ_cb, hw_context_reset, hw_context_destroy);
+    if(!hw_render && log_cb)
+      log_cb(RETRO_LOG_INFO, "[Stella]: OpenGL 3.3 (or ES 3.0) is not supported.\n");
+  }
 
   stella.setROM(info->data, info->size);
 
@@ -618,8 +686,36 @@ void retro_run()
 
   //printf("retro_run - %d %d %d - %d\n", stella.getVideoWidth(), stella.getVideoHeight(), stella.getVideoPitch(), stella.getAudioSize() );
 
-  if(stella.getVideoReady())
-    video_cb(reinterpret_cast<uInt32*>(stella.getVideoBuffer()) + crop_left, stella.getVideoWidth() - crop_left, stella.getVideoHeight(), stella.getVideoPitch());
+  if(stella.getVideoReady() && hw_render)
+  {
+    if(gl_renderer.ready())
+    {
+      stella.renderVideoGL(gl_renderer, crop_left);
+      video_cb(RETRO_HW_FRAME_BUFFER_VALID, stella.getVideoWidth() - crop_left, stella.getVideoHeight(), 0);
+    }
+  }
+  else if(stella.getVideoReady())
+  {
+    // Convert the TIA image directly into the frontend's buffer, if possible
+    struct retro_framebuffer fb;
+    fb.data = nullptr;
+    fb.width = stella.getVideoWidth() - crop_left;
+    fb.height = stella.getVideoHeight();
+    fb.access_flags = RETRO_MEMORY_ACCESS_WRITE;
+
+    if(stella.getVideoDirect() &&
+       environ_cb(RETRO_ENVIRONMENT_GET_CURRENT_SOFTWARE_FRAMEBUFFER, &fb) &&
+       fb.data && fb.format == RETRO_PIXEL_FORMAT_XRGB8888)
+    {
+      stella.renderVideoDirect(static_cast<uInt32*>(fb.data), fb.pitch, crop_left);
+      video_cb(fb.data, fb.width, fb.height, fb.pitch);
+    }
+    else
+    {
+      stella.renderVideo();
+      video_cb(reinterpret_cast<uInt32*>(stella.getVideoBuffer()) + crop_left, stella.getVideoWidth() - crop_left, stella.getVideoHeight(), stella.getVideoPitch());
+    }
+  }
 
   if(stella.getAudioReady())
     audio_batch_cb(stella.getAudioBuffer(), stella.getAudioSize());
@@ -638,23 +734,26 @@ void retro_deinit()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-size_t retro_serialize_size()
+static bool fast_savestates()
 {
-  int runahead = -1;
-  if(environ_cb(RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE, &runahead))
-  {
-    // maximum state size possible
-    if(runahead & 4)
-      return 0x100000;
-  }
+  // Requested for runahead and netplay, where states are saved and loaded
+  // by the same binary many times per second; leaner states are cheaper
+  // to save, compare and send then
+  int flags = 0;
 
-  return stella.getStateSize();
+  return environ_cb(RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE, &flags) && (flags & 4);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+size_t retro_serialize_size()
+{
+  return stella.getStateSize(fast_savestates());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool retro_serialize(void *data, size_t size)
 {
-  return stella.saveState(data, size);
+  return stella.saveState(data, size, fast_savestates());
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -11,19 +11,20 @@ my %prop_type = (
   "Cart.Rarity"             => 5,
   "Cart.Sound"              => 6,
   "Cart.StartBank"          => 7,
-  "Cart.Type"               => 8,
-  "Console.LeftDiff"        => 9,
-  "Console.RightDiff"       => 10,
-  "Console.TVType"          => 11,
-  "Console.SwapPorts"       => 12,
-  "Controller.Left"         => 13,
-  "Controller.Right"        => 14,
-  "Controller.SwapPaddles"  => 15,
-  "Controller.MouseAxis"    => 16,
-  "Display.Format"          => 17,
-  "Display.YStart"          => 18,
-  "Display.Phosphor"        => 19,
-  "Display.PPBlend"         => 20
+  "Cart.ThumbFast"          => 8,
+  "Cart.Type"               => 9,
+  "Console.LeftDiff"        => 10,
+  "Console.RightDiff"       => 11,
+  "Console.TVType"          => 12,
+  "Console.SwapPorts"       => 13,
+  "Controller.Left"         => 14,
+  "Controller.Right"        => 15,
+  "Controller.SwapPaddles"  => 16,
+  "Controller.MouseAxis"    => 17,
+  "Display.Format"          => 18,
+  "Display.YStart"          => 19,
+  "Display.Phosphor"        => 20,
+  "Display.PPBlend"         => 21
 );
 my @prop_type_as_string = (
   "Cart.MD5",
@@ -34,6 +35,7 @@ my @prop_type_as_string = (
   "Cart.Rarity",
   "Cart.Sound",
   "Cart.StartBank",
+  "Cart.ThumbFast",
   "Cart.Type",
   "Console.LeftDiff",
   "Console.RightDiff",
@@ -58,6 +60,7 @@ my @prop_defaults = (
   "",
   "MONO",
   "",
+  "NO",
   "AUTO",
   "B",
   "B",
@@ -83,6 +83,77 @@ for my $key ( sort keys %propset )
   $idx++;
 }
 
+print OUTFILE "};\n";
+
+# Build a perfect hash over the md5sums, so that lookups need only a single
+# comparison.  Every md5sum is split into four 32-bit words; the first one
+# selects a bucket, and each bucket has a displacement chosen so that
+#   slot = (w1 + displacement * (w2 | 1)) mod DEF_PROPS_HASH_SLOTS
+# is unique over all keys.  Since md5sums are uniformly distributed, the
+# words can be used directly as hash values.
+my $numbuckets = 1024;
+my $numslots = 1;
+$numslots *= 2 while ($numslots < $setsize * 1.2);
+
+my @keys = sort keys %propset;
+my @buckets;
+my @words;
+for my $i (0 .. $#keys)
+{
+  my $md5 = lc($keys[$i]);
+  $words[$i] = [ map { hex(substr($md5, $_ * 8, 8)) } (0 .. 3) ];
+  push @{ $buckets[$words[$i][0] % $numbuckets] }, $i;
+}
+
+my @displacement = (0) x $numbuckets;
+my @slots = (65535) x $numslots;
+for my $b (sort { scalar(@{ $buckets[$b] // [] }) <=> scalar(@{ $buckets[$a] // [] }) || $a <=> $b } (0 .. $numbuckets-1))
+{
+  my @members = @{ $buckets[$b] // [] };
+  next if (@members == 0);
+
+  for (my $d = 0; ; $d++)
+  {
+    die "Couldn't build the perfect hash\n" if ($d > 65535);
+
+    my %taken;
+    my $ok = 1;
+    for my $i (@members)
+    {
+      my $slot = ($words[$i][1] + $d * ($words[$i][2] | 1)) % $numslots;
+      if ($slots[$slot] != 65535 || $taken{$slot}) { $ok = 0; last; }
+      $taken{$slot} = $i;
+    }
+    if ($ok)
+    {
+      $slots[$_] = $taken{$_} for (keys %taken);
+      $displacement[$b] = $d;
+      last;
+    }
+  }
+}
+
+print OUTFILE "\n";
+print OUTFILE "#define DEF_PROPS_HASH_BUCKETS " . $numbuckets . "\n";
+print OUTFILE "#define DEF_PROPS_HASH_SLOTS " . $numslots . "\n";
+print OUTFILE "\n";
+print OUTFILE "// The md5sums of the entries above, as four 32-bit words each\n";
+print OUTFILE "static const uInt32 DefPropsKeys[DEF_PROPS_SIZE][4] = {\n";
+for my $i (0 .. $#keys)
+{
+  printf OUTFILE "  { 0x%08x, 0x%08x, 0x%08x, 0x%08x }", @{ $words[$i] };
+  print OUTFILE ($i+1 < $setsize) ? ",\n" : "\n";
+}
+print OUTFILE "};\n";
+print OUTFILE "\n";
+print OUTFILE "// The displacement of each hash bucket (see create_props.pl)\n";
+print OUTFILE "static const uInt16 DefPropsBuckets[DEF_PROPS_HASH_BUCKETS] = {\n";
+print_table(@displacement);
+print OUTFILE "};\n";
+print OUTFILE "\n";
+print OUTFILE "// The entry in each hash slot, or 0xffff if the slot is empty\n";
+print OUTFILE "static const uInt16 DefPropsSlots[DEF_PROPS_HASH_SLOTS] = {\n";
+print_table(@slots);
 print OUTFILE "};\n";
 print OUTFILE "\n";
 print OUTFILE "#endif\n";
@@ -90,6 +161,16 @@ print OUTFILE "#endif\n";
 close(OUTFILE);
 
 
+sub print_table {
+  my @values = @_;
+  for (my $i = 0; $i < @values; $i += 12)
+  {
+    my $end = $i + 11 < $#values ? $i + 11 : $#values;
+    print OUTFILE "  " . join(", ", map { sprintf("0x%04x", $_) } @values[$i .. $end]);
+    print OUTFILE ($end < $#values) ? ",\n" : "\n";
+  }
+}
+
 sub usage {
   print "create_props.pl <INPUT properties file> <OUTPUT C++ header>\n";
   print "\n";
@@ -26,13 +26,13 @@
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FilesystemNodePOSIX::setFlags()
 {
-  struct stat st;
+  const FSMetadataCache::Metadata metadata = getMetadata(_path);
 
-  _isValid = (0 == stat(_path.c_str(), &st));
+  _isValid = metadata.exists;
   if(_isValid)
   {
-    _isDirectory = S_ISDIR(st.st_mode);
-    _isFile = S_ISREG(st.st_mode);
+    _isDirectory = metadata.isDirectory;
+    _isFile = metadata.isFile;
 
     // Add a trailing slash, if necessary
     if (_isDirectory && _path.length() > 0 && _path[_path.length()-1] != '/')
@@ -42,6 +42,27 @@ void FilesystemNodePOSIX::setFlags()
     _isDirectory = _isFile = false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+FSMetadataCache::Metadata FilesystemNodePOSIX::getMetadata(const string& path)
+{
+  FSMetadataCache::Metadata metadata;
+  if(FSMetadataCache::find(path, metadata))
+    return metadata;
+
+  struct stat st;
+  metadata.exists = (0 == stat(path.c_str(), &st));
+  if(metadata.exists)
+  {
+    metadata.isDirectory = S_ISDIR(st.st_mode);
+    metadata.isFile = S_ISREG(st.st_mode);
+    metadata.size = uInt64(st.st_size);
+    metadata.modified = uInt64(st.st_mtime);
+  }
+  FSMetadataCache::insert(path, metadata);
+
+  return metadata;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 FilesystemNodePOSIX::FilesystemNodePOSIX()
   : _path(ROOT_DIR),
@@ -104,6 +125,19 @@ bool FilesystemNodePOSIX::hasParent() const
   return _path != "" && _path != ROOT_DIR;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNodePOSIX::isReadable() const
+{
+  FSMetadataCache::Metadata metadata = getMetadata(_path);
+  if(metadata.readable < 0)
+  {
+    metadata.readable = access(_path.c_str(), R_OK) == 0;
+    FSMetadataCache::insert(_path, metadata);
+  }
+
+  return metadata.readable;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool FilesystemNodePOSIX::getChildren(AbstractFSList& myList, ListMode mode) const
 {
@@ -147,14 +181,9 @@ bool FilesystemNodePOSIX::getChildren(AbstractFSList& myList, ListMode mode) con
     {
       if (dp->d_type == DT_LNK)
       {
-        struct stat st;
-        if (stat(entry._path.c_str(), &st) == 0)
-        {
-          entry._isDirectory = S_ISDIR(st.st_mode);
-          entry._isFile = S_ISREG(st.st_mode);
-        }
-        else
-          entry._isDirectory = entry._isFile = false;
+        const FSMetadataCache::Metadata metadata = getMetadata(entry._path);
+        entry._isDirectory = metadata.isDirectory;
+        entry._isFile = metadata.isFile;
       }
       else
       {
@@ -191,12 +220,15 @@ bool FilesystemNodePOSIX::makeDir()
 {
   if(mkdir(_path.c_str(), 0777) == 0)
   {
+    FSMetadataCache::invalidate(_path);
+
     // Get absolute path
     char buf[MAXPATHLEN];
     if(realpath(_path.c_str(), buf))
       _path = buf;
 
     _displayName = lastPathComponent(_path);
+    FSMetadataCache::invalidate(_path);
     setFlags();
 
     // Add a trailing slash, if necessary
@@ -214,6 +246,8 @@ bool FilesystemNodePOSIX::rename(const string& newfile)
 {
   if(std::rename(_path.c_str(), newfile.c_str()) == 0)
   {
+    FSMetadataCache::invalidate(_path);
+
     _path = newfile;
 
     // Get absolute path
@@ -222,6 +256,7 @@ bool FilesystemNodePOSIX::rename(const string& newfile)
       _path = buf;
 
     _displayName = lastPathComponent(_path);
+    FSMetadataCache::invalidate(_path);
     setFlags();
 
     // Add a trailing slash, if necessary
@@ -234,6 +269,19 @@ bool FilesystemNodePOSIX::rename(const string& newfile)
     return false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNodePOSIX::getFileInfo(uInt64& size, uInt64& modified) const
+{
+  const FSMetadataCache::Metadata metadata = getMetadata(_path);
+  if(!metadata.exists)
+    return false;
+
+  size = metadata.size;
+  modified = metadata.modified;
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 AbstractFSNodePtr FilesystemNodePOSIX::getParent() const
 {
@@ -19,6 +19,7 @@
 #define FS_NODE_POSIX_HXX
 
 #include "FSNode.hxx"
+#include "FSMetadataCache.hxx"
 
 #ifdef BSPF_MACOS
   #include <sys/types.h>
@@ -60,7 +61,7 @@ class FilesystemNodePOSIX : public AbstractFSNode
      */
     FilesystemNodePOSIX(const string& path, bool verify = true);
 
-    bool exists() const override { return access(_path.c_str(), F_OK) == 0; }
+    bool exists() const override { return getMetadata(_path).exists; }
     const string& getName() const override    { return _displayName; }
     void setName(const string& name) override { _displayName = name; }
     const string& getPath() const override { return _path; }
@@ -68,10 +69,11 @@ class FilesystemNodePOSIX : public AbstractFSNode
     bool hasParent() const override;
     bool isDirectory() const override { return _isDirectory; }
     bool isFile() const override      { return _isFile;      }
-    bool isReadable() const override  { return access(_path.c_str(), R_OK) == 0; }
+    bool isReadable() const override;
     bool isWritable() const override  { return access(_path.c_str(), W_OK) == 0; }
     bool makeDir() override;
     bool rename(const string& newfile) override;
+    bool getFileInfo(uInt64& size, uInt64& modified) const override;
 
     bool getChildren(AbstractFSList& list, ListMode mode) const override;
     AbstractFSNodePtr getParent() const override;
@@ -90,6 +92,12 @@ class FilesystemNodePOSIX : public AbstractFSNode
      */
     virtual void setFlags();
 
+    /**
+     * Returns the metadata of the given path, using the stat() function
+     * unless it is cached.
+     */
+    static FSMetadataCache::Metadata getMetadata(const string& path);
+
     /**
      * Returns the last component of a given path.
      *
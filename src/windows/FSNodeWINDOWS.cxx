@@ -292,6 +292,20 @@ bool FilesystemNodeWINDOWS::rename(const string& newfile)
     return false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FilesystemNodeWINDOWS::getFileInfo(uInt64& size, uInt64& modified) const
+{
+  WIN32_FILE_ATTRIBUTE_DATA data;
+  if(_isPseudoRoot || !GetFileAttributesEx(_path.c_str(), GetFileExInfoStandard, &data))
+    return false;
+
+  size = (uInt64(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+  modified = (uInt64(data.ftLastWriteTime.dwHighDateTime) << 32) |
+             data.ftLastWriteTime.dwLowDateTime;
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 AbstractFSNodePtr FilesystemNodeWINDOWS::getParent() const
 {
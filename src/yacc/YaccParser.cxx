@@ -15,6 +15,8 @@
 // this file, and for a DISCLAIMER OF ALL WARRANTIES.
 //============================================================================
 
+#include <unordered_map>
+
 #include "Base.hxx"
 #include "DebuggerExpressions.hxx"
 
@@ -371,4 +373,59 @@ int yylex() {
   return 0; // hit NUL, end of input.
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// The cache of parsed expressions, and what they were parsed with
+static std::unordered_map<string, shared_ptr<const Expression>> cache;
+static uInt32 cacheLabelsVersion = 0, cacheFunctionsVersion = 0;
+
+// Flushing a full cache is simpler than evicting single entries, and
+// scripts rarely use that many different expressions
+static constexpr size_t CACHE_SIZE = 1024;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+shared_ptr<const Expression> parseCached(const string& in)
+{
+  const Debugger& debugger = Debugger::debugger();
+  if(cacheLabelsVersion != debugger.cartDebug().labelsVersion() ||
+     cacheFunctionsVersion != debugger.functionsVersion())
+  {
+    cache.clear();
+    cacheLabelsVersion = debugger.cartDebug().labelsVersion();
+    cacheFunctionsVersion = debugger.functionsVersion();
+  }
+
+  // The key is the default base, followed by the text without redundant
+  // whitespace (which separates the tokens, but never changes them)
+  string key(1, char(Common::Base::format()));
+  key.reserve(in.size() + 1);
+  for(const char* s = in.c_str(); *s; ++s)
+  {
+    if(!isspace(*s))
+      key += *s;
+    else if(key.size() > 1 && s[1] && !isspace(s[1]))
+      key += ' ';
+  }
+
+  const auto iter = cache.find(key);
+  if(iter != cache.end())
+    return iter->second;
+
+  if(parse(in) != 0)
+    return nullptr;
+
+  if(cache.size() >= CACHE_SIZE)
+    cache.clear();
+
+  shared_ptr<const Expression> expression(getResult());
+  cache.emplace(key, expression);
+
+  return expression;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void clearCache()
+{
+  cache.clear();
+}
+
 } // namespace YaccParser
@@ -33,6 +33,26 @@ namespace YaccParser
 
   void setInput(const string& in);
   int parse(const string& in);
+
+  /**
+    Parse the expression like parse(), but take it from the cache of the
+    expressions parsed before, if possible.  The expression is shared by
+    all users of the same text, and is never modified.
+
+    What an expression means depends on the default base, the labels and
+    the functions defined when it is parsed, so the cache is keyed by the
+    base, and flushed when labels or functions are added or removed.
+
+    @return  The expression, or nullptr if the text isn't a valid
+             expression (see errorMessage())
+  */
+  shared_ptr<const Expression> parseCached(const string& in);
+
+  /**
+    Forget all cached expressions (e.g. when a new ROM is debugged).
+  */
+  void clearCache();
+
   int const_to_int(char* ch);
 
   CartMethod getCartSpecial(char* ch);